@@ -1,5 +1,6 @@
 using System.ComponentModel;
 using Modular.Cli.Infrastructure;
+using Modular.Core.Archives;
 using Modular.Core.Database;
 using Modular.Core.Installers;
 using Modular.Sdk.Installers;
@@ -35,6 +36,14 @@ public class InstallCommand : AsyncCommand<InstallCommand.Settings>
         [Description("Overwrite existing files")]
         public bool Force { get; init; }
 
+        [CommandOption("--import")]
+        [Description("Add the archive to the download library first (reflink or copy)")]
+        public bool Import { get; init; }
+
+        [CommandOption("--move")]
+        [Description("With --import, move the archive into the library instead of copying it")]
+        public bool Move { get; init; }
+
         [CommandOption("--no-backup")]
         [Description("Do not create backups of overwritten files")]
         public bool NoBackup { get; init; }
@@ -96,6 +105,26 @@ public class InstallCommand : AsyncCommand<InstallCommand.Settings>
             var db = new ModularDatabase(dbPath);
             await db.InitializeAsync();
 
+            if (settings.Import)
+            {
+                var importPath = Path.Combine(services.Settings.ModsDirectory, "imports", Path.GetFileName(archivePath));
+                if (File.Exists(importPath) && new FileInfo(importPath).Length == new FileInfo(archivePath).Length)
+                {
+                    AnsiConsole.MarkupLine($"[grey]Already in library:[/] {importPath}");
+                }
+                else
+                {
+                    var ingestion = new ArchiveIngestionService(new ArchiveInventoryService(db));
+                    var ingested = await ingestion.IngestAsync(
+                        archivePath, importPath,
+                        new IngestOptions { Move = settings.Move, Overwrite = true },
+                        ct: cts.Token);
+                    AnsiConsole.MarkupLine($"[green]Imported ({ingested.Method.ToString().ToLowerInvariant()}):[/] {importPath}");
+                }
+
+                archivePath = importPath;
+            }
+
             var installService = new ModInstallationService(db, services.Telemetry);
 
             var options = new ModInstallationOptions
@@ -148,6 +177,8 @@ public class InstallCommand : AsyncCommand<InstallCommand.Settings>
                     AnsiConsole.MarkupLine($"[grey]Backed up {result.BackedUpFiles.Count} existing files[/]");
                 AnsiConsole.MarkupLine($"[grey]Changeset: {result.ChangesetId} (use to uninstall later)[/]");
                 AnsiConsole.MarkupLine($"[grey]Installer: {result.InstallerUsed}[/]");
+                foreach (var warning in result.Warnings)
+                    AnsiConsole.MarkupLine($"[yellow]Warning:[/] {Markup.Escape(warning)}");
             }
             else
             {
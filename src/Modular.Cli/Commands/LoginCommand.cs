@@ -16,7 +16,8 @@ public sealed class LoginCommand : AsyncCommand
     {
         try
         {
-            var configService = new ConfigurationService();
+            var credentials = CredentialService.CreateDefault();
+            var configService = new ConfigurationService(credentials);
             var settings = await configService.LoadAsync();
 
             Console.WriteLine("Opening browser for NexusMods authorization...");
@@ -28,10 +29,10 @@ public sealed class LoginCommand : AsyncCommand
                 settings.NexusApplicationSlug,
                 loggerFactory.CreateLogger<NexusSsoClient>());
 
-            settings.NexusApiKey = await ssoClient.AuthenticateAsync();
-            await configService.SaveAsync(settings);
+            var apiKey = await ssoClient.AuthenticateAsync();
+            await credentials.StoreSecretAsync(CredentialService.NexusApiKeyName, apiKey);
 
-            LiveProgressDisplay.ShowSuccess("Login successful! API key saved to config.");
+            LiveProgressDisplay.ShowSuccess($"Login successful! API key saved to the {credentials.StoreName} credential store.");
             return 0;
         }
         catch (TimeoutException)
@@ -0,0 +1,119 @@
+using System.ComponentModel;
+using System.Diagnostics;
+using Microsoft.Extensions.Logging;
+using Modular.Cli.Infrastructure;
+using Modular.Cli.UI;
+using Modular.Core.Database;
+using Modular.Core.Updates;
+using Spectre.Console;
+using Spectre.Console.Cli;
+
+namespace Modular.Cli.Commands;
+
+/// <summary>
+/// Lists downloaded and tracked mods with newer files upstream. Answers from
+/// the local update index; --refresh polls the backends' change feeds first.
+/// </summary>
+public sealed class OutdatedCommand : AsyncCommand<OutdatedCommand.Settings>
+{
+    public sealed class Settings : CommandSettings
+    {
+        [CommandOption("--game|-g")]
+        [Description("Filter by game domain (e.g., skyrimspecialedition)")]
+        public string? Game { get; init; }
+
+        [CommandOption("--backend|-b")]
+        [Description("Filter by backend: nexusmods, gamebanana")]
+        public string? Backend { get; init; }
+
+        [CommandOption("--refresh")]
+        [Description("Poll the backends' update feeds before listing")]
+        public bool Refresh { get; init; }
+
+        [CommandOption("--verbose")]
+        [Description("Enable verbose output")]
+        public bool Verbose { get; init; }
+    }
+
+    public override async Task<int> ExecuteAsync(CommandContext context, Settings settings)
+    {
+        using var cts = new CancellationTokenSource();
+        Console.CancelKeyPress += (_, e) => { e.Cancel = true; cts.Cancel(); };
+
+        try
+        {
+            var dbPath = Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+                ".config", "Modular", "modular.db");
+            await using var db = new ModularDatabase(dbPath);
+            await db.InitializeAsync();
+
+            var index = new ModUpdateIndex(db);
+
+            if (settings.Refresh)
+            {
+                using var services = await RuntimeServices.InitializeMinimalAsync(settings.Verbose);
+                var feeds = services.CreateUpdateFeeds(services.CreateBackendRegistry());
+                if (!feeds.Any(f => f.IsAvailable))
+                {
+                    LiveProgressDisplay.ShowError("No backend is configured for update checks.");
+                    return 1;
+                }
+
+                using var checker = new UpdateCheckService(
+                    index, feeds, services.LoggerFactory?.CreateLogger<UpdateCheckService>());
+
+                var result = await AnsiConsole.Status()
+                    .StartAsync("Checking for updates...", _ => checker.PollAsync(cts.Token));
+
+                foreach (var backend in result.FailedBackends)
+                    LiveProgressDisplay.ShowWarning($"Could not check {backend} for updates; showing results from the last check.");
+
+                await services.SaveStateAsync();
+            }
+
+            var stopwatch = Stopwatch.StartNew();
+            var outdated = await index.GetOutdatedAsync(settings.Backend, settings.Game, cts.Token);
+            stopwatch.Stop();
+
+            if (outdated.Count == 0)
+            {
+                AnsiConsole.MarkupLine("[green]All watched mods are up to date.[/]");
+                AnsiConsole.MarkupLine($"[dim]Answered from the local index in {stopwatch.Elapsed.TotalMilliseconds:F1} ms[/]");
+                return 0;
+            }
+
+            var table = new Table();
+            table.Border(TableBorder.Rounded);
+            table.AddColumn("Backend");
+            table.AddColumn("Game");
+            table.AddColumn("Mod ID");
+            table.AddColumn("Name");
+            table.AddColumn("Have");
+            table.AddColumn("Updated");
+
+            foreach (var mod in outdated)
+            {
+                table.AddRow(
+                    mod.Backend,
+                    Markup.Escape(mod.GameDomain),
+                    mod.ModId,
+                    string.IsNullOrEmpty(mod.Name) ? "[grey]-[/]" : Markup.Escape(mod.Name),
+                    mod.Source.HasFlag(WatchSource.Downloaded) ? "downloaded" : "tracked",
+                    mod.UpdatedAt.ToLocalTime().ToString("yyyy-MM-dd HH:mm"));
+            }
+
+            AnsiConsole.MarkupLine($"[bold]Outdated mods ({outdated.Count}):[/]");
+            AnsiConsole.Write(table);
+            AnsiConsole.MarkupLine($"[dim]Answered from the local index in {stopwatch.Elapsed.TotalMilliseconds:F1} ms[/]");
+            return 0;
+        }
+        catch (Exception ex)
+        {
+            LiveProgressDisplay.ShowError(ex.Message);
+            if (settings.Verbose)
+                AnsiConsole.WriteException(ex);
+            return 1;
+        }
+    }
+}
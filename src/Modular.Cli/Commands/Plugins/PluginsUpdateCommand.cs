@@ -59,19 +59,20 @@ public sealed class PluginsUpdateCommand : AsyncCommand
             var response = Console.ReadLine();
             if (response?.ToLowerInvariant() == "y")
             {
-                foreach (var update in updates)
+                foreach (var update in updates.Where(u => u.IndexEntry == null))
+                    LiveProgressDisplay.ShowError($"Missing index entry for {update.PluginName}");
+
+                var pending = updates.Where(u => u.IndexEntry != null).ToList();
+                LiveProgressDisplay.ShowInfo($"Updating {pending.Count} plugin(s)...");
+
+                // Each update lands in its own version directory, so they can run side by side
+                var results = await marketplace.InstallPluginsAsync(pending.Select(u => u.IndexEntry!).ToList());
+                for (var i = 0; i < pending.Count; i++)
                 {
-                    if (update.IndexEntry == null)
-                    {
-                        LiveProgressDisplay.ShowError($"Missing index entry for {update.PluginName}");
-                        continue;
-                    }
-                    LiveProgressDisplay.ShowInfo($"Updating {update.PluginName}...");
-                    var result = await marketplace.InstallPluginAsync(update.IndexEntry);
-                    if (result.Success)
-                        LiveProgressDisplay.ShowSuccess($"Updated {update.PluginName}");
+                    if (results[i].Success)
+                        LiveProgressDisplay.ShowSuccess($"Updated {pending[i].PluginName}");
                     else
-                        LiveProgressDisplay.ShowError($"Failed to update {update.PluginName}: {result.Error}");
+                        LiveProgressDisplay.ShowError($"Failed to update {pending[i].PluginName}: {results[i].Error}");
                 }
             }
 
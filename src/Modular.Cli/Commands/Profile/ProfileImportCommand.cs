@@ -87,7 +87,8 @@ public sealed class ProfileImportCommand : AsyncCommand<ProfileImportCommand.Set
         var loggerFactory = verbose ? ServiceConfiguration.CreateLoggerFactory(true) : null;
         var resolver = new GreedyDependencyResolver(
             versionProvider,
-            loggerFactory?.CreateLogger<GreedyDependencyResolver>());
+            loggerFactory?.CreateLogger<GreedyDependencyResolver>(),
+            new ResolutionCache(ResolutionCache.DefaultPath(profile.Id)));
 
         // Build root requirements from profile mods
         var requirements = new List<(string canonicalId, VersionRange? constraint)>();
@@ -125,7 +125,7 @@ public sealed class SwitchInstallCommand : AsyncCommand<SwitchInstallCommand.Set
                 .AddColumn("File").AddColumn("Provided by (last wins)");
             foreach (var overlap in overlapReport.Overlaps.Take(20))
                 overlapTable.AddRow(
-                    Markup.Escape(overlap.NormalizedPath),
+                    Markup.Escape(overlap.DisplayPath),
                     Markup.Escape(string.Join(" → ", overlap.ModKeys)));
             if (overlapReport.Overlaps.Count > 20)
                 overlapTable.AddRow($"[grey]... and {overlapReport.Overlaps.Count - 20} more[/]", "");
@@ -146,7 +146,7 @@ public sealed class SwitchResolveCommand : AsyncCommand<SwitchResolveCommand.Set
                     .AddColumn("File").AddColumn("Provided by");
                 foreach (var overlap in overlapReport.Overlaps.Take(30))
                     overlapTable.AddRow(
-                        Markup.Escape(overlap.NormalizedPath),
+                        Markup.Escape(overlap.DisplayPath),
                         Markup.Escape(string.Join(", ", overlap.ModKeys)));
                 if (overlapReport.Overlaps.Count > 30)
                     overlapTable.AddRow($"[grey]... and {overlapReport.Overlaps.Count - 30} more[/]", "");
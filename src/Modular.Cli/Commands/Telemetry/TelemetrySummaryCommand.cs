@@ -45,6 +45,18 @@ public sealed class TelemetrySummaryCommand : AsyncCommand<TelemetrySummaryComma
                     Console.WriteLine($"  {type}: {count}");
             }
 
+            var installers = services.Telemetry.GetOperationStats("installer_execution", startDate, DateTime.UtcNow);
+            if (installers.Count > 0)
+            {
+                Console.WriteLine();
+                Console.WriteLine("Install time by installer (p50 / p95):");
+                foreach (var stats in installers.OrderByDescending(s => s.Count))
+                {
+                    var name = stats.Key.Length > 0 ? stats.Key : "unknown";
+                    Console.WriteLine($"  {name}: {stats.DurationPercentile(50):N0} ms / {stats.DurationPercentile(95):N0} ms ({stats.Count} runs)");
+                }
+            }
+
             return 0;
         }
         catch (Exception ex)
@@ -0,0 +1,144 @@
+using System.ComponentModel;
+using Microsoft.Extensions.Logging;
+using Modular.Cli.Infrastructure;
+using Modular.Core.Archives;
+using Modular.Core.Database;
+using Spectre.Console;
+using Spectre.Console.Cli;
+
+namespace Modular.Cli.Commands;
+
+/// <summary>
+/// Verifies the integrity of every archive in the download library.
+/// </summary>
+public class VerifyDownloadsCommand : AsyncCommand<VerifyDownloadsCommand.Settings>
+{
+    public sealed class Settings : CommandSettings
+    {
+        [CommandArgument(0, "[DIRECTORY]")]
+        [Description("Download directory to scan (defaults to the configured mods directory)")]
+        public string? Directory { get; init; }
+
+        [CommandOption("--quick")]
+        [Description("Only check headers and end markers, without decompressing entries")]
+        public bool Quick { get; init; }
+
+        [CommandOption("--force")]
+        [Description("Re-check archives even if unchanged since the last scan")]
+        public bool Force { get; init; }
+
+        [CommandOption("--parallelism <N>")]
+        [Description("Concurrent checks per disk (default: 1 for HDDs, more for SSDs)")]
+        public int? Parallelism { get; init; }
+
+        [CommandOption("--all")]
+        [Description("List every archive, not just problems")]
+        public bool All { get; init; }
+
+        [CommandOption("--verbose")]
+        [Description("Enable verbose output")]
+        public bool Verbose { get; init; }
+    }
+
+    public override async Task<int> ExecuteAsync(CommandContext context, Settings settings)
+    {
+        using var cts = new CancellationTokenSource();
+        Console.CancelKeyPress += (_, e) => { e.Cancel = true; cts.Cancel(); };
+
+        try
+        {
+            var services = await RuntimeServices.InitializeMinimalAsync(settings.Verbose);
+            var directory = Path.GetFullPath(settings.Directory ?? services.Settings.ModsDirectory);
+
+            if (!System.IO.Directory.Exists(directory))
+            {
+                AnsiConsole.MarkupLine($"[red]Directory not found:[/] {Markup.Escape(directory)}");
+                return 1;
+            }
+
+            var dbPath = Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+                ".config", "Modular", "modular.db");
+            await using var db = new ModularDatabase(dbPath);
+            await db.InitializeAsync();
+
+            var checksums = new ArchiveChecksumIndex();
+            checksums.AddDownloads(services.Database);
+            await checksums.AddDownloadsAsync(db, cts.Token);
+
+            var scanner = new ArchiveIntegrityScanner(
+                db, logger: services.LoggerFactory?.CreateLogger<ArchiveIntegrityScanner>());
+            var options = new ArchiveScanOptions
+            {
+                Deep = !settings.Quick,
+                Force = settings.Force,
+                MaxParallelismPerDevice = settings.Parallelism,
+                Checksums = checksums
+            };
+
+            var report = await AnsiConsole.Status().StartAsync("Scanning archives...", async ctx =>
+            {
+                var done = 0;
+                var progress = new Progress<ArchiveIntegrityResult>(r =>
+                {
+                    done++;
+                    ctx.Status($"Scanning archives... {done} ({Markup.Escape(Path.GetFileName(r.Path))})");
+                });
+                return await scanner.ScanAsync(directory, options, progress, cts.Token);
+            });
+
+            var shown = settings.All ? report.Results : report.Problems.ToList();
+            if (shown.Count > 0)
+            {
+                var table = new Table();
+                table.AddColumn("Archive");
+                table.AddColumn("Format");
+                table.AddColumn("Status");
+                table.AddColumn("Detail");
+
+                foreach (var result in shown)
+                {
+                    table.AddRow(
+                        Markup.Escape(Path.GetRelativePath(directory, result.Path)),
+                        result.Format,
+                        FormatStatus(result),
+                        Markup.Escape(result.Detail ?? string.Empty));
+                }
+
+                AnsiConsole.Write(table);
+            }
+
+            var problems = report.Problems.Count();
+            AnsiConsole.MarkupLine(
+                $"[bold]{report.Results.Count}[/] archives: {report.CheckedCount} checked, " +
+                $"{report.CachedCount} unchanged, " +
+                (problems > 0 ? $"[red]{problems} with problems[/]" : "[green]no problems[/]") +
+                $" ({report.Duration.TotalSeconds:F1}s)");
+
+            services.Dispose();
+            return problems > 0 ? 2 : 0;
+        }
+        catch (OperationCanceledException)
+        {
+            AnsiConsole.MarkupLine("[yellow]Scan cancelled; completed results were saved.[/]");
+            return 1;
+        }
+        catch (Exception ex)
+        {
+            AnsiConsole.MarkupLine($"[red]Error:[/] {Markup.Escape(ex.Message)}");
+            if (settings.Verbose)
+                AnsiConsole.WriteException(ex);
+            return 1;
+        }
+    }
+
+    private static string FormatStatus(ArchiveIntegrityResult result) => result.Status switch
+    {
+        ArchiveIntegrityStatus.Ok when result.ChecksumVerified => "[green]OK (checksum)[/]",
+        ArchiveIntegrityStatus.Ok => "[green]OK[/]",
+        ArchiveIntegrityStatus.Truncated => "[red]Truncated[/]",
+        ArchiveIntegrityStatus.Corrupt => "[red]Corrupt[/]",
+        ArchiveIntegrityStatus.ChecksumMismatch => "[red]Checksum mismatch[/]",
+        _ => "[yellow]Unreadable[/]"
+    };
+}
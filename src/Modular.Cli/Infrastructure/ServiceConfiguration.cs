@@ -8,11 +8,13 @@ using Modular.Core.Configuration;
 using Modular.Core.Database;
 using Modular.Core.Dependencies;
 using Modular.Core.Diagnostics;
+using Modular.Core.Exceptions;
 using Modular.Core.Plugins;
 using Modular.Core.Profiles;
 using Modular.Core.RateLimiting;
 using Modular.Core.Services;
 using Modular.Core.Telemetry;
+using Modular.Core.Updates;
 
 namespace Modular.Cli.Infrastructure;
 
@@ -89,7 +91,7 @@ public sealed class RuntimeServices : IDisposable
     /// </summary>
     public static async Task<RuntimeServices> InitializeMinimalAsync(bool verbose = false)
     {
-        var configService = new ConfigurationService();
+        var configService = new ConfigurationService(CredentialService.CreateDefault());
         var settings = await configService.LoadAsync();
         settings.Verbose = verbose;
 
@@ -126,30 +128,46 @@ public sealed class RuntimeServices : IDisposable
     /// </summary>
     public static async Task<RuntimeServices> InitializeAsync(bool verbose = false)
     {
-        var configService = new ConfigurationService();
+        var loggerFactory = verbose ? ServiceConfiguration.CreateLoggerFactory(verbose) : null;
+
+        var credentials = CredentialService.CreateDefault(loggerFactory?.CreateLogger<CredentialService>());
+        var configService = new ConfigurationService(credentials);
         var settings = await configService.LoadAsync();
         settings.Verbose = verbose;
 
-        var loggerFactory = verbose ? ServiceConfiguration.CreateLoggerFactory(verbose) : null;
+        var ssoClient = new NexusSsoClient(
+            settings.NexusApplicationSlug,
+            loggerFactory?.CreateLogger<NexusSsoClient>());
 
-        // If no API key and SSO is enabled, run the SSO flow
-        if (string.IsNullOrWhiteSpace(settings.NexusApiKey) && settings.NexusSsoEnabled)
+        async Task<string> AuthorizeAsync(CancellationToken ct)
         {
-            Console.WriteLine("No NexusMods API key found. Starting browser authorization...");
+            Console.WriteLine("Starting NexusMods browser authorization...");
             Console.WriteLine("A browser window will open. Please log in and authorize Modular.");
             Console.WriteLine();
-
-            var ssoClient = new NexusSsoClient(
-                settings.NexusApplicationSlug,
-                loggerFactory?.CreateLogger<NexusSsoClient>());
-
-            settings.NexusApiKey = await ssoClient.AuthenticateAsync();
-            await configService.SaveAsync(settings);
-            Console.WriteLine("Authorization successful! API key saved to config.");
+            var apiKey = await ssoClient.AuthenticateAsync(ct);
+            Console.WriteLine($"Authorization successful! API key saved to the {credentials.StoreName} credential store.");
+            return apiKey;
         }
 
+        // If no API key and SSO is enabled, run the SSO flow
+        if (string.IsNullOrWhiteSpace(settings.NexusApiKey) && settings.NexusSsoEnabled)
+            settings.NexusApiKey = await credentials.RefreshAsync(CredentialService.NexusApiKeyName, null, AuthorizeAsync);
+
         configService.Validate(settings, requireNexusKey: true);
 
+        // Validation results are shared between processes, so bursts of invocations
+        // (e.g. Lutris pre-launch hooks) reuse a single /users/validate call
+        var validation = await credentials.ValidateAsync(
+            CredentialService.NexusApiKeyName, settings.NexusApiKey, new NexusApiKeyValidator());
+        if (validation is { IsValid: false })
+        {
+            if (!settings.NexusSsoEnabled)
+                throw new ConfigException("NexusMods API key was rejected. Run 'modular login' or update 'nexus_api_key'.", "nexus_api_key");
+
+            settings.NexusApiKey = await credentials.RefreshAsync(
+                CredentialService.NexusApiKeyName, settings.NexusApiKey, AuthorizeAsync);
+        }
+
         var rateLimiter = new NexusRateLimiter(loggerFactory?.CreateLogger<NexusRateLimiter>());
         await rateLimiter.LoadStateAsync(settings.RateLimitStatePath);
 
@@ -212,6 +230,22 @@ public sealed class RuntimeServices : IDisposable
         return registry;
     }
 
+    /// <summary>
+    /// Creates update feeds for the backends in <paramref name="registry"/>.
+    /// </summary>
+    public List<IUpdateFeed> CreateUpdateFeeds(BackendRegistry registry)
+    {
+        var feeds = new List<IUpdateFeed>();
+
+        if (registry.Get("nexusmods") is NexusModsBackend nexus)
+            feeds.Add(new NexusUpdateFeed(nexus, Database, MetadataCache));
+
+        if (registry.Get("gamebanana") is GameBananaBackend gameBanana)
+            feeds.Add(new GameBananaUpdateFeed(gameBanana));
+
+        return feeds;
+    }
+
     /// <summary>
     /// Creates an aggregate version provider with all enabled backend providers.
     /// </summary>
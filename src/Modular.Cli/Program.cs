@@ -7,6 +7,7 @@ using Modular.Cli.Commands.Profile;
 using Modular.Cli.Commands.Switch;
 using Modular.Cli.Commands.Telemetry;
 using Modular.Cli.Infrastructure;
+using Modular.Core.Installers;
 using Spectre.Console.Cli;
 
 namespace Modular.Cli;
@@ -18,6 +19,9 @@ class Program
         var services = new ServiceCollection();
         services.ConfigureServices();
 
+        // Finish installs a crash interrupted before any command touches the game directories
+        ModInstallationService.RecoverInterruptedCommits();
+
         var registrar = new TypeRegistrar(services);
         var app = new CommandApp(registrar);
 
@@ -171,7 +175,8 @@ class Program
                 .WithExample("install", "mod.zip", "--game", "730")
                 .WithExample("install", "mod.zip", "--game", "Counter-Strike")
                 .WithExample("install", "mod.zip", "--game", "/path/to/game", "--dry-run")
-                .WithExample("install", "mod.zip", "--game", "730", "--force");
+                .WithExample("install", "mod.zip", "--game", "730", "--force")
+                .WithExample("install", "~/Downloads/mod.zip", "--game", "730", "--import");
 
             config.AddCommand<UninstallCommand>("uninstall")
                 .WithDescription("Uninstall a previously installed mod by changeset ID")
@@ -182,6 +187,18 @@ class Program
                 .WithExample("installed")
                 .WithExample("installed", "--game", "730");
 
+            config.AddCommand<OutdatedCommand>("outdated")
+                .WithDescription("List downloaded and tracked mods with updates available")
+                .WithExample("outdated")
+                .WithExample("outdated", "--game", "skyrimspecialedition")
+                .WithExample("outdated", "--refresh");
+
+            config.AddCommand<VerifyDownloadsCommand>("verify-downloads")
+                .WithDescription("Check downloaded archives for truncation, corruption and checksum mismatches")
+                .WithExample("verify-downloads")
+                .WithExample("verify-downloads", "~/Games/Mods-Lists", "--quick")
+                .WithExample("verify-downloads", "--force", "--all");
+
             // Game detection commands
             config.AddCommand<DetectGamesCommand>("detect-games")
                 .WithDescription("Scan for installed Steam games")
@@ -0,0 +1,125 @@
+using Modular.Core.Database;
+using Modular.Core.Dependencies;
+using Modular.Core.Utilities;
+
+namespace Modular.Core.Archives;
+
+/// <summary>
+/// Known checksums of downloaded archives, keyed by full path. Collected from
+/// download records (MD5 reported by the backend) and lockfile checksums; the
+/// algorithm is inferred from the hex length (MD5, SHA-1 or SHA-256).
+/// </summary>
+public sealed class ArchiveChecksumIndex
+{
+    private readonly Dictionary<string, string> _checksums = new(StringComparer.Ordinal);
+
+    /// <summary>
+    /// Number of archives with a known checksum.
+    /// </summary>
+    public int Count => _checksums.Count;
+
+    /// <summary>
+    /// Records the expected checksum of a file. Later additions win.
+    /// </summary>
+    public void Add(string path, string? checksum)
+    {
+        if (string.IsNullOrWhiteSpace(path) || TryGetAlgorithm(checksum) == null)
+            return;
+
+        _checksums[Path.GetFullPath(path)] = checksum!.Trim().ToLowerInvariant();
+    }
+
+    /// <summary>
+    /// Adds the expected MD5 of every record in a download database.
+    /// </summary>
+    public void AddDownloads(DownloadDatabase database)
+    {
+        foreach (var record in database.GetAllRecords())
+            Add(record.Filepath, record.Md5Expected);
+    }
+
+    /// <summary>
+    /// Adds the expected MD5 of every row in the SQLite <c>downloads</c> table.
+    /// </summary>
+    public async Task AddDownloadsAsync(ModularDatabase database, CancellationToken ct = default)
+    {
+        var connection = await database.GetConnectionAsync();
+        await using var cmd = connection.CreateCommand();
+        cmd.CommandText = "SELECT file_path, md5_expected FROM downloads WHERE md5_expected <> ''";
+
+        await using var reader = await cmd.ExecuteReaderAsync(ct);
+        while (await reader.ReadAsync(ct))
+            Add(reader.GetString(0), reader.GetString(1));
+    }
+
+    /// <summary>
+    /// Adds lockfile checksums. Lockfile keys are resolved against the download
+    /// root as either a file or a mod directory (":" treated as a separator, so
+    /// "skyrimspecialedition:1234" matches skyrimspecialedition/1234/); a
+    /// directory only matches when it holds exactly one archive.
+    /// </summary>
+    public void AddLockfile(ModLockfile lockfile, string downloadsRoot)
+    {
+        foreach (var (key, mod) in lockfile.Mods)
+        {
+            if (TryGetAlgorithm(mod.Checksum) == null)
+                continue;
+
+            var path = ResolveLockfileKey(key, downloadsRoot);
+            if (path != null)
+                Add(path, mod.Checksum);
+        }
+    }
+
+    /// <summary>
+    /// Looks up the expected checksum of a file.
+    /// </summary>
+    public bool TryGet(string path, out string checksum) =>
+        _checksums.TryGetValue(Path.GetFullPath(path), out checksum!);
+
+    /// <summary>
+    /// Infers the hash algorithm from a hex checksum's length, or null if it isn't one.
+    /// </summary>
+    public static HashAlgorithmKind? TryGetAlgorithm(string? checksum)
+    {
+        var value = checksum?.Trim();
+        if (string.IsNullOrEmpty(value) || !value.All(Uri.IsHexDigit))
+            return null;
+
+        return value.Length switch
+        {
+            32 => HashAlgorithmKind.MD5,
+            40 => HashAlgorithmKind.SHA1,
+            64 => HashAlgorithmKind.SHA256,
+            _ => null
+        };
+    }
+
+    private static string? ResolveLockfileKey(string key, string downloadsRoot)
+    {
+        var relative = key.Replace(':', '/').Trim('/');
+        var candidates = new List<string> { relative };
+
+        // Canonical ids carry a backend prefix ("nexusmods:domain:id") the directory layout doesn't
+        var firstSeparator = relative.IndexOf('/');
+        if (firstSeparator > 0)
+            candidates.Add(relative[(firstSeparator + 1)..]);
+
+        var factory = new ArchiveReaderFactory();
+        foreach (var candidate in candidates)
+        {
+            var path = Path.Combine(downloadsRoot, candidate);
+            if (File.Exists(path))
+                return path;
+
+            if (!Directory.Exists(path))
+                continue;
+
+            var archives = Directory.EnumerateFiles(path).Where(factory.IsSupported).Take(2).ToList();
+            if (archives.Count == 1)
+                return archives[0];
+        }
+
+        return null;
+    }
+}
@@ -0,0 +1,350 @@
+using System.Buffers;
+using System.Threading.Channels;
+using Microsoft.Win32.SafeHandles;
+using Modular.Core.Utilities;
+
+namespace Modular.Core.Archives;
+
+/// <summary>
+/// Writes extracted archive entries to disk with a write path chosen by size.
+/// Small entries are read into memory and, during a batch, written by a
+/// background writer so decompression doesn't wait on file creation. Larger
+/// entries are copied through a pooled buffer into a file whose length is
+/// set up front. Large ones also leave all-zero blocks as holes and are
+/// dropped from the page cache as they are written, so a multi-GB texture
+/// pack doesn't evict everything else the system has cached.
+/// </summary>
+public static class ArchiveEntryWriter
+{
+    /// <summary>
+    /// Entries up to this size are read whole and written with one call.
+    /// </summary>
+    public const int SmallFileThreshold = 128 * 1024;
+
+    /// <summary>
+    /// Entries from this size take the large-file path.
+    /// </summary>
+    public const long LargeFileThreshold = 64L * 1024 * 1024;
+
+    private const int BufferSize = 1024 * 1024;
+    private const int LargeBufferSize = 4 * 1024 * 1024;
+
+    // Granularity of holes; matches common filesystem extent alignment
+    private const int HoleBlockSize = 64 * 1024;
+
+    // How much is written before the previous range is flushed and dropped
+    private const long CacheWindow = 32L * 1024 * 1024;
+
+    /// <summary>
+    /// Writes <paramref name="source"/> to <paramref name="destinationPath"/>.
+    /// </summary>
+    /// <param name="length">Uncompressed size from the archive index, or a
+    /// negative value when unknown. Only used to choose the write path and
+    /// preallocate; the file gets exactly the bytes the stream yields.</param>
+    public static async Task WriteAsync(
+        Stream source,
+        string destinationPath,
+        long length,
+        bool overwrite,
+        DateTimeOffset? lastWriteTime = null,
+        CancellationToken ct = default)
+    {
+        if (length >= 0 && length <= SmallFileThreshold)
+        {
+            var (buffer, count) = await ReadSmallAsync(source, length, ct);
+            try
+            {
+                WriteSmall(destinationPath, buffer, count, overwrite, lastWriteTime);
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+
+            return;
+        }
+
+        await WriteStreamingAsync(source, destinationPath, length, overwrite, ct);
+        if (lastWriteTime.HasValue)
+            File.SetLastWriteTimeUtc(destinationPath, lastWriteTime.Value.UtcDateTime);
+    }
+
+    /// <summary>
+    /// Starts a batch for extracting many entries. Small entries written
+    /// through it complete in the background; dispose or
+    /// <see cref="ExtractionBatch.CompleteAsync"/> the batch to wait for them.
+    /// </summary>
+    public static ExtractionBatch BeginBatch(CancellationToken ct = default) => new(ct);
+
+    private static async Task<(byte[] Buffer, int Count)> ReadSmallAsync(Stream source, long length, CancellationToken ct)
+    {
+        var buffer = ArrayPool<byte>.Shared.Rent((int)Math.Max(length, 1));
+        var count = 0;
+        try
+        {
+            while (true)
+            {
+                if (count == buffer.Length)
+                {
+                    // The archive index understated the size
+                    var larger = ArrayPool<byte>.Shared.Rent(buffer.Length * 2);
+                    buffer.AsSpan(0, count).CopyTo(larger);
+                    ArrayPool<byte>.Shared.Return(buffer);
+                    buffer = larger;
+                }
+
+                var read = await source.ReadAsync(buffer.AsMemory(count), ct);
+                if (read == 0)
+                    return (buffer, count);
+                count += read;
+            }
+        }
+        catch
+        {
+            ArrayPool<byte>.Shared.Return(buffer);
+            throw;
+        }
+    }
+
+    private static void WriteSmall(string path, byte[] buffer, int count, bool overwrite, DateTimeOffset? lastWriteTime)
+    {
+        using (var handle = File.OpenHandle(path, overwrite ? FileMode.Create : FileMode.CreateNew, FileAccess.Write))
+        {
+            if (count > 0)
+                RandomAccess.Write(handle, buffer.AsSpan(0, count), 0);
+        }
+
+        if (lastWriteTime.HasValue)
+            File.SetLastWriteTimeUtc(path, lastWriteTime.Value.UtcDateTime);
+    }
+
+    private static async Task WriteStreamingAsync(
+        Stream source,
+        string path,
+        long length,
+        bool overwrite,
+        CancellationToken ct)
+    {
+        var large = length >= LargeFileThreshold;
+        var dropCache = large && PageCache.IsSupported;
+
+        // Without page-cache control, bypass the write cache for large files instead
+        var options = large && !dropCache ? FileOptions.WriteThrough : FileOptions.None;
+        var mode = overwrite ? FileMode.Create : FileMode.CreateNew;
+
+        // Large files get their length set instead of allocated, so zero blocks stay holes
+        using var handle = File.OpenHandle(path, mode, FileAccess.Write, FileShare.None, options,
+            preallocationSize: !large && length > 0 ? length : 0);
+        if (large)
+            RandomAccess.SetLength(handle, length);
+
+        var buffer = ArrayPool<byte>.Shared.Rent(large ? LargeBufferSize : BufferSize);
+        try
+        {
+            long offset = 0;
+            long released = 0;
+            long writebackStarted = 0;
+
+            while (true)
+            {
+                var read = await ReadBlockAsync(source, buffer, ct);
+                if (read == 0)
+                    break;
+
+                if (large)
+                    await WriteSkippingZerosAsync(handle, buffer.AsMemory(0, read), offset, ct);
+                else
+                    await RandomAccess.WriteAsync(handle, buffer.AsMemory(0, read), offset, ct);
+                offset += read;
+
+                if (dropCache && offset - writebackStarted >= CacheWindow)
+                {
+                    // Write back the window just filled while the previous one is waited for and dropped
+                    PageCache.StartWriteback(handle, writebackStarted, offset - writebackStarted);
+                    PageCache.Release(handle, released, writebackStarted - released);
+                    released = writebackStarted;
+                    writebackStarted = offset;
+                }
+            }
+
+            if (RandomAccess.GetLength(handle) != offset)
+                RandomAccess.SetLength(handle, offset);
+
+            if (dropCache)
+                PageCache.Release(handle, released, offset - released);
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(buffer);
+        }
+    }
+
+    /// <summary>
+    /// Fills the buffer unless the stream ends, so write offsets stay aligned
+    /// to the buffer size.
+    /// </summary>
+    private static async Task<int> ReadBlockAsync(Stream source, byte[] buffer, CancellationToken ct)
+    {
+        var total = 0;
+        while (total < buffer.Length)
+        {
+            var read = await source.ReadAsync(buffer.AsMemory(total), ct);
+            if (read == 0)
+                break;
+            total += read;
+        }
+
+        return total;
+    }
+
+    /// <summary>
+    /// Writes the non-zero blocks of <paramref name="data"/>; the file was
+    /// created empty, so skipped blocks read back as zeros.
+    /// </summary>
+    private static async Task WriteSkippingZerosAsync(SafeFileHandle handle, ReadOnlyMemory<byte> data, long offset, CancellationToken ct)
+    {
+        var runStart = -1;
+        for (var position = 0; position < data.Length; position += HoleBlockSize)
+        {
+            var isZero = IsZero(data.Span.Slice(position, Math.Min(HoleBlockSize, data.Length - position)));
+
+            if (!isZero && runStart < 0)
+            {
+                runStart = position;
+            }
+            else if (isZero && runStart >= 0)
+            {
+                await RandomAccess.WriteAsync(handle, data[runStart..position], offset + runStart, ct);
+                runStart = -1;
+            }
+        }
+
+        if (runStart >= 0)
+            await RandomAccess.WriteAsync(handle, data[runStart..], offset + runStart, ct);
+    }
+
+    private static bool IsZero(ReadOnlySpan<byte> block) => block.IndexOfAnyExcept((byte)0) < 0;
+
+    /// <summary>
+    /// Entries extracted together. Small files are queued to a single writer
+    /// thread; larger files are written by the caller as usual. Errors from
+    /// queued writes surface from the next write or from completion.
+    /// </summary>
+    public sealed class ExtractionBatch : IAsyncDisposable
+    {
+        // Bounds memory held by queued files to QueueCapacity * SmallFileThreshold
+        private const int QueueCapacity = 64;
+
+        private readonly Channel<PendingWrite> _queue = Channel.CreateBounded<PendingWrite>(
+            new BoundedChannelOptions(QueueCapacity) { SingleReader = true, SingleWriter = true });
+        private readonly Task _writer;
+        private readonly CancellationToken _ct;
+        private volatile Exception? _error;
+        private bool _completed;
+
+        internal ExtractionBatch(CancellationToken ct)
+        {
+            _ct = ct;
+            _writer = Task.Factory.StartNew(DrainAsync, CancellationToken.None,
+                TaskCreationOptions.LongRunning, TaskScheduler.Default).Unwrap();
+        }
+
+        /// <summary>
+        /// Number of files handed to the background writer.
+        /// </summary>
+        public int QueuedFileCount { get; private set; }
+
+        /// <summary>
+        /// Writes an entry; small ones are queued and may not exist on disk
+        /// until the batch completes.
+        /// </summary>
+        public async Task WriteAsync(
+            Stream source,
+            string destinationPath,
+            long length,
+            bool overwrite,
+            DateTimeOffset? lastWriteTime = null)
+        {
+            ThrowIfFailed();
+
+            if (length < 0 || length > SmallFileThreshold)
+            {
+                await ArchiveEntryWriter.WriteAsync(source, destinationPath, length, overwrite, lastWriteTime, _ct);
+                return;
+            }
+
+            if (!overwrite && File.Exists(destinationPath))
+                throw new IOException($"File already exists: {destinationPath}");
+
+            var (buffer, count) = await ReadSmallAsync(source, length, _ct);
+            try
+            {
+                await _queue.Writer.WriteAsync(new PendingWrite(destinationPath, buffer, count, overwrite, lastWriteTime), _ct);
+                QueuedFileCount++;
+            }
+            catch
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Waits for all queued files to be written.
+        /// </summary>
+        public async Task CompleteAsync()
+        {
+            if (!_completed)
+            {
+                _completed = true;
+                _queue.Writer.TryComplete();
+            }
+
+            await _writer;
+            ThrowIfFailed();
+        }
+
+        public async ValueTask DisposeAsync()
+        {
+            _queue.Writer.TryComplete();
+            try
+            {
+                await _writer;
+            }
+            catch
+            {
+                // Reported through CompleteAsync; disposal after a failure just cleans up
+            }
+        }
+
+        private async Task DrainAsync()
+        {
+            await foreach (var write in _queue.Reader.ReadAllAsync(CancellationToken.None))
+            {
+                try
+                {
+                    if (_error == null && !_ct.IsCancellationRequested)
+                        WriteSmall(write.Path, write.Buffer, write.Count, write.Overwrite, write.LastWriteTime);
+                }
+                catch (Exception ex)
+                {
+                    _error ??= ex;
+                }
+                finally
+                {
+                    ArrayPool<byte>.Shared.Return(write.Buffer);
+                }
+            }
+        }
+
+        private void ThrowIfFailed()
+        {
+            _ct.ThrowIfCancellationRequested();
+            if (_error != null)
+                throw new IOException($"Writing extracted files failed: {_error.Message}", _error);
+        }
+
+        private readonly record struct PendingWrite(
+            string Path, byte[] Buffer, int Count, bool Overwrite, DateTimeOffset? LastWriteTime);
+    }
+}
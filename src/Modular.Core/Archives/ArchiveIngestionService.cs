@@ -0,0 +1,287 @@
+using System.Buffers;
+using System.Security.Cryptography;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Exceptions;
+using Modular.Core.Resilience;
+using Modular.Core.Utilities;
+
+namespace Modular.Core.Archives;
+
+/// <summary>
+/// Brings an archive into the download library with as little I/O as the
+/// filesystem allows: rename(2) when moving within one filesystem, a FICLONE
+/// reflink when copying on btrfs/XFS, and only otherwise a streamed copy that
+/// hashes the data as it goes. The archive is then registered in the
+/// inventory without being read again for its hash.
+/// </summary>
+public sealed class ArchiveIngestionService
+{
+    private const int CopyBufferSize = 1024 * 1024;
+
+    private readonly ArchiveInventoryService? _inventory;
+    private readonly ILogger<ArchiveIngestionService>? _logger;
+    private readonly ResilienceEngine _resilience;
+
+    /// <summary>
+    /// Creates an ingestion service.
+    /// </summary>
+    /// <param name="inventory">Inventory to register ingested archives in, or null to skip registration.</param>
+    /// <param name="logger">Optional logger.</param>
+    /// <param name="resilience">Retries renames and deletes that hit a locked or busy file.</param>
+    public ArchiveIngestionService(
+        ArchiveInventoryService? inventory = null,
+        ILogger<ArchiveIngestionService>? logger = null,
+        ResilienceEngine? resilience = null)
+    {
+        _inventory = inventory;
+        _logger = logger;
+        _resilience = resilience ?? ResilienceEngine.Shared;
+    }
+
+    /// <summary>
+    /// Ingests <paramref name="sourcePath"/> as <paramref name="destinationPath"/>.
+    /// </summary>
+    /// <param name="sourcePath">Archive to import (a finished download, a dropped file...).</param>
+    /// <param name="destinationPath">Final path inside the library.</param>
+    /// <param name="options">Ingestion options.</param>
+    /// <param name="progress">Bytes copied / total, reported only for streamed copies.</param>
+    /// <param name="ct">Cancellation token.</param>
+    /// <exception cref="FileSystemException">The source is missing or the destination exists.</exception>
+    public async Task<IngestResult> IngestAsync(
+        string sourcePath,
+        string destinationPath,
+        IngestOptions? options = null,
+        IProgress<(long copied, long total)>? progress = null,
+        CancellationToken ct = default)
+    {
+        options ??= new IngestOptions();
+        var source = Path.GetFullPath(sourcePath);
+        var destination = Path.GetFullPath(destinationPath);
+
+        if (!File.Exists(source))
+            throw new FileSystemException("Archive to ingest not found", source);
+
+        var result = new IngestResult { SourcePath = source, Path = destination, SizeBytes = new FileInfo(source).Length };
+
+        if (string.Equals(source, destination, StringComparison.Ordinal))
+        {
+            result.Method = IngestMethod.InPlace;
+        }
+        else
+        {
+            if (File.Exists(destination) && !options.Overwrite)
+                throw new FileSystemException("Destination already exists in the library", destination);
+
+            var destinationDir = Path.GetDirectoryName(destination)!;
+            Directory.CreateDirectory(destinationDir);
+
+            var sameDevice = FileStat.TryGetDevice(source, out var sourceDevice) &&
+                             FileStat.TryGetDevice(destinationDir, out var destinationDevice) &&
+                             sourceDevice == destinationDevice;
+
+            if (options.Move && sameDevice)
+            {
+                await _resilience.ExecuteFileAsync(destination, () => File.Move(source, destination, options.Overwrite), ct);
+                result.Method = IngestMethod.Rename;
+            }
+            else
+            {
+                result.Sha256 = await CloneOrCopyAsync(source, destination, sameDevice, result, progress, ct);
+                if (options.Move)
+                    await _resilience.ExecuteFileAsync(source, () => File.Delete(source), ct);
+            }
+        }
+
+        _logger?.LogInformation("Ingested {Source} -> {Destination} via {Method}", source, destination, result.Method);
+
+        if (_inventory != null && options.Register)
+        {
+            try
+            {
+                result.Entries = await _inventory.RegisterAsync(destination, result.Sha256, ct);
+            }
+            catch (Exception ex) when (ex is InvalidOperationException or InvalidDataException or IOException)
+            {
+                // The file is in the library either way; a later install will surface the error
+                _logger?.LogWarning(ex, "Could not inventory {Archive}", destination);
+            }
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Writes a copy of <paramref name="source"/> next to <paramref name="destination"/>
+    /// and renames it into place, so a partial copy never appears under the final name.
+    /// Returns the SHA-256 when the data was streamed, or null for a reflink.
+    /// </summary>
+    private static async Task<string?> CloneOrCopyAsync(
+        string source,
+        string destination,
+        bool sameDevice,
+        IngestResult result,
+        IProgress<(long copied, long total)>? progress,
+        CancellationToken ct)
+    {
+        var tempPath = $"{destination}.{Environment.ProcessId}.ingest";
+        try
+        {
+            string? sha256 = null;
+
+            using (var sourceStream = new FileStream(source, FileMode.Open, FileAccess.Read, FileShare.Read, 1, FileOptions.SequentialScan))
+            {
+                var length = sourceStream.Length;
+
+                var cloned = false;
+                if (sameDevice)
+                {
+                    using var cloneHandle = File.OpenHandle(tempPath, FileMode.CreateNew, FileAccess.Write);
+                    cloned = FileClone.TryReflink(sourceStream.SafeFileHandle, cloneHandle);
+                }
+
+                if (cloned)
+                {
+                    result.Method = IngestMethod.Reflink;
+                }
+                else
+                {
+                    // Reserve the space up front so a full disk fails fast instead of mid-copy
+                    await using var tempStream = new FileStream(tempPath, new FileStreamOptions
+                    {
+                        Mode = FileMode.Create,
+                        Access = FileAccess.Write,
+                        Share = FileShare.None,
+                        BufferSize = 0,
+                        PreallocationSize = length
+                    });
+
+                    sha256 = await CopyWithHashAsync(sourceStream, tempStream, length, progress, ct);
+                    tempStream.Flush(flushToDisk: true);
+                    result.Method = IngestMethod.Copy;
+                }
+            }
+
+            File.SetLastWriteTimeUtc(tempPath, File.GetLastWriteTimeUtc(source));
+            File.Move(tempPath, destination, overwrite: true);
+            return sha256;
+        }
+        catch
+        {
+            TryDelete(tempPath);
+            throw;
+        }
+    }
+
+    private static async Task<string> CopyWithHashAsync(
+        Stream source,
+        Stream destination,
+        long length,
+        IProgress<(long copied, long total)>? progress,
+        CancellationToken ct)
+    {
+        using var hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+        var buffer = ArrayPool<byte>.Shared.Rent(CopyBufferSize);
+        try
+        {
+            long copied = 0;
+            var lastReport = Environment.TickCount64;
+            int read;
+            while ((read = await source.ReadAsync(buffer.AsMemory(0, CopyBufferSize), ct)) > 0)
+            {
+                hash.AppendData(buffer, 0, read);
+                await destination.WriteAsync(buffer.AsMemory(0, read), ct);
+                copied += read;
+
+                if (Environment.TickCount64 - lastReport >= 100)
+                {
+                    progress?.Report((copied, length));
+                    lastReport = Environment.TickCount64;
+                }
+            }
+
+            if (copied != length)
+                throw new IOException($"Source changed during copy: expected {length} bytes, read {copied}");
+
+            progress?.Report((copied, length));
+            return Convert.ToHexString(hash.GetHashAndReset()).ToLowerInvariant();
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(buffer);
+        }
+    }
+
+    private static void TryDelete(string path)
+    {
+        try
+        {
+            File.Delete(path);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // Leftover temp files are harmless and named so they're easy to spot
+        }
+    }
+}
+
+/// <summary>
+/// Options for <see cref="ArchiveIngestionService.IngestAsync"/>.
+/// </summary>
+public sealed class IngestOptions
+{
+    /// <summary>
+    /// Remove the source after ingesting (rename when possible). When false the
+    /// source is kept and the library gets a reflink or copy.
+    /// </summary>
+    public bool Move { get; init; }
+
+    /// <summary>
+    /// Replace an existing file at the destination.
+    /// </summary>
+    public bool Overwrite { get; init; }
+
+    /// <summary>
+    /// Register the archive in the inventory after ingesting.
+    /// </summary>
+    public bool Register { get; init; } = true;
+}
+
+/// <summary>
+/// How an archive reached the library.
+/// </summary>
+public enum IngestMethod
+{
+    /// <summary>Source already was the destination.</summary>
+    InPlace,
+
+    /// <summary>rename(2) within one filesystem; no data moved.</summary>
+    Rename,
+
+    /// <summary>Copy-on-write clone sharing the source's extents.</summary>
+    Reflink,
+
+    /// <summary>Streamed byte copy, hashed inline.</summary>
+    Copy
+}
+
+/// <summary>
+/// Outcome of ingesting one archive.
+/// </summary>
+public sealed class IngestResult
+{
+    public string SourcePath { get; init; } = string.Empty;
+    public string Path { get; init; } = string.Empty;
+    public long SizeBytes { get; init; }
+    public IngestMethod Method { get; set; }
+
+    /// <summary>
+    /// SHA-256 of the archive when it was streamed; null for renames and
+    /// reflinks, which never read the data.
+    /// </summary>
+    public string? Sha256 { get; set; }
+
+    /// <summary>
+    /// Inventory entries, or null if registration was skipped or failed.
+    /// </summary>
+    public List<ArchiveEntryRecord>? Entries { get; set; }
+}
@@ -0,0 +1,404 @@
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using Microsoft.Data.Sqlite;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Database;
+using Modular.Core.Utilities;
+using Modular.Sdk.Archives;
+
+namespace Modular.Core.Archives;
+
+/// <summary>
+/// Verifies every archive in a download library and records the outcome in the
+/// archive_integrity table. Files whose (size, mtime, inode) match the stored
+/// row are not reopened, so a warm rescan costs one stat per file. Cold checks
+/// run with bounded parallelism per block device: one reader on spinning disks,
+/// several on SSDs, with all devices scanned concurrently.
+/// </summary>
+public sealed class ArchiveIntegrityScanner
+{
+    private readonly ModularDatabase _database;
+    private readonly IArchiveReaderFactory _readerFactory;
+    private readonly ILogger<ArchiveIntegrityScanner>? _logger;
+
+    public ArchiveIntegrityScanner(
+        ModularDatabase database,
+        IArchiveReaderFactory? readerFactory = null,
+        ILogger<ArchiveIntegrityScanner>? logger = null)
+    {
+        _database = database;
+        _readerFactory = readerFactory ?? new ArchiveReaderFactory();
+        _logger = logger;
+    }
+
+    /// <summary>
+    /// Scans all supported archives under <paramref name="directory"/>.
+    /// </summary>
+    /// <param name="directory">Download library root.</param>
+    /// <param name="options">Scan options.</param>
+    /// <param name="progress">Receives each result as it completes, including cached ones.</param>
+    /// <param name="ct">Cancellation token. Results completed before cancellation are still saved.</param>
+    public async Task<ArchiveIntegrityReport> ScanAsync(
+        string directory,
+        ArchiveScanOptions? options = null,
+        IProgress<ArchiveIntegrityResult>? progress = null,
+        CancellationToken ct = default)
+    {
+        options ??= new ArchiveScanOptions();
+        var root = Path.GetFullPath(directory);
+        var stopwatch = Stopwatch.StartNew();
+
+        var connection = await _database.GetConnectionAsync();
+        var cached = await LoadResultsAsync(connection, root, ct);
+
+        var results = new ConcurrentBag<ArchiveIntegrityResult>();
+        var pending = new List<(string Path, FileStat Stat, string? Expected)>();
+        var seen = new HashSet<string>(StringComparer.Ordinal);
+
+        foreach (var path in EnumerateArchives(root))
+        {
+            if (!FileStat.TryGet(path, out var stat))
+                continue;
+
+            seen.Add(path);
+            string? expected = null;
+            if (options.Checksums?.TryGet(path, out var checksum) == true)
+                expected = checksum;
+
+            if (!options.Force &&
+                cached.TryGetValue(path, out var previous) &&
+                IsReusable(previous, stat, expected, options.Deep))
+            {
+                results.Add(previous);
+                progress?.Report(previous);
+                continue;
+            }
+
+            pending.Add((path, stat, expected));
+        }
+
+        var fresh = new ConcurrentQueue<ArchiveIntegrityResult>();
+        try
+        {
+            // Group by device so each disk gets its own concurrency budget; sorting by inode
+            // roughly follows on-disk layout, which matters on spinning disks
+            var groups = pending
+                .GroupBy(p => p.Stat.Device)
+                .Select(g =>
+                {
+                    var files = g.OrderBy(p => p.Stat.Inode).ToList();
+                    var parallelism = options.MaxParallelismPerDevice ?? StorageDevices.RecommendedParallelism(files[0].Stat);
+                    return (Files: files, Parallelism: Math.Max(1, parallelism));
+                })
+                .ToList();
+
+            await Task.WhenAll(groups.Select(group => Parallel.ForEachAsync(
+                group.Files,
+                new ParallelOptions { MaxDegreeOfParallelism = group.Parallelism, CancellationToken = ct },
+                async (file, token) =>
+                {
+                    var result = await CheckFileAsync(file.Path, file.Stat, file.Expected, options.Deep, token);
+                    fresh.Enqueue(result);
+                    results.Add(result);
+                    progress?.Report(result);
+                })));
+        }
+        finally
+        {
+            // Persist whatever finished, even when cancelled, so the next scan resumes
+            await SaveResultsAsync(connection, root, fresh.ToList(), ct.IsCancellationRequested ? null : seen);
+        }
+
+        _logger?.LogInformation(
+            "Integrity scan of {Root}: {Checked} checked, {Cached} unchanged, {Problems} problems in {Elapsed}ms",
+            root, fresh.Count, results.Count - fresh.Count,
+            results.Count(r => r.Status != ArchiveIntegrityStatus.Ok), stopwatch.ElapsedMilliseconds);
+
+        return new ArchiveIntegrityReport
+        {
+            Results = results.OrderBy(r => r.Path, StringComparer.Ordinal).ToList(),
+            CheckedCount = fresh.Count,
+            CachedCount = results.Count - fresh.Count,
+            Duration = stopwatch.Elapsed
+        };
+    }
+
+    /// <summary>
+    /// Gets stored results, optionally limited to a directory and to failures.
+    /// </summary>
+    public async Task<List<ArchiveIntegrityResult>> GetResultsAsync(
+        string? directory = null,
+        bool problemsOnly = false,
+        CancellationToken ct = default)
+    {
+        var connection = await _database.GetConnectionAsync();
+        var root = directory != null ? Path.GetFullPath(directory) : null;
+        var results = await LoadResultsAsync(connection, root, ct);
+
+        return results.Values
+            .Where(r => !problemsOnly || r.Status != ArchiveIntegrityStatus.Ok)
+            .OrderBy(r => r.Path, StringComparer.Ordinal)
+            .ToList();
+    }
+
+    /// <summary>
+    /// Checks a single archive: structure first, then the recorded checksum if any.
+    /// </summary>
+    internal static async Task<ArchiveIntegrityResult> CheckFileAsync(
+        string path, FileStat stat, string? expectedChecksum, bool deep, CancellationToken ct)
+    {
+        var check = ArchiveIntegrityChecker.Check(path, deep, ct);
+        var status = check.Status;
+        var detail = check.Detail;
+        var checksumVerified = false;
+
+        var algorithm = ArchiveChecksumIndex.TryGetAlgorithm(expectedChecksum);
+        if (status == ArchiveIntegrityStatus.Ok && algorithm != null)
+        {
+            try
+            {
+                var actual = await HashUtility.ComputeFileHashAsync(path, algorithm.Value, ct);
+                checksumVerified = actual.Equals(expectedChecksum, StringComparison.OrdinalIgnoreCase);
+                if (!checksumVerified)
+                {
+                    status = ArchiveIntegrityStatus.ChecksumMismatch;
+                    detail = $"{algorithm} expected {expectedChecksum}, got {actual}";
+                }
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                status = ArchiveIntegrityStatus.Unreadable;
+                detail = ex.Message;
+            }
+        }
+
+        return new ArchiveIntegrityResult
+        {
+            Path = path,
+            SizeBytes = stat.Size,
+            MtimeNs = stat.MtimeNs,
+            Inode = stat.Inode,
+            Device = stat.Device,
+            Format = check.Format,
+            Status = status,
+            Detail = detail,
+            EntryCount = check.EntryCount,
+            Deep = deep,
+            ExpectedChecksum = expectedChecksum,
+            ChecksumVerified = checksumVerified,
+            CheckedAt = DateTime.UtcNow
+        };
+    }
+
+    private static bool IsReusable(ArchiveIntegrityResult previous, FileStat stat, string? expected, bool deep) =>
+        previous.SizeBytes == stat.Size &&
+        previous.MtimeNs == stat.MtimeNs &&
+        previous.Inode == stat.Inode &&
+        (previous.Deep || !deep) &&
+        string.Equals(previous.ExpectedChecksum, expected, StringComparison.OrdinalIgnoreCase);
+
+    private IEnumerable<string> EnumerateArchives(string root)
+    {
+        if (!Directory.Exists(root))
+            return [];
+
+        var enumeration = new EnumerationOptions
+        {
+            RecurseSubdirectories = true,
+            IgnoreInaccessible = true,
+            AttributesToSkip = FileAttributes.ReparsePoint
+        };
+
+        return Directory.EnumerateFiles(root, "*", enumeration).Where(_readerFactory.IsSupported);
+    }
+
+    private static async Task<Dictionary<string, ArchiveIntegrityResult>> LoadResultsAsync(
+        SqliteConnection connection, string? root, CancellationToken ct)
+    {
+        await using var cmd = connection.CreateCommand();
+        cmd.CommandText = """
+            SELECT path, size_bytes, mtime_ns, inode, device, format, status, detail,
+                   entry_count, deep, expected_checksum, checksum_verified, checked_at_utc
+            FROM archive_integrity
+            """;
+
+        if (root != null)
+        {
+            // Prefix range instead of LIKE so paths containing % or _ need no escaping
+            cmd.CommandText += " WHERE path >= @from AND path < @to";
+            var prefix = Path.TrimEndingDirectorySeparator(root) + Path.DirectorySeparatorChar;
+            cmd.Parameters.AddWithValue("@from", prefix);
+            cmd.Parameters.AddWithValue("@to", prefix[..^1] + (char)(Path.DirectorySeparatorChar + 1));
+        }
+
+        var results = new Dictionary<string, ArchiveIntegrityResult>(StringComparer.Ordinal);
+        await using var reader = await cmd.ExecuteReaderAsync(ct);
+        while (await reader.ReadAsync(ct))
+        {
+            var result = new ArchiveIntegrityResult
+            {
+                Path = reader.GetString(0),
+                SizeBytes = reader.GetInt64(1),
+                MtimeNs = reader.GetInt64(2),
+                Inode = unchecked((ulong)reader.GetInt64(3)),
+                Device = unchecked((ulong)reader.GetInt64(4)),
+                Format = reader.GetString(5),
+                Status = Enum.TryParse<ArchiveIntegrityStatus>(reader.GetString(6), out var status) ? status : ArchiveIntegrityStatus.Corrupt,
+                Detail = reader.IsDBNull(7) ? null : reader.GetString(7),
+                EntryCount = reader.GetInt32(8),
+                Deep = reader.GetInt64(9) != 0,
+                ExpectedChecksum = reader.IsDBNull(10) ? null : reader.GetString(10),
+                ChecksumVerified = reader.GetInt64(11) != 0,
+                CheckedAt = DateTime.Parse(reader.GetString(12), null, System.Globalization.DateTimeStyles.RoundtripKind),
+                FromCache = true
+            };
+            results[result.Path] = result;
+        }
+
+        return results;
+    }
+
+    /// <summary>
+    /// Upserts fresh results and, when <paramref name="seen"/> is given, drops rows
+    /// under <paramref name="root"/> for files that no longer exist.
+    /// </summary>
+    private static async Task SaveResultsAsync(
+        SqliteConnection connection,
+        string root,
+        List<ArchiveIntegrityResult> results,
+        HashSet<string>? seen)
+    {
+        await using var transaction = (SqliteTransaction)await connection.BeginTransactionAsync();
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = """
+                INSERT OR REPLACE INTO archive_integrity
+                    (path, size_bytes, mtime_ns, inode, device, format, status, detail,
+                     entry_count, deep, expected_checksum, checksum_verified, checked_at_utc)
+                VALUES (@path, @size, @mtime, @inode, @device, @format, @status, @detail,
+                        @entries, @deep, @expected, @verified, @checked)
+                """;
+
+            foreach (var result in results)
+            {
+                cmd.Parameters.Clear();
+                cmd.Parameters.AddWithValue("@path", result.Path);
+                cmd.Parameters.AddWithValue("@size", result.SizeBytes);
+                cmd.Parameters.AddWithValue("@mtime", result.MtimeNs);
+                cmd.Parameters.AddWithValue("@inode", unchecked((long)result.Inode));
+                cmd.Parameters.AddWithValue("@device", unchecked((long)result.Device));
+                cmd.Parameters.AddWithValue("@format", result.Format);
+                cmd.Parameters.AddWithValue("@status", result.Status.ToString());
+                cmd.Parameters.AddWithValue("@detail", (object?)result.Detail ?? DBNull.Value);
+                cmd.Parameters.AddWithValue("@entries", result.EntryCount);
+                cmd.Parameters.AddWithValue("@deep", result.Deep ? 1 : 0);
+                cmd.Parameters.AddWithValue("@expected", (object?)result.ExpectedChecksum ?? DBNull.Value);
+                cmd.Parameters.AddWithValue("@verified", result.ChecksumVerified ? 1 : 0);
+                cmd.Parameters.AddWithValue("@checked", result.CheckedAt.ToString("O"));
+                await cmd.ExecuteNonQueryAsync();
+            }
+        }
+
+        if (seen != null)
+        {
+            var stale = (await LoadResultsAsync(connection, root, CancellationToken.None)).Keys
+                .Where(path => !seen.Contains(path))
+                .ToList();
+
+            await using var cmd = connection.CreateCommand();
+            cmd.Transaction = transaction;
+            cmd.CommandText = "DELETE FROM archive_integrity WHERE path = @path";
+            foreach (var path in stale)
+            {
+                cmd.Parameters.Clear();
+                cmd.Parameters.AddWithValue("@path", path);
+                await cmd.ExecuteNonQueryAsync();
+            }
+        }
+
+        await transaction.CommitAsync();
+    }
+}
+
+/// <summary>
+/// Options for <see cref="ArchiveIntegrityScanner.ScanAsync"/>.
+/// </summary>
+public sealed class ArchiveScanOptions
+{
+    /// <summary>
+    /// Decompress entries and verify CRCs. When false only headers and end
+    /// markers are checked. A deep result also satisfies a later shallow scan.
+    /// </summary>
+    public bool Deep { get; init; } = true;
+
+    /// <summary>
+    /// Re-check every file even if unchanged since the last scan.
+    /// </summary>
+    public bool Force { get; init; }
+
+    /// <summary>
+    /// Overrides the per-device concurrency derived from the disk type.
+    /// </summary>
+    public int? MaxParallelismPerDevice { get; init; }
+
+    /// <summary>
+    /// Expected checksums to verify against, if any.
+    /// </summary>
+    public ArchiveChecksumIndex? Checksums { get; init; }
+}
+
+/// <summary>
+/// Integrity state of one archive.
+/// </summary>
+public sealed class ArchiveIntegrityResult
+{
+    public string Path { get; init; } = string.Empty;
+    public long SizeBytes { get; init; }
+    public long MtimeNs { get; init; }
+    public ulong Inode { get; init; }
+    public ulong Device { get; init; }
+    public string Format { get; init; } = "unknown";
+    public ArchiveIntegrityStatus Status { get; init; }
+    public string? Detail { get; init; }
+    public int EntryCount { get; init; }
+    public bool Deep { get; init; }
+    public string? ExpectedChecksum { get; init; }
+    public bool ChecksumVerified { get; init; }
+    public DateTime CheckedAt { get; init; }
+
+    /// <summary>
+    /// Whether this result was reused from a previous scan.
+    /// </summary>
+    public bool FromCache { get; init; }
+}
+
+/// <summary>
+/// Summary of a library scan.
+/// </summary>
+public sealed class ArchiveIntegrityReport
+{
+    /// <summary>
+    /// One result per archive found, sorted by path.
+    /// </summary>
+    public IReadOnlyList<ArchiveIntegrityResult> Results { get; init; } = [];
+
+    /// <summary>
+    /// Archives opened and checked in this scan.
+    /// </summary>
+    public int CheckedCount { get; init; }
+
+    /// <summary>
+    /// Archives skipped because they were unchanged since the last scan.
+    /// </summary>
+    public int CachedCount { get; init; }
+
+    public TimeSpan Duration { get; init; }
+
+    /// <summary>
+    /// Results whose status is not <see cref="ArchiveIntegrityStatus.Ok"/>.
+    /// </summary>
+    public IEnumerable<ArchiveIntegrityResult> Problems =>
+        Results.Where(r => r.Status != ArchiveIntegrityStatus.Ok);
+}
@@ -43,7 +43,22 @@ public class ArchiveInventoryService
             return cached;
 
         // Scan and cache
-        return await ScanAndCacheAsync(connection, archivePath, ct);
+        var sha256 = await HashUtility.ComputeFileHashAsync(archivePath, ct: ct);
+        return await ScanAndCacheAsync(connection, archivePath, sha256, ct);
+    }
+
+    /// <summary>
+    /// Scans an archive and stores its inventory, replacing any cached one.
+    /// Used by ingestion, which already knows the hash (or deliberately skips
+    /// it for reflinks and renames); the file is not re-read to hash it.
+    /// </summary>
+    /// <param name="archivePath">Path to the archive file.</param>
+    /// <param name="sha256">Known SHA-256 of the archive, or null if not computed.</param>
+    /// <param name="ct">Cancellation token.</param>
+    public async Task<List<ArchiveEntryRecord>> RegisterAsync(string archivePath, string? sha256, CancellationToken ct = default)
+    {
+        var connection = await _database.GetConnectionAsync();
+        return await ScanAndCacheAsync(connection, archivePath, sha256, ct);
     }
 
     private async Task<List<ArchiveEntryRecord>?> GetCachedInventoryAsync(
@@ -93,17 +108,28 @@ public class ArchiveInventoryService
     }
 
     private async Task<List<ArchiveEntryRecord>> ScanAndCacheAsync(
-        SqliteConnection connection, string archivePath, CancellationToken ct)
+        SqliteConnection connection, string archivePath, string? sha256, CancellationToken ct)
     {
         using var archive = _readerFactory.Open(archivePath)
             ?? throw new InvalidOperationException($"Unsupported archive format: {archivePath}");
 
         var fileInfo = new FileInfo(archivePath);
-        var sha256 = await HashUtility.ComputeFileHashAsync(archivePath, ct: ct);
         var format = Path.GetExtension(archivePath).TrimStart('.');
 
+        await using var transaction = (SqliteTransaction)await connection.BeginTransactionAsync(ct);
+
+        // Drop entries of a previous scan; INSERT OR REPLACE below gives the archive a new id
+        await using (var deleteCmd = connection.CreateCommand())
+        {
+            deleteCmd.Transaction = transaction;
+            deleteCmd.CommandText = "DELETE FROM archive_entry WHERE archive_id IN (SELECT id FROM archive WHERE path = @path)";
+            deleteCmd.Parameters.AddWithValue("@path", archivePath);
+            await deleteCmd.ExecuteNonQueryAsync(ct);
+        }
+
         // Insert archive record
         await using var insertCmd = connection.CreateCommand();
+        insertCmd.Transaction = transaction;
         insertCmd.CommandText = """
             INSERT OR REPLACE INTO archive (path, size_bytes, mtime, sha256, format, entry_count, scanned_at_utc)
             VALUES (@path, @size, @mtime, @sha256, @format, @count, @scanned)
@@ -111,7 +137,7 @@ public class ArchiveInventoryService
         insertCmd.Parameters.AddWithValue("@path", archivePath);
         insertCmd.Parameters.AddWithValue("@size", fileInfo.Length);
         insertCmd.Parameters.AddWithValue("@mtime", fileInfo.LastWriteTimeUtc.ToString("O"));
-        insertCmd.Parameters.AddWithValue("@sha256", sha256);
+        insertCmd.Parameters.AddWithValue("@sha256", (object?)sha256 ?? DBNull.Value);
         insertCmd.Parameters.AddWithValue("@format", format);
         insertCmd.Parameters.AddWithValue("@count", archive.Entries.Count);
         insertCmd.Parameters.AddWithValue("@scanned", DateTime.UtcNow.ToString("O"));
@@ -119,6 +145,7 @@ public class ArchiveInventoryService
 
         // Get the archive ID
         await using var idCmd = connection.CreateCommand();
+        idCmd.Transaction = transaction;
         idCmd.CommandText = "SELECT id FROM archive WHERE path = @path";
         idCmd.Parameters.AddWithValue("@path", archivePath);
         var archiveId = (long)(await idCmd.ExecuteScalarAsync(ct))!;
@@ -138,6 +165,7 @@ public class ArchiveInventoryService
             entries.Add(record);
 
             await using var entryCmd = connection.CreateCommand();
+            entryCmd.Transaction = transaction;
             entryCmd.CommandText = """
                 INSERT INTO archive_entry (archive_id, inner_path, entry_type, size_bytes, compressed_bytes, crc32)
                 VALUES (@archiveId, @path, @type, @size, @compressed, @crc)
@@ -151,6 +179,8 @@ public class ArchiveInventoryService
             await entryCmd.ExecuteNonQueryAsync(ct);
         }
 
+        await transaction.CommitAsync(ct);
+
         _logger?.LogInformation("Scanned archive {Path}: {Count} entries", archivePath, entries.Count);
         return entries;
     }
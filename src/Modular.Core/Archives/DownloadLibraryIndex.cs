@@ -0,0 +1,378 @@
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.IO.Enumeration;
+using Microsoft.Data.Sqlite;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Database;
+using Modular.Core.Installers;
+using Modular.Sdk.Archives;
+
+namespace Modular.Core.Archives;
+
+/// <summary>
+/// Index of the archives in a download library: size, mtime, game and the
+/// installer that would handle each one, kept in the library_archive table.
+/// A refresh is one directory walk; only files that are new or whose size or
+/// mtime changed are opened again, so an unchanged library of tens of
+/// thousands of archives refreshes in well under a second.
+/// </summary>
+public sealed class DownloadLibraryIndex
+{
+    private readonly ModularDatabase _database;
+    private readonly InstallerManager? _installers;
+    private readonly IArchiveReaderFactory _readerFactory;
+    private readonly ILogger<DownloadLibraryIndex>? _logger;
+    private readonly SemaphoreSlim _lock = new(1, 1);
+
+    // Rows per library root, read from the database on first use of that root
+    private readonly Dictionary<string, Dictionary<string, LibraryArchive>> _loaded = new(StringComparer.Ordinal);
+
+    /// <param name="database">Database holding the index. Scans save in a
+    /// transaction, so an index used off the UI thread needs a database (and
+    /// connection) of its own.</param>
+    /// <param name="installers">Detects the installer for new archives; none is recorded when null.</param>
+    /// <param name="readerFactory">Decides which files are archives.</param>
+    /// <param name="logger">Optional logger.</param>
+    public DownloadLibraryIndex(
+        ModularDatabase database,
+        InstallerManager? installers = null,
+        IArchiveReaderFactory? readerFactory = null,
+        ILogger<DownloadLibraryIndex>? logger = null)
+    {
+        _database = database;
+        _installers = installers;
+        _readerFactory = readerFactory ?? new ArchiveReaderFactory();
+        _logger = logger;
+    }
+
+    /// <summary>
+    /// Archives indexed under <paramref name="directory"/> as of the last scan,
+    /// without touching the filesystem.
+    /// </summary>
+    public async Task<IReadOnlyList<LibraryArchive>> GetIndexedAsync(string directory, CancellationToken ct = default)
+    {
+        var root = Path.GetFullPath(directory);
+
+        await _lock.WaitAsync(ct);
+        try
+        {
+            return (await GetKnownAsync(root, ct)).Values.ToList();
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Walks <paramref name="directory"/> and brings the index up to date:
+    /// new and changed archives are inspected, deleted ones dropped.
+    /// </summary>
+    /// <param name="directory">Download library root.</param>
+    /// <param name="options">Scan options.</param>
+    /// <param name="ct">Cancellation token. Archives inspected before cancellation are still saved.</param>
+    public async Task<LibraryScanReport> ScanAsync(
+        string directory,
+        LibraryScanOptions? options = null,
+        CancellationToken ct = default)
+    {
+        options ??= new LibraryScanOptions();
+        var root = Path.GetFullPath(directory);
+        var stopwatch = Stopwatch.StartNew();
+
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var known = await GetKnownAsync(root, ct);
+            var archives = new List<LibraryArchive>(known.Count);
+            var pending = new List<LibraryFile>();
+            var seen = new HashSet<string>(known.Count, StringComparer.Ordinal);
+
+            foreach (var file in EnumerateArchives(root))
+            {
+                seen.Add(file.Path);
+                if (!options.Force &&
+                    known.TryGetValue(file.Path, out var previous) &&
+                    previous.SizeBytes == file.Size &&
+                    previous.MtimeTicks == file.MtimeTicks)
+                {
+                    archives.Add(previous);
+                    continue;
+                }
+
+                pending.Add(file);
+            }
+
+            var removed = known.Keys.Where(path => !seen.Contains(path)).ToList();
+            var inspected = new ConcurrentQueue<LibraryArchive>();
+            try
+            {
+                await Parallel.ForEachAsync(
+                    pending,
+                    new ParallelOptions { MaxDegreeOfParallelism = Math.Max(1, options.MaxParallelism), CancellationToken = ct },
+                    async (file, token) => inspected.Enqueue(await InspectAsync(root, file, token)));
+            }
+            finally
+            {
+                // Persist whatever finished, even when cancelled, so the next scan resumes
+                var fresh = inspected.ToList();
+                var dropped = ct.IsCancellationRequested ? [] : removed;
+                if (fresh.Count > 0 || dropped.Count > 0)
+                {
+                    var connection = await _database.GetConnectionAsync();
+                    await SaveAsync(connection, fresh, dropped);
+                }
+
+                foreach (var archive in fresh)
+                    known[archive.Path] = archive;
+                foreach (var path in dropped)
+                    known.Remove(path);
+            }
+
+            archives.AddRange(inspected);
+
+            _logger?.LogInformation(
+                "Library scan of {Root}: {Total} archives, {Inspected} inspected, {Removed} removed in {Elapsed}ms",
+                root, archives.Count, inspected.Count, removed.Count, stopwatch.ElapsedMilliseconds);
+
+            return new LibraryScanReport
+            {
+                Archives = archives,
+                InspectedCount = inspected.Count,
+                UnchangedCount = archives.Count - inspected.Count,
+                RemovedCount = removed.Count,
+                Duration = stopwatch.Elapsed
+            };
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Game domain of an archive: the top-level folder it sits in under the
+    /// library root, which is how downloads are laid out.
+    /// </summary>
+    internal static string? GameDomainFor(string root, string path)
+    {
+        var relative = Path.GetRelativePath(root, path);
+        var separator = relative.IndexOfAny([Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar]);
+        return separator > 0 ? relative[..separator] : null;
+    }
+
+    // Called under _lock
+    private async Task<Dictionary<string, LibraryArchive>> GetKnownAsync(string root, CancellationToken ct)
+    {
+        if (_loaded.TryGetValue(root, out var known))
+            return known;
+
+        var connection = await _database.GetConnectionAsync();
+        known = await LoadAsync(connection, root, ct);
+        _loaded[root] = known;
+        return known;
+    }
+
+    private IEnumerable<LibraryFile> EnumerateArchives(string root)
+    {
+        if (!Directory.Exists(root))
+            return [];
+
+        var enumeration = new EnumerationOptions
+        {
+            RecurseSubdirectories = true,
+            IgnoreInaccessible = true,
+            AttributesToSkip = FileAttributes.ReparsePoint
+        };
+
+        // Size and mtime come from the directory walk itself: one stat per file, no opens
+        return new FileSystemEnumerable<LibraryFile>(
+            root,
+            (ref FileSystemEntry entry) => new LibraryFile(entry.ToFullPath(), entry.Length, entry.LastWriteTimeUtc.UtcTicks),
+            enumeration)
+        {
+            ShouldIncludePredicate = (ref FileSystemEntry entry) =>
+                !entry.IsDirectory && _readerFactory.IsSupported(entry.FileName.ToString())
+        };
+    }
+
+    private async Task<LibraryArchive> InspectAsync(string root, LibraryFile file, CancellationToken ct)
+    {
+        string? installerId = null;
+        if (_installers != null)
+        {
+            try
+            {
+                installerId = (await _installers.SelectInstallerAsync(file.Path, ct: ct))?.Installer.InstallerId;
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or InvalidDataException)
+            {
+                _logger?.LogDebug("Could not inspect {Path}: {Message}", file.Path, ex.Message);
+            }
+        }
+
+        return new LibraryArchive
+        {
+            Path = file.Path,
+            SizeBytes = file.Size,
+            MtimeTicks = file.MtimeTicks,
+            GameDomain = GameDomainFor(root, file.Path),
+            InstallerId = installerId,
+            InspectedAt = DateTime.UtcNow
+        };
+    }
+
+    private static async Task<Dictionary<string, LibraryArchive>> LoadAsync(
+        SqliteConnection connection, string root, CancellationToken ct)
+    {
+        await using var cmd = connection.CreateCommand();
+
+        // Prefix range instead of LIKE so paths containing % or _ need no escaping
+        cmd.CommandText = """
+            SELECT path, size_bytes, mtime_ticks, game_domain, installer_id, inspected_at_utc
+            FROM library_archive
+            WHERE path >= @from AND path < @to
+            """;
+        var prefix = Path.TrimEndingDirectorySeparator(root) + Path.DirectorySeparatorChar;
+        cmd.Parameters.AddWithValue("@from", prefix);
+        cmd.Parameters.AddWithValue("@to", prefix[..^1] + (char)(Path.DirectorySeparatorChar + 1));
+
+        var archives = new Dictionary<string, LibraryArchive>(StringComparer.Ordinal);
+        await using var reader = await cmd.ExecuteReaderAsync(ct);
+        while (await reader.ReadAsync(ct))
+        {
+            var archive = new LibraryArchive
+            {
+                Path = reader.GetString(0),
+                SizeBytes = reader.GetInt64(1),
+                MtimeTicks = reader.GetInt64(2),
+                GameDomain = reader.IsDBNull(3) ? null : reader.GetString(3),
+                InstallerId = reader.IsDBNull(4) ? null : reader.GetString(4),
+                InspectedAt = DateTime.Parse(reader.GetString(5), null, System.Globalization.DateTimeStyles.RoundtripKind)
+            };
+            archives[archive.Path] = archive;
+        }
+
+        return archives;
+    }
+
+    private static async Task SaveAsync(
+        SqliteConnection connection,
+        List<LibraryArchive> archives,
+        List<string> removed)
+    {
+        await using var transaction = (SqliteTransaction)await connection.BeginTransactionAsync();
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = """
+                INSERT OR REPLACE INTO library_archive
+                    (path, size_bytes, mtime_ticks, game_domain, installer_id, inspected_at_utc)
+                VALUES (@path, @size, @mtime, @game, @installer, @inspected)
+                """;
+
+            foreach (var archive in archives)
+            {
+                cmd.Parameters.Clear();
+                cmd.Parameters.AddWithValue("@path", archive.Path);
+                cmd.Parameters.AddWithValue("@size", archive.SizeBytes);
+                cmd.Parameters.AddWithValue("@mtime", archive.MtimeTicks);
+                cmd.Parameters.AddWithValue("@game", (object?)archive.GameDomain ?? DBNull.Value);
+                cmd.Parameters.AddWithValue("@installer", (object?)archive.InstallerId ?? DBNull.Value);
+                cmd.Parameters.AddWithValue("@inspected", archive.InspectedAt.ToString("O"));
+                await cmd.ExecuteNonQueryAsync();
+            }
+        }
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = "DELETE FROM library_archive WHERE path = @path";
+            foreach (var path in removed)
+            {
+                cmd.Parameters.Clear();
+                cmd.Parameters.AddWithValue("@path", path);
+                await cmd.ExecuteNonQueryAsync();
+            }
+        }
+
+        await transaction.CommitAsync();
+    }
+
+    private readonly record struct LibraryFile(string Path, long Size, long MtimeTicks);
+}
+
+/// <summary>
+/// Options for <see cref="DownloadLibraryIndex.ScanAsync"/>.
+/// </summary>
+public sealed class LibraryScanOptions
+{
+    /// <summary>
+    /// Re-inspect every archive even if unchanged since the last scan.
+    /// </summary>
+    public bool Force { get; init; }
+
+    /// <summary>
+    /// Archives inspected at once. Inspection reads archive headers, so this
+    /// mostly bounds concurrent disk reads.
+    /// </summary>
+    public int MaxParallelism { get; init; } = Math.Clamp(Environment.ProcessorCount / 2, 1, 4);
+}
+
+/// <summary>
+/// One archive in the download library.
+/// </summary>
+public sealed class LibraryArchive
+{
+    public string Path { get; init; } = string.Empty;
+    public long SizeBytes { get; init; }
+
+    /// <summary>
+    /// Last write time in UTC ticks, as read during the directory walk.
+    /// </summary>
+    public long MtimeTicks { get; init; }
+
+    /// <summary>
+    /// Game domain from the folder layout, or null for archives at the library root.
+    /// </summary>
+    public string? GameDomain { get; init; }
+
+    /// <summary>
+    /// Installer selected for the archive, or null if none can handle it.
+    /// </summary>
+    public string? InstallerId { get; init; }
+
+    public DateTime InspectedAt { get; init; }
+
+    public string FileName => System.IO.Path.GetFileName(Path);
+    public DateTime LastWriteUtc => new(MtimeTicks, DateTimeKind.Utc);
+}
+
+/// <summary>
+/// Summary of a library scan.
+/// </summary>
+public sealed class LibraryScanReport
+{
+    /// <summary>
+    /// Every archive found, in no particular order.
+    /// </summary>
+    public IReadOnlyList<LibraryArchive> Archives { get; init; } = [];
+
+    /// <summary>
+    /// Archives opened in this scan because they were new or changed.
+    /// </summary>
+    public int InspectedCount { get; init; }
+
+    /// <summary>
+    /// Archives reused from the index.
+    /// </summary>
+    public int UnchangedCount { get; init; }
+
+    /// <summary>
+    /// Indexed archives that no longer exist.
+    /// </summary>
+    public int RemovedCount { get; init; }
+
+    public TimeSpan Duration { get; init; }
+}
@@ -64,12 +64,13 @@ public class SharpCompressArchiveReader : IArchiveReader
             throw new IOException($"File already exists: {destinationPath}");
 
         await using var sourceStream = sharpEntry.OpenEntryStream();
-        await using var destStream = File.Create(destinationPath);
-        await sourceStream.CopyToAsync(destStream, ct);
+        await ArchiveEntryWriter.WriteAsync(sourceStream, destinationPath, SizeOf(sharpEntry), overwrite: true, ct: ct);
     }
 
     public async Task ExtractAllAsync(string destinationDirectory, bool overwrite = false, CancellationToken ct = default)
     {
+        await using var batch = ArchiveEntryWriter.BeginBatch(ct);
+
         foreach (var entry in _entries)
         {
             ct.ThrowIfCancellationRequested();
@@ -81,10 +82,26 @@ public class SharpCompressArchiveReader : IArchiveReader
                 continue;
 
             var destPath = PathSanitizer.SanitizeEntryPath(entry.FullName, destinationDirectory);
-            await ExtractEntryAsync(entry, destPath, overwrite, ct);
+            if (!_sharpEntryMap.TryGetValue(entry.FullName, out var sharpEntry))
+                throw new FileNotFoundException($"Entry not found in archive: {entry.FullName}");
+
+            var destDir = Path.GetDirectoryName(destPath);
+            if (!string.IsNullOrEmpty(destDir))
+                Directory.CreateDirectory(destDir);
+
+            if (File.Exists(destPath) && !overwrite)
+                throw new IOException($"File already exists: {destPath}");
+
+            await using var sourceStream = sharpEntry.OpenEntryStream();
+            await batch.WriteAsync(sourceStream, destPath, SizeOf(sharpEntry), overwrite: true);
         }
+
+        await batch.CompleteAsync();
     }
 
+    // Some formats (e.g. streamed tar.gz) report 0 for entries whose size isn't in a header
+    private static long SizeOf(IArchiveEntry entry) => entry.Size > 0 ? entry.Size : -1;
+
     public Stream OpenEntryStream(ArchiveEntry entry)
     {
         if (!_sharpEntryMap.TryGetValue(entry.FullName, out var sharpEntry))
@@ -46,12 +46,14 @@ public class ZipArchiveReader : IArchiveReader
             return;
         }
 
-        zipEntry.ExtractToFile(destinationPath, overwrite);
-        await Task.CompletedTask;
+        await using var source = zipEntry.Open();
+        await ArchiveEntryWriter.WriteAsync(source, destinationPath, zipEntry.Length, overwrite, zipEntry.LastWriteTime, ct);
     }
 
     public async Task ExtractAllAsync(string destinationDirectory, bool overwrite = false, CancellationToken ct = default)
     {
+        await using var batch = ArchiveEntryWriter.BeginBatch(ct);
+
         foreach (var entry in _entries)
         {
             ct.ThrowIfCancellationRequested();
@@ -60,8 +62,18 @@ public class ZipArchiveReader : IArchiveReader
                 continue;
 
             var destPath = PathSanitizer.SanitizeEntryPath(entry.FullName, destinationDirectory);
-            await ExtractEntryAsync(entry, destPath, overwrite, ct);
+            var zipEntry = _archive.GetEntry(entry.FullName)
+                ?? throw new FileNotFoundException($"Entry not found in archive: {entry.FullName}");
+
+            var destDir = Path.GetDirectoryName(destPath);
+            if (!string.IsNullOrEmpty(destDir))
+                Directory.CreateDirectory(destDir);
+
+            await using var source = zipEntry.Open();
+            await batch.WriteAsync(source, destPath, zipEntry.Length, overwrite, zipEntry.LastWriteTime);
         }
+
+        await batch.CompleteAsync();
     }
 
     public Stream OpenEntryStream(ArchiveEntry entry)
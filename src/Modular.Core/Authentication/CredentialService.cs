@@ -0,0 +1,299 @@
+using System.Security.Cryptography;
+using System.Text;
+using System.Text.Json;
+using Microsoft.Extensions.Logging;
+
+namespace Modular.Core.Authentication;
+
+/// <summary>
+/// Local credential service shared by the CLI, GUI and Lutris hooks.
+/// Secrets live in an <see cref="ISecretStore"/>; validation results are cached
+/// by key fingerprint in credential_state.json with an expiry. All reads and
+/// writes of that state happen under an exclusive lock file, so concurrent
+/// processes wait for a single validation instead of each issuing their own.
+/// </summary>
+public sealed class CredentialService
+{
+    /// <summary>
+    /// Secret name of the NexusMods API key.
+    /// </summary>
+    public const string NexusApiKeyName = "nexusmods.api_key";
+
+    private static readonly TimeSpan LockRetryDelay = TimeSpan.FromMilliseconds(25);
+
+    private static readonly JsonSerializerOptions JsonOptions = new()
+    {
+        WriteIndented = true,
+        PropertyNamingPolicy = JsonNamingPolicy.SnakeCaseLower
+    };
+
+    private readonly ISecretStore _store;
+    private readonly string _statePath;
+    private readonly string _lockPath;
+    private readonly ILogger? _logger;
+
+    /// <summary>
+    /// Creates a credential service.
+    /// </summary>
+    /// <param name="store">Backend holding the secrets.</param>
+    /// <param name="stateDirectory">Directory for the validation cache and lock file.</param>
+    /// <param name="logger">Optional logger.</param>
+    public CredentialService(ISecretStore store, string stateDirectory, ILogger? logger = null)
+    {
+        _store = store;
+        _statePath = Path.Combine(stateDirectory, "credential_state.json");
+        _lockPath = Path.Combine(stateDirectory, "credentials.lock");
+        _logger = logger;
+    }
+
+    /// <summary>
+    /// Creates the default service under ~/.config/Modular, using the desktop
+    /// keyring when libsecret is available and the encrypted key file otherwise.
+    /// </summary>
+    public static CredentialService CreateDefault(ILogger? logger = null)
+    {
+        var configDir = Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+            ".config", "Modular");
+
+        ISecretStore store = LibSecretStore.IsAvailable()
+            ? new LibSecretStore()
+            : new KeyFileSecretStore(configDir);
+
+        return new CredentialService(store, configDir, logger);
+    }
+
+    /// <summary>
+    /// Name of the active secret store backend.
+    /// </summary>
+    public string StoreName => _store.Name;
+
+    /// <summary>
+    /// How long a successful validation is trusted.
+    /// </summary>
+    public TimeSpan ValidLifetime { get; init; } = TimeSpan.FromHours(24);
+
+    /// <summary>
+    /// How long a rejected key is remembered before it is re-checked.
+    /// </summary>
+    public TimeSpan InvalidLifetime { get; init; } = TimeSpan.FromMinutes(5);
+
+    /// <summary>
+    /// Maximum time to wait for another process holding the lock.
+    /// </summary>
+    public TimeSpan LockTimeout { get; init; } = TimeSpan.FromSeconds(30);
+
+    /// <summary>
+    /// Retrieves a stored secret.
+    /// </summary>
+    public Task<string?> GetSecretAsync(string name, CancellationToken ct = default) =>
+        _store.GetAsync(name, ct);
+
+    /// <summary>
+    /// Stores a secret and drops any cached validation for the previous value.
+    /// </summary>
+    public async Task StoreSecretAsync(string name, string secret, CancellationToken ct = default)
+    {
+        await using var fileLock = await AcquireLockAsync(ct);
+        await _store.SetAsync(name, secret, ct);
+
+        var state = await ReadStateAsync(ct);
+        if (state.Remove(name))
+            await WriteStateAsync(state, ct);
+    }
+
+    /// <summary>
+    /// Removes a secret and its cached validation.
+    /// </summary>
+    public async Task<bool> DeleteSecretAsync(string name, CancellationToken ct = default)
+    {
+        await using var fileLock = await AcquireLockAsync(ct);
+        var removed = await _store.DeleteAsync(name, ct);
+
+        var state = await ReadStateAsync(ct);
+        if (state.Remove(name))
+            await WriteStateAsync(state, ct);
+
+        return removed;
+    }
+
+    /// <summary>
+    /// Validates <paramref name="secret"/>, answering from the shared cache when a
+    /// non-expired result exists for the same value. Returns null when the
+    /// validator could not be reached; such outcomes are not cached.
+    /// </summary>
+    public async Task<CredentialValidation?> ValidateAsync(
+        string name,
+        string secret,
+        ICredentialValidator validator,
+        CancellationToken ct = default)
+    {
+        var fingerprint = Fingerprint(secret);
+
+        await using var fileLock = await AcquireLockAsync(ct);
+        var state = await ReadStateAsync(ct);
+
+        if (state.TryGetValue(name, out var cached) &&
+            cached.Fingerprint == fingerprint &&
+            cached.ExpiresAt > DateTime.UtcNow)
+        {
+            return cached.ToValidation();
+        }
+
+        CredentialValidation validation;
+        try
+        {
+            validation = await validator.ValidateAsync(secret, ct);
+        }
+        catch (Exception ex) when (ex is HttpRequestException || (ex is TaskCanceledException && !ct.IsCancellationRequested))
+        {
+            _logger?.LogWarning(ex, "Could not validate credential {Name}; using it unvalidated", name);
+            return null;
+        }
+
+        var now = DateTime.UtcNow;
+        state[name] = new CachedValidation
+        {
+            Fingerprint = fingerprint,
+            IsValid = validation.IsValid,
+            UserName = validation.UserName,
+            IsPremium = validation.IsPremium,
+            ValidatedAt = now,
+            ExpiresAt = now + (validation.IsValid ? ValidLifetime : InvalidLifetime)
+        };
+        await WriteStateAsync(state, ct);
+
+        return validation;
+    }
+
+    /// <summary>
+    /// Replaces a rejected secret. If another process already stored a different
+    /// value, that value is returned without re-authenticating; otherwise
+    /// <paramref name="reauthenticate"/> runs once (e.g. the NexusMods SSO flow)
+    /// and its result is stored.
+    /// </summary>
+    public async Task<string> RefreshAsync(
+        string name,
+        string? rejectedSecret,
+        Func<CancellationToken, Task<string>> reauthenticate,
+        CancellationToken ct = default)
+    {
+        await using var fileLock = await AcquireLockAsync(ct);
+
+        var current = await _store.GetAsync(name, ct);
+        if (!string.IsNullOrEmpty(current) && current != rejectedSecret)
+            return current;
+
+        var fresh = await reauthenticate(ct);
+        await _store.SetAsync(name, fresh, ct);
+
+        var state = await ReadStateAsync(ct);
+        if (state.Remove(name))
+            await WriteStateAsync(state, ct);
+
+        return fresh;
+    }
+
+    private async Task<FileStream> AcquireLockAsync(CancellationToken ct)
+    {
+        var directory = Path.GetDirectoryName(_lockPath);
+        if (!string.IsNullOrEmpty(directory))
+            Directory.CreateDirectory(directory);
+
+        var deadline = DateTime.UtcNow + LockTimeout;
+        while (true)
+        {
+            ct.ThrowIfCancellationRequested();
+            try
+            {
+                // FileShare.None maps to an exclusive advisory lock on Unix
+                return new FileStream(_lockPath, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.None);
+            }
+            catch (IOException) when (DateTime.UtcNow < deadline)
+            {
+                await Task.Delay(LockRetryDelay, ct);
+            }
+        }
+    }
+
+    private async Task<Dictionary<string, CachedValidation>> ReadStateAsync(CancellationToken ct)
+    {
+        if (!File.Exists(_statePath))
+            return [];
+
+        try
+        {
+            var json = await File.ReadAllTextAsync(_statePath, ct);
+            return JsonSerializer.Deserialize<Dictionary<string, CachedValidation>>(json, JsonOptions) ?? [];
+        }
+        catch (JsonException)
+        {
+            // Corrupt cache, revalidate
+            return [];
+        }
+    }
+
+    private async Task WriteStateAsync(Dictionary<string, CachedValidation> state, CancellationToken ct)
+    {
+        var tempPath = $"{_statePath}.{Environment.ProcessId}.tmp";
+        await File.WriteAllTextAsync(tempPath, JsonSerializer.Serialize(state, JsonOptions), ct);
+        if (!OperatingSystem.IsWindows())
+            File.SetUnixFileMode(tempPath, UnixFileMode.UserRead | UnixFileMode.UserWrite);
+        File.Move(tempPath, _statePath, overwrite: true);
+    }
+
+    private static string Fingerprint(string secret) =>
+        Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(secret)));
+
+    private sealed class CachedValidation
+    {
+        public string Fingerprint { get; set; } = string.Empty;
+        public bool IsValid { get; set; }
+        public string? UserName { get; set; }
+        public bool IsPremium { get; set; }
+        public DateTime ValidatedAt { get; set; }
+        public DateTime ExpiresAt { get; set; }
+
+        public CredentialValidation ToValidation() => new()
+        {
+            IsValid = IsValid,
+            UserName = UserName,
+            IsPremium = IsPremium,
+            ValidatedAt = ValidatedAt,
+            FromCache = true
+        };
+    }
+}
+
+/// <summary>
+/// Checks a secret against its issuing service.
+/// </summary>
+public interface ICredentialValidator
+{
+    /// <summary>
+    /// Validates the secret. Throws <see cref="HttpRequestException"/> when the
+    /// service cannot be reached.
+    /// </summary>
+    Task<CredentialValidation> ValidateAsync(string secret, CancellationToken ct = default);
+}
+
+/// <summary>
+/// Outcome of validating a credential.
+/// </summary>
+public sealed class CredentialValidation
+{
+    /// <summary>Whether the service accepted the credential.</summary>
+    public bool IsValid { get; init; }
+
+    /// <summary>Account name reported by the service.</summary>
+    public string? UserName { get; init; }
+
+    /// <summary>Whether the account has premium status.</summary>
+    public bool IsPremium { get; init; }
+
+    /// <summary>When the service was last asked.</summary>
+    public DateTime ValidatedAt { get; init; } = DateTime.UtcNow;
+
+    /// <summary>Whether this result was served from the shared cache.</summary>
+    public bool FromCache { get; init; }
+}
@@ -0,0 +1,29 @@
+namespace Modular.Core.Authentication;
+
+/// <summary>
+/// Backend that keeps secrets encrypted at rest.
+/// Implementations: <see cref="LibSecretStore"/> (desktop keyring) and
+/// <see cref="KeyFileSecretStore"/> (AES-GCM file with a 0600 key file).
+/// </summary>
+public interface ISecretStore
+{
+    /// <summary>
+    /// Short name of the backend, for diagnostics.
+    /// </summary>
+    string Name { get; }
+
+    /// <summary>
+    /// Retrieves a secret, or null if none is stored under <paramref name="key"/>.
+    /// </summary>
+    Task<string?> GetAsync(string key, CancellationToken ct = default);
+
+    /// <summary>
+    /// Stores or replaces a secret.
+    /// </summary>
+    Task SetAsync(string key, string secret, CancellationToken ct = default);
+
+    /// <summary>
+    /// Removes a secret. Returns false if nothing was stored.
+    /// </summary>
+    Task<bool> DeleteAsync(string key, CancellationToken ct = default);
+}
@@ -0,0 +1,177 @@
+using System.Security.Cryptography;
+using System.Text;
+using System.Text.Json;
+
+namespace Modular.Core.Authentication;
+
+/// <summary>
+/// File-based secret store used when no desktop keyring is available.
+/// Secrets are sealed with AES-256-GCM under a random key kept in a separate
+/// key file; both files are created with 0600 permissions.
+/// </summary>
+public sealed class KeyFileSecretStore : ISecretStore
+{
+    private const int KeySize = 32;
+    private const int NonceSize = 12;
+    private const int TagSize = 16;
+
+    private static readonly JsonSerializerOptions JsonOptions = new() { WriteIndented = true };
+
+    private readonly string _storePath;
+    private readonly string _keyPath;
+    private readonly SemaphoreSlim _gate = new(1, 1);
+
+    /// <summary>
+    /// Creates a store in <paramref name="directory"/> (credentials.bin + credentials.key).
+    /// </summary>
+    public KeyFileSecretStore(string directory)
+    {
+        _storePath = Path.Combine(directory, "credentials.bin");
+        _keyPath = Path.Combine(directory, "credentials.key");
+    }
+
+    /// <inheritdoc />
+    public string Name => "keyfile";
+
+    /// <inheritdoc />
+    public async Task<string?> GetAsync(string key, CancellationToken ct = default)
+    {
+        await _gate.WaitAsync(ct);
+        try
+        {
+            var entries = await ReadEntriesAsync(ct);
+            if (!entries.TryGetValue(key, out var sealedValue))
+                return null;
+
+            return Unseal(await GetOrCreateKeyAsync(ct), sealedValue);
+        }
+        finally
+        {
+            _gate.Release();
+        }
+    }
+
+    /// <inheritdoc />
+    public async Task SetAsync(string key, string secret, CancellationToken ct = default)
+    {
+        await _gate.WaitAsync(ct);
+        try
+        {
+            var entries = await ReadEntriesAsync(ct);
+            entries[key] = Seal(await GetOrCreateKeyAsync(ct), secret);
+            await WriteEntriesAsync(entries, ct);
+        }
+        finally
+        {
+            _gate.Release();
+        }
+    }
+
+    /// <inheritdoc />
+    public async Task<bool> DeleteAsync(string key, CancellationToken ct = default)
+    {
+        await _gate.WaitAsync(ct);
+        try
+        {
+            var entries = await ReadEntriesAsync(ct);
+            if (!entries.Remove(key))
+                return false;
+
+            await WriteEntriesAsync(entries, ct);
+            return true;
+        }
+        finally
+        {
+            _gate.Release();
+        }
+    }
+
+    private async Task<byte[]> GetOrCreateKeyAsync(CancellationToken ct)
+    {
+        if (File.Exists(_keyPath))
+        {
+            var existing = await File.ReadAllBytesAsync(_keyPath, ct);
+            if (existing.Length == KeySize)
+                return existing;
+
+            throw new CryptographicException($"Credential key file is corrupt: {_keyPath}");
+        }
+
+        var key = RandomNumberGenerator.GetBytes(KeySize);
+        await WritePrivateFileAsync(_keyPath, key, ct);
+        return key;
+    }
+
+    private async Task<Dictionary<string, string>> ReadEntriesAsync(CancellationToken ct)
+    {
+        if (!File.Exists(_storePath))
+            return new Dictionary<string, string>(StringComparer.Ordinal);
+
+        var json = await File.ReadAllBytesAsync(_storePath, ct);
+        return JsonSerializer.Deserialize<Dictionary<string, string>>(json, JsonOptions)
+            ?? new Dictionary<string, string>(StringComparer.Ordinal);
+    }
+
+    private Task WriteEntriesAsync(Dictionary<string, string> entries, CancellationToken ct) =>
+        WritePrivateFileAsync(_storePath, JsonSerializer.SerializeToUtf8Bytes(entries, JsonOptions), ct);
+
+    private static string Seal(byte[] key, string secret)
+    {
+        var plaintext = Encoding.UTF8.GetBytes(secret);
+        var buffer = new byte[NonceSize + TagSize + plaintext.Length];
+        var nonce = buffer.AsSpan(0, NonceSize);
+        var tag = buffer.AsSpan(NonceSize, TagSize);
+        var ciphertext = buffer.AsSpan(NonceSize + TagSize);
+
+        RandomNumberGenerator.Fill(nonce);
+        using var aes = new AesGcm(key, TagSize);
+        aes.Encrypt(nonce, plaintext, ciphertext, tag);
+
+        return Convert.ToBase64String(buffer);
+    }
+
+    private static string Unseal(byte[] key, string sealedValue)
+    {
+        var buffer = Convert.FromBase64String(sealedValue);
+        if (buffer.Length < NonceSize + TagSize)
+            throw new CryptographicException("Sealed credential is truncated");
+
+        var plaintext = new byte[buffer.Length - NonceSize - TagSize];
+        using var aes = new AesGcm(key, TagSize);
+        aes.Decrypt(
+            buffer.AsSpan(0, NonceSize),
+            buffer.AsSpan(NonceSize + TagSize),
+            buffer.AsSpan(NonceSize, TagSize),
+            plaintext);
+
+        return Encoding.UTF8.GetString(plaintext);
+    }
+
+    /// <summary>
+    /// Writes a file readable only by the current user, replacing it atomically.
+    /// </summary>
+    private static async Task WritePrivateFileAsync(string path, byte[] contents, CancellationToken ct)
+    {
+        var directory = Path.GetDirectoryName(path);
+        if (!string.IsNullOrEmpty(directory))
+            Directory.CreateDirectory(directory);
+
+        var tempPath = $"{path}.{Environment.ProcessId}.tmp";
+        var options = new FileStreamOptions
+        {
+            Mode = FileMode.Create,
+            Access = FileAccess.Write,
+            Share = FileShare.None
+        };
+        if (!OperatingSystem.IsWindows())
+            options.UnixCreateMode = UnixFileMode.UserRead | UnixFileMode.UserWrite;
+
+        await using (var stream = new FileStream(tempPath, options))
+        {
+            await stream.WriteAsync(contents, ct);
+            await stream.FlushAsync(ct);
+        }
+
+        File.Move(tempPath, path, overwrite: true);
+    }
+}
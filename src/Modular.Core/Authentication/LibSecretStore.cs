@@ -0,0 +1,94 @@
+using System.Diagnostics;
+
+namespace Modular.Core.Authentication;
+
+/// <summary>
+/// Secret store backed by the desktop keyring through libsecret's
+/// <c>secret-tool</c> (GNOME Keyring, KWallet via the Secret Service API).
+/// Secrets are passed over stdin/stdout and never appear on a command line.
+/// </summary>
+public sealed class LibSecretStore : ISecretStore
+{
+    private const string ToolName = "secret-tool";
+    private const string ServiceAttribute = "modular";
+    private static readonly TimeSpan CommandTimeout = TimeSpan.FromSeconds(10);
+
+    /// <inheritdoc />
+    public string Name => "libsecret";
+
+    /// <summary>
+    /// Whether secret-tool is installed and a session bus is reachable.
+    /// </summary>
+    public static bool IsAvailable()
+    {
+        if (!OperatingSystem.IsLinux())
+            return false;
+
+        if (string.IsNullOrEmpty(Environment.GetEnvironmentVariable("DBUS_SESSION_BUS_ADDRESS")))
+            return false;
+
+        var path = Environment.GetEnvironmentVariable("PATH") ?? string.Empty;
+        return path.Split(Path.PathSeparator, StringSplitOptions.RemoveEmptyEntries)
+            .Any(dir => File.Exists(Path.Combine(dir, ToolName)));
+    }
+
+    /// <inheritdoc />
+    public async Task<string?> GetAsync(string key, CancellationToken ct = default)
+    {
+        var (exitCode, output) = await RunAsync(["lookup", "service", ServiceAttribute, "account", key], null, ct);
+        if (exitCode != 0 || output.Length == 0)
+            return null;
+
+        return output;
+    }
+
+    /// <inheritdoc />
+    public async Task SetAsync(string key, string secret, CancellationToken ct = default)
+    {
+        var (exitCode, _) = await RunAsync(
+            ["store", $"--label=Modular {key}", "service", ServiceAttribute, "account", key], secret, ct);
+
+        if (exitCode != 0)
+            throw new InvalidOperationException($"secret-tool store failed with exit code {exitCode}");
+    }
+
+    /// <inheritdoc />
+    public async Task<bool> DeleteAsync(string key, CancellationToken ct = default)
+    {
+        var existing = await GetAsync(key, ct);
+        if (existing == null)
+            return false;
+
+        var (exitCode, _) = await RunAsync(["clear", "service", ServiceAttribute, "account", key], null, ct);
+        return exitCode == 0;
+    }
+
+    private static async Task<(int ExitCode, string Output)> RunAsync(
+        IEnumerable<string> arguments, string? stdin, CancellationToken ct)
+    {
+        var psi = new ProcessStartInfo(ToolName)
+        {
+            RedirectStandardInput = true,
+            RedirectStandardOutput = true,
+            RedirectStandardError = true,
+            UseShellExecute = false
+        };
+        foreach (var argument in arguments)
+            psi.ArgumentList.Add(argument);
+
+        using var timeoutCts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+        timeoutCts.CancelAfter(CommandTimeout);
+
+        using var process = Process.Start(psi)
+            ?? throw new InvalidOperationException($"Failed to start {ToolName}");
+
+        if (stdin != null)
+            await process.StandardInput.WriteAsync(stdin);
+        process.StandardInput.Close();
+
+        var output = await process.StandardOutput.ReadToEndAsync(timeoutCts.Token);
+        await process.WaitForExitAsync(timeoutCts.Token);
+
+        return (process.ExitCode, output.TrimEnd('\n'));
+    }
+}
@@ -0,0 +1,47 @@
+using System.Net;
+using System.Text.Json;
+
+namespace Modular.Core.Authentication;
+
+/// <summary>
+/// Validates a NexusMods API key via GET /v1/users/validate.json.
+/// </summary>
+public sealed class NexusApiKeyValidator : ICredentialValidator
+{
+    private const string ValidateUrl = "https://api.nexusmods.com/v1/users/validate.json";
+
+    private readonly HttpClient _httpClient;
+    private readonly string _validateUrl;
+
+    public NexusApiKeyValidator(HttpClient? httpClient = null, string? validateUrl = null)
+    {
+        _httpClient = httpClient ?? new HttpClient { Timeout = TimeSpan.FromSeconds(15) };
+        _validateUrl = validateUrl ?? ValidateUrl;
+    }
+
+    /// <inheritdoc />
+    public async Task<CredentialValidation> ValidateAsync(string secret, CancellationToken ct = default)
+    {
+        using var request = new HttpRequestMessage(HttpMethod.Get, _validateUrl);
+        request.Headers.Add("apikey", secret);
+        request.Headers.Add("accept", "application/json");
+
+        using var response = await _httpClient.SendAsync(request, ct);
+
+        if (response.StatusCode is HttpStatusCode.Unauthorized or HttpStatusCode.Forbidden)
+            return new CredentialValidation { IsValid = false };
+
+        response.EnsureSuccessStatusCode();
+
+        await using var stream = await response.Content.ReadAsStreamAsync(ct);
+        using var doc = await JsonDocument.ParseAsync(stream, cancellationToken: ct);
+        var root = doc.RootElement;
+
+        return new CredentialValidation
+        {
+            IsValid = true,
+            UserName = root.TryGetProperty("name", out var name) ? name.GetString() : null,
+            IsPremium = root.TryGetProperty("is_premium", out var premium) && premium.ValueKind == JsonValueKind.True
+        };
+    }
+}
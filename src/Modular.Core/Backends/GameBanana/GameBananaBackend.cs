@@ -2,6 +2,7 @@ using System.Text.Json;
 using Microsoft.Extensions.Logging;
 using Modular.Sdk.Backends.Common;
 using Modular.Core.Configuration;
+using Modular.Core.Resilience;
 using Modular.Core.Utilities;
 using Modular.FluentHttp.Implementation;
 using Modular.FluentHttp.Interfaces;
@@ -38,6 +39,7 @@ public class GameBananaBackend : IModBackend
         _settings = settings;
         _logger = logger;
         _client = FluentClientFactory.Create(BaseUrl);
+        _client.SetRequestPolicy(new HttpResiliencePolicy());
         _client.SetUserAgent("Modular/1.0");
     }
 
@@ -76,79 +78,94 @@ public class GameBananaBackend : IModBackend
 
         try
         {
-            var page = 1;
-            while (true)
-            {
-                ct.ThrowIfCancellationRequested();
-                await ThrottleAsync();
+            await FetchSubscriptionsAsync(result, ct);
+            _logger?.LogInformation("Fetched {Count} subscribed mods from GameBanana", result.Count);
+        }
+        catch (OperationCanceledException)
+        {
+            throw;
+        }
+        catch (Exception ex)
+        {
+            _logger?.LogError(ex, "Failed to fetch subscribed mods for user {UserId}", _settings.GameBananaUserId);
+        }
 
-                // Fetch the user's subscriptions (mods they follow) using v11 API
-                var response = await _client.GetAsync($"Member/{_settings.GameBananaUserId}/Subscriptions")
-                    .WithArgument("_nPage", page.ToString())
-                    .WithArgument("_nPerpage", DefaultPageSize.ToString())
-                    .AsJsonAsync();
+        return result;
+    }
 
-                var v11Response = JsonSerializer.Deserialize<GameBananaV11Response>(
-                    response.RootElement.GetRawText());
+    /// <summary>
+    /// Gets the user's subscribed mods. Unlike <see cref="GetUserModsAsync"/>,
+    /// throws instead of returning a partial list when a page fails.
+    /// </summary>
+    public async Task<List<BackendMod>> GetSubscribedModsAsync(CancellationToken ct = default)
+    {
+        var result = new List<BackendMod>();
+        await FetchSubscriptionsAsync(result, ct);
+        return result;
+    }
 
-                if (v11Response?.Records == null || v11Response.Records.Count == 0)
-                    break;
+    private async Task FetchSubscriptionsAsync(List<BackendMod> result, CancellationToken ct)
+    {
+        var page = 1;
+        while (true)
+        {
+            ct.ThrowIfCancellationRequested();
+            await ThrottleAsync();
 
-                foreach (var record in v11Response.Records)
-                {
-                    // Subscription records have the actual mod in _aSubscription
-                    var mod = record.Subscription ?? record;
-                    if (mod.Id == 0 || string.IsNullOrEmpty(mod.Name))
-                        continue;
+            // Fetch the user's subscriptions (mods they follow) using v11 API
+            var response = await _client.GetAsync($"Member/{_settings.GameBananaUserId}/Subscriptions")
+                .WithArgument("_nPage", page.ToString())
+                .WithArgument("_nPerpage", DefaultPageSize.ToString())
+                .AsJsonAsync();
 
-                    // Optional: Filter by game IDs if configured
-                    if (_settings.GameBananaGameIds.Count > 0 &&
-                        mod.Game != null &&
-                        !_settings.GameBananaGameIds.Contains(mod.Game.Id))
-                    {
-                        continue;
-                    }
+            var v11Response = JsonSerializer.Deserialize<GameBananaV11Response>(
+                response.RootElement.GetRawText());
 
-                    var modId = mod.Id.ToString();
-                    var thumbnailUrl = GetThumbnailUrl(mod.PreviewMedia);
+            if (v11Response?.Records == null || v11Response.Records.Count == 0)
+                break;
 
-                    result.Add(new BackendMod
-                    {
-                        ModId = modId,
-                        Name = mod.Name,
-                        BackendId = Id,
-                        Url = mod.ProfileUrl ?? $"https://gamebanana.com/mods/{modId}",
-                        Author = mod.Submitter?.Name,
-                        UpdatedAt = mod.DateModifiedTimestamp.HasValue
-                            ? DateTimeOffset.FromUnixTimeSeconds(mod.DateModifiedTimestamp.Value).DateTime
-                            : null,
-                        GameDomain = mod.Game?.Name,
-                        ThumbnailUrl = thumbnailUrl
-                    });
+            foreach (var record in v11Response.Records)
+            {
+                // Subscription records have the actual mod in _aSubscription
+                var mod = record.Subscription ?? record;
+                if (mod.Id == 0 || string.IsNullOrEmpty(mod.Name))
+                    continue;
+
+                // Optional: Filter by game IDs if configured
+                if (_settings.GameBananaGameIds.Count > 0 &&
+                    mod.Game != null &&
+                    !_settings.GameBananaGameIds.Contains(mod.Game.Id))
+                {
+                    continue;
                 }
 
-                // Check if we've fetched all records
-                var totalCount = v11Response.Metadata?.RecordCount ?? 0;
-                if (v11Response.Metadata?.IsComplete == true ||
-                    result.Count >= totalCount ||
-                    v11Response.Records.Count < DefaultPageSize)
-                    break;
+                var modId = mod.Id.ToString();
+                var thumbnailUrl = GetThumbnailUrl(mod.PreviewMedia);
 
-                page++;
+                result.Add(new BackendMod
+                {
+                    ModId = modId,
+                    Name = mod.Name,
+                    BackendId = Id,
+                    Url = mod.ProfileUrl ?? $"https://gamebanana.com/mods/{modId}",
+                    Author = mod.Submitter?.Name,
+                    UpdatedAt = mod.DateModifiedTimestamp.HasValue
+                        ? DateTimeOffset.FromUnixTimeSeconds(mod.DateModifiedTimestamp.Value).DateTime
+                        : null,
+                    GameDomain = mod.Game?.Name,
+                    ThumbnailUrl = thumbnailUrl
+                });
             }
 
-            _logger?.LogInformation("Fetched {Count} subscribed mods from GameBanana", result.Count);
-        }
-        catch (OperationCanceledException)
-        {
-            throw;
-        }
-        catch (Exception ex)
-        {
-            _logger?.LogError(ex, "Failed to fetch subscribed mods for user {UserId}", _settings.GameBananaUserId);
-        }
+            // Check if we've fetched all records
+            var totalCount = v11Response.Metadata?.RecordCount ?? 0;
+            if (v11Response.Metadata?.IsComplete == true ||
+                result.Count >= totalCount ||
+                v11Response.Records.Count < DefaultPageSize)
+                break;
 
-        return result;
+            page++;
+        }
     }
 
     /// <summary>
@@ -515,7 +532,11 @@ public class GameBananaBackend : IModBackend
                 _logger?.LogDebug("Downloading from URL: {Url}", url);
                 _logger?.LogDebug("Output path: {OutputPath}", outputPath);
                 FileUtils.EnsureDirectoryExists(modOutputDir);
-                await _client.GetAsync(url).DownloadToAsync(outputPath, null, ct);
+                // Download beside the final name and rename into place (same directory, so no copy);
+                // an interrupted download never looks like a finished archive
+                var partialPath = outputPath + ".part";
+                await _client.GetAsync(url).DownloadToAsync(partialPath, null, ct);
+                File.Move(partialPath, outputPath, overwrite: true);
                 _logger?.LogInformation("Downloaded: {File}", outputPath);
             }
             catch (HttpRequestException ex)
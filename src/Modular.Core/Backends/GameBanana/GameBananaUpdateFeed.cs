@@ -0,0 +1,72 @@
+using Modular.Core.Updates;
+
+namespace Modular.Core.Backends.GameBanana;
+
+/// <summary>
+/// GameBanana change feed. GameBanana has no site-wide list of updated mods,
+/// but the subscriptions listing carries each mod's modification time, so one
+/// paged request both lists the watched mods and says which of them changed.
+/// </summary>
+public sealed class GameBananaUpdateFeed : IUpdateFeed
+{
+    private const string UnknownGame = "unknown";
+
+    private readonly GameBananaBackend _backend;
+    private Dictionary<string, List<RemoteModUpdate>> _latest = new(StringComparer.Ordinal);
+
+    public GameBananaUpdateFeed(GameBananaBackend backend)
+    {
+        _backend = backend;
+    }
+
+    public string BackendId => _backend.Id;
+
+    public bool IsAvailable => _backend.ValidateConfiguration().Count == 0;
+
+    public async Task<IReadOnlyList<WatchedMod>> GetWatchedModsAsync(CancellationToken ct = default)
+    {
+        var subscriptions = await _backend.GetSubscribedModsAsync(ct);
+
+        var latest = new Dictionary<string, List<RemoteModUpdate>>(StringComparer.Ordinal);
+        var watched = new List<WatchedMod>();
+        foreach (var mod in subscriptions)
+        {
+            var game = string.IsNullOrEmpty(mod.GameDomain) ? UnknownGame : mod.GameDomain;
+
+            // Compared against the time each mod is first seen; we don't know which version the user has
+            watched.Add(new WatchedMod
+            {
+                GameDomain = game,
+                ModId = mod.ModId,
+                Name = mod.Name,
+                Source = WatchSource.Tracked
+            });
+
+            if (mod.UpdatedAt is { } updatedAt)
+            {
+                if (!latest.TryGetValue(game, out var updates))
+                    latest[game] = updates = [];
+                updates.Add(new RemoteModUpdate(
+                    mod.ModId,
+                    new DateTimeOffset(DateTime.SpecifyKind(updatedAt, DateTimeKind.Utc)).ToUnixTimeSeconds()));
+            }
+        }
+
+        _latest = latest;
+        return watched;
+    }
+
+    public async Task<IReadOnlyList<RemoteModUpdate>> GetUpdatesAsync(
+        string gameDomain,
+        long? since,
+        long now,
+        CancellationToken ct = default)
+    {
+        if (_latest.Count == 0)
+            await GetWatchedModsAsync(ct);
+
+        return _latest.TryGetValue(gameDomain, out var updates)
+            ? updates.Where(u => since == null || u.UpdatedAt > since).ToList()
+            : [];
+    }
+}
@@ -1,11 +1,15 @@
+using System.Collections.Concurrent;
 using Microsoft.Extensions.Logging;
 using Modular.Sdk.Backends;
 using Modular.Sdk.Backends.Common;
 using Modular.Core.Configuration;
 using Modular.Core.Database;
+using Modular.Core.Downloads;
 using Modular.Core.Exceptions;
 using Modular.Core.Models;
 using Modular.Core.RateLimiting;
+using Modular.Core.Resilience;
+using Modular.Core.Updates;
 using Modular.Core.Utilities;
 using Modular.FluentHttp.Implementation;
 using Modular.FluentHttp.Interfaces;
@@ -27,6 +31,8 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
     private readonly ModMetadataCache _metadataCache;
     private readonly ILogger<NexusModsBackend>? _logger;
     private readonly NexusModsGraphQlClient _graphQlClient;
+    private readonly NexusQueryBatcher _batcher;
+    private readonly MirrorSelector _mirrors;
 
     // Cache of tracked mods to avoid repeated API calls
     private HashSet<(string domain, int modId)>? _trackedModsCache;
@@ -48,16 +54,42 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
         Modular.Core.RateLimiting.IRateLimiter rateLimiter,
         DownloadDatabase database,
         ModMetadataCache metadataCache,
-        ILogger<NexusModsBackend>? logger = null)
+        ILogger<NexusModsBackend>? logger = null,
+        MirrorSelector? mirrors = null)
+        : this(settings, rateLimiter, database, metadataCache, BaseUrl, logger,
+            mirrors ?? new MirrorSelector(
+                new MirrorModel(MirrorModel.DefaultPath, logger: logger),
+                logger: logger,
+                governor: new BandwidthGovernor(settings, logger: logger)))
+    {
+    }
+
+    /// <summary>
+    /// Creates a backend talking to <paramref name="baseUrl"/> instead of the
+    /// public API (tests run against a local server). Without
+    /// <paramref name="mirrors"/> the mirror statistics stay in memory.
+    /// </summary>
+    internal NexusModsBackend(
+        AppSettings settings,
+        Modular.Core.RateLimiting.IRateLimiter rateLimiter,
+        DownloadDatabase database,
+        ModMetadataCache metadataCache,
+        string baseUrl,
+        ILogger<NexusModsBackend>? logger = null,
+        MirrorSelector? mirrors = null)
     {
         _settings = settings;
+        _mirrors = mirrors ?? new MirrorSelector(logger: logger);
         _database = database;
         _metadataCache = metadataCache;
         _logger = logger;
         var rateLimiterAdapter = new RateLimiterAdapter(rateLimiter);
-        _client = FluentClientFactory.Create(BaseUrl, rateLimiterAdapter, logger);
+        _client = FluentClientFactory.Create(baseUrl, rateLimiterAdapter, logger);
+        _client.SetRequestPolicy(new HttpResiliencePolicy());
         _client.SetUserAgent("Modular/1.0");
-        _graphQlClient = new NexusModsGraphQlClient(settings.NexusApiKey ?? string.Empty, rateLimiterAdapter, logger);
+        _graphQlClient = new NexusModsGraphQlClient(
+            () => settings.NexusApiKey ?? string.Empty, rateLimiterAdapter, logger, $"{baseUrl.TrimEnd('/')}/v2/graphql");
+        _batcher = new NexusQueryBatcher(_graphQlClient.ExecuteAsync, ResolveGameIdAsync, logger);
     }
 
     public IReadOnlyList<string> ValidateConfiguration()
@@ -84,6 +116,13 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
             ? response.Where(m => m.DomainName == gameDomain).ToList()
             : response;
 
+        // Names missing from the cache are fetched together; the loads share GraphQL requests
+        var lookups = filteredMods
+            .Where(m => _metadataCache.GetModMetadata(m.DomainName, m.ModId) == null)
+            .DistinctBy(m => (m.DomainName, m.ModId))
+            .ToDictionary(m => (m.DomainName, m.ModId), m => GetModInfoAsync(m.ModId.ToString(), m.DomainName, ct));
+        await Task.WhenAll(lookups.Values);
+
         var mods = new List<BackendMod>();
         foreach (var m in filteredMods)
         {
@@ -105,8 +144,7 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
             }
             else
             {
-                // Fetch mod info from API (only if not in cache)
-                var modInfo = await GetModInfoAsync(m.ModId.ToString(), m.DomainName, ct);
+                var modInfo = lookups.TryGetValue((m.DomainName, m.ModId), out var lookup) ? await lookup : null;
 
                 mods.Add(new BackendMod
                 {
@@ -195,11 +233,30 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
         return files;
     }
 
+    /// <summary>
+    /// Resolves a download URL on the mirror the <see cref="MirrorModel"/>
+    /// currently rates best (no probing; use <see cref="ResolveDownloadLinksAsync"/>
+    /// to get every mirror).
+    /// </summary>
     public async Task<string?> ResolveDownloadUrlAsync(
         string modId,
         string fileId,
         string? gameDomain = null,
         CancellationToken ct = default)
+    {
+        var links = await ResolveDownloadLinksAsync(modId, fileId, gameDomain, ct);
+        return links.Count > 0 ? _mirrors.Model.Rank(links, 0)[0].Uri : null;
+    }
+
+    /// <summary>
+    /// Resolves every CDN location NexusMods offers for a file, in the server's
+    /// order. Returns an empty list when no link can be generated.
+    /// </summary>
+    public async Task<IReadOnlyList<DownloadLink>> ResolveDownloadLinksAsync(
+        string modId,
+        string fileId,
+        string? gameDomain = null,
+        CancellationToken ct = default)
     {
         if (string.IsNullOrEmpty(gameDomain))
             throw new ArgumentException("Game domain is required for NexusMods", nameof(gameDomain));
@@ -224,16 +281,15 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
                     _logger?.LogWarning("Failed to resolve download URL for mod {ModId} file {FileId}: HTTP {StatusCode}", 
                         modId, fileId, response.StatusCode);
                 }
-                return null;
+                return [];
             }
 
-            var links = response.AsArray<DownloadLink>();
-            return links.Count > 0 ? links[0].Uri : null;
+            return response.AsArray<DownloadLink>().Where(l => !string.IsNullOrEmpty(l.Uri)).ToList();
         }
         catch (Exception ex)
         {
             _logger?.LogWarning(ex, "Failed to resolve download URL for mod {ModId} file {FileId}", modId, fileId);
-            return null;
+            return [];
         }
     }
 
@@ -258,144 +314,231 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
 
         var trackedMods = await GetUserModsAsync(gameDomain, ct);
         _logger?.LogInformation("Found {Count} tracked mods for {Domain}", trackedMods.Count, gameDomain);
-        options.StatusCallback?.Invoke($"Found {trackedMods.Count} tracked mods. Fetching file info...");
 
-        // Get files for each mod
-        var allFiles = new List<(BackendMod mod, BackendModFile file)>();
-        foreach (var mod in trackedMods)
+        // Diff against the last sync so only mods with new uploads get their files listed
+        var syncStarted = DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+        var filterKey = NexusSyncPlanner.FilterKey(options.Filter);
+        var syncState = _metadataCache.GetTrackedSyncState(gameDomain);
+        var trackedById = trackedMods.DistinctBy(m => m.ModId).ToDictionary(m => int.Parse(m.ModId));
+        var plan = await PlanSyncAsync(gameDomain, trackedById.Keys, syncState, filterKey, syncStarted, options.Force, ct);
+
+        _logger?.LogInformation("{Changed} of {Total} tracked mods changed since last sync",
+            plan.ModsToList.Count, trackedMods.Count);
+        options.StatusCallback?.Invoke(
+            $"Found {trackedMods.Count} tracked mods, {plan.ModsToList.Count} changed. Fetching file info...");
+
+        // Get files for each changed mod; files already on disk never reach the queue
+        var newState = new TrackedModSyncState { FilterKey = filterKey };
+        foreach (var modId in plan.Unchanged)
+            newState.SyncedAt[modId] = syncStarted;
+
+        var pendingFiles = new Dictionary<int, int>();
+        var downloadQueue = new List<(BackendMod mod, BackendModFile file)>();
+        foreach (var modId in plan.ModsToList)
         {
             ct.ThrowIfCancellationRequested();
+            var mod = trackedById[modId];
             try
             {
                 var files = await GetModFilesAsync(mod.ModId, gameDomain, options.Filter, ct);
+                var queued = 0;
                 foreach (var file in files)
                 {
-                    allFiles.Add((mod, file));
+                    if (!options.Force && _database.IsDownloaded(gameDomain, modId, int.Parse(file.FileId)))
+                        continue;
+
+                    downloadQueue.Add((mod, file));
+                    queued++;
                 }
+
+                if (queued == 0)
+                    newState.SyncedAt[modId] = syncStarted;
+                else
+                    pendingFiles[modId] = queued;
             }
-            catch (Exception ex)
+            catch (Exception ex) when (ex is not OperationCanceledException)
             {
                 _logger?.LogWarning(ex, "Failed to get files for mod {ModId}", mod.ModId);
             }
         }
 
-        options.StatusCallback?.Invoke($"Found {allFiles.Count} files. Generating download links...");
+        options.StatusCallback?.Invoke($"Ready to download {downloadQueue.Count} files.");
+
+        // Download phase. Links are generated right before each transfer: they
+        // expire, and a link for a file that's skipped or cancelled is a wasted call.
+        var completed = 0;
+        var total = downloadQueue.Count;
+        var linksObtained = 0;
+        var linkFailures = 0;
 
-        // Generate download links
-        var downloadQueue = new List<(BackendMod mod, BackendModFile file, string url)>();
-        foreach (var (mod, file) in allFiles)
+        try
         {
-            ct.ThrowIfCancellationRequested();
-            var url = await ResolveDownloadUrlAsync(mod.ModId, file.FileId, gameDomain, ct);
-            if (!string.IsNullOrEmpty(url))
+            foreach (var (mod, file) in downloadQueue)
             {
-                downloadQueue.Add((mod, file, url));
-            }
-        }
+                ct.ThrowIfCancellationRequested();
 
-        options.StatusCallback?.Invoke($"Ready to download {downloadQueue.Count} files.");
+                var modIdInt = int.Parse(mod.ModId);
+                var fileIdInt = int.Parse(file.FileId);
 
-        // Check if no download links were obtained
-        if (downloadQueue.Count == 0 && allFiles.Count > 0)
-        {
-            _logger?.LogError("Could not obtain any download links. NexusMods Premium membership is required to download mods via the API.");
-            throw new ApiException(
-                "Cannot download mods: NexusMods requires a Premium membership to access download links via the API. " +
-                "Visit https://www.nexusmods.com/register/premium to upgrade your account.",
-                403);
-        }
+                var modOutputDir = Path.Combine(outputDirectory, gameDomain, mod.ModId);
+                var outputPath = Path.Combine(modOutputDir, FileUtils.SanitizeFilename(file.FileName));
 
-        // Download phase
-        var completed = 0;
-        var total = downloadQueue.Count;
+                if (options.DryRun)
+                {
+                    _logger?.LogInformation("[DRY RUN] Would download: {File}", outputPath);
+                    completed++;
+                    progress?.Report(DownloadProgress.Downloading(
+                        $"[DRY RUN] {file.FileName}",
+                        completed, total, file.FileName));
+                    continue;
+                }
 
-        foreach (var (mod, file, url) in downloadQueue)
-        {
-            ct.ThrowIfCancellationRequested();
+                var links = await ResolveDownloadLinksAsync(mod.ModId, file.FileId, gameDomain, ct);
+                if (links.Count == 0)
+                {
+                    // Without Premium every link request fails; stop before burning the quota on all of them
+                    if (++linkFailures >= 3 && linksObtained == 0)
+                    {
+                        throw PremiumRequired();
+                    }
 
-            var modIdInt = int.Parse(mod.ModId);
-            var fileIdInt = int.Parse(file.FileId);
+                    completed++;
+                    continue;
+                }
 
-            // Check if already downloaded
-            if (!options.Force && _database.IsDownloaded(gameDomain, modIdInt, fileIdInt))
-            {
-                completed++;
-                progress?.Report(DownloadProgress.Downloading(
-                    $"Skipping {file.FileName} (already downloaded)",
-                    completed, total, file.FileName));
-                continue;
-            }
+                linksObtained++;
 
-            var modOutputDir = Path.Combine(outputDirectory, gameDomain, mod.ModId);
-            var outputPath = Path.Combine(modOutputDir, FileUtils.SanitizeFilename(file.FileName));
+                try
+                {
+                    FileUtils.EnsureDirectoryExists(modOutputDir);
+                    // Download beside the final name and rename into place (same directory, so no copy);
+                    // an interrupted download never looks like a finished archive. The selector
+                    // picks the CDN location and resumes on another one if it fails or crawls.
+                    var partialPath = outputPath + ".part";
+                    var transfer = await _mirrors.DownloadAsync(links, partialPath, file.SizeBytes ?? 0, ct);
+                    File.Move(partialPath, outputPath, overwrite: true);
+
+                    var record = new DownloadRecord
+                    {
+                        GameDomain = gameDomain,
+                        ModId = modIdInt,
+                        FileId = fileIdInt,
+                        Filename = file.FileName,
+                        Filepath = outputPath,
+                        Url = transfer.Url,
+                        Md5Expected = file.Md5 ?? string.Empty,
+                        FileSize = new FileInfo(outputPath).Length,
+                        DownloadTime = DateTime.UtcNow,
+                        Status = DownloadStatus.Success
+                    };
+
+                    // Verify MD5 if enabled
+                    if (options.VerifyDownloads && !string.IsNullOrEmpty(file.Md5))
+                    {
+                        var actualMd5 = await Md5Calculator.CalculateMd5Async(outputPath, ct);
+                        record.Md5Actual = actualMd5;
+                        record.Status = actualMd5.Equals(file.Md5, StringComparison.OrdinalIgnoreCase)
+                            ? DownloadStatus.Verified
+                            : DownloadStatus.HashMismatch;
+                    }
+
+                    _database.AddRecord(record);
+                    _logger?.LogInformation("Downloaded: {File}", file.FileName);
+
+                    // A mod counts as synced once every queued file of it has landed intact
+                    if (record.Status != DownloadStatus.HashMismatch && --pendingFiles[modIdInt] == 0)
+                        newState.SyncedAt[modIdInt] = syncStarted;
+                }
+                catch (Exception ex) when (ex is not OperationCanceledException)
+                {
+                    _logger?.LogError(ex, "Failed to download {File}", file.FileName);
+                    _database.AddRecord(new DownloadRecord
+                    {
+                        GameDomain = gameDomain,
+                        ModId = modIdInt,
+                        FileId = fileIdInt,
+                        Filename = file.FileName,
+                        DownloadTime = DateTime.UtcNow,
+                        Status = DownloadStatus.Failed,
+                        ErrorMessage = ex.Message
+                    });
+                }
 
-            if (options.DryRun)
-            {
-                _logger?.LogInformation("[DRY RUN] Would download: {File}", outputPath);
                 completed++;
                 progress?.Report(DownloadProgress.Downloading(
-                    $"[DRY RUN] {file.FileName}",
+                    $"Downloaded {file.FileName}",
                     completed, total, file.FileName));
-                continue;
             }
 
-            try
+            if (linksObtained == 0 && linkFailures > 0)
             {
-                FileUtils.EnsureDirectoryExists(modOutputDir);
-                await _client.GetAsync(url).DownloadToAsync(outputPath, null, ct);
-
-                var record = new DownloadRecord
-                {
-                    GameDomain = gameDomain,
-                    ModId = modIdInt,
-                    FileId = fileIdInt,
-                    Filename = file.FileName,
-                    Filepath = outputPath,
-                    Url = url,
-                    Md5Expected = file.Md5 ?? string.Empty,
-                    FileSize = new FileInfo(outputPath).Length,
-                    DownloadTime = DateTime.UtcNow,
-                    Status = DownloadStatus.Success
-                };
-
-                // Verify MD5 if enabled
-                if (options.VerifyDownloads && !string.IsNullOrEmpty(file.Md5))
-                {
-                    var actualMd5 = await Md5Calculator.CalculateMd5Async(outputPath, ct);
-                    record.Md5Actual = actualMd5;
-                    record.Status = actualMd5.Equals(file.Md5, StringComparison.OrdinalIgnoreCase)
-                        ? DownloadStatus.Verified
-                        : DownloadStatus.HashMismatch;
-                }
-
-                _database.AddRecord(record);
-                _logger?.LogInformation("Downloaded: {File}", file.FileName);
+                throw PremiumRequired();
             }
-            catch (Exception ex)
+        }
+        finally
+        {
+            // Persist whatever finished, even when cancelled, so the next sync resumes from here.
+            // Mods that failed or were cut short have no entry and are listed again next time.
+            if (!options.DryRun)
             {
-                _logger?.LogError(ex, "Failed to download {File}", file.FileName);
-                _database.AddRecord(new DownloadRecord
-                {
-                    GameDomain = gameDomain,
-                    ModId = modIdInt,
-                    FileId = fileIdInt,
-                    Filename = file.FileName,
-                    DownloadTime = DateTime.UtcNow,
-                    Status = DownloadStatus.Failed,
-                    ErrorMessage = ex.Message
-                });
+                _metadataCache.SetTrackedSyncState(gameDomain, newState);
+                await _metadataCache.SaveAsync();
             }
-
-            completed++;
-            progress?.Report(DownloadProgress.Downloading(
-                $"Downloaded {file.FileName}",
-                completed, total, file.FileName));
         }
 
         await _database.SaveAsync();
         progress?.Report(DownloadProgress.Done(total));
     }
 
+    private ApiException PremiumRequired()
+    {
+        _logger?.LogError("Could not obtain any download links. NexusMods Premium membership is required to download mods via the API.");
+        return new ApiException(
+            "Cannot download mods: NexusMods requires a Premium membership to access download links via the API. " +
+            "Visit https://www.nexusmods.com/register/premium to upgrade your account.",
+            403);
+    }
+
+    /// <summary>
+    /// Diffs tracked mods against the stored sync state. Costs one updated.json
+    /// call when there is usable state, none otherwise.
+    /// </summary>
+    private async Task<NexusSyncPlan> PlanSyncAsync(
+        string gameDomain,
+        IReadOnlyCollection<int> trackedModIds,
+        TrackedModSyncState? state,
+        string filterKey,
+        long now,
+        bool force,
+        CancellationToken ct)
+    {
+        var period = force ? null : NexusSyncPlanner.ChooseUpdatedPeriod(state, trackedModIds, filterKey, now);
+        List<NexusV1UpdatedMod>? updated = null;
+
+        if (period != null)
+        {
+            ct.ThrowIfCancellationRequested();
+            try
+            {
+                updated = await _client.GetAsync($"v1/games/{gameDomain}/mods/updated.json?period={period}")
+                    .WithHeader("apikey", _settings.NexusApiKey)
+                    .WithHeader("accept", "application/json")
+                    .AsArrayAsync<NexusV1UpdatedMod>();
+            }
+            catch (Exception ex) when (ex is not OperationCanceledException)
+            {
+                // Fall back to listing every mod
+                _logger?.LogWarning(ex, "Failed to fetch updated mods for {Domain}", gameDomain);
+            }
+        }
+
+        return NexusSyncPlanner.Plan(trackedModIds, state, updated, period, filterKey, now, force);
+    }
+
+    /// <summary>
+    /// Gets a mod's details. Lookups made around the same time are sent as one
+    /// GraphQL request, so callers can ask for many mods concurrently.
+    /// </summary>
     public async Task<BackendMod?> GetModInfoAsync(
         string modId,
         string? gameDomain = null,
@@ -404,38 +547,119 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
         if (string.IsNullOrEmpty(gameDomain))
             throw new ArgumentException("Game domain is required for NexusMods", nameof(gameDomain));
 
+        if (!int.TryParse(modId, out var id))
+            return null;
+
         try
         {
-            var response = await _client.GetAsync($"v1/games/{gameDomain}/mods/{modId}.json")
-                .WithHeader("apikey", _settings.NexusApiKey)
-                .WithHeader("accept", "application/json")
-                .AsJsonAsync();
-
-            var root = response.RootElement;
-
-            return new BackendMod
-            {
-                ModId = modId,
-                Name = root.TryGetProperty("name", out var nameProp) ? nameProp.GetString() ?? $"Mod {modId}" : $"Mod {modId}",
-                GameDomain = gameDomain,
-                BackendId = Id,
-                CategoryId = root.TryGetProperty("category_id", out var catProp) ? catProp.GetInt32() : null,
-                Summary = root.TryGetProperty("summary", out var sumProp) ? sumProp.GetString() : null,
-                Author = root.TryGetProperty("author", out var authProp) ? authProp.GetString() : null,
-                Url = $"https://www.nexusmods.com/{gameDomain}/mods/{modId}",
-                UpdatedAt = root.TryGetProperty("updated_timestamp", out var updProp)
-                    ? DateTimeOffset.FromUnixTimeSeconds(updProp.GetInt64()).DateTime
-                    : null,
-                ThumbnailUrl = root.TryGetProperty("picture_url", out var picProp) ? picProp.GetString() : null
-            };
+            var mod = await _batcher.LoadModAsync(gameDomain, id, ct: ct);
+            return mod == null ? null : NexusModsGraphQlClient.MapToBackendMod(mod, gameDomain);
         }
-        catch (Exception ex)
+        catch (Exception ex) when (ex is not OperationCanceledException)
         {
             _logger?.LogWarning(ex, "Failed to get mod info for {ModId}", modId);
             return null;
         }
     }
 
+    /// <summary>
+    /// Lists a mod's files through the GraphQL API. Listings requested around
+    /// the same time share requests, which makes this the cheap way to check
+    /// versions of many mods. The files carry no MD5; downloads should use
+    /// <see cref="GetModFilesAsync"/>.
+    /// </summary>
+    public async Task<List<BackendModFile>> GetModFilesBatchedAsync(
+        string modId,
+        string gameDomain,
+        bool includeArchived = false,
+        CancellationToken ct = default)
+    {
+        if (!int.TryParse(modId, out var id))
+            return [];
+
+        var files = await _batcher.LoadModFilesAsync(gameDomain, id, ct) ?? [];
+        return files
+            .Select(f => new BackendModFile
+            {
+                FileId = f.FileId.ToString(),
+                FileName = f.Uri ?? f.Name,
+                DisplayName = f.Name,
+                SizeBytes = f.SizeInBytes,
+                Version = f.Version,
+                Category = f.Category?.ToLowerInvariant(),
+                UploadedAt = f.Date > 0 ? DateTimeOffset.FromUnixTimeSeconds(f.Date).DateTime : null,
+                ModId = modId
+            })
+            .Where(f => includeArchived || f.Category is not ("old_version" or "archived"))
+            .ToList();
+    }
+
+    /// <summary>
+    /// Gets the Nexus mods a mod lists as requirements. Requirements hosted
+    /// elsewhere are left out. Batched like <see cref="GetModInfoAsync"/>.
+    /// </summary>
+    public async Task<List<NexusModRequirement>> GetModRequirementsAsync(
+        string modId,
+        string gameDomain,
+        CancellationToken ct = default)
+    {
+        if (!int.TryParse(modId, out var id))
+            return [];
+
+        var mod = await _batcher.LoadModAsync(gameDomain, id, withRequirements: true, ct);
+        var nodes = mod?.ModRequirements?.NexusRequirements?.Nodes ?? [];
+
+        return nodes
+            .Where(r => !r.ExternalRequirement && r.ModId > 0)
+            .Select(r => new NexusModRequirement
+            {
+                GameDomain = GameDomainFromUrl(r.Url) ?? gameDomain,
+                ModId = r.ModId.ToString(),
+                Name = r.ModName
+            })
+            .DistinctBy(r => (r.GameDomain, r.ModId))
+            .ToList();
+    }
+
+    // Requirements give the game as a numeric ID; the mod page URL has the domain
+    private static string? GameDomainFromUrl(string? url)
+    {
+        if (!Uri.TryCreate(url, UriKind.Absolute, out var uri))
+            return null;
+
+        var segments = uri.AbsolutePath.Trim('/').Split('/');
+        return segments.Length >= 3 && segments[1] == "mods" ? segments[0] : null;
+    }
+
+    /// <summary>
+    /// Gets the game domain and ID of every tracked mod in one request,
+    /// without the per-mod lookups <see cref="GetUserModsAsync"/> does for names.
+    /// </summary>
+    public async Task<List<(string GameDomain, int ModId)>> GetTrackedModKeysAsync(CancellationToken ct = default)
+    {
+        var response = await _client.GetAsync("v1/user/tracked_mods.json")
+            .WithHeader("apikey", _settings.NexusApiKey)
+            .WithHeader("accept", "application/json")
+            .AsArrayAsync<TrackedMod>();
+
+        _trackedModsCache = response.Select(m => (m.DomainName, m.ModId)).ToHashSet();
+        return response.Select(m => (m.DomainName, m.ModId)).ToList();
+    }
+
+    /// <summary>
+    /// Gets every mod of a game with new files in <paramref name="period"/>
+    /// ("1d", "1w" or "1m") from the updated.json feed, one request in total.
+    /// </summary>
+    public async Task<List<RemoteModUpdate>> GetModUpdatesAsync(string gameDomain, string period, CancellationToken ct = default)
+    {
+        var updated = await _client.GetAsync($"v1/games/{gameDomain}/mods/updated.json?period={period}")
+            .WithHeader("apikey", _settings.NexusApiKey)
+            .WithHeader("accept", "application/json")
+            .AsArrayAsync<NexusV1UpdatedMod>();
+
+        return updated.Select(m => new RemoteModUpdate(m.ModId.ToString(), m.LatestFileUpdate)).ToList();
+    }
+
     /// <summary>
     /// Checks if a mod is in the user's tracked list.
     /// </summary>
@@ -522,7 +746,7 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
 
         throw new InvalidOperationException($"Could not resolve game ID for domain '{gameDomain}'");
     }
-    private readonly Dictionary<string, int> _gameIdCache = new(StringComparer.OrdinalIgnoreCase);
+    private readonly ConcurrentDictionary<string, int> _gameIdCache = new(StringComparer.OrdinalIgnoreCase);
 
     // --- Collections ---
 
@@ -678,17 +902,11 @@ public class NexusModsBackend : IModBackend, ISearchableBackend
             .WithHeader("accept", "application/json")
             .AsArrayAsync<NexusV1UpdatedMod>();
 
-        // The updated endpoint only returns mod IDs and timestamps,
-        // so we fetch full info for each (cached where possible)
-        var result = new List<BackendMod>();
-        foreach (var updated in updatedMods)
-        {
-            ct.ThrowIfCancellationRequested();
-            var modInfo = await GetModInfoAsync(updated.ModId.ToString(), gameDomain, ct);
-            if (modInfo != null)
-                result.Add(modInfo);
-        }
-        return result;
+        // The updated endpoint only returns mod IDs and timestamps, so full
+        // info is fetched for all of them at once; the lookups share GraphQL requests
+        var modInfos = await Task.WhenAll(updatedMods.Select(updated =>
+            GetModInfoAsync(updated.ModId.ToString(), gameDomain, ct)));
+        return modInfos.OfType<BackendMod>().ToList();
     }
 
     private static BackendMod MapV1ModToBackendMod(NexusV1ModInfo mod, string gameDomain)
@@ -1,5 +1,6 @@
 using System.Text.Json;
 using Microsoft.Extensions.Logging;
+using Modular.Core.Resilience;
 using Modular.FluentHttp.Implementation;
 using Modular.FluentHttp.Interfaces;
 using Modular.Sdk.Backends;
@@ -89,14 +90,34 @@ internal class NexusModsGraphQlClient
     private const int MaxModsPerQuery = 20;
 
     private readonly IFluentClient _client;
-    private readonly string _apiKey;
+    private readonly string _endpoint;
+    private readonly Func<string> _apiKey;
     private readonly ILogger? _logger;
 
     public NexusModsGraphQlClient(string apiKey, Modular.FluentHttp.Interfaces.IRateLimiter rateLimiter, ILogger? logger = null)
+        : this(() => apiKey, rateLimiter, logger)
+    {
+    }
+
+    /// <summary>
+    /// Creates a client that asks <paramref name="apiKey"/> for the key on every
+    /// request, so a key changed in the settings is used without recreating it.
+    /// </summary>
+    /// <param name="apiKey">Returns the API key to send.</param>
+    /// <param name="rateLimiter">Rate limiter shared with the v1 client.</param>
+    /// <param name="logger">Optional logger.</param>
+    /// <param name="endpoint">GraphQL endpoint; the public API when null (tests use a local server).</param>
+    public NexusModsGraphQlClient(
+        Func<string> apiKey,
+        Modular.FluentHttp.Interfaces.IRateLimiter rateLimiter,
+        ILogger? logger = null,
+        string? endpoint = null)
     {
         _apiKey = apiKey;
         _logger = logger;
-        _client = FluentClientFactory.Create(GraphQlUrl, rateLimiter, logger);
+        _endpoint = endpoint ?? GraphQlUrl;
+        _client = FluentClientFactory.Create(_endpoint, rateLimiter, logger);
+        _client.SetRequestPolicy(new HttpResiliencePolicy());
         _client.SetUserAgent("Modular/1.0");
     }
 
@@ -141,8 +162,8 @@ internal class NexusModsGraphQlClient
         _logger?.LogDebug("Searching NexusMods GraphQL: terms={Terms}, game={Game}, page={Page}, adult={Adult}",
             query.Terms, query.GameDomain, query.Page, query.AdultContent);
 
-        var json = await _client.PostAsync(GraphQlUrl)
-            .WithHeader("apikey", _apiKey)
+        var json = await _client.PostAsync(_endpoint)
+            .WithHeader("apikey", _apiKey())
             .WithHeader("accept", "application/json")
             .WithJsonBody(requestBody)
             .AsStringAsync();
@@ -185,7 +206,7 @@ internal class NexusModsGraphQlClient
         };
     }
 
-    private static BackendMod MapToBackendMod(NexusGraphQlMod node, string fallbackDomain)
+    internal static BackendMod MapToBackendMod(NexusGraphQlMod node, string fallbackDomain)
     {
         var domain = node.Game?.DomainName ?? fallbackDomain;
 
@@ -212,6 +233,41 @@ internal class NexusModsGraphQlClient
         };
     }
 
+    /// <summary>
+    /// Runs an arbitrary query and returns its <c>data</c> object. Errors only
+    /// fail the call when there is no data; with partial results the fields
+    /// that failed are null and the rest are usable.
+    /// </summary>
+    public async Task<JsonElement> ExecuteAsync(
+        string query, IReadOnlyDictionary<string, object?> variables, CancellationToken ct = default)
+    {
+        var json = await _client.PostAsync(_endpoint)
+            .WithHeader("apikey", _apiKey())
+            .WithHeader("accept", "application/json")
+            .WithJsonBody(new { query, variables })
+            .AsStringAsync();
+
+        using var document = JsonDocument.Parse(json);
+        var root = document.RootElement;
+        var hasData = root.TryGetProperty("data", out var data) && data.ValueKind == JsonValueKind.Object;
+
+        if (root.TryGetProperty("errors", out var errors) && errors.ValueKind == JsonValueKind.Array && errors.GetArrayLength() > 0)
+        {
+            var errorMessages = string.Join("; ", errors.EnumerateArray()
+                .Select(e => e.TryGetProperty("message", out var m) ? m.GetString() : null)
+                .Where(m => !string.IsNullOrEmpty(m)));
+            if (!hasData)
+                throw new InvalidOperationException($"NexusMods API error: {errorMessages}");
+
+            _logger?.LogDebug("GraphQL returned partial errors: {Errors}", errorMessages);
+        }
+
+        if (!hasData)
+            throw new InvalidOperationException("NexusMods API returned no data");
+
+        return data.Clone();
+    }
+
     /// <summary>
     /// Fetches mod metadata for multiple mod IDs in a single GraphQL request.
     /// Returns up to <see cref="MaxModsPerQuery"/> mods per call.
@@ -240,8 +296,8 @@ internal class NexusModsGraphQlClient
 
         _logger?.LogDebug("GraphQL batch fetch: {Count} mod(s) for {Game}", modIds.Count, gameDomain);
 
-        var json = await _client.PostAsync(GraphQlUrl)
-            .WithHeader("apikey", _apiKey)
+        var json = await _client.PostAsync(_endpoint)
+            .WithHeader("apikey", _apiKey())
             .WithHeader("accept", "application/json")
             .WithJsonBody(requestBody)
             .AsStringAsync();
@@ -322,8 +378,8 @@ internal class NexusModsGraphQlClient
         _logger?.LogDebug("Searching NexusMods collections: gameId={GameId}, game={Game}, count={Count}, offset={Offset}",
             gameId, gameDomain, count, offset);
 
-        var json = await _client.PostAsync(GraphQlUrl)
-            .WithHeader("apikey", _apiKey)
+        var json = await _client.PostAsync(_endpoint)
+            .WithHeader("apikey", _apiKey())
             .WithHeader("accept", "application/json")
             .WithJsonBody(requestBody)
             .AsStringAsync();
@@ -381,8 +437,8 @@ internal class NexusModsGraphQlClient
 
         _logger?.LogDebug("Fetching NexusMods collection details: slug={Slug}, game={Game}", slug, gameDomain);
 
-        var json = await _client.PostAsync(GraphQlUrl)
-            .WithHeader("apikey", _apiKey)
+        var json = await _client.PostAsync(_endpoint)
+            .WithHeader("apikey", _apiKey())
             .WithHeader("accept", "application/json")
             .WithJsonBody(requestBody)
             .AsStringAsync();
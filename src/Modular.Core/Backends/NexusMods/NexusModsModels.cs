@@ -81,6 +81,69 @@ internal record NexusGraphQlMod
 
     [JsonPropertyName("game")]
     public NexusGraphQlGame? Game { get; init; }
+
+    /// <summary>
+    /// Only present when the query selected it.
+    /// </summary>
+    [JsonPropertyName("modRequirements")]
+    public NexusGraphQlModRequirements? ModRequirements { get; init; }
+}
+
+internal record NexusGraphQlModRequirements
+{
+    [JsonPropertyName("nexusRequirements")]
+    public NexusGraphQlRequirementPage? NexusRequirements { get; init; }
+}
+
+internal record NexusGraphQlRequirementPage
+{
+    [JsonPropertyName("nodes")]
+    public List<NexusGraphQlRequirement> Nodes { get; init; } = [];
+}
+
+internal record NexusGraphQlRequirement
+{
+    [JsonPropertyName("modId")]
+    [JsonNumberHandling(JsonNumberHandling.AllowReadingFromString)]
+    public int ModId { get; init; }
+
+    [JsonPropertyName("modName")]
+    public string? ModName { get; init; }
+
+    [JsonPropertyName("url")]
+    public string? Url { get; init; }
+
+    [JsonPropertyName("externalRequirement")]
+    public bool ExternalRequirement { get; init; }
+}
+
+/// <summary>
+/// A file from the GraphQL modFiles query. Unlike the v1 file list it has no MD5.
+/// </summary>
+internal record NexusGraphQlModFile
+{
+    [JsonPropertyName("fileId")]
+    [JsonNumberHandling(JsonNumberHandling.AllowReadingFromString)]
+    public int FileId { get; init; }
+
+    [JsonPropertyName("name")]
+    public string Name { get; init; } = string.Empty;
+
+    [JsonPropertyName("uri")]
+    public string? Uri { get; init; }
+
+    [JsonPropertyName("version")]
+    public string? Version { get; init; }
+
+    [JsonPropertyName("category")]
+    public string? Category { get; init; }
+
+    [JsonPropertyName("date")]
+    public long Date { get; init; }
+
+    [JsonPropertyName("sizeInBytes")]
+    [JsonNumberHandling(JsonNumberHandling.AllowReadingFromString)]
+    public long? SizeInBytes { get; init; }
 }
 
 internal record NexusGraphQlModCategory
@@ -285,6 +348,16 @@ public record NexusCollectionInfo
     public string Url => $"https://next.nexusmods.com/{GameDomain}/collections/{Slug}";
 }
 
+/// <summary>
+/// A mod another Nexus mod lists as required.
+/// </summary>
+public record NexusModRequirement
+{
+    public string GameDomain { get; init; } = string.Empty;
+    public string ModId { get; init; } = string.Empty;
+    public string? Name { get; init; }
+}
+
 /// <summary>
 /// v1 API models for discovery endpoints (trending, latest, updated).
 /// </summary>
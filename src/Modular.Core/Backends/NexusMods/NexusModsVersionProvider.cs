@@ -1,3 +1,5 @@
+using System.Collections.Concurrent;
+using System.Globalization;
 using Microsoft.Extensions.Logging;
 using Modular.Core.Dependencies;
 using Modular.Core.Metadata;
@@ -11,11 +13,18 @@ namespace Modular.Core.Backends.NexusMods;
 /// Provides mod version information from NexusMods for dependency resolution.
 /// Parses canonical IDs in the format "nexusmods:{modId}" or "nexusmods:{gameDomain}:{modId}".
 /// </summary>
+/// <remarks>
+/// Backed by <see cref="NexusModsBackend"/>, file lists and requirements come
+/// from batched GraphQL lookups and are kept for the life of the provider, so
+/// create one per resolution.
+/// </remarks>
 public class NexusModsVersionProvider : IModVersionProvider
 {
     private readonly IModBackend _backend;
     private readonly string _defaultGameDomain;
     private readonly ILogger<NexusModsVersionProvider>? _logger;
+    private readonly ConcurrentDictionary<(string GameDomain, string ModId), Task<List<BackendModFile>>> _files = new();
+    private readonly ConcurrentDictionary<(string GameDomain, string ModId), Task<List<ModDependency>>> _requirements = new();
 
     public NexusModsVersionProvider(
         IModBackend backend,
@@ -33,24 +42,134 @@ public class NexusModsVersionProvider : IModVersionProvider
     {
         var (gameDomain, modId) = ParseCanonicalId(canonicalId);
 
-        var files = await _backend.GetModFilesAsync(modId, gameDomain, ct: ct);
+        if (_backend is not NexusModsBackend nexus)
+            return ExtractVersions(await _backend.GetModFilesAsync(modId, gameDomain, ct: ct));
 
-        return ExtractVersions(files);
+        return ExtractVersions(await LoadFiles(nexus, (gameDomain, modId)).WaitAsync(ct));
     }
 
-    public Task<List<ModDependency>> GetDependenciesAsync(
+    public async Task<List<ModDependency>> GetDependenciesAsync(
         string canonicalId,
         SemanticVersion version,
         CancellationToken ct = default)
     {
-        // NexusMods API does not expose structured dependency data.
-        // Return an empty list; dependencies would need to come from
-        // FOMOD metadata or manual user configuration.
-        _logger?.LogDebug(
-            "NexusMods does not provide structured dependency data for {CanonicalId}@{Version}",
-            canonicalId, version);
-
-        return Task.FromResult(new List<ModDependency>());
+        if (_backend is not NexusModsBackend nexus)
+        {
+            // Only the GraphQL API has requirements; the v1 API has no dependency data
+            _logger?.LogDebug(
+                "No structured dependency data for {CanonicalId}@{Version} without the NexusMods backend",
+                canonicalId, version);
+            return [];
+        }
+
+        // Nexus requirements are per mod, not per version
+        return await LoadRequirements(nexus, ParseCanonicalId(canonicalId)).WaitAsync(ct);
+    }
+
+    /// <summary>
+    /// Starts the file and requirement lookups for every mod at once so they
+    /// go out in a few batched requests; the resolver then reads them back one
+    /// by one.
+    /// </summary>
+    public async Task PrefetchAsync(IReadOnlyCollection<string> canonicalIds, CancellationToken ct = default)
+    {
+        if (_backend is not NexusModsBackend nexus)
+            return;
+
+        var loads = new List<Task>();
+        foreach (var canonicalId in canonicalIds)
+        {
+            (string GameDomain, string ModId) key;
+            try
+            {
+                key = ParseCanonicalId(canonicalId);
+            }
+            catch (ArgumentException)
+            {
+                continue;
+            }
+
+            loads.Add(LoadFiles(nexus, key));
+            loads.Add(LoadRequirements(nexus, key));
+        }
+
+        try
+        {
+            await Task.WhenAll(loads).WaitAsync(ct);
+        }
+        catch (Exception ex) when (ex is not OperationCanceledException)
+        {
+            // Failures surface again when the resolver asks for that mod
+            _logger?.LogDebug(ex, "Prefetch of {Count} mod(s) failed", canonicalIds.Count);
+        }
+    }
+
+    /// <summary>
+    /// Uses each mod's last-updated time, which Nexus bumps whenever a file
+    /// or the mod page changes. The lookups are batched like
+    /// <see cref="PrefetchAsync"/> and fetch no file lists or requirements.
+    /// Mods that can't be looked up are left out.
+    /// </summary>
+    public async Task<Dictionary<string, string>> GetDataVersionsAsync(
+        IReadOnlyCollection<string> canonicalIds,
+        CancellationToken ct = default)
+    {
+        var dataVersions = new Dictionary<string, string>();
+        if (_backend is not NexusModsBackend nexus)
+            return dataVersions;
+
+        var lookups = new List<(string CanonicalId, Task<BackendMod?> Mod)>();
+        foreach (var canonicalId in canonicalIds.Distinct())
+        {
+            (string GameDomain, string ModId) key;
+            try
+            {
+                key = ParseCanonicalId(canonicalId);
+            }
+            catch (ArgumentException)
+            {
+                continue;
+            }
+
+            lookups.Add((canonicalId, nexus.GetModInfoAsync(key.ModId, key.GameDomain, ct)));
+        }
+
+        foreach (var (canonicalId, lookup) in lookups)
+        {
+            if (await lookup is { UpdatedAt: { } updatedAt })
+                dataVersions[canonicalId] = updatedAt.ToUniversalTime().ToString("O", CultureInfo.InvariantCulture);
+        }
+
+        return dataVersions;
+    }
+
+    private Task<List<BackendModFile>> LoadFiles(NexusModsBackend nexus, (string GameDomain, string ModId) key) =>
+        Memoize(_files, key, k => nexus.GetModFilesBatchedAsync(k.ModId, k.GameDomain));
+
+    private Task<List<ModDependency>> LoadRequirements(NexusModsBackend nexus, (string GameDomain, string ModId) key) =>
+        Memoize(_requirements, key, async k =>
+            (await nexus.GetModRequirementsAsync(k.ModId, k.GameDomain))
+                .Select(r => new ModDependency
+                {
+                    Type = DependencyType.Required,
+                    Target = new DependencyTarget { BackendId = "nexusmods", ProjectId = $"{r.GameDomain}:{r.ModId}" }
+                })
+                .ToList());
+
+    // Shares one lookup per mod between callers; a failed lookup is dropped so it can be retried
+    private static Task<T> Memoize<T>(
+        ConcurrentDictionary<(string GameDomain, string ModId), Task<T>> cache,
+        (string GameDomain, string ModId) key,
+        Func<(string GameDomain, string ModId), Task<T>> load)
+    {
+        var task = cache.GetOrAdd(key, load);
+        if (task.IsFaulted || task.IsCanceled)
+        {
+            cache.TryRemove(new KeyValuePair<(string, string), Task<T>>(key, task));
+            task = cache.GetOrAdd(key, load);
+        }
+
+        return task;
     }
 
     /// <summary>
@@ -0,0 +1,341 @@
+using System.Text;
+using System.Text.Json;
+using Microsoft.Extensions.Logging;
+
+namespace Modular.Core.Backends.NexusMods;
+
+/// <summary>
+/// Coalesces mod and file lookups into GraphQL requests, DataLoader style.
+/// Loads asked for within a short window are collected, duplicates merged,
+/// and sent together as one query with an aliased selection per game's mods
+/// and per file list. Each caller gets back its own result.
+/// </summary>
+internal sealed class NexusQueryBatcher
+{
+    /// <summary>
+    /// How long the first load of a batch waits for others to join it.
+    /// </summary>
+    public static readonly TimeSpan DefaultWindow = TimeSpan.FromMilliseconds(10);
+
+    /// <summary>
+    /// Mods per <c>mods</c> selection, the page size the search API returns.
+    /// </summary>
+    internal const int ModsPerSelection = 20;
+
+    /// <summary>
+    /// Aliased selections per request, to keep query cost within API limits.
+    /// </summary>
+    internal const int MaxSelectionsPerRequest = 100;
+
+    // A batch this large is sent without waiting for the window to close
+    private const int MaxPendingLoads = 1000;
+
+    private const string ModFields =
+        "modId name summary author version category modCategory { categoryId } endorsements downloads " +
+        "createdAt updatedAt pictureUrl adultContent game { domainName }";
+
+    private const string RequirementFields =
+        "modRequirements { nexusRequirements { nodes { modId modName url externalRequirement } } }";
+
+    private const string FileFields = "fileId name uri version category date sizeInBytes";
+
+    private static readonly JsonSerializerOptions JsonOptions = new() { PropertyNameCaseInsensitive = true };
+
+    private readonly Func<string, IReadOnlyDictionary<string, object?>, CancellationToken, Task<JsonElement>> _execute;
+    private readonly Func<string, CancellationToken, Task<int>> _resolveGameId;
+    private readonly TimeSpan _window;
+    private readonly ILogger? _logger;
+    private readonly object _lock = new();
+    private Dictionary<NexusLoadKey, TaskCompletionSource<object?>> _pending = new();
+
+    /// <param name="execute">Runs a query with variables and returns its data object.</param>
+    /// <param name="resolveGameId">Maps a game domain to the numeric ID file queries need.</param>
+    /// <param name="logger">Optional logger.</param>
+    /// <param name="window">Batching window; <see cref="DefaultWindow"/> when null.</param>
+    public NexusQueryBatcher(
+        Func<string, IReadOnlyDictionary<string, object?>, CancellationToken, Task<JsonElement>> execute,
+        Func<string, CancellationToken, Task<int>> resolveGameId,
+        ILogger? logger = null,
+        TimeSpan? window = null)
+    {
+        _execute = execute;
+        _resolveGameId = resolveGameId;
+        _logger = logger;
+        _window = window ?? DefaultWindow;
+    }
+
+    /// <summary>
+    /// Loads a mod, or null if it doesn't exist.
+    /// </summary>
+    /// <param name="gameDomain">Game domain name.</param>
+    /// <param name="modId">Mod ID.</param>
+    /// <param name="withRequirements">Also select the mods it requires.</param>
+    /// <param name="ct">Stops waiting; the shared request carries on for other callers.</param>
+    public async Task<NexusGraphQlMod?> LoadModAsync(
+        string gameDomain, int modId, bool withRequirements = false, CancellationToken ct = default)
+    {
+        var kind = withRequirements ? NexusLoadKind.ModWithRequirements : NexusLoadKind.Mod;
+        return (NexusGraphQlMod?)await LoadAsync(new NexusLoadKey(kind, gameDomain, modId), ct);
+    }
+
+    /// <summary>
+    /// Loads a mod's files, or null if the mod doesn't exist.
+    /// </summary>
+    public async Task<List<NexusGraphQlModFile>?> LoadModFilesAsync(
+        string gameDomain, int modId, CancellationToken ct = default)
+    {
+        return (List<NexusGraphQlModFile>?)await LoadAsync(new NexusLoadKey(NexusLoadKind.Files, gameDomain, modId), ct);
+    }
+
+    private Task<object?> LoadAsync(NexusLoadKey key, CancellationToken ct)
+    {
+        TaskCompletionSource<object?>? load;
+        Dictionary<NexusLoadKey, TaskCompletionSource<object?>>? startWindow = null;
+        Dictionary<NexusLoadKey, TaskCompletionSource<object?>>? sendNow = null;
+
+        lock (_lock)
+        {
+            if (!_pending.TryGetValue(key, out load))
+            {
+                load = new TaskCompletionSource<object?>(TaskCreationOptions.RunContinuationsAsynchronously);
+                _pending[key] = load;
+
+                if (_pending.Count == 1)
+                {
+                    startWindow = _pending;
+                }
+                else if (_pending.Count >= MaxPendingLoads)
+                {
+                    sendNow = _pending;
+                    _pending = new();
+                }
+            }
+        }
+
+        if (startWindow != null)
+            _ = SendAfterWindowAsync(startWindow);
+        if (sendNow != null)
+            _ = SendAsync(sendNow);
+
+        return load.Task.WaitAsync(ct);
+    }
+
+    private async Task SendAfterWindowAsync(Dictionary<NexusLoadKey, TaskCompletionSource<object?>> batch)
+    {
+        await Task.Delay(_window);
+
+        lock (_lock)
+        {
+            // Already sent because it filled up
+            if (!ReferenceEquals(_pending, batch))
+                return;
+            _pending = new();
+        }
+
+        await SendAsync(batch);
+    }
+
+    private async Task SendAsync(Dictionary<NexusLoadKey, TaskCompletionSource<object?>> batch)
+    {
+        try
+        {
+            var selections = await PlanSelectionsAsync(batch);
+            var requests = selections.Chunk(MaxSelectionsPerRequest).ToList();
+
+            _logger?.LogDebug("GraphQL batch: {Loads} load(s) in {Selections} selection(s), {Requests} request(s)",
+                batch.Count, selections.Count, requests.Count);
+
+            await Task.WhenAll(requests.Select(request => SendRequestAsync(request, batch)));
+        }
+        catch (Exception ex)
+        {
+            foreach (var load in batch.Values)
+                load.TrySetException(ex);
+        }
+        finally
+        {
+            // Anything the response didn't mention doesn't exist
+            foreach (var load in batch.Values)
+                load.TrySetResult(null);
+        }
+    }
+
+    /// <summary>
+    /// Groups a batch into selections: each game's mods in pages, and one
+    /// file list per mod. A mod asked for both with and without requirements
+    /// is fetched once, with them.
+    /// </summary>
+    private async Task<List<NexusSelection>> PlanSelectionsAsync(
+        Dictionary<NexusLoadKey, TaskCompletionSource<object?>> batch)
+    {
+        var selections = new List<NexusSelection>();
+
+        foreach (var game in batch.Keys.Where(k => k.Kind != NexusLoadKind.Files).GroupBy(k => k.GameDomain))
+        {
+            var withRequirements = game.Where(k => k.Kind == NexusLoadKind.ModWithRequirements)
+                .Select(k => k.ModId).ToHashSet();
+            var plain = game.Where(k => k.Kind == NexusLoadKind.Mod && !withRequirements.Contains(k.ModId))
+                .Select(k => k.ModId).Distinct();
+
+            foreach (var page in withRequirements.Order().Chunk(ModsPerSelection))
+                selections.Add(new NexusSelection(NexusLoadKind.ModWithRequirements, game.Key, page, GameId: 0));
+            foreach (var page in plain.Order().Chunk(ModsPerSelection))
+                selections.Add(new NexusSelection(NexusLoadKind.Mod, game.Key, page, GameId: 0));
+        }
+
+        foreach (var game in batch.Keys.Where(k => k.Kind == NexusLoadKind.Files).GroupBy(k => k.GameDomain))
+        {
+            int gameId;
+            try
+            {
+                gameId = await _resolveGameId(game.Key, CancellationToken.None);
+            }
+            catch (Exception ex)
+            {
+                foreach (var key in game)
+                    batch[key].TrySetException(ex);
+                continue;
+            }
+
+            foreach (var key in game.OrderBy(k => k.ModId))
+                selections.Add(new NexusSelection(NexusLoadKind.Files, game.Key, [key.ModId], gameId));
+        }
+
+        return selections;
+    }
+
+    private async Task SendRequestAsync(
+        NexusSelection[] selections,
+        Dictionary<NexusLoadKey, TaskCompletionSource<object?>> batch)
+    {
+        var (query, variables) = BuildQuery(selections);
+
+        JsonElement data;
+        try
+        {
+            data = await _execute(query, variables, CancellationToken.None);
+        }
+        catch (Exception ex)
+        {
+            foreach (var key in selections.SelectMany(KeysOf))
+            {
+                if (batch.TryGetValue(key, out var load))
+                    load.TrySetException(ex);
+            }
+            return;
+        }
+
+        for (var i = 0; i < selections.Length; i++)
+        {
+            var selection = selections[i];
+            data.TryGetProperty(Alias(i), out var result);
+
+            if (selection.Kind == NexusLoadKind.Files)
+            {
+                List<NexusGraphQlModFile>? files = result.ValueKind == JsonValueKind.Array
+                    ? result.Deserialize<List<NexusGraphQlModFile>>(JsonOptions)
+                    : null;
+                Complete(batch, new NexusLoadKey(NexusLoadKind.Files, selection.GameDomain, selection.ModIds[0]), files);
+                continue;
+            }
+
+            var mods = result.ValueKind == JsonValueKind.Object && result.TryGetProperty("nodes", out var nodes)
+                ? nodes.Deserialize<List<NexusGraphQlMod>>(JsonOptions) ?? []
+                : [];
+
+            // A node listed twice must not fail the whole batch; the first one wins
+            var byId = new Dictionary<int, NexusGraphQlMod>();
+            foreach (var mod in mods)
+                byId.TryAdd(mod.ModId, mod);
+
+            foreach (var modId in selection.ModIds)
+            {
+                byId.TryGetValue(modId, out var mod);
+                Complete(batch, new NexusLoadKey(NexusLoadKind.ModWithRequirements, selection.GameDomain, modId), mod);
+                Complete(batch, new NexusLoadKey(NexusLoadKind.Mod, selection.GameDomain, modId), mod);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Builds one query with an aliased field per selection (s0, s1, ...),
+    /// passing every argument as a variable.
+    /// </summary>
+    internal static (string Query, Dictionary<string, object?> Variables) BuildQuery(IReadOnlyList<NexusSelection> selections)
+    {
+        var declarations = new List<string>();
+        var fields = new StringBuilder();
+        var variables = new Dictionary<string, object?>();
+
+        for (var i = 0; i < selections.Count; i++)
+        {
+            var selection = selections[i];
+            var alias = Alias(i);
+
+            if (selection.Kind == NexusLoadKind.Files)
+            {
+                declarations.Add($"${alias}m: ID!");
+                declarations.Add($"${alias}g: ID!");
+                variables[$"{alias}m"] = selection.ModIds[0].ToString();
+                variables[$"{alias}g"] = selection.GameId.ToString();
+                fields.Append($"  {alias}: modFiles(modId: ${alias}m, gameId: ${alias}g) {{ {FileFields} }}\n");
+                continue;
+            }
+
+            declarations.Add($"${alias}: ModsFilter");
+            variables[alias] = new Dictionary<string, object>
+            {
+                ["gameDomainName"] = new[] { new { value = selection.GameDomain } },
+                ["modId"] = selection.ModIds.Select(id => new { value = id }).ToArray()
+            };
+
+            var selected = selection.Kind == NexusLoadKind.ModWithRequirements
+                ? $"{ModFields} {RequirementFields}"
+                : ModFields;
+            fields.Append($"  {alias}: mods(filter: ${alias}, count: {selection.ModIds.Length}) {{ nodes {{ {selected} }} }}\n");
+        }
+
+        var query = $"query Batch({string.Join(", ", declarations)}) {{\n{fields}}}";
+        return (query, variables);
+    }
+
+    private static string Alias(int index) => $"s{index}";
+
+    private static IEnumerable<NexusLoadKey> KeysOf(NexusSelection selection)
+    {
+        foreach (var modId in selection.ModIds)
+        {
+            if (selection.Kind == NexusLoadKind.Files)
+            {
+                yield return new NexusLoadKey(NexusLoadKind.Files, selection.GameDomain, modId);
+            }
+            else
+            {
+                yield return new NexusLoadKey(NexusLoadKind.Mod, selection.GameDomain, modId);
+                yield return new NexusLoadKey(NexusLoadKind.ModWithRequirements, selection.GameDomain, modId);
+            }
+        }
+    }
+
+    private static void Complete(
+        Dictionary<NexusLoadKey, TaskCompletionSource<object?>> batch, NexusLoadKey key, object? result)
+    {
+        if (batch.TryGetValue(key, out var load))
+            load.TrySetResult(result);
+    }
+}
+
+internal enum NexusLoadKind
+{
+    Mod,
+    ModWithRequirements,
+    Files
+}
+
+internal readonly record struct NexusLoadKey(NexusLoadKind Kind, string GameDomain, int ModId);
+
+/// <summary>
+/// One aliased field of a batched query: a page of one game's mods, or one
+/// mod's files.
+/// </summary>
+internal sealed record NexusSelection(NexusLoadKind Kind, string GameDomain, int[] ModIds, int GameId);
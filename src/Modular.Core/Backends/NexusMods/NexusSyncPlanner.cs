@@ -0,0 +1,162 @@
+using System.Globalization;
+using Modular.Core.Database;
+using Modular.Sdk.Backends.Common;
+
+namespace Modular.Core.Backends.NexusMods;
+
+/// <summary>
+/// Decides which tracked mods need their file lists fetched on a re-sync.
+/// A mod whose files were fully synced at time T only needs listing again if
+/// the updated-mods feed shows a file upload after T. One updated.json call
+/// covers every tracked mod of a game, so a re-sync with nothing new costs
+/// that call plus the tracked-mods list.
+/// </summary>
+internal static class NexusSyncPlanner
+{
+    /// <summary>
+    /// Periods accepted by updated.json, shortest first.
+    /// </summary>
+    private static readonly (string Period, long Seconds)[] UpdatedPeriods =
+    [
+        ("1d", 86_400),
+        ("1w", 7 * 86_400),
+        ("1m", 28 * 86_400)
+    ];
+
+    /// <summary>
+    /// Slack for clock skew between us and the API and for feed lag.
+    /// </summary>
+    private const long SafetyMarginSeconds = 3_600;
+
+    /// <summary>
+    /// Picks the shortest updated.json period that reaches back to the oldest
+    /// sync we'd like to confirm, or null if no state is usable and every mod
+    /// has to be listed anyway.
+    /// </summary>
+    public static string? ChooseUpdatedPeriod(
+        TrackedModSyncState? state,
+        IEnumerable<int> trackedModIds,
+        string filterKey,
+        long now)
+    {
+        if (state == null || state.FilterKey != filterKey)
+            return null;
+
+        long? oldest = null;
+        foreach (var modId in trackedModIds)
+        {
+            if (state.SyncedAt.TryGetValue(modId, out var syncedAt))
+                oldest = oldest == null ? syncedAt : Math.Min(oldest.Value, syncedAt);
+        }
+
+        if (oldest == null)
+            return null;
+
+        // Older than the longest period: use it anyway, mods it can't vouch for are relisted
+        return PeriodCovering(oldest.Value, now);
+    }
+
+    /// <summary>
+    /// The shortest updated.json period that reaches back to <paramref name="since"/>,
+    /// or the longest one if none does or <paramref name="since"/> is null.
+    /// </summary>
+    public static string PeriodCovering(long? since, long now)
+    {
+        if (since != null)
+        {
+            var age = now - since.Value + SafetyMarginSeconds;
+            foreach (var (period, seconds) in UpdatedPeriods)
+            {
+                if (age <= seconds)
+                    return period;
+            }
+        }
+
+        return UpdatedPeriods[^1].Period;
+    }
+
+    /// <summary>
+    /// Builds the plan for one game domain.
+    /// </summary>
+    /// <param name="trackedModIds">Currently tracked mods.</param>
+    /// <param name="state">Stored state, or null on first sync.</param>
+    /// <param name="updated">Result of updated.json for <paramref name="period"/>, or null if not fetched.</param>
+    /// <param name="period">The period that was fetched.</param>
+    /// <param name="filterKey">Fingerprint of the current file filter.</param>
+    /// <param name="now">Unix time the sync started.</param>
+    /// <param name="force">List every mod regardless of state.</param>
+    public static NexusSyncPlan Plan(
+        IReadOnlyCollection<int> trackedModIds,
+        TrackedModSyncState? state,
+        IReadOnlyList<NexusV1UpdatedMod>? updated,
+        string? period,
+        string filterKey,
+        long now,
+        bool force)
+    {
+        var plan = new NexusSyncPlan();
+
+        var usable = !force && state != null && state.FilterKey == filterKey && updated != null && period != null;
+        if (!usable)
+        {
+            plan.ModsToList.AddRange(trackedModIds);
+            return plan;
+        }
+
+        var windowStart = now - UpdatedPeriods.First(p => p.Period == period).Seconds + SafetyMarginSeconds;
+        var latestUpload = new Dictionary<int, long>();
+        foreach (var mod in updated!)
+            latestUpload[mod.ModId] = mod.LatestFileUpdate;
+
+        foreach (var modId in trackedModIds)
+        {
+            if (!state!.SyncedAt.TryGetValue(modId, out var syncedAt) || syncedAt < windowStart)
+            {
+                // Never fully synced, or synced before what the feed can see
+                plan.ModsToList.Add(modId);
+            }
+            else if (latestUpload.TryGetValue(modId, out var uploaded) && uploaded >= syncedAt - SafetyMarginSeconds)
+            {
+                plan.ModsToList.Add(modId);
+            }
+            else
+            {
+                plan.Unchanged.Add(modId);
+            }
+        }
+
+        return plan;
+    }
+
+    /// <summary>
+    /// Fingerprint of a file filter. State built under one filter says nothing
+    /// about the files another filter would select.
+    /// </summary>
+    public static string FilterKey(FileFilter? filter)
+    {
+        if (filter == null)
+            return string.Empty;
+
+        var categories = filter.Categories is { Count: > 0 }
+            ? string.Join(",", filter.Categories.Select(c => c.ToLowerInvariant()).Order(StringComparer.Ordinal))
+            : "*";
+        var after = filter.UploadedAfter?.ToUniversalTime().ToString("O", CultureInfo.InvariantCulture) ?? "-";
+        return $"{categories}|{after}|{filter.IncludeArchived}|{filter.MinVersion}";
+    }
+}
+
+/// <summary>
+/// Which tracked mods a sync has to look at.
+/// </summary>
+internal sealed class NexusSyncPlan
+{
+    /// <summary>
+    /// Mods whose file lists must be fetched.
+    /// </summary>
+    public List<int> ModsToList { get; } = [];
+
+    /// <summary>
+    /// Mods with no file uploads since their last full sync.
+    /// </summary>
+    public List<int> Unchanged { get; } = [];
+}
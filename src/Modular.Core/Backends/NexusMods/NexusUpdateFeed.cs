@@ -0,0 +1,90 @@
+using Modular.Core.Database;
+using Modular.Core.Updates;
+
+namespace Modular.Core.Backends.NexusMods;
+
+/// <summary>
+/// NexusMods change feed: updated.json lists every mod of a game with file
+/// uploads in the last day, week or month. Watched mods are the ones in the
+/// download database plus the user's tracked mods.
+/// </summary>
+public sealed class NexusUpdateFeed : IUpdateFeed
+{
+    private readonly NexusModsBackend _backend;
+    private readonly DownloadDatabase _database;
+    private readonly ModMetadataCache _metadataCache;
+
+    public NexusUpdateFeed(NexusModsBackend backend, DownloadDatabase database, ModMetadataCache metadataCache)
+    {
+        _backend = backend;
+        _database = database;
+        _metadataCache = metadataCache;
+    }
+
+    public string BackendId => _backend.Id;
+
+    public bool IsAvailable => _backend.ValidateConfiguration().Count == 0;
+
+    public async Task<IReadOnlyList<WatchedMod>> GetWatchedModsAsync(CancellationToken ct = default)
+    {
+        var mods = new Dictionary<(string Domain, int ModId), WatchedMod>();
+
+        // Downloaded: we have the files as of the newest download
+        foreach (var group in _database.GetAllRecords()
+                     .Where(r => r.Status == DownloadStatus.Success && !string.IsNullOrEmpty(r.GameDomain))
+                     .GroupBy(r => (r.GameDomain, r.ModId)))
+        {
+            var latest = group.Max(r => r.DownloadTime);
+            mods[group.Key] = new WatchedMod
+            {
+                GameDomain = group.Key.GameDomain,
+                ModId = group.Key.ModId.ToString(),
+                Name = _metadataCache.GetModMetadata(group.Key.GameDomain, group.Key.ModId)?.Name ?? string.Empty,
+                Source = WatchSource.Downloaded,
+                BaselineAt = new DateTimeOffset(DateTime.SpecifyKind(latest, DateTimeKind.Utc)).ToUnixTimeSeconds()
+            };
+        }
+
+        // Tracked: a full tracked-mod sync also counts as having the files
+        var syncStates = new Dictionary<string, TrackedModSyncState?>(StringComparer.Ordinal);
+        foreach (var key in await _backend.GetTrackedModKeysAsync(ct))
+        {
+            if (!syncStates.TryGetValue(key.GameDomain, out var state))
+                syncStates[key.GameDomain] = state = _metadataCache.GetTrackedSyncState(key.GameDomain);
+
+            long? syncedAt = state != null && state.SyncedAt.TryGetValue(key.ModId, out var at) ? at : null;
+
+            if (mods.TryGetValue(key, out var downloaded))
+            {
+                mods[key] = downloaded with
+                {
+                    Source = downloaded.Source | WatchSource.Tracked,
+                    BaselineAt = Math.Max(downloaded.BaselineAt ?? 0, syncedAt ?? 0)
+                };
+            }
+            else
+            {
+                mods[key] = new WatchedMod
+                {
+                    GameDomain = key.GameDomain,
+                    ModId = key.ModId.ToString(),
+                    Name = _metadataCache.GetModMetadata(key.GameDomain, key.ModId)?.Name ?? string.Empty,
+                    Source = WatchSource.Tracked,
+                    BaselineAt = syncedAt
+                };
+            }
+        }
+
+        return mods.Values.ToList();
+    }
+
+    public async Task<IReadOnlyList<RemoteModUpdate>> GetUpdatesAsync(
+        string gameDomain,
+        long? since,
+        long now,
+        CancellationToken ct = default)
+    {
+        var period = NexusSyncPlanner.PeriodCovering(since, now);
+        return await _backend.GetModUpdatesAsync(gameDomain, period, ct);
+    }
+}
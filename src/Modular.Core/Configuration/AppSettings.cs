@@ -97,6 +97,30 @@ public class AppSettings
     [JsonPropertyName("max_concurrent_downloads")]
     public int MaxConcurrentDownloads { get; set; } = 1;
 
+    /// <summary>
+    /// Total download bandwidth for all Modular processes, in KB/s (0 = unlimited).
+    /// </summary>
+    [JsonPropertyName("bandwidth_limit_kbps")]
+    public int BandwidthLimitKbps { get; set; } = 0;
+
+    /// <summary>
+    /// Time-of-day overrides of the bandwidth limit, e.g. "mon-fri 09:00-18:00 512".
+    /// </summary>
+    [JsonPropertyName("bandwidth_schedule")]
+    public List<string> BandwidthSchedule { get; set; } = [];
+
+    /// <summary>
+    /// Share of the bandwidth for downloads started by hand, relative to background sync.
+    /// </summary>
+    [JsonPropertyName("bandwidth_interactive_weight")]
+    public int BandwidthInteractiveWeight { get; set; } = 3;
+
+    /// <summary>
+    /// Share of the bandwidth for background sync, relative to interactive downloads.
+    /// </summary>
+    [JsonPropertyName("bandwidth_background_weight")]
+    public int BandwidthBackgroundWeight { get; set; } = 1;
+
     /// <summary>
     /// Enable verbose logging output.
     /// </summary>
@@ -146,4 +170,31 @@ public class AppSettings
     public string TelemetryPath { get; set; } = Path.Combine(
         Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
         ".config", "Modular", "telemetry");
+
+    /// <summary>
+    /// Creates a deep copy, so the original can change without affecting it.
+    /// </summary>
+    public AppSettings Clone()
+    {
+        var copy = new AppSettings();
+        CopyTo(copy);
+        return copy;
+    }
+
+    /// <summary>
+    /// Overwrites every setting of <paramref name="target"/> with this one's,
+    /// keeping the target instance so code holding it sees the new values.
+    /// </summary>
+    public void CopyTo(AppSettings target)
+    {
+        foreach (var property in typeof(AppSettings).GetProperties())
+        {
+            var value = property.GetValue(this);
+            if (value is List<string> strings)
+                value = new List<string>(strings);
+            else if (value is List<int> ints)
+                value = new List<int>(ints);
+            property.SetValue(target, value);
+        }
+    }
 }
@@ -1,5 +1,11 @@
+using System.Reflection;
+using System.Text;
 using System.Text.Json;
+using System.Text.Json.Nodes;
+using System.Text.Json.Serialization;
+using Modular.Core.Authentication;
 using Modular.Core.Exceptions;
+using Modular.Core.RateLimiting;
 using Modular.Core.Utilities;
 
 namespace Modular.Core.Configuration;
@@ -15,6 +21,26 @@ public class ConfigurationService
         PropertyNamingPolicy = JsonNamingPolicy.SnakeCaseLower
     };
 
+    /// <summary>
+    /// Upper bound for max_concurrent_downloads; more only trips API rate limits.
+    /// </summary>
+    public const int MaxConcurrentDownloadsLimit = 16;
+
+    private readonly CredentialService? _credentials;
+
+    /// <summary>
+    /// Creates a configuration service.
+    /// </summary>
+    /// <param name="credentials">
+    /// When set, the NexusMods API key is kept in the encrypted credential store
+    /// instead of config.json: it is read from there when the file and environment
+    /// do not provide one, and moved there on save.
+    /// </param>
+    public ConfigurationService(CredentialService? credentials = null)
+    {
+        _credentials = credentials;
+    }
+
     /// <summary>
     /// Gets the default configuration file path.
     /// </summary>
@@ -43,6 +69,13 @@ public class ConfigurationService
         Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
         ".config", "Modular", "metadata_cache.json");
 
+    /// <summary>
+    /// Gets the default Steam library cache path.
+    /// </summary>
+    public static string DefaultSteamLibraryCachePath => Path.Combine(
+        Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+        ".config", "Modular", "steam_library_cache.json");
+
     /// <summary>
     /// Loads configuration from file and environment variables.
     /// Environment variables take precedence over file values.
@@ -74,6 +107,10 @@ public class ConfigurationService
         // Apply environment variable overrides
         ApplyEnvironmentOverrides(settings);
 
+        // Fall back to the credential store for the API key
+        if (string.IsNullOrWhiteSpace(settings.NexusApiKey) && _credentials != null)
+            settings.NexusApiKey = await _credentials.GetSecretAsync(CredentialService.NexusApiKeyName) ?? string.Empty;
+
         // Set default paths if not specified
         if (string.IsNullOrEmpty(settings.DatabasePath))
             settings.DatabasePath = DefaultDatabasePath;
@@ -108,8 +145,21 @@ public class ConfigurationService
             if (!string.IsNullOrEmpty(directory))
                 Directory.CreateDirectory(directory);
 
-            var json = JsonSerializer.Serialize(settings, JsonOptions);
-            await File.WriteAllTextAsync(path, json);
+            string json;
+            if (_credentials != null && !string.IsNullOrWhiteSpace(settings.NexusApiKey))
+            {
+                // Keep the key out of the plain-text config file
+                await _credentials.StoreSecretAsync(CredentialService.NexusApiKeyName, settings.NexusApiKey);
+                var node = JsonSerializer.SerializeToNode(settings, JsonOptions)!;
+                node["nexus_api_key"] = string.Empty;
+                json = node.ToJsonString(JsonOptions);
+            }
+            else
+            {
+                json = JsonSerializer.Serialize(settings, JsonOptions);
+            }
+
+            await WriteAtomicallyAsync(path, json);
         }
         catch (IOException ex)
         {
@@ -150,6 +200,98 @@ public class ConfigurationService
         }
     }
 
+    /// <summary>
+    /// Checks settings against the config schema: value ranges, formats and
+    /// required fields. Unlike <see cref="Validate"/>, which checks what a
+    /// command needs, this checks what any valid config must satisfy.
+    /// </summary>
+    /// <returns>One message per problem, prefixed with the offending key; empty if valid.</returns>
+    public static IReadOnlyList<string> GetSchemaErrors(AppSettings settings)
+    {
+        var errors = new List<string>();
+
+        if (settings.MaxConcurrentDownloads is < 1 or > MaxConcurrentDownloadsLimit)
+            errors.Add($"max_concurrent_downloads: must be between 1 and {MaxConcurrentDownloadsLimit}, got {settings.MaxConcurrentDownloads}");
+
+        if (settings.BandwidthLimitKbps < 0)
+            errors.Add($"bandwidth_limit_kbps: must be 0 (unlimited) or positive, got {settings.BandwidthLimitKbps}");
+
+        if (settings.BandwidthInteractiveWeight < 1 || settings.BandwidthBackgroundWeight < 1)
+            errors.Add("bandwidth_interactive_weight, bandwidth_background_weight: must be at least 1");
+
+        try
+        {
+            BandwidthSchedule.Parse(settings.BandwidthSchedule);
+        }
+        catch (FormatException ex)
+        {
+            errors.Add($"bandwidth_schedule: {ex.Message}");
+        }
+
+        if (settings.NexusApiKey.Any(char.IsWhiteSpace))
+            errors.Add("nexus_api_key: must not contain whitespace");
+
+        if (string.IsNullOrWhiteSpace(settings.ModsDirectory))
+            errors.Add("mods_directory: must not be empty");
+
+        if (settings.GameBananaGameIds.Any(id => id <= 0))
+            errors.Add("gamebanana_game_ids: IDs must be positive");
+
+        if (settings.DefaultCategories.Any(string.IsNullOrWhiteSpace))
+            errors.Add("default_categories: categories must not be empty");
+
+        if (settings.EnabledBackends.Any(string.IsNullOrWhiteSpace))
+            errors.Add("enabled_backends: backend IDs must not be empty");
+
+        if (!string.IsNullOrEmpty(settings.PluginMarketplaceUrl) &&
+            !(Uri.TryCreate(settings.PluginMarketplaceUrl, UriKind.Absolute, out var uri) &&
+              (uri.Scheme == Uri.UriSchemeHttp || uri.Scheme == Uri.UriSchemeHttps)))
+            errors.Add("plugin_marketplace_url: must be an http(s) URL");
+
+        return errors;
+    }
+
+    /// <summary>
+    /// Keys in a config file that no setting reads, usually typos. Their
+    /// values are silently ignored, so they are worth a warning.
+    /// </summary>
+    public static IReadOnlyList<string> GetUnknownKeys(string json)
+    {
+        if (JsonNode.Parse(json) is not JsonObject root)
+            return [];
+
+        var known = typeof(AppSettings).GetProperties()
+            .Select(p => p.GetCustomAttribute<JsonPropertyNameAttribute>()?.Name)
+            .OfType<string>()
+            .ToHashSet(StringComparer.Ordinal);
+
+        return root.Select(kv => kv.Key).Where(key => !known.Contains(key)).ToList();
+    }
+
+    /// <summary>
+    /// Replaces <paramref name="path"/> so readers see either the old or the
+    /// new file, never a partial one: write a temp file beside it, fsync, rename.
+    /// </summary>
+    private static async Task WriteAtomicallyAsync(string path, string contents)
+    {
+        var tempPath = $"{path}.{Environment.ProcessId}.{Guid.NewGuid():N}.tmp";
+        try
+        {
+            await using (var stream = new FileStream(tempPath, FileMode.CreateNew, FileAccess.Write, FileShare.None))
+            {
+                await stream.WriteAsync(Encoding.UTF8.GetBytes(contents));
+                stream.Flush(flushToDisk: true);
+            }
+
+            File.Move(tempPath, path, overwrite: true);
+        }
+        finally
+        {
+            if (File.Exists(tempPath))
+                File.Delete(tempPath);
+        }
+    }
+
     private static void ApplyEnvironmentOverrides(AppSettings settings)
     {
         // NEXUS_API_KEY or API_KEY
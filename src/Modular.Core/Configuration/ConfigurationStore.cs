@@ -0,0 +1,369 @@
+using System.Reflection;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Exceptions;
+
+namespace Modular.Core.Configuration;
+
+/// <summary>
+/// Holds the application configuration for the lifetime of the process and
+/// keeps it in step with config.json. Saves are validated and written
+/// atomically; edits made to the file by other processes or by hand are picked
+/// up through a file watcher, validated the same way, and published as
+/// <see cref="Changed"/> events so running services can adjust.
+/// </summary>
+public sealed class ConfigurationStore : IDisposable
+{
+    private static readonly PropertyInfo[] Properties = typeof(AppSettings).GetProperties();
+    private static readonly JsonSerializerOptions CompareOptions = new();
+
+    private readonly ConfigurationService _service;
+    private readonly ILogger<ConfigurationStore>? _logger;
+    private readonly SemaphoreSlim _writeLock = new(1, 1);
+    private readonly TimeSpan _debounce;
+    private AppSettings _current = new();
+    private long _version;
+    private FileSystemWatcher? _watcher;
+    private Timer? _debounceTimer;
+    private bool _disposed;
+
+    /// <summary>
+    /// Creates a configuration store.
+    /// </summary>
+    /// <param name="service">Reads and writes the config file</param>
+    /// <param name="path">Path to config file (defaults to ~/.config/Modular/config.json)</param>
+    /// <param name="logger">Optional logger</param>
+    /// <param name="debounce">
+    /// How long the file must stay quiet before it is reloaded; editors often
+    /// write a file in several steps.
+    /// </param>
+    public ConfigurationStore(
+        ConfigurationService service,
+        string? path = null,
+        ILogger<ConfigurationStore>? logger = null,
+        TimeSpan? debounce = null)
+    {
+        _service = service;
+        Path = path ?? ConfigurationService.DefaultConfigPath;
+        _logger = logger;
+        _debounce = debounce ?? TimeSpan.FromMilliseconds(100);
+    }
+
+    /// <summary>
+    /// Path of the config file.
+    /// </summary>
+    public string Path { get; }
+
+    /// <summary>
+    /// The live settings instance. It is updated in place on every change, so
+    /// services holding it see new values on their next read. Use
+    /// <see cref="Current"/> when several values must be read consistently.
+    /// </summary>
+    public AppSettings Settings { get; } = new();
+
+    /// <summary>
+    /// An immutable snapshot of the current settings. Every change replaces
+    /// the snapshot as a whole, so readers never see half of an update. Do not
+    /// modify it; use <see cref="AppSettings.Clone"/> and <see cref="SaveAsync"/>.
+    /// </summary>
+    public AppSettings Current => Volatile.Read(ref _current);
+
+    /// <summary>
+    /// Incremented on every applied change.
+    /// </summary>
+    public long Version => Interlocked.Read(ref _version);
+
+    /// <summary>
+    /// Raised after a change has been applied, on the thread that applied it.
+    /// </summary>
+    public event EventHandler<ConfigurationChangedEventArgs>? Changed;
+
+    /// <summary>
+    /// Raised when the config file changed but could not be loaded. The
+    /// previous settings stay in effect.
+    /// </summary>
+    public event EventHandler<ConfigurationReloadFailedEventArgs>? ReloadFailed;
+
+    /// <summary>
+    /// Loads the config file for the first time. Schema problems are logged
+    /// rather than thrown so an existing config cannot stop the app from
+    /// starting; later reloads and saves reject them.
+    /// </summary>
+    /// <exception cref="ConfigException">The file is not valid JSON.</exception>
+    public async Task<AppSettings> LoadAsync()
+    {
+        await _writeLock.WaitAsync();
+        try
+        {
+            var settings = await _service.LoadAsync(Path);
+            foreach (var error in ConfigurationService.GetSchemaErrors(settings))
+                _logger?.LogWarning("Invalid setting in {Path}: {Error}", Path, error);
+            WarnUnknownKeys();
+
+            settings.CopyTo(Settings);
+            Volatile.Write(ref _current, settings);
+            Interlocked.Increment(ref _version);
+            return Settings;
+        }
+        finally
+        {
+            _writeLock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Validates <paramref name="settings"/>, writes them to the config file and
+    /// applies them. The store keeps its own copy, so the caller may go on
+    /// editing the instance it passed.
+    /// </summary>
+    /// <exception cref="ConfigException">A setting is invalid; nothing was written.</exception>
+    public async Task SaveAsync(AppSettings settings)
+    {
+        var errors = ConfigurationService.GetSchemaErrors(settings);
+        if (errors.Count > 0)
+            throw new ConfigException(string.Join("; ", errors), errors[0].Split(':')[0]);
+
+        var snapshot = settings.Clone();
+        ConfigurationChangedEventArgs? change;
+
+        await _writeLock.WaitAsync();
+        try
+        {
+            await _service.SaveAsync(snapshot, Path);
+            change = Apply(snapshot);
+        }
+        finally
+        {
+            _writeLock.Release();
+        }
+
+        Raise(change);
+    }
+
+    /// <summary>
+    /// Re-reads the config file and applies it if it is valid.
+    /// </summary>
+    /// <returns>False if the file could not be loaded and the previous settings were kept.</returns>
+    public async Task<bool> ReloadAsync()
+    {
+        ConfigurationChangedEventArgs? change;
+
+        await _writeLock.WaitAsync();
+        try
+        {
+            AppSettings settings;
+            try
+            {
+                settings = await _service.LoadAsync(Path);
+
+                var errors = ConfigurationService.GetSchemaErrors(settings);
+                if (errors.Count > 0)
+                    throw new ConfigException(string.Join("; ", errors), errors[0].Split(':')[0]);
+            }
+            catch (Exception ex) when (ex is ConfigException or IOException or UnauthorizedAccessException)
+            {
+                _logger?.LogWarning("Ignoring invalid config change in {Path}: {Message}", Path, ex.Message);
+                ReloadFailed?.Invoke(this, new ConfigurationReloadFailedEventArgs(ex));
+                return false;
+            }
+
+            WarnUnknownKeys();
+            change = Apply(settings);
+        }
+        finally
+        {
+            _writeLock.Release();
+        }
+
+        Raise(change);
+        return true;
+    }
+
+    /// <summary>
+    /// Starts reloading the settings whenever the config file changes on disk.
+    /// </summary>
+    public void StartWatching()
+    {
+        if (_watcher != null)
+            return;
+
+        var directory = System.IO.Path.GetDirectoryName(System.IO.Path.GetFullPath(Path))!;
+        Directory.CreateDirectory(directory);
+
+        _debounceTimer = new Timer(_ => _ = ReloadFromWatcherAsync(), null, Timeout.Infinite, Timeout.Infinite);
+
+        // Watch the directory rather than the file: atomic saves replace the
+        // file by renaming a temp file over it
+        _watcher = new FileSystemWatcher(directory, System.IO.Path.GetFileName(Path))
+        {
+            NotifyFilter = NotifyFilters.FileName | NotifyFilters.LastWrite | NotifyFilters.Size | NotifyFilters.CreationTime
+        };
+        _watcher.Changed += OnFileEvent;
+        _watcher.Created += OnFileEvent;
+        _watcher.Renamed += OnFileEvent;
+        _watcher.EnableRaisingEvents = true;
+
+        _logger?.LogDebug("Watching {Path} for changes", Path);
+    }
+
+    /// <summary>
+    /// Calls <paramref name="onChanged"/> with the new value whenever the value
+    /// picked by <paramref name="selector"/> changes. Values are compared with
+    /// <see cref="EqualityComparer{T}.Default"/>, so select scalars rather than lists.
+    /// </summary>
+    /// <returns>Dispose to unsubscribe.</returns>
+    public IDisposable Subscribe<T>(Func<AppSettings, T> selector, Action<T> onChanged)
+    {
+        EventHandler<ConfigurationChangedEventArgs> handler = (_, e) =>
+        {
+            var value = selector(e.Current);
+            if (!EqualityComparer<T>.Default.Equals(selector(e.Previous), value))
+                onChanged(value);
+        };
+
+        Changed += handler;
+        return new Subscription(() => Changed -= handler);
+    }
+
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+        _disposed = true;
+
+        _watcher?.Dispose();
+        _debounceTimer?.Dispose();
+    }
+
+    private void OnFileEvent(object sender, FileSystemEventArgs e)
+    {
+        if (e is RenamedEventArgs && !string.Equals(e.FullPath, System.IO.Path.GetFullPath(Path), StringComparison.Ordinal))
+            return;
+
+        try
+        {
+            _debounceTimer?.Change(_debounce, Timeout.InfiniteTimeSpan);
+        }
+        catch (ObjectDisposedException)
+        {
+            // Disposed while the watcher was delivering an event
+        }
+    }
+
+    private async Task ReloadFromWatcherAsync()
+    {
+        if (_disposed)
+            return;
+
+        try
+        {
+            await ReloadAsync();
+        }
+        catch (Exception ex)
+        {
+            _logger?.LogError(ex, "Failed to reload {Path}", Path);
+        }
+    }
+
+    // Called under _writeLock
+    private ConfigurationChangedEventArgs? Apply(AppSettings settings)
+    {
+        var previous = Current;
+        var changedKeys = GetChangedKeys(previous, settings);
+        if (changedKeys.Count == 0)
+            return null;
+
+        settings.CopyTo(Settings);
+        Volatile.Write(ref _current, settings);
+        var version = Interlocked.Increment(ref _version);
+
+        _logger?.LogInformation("Configuration changed: {Keys}", string.Join(", ", changedKeys));
+        return new ConfigurationChangedEventArgs(previous, settings, changedKeys, version);
+    }
+
+    // Raised outside _writeLock so handlers may save settings themselves
+    private void Raise(ConfigurationChangedEventArgs? change)
+    {
+        if (change != null)
+            Changed?.Invoke(this, change);
+    }
+
+    private void WarnUnknownKeys()
+    {
+        if (_logger == null || !File.Exists(Path))
+            return;
+
+        try
+        {
+            foreach (var key in ConfigurationService.GetUnknownKeys(File.ReadAllText(Path)))
+                _logger.LogWarning("Unknown setting '{Key}' in {Path} is ignored", key, Path);
+        }
+        catch (Exception ex) when (ex is IOException or JsonException)
+        {
+            // The file changed again since it was loaded; the next reload will check it
+        }
+    }
+
+    private static IReadOnlyList<string> GetChangedKeys(AppSettings previous, AppSettings current)
+    {
+        var keys = new List<string>();
+        foreach (var property in Properties)
+        {
+            var before = JsonSerializer.Serialize(property.GetValue(previous), CompareOptions);
+            var after = JsonSerializer.Serialize(property.GetValue(current), CompareOptions);
+            if (before != after)
+                keys.Add(property.GetCustomAttribute<JsonPropertyNameAttribute>()?.Name ?? property.Name);
+        }
+
+        return keys;
+    }
+
+    private sealed class Subscription : IDisposable
+    {
+        private Action? _unsubscribe;
+
+        public Subscription(Action unsubscribe) => _unsubscribe = unsubscribe;
+
+        public void Dispose() => Interlocked.Exchange(ref _unsubscribe, null)?.Invoke();
+    }
+}
+
+/// <summary>
+/// Describes an applied configuration change.
+/// </summary>
+public sealed class ConfigurationChangedEventArgs : EventArgs
+{
+    public ConfigurationChangedEventArgs(AppSettings previous, AppSettings current, IReadOnlyList<string> changedKeys, long version)
+    {
+        Previous = previous;
+        Current = current;
+        ChangedKeys = changedKeys;
+        Version = version;
+    }
+
+    public AppSettings Previous { get; }
+    public AppSettings Current { get; }
+
+    /// <summary>
+    /// Config file keys whose values changed, e.g. "max_concurrent_downloads".
+    /// </summary>
+    public IReadOnlyList<string> ChangedKeys { get; }
+
+    public long Version { get; }
+
+    public bool HasChanged(string key) => ChangedKeys.Contains(key, StringComparer.Ordinal);
+}
+
+/// <summary>
+/// Describes a config file change that was rejected.
+/// </summary>
+public sealed class ConfigurationReloadFailedEventArgs : EventArgs
+{
+    public ConfigurationReloadFailedEventArgs(Exception error)
+    {
+        Error = error;
+    }
+
+    public Exception Error { get; }
+}
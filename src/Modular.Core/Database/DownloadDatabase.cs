@@ -147,6 +147,17 @@ public class DownloadDatabase
         }
     }
 
+    /// <summary>
+    /// Gets a snapshot of all download records.
+    /// </summary>
+    public IReadOnlyList<DownloadRecord> GetAllRecords()
+    {
+        lock (_lock)
+        {
+            return _records.ToList();
+        }
+    }
+
     /// <summary>
     /// Gets total number of records in the database.
     /// </summary>
@@ -57,6 +57,33 @@ public class MetadataCacheData
 
     [JsonPropertyName("game_categories")]
     public Dictionary<string, GameCategoryCache> GameCategories { get; set; } = [];
+
+    /// <summary>
+    /// Tracked-mod sync state per game domain.
+    /// </summary>
+    [JsonPropertyName("tracked_sync")]
+    public Dictionary<string, TrackedModSyncState> TrackedSync { get; set; } = [];
+}
+
+/// <summary>
+/// When each tracked mod's file list was last confirmed current, so a re-sync
+/// only needs to list files for mods that changed since.
+/// </summary>
+public class TrackedModSyncState
+{
+    /// <summary>
+    /// Fingerprint of the file filter the state was built with; a different
+    /// filter selects different files and invalidates everything.
+    /// </summary>
+    [JsonPropertyName("filter_key")]
+    public string FilterKey { get; set; } = string.Empty;
+
+    /// <summary>
+    /// Mod ID to the Unix time its files were last fully synced. Mods whose
+    /// last sync left files behind have no entry.
+    /// </summary>
+    [JsonPropertyName("synced_at")]
+    public Dictionary<int, long> SyncedAt { get; set; } = [];
 }
 
 /// <summary>
@@ -200,6 +227,40 @@ public class ModMetadataCache
         }
     }
 
+    /// <summary>
+    /// Gets a copy of the tracked-mod sync state for a game domain.
+    /// </summary>
+    /// <param name="gameDomain">Game domain</param>
+    /// <returns>Sync state, or null if the domain was never synced</returns>
+    public TrackedModSyncState? GetTrackedSyncState(string gameDomain)
+    {
+        lock (_lock)
+        {
+            if (_data.TrackedSync.TryGetValue(gameDomain, out var state))
+            {
+                return new TrackedModSyncState
+                {
+                    FilterKey = state.FilterKey,
+                    SyncedAt = new Dictionary<int, long>(state.SyncedAt)
+                };
+            }
+            return null;
+        }
+    }
+
+    /// <summary>
+    /// Stores the tracked-mod sync state for a game domain.
+    /// </summary>
+    /// <param name="gameDomain">Game domain</param>
+    /// <param name="state">Sync state to store</param>
+    public void SetTrackedSyncState(string gameDomain, TrackedModSyncState state)
+    {
+        lock (_lock)
+        {
+            _data.TrackedSync[gameDomain] = state;
+        }
+    }
+
     /// <summary>
     /// Gets the number of cached mods for a game domain.
     /// </summary>
@@ -230,6 +291,30 @@ public class ModMetadataCache
         }
     }
 
+    /// <summary>
+    /// Gets a snapshot of all cached mod metadata with its game domain (legacy format).
+    /// </summary>
+    public IReadOnlyList<(string GameDomain, ModMetadata Metadata)> GetAllModMetadata()
+    {
+        lock (_lock)
+        {
+            return _data.Mods
+                .SelectMany(domain => domain.Value.Values.Select(m => (domain.Key, m)))
+                .ToList();
+        }
+    }
+
+    /// <summary>
+    /// Gets a snapshot of all cached canonical mods.
+    /// </summary>
+    public IReadOnlyList<CanonicalMod> GetAllCanonicalMods()
+    {
+        lock (_lock)
+        {
+            return _data.CanonicalMods.Values.Select(e => e.Mod).ToList();
+        }
+    }
+
     /// <summary>
     /// Saves the cache to disk.
     /// </summary>
@@ -248,6 +333,9 @@ public class ModMetadataCache
                     kvp => kvp.Key,
                     kvp => kvp.Value),
                 GameCategories = _data.GameCategories.ToDictionary(
+                    kvp => kvp.Key,
+                    kvp => kvp.Value),
+                TrackedSync = _data.TrackedSync.ToDictionary(
                     kvp => kvp.Key,
                     kvp => kvp.Value)
             };
@@ -313,6 +401,7 @@ public class ModMetadataCache
         {
             _data.Mods.Remove(gameDomain);
             _data.GameCategories.Remove(gameDomain);
+            _data.TrackedSync.Remove(gameDomain);
         }
     }
 
@@ -8,7 +8,7 @@ namespace Modular.Core.Database;
 /// </summary>
 public sealed class ModularDatabase : IAsyncDisposable, IDisposable
 {
-    private const int CurrentSchemaVersion = 4;
+    private const int CurrentSchemaVersion = 9;
 
     private readonly string _connectionString;
     private SqliteConnection? _connection;
@@ -24,9 +24,15 @@ public sealed class ModularDatabase : IAsyncDisposable, IDisposable
         if (!string.IsNullOrEmpty(directory))
             Directory.CreateDirectory(directory);
 
+        DatabasePath = dbPath;
         _connectionString = $"Data Source={dbPath};Mode=ReadWriteCreate;Cache=Shared";
     }
 
+    /// <summary>
+    /// Path of the database file.
+    /// </summary>
+    public string DatabasePath { get; }
+
     /// <summary>
     /// Gets an open connection to the database.
     /// </summary>
@@ -187,6 +193,11 @@ public sealed class ModularDatabase : IAsyncDisposable, IDisposable
             // Also create v2+ tables for fresh installs
             await CreateV2TablesAsync(connection, (SqliteTransaction)transaction);
             await CreateV4TablesAsync(connection, (SqliteTransaction)transaction);
+            await CreateV5TablesAsync(connection, (SqliteTransaction)transaction);
+            await CreateV6TablesAsync(connection, (SqliteTransaction)transaction);
+            await CreateV7TablesAsync(connection, (SqliteTransaction)transaction);
+            await CreateV8TablesAsync(connection, (SqliteTransaction)transaction);
+            await MigrateToV9Async(connection, (SqliteTransaction)transaction);
 
             await SetSchemaVersionAsync(connection, CurrentSchemaVersion);
             await transaction.CommitAsync();
@@ -221,6 +232,31 @@ public sealed class ModularDatabase : IAsyncDisposable, IDisposable
                 await CreateV4TablesAsync(connection, (SqliteTransaction)transaction);
             }
 
+            if (fromVersion < 5)
+            {
+                await CreateV5TablesAsync(connection, (SqliteTransaction)transaction);
+            }
+
+            if (fromVersion < 6)
+            {
+                await CreateV6TablesAsync(connection, (SqliteTransaction)transaction);
+            }
+
+            if (fromVersion < 7)
+            {
+                await CreateV7TablesAsync(connection, (SqliteTransaction)transaction);
+            }
+
+            if (fromVersion < 8)
+            {
+                await CreateV8TablesAsync(connection, (SqliteTransaction)transaction);
+            }
+
+            if (fromVersion < 9)
+            {
+                await MigrateToV9Async(connection, (SqliteTransaction)transaction);
+            }
+
             await SetSchemaVersionAsync(connection, CurrentSchemaVersion);
             await transaction.CommitAsync();
         }
@@ -394,6 +430,133 @@ public sealed class ModularDatabase : IAsyncDisposable, IDisposable
         }
     }
 
+    private static async Task CreateV5TablesAsync(SqliteConnection connection, SqliteTransaction transaction)
+    {
+        // Archive integrity results — keyed by path, reused while (size, mtime, inode) is unchanged
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = """
+                CREATE TABLE IF NOT EXISTS archive_integrity (
+                    path TEXT PRIMARY KEY NOT NULL,
+                    size_bytes INTEGER NOT NULL,
+                    mtime_ns INTEGER NOT NULL,
+                    inode INTEGER NOT NULL DEFAULT 0,
+                    device INTEGER NOT NULL DEFAULT 0,
+                    format TEXT NOT NULL,
+                    status TEXT NOT NULL,
+                    detail TEXT,
+                    entry_count INTEGER NOT NULL DEFAULT 0,
+                    deep INTEGER NOT NULL DEFAULT 0,
+                    expected_checksum TEXT,
+                    checksum_verified INTEGER NOT NULL DEFAULT 0,
+                    checked_at_utc TEXT NOT NULL
+                );
+                CREATE INDEX IF NOT EXISTS idx_archive_integrity_status ON archive_integrity(status);
+                """;
+            await cmd.ExecuteNonQueryAsync();
+        }
+    }
+
+    private static async Task CreateV6TablesAsync(SqliteConnection connection, SqliteTransaction transaction)
+    {
+        // Update checking — mods we have or track, the latest remote update seen
+        // for each, and how far back each feed has been polled
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = """
+                CREATE TABLE IF NOT EXISTS watched_mod (
+                    backend TEXT NOT NULL,
+                    game_domain TEXT NOT NULL,
+                    mod_id TEXT NOT NULL,
+                    name TEXT NOT NULL,
+                    sources INTEGER NOT NULL,
+                    baseline_at INTEGER NOT NULL,
+                    seen_at INTEGER NOT NULL,
+                    PRIMARY KEY (backend, game_domain, mod_id)
+                );
+                CREATE TABLE IF NOT EXISTS mod_update (
+                    backend TEXT NOT NULL,
+                    game_domain TEXT NOT NULL,
+                    mod_id TEXT NOT NULL,
+                    updated_at INTEGER NOT NULL,
+                    PRIMARY KEY (backend, game_domain, mod_id)
+                );
+                CREATE INDEX IF NOT EXISTS idx_mod_update_updated ON mod_update(updated_at);
+                CREATE TABLE IF NOT EXISTS update_watermark (
+                    backend TEXT NOT NULL,
+                    game_domain TEXT NOT NULL,
+                    polled_at INTEGER NOT NULL,
+                    PRIMARY KEY (backend, game_domain)
+                );
+                """;
+            await cmd.ExecuteNonQueryAsync();
+        }
+    }
+
+    private static async Task CreateV7TablesAsync(SqliteConnection connection, SqliteTransaction transaction)
+    {
+        // Download library index — one row per archive with what was learned
+        // from opening it, valid while size and mtime are unchanged
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = """
+                CREATE TABLE IF NOT EXISTS library_archive (
+                    path TEXT PRIMARY KEY NOT NULL,
+                    size_bytes INTEGER NOT NULL,
+                    mtime_ticks INTEGER NOT NULL,
+                    game_domain TEXT,
+                    installer_id TEXT,
+                    inspected_at_utc TEXT NOT NULL
+                );
+                """;
+            await cmd.ExecuteNonQueryAsync();
+        }
+    }
+
+    private static async Task CreateV8TablesAsync(SqliteConnection connection, SqliteTransaction transaction)
+    {
+        // Mod identity — every store's record of a mod, labelled with the
+        // identity it was linked into; the label is the root of a union-find
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = """
+                CREATE TABLE IF NOT EXISTS identity_record (
+                    record_key TEXT PRIMARY KEY NOT NULL,
+                    source TEXT NOT NULL,
+                    identity TEXT NOT NULL,
+                    backend TEXT,
+                    game_domain TEXT,
+                    mod_id TEXT,
+                    file_id TEXT,
+                    name TEXT,
+                    author TEXT,
+                    archive_path TEXT,
+                    archive_hash TEXT,
+                    uploaded_at INTEGER
+                );
+                CREATE INDEX IF NOT EXISTS idx_identity_record_identity ON identity_record(identity, source, uploaded_at);
+                CREATE INDEX IF NOT EXISTS idx_identity_record_path ON identity_record(archive_path, source);
+                CREATE INDEX IF NOT EXISTS idx_identity_record_hash ON identity_record(archive_hash);
+                CREATE INDEX IF NOT EXISTS idx_identity_record_mod ON identity_record(backend, game_domain, mod_id);
+                """;
+            await cmd.ExecuteNonQueryAsync();
+        }
+    }
+
+    private static async Task MigrateToV9Async(SqliteConnection connection, SqliteTransaction transaction)
+    {
+        // Snapshot state root — hash of the game directory's Merkle tree in the
+        // DirectoryStateStore, null for snapshots taken without one
+        await using var cmd = connection.CreateCommand();
+        cmd.Transaction = transaction;
+        cmd.CommandText = "ALTER TABLE snapshot ADD COLUMN state_root TEXT;";
+        await cmd.ExecuteNonQueryAsync();
+    }
+
     public async ValueTask DisposeAsync()
     {
         if (_disposed) return;
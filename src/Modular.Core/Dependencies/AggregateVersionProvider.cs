@@ -80,6 +80,36 @@ public class AggregateVersionProvider : IModVersionProvider
         return new List<ModDependency>();
     }
 
+    public Task PrefetchAsync(IReadOnlyCollection<string> canonicalIds, CancellationToken ct = default)
+    {
+        // IDs without a known prefix aren't prefetched; they fall back to trying every provider
+        var byProvider = canonicalIds
+            .Select(id => (Id: id, Provider: ResolveProvider(id)))
+            .Where(x => x.Provider != null)
+            .GroupBy(x => x.Provider!, x => x.Id);
+
+        return Task.WhenAll(byProvider.Select(g => g.Key.PrefetchAsync(g.ToList(), ct)));
+    }
+
+    public async Task<Dictionary<string, string>> GetDataVersionsAsync(
+        IReadOnlyCollection<string> canonicalIds,
+        CancellationToken ct = default)
+    {
+        var byProvider = canonicalIds
+            .Select(id => (Id: id, Provider: ResolveProvider(id)))
+            .Where(x => x.Provider != null)
+            .GroupBy(x => x.Provider!, x => x.Id);
+
+        var merged = new Dictionary<string, string>();
+        foreach (var versions in await Task.WhenAll(byProvider.Select(g => g.Key.GetDataVersionsAsync(g.ToList(), ct))))
+        {
+            foreach (var (id, version) in versions)
+                merged[id] = version;
+        }
+
+        return merged;
+    }
+
     private IModVersionProvider? ResolveProvider(string canonicalId)
     {
         var colonIndex = canonicalId.IndexOf(':');
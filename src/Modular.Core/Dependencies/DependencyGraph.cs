@@ -10,6 +10,7 @@ public class DependencyGraph
 {
     private readonly Dictionary<string, ModNode> _nodes = new();
     private readonly List<DependencyEdge> _edges = new();
+    private readonly Dictionary<string, List<DependencyEdge>> _outgoing = new();
     private readonly object _lock = new();
 
     /// <summary>
@@ -59,6 +60,11 @@ public class DependencyGraph
                 AddNode(edge.To);
 
             _edges.Add(edge);
+
+            var fromId = edge.From.GetNodeId();
+            if (!_outgoing.TryGetValue(fromId, out var outgoing))
+                _outgoing[fromId] = outgoing = new List<DependencyEdge>();
+            outgoing.Add(edge);
         }
     }
 
@@ -69,8 +75,7 @@ public class DependencyGraph
     {
         lock (_lock)
         {
-            var nodeId = node.GetNodeId();
-            return _edges.Where(e => e.From.GetNodeId() == nodeId).ToList();
+            return Outgoing(node.GetNodeId()).ToList();
         }
     }
 
@@ -109,8 +114,7 @@ public class DependencyGraph
         recursionStack.Add(nodeId);
         path.Push(nodeId);
 
-        var outgoingEdges = _edges.Where(e => e.From.GetNodeId() == nodeId);
-        foreach (var edge in outgoingEdges)
+        foreach (var edge in Outgoing(nodeId))
         {
             var targetId = edge.To.GetNodeId();
 
@@ -182,8 +186,7 @@ public class DependencyGraph
 
         temporaryMarks.Add(nodeId);
 
-        var dependencies = _edges.Where(e => e.From.GetNodeId() == nodeId);
-        foreach (var edge in dependencies)
+        foreach (var edge in Outgoing(nodeId))
         {
             if (!TopologicalSortVisit(edge.To, visited, temporaryMarks, sorted))
                 return false;
@@ -205,7 +208,11 @@ public class DependencyGraph
         {
             _nodes.Clear();
             _edges.Clear();
+            _outgoing.Clear();
         }
     }
 
+    private IReadOnlyList<DependencyEdge> Outgoing(string nodeId) =>
+        _outgoing.TryGetValue(nodeId, out var edges) ? edges : [];
+
 }
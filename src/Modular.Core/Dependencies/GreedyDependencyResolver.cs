@@ -22,14 +22,21 @@ namespace Modular.Core.Dependencies;
 public class GreedyDependencyResolver
 {
     private readonly IModVersionProvider _versionProvider;
+    private readonly ResolutionCache? _cache;
     private readonly ILogger<GreedyDependencyResolver>? _logger;
 
+    /// <param name="cache">
+    /// Results of earlier runs over the same profile. With it, only mods whose
+    /// provider data or constraints changed are looked up and re-selected.
+    /// </param>
     public GreedyDependencyResolver(
         IModVersionProvider versionProvider,
-        ILogger<GreedyDependencyResolver>? logger = null)
+        ILogger<GreedyDependencyResolver>? logger = null,
+        ResolutionCache? cache = null)
     {
         _versionProvider = versionProvider;
         _logger = logger;
+        _cache = cache;
     }
 
     /// <summary>
@@ -38,6 +45,21 @@ public class GreedyDependencyResolver
     public async Task<ResolutionResult> ResolveAsync(
         List<(string canonicalId, VersionRange? constraint)> rootRequirements,
         CancellationToken ct = default)
+    {
+        if (_cache == null)
+            return await ResolveCoreAsync(rootRequirements, ct);
+
+        await _cache.BeginAsync(_versionProvider, rootRequirements.Select(r => r.canonicalId), ct);
+        var result = await ResolveCoreAsync(rootRequirements, ct);
+        result.Fingerprint = _cache.Complete(rootRequirements);
+
+        _logger?.LogDebug("Re-resolved {Count} mod(s), reused the rest", result.ReResolvedMods.Count);
+        return result;
+    }
+
+    private async Task<ResolutionResult> ResolveCoreAsync(
+        List<(string canonicalId, VersionRange? constraint)> rootRequirements,
+        CancellationToken ct)
     {
         var result = new ResolutionResult();
         var graph = new DependencyGraph();
@@ -65,6 +87,7 @@ public class GreedyDependencyResolver
             // Iteratively select versions and propagate constraints
             var unresolved = new Queue<string>(constraints.Keys);
             var visited = new HashSet<string>();
+            var prefetched = new HashSet<string>();
 
             while (unresolved.Count > 0)
             {
@@ -76,8 +99,25 @@ public class GreedyDependencyResolver
 
                 visited.Add(modId);
 
+                // Reaching a mod not yet prefetched means the previous level is done;
+                // hand the provider the whole next level at once
+                if (!prefetched.Contains(modId))
+                {
+                    var level = unresolved.Where(id => !visited.Contains(id)).Prepend(modId)
+                        .Where(prefetched.Add)
+                        .Where(id => _cache?.Contains(id) != true)
+                        .ToList();
+
+                    if (level.Count > 0)
+                    {
+                        if (_cache != null)
+                            await _cache.RecordDataVersionsAsync(_versionProvider, level, ct);
+                        await _versionProvider.PrefetchAsync(level, ct);
+                    }
+                }
+
                 // Get available versions
-                var availableVersions = await _versionProvider.GetAvailableVersionsAsync(modId, ct);
+                var availableVersions = await GetAvailableVersionsAsync(modId, ct);
                 if (availableVersions.Count == 0)
                 {
                     result.Conflicts.Add(new ResolutionConflict
@@ -93,7 +133,18 @@ public class GreedyDependencyResolver
 
                 // Find a version satisfying all constraints
                 var modConstraints = constraints[modId];
-                var selectedVersion = SelectVersion(availableVersions, modConstraints);
+                var constraintKey = string.Join("\n", modConstraints.Select(c => c.Constraint?.ToString()));
+                SemanticVersion? selectedVersion;
+                if (_cache == null || !_cache.TryGetSelection(modId, constraintKey, out var reused))
+                {
+                    selectedVersion = SelectVersion(availableVersions, modConstraints);
+                    result.ReResolvedMods.Add(modId);
+                    _cache?.StoreSelection(modId, constraintKey, selectedVersion);
+                }
+                else
+                {
+                    selectedVersion = reused;
+                }
 
                 if (selectedVersion == null)
                 {
@@ -118,7 +169,7 @@ public class GreedyDependencyResolver
                 graph.AddNode(node);
 
                 // Get dependencies for selected version
-                var dependencies = await _versionProvider.GetDependenciesAsync(modId, selectedVersion, ct);
+                var dependencies = await GetDependenciesAsync(modId, selectedVersion, ct);
 
                 // Propagate constraints from dependencies
                 foreach (var dep in dependencies)
@@ -215,6 +266,26 @@ public class GreedyDependencyResolver
         return result;
     }
 
+    private async Task<List<SemanticVersion>> GetAvailableVersionsAsync(string modId, CancellationToken ct)
+    {
+        if (_cache != null && _cache.TryGetVersions(modId, out var cached))
+            return cached;
+
+        var versions = await _versionProvider.GetAvailableVersionsAsync(modId, ct);
+        _cache?.StoreVersions(modId, versions);
+        return versions;
+    }
+
+    private async Task<List<ModDependency>> GetDependenciesAsync(string modId, SemanticVersion version, CancellationToken ct)
+    {
+        if (_cache != null && _cache.TryGetDependencies(modId, version, out var cached))
+            return cached;
+
+        var dependencies = await _versionProvider.GetDependenciesAsync(modId, version, ct);
+        _cache?.StoreDependencies(modId, version, dependencies);
+        return dependencies;
+    }
+
     /// <summary>
     /// Selects a version that satisfies all constraints (prefers latest).
     /// </summary>
@@ -319,4 +390,20 @@ public interface IModVersionProvider
         string canonicalId,
         SemanticVersion version,
         CancellationToken ct = default);
+
+    /// <summary>
+    /// Hints that versions and dependencies of these mods will be asked for
+    /// next, so a provider that can batch lookups may fetch them together.
+    /// </summary>
+    Task PrefetchAsync(IReadOnlyCollection<string> canonicalIds, CancellationToken ct = default) =>
+        Task.CompletedTask;
+
+    /// <summary>
+    /// A stamp per mod that changes whenever its versions or dependencies
+    /// change, e.g. its last-updated time, answered without fetching them.
+    /// Mods left out can't be checked cheaply; a <see cref="ResolutionCache"/>
+    /// then reuses their data only for a limited time.
+    /// </summary>
+    Task<Dictionary<string, string>> GetDataVersionsAsync(IReadOnlyCollection<string> canonicalIds, CancellationToken ct = default) =>
+        Task.FromResult(new Dictionary<string, string>());
 }
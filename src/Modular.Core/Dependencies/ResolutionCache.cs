@@ -0,0 +1,263 @@
+using System.Security.Cryptography;
+using System.Text;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using Modular.Core.Metadata;
+using Modular.Core.Utilities;
+using Modular.Core.Versioning;
+
+namespace Modular.Core.Dependencies;
+
+/// <summary>
+/// What <see cref="GreedyDependencyResolver"/> learned in earlier runs over a
+/// profile: each mod's available versions and dependencies, stamped with
+/// the provider's data version, and the version it selected under which
+/// constraints. A later run only asks the provider about mods whose data
+/// changed and only re-selects mods whose constraints changed, i.e. the part
+/// of the graph reachable from an edit. Everything it reuses is exactly what
+/// a full solve would compute, so results are identical.
+/// </summary>
+public sealed class ResolutionCache
+{
+    private static readonly JsonSerializerOptions JsonOptions = new()
+    {
+        DefaultIgnoreCondition = JsonIgnoreCondition.WhenWritingNull
+    };
+
+    private readonly string? _path;
+    private readonly CacheFile _file;
+    private readonly Dictionary<string, string> _pendingDataVersions = new(StringComparer.Ordinal);
+    private readonly HashSet<string> _visited = new(StringComparer.Ordinal);
+    private bool _changed;
+
+    /// <summary>
+    /// Opens the cache persisted at <paramref name="path"/>, or an in-memory
+    /// one when it's null. An unreadable file starts an empty cache.
+    /// </summary>
+    public ResolutionCache(string? path = null, TimeSpan? maxUnversionedAge = null)
+    {
+        _path = path;
+        MaxUnversionedAge = maxUnversionedAge ?? TimeSpan.FromHours(1);
+        _file = Load(path);
+    }
+
+    /// <summary>
+    /// How long data from a provider that reports no data versions is
+    /// trusted before it's fetched again.
+    /// </summary>
+    public TimeSpan MaxUnversionedAge { get; }
+
+    /// <summary>
+    /// Fingerprint of the inputs of the last completed run.
+    /// </summary>
+    public string? Fingerprint => _file.Fingerprint;
+
+    /// <summary>
+    /// Default location of a profile's cache.
+    /// </summary>
+    public static string DefaultPath(string profileId) =>
+        Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+            ".config", "Modular", "resolution", FileUtils.SanitizeFilename(profileId) + ".json");
+
+    /// <summary>
+    /// Starts a run: asks the provider for the data versions of every cached
+    /// mod and the roots, and drops entries whose data changed or expired.
+    /// </summary>
+    internal async Task BeginAsync(IModVersionProvider provider, IEnumerable<string> rootIds, CancellationToken ct)
+    {
+        _visited.Clear();
+        _pendingDataVersions.Clear();
+
+        var ids = _file.Mods.Keys.Union(rootIds, StringComparer.Ordinal).ToList();
+        var dataVersions = ids.Count > 0
+            ? await provider.GetDataVersionsAsync(ids, ct)
+            : new Dictionary<string, string>();
+        var now = DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+
+        foreach (var id in ids)
+        {
+            dataVersions.TryGetValue(id, out var dataVersion);
+            if (dataVersion != null)
+                _pendingDataVersions[id] = dataVersion;
+
+            if (!_file.Mods.TryGetValue(id, out var entry))
+                continue;
+
+            var valid = dataVersion != null
+                ? dataVersion == entry.DataVersion
+                : entry.DataVersion == null && now - entry.FetchedAt < MaxUnversionedAge.TotalSeconds;
+
+            if (!valid)
+            {
+                _file.Mods.Remove(id);
+                _changed = true;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Records data versions of mods about to be fetched for the first time,
+    /// before their data, so a change in between is caught next run.
+    /// </summary>
+    internal async Task RecordDataVersionsAsync(IModVersionProvider provider, IReadOnlyCollection<string> ids, CancellationToken ct)
+    {
+        var missing = ids.Where(id => !_pendingDataVersions.ContainsKey(id)).ToList();
+        if (missing.Count == 0)
+            return;
+
+        foreach (var (id, dataVersion) in await provider.GetDataVersionsAsync(missing, ct))
+            _pendingDataVersions[id] = dataVersion;
+    }
+
+    internal bool Contains(string canonicalId) => _file.Mods.ContainsKey(canonicalId);
+
+    internal bool TryGetVersions(string canonicalId, out List<SemanticVersion> versions)
+    {
+        _visited.Add(canonicalId);
+        if (_file.Mods.TryGetValue(canonicalId, out var entry))
+        {
+            versions = entry.ParsedVersions ??= entry.Versions.Select(SemanticVersion.Parse).ToList();
+            return true;
+        }
+
+        versions = [];
+        return false;
+    }
+
+    internal void StoreVersions(string canonicalId, List<SemanticVersion> versions)
+    {
+        _file.Mods[canonicalId] = new CachedMod
+        {
+            DataVersion = _pendingDataVersions.GetValueOrDefault(canonicalId),
+            FetchedAt = DateTimeOffset.UtcNow.ToUnixTimeSeconds(),
+            Versions = versions.Select(v => v.ToString()).ToList(),
+            ParsedVersions = versions
+        };
+        _changed = true;
+    }
+
+    internal bool TryGetDependencies(string canonicalId, SemanticVersion version, out List<ModDependency> dependencies)
+    {
+        if (_file.Mods.TryGetValue(canonicalId, out var entry)
+            && entry.Dependencies.TryGetValue(version.ToString(), out var cached))
+        {
+            dependencies = cached;
+            return true;
+        }
+
+        dependencies = [];
+        return false;
+    }
+
+    internal void StoreDependencies(string canonicalId, SemanticVersion version, List<ModDependency> dependencies)
+    {
+        if (!_file.Mods.TryGetValue(canonicalId, out var entry))
+            return;
+
+        entry.Dependencies[version.ToString()] = dependencies;
+        _changed = true;
+    }
+
+    /// <summary>
+    /// The version selected last time under the same constraints; null when
+    /// none satisfied them.
+    /// </summary>
+    internal bool TryGetSelection(string canonicalId, string constraintKey, out SemanticVersion? version)
+    {
+        if (_file.Mods.TryGetValue(canonicalId, out var entry) && entry.SelectionKey == constraintKey)
+        {
+            version = entry.Selected == null ? null : SemanticVersion.Parse(entry.Selected);
+            return true;
+        }
+
+        version = null;
+        return false;
+    }
+
+    internal void StoreSelection(string canonicalId, string constraintKey, SemanticVersion? version)
+    {
+        if (!_file.Mods.TryGetValue(canonicalId, out var entry))
+            return;
+
+        entry.SelectionKey = constraintKey;
+        entry.Selected = version?.ToString();
+        _changed = true;
+    }
+
+    /// <summary>
+    /// Ends a run: fingerprints its inputs (root requirements plus the data
+    /// version of every mod it visited) and saves the cache if it changed.
+    /// </summary>
+    internal string Complete(List<(string canonicalId, VersionRange? constraint)> rootRequirements)
+    {
+        var inputs = new StringBuilder();
+        foreach (var (canonicalId, constraint) in rootRequirements)
+            inputs.Append("root ").Append(canonicalId).Append(' ').Append(constraint).Append('\n');
+
+        foreach (var id in _visited.Order(StringComparer.Ordinal))
+        {
+            var entry = _file.Mods.GetValueOrDefault(id);
+            inputs.Append("mod ").Append(id).Append(' ')
+                .Append(entry?.DataVersion ?? $"@{entry?.FetchedAt}").Append('\n');
+        }
+
+        var fingerprint = Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(inputs.ToString())));
+        if (fingerprint != _file.Fingerprint)
+        {
+            _file.Fingerprint = fingerprint;
+            _changed = true;
+        }
+
+        if (_changed)
+            Save();
+
+        return fingerprint;
+    }
+
+    private void Save()
+    {
+        _changed = false;
+        if (_path == null)
+            return;
+
+        Directory.CreateDirectory(Path.GetDirectoryName(_path)!);
+        var temp = _path + ".tmp";
+        File.WriteAllText(temp, JsonSerializer.Serialize(_file, JsonOptions));
+        File.Move(temp, _path, overwrite: true);
+    }
+
+    private static CacheFile Load(string? path)
+    {
+        if (path == null || !File.Exists(path))
+            return new CacheFile();
+
+        try
+        {
+            return JsonSerializer.Deserialize<CacheFile>(File.ReadAllText(path), JsonOptions) ?? new CacheFile();
+        }
+        catch (JsonException)
+        {
+            return new CacheFile();
+        }
+    }
+
+    private sealed class CacheFile
+    {
+        public string? Fingerprint { get; set; }
+        public Dictionary<string, CachedMod> Mods { get; set; } = new(StringComparer.Ordinal);
+    }
+
+    private sealed class CachedMod
+    {
+        public string? DataVersion { get; set; }
+        public long FetchedAt { get; set; }
+        public List<string> Versions { get; set; } = [];
+        public Dictionary<string, List<ModDependency>> Dependencies { get; set; } = new(StringComparer.Ordinal);
+        public string? SelectionKey { get; set; }
+        public string? Selected { get; set; }
+
+        [JsonIgnore]
+        public List<SemanticVersion>? ParsedVersions { get; set; }
+    }
+}
@@ -37,6 +37,17 @@ public class ResolutionResult
     /// Resolution graph showing the full dependency tree.
     /// </summary>
     public DependencyGraph? Graph { get; set; }
+
+    /// <summary>
+    /// Mods whose version was selected in this run rather than reused from a
+    /// <see cref="ResolutionCache"/>; every visited mod without one.
+    /// </summary>
+    public List<string> ReResolvedMods { get; set; } = new();
+
+    /// <summary>
+    /// Fingerprint of the resolution inputs, set when a cache is used.
+    /// </summary>
+    public string? Fingerprint { get; set; }
 }
 
 /// <summary>
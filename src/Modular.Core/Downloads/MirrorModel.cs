@@ -0,0 +1,242 @@
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Models;
+
+namespace Modular.Core.Downloads;
+
+/// <summary>
+/// Smoothed performance of one download mirror.
+/// </summary>
+public sealed class MirrorStats
+{
+    /// <summary>
+    /// Time to response headers, in milliseconds.
+    /// </summary>
+    [JsonPropertyName("latency_ms")]
+    public double LatencyMs { get; set; }
+
+    /// <summary>
+    /// Body transfer rate in bytes per second; zero until a transfer has been measured.
+    /// </summary>
+    [JsonPropertyName("throughput_bps")]
+    public double ThroughputBytesPerSecond { get; set; }
+
+    /// <summary>
+    /// Smoothed share of requests that failed (0 to 1).
+    /// </summary>
+    [JsonPropertyName("failure_rate")]
+    public double FailureRate { get; set; }
+
+    /// <summary>
+    /// Number of observations folded into the averages.
+    /// </summary>
+    [JsonPropertyName("samples")]
+    public int Samples { get; set; }
+
+    /// <summary>
+    /// When the mirror was last observed.
+    /// </summary>
+    [JsonPropertyName("updated_utc")]
+    public DateTime UpdatedUtc { get; set; }
+}
+
+/// <summary>
+/// Persistent per-mirror latency/throughput model. Every observation is folded
+/// in as an exponentially weighted moving average, so a mirror that degrades
+/// loses its rank after a few transfers while one bad sample doesn't bury a
+/// good mirror. Mirrors are keyed by their CDN short name (or host).
+/// </summary>
+public sealed class MirrorModel
+{
+    private readonly string? _statePath;
+    private readonly double _alpha;
+    private readonly ILogger? _logger;
+    private readonly Dictionary<string, MirrorStats> _stats = new(StringComparer.OrdinalIgnoreCase);
+    private readonly object _lock = new();
+
+    /// <summary>
+    /// Creates a model persisted at <paramref name="statePath"/>, or kept in
+    /// memory only when no path is given.
+    /// </summary>
+    /// <param name="alpha">Weight of each new observation (0 to 1).</param>
+    public MirrorModel(string? statePath = null, double alpha = 0.3, ILogger? logger = null)
+    {
+        if (alpha is <= 0 or > 1)
+            throw new ArgumentOutOfRangeException(nameof(alpha), "Smoothing factor must be in (0, 1]");
+
+        _statePath = statePath;
+        _alpha = alpha;
+        _logger = logger;
+        Load();
+    }
+
+    /// <summary>
+    /// Default location of the model.
+    /// </summary>
+    public static string DefaultPath =>
+        Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+            ".config", "Modular", "mirrors.json");
+
+    /// <summary>
+    /// Key a link is tracked under.
+    /// </summary>
+    public static string KeyOf(DownloadLink link)
+    {
+        if (!string.IsNullOrEmpty(link.ShortName))
+            return link.ShortName;
+        return Uri.TryCreate(link.Uri, UriKind.Absolute, out var uri) ? uri.Authority : link.Uri;
+    }
+
+    /// <summary>
+    /// Returns a copy of the statistics for <paramref name="mirror"/>, or null if it was never observed.
+    /// </summary>
+    public MirrorStats? GetStats(string mirror)
+    {
+        lock (_lock)
+        {
+            if (!_stats.TryGetValue(mirror, out var stats))
+                return null;
+
+            return new MirrorStats
+            {
+                LatencyMs = stats.LatencyMs,
+                ThroughputBytesPerSecond = stats.ThroughputBytesPerSecond,
+                FailureRate = stats.FailureRate,
+                Samples = stats.Samples,
+                UpdatedUtc = stats.UpdatedUtc
+            };
+        }
+    }
+
+    /// <summary>
+    /// Records a successful request: its header latency and, when the body was
+    /// read, the transfer rate.
+    /// </summary>
+    public void RecordSuccess(string mirror, TimeSpan latency, long bytes, TimeSpan transferTime)
+    {
+        lock (_lock)
+        {
+            var stats = GetOrAdd(mirror);
+            stats.LatencyMs = Blend(stats.LatencyMs, latency.TotalMilliseconds);
+            if (bytes > 0 && transferTime > TimeSpan.Zero)
+                stats.ThroughputBytesPerSecond = Blend(stats.ThroughputBytesPerSecond, bytes / transferTime.TotalSeconds);
+
+            stats.FailureRate *= 1 - _alpha;
+            stats.Samples++;
+            stats.UpdatedUtc = DateTime.UtcNow;
+        }
+    }
+
+    /// <summary>
+    /// Records a failed request (error status, reset connection or timeout).
+    /// </summary>
+    public void RecordFailure(string mirror)
+    {
+        lock (_lock)
+        {
+            var stats = GetOrAdd(mirror);
+            stats.FailureRate = stats.FailureRate * (1 - _alpha) + _alpha;
+            stats.Samples++;
+            stats.UpdatedUtc = DateTime.UtcNow;
+        }
+    }
+
+    /// <summary>
+    /// Whether <paramref name="mirror"/> has no measurement newer than <paramref name="maxAge"/>.
+    /// </summary>
+    public bool IsStale(string mirror, TimeSpan maxAge)
+    {
+        lock (_lock)
+        {
+            return !_stats.TryGetValue(mirror, out var stats)
+                || stats.ThroughputBytesPerSecond <= 0
+                || DateTime.UtcNow - stats.UpdatedUtc > maxAge;
+        }
+    }
+
+    /// <summary>
+    /// Expected seconds to fetch <paramref name="sizeBytes"/> from <paramref name="mirror"/>,
+    /// inflated by its failure rate. Unmeasured mirrors rank last.
+    /// </summary>
+    public double EstimateSeconds(string mirror, long sizeBytes)
+    {
+        lock (_lock)
+        {
+            if (!_stats.TryGetValue(mirror, out var stats) || stats.ThroughputBytesPerSecond <= 0)
+                return double.MaxValue;
+
+            var seconds = stats.LatencyMs / 1000 + Math.Max(sizeBytes, 0) / stats.ThroughputBytesPerSecond;
+            return seconds / Math.Max(0.05, 1 - stats.FailureRate);
+        }
+    }
+
+    /// <summary>
+    /// Orders <paramref name="links"/> fastest first for a file of
+    /// <paramref name="sizeBytes"/>: small files favour low latency, large
+    /// ones throughput. Ties keep the server's order.
+    /// </summary>
+    public List<DownloadLink> Rank(IEnumerable<DownloadLink> links, long sizeBytes) =>
+        links
+            .Select((link, index) => (link, index, estimate: EstimateSeconds(KeyOf(link), sizeBytes)))
+            .OrderBy(x => x.estimate)
+            .ThenBy(x => x.index)
+            .Select(x => x.link)
+            .ToList();
+
+    /// <summary>
+    /// Writes the model to its state file; a no-op for in-memory models.
+    /// </summary>
+    public void Save()
+    {
+        if (string.IsNullOrEmpty(_statePath))
+            return;
+
+        try
+        {
+            Directory.CreateDirectory(Path.GetDirectoryName(Path.GetFullPath(_statePath))!);
+            var tempPath = _statePath + ".tmp";
+            lock (_lock)
+            {
+                File.WriteAllText(tempPath, JsonSerializer.Serialize(_stats, new JsonSerializerOptions { WriteIndented = true }));
+                File.Move(tempPath, _statePath, overwrite: true);
+            }
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            _logger?.LogWarning(ex, "Failed to save mirror statistics to {Path}", _statePath);
+        }
+    }
+
+    private void Load()
+    {
+        if (string.IsNullOrEmpty(_statePath) || !File.Exists(_statePath))
+            return;
+
+        try
+        {
+            var stored = JsonSerializer.Deserialize<Dictionary<string, MirrorStats>>(File.ReadAllText(_statePath));
+            if (stored == null)
+                return;
+
+            foreach (var (mirror, stats) in stored)
+                _stats[mirror] = stats;
+        }
+        catch (Exception ex) when (ex is JsonException or IOException)
+        {
+            _logger?.LogWarning(ex, "Ignoring unreadable mirror statistics at {Path}", _statePath);
+        }
+    }
+
+    private MirrorStats GetOrAdd(string mirror)
+    {
+        if (!_stats.TryGetValue(mirror, out var stats))
+            _stats[mirror] = stats = new MirrorStats();
+        return stats;
+    }
+
+    // The first measurement seeds the average instead of being pulled towards zero
+    private double Blend(double current, double sample) =>
+        current <= 0 ? sample : current + _alpha * (sample - current);
+}
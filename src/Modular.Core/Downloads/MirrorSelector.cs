@@ -0,0 +1,317 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Http.Headers;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Models;
+using Modular.Core.RateLimiting;
+
+namespace Modular.Core.Downloads;
+
+/// <summary>
+/// Tuning for <see cref="MirrorSelector"/>.
+/// </summary>
+public sealed class MirrorSelectorOptions
+{
+    /// <summary>
+    /// Bytes requested by a probe.
+    /// </summary>
+    public int ProbeBytes { get; set; } = 64 * 1024;
+
+    /// <summary>
+    /// How long the probes of one file may take in total.
+    /// </summary>
+    public TimeSpan ProbeTimeout { get; set; } = TimeSpan.FromSeconds(3);
+
+    /// <summary>
+    /// Mirrors measured more recently than this are ranked from the model alone.
+    /// </summary>
+    public TimeSpan ProbeInterval { get; set; } = TimeSpan.FromMinutes(15);
+
+    /// <summary>
+    /// Transfer rate below which a mirror is abandoned mid-transfer, when another one is left.
+    /// </summary>
+    public double MinThroughputBytesPerSecond { get; set; } = 128 * 1024;
+
+    /// <summary>
+    /// Window the transfer rate is measured over.
+    /// </summary>
+    public TimeSpan ThroughputWindow { get; set; } = TimeSpan.FromSeconds(3);
+
+    /// <summary>
+    /// A read that returns nothing for this long fails the mirror.
+    /// </summary>
+    public TimeSpan StallTimeout { get; set; } = TimeSpan.FromSeconds(15);
+}
+
+/// <summary>
+/// Outcome of <see cref="MirrorSelector.DownloadAsync"/>.
+/// </summary>
+/// <param name="Url">URL of the mirror that delivered the final byte.</param>
+/// <param name="Bytes">Size of the downloaded file.</param>
+/// <param name="Mirrors">Mirrors used, in order; more than one means the transfer switched.</param>
+public sealed record MirrorDownloadResult(string Url, long Bytes, IReadOnlyList<string> Mirrors);
+
+/// <summary>
+/// Picks the best CDN location for each file and moves a transfer to another
+/// one when its mirror fails or slows down. Mirrors nobody measured recently
+/// are probed in parallel with a short ranged request; the rest are ranked by
+/// the persistent <see cref="MirrorModel"/>. A switch resumes from the bytes
+/// already on disk with a <c>Range</c> request instead of starting over.
+/// With a <see cref="BandwidthGovernor"/>, transfers count as background
+/// traffic, and time spent waiting for bandwidth is left out of the mirror's
+/// measured throughput.
+/// </summary>
+public sealed class MirrorSelector
+{
+    private const int BufferSize = 81920;
+
+    private readonly HttpClient _httpClient;
+    private readonly BandwidthGovernor? _governor;
+    private readonly ILogger? _logger;
+
+    public MirrorSelector(
+        MirrorModel? model = null,
+        MirrorSelectorOptions? options = null,
+        HttpClient? httpClient = null,
+        ILogger? logger = null,
+        BandwidthGovernor? governor = null)
+    {
+        Model = model ?? new MirrorModel(logger: logger);
+        Options = options ?? new MirrorSelectorOptions();
+        _logger = logger;
+        _governor = governor;
+        _httpClient = httpClient ?? CreateHttpClient();
+    }
+
+    /// <summary>
+    /// The per-mirror performance model.
+    /// </summary>
+    public MirrorModel Model { get; }
+
+    /// <summary>
+    /// Thresholds and probe settings.
+    /// </summary>
+    public MirrorSelectorOptions Options { get; }
+
+    /// <summary>
+    /// Orders <paramref name="links"/> best first for a file of
+    /// <paramref name="sizeBytes"/>, probing mirrors whose measurements are
+    /// missing or stale first.
+    /// </summary>
+    public async Task<List<DownloadLink>> RankAsync(
+        IReadOnlyList<DownloadLink> links,
+        long sizeBytes,
+        CancellationToken ct = default)
+    {
+        if (links.Count > 1)
+        {
+            var stale = links.Where(l => Model.IsStale(MirrorModel.KeyOf(l), Options.ProbeInterval)).ToList();
+            if (stale.Count > 0)
+            {
+                using var probeCts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+                probeCts.CancelAfter(Options.ProbeTimeout);
+                await Task.WhenAll(stale.Select(l => ProbeAsync(l, probeCts.Token)));
+                ct.ThrowIfCancellationRequested();
+            }
+        }
+
+        return Model.Rank(links, sizeBytes);
+    }
+
+    /// <summary>
+    /// Downloads the file behind <paramref name="links"/> to
+    /// <paramref name="destinationPath"/>, starting on the best mirror and
+    /// resuming on the next one whenever a mirror fails, stalls or drops below
+    /// <see cref="MirrorSelectorOptions.MinThroughputBytesPerSecond"/>. The last
+    /// remaining mirror is never abandoned for being slow.
+    /// </summary>
+    /// <param name="sizeHint">Approximate file size for ranking; 0 if unknown.</param>
+    public async Task<MirrorDownloadResult> DownloadAsync(
+        IReadOnlyList<DownloadLink> links,
+        string destinationPath,
+        long sizeHint = 0,
+        CancellationToken ct = default)
+    {
+        if (links.Count == 0)
+            throw new ArgumentException("At least one download link is required", nameof(links));
+
+        var candidates = new Queue<DownloadLink>(await RankAsync(links, sizeHint, ct));
+        var used = new List<string>();
+        Exception? lastError = null;
+        using var bandwidth = _governor?.BeginTransfer(BandwidthClass.Background);
+
+        try
+        {
+            await using var output = new FileStream(
+                destinationPath, FileMode.Create, FileAccess.Write, FileShare.None, BufferSize, useAsync: true);
+
+            while (candidates.TryDequeue(out var link))
+            {
+                var mirror = MirrorModel.KeyOf(link);
+                used.Add(mirror);
+                try
+                {
+                    var finished = await TransferAsync(link, mirror, output, canSwitch: candidates.Count > 0, ct);
+                    if (finished)
+                        return new MirrorDownloadResult(link.Uri, output.Length, used);
+
+                    _logger?.LogInformation(
+                        "Mirror {Mirror} fell below {Rate:N0} B/s at byte {Offset}; switching",
+                        mirror, Options.MinThroughputBytesPerSecond, output.Length);
+                }
+                catch (Exception ex) when (ex is HttpRequestException or IOException or TimeoutException
+                                               || (ex is OperationCanceledException && !ct.IsCancellationRequested))
+                {
+                    lastError = ex;
+                    Model.RecordFailure(mirror);
+                    _logger?.LogWarning(ex, "Mirror {Mirror} failed at byte {Offset}", mirror, output.Length);
+                }
+            }
+        }
+        finally
+        {
+            Model.Save();
+        }
+
+        throw new HttpRequestException($"All {links.Count} mirrors failed", lastError);
+    }
+
+    /// <summary>
+    /// Fetches from <paramref name="link"/> into <paramref name="output"/>,
+    /// continuing at its current length. Returns false if the mirror was
+    /// abandoned for being slow.
+    /// </summary>
+    private async Task<bool> TransferAsync(
+        DownloadLink link,
+        string mirror,
+        FileStream output,
+        bool canSwitch,
+        CancellationToken ct)
+    {
+        var offset = output.Length;
+        using var request = new HttpRequestMessage(HttpMethod.Get, link.Uri);
+        if (offset > 0)
+            request.Headers.Range = new RangeHeaderValue(offset, null);
+
+        var stopwatch = Stopwatch.StartNew();
+        using var stallCts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+        stallCts.CancelAfter(Options.StallTimeout);
+        using var response = await _httpClient.SendAsync(request, HttpCompletionOption.ResponseHeadersRead, stallCts.Token);
+        response.EnsureSuccessStatusCode();
+        var latency = stopwatch.Elapsed;
+
+        if (offset > 0 && response.StatusCode != HttpStatusCode.PartialContent)
+        {
+            // The mirror ignored the range; its body starts at byte zero
+            _logger?.LogDebug("Mirror {Mirror} does not support ranges; restarting the file", mirror);
+            output.SetLength(0);
+        }
+        else if (offset > 0 && response.Content.Headers.ContentRange?.From != offset)
+        {
+            throw new IOException($"Mirror {mirror} answered a request for byte {offset} with a different range");
+        }
+
+        output.Seek(0, SeekOrigin.End);
+        await using var body = await response.Content.ReadAsStreamAsync(stallCts.Token);
+        var buffer = new byte[BufferSize];
+        long received = 0;
+        var throttled = TimeSpan.Zero;
+        var windowStart = stopwatch.Elapsed;
+        var windowThrottled = TimeSpan.Zero;
+        long windowBytes = 0;
+
+        while (true)
+        {
+            var count = buffer.Length;
+            if (_governor != null)
+            {
+                count = Math.Min(count, _governor.ChunkSize);
+                var waitStart = stopwatch.Elapsed;
+                await _governor.AcquireAsync(count, BandwidthClass.Background, ct);
+                var waited = stopwatch.Elapsed - waitStart;
+                throttled += waited;
+                windowThrottled += waited;
+            }
+
+            stallCts.CancelAfter(Options.StallTimeout);
+            var read = await body.ReadAsync(buffer.AsMemory(0, count), stallCts.Token);
+            if (read < count)
+                _governor?.Refund(count - read, BandwidthClass.Background);
+            if (read == 0)
+                break;
+
+            await output.WriteAsync(buffer.AsMemory(0, read), ct);
+            received += read;
+            windowBytes += read;
+
+            var windowLength = stopwatch.Elapsed - windowStart - windowThrottled;
+            if (windowLength < Options.ThroughputWindow)
+                continue;
+
+            if (canSwitch && windowBytes / windowLength.TotalSeconds < Options.MinThroughputBytesPerSecond)
+            {
+                await output.FlushAsync(ct);
+                Model.RecordSuccess(mirror, latency, received, stopwatch.Elapsed - latency - throttled);
+                return false;
+            }
+
+            windowStart = stopwatch.Elapsed;
+            windowThrottled = TimeSpan.Zero;
+            windowBytes = 0;
+        }
+
+        await output.FlushAsync(ct);
+        Model.RecordSuccess(mirror, latency, received, stopwatch.Elapsed - latency - throttled);
+        return true;
+    }
+
+    /// <summary>
+    /// Measures one mirror with a short ranged request. A probe cut off by the
+    /// deadline still counts what it read, so a slow mirror is measured as slow
+    /// rather than as broken.
+    /// </summary>
+    private async Task ProbeAsync(DownloadLink link, CancellationToken ct)
+    {
+        var mirror = MirrorModel.KeyOf(link);
+        var stopwatch = Stopwatch.StartNew();
+        var latency = TimeSpan.Zero;
+        long received = 0;
+        try
+        {
+            using var request = new HttpRequestMessage(HttpMethod.Get, link.Uri);
+            request.Headers.Range = new RangeHeaderValue(0, Options.ProbeBytes - 1);
+            using var response = await _httpClient.SendAsync(request, HttpCompletionOption.ResponseHeadersRead, ct);
+            response.EnsureSuccessStatusCode();
+            latency = stopwatch.Elapsed;
+
+            await using var body = await response.Content.ReadAsStreamAsync(ct);
+            var buffer = new byte[BufferSize];
+            while (received < Options.ProbeBytes)
+            {
+                var read = await body.ReadAsync(buffer.AsMemory(0, (int)Math.Min(buffer.Length, Options.ProbeBytes - received)), ct);
+                if (read == 0)
+                    break;
+                received += read;
+            }
+
+            Model.RecordSuccess(mirror, latency, received, stopwatch.Elapsed - latency);
+        }
+        catch (OperationCanceledException) when (received > 0)
+        {
+            Model.RecordSuccess(mirror, latency, received, stopwatch.Elapsed - latency);
+        }
+        catch (Exception ex) when (ex is HttpRequestException or IOException or OperationCanceledException)
+        {
+            _logger?.LogDebug(ex, "Probe of mirror {Mirror} failed", mirror);
+            Model.RecordFailure(mirror);
+        }
+    }
+
+    private static HttpClient CreateHttpClient()
+    {
+        // Per-read stall detection replaces the whole-request timeout, which would cut off large files
+        var client = new HttpClient { Timeout = Timeout.InfiniteTimeSpan };
+        client.DefaultRequestHeaders.UserAgent.ParseAdd("Modular/1.0");
+        return client;
+    }
+}
@@ -1,4 +1,5 @@
 using Microsoft.Extensions.Logging;
+using Modular.Core.Resilience;
 using Modular.Core.Telemetry;
 
 namespace Modular.Core.ErrorHandling;
@@ -11,15 +12,18 @@ public class ErrorBoundary
     private readonly ILogger? _logger;
     private readonly ErrorBoundaryPolicy _policy;
     private readonly TelemetryService? _telemetry;
+    private readonly ResilienceEngine _resilience;
 
     public ErrorBoundary(
         ErrorBoundaryPolicy policy,
         ILogger? logger = null,
-        TelemetryService? telemetry = null)
+        TelemetryService? telemetry = null,
+        ResilienceEngine? resilience = null)
     {
         _policy = policy;
         _logger = logger;
         _telemetry = telemetry;
+        _resilience = resilience ?? ResilienceEngine.Shared;
     }
 
     /// <summary>
@@ -71,7 +75,10 @@ public class ErrorBoundary
 
         try
         {
-            await action();
+            if (_policy.Resilience is { } category)
+                await _resilience.ExecuteAsync(category, operationName, _ => action(), ct: ct);
+            else
+                await action();
             result.Success = true;
             _logger?.LogDebug("Async operation {Operation} completed successfully", operationName);
         }
@@ -159,7 +166,9 @@ public class ErrorBoundary
 
         try
         {
-            result.Value = await action();
+            result.Value = _policy.Resilience is { } category
+                ? await _resilience.ExecuteAsync(category, operationName, _ => action(), ct: ct)
+                : await action();
             result.Success = true;
             _logger?.LogDebug("Async operation {Operation} completed successfully", operationName);
         }
@@ -225,6 +234,8 @@ public class ErrorBoundary
             StackOverflowException => ErrorSeverity.Critical,
             AccessViolationException => ErrorSeverity.Critical,
             FileNotFoundException => ErrorSeverity.Warning,
+            CircuitOpenException => ErrorSeverity.Warning,
+            BulkheadRejectedException => ErrorSeverity.Warning,
             DirectoryNotFoundException => ErrorSeverity.Warning,
             _ => ErrorSeverity.Error
         };
@@ -246,6 +257,13 @@ public class ErrorBoundaryPolicy
     /// </summary>
     public bool ThrowOnCriticalError { get; set; } = false;
 
+    /// <summary>
+    /// Category whose resilience policy async operations run under, with the
+    /// operation name as the circuit key. Null runs each operation once.
+    /// Synchronous operations always run once.
+    /// </summary>
+    public ResilienceCategory? Resilience { get; set; }
+
     /// <summary>
     /// Default permissive policy.
     /// </summary>
@@ -255,6 +273,17 @@ public class ErrorBoundaryPolicy
         ThrowOnCriticalError = false
     };
 
+    /// <summary>
+    /// Permissive policy that also isolates each operation behind its own
+    /// circuit breaker and bulkhead, for calls into plugin code.
+    /// </summary>
+    public static ErrorBoundaryPolicy Isolated => new()
+    {
+        ReturnFallbackOnError = true,
+        ThrowOnCriticalError = false,
+        Resilience = ResilienceCategory.Plugin
+    };
+
     /// <summary>
     /// Strict policy that throws on critical errors.
     /// </summary>
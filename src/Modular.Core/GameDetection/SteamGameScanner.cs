@@ -25,28 +25,8 @@ public class SteamGameScanner
 
         foreach (var root in roots)
         {
-            var steamApps = Path.Combine(root, "steamapps");
-            if (!Directory.Exists(steamApps))
-                continue;
-
-            var manifests = Directory.GetFiles(steamApps, "appmanifest_*.acf");
-            foreach (var manifest in manifests)
-            {
-                ct.ThrowIfCancellationRequested();
-
-                SteamGameInstall? game = null;
-                try
-                {
-                    game = ParseManifest(manifest, root);
-                }
-                catch
-                {
-                    // Skip unparseable manifests
-                }
-
-                if (game != null)
-                    yield return game;
-            }
+            foreach (var game in ScanLibrary(root, ct))
+                yield return game;
         }
 
         await Task.CompletedTask; // Make truly async if needed in the future
@@ -65,6 +45,36 @@ public class SteamGameScanner
         return results;
     }
 
+    /// <summary>
+    /// Parses every appmanifest_*.acf in a single library root.
+    /// </summary>
+    internal static List<SteamGameInstall> ScanLibrary(string root, CancellationToken ct = default)
+    {
+        var games = new List<SteamGameInstall>();
+        var steamApps = Path.Combine(root, "steamapps");
+        if (!Directory.Exists(steamApps))
+            return games;
+
+        var manifests = Directory.GetFiles(steamApps, "appmanifest_*.acf");
+        foreach (var manifest in manifests)
+        {
+            ct.ThrowIfCancellationRequested();
+
+            try
+            {
+                var game = ParseManifest(manifest, root);
+                if (game != null)
+                    games.Add(game);
+            }
+            catch
+            {
+                // Skip unparseable manifests
+            }
+        }
+
+        return games;
+    }
+
     private static SteamGameInstall? ParseManifest(string manifestPath, string libraryRoot)
     {
         var kv = KeyValuesParser.ParseFile(manifestPath);
@@ -0,0 +1,309 @@
+using System.Text.Json;
+using Modular.Core.Configuration;
+
+namespace Modular.Core.GameDetection;
+
+/// <summary>
+/// Process-wide, persisted view of the Steam installation: the resolved root,
+/// its library folders and an AppID → install map.
+/// Validity is checked against the mtimes of libraryfolders.vdf and each
+/// library's steamapps/ directory, and only libraries whose directory changed
+/// are rescanned. Checks are throttled by <see cref="RevalidationInterval"/>, so
+/// lookups within a batch are dictionary hits with no filesystem access.
+/// </summary>
+public sealed class SteamLibraryCache
+{
+    private static readonly Lazy<SteamLibraryCache> SharedInstance = new(
+        () => new SteamLibraryCache(cachePath: ConfigurationService.DefaultSteamLibraryCachePath));
+
+    private static readonly JsonSerializerOptions JsonOptions = new()
+    {
+        PropertyNamingPolicy = JsonNamingPolicy.SnakeCaseLower
+    };
+
+    private readonly ISteamLocator _locator;
+    private readonly string? _cachePath;
+    private readonly object _lock = new();
+    private volatile SteamLibraryView? _view;
+    private long _lastValidatedTicks;
+    private bool _loadedFromDisk;
+
+    /// <summary>
+    /// The cache shared by every component in this process.
+    /// </summary>
+    public static SteamLibraryCache Shared => SharedInstance.Value;
+
+    /// <summary>
+    /// Creates a cache over the given locator.
+    /// </summary>
+    /// <param name="locator">Steam root locator (defaults to <see cref="SteamLocator"/>).</param>
+    /// <param name="cachePath">File to persist the view to, or null to keep it in memory only.</param>
+    public SteamLibraryCache(ISteamLocator? locator = null, string? cachePath = null)
+    {
+        _locator = locator ?? new SteamLocator();
+        _cachePath = cachePath;
+    }
+
+    /// <summary>
+    /// Minimum time between mtime checks. Lookups inside this window are served
+    /// from memory without touching the filesystem.
+    /// </summary>
+    public TimeSpan RevalidationInterval { get; init; } = TimeSpan.FromSeconds(2);
+
+    /// <summary>
+    /// Returns the current view, revalidating it if the interval has elapsed.
+    /// </summary>
+    public SteamLibraryView GetView()
+    {
+        var view = _view;
+        if (view != null && !IsRevalidationDue())
+            return view;
+
+        lock (_lock)
+        {
+            if (_view != null && !IsRevalidationDue())
+                return _view;
+
+            if (!_loadedFromDisk)
+            {
+                _loadedFromDisk = true;
+                _view ??= LoadPersisted();
+            }
+
+            var refreshed = Refresh(_view);
+            if (!ReferenceEquals(refreshed, _view))
+                Persist(refreshed);
+
+            _view = refreshed;
+            Interlocked.Exchange(ref _lastValidatedTicks, Environment.TickCount64);
+            return refreshed;
+        }
+    }
+
+    /// <summary>
+    /// Looks up an installed game by Steam AppID.
+    /// </summary>
+    public SteamGameInstall? FindByAppId(int appId) =>
+        GetView().ByAppId.GetValueOrDefault(appId);
+
+    /// <summary>
+    /// Looks up an installed game by display name: exact (case-insensitive) match
+    /// first, then the first game whose name contains <paramref name="name"/>.
+    /// </summary>
+    public SteamGameInstall? FindByName(string name)
+    {
+        var view = GetView();
+        if (view.ByName.TryGetValue(name, out var exact))
+            return exact;
+
+        return view.Games.FirstOrDefault(g =>
+            g.DisplayName.Contains(name, StringComparison.OrdinalIgnoreCase));
+    }
+
+    /// <summary>
+    /// Forces the next lookup to revalidate against the filesystem.
+    /// </summary>
+    public void Invalidate() => Interlocked.Exchange(ref _lastValidatedTicks, 0);
+
+    private bool IsRevalidationDue()
+    {
+        var last = Interlocked.Read(ref _lastValidatedTicks);
+        return last == 0 || Environment.TickCount64 - last >= (long)RevalidationInterval.TotalMilliseconds;
+    }
+
+    /// <summary>
+    /// Builds a new view, reusing every library from <paramref name="previous"/> whose
+    /// steamapps/ mtime is unchanged. Returns <paramref name="previous"/> itself when
+    /// nothing changed.
+    /// </summary>
+    private SteamLibraryView Refresh(SteamLibraryView? previous)
+    {
+        var steamRoot = previous?.SteamRoot;
+        if (string.IsNullOrEmpty(steamRoot) || !Directory.Exists(steamRoot))
+            steamRoot = _locator.FindSteamRoot();
+
+        if (string.IsNullOrEmpty(steamRoot))
+            return previous is { SteamRoot: null } ? previous : SteamLibraryView.Empty;
+
+        var vdfPath = Path.Combine(steamRoot, "steamapps", "libraryfolders.vdf");
+        var vdfMtime = GetFileMtime(vdfPath);
+
+        var rootsUnchanged = previous != null &&
+            string.Equals(previous.SteamRoot, steamRoot, StringComparison.Ordinal) &&
+            previous.LibraryFoldersMtime == vdfMtime;
+
+        var roots = rootsUnchanged
+            ? previous!.Libraries.Select(l => l.Root).ToList()
+            : SteamLibraryScanner.ReadLibraryRoots(steamRoot);
+
+        var previousByRoot = previous?.Libraries.ToDictionary(l => l.Root, StringComparer.Ordinal)
+            ?? new Dictionary<string, SteamLibraryState>(StringComparer.Ordinal);
+
+        var changed = !rootsUnchanged;
+        var libraries = new List<SteamLibraryState>(roots.Count);
+        foreach (var root in roots)
+        {
+            var steamAppsMtime = GetDirectoryMtime(Path.Combine(root, "steamapps"));
+            if (previousByRoot.TryGetValue(root, out var cached) && cached.SteamAppsMtime == steamAppsMtime)
+            {
+                libraries.Add(cached);
+                continue;
+            }
+
+            changed = true;
+            libraries.Add(new SteamLibraryState
+            {
+                Root = root,
+                SteamAppsMtime = steamAppsMtime,
+                Games = SteamGameScanner.ScanLibrary(root)
+            });
+        }
+
+        if (!changed && previous != null)
+            return previous;
+
+        return new SteamLibraryView(steamRoot, vdfMtime, libraries);
+    }
+
+    private SteamLibraryView? LoadPersisted()
+    {
+        if (_cachePath == null || !File.Exists(_cachePath))
+            return null;
+
+        try
+        {
+            var json = File.ReadAllText(_cachePath);
+            var data = JsonSerializer.Deserialize<PersistedSteamLibraryView>(json, JsonOptions);
+            if (data?.SteamRoot == null)
+                return null;
+
+            return new SteamLibraryView(data.SteamRoot, data.LibraryFoldersMtime, data.Libraries);
+        }
+        catch (Exception ex) when (ex is JsonException or IOException or UnauthorizedAccessException)
+        {
+            // Corrupt or unreadable cache, rebuild from disk
+            return null;
+        }
+    }
+
+    private void Persist(SteamLibraryView view)
+    {
+        if (_cachePath == null)
+            return;
+
+        try
+        {
+            var directory = Path.GetDirectoryName(_cachePath);
+            if (!string.IsNullOrEmpty(directory))
+                Directory.CreateDirectory(directory);
+
+            var data = new PersistedSteamLibraryView
+            {
+                SteamRoot = view.SteamRoot,
+                LibraryFoldersMtime = view.LibraryFoldersMtime,
+                Libraries = view.Libraries.ToList()
+            };
+
+            // Write-then-rename so concurrent processes never read a partial file
+            var tempPath = $"{_cachePath}.{Environment.ProcessId}.tmp";
+            File.WriteAllText(tempPath, JsonSerializer.Serialize(data, JsonOptions));
+            File.Move(tempPath, _cachePath, overwrite: true);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // Persistence is best-effort; the in-memory view is still valid
+        }
+    }
+
+    private static long GetFileMtime(string path) =>
+        File.Exists(path) ? File.GetLastWriteTimeUtc(path).Ticks : 0;
+
+    private static long GetDirectoryMtime(string path) =>
+        Directory.Exists(path) ? Directory.GetLastWriteTimeUtc(path).Ticks : 0;
+
+    private sealed class PersistedSteamLibraryView
+    {
+        public string? SteamRoot { get; set; }
+        public long LibraryFoldersMtime { get; set; }
+        public List<SteamLibraryState> Libraries { get; set; } = [];
+    }
+}
+
+/// <summary>
+/// Cached state of a single Steam library folder.
+/// </summary>
+public sealed class SteamLibraryState
+{
+    /// <summary>
+    /// Library root (contains steamapps/).
+    /// </summary>
+    public string Root { get; init; } = string.Empty;
+
+    /// <summary>
+    /// Last write time (UTC ticks) of steamapps/ when <see cref="Games"/> was built.
+    /// </summary>
+    public long SteamAppsMtime { get; init; }
+
+    /// <summary>
+    /// Games whose appmanifest lives in this library.
+    /// </summary>
+    public List<SteamGameInstall> Games { get; init; } = [];
+}
+
+/// <summary>
+/// Immutable snapshot of the resolved Steam root, libraries and installed games.
+/// </summary>
+public sealed class SteamLibraryView
+{
+    internal static readonly SteamLibraryView Empty = new(null, 0, []);
+
+    internal SteamLibraryView(string? steamRoot, long libraryFoldersMtime, IReadOnlyList<SteamLibraryState> libraries)
+    {
+        SteamRoot = steamRoot;
+        LibraryFoldersMtime = libraryFoldersMtime;
+        Libraries = libraries;
+        Games = libraries.SelectMany(l => l.Games).ToList();
+
+        var byAppId = new Dictionary<int, SteamGameInstall>();
+        var byName = new Dictionary<string, SteamGameInstall>(StringComparer.OrdinalIgnoreCase);
+        foreach (var game in Games)
+        {
+            // First library wins, matching SteamGameScanner's enumeration order
+            byAppId.TryAdd(game.AppId, game);
+            byName.TryAdd(game.DisplayName, game);
+        }
+
+        ByAppId = byAppId;
+        ByName = byName;
+    }
+
+    /// <summary>
+    /// Resolved Steam installation root, or null if Steam was not found.
+    /// </summary>
+    public string? SteamRoot { get; }
+
+    /// <summary>
+    /// Last write time (UTC ticks) of libraryfolders.vdf, or 0 if absent.
+    /// </summary>
+    public long LibraryFoldersMtime { get; }
+
+    /// <summary>
+    /// Library folders in libraryfolders.vdf order, main root first.
+    /// </summary>
+    public IReadOnlyList<SteamLibraryState> Libraries { get; }
+
+    /// <summary>
+    /// All installed games across libraries.
+    /// </summary>
+    public IReadOnlyList<SteamGameInstall> Games { get; }
+
+    /// <summary>
+    /// Games keyed by AppID.
+    /// </summary>
+    public IReadOnlyDictionary<int, SteamGameInstall> ByAppId { get; }
+
+    /// <summary>
+    /// Games keyed by display name (case-insensitive).
+    /// </summary>
+    public IReadOnlyDictionary<string, SteamGameInstall> ByName { get; }
+}
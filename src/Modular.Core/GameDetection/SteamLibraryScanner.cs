@@ -20,11 +20,20 @@ public class SteamLibraryScanner
     /// <returns>List of library root paths.</returns>
     public List<string> GetLibraryRoots()
     {
-        var roots = new List<string>();
         var steamRoot = _locator.FindSteamRoot();
 
         if (string.IsNullOrEmpty(steamRoot))
-            return roots;
+            return [];
+
+        return ReadLibraryRoots(steamRoot);
+    }
+
+    /// <summary>
+    /// Reads the library roots registered under a known Steam root.
+    /// </summary>
+    internal static List<string> ReadLibraryRoots(string steamRoot)
+    {
+        var roots = new List<string>();
 
         // The Steam root itself is always a library
         var mainSteamApps = Path.Combine(steamRoot, "steamapps");
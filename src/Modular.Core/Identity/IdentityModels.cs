@@ -0,0 +1,144 @@
+namespace Modular.Core.Identity;
+
+/// <summary>
+/// Stores that hold a partial identity of a mod.
+/// </summary>
+public static class IdentitySources
+{
+    /// <summary>
+    /// A file in the download database.
+    /// </summary>
+    public const string Download = "download";
+
+    /// <summary>
+    /// An archive in the download library index.
+    /// </summary>
+    public const string Library = "library";
+
+    /// <summary>
+    /// A committed install changeset.
+    /// </summary>
+    public const string Install = "install";
+
+    /// <summary>
+    /// Legacy per-domain mod metadata from the metadata cache.
+    /// </summary>
+    public const string Metadata = "metadata";
+
+    /// <summary>
+    /// A canonical mod from the metadata cache.
+    /// </summary>
+    public const string Canonical = "canonical";
+
+    /// <summary>
+    /// A file a backend offers for a canonical mod.
+    /// </summary>
+    public const string Upstream = "upstream";
+}
+
+/// <summary>
+/// One store's view of a mod or mod file: whatever identifying fields that
+/// store has. Records are linked into identities by
+/// <see cref="ModIdentityIndex.ReconcileAsync"/>.
+/// </summary>
+public sealed record IdentityRecord
+{
+    /// <summary>
+    /// Stable key of the record within all sources, e.g. "download:skyrim:12604:1573".
+    /// </summary>
+    public required string Key { get; init; }
+
+    /// <summary>
+    /// One of <see cref="IdentitySources"/>.
+    /// </summary>
+    public required string Source { get; init; }
+
+    public string? Backend { get; init; }
+    public string? GameDomain { get; init; }
+    public string? ModId { get; init; }
+    public string? FileId { get; init; }
+    public string? Name { get; init; }
+    public string? Author { get; init; }
+
+    /// <summary>
+    /// Full path of the archive the record refers to.
+    /// </summary>
+    public string? ArchivePath { get; init; }
+
+    /// <summary>
+    /// Archive hash prefixed with its algorithm, e.g. "md5:0cc175b9...".
+    /// </summary>
+    public string? ArchiveHash { get; init; }
+
+    /// <summary>
+    /// Unix time an upstream file was published.
+    /// </summary>
+    public long? UploadedAt { get; init; }
+}
+
+/// <summary>
+/// Options for <see cref="ModIdentityIndex.ReconcileAsync"/>.
+/// </summary>
+public sealed class IdentityReconcileOptions
+{
+    /// <summary>
+    /// Re-match every record instead of only new and changed ones, e.g. after
+    /// changing the thresholds.
+    /// </summary>
+    public bool Force { get; init; }
+
+    /// <summary>
+    /// Name similarity (0-1) above which two records with the same author are
+    /// the same mod.
+    /// </summary>
+    public double AuthorNameThreshold { get; init; } = 0.8;
+
+    /// <summary>
+    /// Name similarity (0-1) above which two records are the same mod when an
+    /// author is missing on either side.
+    /// </summary>
+    public double NameOnlyThreshold { get; init; } = 0.92;
+
+    /// <summary>
+    /// Normalized names shorter than this are never matched by name.
+    /// </summary>
+    public int MinNameLength { get; init; } = 4;
+}
+
+/// <summary>
+/// Outcome of a reconcile.
+/// </summary>
+public sealed record IdentityReconcileReport
+{
+    public int RecordCount { get; init; }
+    public int IdentityCount { get; init; }
+    public int AddedCount { get; init; }
+    public int ChangedCount { get; init; }
+    public int RemovedCount { get; init; }
+
+    /// <summary>
+    /// Existing records moved to another identity by a merge or split.
+    /// </summary>
+    public int RelinkedCount { get; init; }
+
+    public TimeSpan Duration { get; init; }
+}
+
+/// <summary>
+/// An installed archive compared with the newest upstream file of its identity.
+/// </summary>
+public sealed record InstalledArchiveStatus
+{
+    public required string InstallKey { get; init; }
+    public required string Identity { get; init; }
+    public string? ArchivePath { get; init; }
+    public string? LatestFileId { get; init; }
+    public string? LatestFileName { get; init; }
+    public DateTimeOffset? LatestUploadedAt { get; init; }
+
+    /// <summary>
+    /// Whether the installed archive is the newest upstream file, or null when
+    /// no upstream file is known for the identity.
+    /// </summary>
+    public bool? IsLatest { get; init; }
+}
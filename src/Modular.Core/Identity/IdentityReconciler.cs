@@ -0,0 +1,427 @@
+namespace Modular.Core.Identity;
+
+/// <summary>
+/// A stored record with the identity it was last assigned.
+/// </summary>
+internal readonly record struct StoredIdentity(IdentityRecord Record, string Identity);
+
+/// <summary>
+/// Writes that bring the stored identities in line with the current records.
+/// </summary>
+internal sealed class IdentityPlan
+{
+    /// <summary>
+    /// New and changed records with their identity.
+    /// </summary>
+    public List<(IdentityRecord Record, string Identity)> Upserts { get; } = [];
+
+    /// <summary>
+    /// Unchanged records whose identity changed, by record key.
+    /// </summary>
+    public Dictionary<string, string> Relabels { get; } = new(StringComparer.Ordinal);
+
+    /// <summary>
+    /// Whole identities merged into another one, old label to new.
+    /// </summary>
+    public Dictionary<string, string> Merges { get; } = new(StringComparer.Ordinal);
+
+    public List<string> Deletes { get; } = [];
+
+    public int AddedCount { get; set; }
+    public int ChangedCount { get; set; }
+    public int RelinkedCount { get; set; }
+    public int IdentityCount { get; set; }
+
+    public bool IsEmpty => Upserts.Count == 0 && Relabels.Count == 0 && Merges.Count == 0 && Deletes.Count == 0;
+}
+
+/// <summary>
+/// Links records into identities with a union-find: archive hash or path
+/// first, then backend mod ID, then name similarity. Only new and changed
+/// records are matched; identities that lost or changed a member are taken
+/// apart and matched again, since a union-find can't undo a link.
+/// </summary>
+internal static class IdentityReconciler
+{
+    public static IdentityPlan Plan(
+        IReadOnlyDictionary<string, StoredIdentity> stored,
+        IEnumerable<IdentityRecord> records,
+        IdentityReconcileOptions options)
+    {
+        var plan = new IdentityPlan();
+
+        var current = new Dictionary<string, IdentityRecord>(StringComparer.Ordinal);
+        foreach (var record in records)
+            current[record.Key] = record;
+
+        // Identities that lost a member or had one change
+        var dirty = new HashSet<string>(StringComparer.Ordinal);
+        foreach (var (key, entry) in stored)
+        {
+            if (options.Force ||
+                !current.TryGetValue(key, out var record) ||
+                record != entry.Record)
+            {
+                dirty.Add(entry.Identity);
+            }
+
+            if (!current.ContainsKey(key))
+                plan.Deletes.Add(key);
+        }
+
+        var sets = new DisjointSet();
+        var stable = new List<Candidate>();
+        var pending = new List<Candidate>();
+
+        foreach (var record in current.Values.OrderBy(r => r.Key, StringComparer.Ordinal))
+        {
+            if (stored.TryGetValue(record.Key, out var entry) && !dirty.Contains(entry.Identity))
+            {
+                stable.Add(new Candidate(record, entry.Identity));
+                sets.Add(entry.Identity, record);
+            }
+            else
+            {
+                pending.Add(new Candidate(record, record.Key));
+                sets.Add(record.Key, record);
+            }
+        }
+
+        var archives = new Dictionary<string, string>(StringComparer.Ordinal);
+        var mods = new Dictionary<string, string>(StringComparer.Ordinal);
+        var names = new NameBlocks(options);
+
+        foreach (var candidate in stable)
+        {
+            foreach (var key in ArchiveKeys(candidate.Record))
+                archives.TryAdd(key, candidate.Node);
+            if (ModKey(candidate.Record) is { } mod)
+                mods.TryAdd(mod, candidate.Node);
+            names.Add(candidate);
+        }
+
+        if (pending.Count > 0)
+        {
+            // The same archive is the same mod
+            foreach (var candidate in pending)
+            {
+                foreach (var key in ArchiveKeys(candidate.Record))
+                {
+                    if (archives.TryGetValue(key, out var other))
+                        sets.Union(candidate.Node, other);
+                    else
+                        archives[key] = candidate.Node;
+                }
+            }
+
+            // The same backend mod is the same mod
+            foreach (var candidate in pending)
+            {
+                if (ModKey(candidate.Record) is not { } key)
+                    continue;
+                if (mods.TryGetValue(key, out var other))
+                    sets.Union(candidate.Node, other);
+                else
+                    mods[key] = candidate.Node;
+            }
+
+            // Similar names, unless that would join two different mods of one backend
+            foreach (var candidate in pending)
+            {
+                foreach (var other in names.Matches(candidate))
+                {
+                    if (!sets.Conflicts(candidate.Node, other))
+                        sets.Union(candidate.Node, other);
+                }
+
+                names.Add(candidate);
+            }
+        }
+
+        foreach (var label in stable.Select(c => c.Node).Distinct(StringComparer.Ordinal))
+        {
+            var root = sets.Find(label);
+            if (root != label)
+                plan.Merges[label] = root;
+        }
+
+        foreach (var candidate in pending)
+        {
+            var identity = sets.Find(candidate.Node);
+            if (!stored.TryGetValue(candidate.Record.Key, out var entry))
+            {
+                plan.Upserts.Add((candidate.Record, identity));
+                plan.AddedCount++;
+            }
+            else if (entry.Record != candidate.Record)
+            {
+                plan.Upserts.Add((candidate.Record, identity));
+                plan.ChangedCount++;
+            }
+            else if (entry.Identity != identity)
+            {
+                plan.Relabels[candidate.Record.Key] = identity;
+                plan.RelinkedCount++;
+            }
+        }
+
+        plan.RelinkedCount += stable.Count(c => plan.Merges.ContainsKey(c.Node));
+        plan.IdentityCount = current.Count == 0
+            ? 0
+            : stable.Select(c => c.Node).Concat(pending.Select(c => c.Node))
+                .Select(sets.Find).Distinct(StringComparer.Ordinal).Count();
+        return plan;
+    }
+
+    private static IEnumerable<string> ArchiveKeys(IdentityRecord record)
+    {
+        if (!string.IsNullOrEmpty(record.ArchiveHash))
+            yield return "hash:" + record.ArchiveHash.ToLowerInvariant();
+        if (!string.IsNullOrEmpty(record.ArchivePath))
+            yield return "path:" + record.ArchivePath;
+    }
+
+    internal static string? ModKey(IdentityRecord record) =>
+        string.IsNullOrEmpty(record.Backend) || string.IsNullOrEmpty(record.ModId)
+            ? null
+            : $"{record.Backend}|{record.GameDomain}|{record.ModId}";
+
+    internal static string? BackendKey(IdentityRecord record) =>
+        string.IsNullOrEmpty(record.Backend) || string.IsNullOrEmpty(record.ModId)
+            ? null
+            : $"{record.Backend}|{record.GameDomain}";
+
+    /// <summary>
+    /// Lowercased name with punctuation, versions and numbers dropped, so
+    /// "SkyUI_5_2_SE-12604-5-2SE" and "SkyUI SE" compare equal.
+    /// </summary>
+    internal static string NormalizeName(string? name)
+    {
+        if (string.IsNullOrWhiteSpace(name))
+            return string.Empty;
+
+        var tokens = new List<string>();
+        var start = -1;
+        for (var i = 0; i <= name.Length; i++)
+        {
+            if (i < name.Length && char.IsLetterOrDigit(name[i]))
+            {
+                if (start < 0)
+                    start = i;
+                continue;
+            }
+
+            if (start >= 0)
+            {
+                var token = name[start..i].ToLowerInvariant();
+                if (!char.IsDigit(token[0]) && !(token[0] == 'v' && token.Length > 1 && char.IsDigit(token[1])))
+                    tokens.Add(token);
+                start = -1;
+            }
+        }
+
+        return string.Join(' ', tokens);
+    }
+
+    /// <summary>
+    /// Sørensen–Dice coefficient of the character bigrams of two sorted
+    /// bigram lists.
+    /// </summary>
+    internal static double Similarity(int[] a, int[] b)
+    {
+        if (a.Length == 0 || b.Length == 0)
+            return 0;
+
+        int i = 0, j = 0, common = 0;
+        while (i < a.Length && j < b.Length)
+        {
+            if (a[i] == b[j])
+            {
+                common++;
+                i++;
+                j++;
+            }
+            else if (a[i] < b[j])
+            {
+                i++;
+            }
+            else
+            {
+                j++;
+            }
+        }
+
+        return 2.0 * common / (a.Length + b.Length);
+    }
+
+    internal static int[] Bigrams(string normalized)
+    {
+        var compact = normalized.Replace(" ", string.Empty);
+        if (compact.Length < 2)
+            return [];
+
+        var bigrams = new int[compact.Length - 1];
+        for (var i = 0; i < bigrams.Length; i++)
+            bigrams[i] = (compact[i] << 16) | compact[i + 1];
+        Array.Sort(bigrams);
+        return bigrams;
+    }
+
+    private sealed record Candidate(IdentityRecord Record, string Node);
+
+    /// <summary>
+    /// Records with a usable name, bucketed so each is only compared with a
+    /// few likely candidates instead of every other record.
+    /// </summary>
+    private sealed class NameBlocks(IdentityReconcileOptions options)
+    {
+        private const int PrefixLength = 4;
+
+        private readonly Dictionary<string, List<Entry>> _blocks = new(StringComparer.Ordinal);
+
+        public void Add(Candidate candidate)
+        {
+            if (Describe(candidate) is not { } entry)
+                return;
+
+            foreach (var block in BlocksOf(entry))
+            {
+                if (!_blocks.TryGetValue(block, out var list))
+                    _blocks[block] = list = [];
+                list.Add(entry);
+            }
+        }
+
+        public IEnumerable<string> Matches(Candidate candidate)
+        {
+            if (Describe(candidate) is not { } entry)
+                yield break;
+
+            foreach (var block in BlocksOf(entry))
+            {
+                if (!_blocks.TryGetValue(block, out var list))
+                    continue;
+
+                var byAuthor = block[0] == 'a';
+                var threshold = byAuthor ? options.AuthorNameThreshold : options.NameOnlyThreshold;
+                foreach (var other in list)
+                {
+                    if (entry.Domain != null && other.Domain != null && entry.Domain != other.Domain)
+                        continue;
+                    if (!byAuthor && entry.Author != null && other.Author != null)
+                        continue;
+                    if (Similarity(entry.Bigrams, other.Bigrams) >= threshold)
+                        yield return other.Node;
+                }
+            }
+        }
+
+        private Entry? Describe(Candidate candidate)
+        {
+            var name = NormalizeName(candidate.Record.Name);
+            var compact = name.Replace(" ", string.Empty);
+            if (compact.Length < Math.Max(options.MinNameLength, PrefixLength))
+                return null;
+
+            var author = string.IsNullOrWhiteSpace(candidate.Record.Author)
+                ? null
+                : candidate.Record.Author.Trim().ToLowerInvariant();
+            return new Entry(candidate.Node, compact, author, candidate.Record.GameDomain, Bigrams(name));
+        }
+
+        /// <summary>
+        /// Records by the same author, and records of the same game whose names
+        /// start or end alike: near-identical names differ somewhere in the middle
+        /// or at one end, rarely at both.
+        /// </summary>
+        private static IEnumerable<string> BlocksOf(Entry entry)
+        {
+            if (entry.Author != null)
+                yield return "a|" + entry.Author;
+
+            yield return $"p|{entry.Domain}|{entry.Compact[..PrefixLength]}";
+            yield return $"s|{entry.Domain}|{entry.Compact[^PrefixLength..]}";
+        }
+
+        private sealed record Entry(string Node, string Compact, string? Author, string? Domain, int[] Bigrams);
+    }
+
+    /// <summary>
+    /// Union-find over identity labels, by size with path halving. Each set
+    /// remembers which mod ID it holds per backend and game, so a name match
+    /// can be refused when it would join two different mods.
+    /// </summary>
+    private sealed class DisjointSet
+    {
+        private readonly Dictionary<string, string> _parent = new(StringComparer.Ordinal);
+        private readonly Dictionary<string, int> _size = new(StringComparer.Ordinal);
+        private readonly Dictionary<string, Dictionary<string, string>> _mods = new(StringComparer.Ordinal);
+
+        public void Add(string node, IdentityRecord record)
+        {
+            if (_parent.TryAdd(node, node))
+                _size[node] = 0;
+            _size[node]++;
+
+            if (BackendKey(record) is { } backend)
+            {
+                if (!_mods.TryGetValue(node, out var mods))
+                    _mods[node] = mods = new Dictionary<string, string>(StringComparer.Ordinal);
+                mods.TryAdd(backend, record.ModId!);
+            }
+        }
+
+        public string Find(string node)
+        {
+            while (true)
+            {
+                var parent = _parent[node];
+                if (parent == node)
+                    return node;
+
+                var grandparent = _parent[parent];
+                _parent[node] = grandparent;
+                node = grandparent;
+            }
+        }
+
+        public bool Conflicts(string a, string b)
+        {
+            a = Find(a);
+            b = Find(b);
+            if (a == b || !_mods.TryGetValue(a, out var left) || !_mods.TryGetValue(b, out var right))
+                return false;
+
+            foreach (var (backend, modId) in left)
+            {
+                if (right.TryGetValue(backend, out var other) && other != modId)
+                    return true;
+            }
+
+            return false;
+        }
+
+        public void Union(string a, string b)
+        {
+            a = Find(a);
+            b = Find(b);
+            if (a == b)
+                return;
+
+            // Larger set keeps its label; ties go to the smaller label so runs are repeatable
+            if (_size[a] < _size[b] || (_size[a] == _size[b] && string.CompareOrdinal(a, b) > 0))
+                (a, b) = (b, a);
+
+            _parent[b] = a;
+            _size[a] += _size[b];
+
+            if (_mods.Remove(b, out var mods))
+            {
+                if (!_mods.TryGetValue(a, out var target))
+                    _mods[a] = target = new Dictionary<string, string>(StringComparer.Ordinal);
+                foreach (var (backend, modId) in mods)
+                    target.TryAdd(backend, modId);
+            }
+        }
+    }
+}
@@ -0,0 +1,206 @@
+using Modular.Core.Database;
+using Modular.Core.Metadata;
+
+namespace Modular.Core.Identity;
+
+/// <summary>
+/// Reads every store that knows about mods into <see cref="IdentityRecord"/>s
+/// for <see cref="ModIdentityIndex.ReconcileAsync"/>. Stores that weren't
+/// given are skipped.
+/// </summary>
+public sealed class IdentitySourceCollector
+{
+    private const string NexusBackend = "nexusmods";
+
+    private readonly ModularDatabase _database;
+    private readonly DownloadDatabase? _downloads;
+    private readonly ModMetadataCache? _metadataCache;
+
+    public IdentitySourceCollector(
+        ModularDatabase database,
+        DownloadDatabase? downloads = null,
+        ModMetadataCache? metadataCache = null)
+    {
+        _database = database;
+        _downloads = downloads;
+        _metadataCache = metadataCache;
+    }
+
+    public async Task<IReadOnlyList<IdentityRecord>> CollectAsync(CancellationToken ct = default)
+    {
+        var records = new List<IdentityRecord>();
+
+        if (_downloads != null)
+            records.AddRange(_downloads.GetAllRecords().Select(FromDownload));
+
+        if (_metadataCache != null)
+        {
+            records.AddRange(_metadataCache.GetAllModMetadata().Select(m => new IdentityRecord
+            {
+                Key = $"{IdentitySources.Metadata}:{m.GameDomain}:{m.Metadata.ModId}",
+                Source = IdentitySources.Metadata,
+                Backend = NexusBackend,
+                GameDomain = m.GameDomain,
+                ModId = m.Metadata.ModId.ToString(),
+                Name = m.Metadata.Name
+            }));
+
+            foreach (var mod in _metadataCache.GetAllCanonicalMods())
+                records.AddRange(FromCanonical(mod));
+        }
+
+        var connection = await _database.GetConnectionAsync();
+
+        // Archives hashed by the inventory scan carry their SHA-256
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.CommandText = """
+                SELECT l.path, l.game_domain, a.sha256
+                FROM library_archive l LEFT JOIN archive a ON a.path = l.path
+                """;
+            await using var reader = await cmd.ExecuteReaderAsync(ct);
+            while (await reader.ReadAsync(ct))
+            {
+                var path = reader.GetString(0);
+                records.Add(new IdentityRecord
+                {
+                    Key = $"{IdentitySources.Library}:{path}",
+                    Source = IdentitySources.Library,
+                    GameDomain = reader.IsDBNull(1) ? null : reader.GetString(1),
+                    Name = Path.GetFileNameWithoutExtension(path),
+                    ArchivePath = NormalizePath(path),
+                    ArchiveHash = reader.IsDBNull(2) ? null : "sha256:" + reader.GetString(2)
+                });
+            }
+        }
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.CommandText = """
+                SELECT c.changeset_id, c.mod_id, c.archive_path, a.sha256
+                FROM changeset c LEFT JOIN archive a ON a.path = c.archive_path
+                WHERE c.state = 'committed'
+                """;
+            await using var reader = await cmd.ExecuteReaderAsync(ct);
+            while (await reader.ReadAsync(ct))
+            {
+                var (backend, domain, modId) = ParseModId(reader.IsDBNull(1) ? null : reader.GetString(1));
+                records.Add(new IdentityRecord
+                {
+                    Key = $"{IdentitySources.Install}:{reader.GetString(0)}",
+                    Source = IdentitySources.Install,
+                    Backend = backend,
+                    GameDomain = domain,
+                    ModId = modId,
+                    ArchivePath = reader.IsDBNull(2) ? null : NormalizePath(reader.GetString(2)),
+                    ArchiveHash = reader.IsDBNull(3) ? null : "sha256:" + reader.GetString(3)
+                });
+            }
+        }
+
+        return records;
+    }
+
+    private static IdentityRecord FromDownload(DownloadRecord record)
+    {
+        var md5 = !string.IsNullOrEmpty(record.Md5Actual) ? record.Md5Actual : record.Md5Expected;
+
+        // Only NexusMods downloads record a game domain; without one the IDs can't be trusted
+        var hasDomain = !string.IsNullOrEmpty(record.GameDomain);
+        return new IdentityRecord
+        {
+            Key = $"{IdentitySources.Download}:{record.GameDomain}:{record.ModId}:{record.FileId}",
+            Source = IdentitySources.Download,
+            Backend = hasDomain ? NexusBackend : null,
+            GameDomain = hasDomain ? record.GameDomain : null,
+            ModId = hasDomain ? record.ModId.ToString() : null,
+            FileId = hasDomain ? record.FileId.ToString() : null,
+            Name = Path.GetFileNameWithoutExtension(record.Filename),
+            ArchivePath = string.IsNullOrEmpty(record.Filepath) ? null : NormalizePath(record.Filepath),
+            ArchiveHash = string.IsNullOrEmpty(md5) ? null : "md5:" + md5.ToLowerInvariant()
+        };
+    }
+
+    private static IEnumerable<IdentityRecord> FromCanonical(CanonicalMod mod)
+    {
+        var backend = string.IsNullOrEmpty(mod.Source.BackendId) ? null : mod.Source.BackendId;
+        var domain = mod.Game?.Domain;
+        var modId = mod.Source.ProjectId;
+
+        // Nexus project IDs may be qualified as "domain:id"
+        var separator = modId.LastIndexOf(':');
+        if (separator >= 0)
+        {
+            domain ??= modId[..separator];
+            modId = modId[(separator + 1)..];
+        }
+
+        if (string.IsNullOrEmpty(modId))
+            modId = null;
+
+        yield return new IdentityRecord
+        {
+            Key = $"{IdentitySources.Canonical}:{mod.CanonicalId}",
+            Source = IdentitySources.Canonical,
+            Backend = backend,
+            GameDomain = domain,
+            ModId = modId,
+            Name = mod.Name,
+            Author = mod.Authors.FirstOrDefault()?.Name
+        };
+
+        foreach (var version in mod.Versions)
+        {
+            foreach (var file in version.Files)
+            {
+                var uploaded = file.UploadedAt ?? version.PublishedAt;
+                yield return new IdentityRecord
+                {
+                    Key = $"{IdentitySources.Upstream}:{mod.CanonicalId}:{file.FileId}",
+                    Source = IdentitySources.Upstream,
+                    Backend = backend,
+                    GameDomain = domain,
+                    ModId = modId,
+                    FileId = file.FileId,
+                    Name = file.DisplayName ?? Path.GetFileNameWithoutExtension(file.FileName),
+                    ArchiveHash = file.Hashes.Md5 != null ? "md5:" + file.Hashes.Md5.ToLowerInvariant()
+                        : file.Hashes.Sha256 != null ? "sha256:" + file.Hashes.Sha256.ToLowerInvariant()
+                        : null,
+                    UploadedAt = uploaded.HasValue
+                        ? new DateTimeOffset(DateTime.SpecifyKind(uploaded.Value, DateTimeKind.Utc)).ToUnixTimeSeconds()
+                        : null
+                };
+            }
+        }
+    }
+
+    /// <summary>
+    /// Splits a changeset mod ID: "backend:domain:id", "backend:id", or a bare
+    /// ID that names no backend.
+    /// </summary>
+    internal static (string? Backend, string? Domain, string? ModId) ParseModId(string? modId)
+    {
+        if (string.IsNullOrWhiteSpace(modId))
+            return (null, null, null);
+
+        var parts = modId.Split(':');
+        return parts.Length switch
+        {
+            3 => (parts[0], parts[1], parts[2]),
+            2 => (parts[0], null, parts[1]),
+            _ => (null, null, null)
+        };
+    }
+
+    private static string NormalizePath(string path)
+    {
+        try
+        {
+            return Path.GetFullPath(path);
+        }
+        catch (Exception ex) when (ex is ArgumentException or NotSupportedException or PathTooLongException)
+        {
+            return path;
+        }
+    }
+}
@@ -0,0 +1,295 @@
+using System.Diagnostics;
+using Microsoft.Data.Sqlite;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Database;
+
+namespace Modular.Core.Identity;
+
+/// <summary>
+/// Links the records each store keeps of a mod — downloads, library archives,
+/// install changesets, cached metadata and upstream files — into one identity
+/// per mod, persisted in the <c>identity_record</c> table. Every row carries
+/// its identity label, so cross-store questions are a join on that column.
+/// </summary>
+public sealed class ModIdentityIndex
+{
+    private const string Columns =
+        "record_key, source, identity, backend, game_domain, mod_id, file_id, name, author, archive_path, archive_hash, uploaded_at";
+
+    private readonly ModularDatabase _database;
+    private readonly ILogger<ModIdentityIndex>? _logger;
+
+    // The database shares one connection, which allows one transaction at a time
+    private readonly SemaphoreSlim _lock = new(1, 1);
+
+    public ModIdentityIndex(ModularDatabase database, ILogger<ModIdentityIndex>? logger = null)
+    {
+        _database = database;
+        _logger = logger;
+    }
+
+    /// <summary>
+    /// Brings the index in line with <paramref name="records"/>, the complete
+    /// current set from all stores. Only new and changed records are matched,
+    /// plus the members of identities that lost or changed a record.
+    /// </summary>
+    public async Task<IdentityReconcileReport> ReconcileAsync(
+        IReadOnlyCollection<IdentityRecord> records,
+        IdentityReconcileOptions? options = null,
+        CancellationToken ct = default)
+    {
+        options ??= new IdentityReconcileOptions();
+        var stopwatch = Stopwatch.StartNew();
+
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            var stored = await LoadAsync(connection, ct);
+            var plan = IdentityReconciler.Plan(stored, records, options);
+
+            if (!plan.IsEmpty)
+                await ApplyAsync(connection, plan, ct);
+
+            var report = new IdentityReconcileReport
+            {
+                RecordCount = records.Count,
+                IdentityCount = plan.IdentityCount,
+                AddedCount = plan.AddedCount,
+                ChangedCount = plan.ChangedCount,
+                RemovedCount = plan.Deletes.Count,
+                RelinkedCount = plan.RelinkedCount,
+                Duration = stopwatch.Elapsed
+            };
+
+            _logger?.LogInformation(
+                "Reconciled {Records} records into {Identities} identities: {Added} added, {Changed} changed, {Removed} removed, {Relinked} relinked in {Ms} ms",
+                report.RecordCount, report.IdentityCount, report.AddedCount, report.ChangedCount,
+                report.RemovedCount, report.RelinkedCount, (long)report.Duration.TotalMilliseconds);
+            return report;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Identity of a record, or null if it isn't indexed.
+    /// </summary>
+    public async Task<string?> GetIdentityAsync(string recordKey, CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var cmd = connection.CreateCommand();
+            cmd.CommandText = "SELECT identity FROM identity_record WHERE record_key = @key";
+            cmd.Parameters.AddWithValue("@key", recordKey);
+            return await cmd.ExecuteScalarAsync(ct) as string;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// All records linked into <paramref name="identity"/>.
+    /// </summary>
+    public async Task<IReadOnlyList<IdentityRecord>> GetMembersAsync(string identity, CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var cmd = connection.CreateCommand();
+            cmd.CommandText = $"SELECT {Columns} FROM identity_record WHERE identity = @identity ORDER BY record_key";
+            cmd.Parameters.AddWithValue("@identity", identity);
+
+            var result = new List<IdentityRecord>();
+            await using var reader = await cmd.ExecuteReaderAsync(ct);
+            while (await reader.ReadAsync(ct))
+                result.Add(ReadRecord(reader));
+            return result;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Each installed archive with the newest upstream file of its identity,
+    /// and whether the two are the same file by ID or hash.
+    /// </summary>
+    public async Task<IReadOnlyList<InstalledArchiveStatus>> GetInstalledStatusAsync(CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var cmd = connection.CreateCommand();
+            cmd.CommandText = """
+                SELECT i.record_key, i.identity, i.archive_path, u.file_id, u.name, u.uploaded_at,
+                       CASE
+                           WHEN u.record_key IS NULL THEN NULL
+                           WHEN EXISTS (SELECT 1 FROM identity_record d
+                                        WHERE d.archive_path = i.archive_path
+                                          AND d.identity = i.identity
+                                          AND ((d.backend = u.backend AND d.file_id = u.file_id)
+                                               OR d.archive_hash = u.archive_hash))
+                                OR i.archive_hash = u.archive_hash THEN 1
+                           ELSE 0
+                       END
+                FROM identity_record i
+                LEFT JOIN identity_record u ON u.identity = i.identity AND u.source = 'upstream'
+                    AND u.uploaded_at = (SELECT MAX(uploaded_at) FROM identity_record
+                                         WHERE identity = i.identity AND source = 'upstream')
+                WHERE i.source = 'install'
+                ORDER BY i.record_key
+                """;
+
+            var result = new List<InstalledArchiveStatus>();
+            await using var reader = await cmd.ExecuteReaderAsync(ct);
+            while (await reader.ReadAsync(ct))
+            {
+                var status = new InstalledArchiveStatus
+                {
+                    InstallKey = reader.GetString(0),
+                    Identity = reader.GetString(1),
+                    ArchivePath = reader.IsDBNull(2) ? null : reader.GetString(2),
+                    LatestFileId = reader.IsDBNull(3) ? null : reader.GetString(3),
+                    LatestFileName = reader.IsDBNull(4) ? null : reader.GetString(4),
+                    LatestUploadedAt = reader.IsDBNull(5) ? null : DateTimeOffset.FromUnixTimeSeconds(reader.GetInt64(5)),
+                    IsLatest = reader.IsDBNull(6) ? null : reader.GetInt64(6) == 1
+                };
+
+                // Several upstream files uploaded in the same second: installed is latest if it is any of them
+                if (result.Count > 0 && result[^1].InstallKey == status.InstallKey)
+                {
+                    if (status.IsLatest == true)
+                        result[^1] = status;
+                    continue;
+                }
+
+                result.Add(status);
+            }
+
+            return result;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    private static async Task<Dictionary<string, StoredIdentity>> LoadAsync(SqliteConnection connection, CancellationToken ct)
+    {
+        var stored = new Dictionary<string, StoredIdentity>(StringComparer.Ordinal);
+
+        await using var cmd = connection.CreateCommand();
+        cmd.CommandText = $"SELECT {Columns} FROM identity_record";
+        await using var reader = await cmd.ExecuteReaderAsync(ct);
+        while (await reader.ReadAsync(ct))
+        {
+            var record = ReadRecord(reader);
+            stored[record.Key] = new StoredIdentity(record, reader.GetString(2));
+        }
+
+        return stored;
+    }
+
+    private static async Task ApplyAsync(SqliteConnection connection, IdentityPlan plan, CancellationToken ct)
+    {
+        await using var transaction = (SqliteTransaction)await connection.BeginTransactionAsync(ct);
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = "DELETE FROM identity_record WHERE record_key = @key";
+            var key = cmd.Parameters.Add("@key", SqliteType.Text);
+            foreach (var deleted in plan.Deletes)
+            {
+                key.Value = deleted;
+                await cmd.ExecuteNonQueryAsync(ct);
+            }
+        }
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = "UPDATE identity_record SET identity = @to WHERE identity = @from";
+            var from = cmd.Parameters.Add("@from", SqliteType.Text);
+            var to = cmd.Parameters.Add("@to", SqliteType.Text);
+            foreach (var (old, merged) in plan.Merges)
+            {
+                from.Value = old;
+                to.Value = merged;
+                await cmd.ExecuteNonQueryAsync(ct);
+            }
+        }
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = "UPDATE identity_record SET identity = @identity WHERE record_key = @key";
+            var key = cmd.Parameters.Add("@key", SqliteType.Text);
+            var identity = cmd.Parameters.Add("@identity", SqliteType.Text);
+            foreach (var (recordKey, label) in plan.Relabels)
+            {
+                key.Value = recordKey;
+                identity.Value = label;
+                await cmd.ExecuteNonQueryAsync(ct);
+            }
+        }
+
+        await using (var cmd = connection.CreateCommand())
+        {
+            cmd.Transaction = transaction;
+            cmd.CommandText = $"""
+                INSERT OR REPLACE INTO identity_record ({Columns})
+                VALUES (@key, @source, @identity, @backend, @domain, @mod, @file, @name, @author, @path, @hash, @uploaded)
+                """;
+            var parameters = new[]
+            {
+                "@key", "@source", "@identity", "@backend", "@domain", "@mod",
+                "@file", "@name", "@author", "@path", "@hash", "@uploaded"
+            }.Select(name => cmd.Parameters.Add(name, name == "@uploaded" ? SqliteType.Integer : SqliteType.Text)).ToArray();
+
+            foreach (var (record, label) in plan.Upserts)
+            {
+                parameters[0].Value = record.Key;
+                parameters[1].Value = record.Source;
+                parameters[2].Value = label;
+                parameters[3].Value = (object?)record.Backend ?? DBNull.Value;
+                parameters[4].Value = (object?)record.GameDomain ?? DBNull.Value;
+                parameters[5].Value = (object?)record.ModId ?? DBNull.Value;
+                parameters[6].Value = (object?)record.FileId ?? DBNull.Value;
+                parameters[7].Value = (object?)record.Name ?? DBNull.Value;
+                parameters[8].Value = (object?)record.Author ?? DBNull.Value;
+                parameters[9].Value = (object?)record.ArchivePath ?? DBNull.Value;
+                parameters[10].Value = (object?)record.ArchiveHash ?? DBNull.Value;
+                parameters[11].Value = (object?)record.UploadedAt ?? DBNull.Value;
+                await cmd.ExecuteNonQueryAsync(ct);
+            }
+        }
+
+        await transaction.CommitAsync(ct);
+    }
+
+    private static IdentityRecord ReadRecord(SqliteDataReader reader) => new()
+    {
+        Key = reader.GetString(0),
+        Source = reader.GetString(1),
+        Backend = reader.IsDBNull(3) ? null : reader.GetString(3),
+        GameDomain = reader.IsDBNull(4) ? null : reader.GetString(4),
+        ModId = reader.IsDBNull(5) ? null : reader.GetString(5),
+        FileId = reader.IsDBNull(6) ? null : reader.GetString(6),
+        Name = reader.IsDBNull(7) ? null : reader.GetString(7),
+        Author = reader.IsDBNull(8) ? null : reader.GetString(8),
+        ArchivePath = reader.IsDBNull(9) ? null : reader.GetString(9),
+        ArchiveHash = reader.IsDBNull(10) ? null : reader.GetString(10),
+        UploadedAt = reader.IsDBNull(11) ? null : reader.GetInt64(11)
+    };
+}
@@ -0,0 +1,480 @@
+using System.Security.Cryptography;
+using System.Text.Json;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Utilities;
+using ZstdSharp;
+
+namespace Modular.Core.Installers;
+
+/// <summary>
+/// Content-addressed store for game files overwritten by mod installs. Each
+/// original is kept once, by SHA-256, however many changesets replaced it:
+/// <code>
+/// vault/
+///   objects/3f/3fa2...e1.zst   zstd-compressed original
+///   objects/9c/9c04...7b.raw   stored as-is, compression didn't pay off
+///   refs/&lt;changeset&gt;.json   originals a changeset needs to restore
+/// </code>
+/// Objects are written outside the vault lock, so installs hashing and
+/// compressing large originals don't wait on each other; the lock only
+/// covers reading and writing refs. An object is removed once no
+/// changeset's refs mention it.
+/// </summary>
+public class BackupVault
+{
+    private const string ObjectsDirectoryName = "objects";
+    private const string RefsDirectoryName = "refs";
+    private const string LockFileName = ".lock";
+    private const string CompressedExtension = ".zst";
+    private const string RawExtension = ".raw";
+
+    // Originals are written once and read rarely, but installs wait on them
+    private const int CompressionLevel = 6;
+
+    // Keep the compressed copy only if it saves at least this much
+    private const double MaxCompressionRatio = 0.95;
+
+    // Suffixes installers give the full copies they leave beside overwritten files
+    private static readonly string[] BackupSuffixes = [".backup", ".modular.bak"];
+
+    private static readonly TimeSpan LockTimeout = TimeSpan.FromSeconds(30);
+
+    // Unreferenced objects and temp files younger than this may belong to a store still in progress
+    private static readonly TimeSpan OrphanGracePeriod = TimeSpan.FromHours(1);
+
+    private static readonly JsonSerializerOptions JsonOptions = new() { WriteIndented = true };
+
+    private readonly ILogger<BackupVault>? _logger;
+
+    public BackupVault(string vaultDirectory, ILogger<BackupVault>? logger = null)
+    {
+        VaultDirectory = vaultDirectory;
+        _logger = logger;
+        Directory.CreateDirectory(ObjectsDirectory);
+        Directory.CreateDirectory(RefsDirectory);
+    }
+
+    /// <summary>
+    /// Root directory of the vault.
+    /// </summary>
+    public string VaultDirectory { get; }
+
+    private string ObjectsDirectory => Path.Combine(VaultDirectory, ObjectsDirectoryName);
+
+    private string RefsDirectory => Path.Combine(VaultDirectory, RefsDirectoryName);
+
+    /// <summary>
+    /// Adds originals to the vault and records them under a changeset.
+    /// </summary>
+    /// <param name="changesetId">Changeset that overwrote the files.</param>
+    /// <param name="originals">Path each original belongs at, mapped to a file holding its content.</param>
+    /// <returns>The vaulted files, in the order given.</returns>
+    public Task<IReadOnlyList<VaultedFile>> StoreAsync(
+        string changesetId,
+        IEnumerable<KeyValuePair<string, string>> originals,
+        CancellationToken ct = default)
+    {
+        var refsPath = RefsPath(changesetId);
+
+        return Task.Run<IReadOnlyList<VaultedFile>>(() =>
+        {
+            var stored = new List<(VaultedFile File, string SourcePath)>();
+            long written = 0;
+
+            foreach (var (targetPath, sourcePath) in originals)
+            {
+                ct.ThrowIfCancellationRequested();
+
+                var hash = ComputeHash(sourcePath);
+                var length = new FileInfo(sourcePath).Length;
+                if (FindObject(hash) == null)
+                    written += WriteObject(hash, sourcePath, length);
+
+                stored.Add((new VaultedFile(targetPath, hash, length), sourcePath));
+            }
+
+            using (Lock())
+            {
+                // A release may have collected an object between writing and referencing it
+                foreach (var (file, sourcePath) in stored)
+                {
+                    if (FindObject(file.Hash) == null)
+                        written += WriteObject(file.Hash, sourcePath, file.Length);
+                }
+
+                var entries = ReadRefs(refsPath);
+                entries.AddRange(stored.Select(s => s.File));
+                WriteRefs(refsPath, entries);
+            }
+
+            _logger?.LogInformation(
+                "Vaulted {Count} originals for changeset {ChangesetId} ({Bytes:N0} new bytes)",
+                stored.Count, changesetId, written);
+            return stored.Select(s => s.File).ToList();
+        }, ct);
+    }
+
+    /// <summary>
+    /// Moves the backup copies an installer left beside overwritten files
+    /// (<c>file.ext.backup</c>, <c>file.ext.modular.bak</c>) into the vault
+    /// and deletes them. Paths without a known backup suffix are skipped.
+    /// </summary>
+    public async Task<IReadOnlyList<VaultedFile>> AdoptBackupsAsync(
+        string changesetId,
+        IEnumerable<string> backupPaths,
+        CancellationToken ct = default)
+    {
+        var originals = new List<KeyValuePair<string, string>>();
+        foreach (var backupPath in backupPaths)
+        {
+            var suffix = BackupSuffixes.FirstOrDefault(s => backupPath.EndsWith(s, StringComparison.Ordinal));
+            if (suffix != null && File.Exists(backupPath))
+                originals.Add(new(backupPath[..^suffix.Length], backupPath));
+        }
+
+        if (originals.Count == 0)
+            return [];
+
+        var stored = await StoreAsync(changesetId, originals, ct);
+        foreach (var (_, backupPath) in originals)
+            File.Delete(backupPath);
+
+        return stored;
+    }
+
+    /// <summary>
+    /// Restores every original recorded for a changeset. Returns the number
+    /// of files restored.
+    /// </summary>
+    public async Task<int> RestoreChangesetAsync(string changesetId, CancellationToken ct = default)
+    {
+        var files = GetFiles(changesetId);
+        foreach (var file in files)
+            await RestoreAsync(file, ct);
+
+        return files.Count;
+    }
+
+    /// <summary>
+    /// Originals recorded for a changeset.
+    /// </summary>
+    public IReadOnlyList<VaultedFile> GetFiles(string changesetId) => ReadRefs(RefsPath(changesetId));
+
+    /// <summary>
+    /// Writes an original back to <see cref="VaultedFile.TargetPath"/>,
+    /// replacing whatever is there. Uncompressed objects are reflinked where
+    /// the filesystem allows it; everything else is streamed and verified.
+    /// </summary>
+    public Task RestoreAsync(VaultedFile file, CancellationToken ct = default)
+    {
+        return Task.Run(async () =>
+        {
+            var objectPath = FindObject(file.Hash)
+                ?? throw new FileNotFoundException($"Vault object {file.Hash} for {file.TargetPath} is missing");
+
+            var targetDir = Path.GetDirectoryName(file.TargetPath);
+            if (!string.IsNullOrEmpty(targetDir))
+                Directory.CreateDirectory(targetDir);
+
+            var tempPath = $"{file.TargetPath}.{Guid.NewGuid():N}.restore";
+            try
+            {
+                if (!(objectPath.EndsWith(RawExtension, StringComparison.Ordinal) && TryReflink(objectPath, tempPath)))
+                    await CopyVerifiedAsync(objectPath, tempPath, file.Hash, ct);
+
+                File.Move(tempPath, file.TargetPath, overwrite: true);
+            }
+            finally
+            {
+                if (File.Exists(tempPath))
+                    File.Delete(tempPath);
+            }
+        }, ct);
+    }
+
+    /// <summary>
+    /// Drops a changeset's references and removes objects no other
+    /// changeset refers to. Returns the number of objects removed.
+    /// </summary>
+    public int Release(string changesetId)
+    {
+        var refsPath = RefsPath(changesetId);
+
+        using var _ = Lock();
+        if (!File.Exists(refsPath))
+            return 0;
+
+        var candidates = ReadRefs(refsPath).Select(f => f.Hash).ToHashSet(StringComparer.Ordinal);
+        File.Delete(refsPath);
+        var live = LiveHashes();
+        candidates.ExceptWith(live);
+
+        var removed = 0;
+        foreach (var hash in candidates)
+        {
+            var objectPath = FindObject(hash);
+            if (objectPath == null)
+                continue;
+
+            File.Delete(objectPath);
+            removed++;
+        }
+
+        _logger?.LogInformation("Released changeset {ChangesetId}, removed {Count} vault objects", changesetId, removed);
+        RemoveOrphans(live);
+        return removed;
+    }
+
+    /// <summary>
+    /// Removes objects no changeset refers to and temp files left behind,
+    /// e.g. by a crash between writing an object and recording its refs.
+    /// Returns the number of files removed.
+    /// </summary>
+    public int CollectGarbage()
+    {
+        using var _ = Lock();
+        return RemoveOrphans(LiveHashes());
+    }
+
+    // Skips recent files, which may belong to a store that hasn't reached its refs yet
+    private int RemoveOrphans(HashSet<string> live)
+    {
+        var cutoff = DateTime.UtcNow - OrphanGracePeriod;
+        var removed = 0;
+
+        foreach (var path in Directory.EnumerateFiles(ObjectsDirectory, "*", SearchOption.AllDirectories))
+        {
+            var name = Path.GetFileName(path);
+            var isObject = name.EndsWith(CompressedExtension, StringComparison.Ordinal) ||
+                           name.EndsWith(RawExtension, StringComparison.Ordinal);
+            if (isObject && live.Contains(Path.GetFileNameWithoutExtension(name)))
+                continue;
+
+            try
+            {
+                if (File.GetLastWriteTimeUtc(path) >= cutoff)
+                    continue;
+
+                File.Delete(path);
+                removed++;
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                _logger?.LogDebug(ex, "Could not remove orphaned vault file {Path}", path);
+            }
+        }
+
+        if (removed > 0)
+            _logger?.LogInformation("Removed {Count} orphaned vault files", removed);
+        return removed;
+    }
+
+    /// <summary>
+    /// Number of changeset references to an object.
+    /// </summary>
+    public int GetReferenceCount(string hash)
+    {
+        using var _ = Lock();
+        return EnumerateRefs().Sum(refs => refs.Count(f => f.Hash == hash));
+    }
+
+    /// <summary>
+    /// Object count and sizes, for diagnostics.
+    /// </summary>
+    public BackupVaultStats GetStats()
+    {
+        var stats = new BackupVaultStats();
+        foreach (var path in Directory.EnumerateFiles(ObjectsDirectory, "*", SearchOption.AllDirectories))
+        {
+            if (!path.EndsWith(CompressedExtension, StringComparison.Ordinal) &&
+                !path.EndsWith(RawExtension, StringComparison.Ordinal))
+                continue;
+
+            stats.ObjectCount++;
+            stats.StoredBytes += new FileInfo(path).Length;
+            if (path.EndsWith(CompressedExtension, StringComparison.Ordinal))
+                stats.CompressedObjectCount++;
+        }
+
+        return stats;
+    }
+
+    /// <summary>
+    /// Compresses a new original into the objects directory, or keeps it
+    /// uncompressed if compression barely helps (archives, encoded media).
+    /// The object is written to a temp file, flushed and renamed to its hash,
+    /// so it needs no lock; when two stores race, the first rename wins.
+    /// Returns the bytes written.
+    /// </summary>
+    private long WriteObject(string hash, string sourcePath, long length)
+    {
+        var directory = Path.Combine(ObjectsDirectory, hash[..2]);
+        Directory.CreateDirectory(directory);
+        var tempPath = Path.Combine(directory, $"{hash}.{Guid.NewGuid():N}.tmp");
+
+        try
+        {
+            using (var source = new FileStream(sourcePath, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 16, FileOptions.SequentialScan))
+            using (var destination = new FileStream(tempPath, FileMode.CreateNew, FileAccess.Write, FileShare.None, 1 << 16))
+            {
+                using (var zstd = new CompressionStream(destination, CompressionLevel, leaveOpen: true))
+                    source.CopyTo(zstd);
+                destination.Flush(flushToDisk: true);
+            }
+
+            var extension = CompressedExtension;
+            if (new FileInfo(tempPath).Length > length * MaxCompressionRatio)
+            {
+                File.Delete(tempPath);
+                if (!TryReflink(sourcePath, tempPath))
+                    File.Copy(sourcePath, tempPath);
+                DurableFile.FlushFile(tempPath);
+                extension = RawExtension;
+            }
+
+            var objectPath = Path.Combine(directory, hash + extension);
+            try
+            {
+                File.Move(tempPath, objectPath);
+            }
+            catch (IOException) when (File.Exists(objectPath))
+            {
+                // Another store wrote the same content first
+                return 0;
+            }
+
+            DurableFile.FlushDirectory(directory);
+            return new FileInfo(objectPath).Length;
+        }
+        finally
+        {
+            if (File.Exists(tempPath))
+                File.Delete(tempPath);
+        }
+    }
+
+    private static async Task CopyVerifiedAsync(string objectPath, string destinationPath, string expectedHash, CancellationToken ct)
+    {
+        using var hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+        var buffer = new byte[1 << 16];
+
+        await using (var stored = new FileStream(objectPath, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 16, FileOptions.SequentialScan))
+        await using (var source = objectPath.EndsWith(CompressedExtension, StringComparison.Ordinal)
+            ? new DecompressionStream(stored, leaveOpen: true)
+            : (Stream)stored)
+        await using (var destination = new FileStream(destinationPath, FileMode.CreateNew, FileAccess.Write, FileShare.None, 1 << 16))
+        {
+            int read;
+            while ((read = await source.ReadAsync(buffer, ct)) > 0)
+            {
+                hash.AppendData(buffer, 0, read);
+                await destination.WriteAsync(buffer.AsMemory(0, read), ct);
+            }
+        }
+
+        var actual = Convert.ToHexString(hash.GetHashAndReset()).ToLowerInvariant();
+        if (actual != expectedHash)
+            throw new InvalidDataException($"Vault object {expectedHash} is corrupt (content hashes to {actual})");
+    }
+
+    private static bool TryReflink(string sourcePath, string destinationPath)
+    {
+        using var source = File.OpenHandle(sourcePath, FileMode.Open, FileAccess.Read, FileShare.Read);
+        bool cloned;
+        using (var destination = File.OpenHandle(destinationPath, FileMode.CreateNew, FileAccess.Write))
+            cloned = FileClone.TryReflink(source, destination);
+
+        if (!cloned)
+            File.Delete(destinationPath);
+        return cloned;
+    }
+
+    private static string ComputeHash(string path)
+    {
+        using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 16, FileOptions.SequentialScan);
+        return Convert.ToHexString(SHA256.HashData(stream)).ToLowerInvariant();
+    }
+
+    private string? FindObject(string hash)
+    {
+        var directory = Path.Combine(ObjectsDirectory, hash[..2]);
+        var compressed = Path.Combine(directory, hash + CompressedExtension);
+        if (File.Exists(compressed))
+            return compressed;
+
+        var raw = Path.Combine(directory, hash + RawExtension);
+        return File.Exists(raw) ? raw : null;
+    }
+
+    private HashSet<string> LiveHashes() =>
+        EnumerateRefs().SelectMany(refs => refs.Select(f => f.Hash)).ToHashSet(StringComparer.Ordinal);
+
+    private IEnumerable<List<VaultedFile>> EnumerateRefs() =>
+        Directory.EnumerateFiles(RefsDirectory, "*.json").Select(ReadRefs);
+
+    private static List<VaultedFile> ReadRefs(string path)
+    {
+        if (!File.Exists(path))
+            return new List<VaultedFile>();
+
+        return JsonSerializer.Deserialize<List<VaultedFile>>(File.ReadAllText(path), JsonOptions)
+            ?? new List<VaultedFile>();
+    }
+
+    private void WriteRefs(string path, List<VaultedFile> entries)
+    {
+        var tempPath = $"{path}.{Guid.NewGuid():N}.tmp";
+        File.WriteAllText(tempPath, JsonSerializer.Serialize(entries, JsonOptions));
+        DurableFile.FlushFile(tempPath);
+        File.Move(tempPath, path, overwrite: true);
+        DurableFile.FlushDirectory(RefsDirectory);
+    }
+
+    private string RefsPath(string changesetId)
+    {
+        if (string.IsNullOrWhiteSpace(changesetId) || changesetId != FileUtils.SanitizeFilename(changesetId) ||
+            changesetId.Contains('/') || changesetId.Contains('\\') || changesetId.StartsWith('.'))
+            throw new ArgumentException($"Invalid changeset ID: '{changesetId}'", nameof(changesetId));
+
+        return Path.Combine(RefsDirectory, changesetId + ".json");
+    }
+
+    /// <summary>
+    /// Process-exclusive lock on the vault, held while references change.
+    /// </summary>
+    private FileStream Lock()
+    {
+        var path = Path.Combine(VaultDirectory, LockFileName);
+        var deadline = DateTime.UtcNow + LockTimeout;
+
+        while (true)
+        {
+            try
+            {
+                return new FileStream(path, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.None, bufferSize: 1);
+            }
+            catch (IOException) when (DateTime.UtcNow < deadline)
+            {
+                Thread.Sleep(5);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// An original file kept in the <see cref="BackupVault"/>.
+/// </summary>
+/// <param name="TargetPath">Where the original is restored to.</param>
+/// <param name="Hash">Lowercase SHA-256 of its content.</param>
+/// <param name="Length">Uncompressed size in bytes.</param>
+public sealed record VaultedFile(string TargetPath, string Hash, long Length);
+
+/// <summary>
+/// Size of a <see cref="BackupVault"/>.
+/// </summary>
+public class BackupVaultStats
+{
+    public int ObjectCount { get; set; }
+    public int CompressedObjectCount { get; set; }
+    public long StoredBytes { get; set; }
+}
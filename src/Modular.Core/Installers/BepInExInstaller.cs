@@ -180,6 +180,7 @@ public class BepInExInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(plan.TargetDirectory);
 
             foreach (var operation in plan.Operations)
             {
@@ -189,7 +190,7 @@ public class BepInExInstaller : IModInstaller
                 if (entry == null)
                     continue;
 
-                var destPath = PathSanitizer.SanitizeEntryPath(operation.DestinationPath, plan.TargetDirectory);
+                var destPath = paths.SanitizeEntryPath(operation.DestinationPath);
 
                 // Create directory
                 var destDir = Path.GetDirectoryName(destPath);
@@ -206,6 +207,7 @@ public class BepInExInstaller : IModInstaller
 
                 // Extract file
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(destPath);
 
                 filesProcessed++;
@@ -195,6 +195,7 @@ public class CyberpunkModInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(plan.TargetDirectory);
 
             foreach (var operation in plan.Operations)
             {
@@ -207,8 +208,7 @@ public class CyberpunkModInstaller : IModInstaller
                 string destPath;
                 try
                 {
-                    destPath = PathSanitizer.SanitizeEntryPath(
-                        operation.DestinationPath, plan.TargetDirectory);
+                    destPath = paths.SanitizeEntryPath(operation.DestinationPath);
                 }
                 catch (InvalidOperationException ex)
                 {
@@ -234,6 +234,7 @@ public class CyberpunkModInstaller : IModInstaller
 
                 // Extract
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(operation.DestinationPath); // store relative path
 
                 filesProcessed++;
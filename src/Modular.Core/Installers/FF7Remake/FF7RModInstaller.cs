@@ -202,6 +202,7 @@ public class FF7RModInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(plan.TargetDirectory);
 
             foreach (var operation in plan.Operations)
             {
@@ -216,8 +217,7 @@ public class FF7RModInstaller : IModInstaller
                 string destPath;
                 try
                 {
-                    destPath = PathSanitizer.SanitizeEntryPath(
-                        operation.DestinationPath, plan.TargetDirectory);
+                    destPath = paths.SanitizeEntryPath(operation.DestinationPath);
                 }
                 catch (InvalidOperationException ex)
                 {
@@ -245,6 +245,7 @@ public class FF7RModInstaller : IModInstaller
                 }
 
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(operation.DestinationPath);
 
                 filesProcessed++;
@@ -162,6 +162,7 @@ public class FomodInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(plan.TargetDirectory);
 
             foreach (var filePath in selectedFiles)
             {
@@ -171,13 +172,14 @@ public class FomodInstaller : IModInstaller
                 if (entry == null)
                     continue;
 
-                var destPath = PathSanitizer.SanitizeEntryPath(entry.Name, plan.TargetDirectory);
+                var destPath = paths.SanitizeEntryPath(entry.Name);
 
                 var destDir = Path.GetDirectoryName(destPath);
                 if (!string.IsNullOrEmpty(destDir) && !Directory.Exists(destDir))
                     Directory.CreateDirectory(destDir);
 
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(destPath);
 
                 filesProcessed++;
@@ -187,6 +187,7 @@ public class HZDModInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(plan.TargetDirectory);
 
             foreach (var operation in plan.Operations)
             {
@@ -200,8 +201,7 @@ public class HZDModInstaller : IModInstaller
                 string destPath;
                 try
                 {
-                    destPath = PathSanitizer.SanitizeEntryPath(
-                        operation.DestinationPath, plan.TargetDirectory);
+                    destPath = paths.SanitizeEntryPath(operation.DestinationPath);
                 }
                 catch (InvalidOperationException ex)
                 {
@@ -227,6 +227,7 @@ public class HZDModInstaller : IModInstaller
                 }
 
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(operation.DestinationPath);
 
                 filesProcessed++;
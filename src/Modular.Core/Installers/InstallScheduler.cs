@@ -0,0 +1,561 @@
+using Microsoft.Extensions.Logging;
+using Modular.Core.Utilities;
+using Modular.Sdk.Installers;
+
+namespace Modular.Core.Installers;
+
+/// <summary>
+/// Queues install, uninstall and batch work and runs it with a per-device
+/// I/O budget: operations targeting different block devices run in parallel,
+/// a spinning disk gets one operation at a time, and an SSD a few. Operations
+/// on the same target directory always run one after another in priority
+/// order, since later mods may overwrite files from earlier ones.
+/// </summary>
+public sealed class InstallScheduler : IDisposable
+{
+    private readonly InstallSchedulerOptions _options;
+    private readonly ILogger<InstallScheduler>? _logger;
+    private readonly object _lock = new();
+    private readonly Dictionary<string, DeviceLane> _lanes = new(StringComparer.Ordinal);
+    private readonly HashSet<string> _busyTargets = new(StringComparer.Ordinal);
+    private readonly List<ScheduledInstall> _batch = new();
+    private readonly CancellationTokenSource _shutdown = new();
+    private TaskCompletionSource _idle = CompletedIdle();
+    private long _sequence;
+    private bool _disposed;
+
+    /// <summary>
+    /// Raised whenever an operation is queued, starts, reports progress or
+    /// finishes. May be raised from any thread.
+    /// </summary>
+    public event EventHandler<InstallSchedulerProgress>? ProgressChanged;
+
+    public InstallScheduler(InstallSchedulerOptions? options = null, ILogger<InstallScheduler>? logger = null)
+    {
+        _options = options ?? new InstallSchedulerOptions();
+        _logger = logger;
+    }
+
+    /// <summary>
+    /// Queues an operation. It starts as soon as its device has a free slot and
+    /// no other operation on the same target directory is running.
+    /// </summary>
+    /// <param name="name">Display name (archive or mod name).</param>
+    /// <param name="targetDirectory">Directory the operation writes to; decides the device lane.</param>
+    /// <param name="work">The operation. Report progress as <see cref="InstallProgress.Percentage"/>.</param>
+    /// <param name="priority">Higher runs first among queued operations on the same device.</param>
+    /// <param name="ct">Cancels the operation, whether queued or running.</param>
+    public ScheduledInstall<T> Schedule<T>(
+        string name,
+        string targetDirectory,
+        Func<IProgress<InstallProgress>, CancellationToken, Task<T>> work,
+        int priority = 0,
+        CancellationToken ct = default)
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+        ArgumentException.ThrowIfNullOrEmpty(targetDirectory);
+
+        var target = Path.TrimEndingDirectorySeparator(Path.GetFullPath(targetDirectory));
+        var device = (_options.DeviceResolver ?? ResolveDevice)(target);
+
+        var operation = new ScheduledInstall<T>(this, name, target, device.Key, priority, work,
+            CancellationTokenSource.CreateLinkedTokenSource(_shutdown.Token, ct));
+
+        lock (_lock)
+        {
+            if (_batch.Count == 0 || _batch.TrueForAll(o => o.IsFinished))
+            {
+                _batch.Clear();
+                _idle = new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+            }
+
+            operation.Sequence = _sequence++;
+            _batch.Add(operation);
+
+            if (!_lanes.TryGetValue(device.Key, out var lane))
+            {
+                lane = new DeviceLane(device.Key, ConcurrencyFor(device));
+                _lanes[device.Key] = lane;
+                _logger?.LogDebug("Device lane {Device}: {Slots} slot(s), rotational={Rotational}",
+                    device.Key, lane.Slots, device.Rotational);
+            }
+
+            lane.Pending.Add(operation);
+        }
+
+        operation.RegisterCancellation();
+        Pump(device.Key);
+        RaiseProgress();
+        return operation;
+    }
+
+    /// <summary>
+    /// Snapshot of the current batch: everything queued since the scheduler was last idle.
+    /// </summary>
+    public InstallSchedulerProgress GetProgress()
+    {
+        lock (_lock)
+        {
+            return InstallSchedulerProgress.From(_batch);
+        }
+    }
+
+    /// <summary>
+    /// Completes when every queued and running operation has finished.
+    /// </summary>
+    public Task WhenIdleAsync()
+    {
+        lock (_lock)
+        {
+            return _idle.Task;
+        }
+    }
+
+    /// <summary>
+    /// Cancels every queued and running operation.
+    /// </summary>
+    public void CancelAll()
+    {
+        List<ScheduledInstall> operations;
+        lock (_lock)
+        {
+            operations = _batch.ToList();
+        }
+
+        foreach (var operation in operations)
+            operation.Cancel();
+    }
+
+    /// <summary>
+    /// Resolves the lane for a path: the device id of the nearest existing
+    /// ancestor, or the path root where device ids are unavailable.
+    /// </summary>
+    public static InstallDevice ResolveDevice(string path)
+    {
+        for (var dir = path; !string.IsNullOrEmpty(dir); dir = Path.GetDirectoryName(dir))
+        {
+            if (!Directory.Exists(dir))
+                continue;
+
+            if (FileStat.TryGetDevice(dir, out var device))
+                return new InstallDevice($"dev:{device}", StorageDevices.IsRotational(new FileStat(device, 0, 0, 0)));
+
+            break;
+        }
+
+        return new InstallDevice($"root:{Path.GetPathRoot(path)}", null);
+    }
+
+    private int ConcurrencyFor(InstallDevice device) => device.Rotational switch
+    {
+        true => _options.RotationalConcurrency,
+        false => _options.SolidStateConcurrency,
+        null => _options.UnknownDeviceConcurrency
+    };
+
+    /// <summary>
+    /// Starts as many queued operations on a lane as it has free slots for.
+    /// </summary>
+    private void Pump(string laneKey)
+    {
+        var toStart = new List<ScheduledInstall>();
+
+        lock (_lock)
+        {
+            var lane = _lanes[laneKey];
+            lane.Pending.RemoveAll(o => o.IsFinished);
+
+            while (lane.Running < lane.Slots)
+            {
+                ScheduledInstall? next = null;
+                foreach (var candidate in lane.Pending)
+                {
+                    if (_busyTargets.Contains(candidate.TargetDirectory))
+                        continue;
+                    if (next == null || candidate.Priority > next.Priority ||
+                        (candidate.Priority == next.Priority && candidate.Sequence < next.Sequence))
+                        next = candidate;
+                }
+
+                if (next == null)
+                    break;
+
+                lane.Pending.Remove(next);
+                lane.Running++;
+                _busyTargets.Add(next.TargetDirectory);
+                next.State = ScheduledInstallState.Running;
+                toStart.Add(next);
+            }
+        }
+
+        // Installs do plenty of synchronous I/O, keep it off the caller's (UI) thread
+        foreach (var operation in toStart)
+            _ = Task.Run(() => RunAsync(operation));
+    }
+
+    private async Task RunAsync(ScheduledInstall operation)
+    {
+        _logger?.LogInformation("Starting {Name} on {Device}", operation.Name, operation.DeviceKey);
+        RaiseProgress();
+
+        try
+        {
+            await operation.ExecuteAsync();
+        }
+        finally
+        {
+            lock (_lock)
+            {
+                _lanes[operation.DeviceKey].Running--;
+                _busyTargets.Remove(operation.TargetDirectory);
+            }
+
+            _logger?.LogInformation("Finished {Name}: {State}", operation.Name, operation.State);
+            OnFinished(operation);
+        }
+    }
+
+    /// <summary>
+    /// Removes a still-queued operation. Returns false if it has already started,
+    /// in which case the work itself observes the cancellation.
+    /// </summary>
+    internal bool TryCancelQueued(ScheduledInstall operation)
+    {
+        lock (_lock)
+        {
+            if (operation.State != ScheduledInstallState.Queued)
+                return false;
+
+            operation.State = ScheduledInstallState.Cancelled;
+            _lanes[operation.DeviceKey].Pending.Remove(operation);
+        }
+
+        OnFinished(operation);
+        return true;
+    }
+
+    private void OnFinished(ScheduledInstall operation)
+    {
+        Pump(operation.DeviceKey);
+        RaiseProgress();
+
+        lock (_lock)
+        {
+            if (_batch.TrueForAll(o => o.IsFinished))
+                _idle.TrySetResult();
+        }
+    }
+
+    internal void RaiseProgress()
+    {
+        var handler = ProgressChanged;
+        if (handler != null)
+            handler(this, GetProgress());
+    }
+
+    private static TaskCompletionSource CompletedIdle()
+    {
+        var tcs = new TaskCompletionSource();
+        tcs.SetResult();
+        return tcs;
+    }
+
+    public void Dispose()
+    {
+        if (_disposed) return;
+        _disposed = true;
+
+        _shutdown.Cancel();
+        _shutdown.Dispose();
+    }
+
+    private sealed class DeviceLane
+    {
+        public DeviceLane(string key, int slots)
+        {
+            Key = key;
+            Slots = Math.Max(1, slots);
+        }
+
+        public string Key { get; }
+        public int Slots { get; }
+        public int Running { get; set; }
+        public List<ScheduledInstall> Pending { get; } = new();
+    }
+}
+
+/// <summary>
+/// Per-device concurrency budgets for <see cref="InstallScheduler"/>.
+/// </summary>
+public sealed class InstallSchedulerOptions
+{
+    /// <summary>
+    /// Concurrent operations on a spinning disk. Two writers interleaving on
+    /// one HDD spend their time seeking, so the default is one.
+    /// </summary>
+    public int RotationalConcurrency { get; init; } = 1;
+
+    /// <summary>
+    /// Concurrent operations on a solid-state device.
+    /// </summary>
+    public int SolidStateConcurrency { get; init; } = Math.Clamp(Environment.ProcessorCount / 2, 2, 4);
+
+    /// <summary>
+    /// Concurrent operations when the device type can't be determined
+    /// (network filesystems, non-Linux platforms).
+    /// </summary>
+    public int UnknownDeviceConcurrency { get; init; } = 2;
+
+    /// <summary>
+    /// Overrides how target directories map to devices. Defaults to
+    /// <see cref="InstallScheduler.ResolveDevice"/>.
+    /// </summary>
+    public Func<string, InstallDevice>? DeviceResolver { get; init; }
+}
+
+/// <summary>
+/// A device lane: operations with the same key share one I/O budget.
+/// </summary>
+/// <param name="Key">Device identity.</param>
+/// <param name="Rotational">True for spinning disks, false for SSDs, null if unknown.</param>
+public readonly record struct InstallDevice(string Key, bool? Rotational);
+
+public enum ScheduledInstallState
+{
+    Queued,
+    Running,
+    Succeeded,
+    Failed,
+    Cancelled
+}
+
+/// <summary>
+/// An operation queued on an <see cref="InstallScheduler"/>.
+/// </summary>
+public abstract class ScheduledInstall
+{
+    private readonly InstallScheduler _scheduler;
+    private readonly CancellationTokenSource _cts;
+    private double _percentage;
+
+    private protected ScheduledInstall(
+        InstallScheduler scheduler, string name, string targetDirectory, string deviceKey,
+        int priority, CancellationTokenSource cts)
+    {
+        _scheduler = scheduler;
+        _cts = cts;
+        Name = name;
+        TargetDirectory = targetDirectory;
+        DeviceKey = deviceKey;
+        Priority = priority;
+    }
+
+    public string Name { get; }
+    public string TargetDirectory { get; }
+    public string DeviceKey { get; }
+    public int Priority { get; }
+    public ScheduledInstallState State { get; internal set; } = ScheduledInstallState.Queued;
+
+    /// <summary>
+    /// Last reported progress, 0-100.
+    /// </summary>
+    public double Percentage => Volatile.Read(ref _percentage);
+
+    /// <summary>
+    /// Last reported operation description.
+    /// </summary>
+    public string? CurrentOperation { get; private set; }
+
+    internal long Sequence { get; set; }
+
+    internal bool IsFinished => State is ScheduledInstallState.Succeeded or ScheduledInstallState.Failed or ScheduledInstallState.Cancelled;
+
+    /// <summary>
+    /// Completes when the operation finishes, is cancelled or fails.
+    /// </summary>
+    public abstract Task Completion { get; }
+
+    /// <summary>
+    /// Cancels the operation. A queued operation is removed without running.
+    /// </summary>
+    public void Cancel()
+    {
+        try
+        {
+            _cts.Cancel();
+        }
+        catch (ObjectDisposedException)
+        {
+            // Already finished
+        }
+    }
+
+    internal void RegisterCancellation()
+    {
+        var token = _cts.Token;
+        token.Register(() =>
+        {
+            if (!_scheduler.TryCancelQueued(this))
+                return;
+
+            SetCancelled(token);
+            _cts.Dispose();
+        });
+    }
+
+    internal async Task ExecuteAsync()
+    {
+        var progress = new SynchronousProgress(p =>
+        {
+            // Status-only reports ("Scanning archive...") carry no file counts
+            if (p.TotalFiles > 0)
+                Volatile.Write(ref _percentage, Math.Clamp(p.Percentage, 0, 100));
+            CurrentOperation = p.CurrentOperation;
+            _scheduler.RaiseProgress();
+        });
+
+        try
+        {
+            await RunWorkAsync(progress, _cts.Token);
+            Volatile.Write(ref _percentage, 100);
+            State = ScheduledInstallState.Succeeded;
+        }
+        catch (OperationCanceledException) when (_cts.IsCancellationRequested)
+        {
+            State = ScheduledInstallState.Cancelled;
+            SetCancelled(_cts.Token);
+        }
+        catch (Exception ex)
+        {
+            State = ScheduledInstallState.Failed;
+            SetFailed(ex);
+        }
+        finally
+        {
+            _cts.Dispose();
+        }
+    }
+
+    private protected abstract Task RunWorkAsync(IProgress<InstallProgress> progress, CancellationToken ct);
+    private protected abstract void SetCancelled(CancellationToken ct);
+    private protected abstract void SetFailed(Exception ex);
+
+    /// <summary>
+    /// Reports on the worker's thread; <see cref="Progress{T}"/> would post to
+    /// whatever context scheduled the work and reorder reports.
+    /// </summary>
+    private sealed class SynchronousProgress : IProgress<InstallProgress>
+    {
+        private readonly Action<InstallProgress> _report;
+
+        public SynchronousProgress(Action<InstallProgress> report) => _report = report;
+
+        public void Report(InstallProgress value) => _report(value);
+    }
+}
+
+/// <summary>
+/// An operation queued on an <see cref="InstallScheduler"/> producing a result.
+/// </summary>
+public sealed class ScheduledInstall<T> : ScheduledInstall
+{
+    private readonly Func<IProgress<InstallProgress>, CancellationToken, Task<T>> _work;
+    private readonly TaskCompletionSource<T> _completion = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+    internal ScheduledInstall(
+        InstallScheduler scheduler, string name, string targetDirectory, string deviceKey, int priority,
+        Func<IProgress<InstallProgress>, CancellationToken, Task<T>> work, CancellationTokenSource cts)
+        : base(scheduler, name, targetDirectory, deviceKey, priority, cts)
+    {
+        _work = work;
+    }
+
+    /// <summary>
+    /// The operation's result. Faults with the operation's exception, or is
+    /// cancelled if the operation was.
+    /// </summary>
+    public Task<T> Result => _completion.Task;
+
+    public override Task Completion => _completion.Task;
+
+    private protected override async Task RunWorkAsync(IProgress<InstallProgress> progress, CancellationToken ct)
+    {
+        var result = await _work(progress, ct);
+        _completion.TrySetResult(result);
+    }
+
+    private protected override void SetCancelled(CancellationToken ct) => _completion.TrySetCanceled(ct);
+
+    private protected override void SetFailed(Exception ex) => _completion.TrySetException(ex);
+}
+
+/// <summary>
+/// Aggregate progress of the operations queued since the scheduler was last idle.
+/// </summary>
+public sealed class InstallSchedulerProgress
+{
+    public int Total { get; init; }
+    public int Queued { get; init; }
+    public int Running { get; init; }
+    public int Succeeded { get; init; }
+    public int Failed { get; init; }
+    public int Cancelled { get; init; }
+
+    /// <summary>
+    /// Overall progress, 0-100, with every operation weighted equally.
+    /// </summary>
+    public double Percentage { get; init; }
+
+    /// <summary>
+    /// Names of the operations currently running.
+    /// </summary>
+    public IReadOnlyList<string> RunningNames { get; init; } = Array.Empty<string>();
+
+    public bool IsIdle => Queued == 0 && Running == 0;
+
+    internal static InstallSchedulerProgress From(IReadOnlyCollection<ScheduledInstall> batch)
+    {
+        int queued = 0, running = 0, succeeded = 0, failed = 0, cancelled = 0;
+        double sum = 0;
+        var runningNames = new List<string>();
+
+        foreach (var operation in batch)
+        {
+            switch (operation.State)
+            {
+                case ScheduledInstallState.Queued:
+                    queued++;
+                    break;
+                case ScheduledInstallState.Running:
+                    running++;
+                    runningNames.Add(operation.Name);
+                    sum += operation.Percentage;
+                    break;
+                case ScheduledInstallState.Succeeded:
+                    succeeded++;
+                    sum += 100;
+                    break;
+                case ScheduledInstallState.Failed:
+                    failed++;
+                    sum += 100;
+                    break;
+                case ScheduledInstallState.Cancelled:
+                    cancelled++;
+                    sum += 100;
+                    break;
+            }
+        }
+
+        return new InstallSchedulerProgress
+        {
+            Total = batch.Count,
+            Queued = queued,
+            Running = running,
+            Succeeded = succeeded,
+            Failed = failed,
+            Cancelled = cancelled,
+            Percentage = batch.Count == 0 ? 100 : sum / batch.Count,
+            RunningNames = runningNames
+        };
+    }
+}
@@ -4,6 +4,7 @@ using Modular.Core.Installers.Cyberpunk;
 using Modular.Core.Installers.FF7Remake;
 using Modular.Core.Installers.HorizonZeroDawn;
 using Modular.Core.Installers.Steam;
+using Modular.Core.Resilience;
 using Modular.Core.Telemetry;
 using Modular.Sdk.Archives;
 using Modular.Sdk.Installers;
@@ -18,14 +19,17 @@ public class InstallerManager
     private readonly List<IModInstaller> _installers;
     private readonly ILogger<InstallerManager>? _logger;
     private readonly TelemetryService? _telemetry;
+    private readonly ResilienceEngine _resilience;
 
     public InstallerManager(
         IArchiveReaderFactory? archiveReaderFactory = null,
         ILogger<InstallerManager>? logger = null,
-        TelemetryService? telemetry = null)
+        TelemetryService? telemetry = null,
+        ResilienceEngine? resilience = null)
     {
         _logger = logger;
         _telemetry = telemetry;
+        _resilience = resilience ?? ResilienceEngine.Shared;
         _installers = new List<IModInstaller>();
 
         var factory = archiveReaderFactory ?? new ArchiveReaderFactory();
@@ -88,7 +92,9 @@ public class InstallerManager
         {
             try
             {
-                var result = await installer.DetectAsync(archivePath, ct);
+                // Every installer sees every archive, so one that keeps throwing is switched off for a while
+                var result = await _resilience.ExecuteAsync(ResilienceCategory.Plugin, installer.InstallerId,
+                    token => installer.DetectAsync(archivePath, token), ct: ct);
                 if (result.CanHandle)
                 {
                     detectionResults.Add((installer, result));
@@ -98,6 +104,10 @@ public class InstallerManager
                         result.Confidence, result.Reason);
                 }
             }
+            catch (CircuitOpenException)
+            {
+                _logger?.LogDebug("Skipping installer {InstallerId}, it failed repeatedly", installer.InstallerId);
+            }
             catch (Exception ex)
             {
                 _logger?.LogError(ex, "Error during detection with installer {InstallerId}",
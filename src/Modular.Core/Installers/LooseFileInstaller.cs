@@ -127,6 +127,7 @@ public class LooseFileInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(plan.TargetDirectory);
 
             foreach (var operation in plan.Operations)
             {
@@ -136,7 +137,7 @@ public class LooseFileInstaller : IModInstaller
                 if (entry == null)
                     continue;
 
-                var destPath = PathSanitizer.SanitizeEntryPath(operation.DestinationPath, plan.TargetDirectory);
+                var destPath = paths.SanitizeEntryPath(operation.DestinationPath);
 
                 // Create directory
                 var destDir = Path.GetDirectoryName(destPath);
@@ -153,6 +154,7 @@ public class LooseFileInstaller : IModInstaller
 
                 // Extract file
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(destPath);
 
                 filesProcessed++;
@@ -6,6 +6,7 @@ using Modular.Core.Dependencies;
 using Modular.Core.GameDetection;
 using Modular.Core.Snapshots;
 using Modular.Core.Telemetry;
+using Modular.Core.Utilities;
 using Modular.Sdk.Installers;
 
 namespace Modular.Core.Installers;
@@ -25,34 +26,69 @@ public class ModInstallationService
     private readonly ModularDatabase _database;
     private readonly TelemetryService? _telemetry;
     private readonly SnapshotManager? _snapshotManager;
+    private readonly BackupVault _backupVault;
     private readonly ILogger<ModInstallationService>? _logger;
 
     public ModInstallationService(
         ModularDatabase database,
         TelemetryService? telemetry = null,
         SnapshotManager? snapshotManager = null,
-        ILogger<ModInstallationService>? logger = null)
+        ILogger<ModInstallationService>? logger = null,
+        BackupVault? backupVault = null)
     {
         _database = database;
         _telemetry = telemetry;
         _snapshotManager = snapshotManager;
         _logger = logger;
 
-        var configDir = Path.Combine(
-            Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
-            ".config", "Modular");
-        var stagingPath = Path.Combine(configDir, "staging");
-
         _installerManager = new InstallerManager(
             archiveReaderFactory: new ArchiveReaderFactory(),
             logger: logger != null ? null : null,
             telemetry: telemetry);
-        _stagingManager = new StagingManager(stagingPath);
+        _stagingManager = new StagingManager(DefaultStagingPath);
+        _backupVault = backupVault ?? new BackupVault(Path.Combine(ConfigDirectory, "vault"));
         _changesetManager = new ChangesetManager(database);
         _archiveInventory = new ArchiveInventoryService(database);
         _conflictIndex = new FileConflictIndex();
     }
 
+    private static string ConfigDirectory => Path.Combine(
+        Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+        ".config", "Modular");
+
+    /// <summary>
+    /// Root of the staging directories installs commit from.
+    /// </summary>
+    public static string DefaultStagingPath => Path.Combine(ConfigDirectory, "staging");
+
+    /// <summary>
+    /// Finishes or undoes staging commits interrupted by a crash (see
+    /// <see cref="StagingManager.RecoverInterruptedCommits"/>). Call once at
+    /// process startup, before any install; services don't do it themselves,
+    /// so recovery never races a commit another service in the process is making.
+    /// </summary>
+    public static IReadOnlyList<StagingRecoveryResult> RecoverInterruptedCommits(ILogger<StagingManager>? logger = null) =>
+        new StagingManager(DefaultStagingPath, logger).RecoverInterruptedCommits();
+
+    /// <summary>
+    /// Creates a service that shares this one's telemetry but works through
+    /// <paramref name="database"/>. A <see cref="ModularDatabase"/> holds a single
+    /// connection, so installs running concurrently (see <see cref="InstallScheduler"/>)
+    /// each need their own.
+    /// </summary>
+    public ModInstallationService WithDatabase(ModularDatabase database)
+    {
+        var snapshots = _snapshotManager != null
+            ? new SnapshotManager(database, new ChangesetManager(database), stateStore: _snapshotManager.StateStore)
+            : null;
+        return new ModInstallationService(database, _telemetry, snapshots, _logger, _backupVault);
+    }
+
+    /// <summary>
+    /// The database this service records changesets in.
+    /// </summary>
+    public ModularDatabase Database => _database;
+
     /// <summary>
     /// Installs a mod archive to a target game directory with full lifecycle tracking.
     /// </summary>
@@ -80,6 +116,15 @@ public class ModInstallationService
             return result;
         }
 
+        // Installers map entries onto the game's on-disk casing; names the game
+        // already has in several casings can't all be seen by it. A dry run
+        // writes nothing, so it doesn't pay for walking the game directory.
+        if (!options.DryRun)
+        {
+            foreach (var collision in CaseFoldingPathIndex.For(targetDirectory).Collisions)
+                _logger?.LogWarning("{Path} exists in several casings: {Names}", collision.Path, string.Join(", ", collision.Names));
+        }
+
         // Step 1: Create changeset record
         var changesetId = await _changesetManager.CreateChangesetAsync(
             modId: options.ModId,
@@ -176,16 +221,20 @@ public class ModInstallationService
                 return result;
             }
 
-            // Step 8: Record operations for rollback
+            // Step 8: Move full backup copies out of the game directory into the vault
+            var vaultedFiles = await VaultBackupsAsync(changesetId, installResult.BackedUpFiles, result, ct);
+
+            // Step 9: Record operations for rollback
             var operationsData = JsonSerializer.Serialize(new
             {
                 installedFiles = installResult.InstalledFiles,
                 backedUpFiles = installResult.BackedUpFiles,
+                vaultedFiles = vaultedFiles.Select(f => f.TargetPath),
                 manifest = installResult.Manifest
             });
             await _changesetManager.UpdateStateAsync(changesetId, ChangesetState.Committed, operationsData, ct);
 
-            // Step 9: Record telemetry
+            // Step 10: Record telemetry
             stopwatch.Stop();
             _telemetry?.RecordInstallerResult(
                 selection.Installer.InstallerId,
@@ -308,6 +357,9 @@ public class ModInstallationService
                 }
             }
 
+            // Restore originals kept in the vault
+            restoredCount += await _backupVault.RestoreChangesetAsync(changesetId, ct);
+
             // Clean up empty directories (bottom-up)
             var dirs = installedFiles
                 .Select(f => Path.GetDirectoryName(Path.Combine(changeset.TargetDirectory, f)))
@@ -327,6 +379,7 @@ public class ModInstallationService
             }
 
             await _changesetManager.UpdateStateAsync(changesetId, ChangesetState.RolledBack, ct: ct);
+            _backupVault.Release(changesetId);
 
             result.Success = true;
             result.FilesRemoved = removedCount;
@@ -366,6 +419,32 @@ public class ModInstallationService
         return result;
     }
 
+    /// <summary>
+    /// Moves an install's backup copies into the vault. If that fails the
+    /// copies stay beside the originals, where uninstall still finds them,
+    /// and the install result says so.
+    /// </summary>
+    private async Task<IReadOnlyList<VaultedFile>> VaultBackupsAsync(
+        string changesetId,
+        IReadOnlyList<string> backedUpFiles,
+        ModInstallationResult result,
+        CancellationToken ct)
+    {
+        if (backedUpFiles.Count == 0)
+            return [];
+
+        try
+        {
+            return await _backupVault.AdoptBackupsAsync(changesetId, backedUpFiles, ct);
+        }
+        catch (Exception ex) when (ex is not OperationCanceledException)
+        {
+            _logger?.LogWarning(ex, "Could not move backups of changeset {Id} into the vault, keeping them in place", changesetId);
+            result.Warnings.Add($"{backedUpFiles.Count} backup file(s) were left beside the originals: {ex.Message}");
+            return [];
+        }
+    }
+
     /// <summary>
     /// Lists all committed (installed) changesets, optionally filtered by target directory.
     /// </summary>
@@ -389,28 +468,26 @@ public class ModInstallationService
 
     /// <summary>
     /// Resolves a Steam AppID or game name to an install directory.
+    /// Served from <see cref="SteamLibraryCache.Shared"/>, so repeated calls in a
+    /// batch do not rescan Steam libraries.
     /// </summary>
-    public static async Task<string?> ResolveGameDirectoryAsync(
+    public static Task<string?> ResolveGameDirectoryAsync(
         string gameIdentifier,
         CancellationToken ct = default)
     {
-        var scanner = new SteamGameScanner(new SteamLibraryScanner(new SteamLocator()));
-        var games = await scanner.ScanAllAsync(ct);
+        ct.ThrowIfCancellationRequested();
+        var cache = SteamLibraryCache.Shared;
 
         // Try exact AppID match
         if (int.TryParse(gameIdentifier, out var appId))
         {
-            var game = games.FirstOrDefault(g => g.AppId == appId);
+            var game = cache.FindByAppId(appId);
             if (game != null)
-                return game.InstallPath;
+                return Task.FromResult<string?>(game.InstallPath);
         }
 
         // Try case-insensitive name match
-        var byName = games.FirstOrDefault(g =>
-            g.DisplayName != null &&
-            g.DisplayName.Contains(gameIdentifier, StringComparison.OrdinalIgnoreCase));
-
-        return byName?.InstallPath;
+        return Task.FromResult(cache.FindByName(gameIdentifier)?.InstallPath);
     }
 
     /// <summary>
@@ -474,6 +551,12 @@ public class ModInstallationResult
     public List<string> InstalledFiles { get; set; } = new();
     public List<string> BackedUpFiles { get; set; } = new();
     public List<string> PlannedOperations { get; set; } = new();
+
+    /// <summary>
+    /// Problems that didn't fail the install.
+    /// </summary>
+    public List<string> Warnings { get; set; } = new();
+
     public string? Error { get; set; }
 }
 
@@ -0,0 +1,188 @@
+using System.Text.Json;
+using System.Text.Json.Serialization;
+
+namespace Modular.Core.Installers;
+
+/// <summary>
+/// The on-disk record of a staging commit, kept in the session's staging
+/// directory. Its state decides what recovery does after a crash:
+/// <list type="bullet">
+/// <item><see cref="StagingCommitState.Preparing"/> - temp files may be
+/// incomplete and no target has been touched; roll back.</item>
+/// <item><see cref="StagingCommitState.Prepared"/> - every temp file and
+/// backup copy is durable; roll forward by redoing the renames.</item>
+/// <item><see cref="StagingCommitState.Committed"/> - only cleanup is left.</item>
+/// </list>
+/// </summary>
+internal static class StagingCommitJournal
+{
+    public const string ManifestFileName = "commit.manifest";
+
+    private static readonly JsonSerializerOptions JsonOptions = new()
+    {
+        WriteIndented = true,
+        Converters = { new JsonStringEnumConverter() }
+    };
+
+    public static string ManifestPath(string stagingDirectory) =>
+        Path.Combine(stagingDirectory, ManifestFileName);
+
+    /// <summary>
+    /// Replaces the manifest atomically and durably.
+    /// </summary>
+    public static void Write(IStagingFileSystem fileSystem, string stagingDirectory, StagingCommitManifest manifest)
+    {
+        var path = ManifestPath(stagingDirectory);
+        var tempPath = path + ".tmp";
+
+        fileSystem.WriteAllText(tempPath, JsonSerializer.Serialize(manifest, JsonOptions));
+        fileSystem.FlushFile(tempPath);
+        fileSystem.Move(tempPath, path);
+        fileSystem.FlushDirectory(stagingDirectory);
+    }
+
+    public static StagingCommitManifest? Read(IStagingFileSystem fileSystem, string stagingDirectory)
+    {
+        var path = ManifestPath(stagingDirectory);
+        if (!fileSystem.FileExists(path))
+            return null;
+
+        // Written by rename after a flush, so it is either absent or complete
+        return JsonSerializer.Deserialize<StagingCommitManifest>(fileSystem.ReadAllText(path), JsonOptions)
+            ?? throw new InvalidDataException($"Empty commit manifest: {path}");
+    }
+
+    /// <summary>
+    /// Renames every prepared file into place, flushes the target
+    /// directories and marks the manifest committed. Safe to repeat: renames
+    /// already done are recognised by their temp file being gone.
+    /// </summary>
+    public static void RollForward(IStagingFileSystem fileSystem, string stagingDirectory, StagingCommitManifest manifest)
+    {
+        foreach (var entry in manifest.Entries)
+        {
+            // Backup first, so the target is never replaced without one
+            if (entry.BackupTempPath != null && fileSystem.FileExists(entry.BackupTempPath))
+                fileSystem.Move(entry.BackupTempPath, entry.BackupPath!);
+
+            if (fileSystem.FileExists(entry.TempPath))
+                fileSystem.Move(entry.TempPath, entry.TargetPath);
+        }
+
+        foreach (var directory in TargetDirectories(manifest))
+            fileSystem.FlushDirectory(directory);
+
+        manifest.State = StagingCommitState.Committed;
+        Write(fileSystem, stagingDirectory, manifest);
+    }
+
+    /// <summary>
+    /// Removes temp files of a commit that never reached
+    /// <see cref="StagingCommitState.Prepared"/>. Targets are untouched.
+    /// </summary>
+    public static void RollBack(IStagingFileSystem fileSystem, StagingCommitManifest manifest)
+    {
+        foreach (var entry in manifest.Entries)
+        {
+            if (fileSystem.FileExists(entry.TempPath))
+                fileSystem.Delete(entry.TempPath);
+            if (entry.BackupTempPath != null && fileSystem.FileExists(entry.BackupTempPath))
+                fileSystem.Delete(entry.BackupTempPath);
+        }
+
+        foreach (var directory in TargetDirectories(manifest))
+        {
+            if (Directory.Exists(directory))
+                fileSystem.FlushDirectory(directory);
+        }
+    }
+
+    /// <summary>
+    /// Finishes or undoes the commit recorded in a staging directory and
+    /// removes the directory. Returns null if there is no manifest.
+    /// </summary>
+    public static StagingRecoveryOutcome? Resolve(IStagingFileSystem fileSystem, string stagingDirectory)
+    {
+        var manifest = Read(fileSystem, stagingDirectory);
+        if (manifest == null)
+            return null;
+
+        StagingRecoveryOutcome outcome;
+        switch (manifest.State)
+        {
+            case StagingCommitState.Preparing:
+                RollBack(fileSystem, manifest);
+                outcome = StagingRecoveryOutcome.RolledBack;
+                break;
+            case StagingCommitState.Prepared:
+                RollForward(fileSystem, stagingDirectory, manifest);
+                outcome = StagingRecoveryOutcome.RolledForward;
+                break;
+            default:
+                outcome = StagingRecoveryOutcome.Completed;
+                break;
+        }
+
+        fileSystem.DeleteDirectory(stagingDirectory);
+        return outcome;
+    }
+
+    private static IEnumerable<string> TargetDirectories(StagingCommitManifest manifest) =>
+        manifest.Entries
+            .Select(e => Path.GetDirectoryName(e.TargetPath))
+            .OfType<string>()
+            .Where(d => d.Length > 0)
+            .Distinct(StringComparer.Ordinal);
+}
+
+internal enum StagingCommitState
+{
+    Preparing,
+    Prepared,
+    Committed
+}
+
+internal sealed class StagingCommitManifest
+{
+    public string ChangesetId { get; set; } = string.Empty;
+    public StagingCommitState State { get; set; }
+    public List<StagingCommitEntry> Entries { get; set; } = new();
+}
+
+internal sealed class StagingCommitEntry
+{
+    public string StagedPath { get; set; } = string.Empty;
+    public string TargetPath { get; set; } = string.Empty;
+
+    /// <summary>
+    /// Copy of the staged file next to the target, renamed over it on commit.
+    /// </summary>
+    public string TempPath { get; set; } = string.Empty;
+
+    public string? BackupPath { get; set; }
+
+    /// <summary>
+    /// Copy of the existing target, renamed to <see cref="BackupPath"/> on commit.
+    /// </summary>
+    public string? BackupTempPath { get; set; }
+}
+
+/// <summary>
+/// What recovery did with an interrupted staging commit.
+/// </summary>
+public enum StagingRecoveryOutcome
+{
+    /// <summary>The commit had not reached its commit point; targets were left as they were.</summary>
+    RolledBack,
+
+    /// <summary>The commit had reached its commit point and was finished.</summary>
+    RolledForward,
+
+    /// <summary>The commit had finished; only its staging directory was left over.</summary>
+    Completed
+}
+
+/// <summary>
+/// Outcome of recovering one staging session.
+/// </summary>
+public sealed record StagingRecoveryResult(string ChangesetId, StagingRecoveryOutcome Outcome);
@@ -0,0 +1,86 @@
+using Modular.Core.Utilities;
+
+namespace Modular.Core.Installers;
+
+/// <summary>
+/// File operations used by the staging commit protocol. Exists so tests can
+/// substitute a filesystem that fails (or "crashes") at a chosen step and
+/// forgets whatever was not flushed, the way a power loss would.
+/// </summary>
+internal interface IStagingFileSystem
+{
+    bool FileExists(string path);
+
+    string ReadAllText(string path);
+
+    void WriteAllText(string path, string contents);
+
+    /// <summary>
+    /// Copies a file, replacing <paramref name="destination"/> if it exists.
+    /// </summary>
+    void Copy(string source, string destination);
+
+    /// <summary>
+    /// Renames a file, replacing <paramref name="destination"/> atomically.
+    /// Both paths must be in the same directory.
+    /// </summary>
+    void Move(string source, string destination);
+
+    /// <summary>
+    /// Moves a file into another directory, replacing <paramref name="destination"/>.
+    /// A rename when both are on one filesystem; across filesystems the file
+    /// is copied and the source deleted.
+    /// </summary>
+    void Relocate(string source, string destination);
+
+    void Delete(string path);
+
+    void CreateDirectory(string path);
+
+    void DeleteDirectory(string path);
+
+    /// <summary>
+    /// Makes a file's data durable.
+    /// </summary>
+    void FlushFile(string path);
+
+    /// <summary>
+    /// Makes entries created, renamed or deleted in a directory durable.
+    /// </summary>
+    void FlushDirectory(string path);
+}
+
+/// <summary>
+/// The real filesystem.
+/// </summary>
+internal sealed class StagingFileSystem : IStagingFileSystem
+{
+    public static readonly StagingFileSystem Instance = new();
+
+    public bool FileExists(string path) => File.Exists(path);
+
+    public string ReadAllText(string path) => File.ReadAllText(path);
+
+    public void WriteAllText(string path, string contents) => File.WriteAllText(path, contents);
+
+    public void Copy(string source, string destination) => File.Copy(source, destination, overwrite: true);
+
+    public void Move(string source, string destination) => File.Move(source, destination, overwrite: true);
+
+    // File.Move already falls back to copy and delete when rename fails with EXDEV
+    public void Relocate(string source, string destination) => File.Move(source, destination, overwrite: true);
+
+    public void Delete(string path) => File.Delete(path);
+
+    public void CreateDirectory(string path) => Directory.CreateDirectory(path);
+
+    public void DeleteDirectory(string path)
+    {
+        if (Directory.Exists(path))
+            Directory.Delete(path, recursive: true);
+    }
+
+    public void FlushFile(string path) => DurableFile.FlushFile(path);
+
+    public void FlushDirectory(string path) => DurableFile.FlushDirectory(path);
+}
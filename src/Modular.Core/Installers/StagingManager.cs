@@ -1,3 +1,4 @@
+using System.Text.Json;
 using Microsoft.Extensions.Logging;
 using Modular.Core.Utilities;
 
@@ -11,6 +12,7 @@ namespace Modular.Core.Installers;
 public class StagingManager
 {
     private readonly string _baseStagingPath;
+    private readonly IStagingFileSystem _fileSystem;
     private readonly ILogger<StagingManager>? _logger;
 
     /// <summary>
@@ -19,12 +21,81 @@ public class StagingManager
     /// <param name="baseStagingPath">Root directory for staging areas (e.g., ~/.config/Modular/staging/).</param>
     /// <param name="logger">Optional logger.</param>
     public StagingManager(string baseStagingPath, ILogger<StagingManager>? logger = null)
+        : this(baseStagingPath, StagingFileSystem.Instance, logger)
+    {
+    }
+
+    internal StagingManager(string baseStagingPath, IStagingFileSystem fileSystem, ILogger<StagingManager>? logger = null)
     {
         _baseStagingPath = baseStagingPath;
+        _fileSystem = fileSystem;
         _logger = logger;
         Directory.CreateDirectory(_baseStagingPath);
     }
 
+    /// <summary>
+    /// Creates the staging directory for a changeset.
+    /// </summary>
+    public StagingSession CreateSession(string changesetId)
+    {
+        var stagingDirectory = Path.Combine(_baseStagingPath, FileUtils.SanitizeFilename(changesetId));
+        Directory.CreateDirectory(stagingDirectory);
+        return new StagingSession(changesetId, stagingDirectory, _fileSystem, _logger);
+    }
+
+    /// <summary>
+    /// Finishes or undoes commits that were interrupted by a crash or power
+    /// loss, based on the manifest each one left in its staging directory.
+    /// Call at startup before installing anything. Sessions still being
+    /// committed by another process are skipped.
+    /// </summary>
+    public IReadOnlyList<StagingRecoveryResult> RecoverInterruptedCommits()
+    {
+        var results = new List<StagingRecoveryResult>();
+
+        foreach (var stagingDirectory in Directory.EnumerateDirectories(_baseStagingPath))
+        {
+            if (!_fileSystem.FileExists(StagingCommitJournal.ManifestPath(stagingDirectory)))
+                continue;
+
+            using var commitLock = StagingSessionLock.TryAcquire(stagingDirectory);
+            if (commitLock == null || !_fileSystem.FileExists(StagingCommitJournal.ManifestPath(stagingDirectory)))
+                continue;
+
+            var changesetId = Path.GetFileName(stagingDirectory);
+            try
+            {
+                var outcome = StagingCommitJournal.Resolve(_fileSystem, stagingDirectory);
+                if (outcome == null)
+                    continue;
+
+                results.Add(new StagingRecoveryResult(changesetId, outcome.Value));
+                _logger?.LogInformation("Recovered staging commit {ChangesetId}: {Outcome}", changesetId, outcome.Value);
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or JsonException or InvalidDataException)
+            {
+                _logger?.LogError(ex, "Failed to recover staging commit {ChangesetId}", changesetId);
+            }
+        }
+
+        RemoveAbandonedLocks();
+        return results;
+    }
+
+    // Lock files of sessions whose process died between removing the staging directory and the lock
+    private void RemoveAbandonedLocks()
+    {
+        var lockDirectory = Path.Combine(_baseStagingPath, StagingSessionLock.DirectoryName);
+        if (!Directory.Exists(lockDirectory))
+            return;
+
+        foreach (var lockFile in Directory.EnumerateFiles(lockDirectory, "*" + StagingSessionLock.Extension))
+        {
+            var stagingDirectory = Path.Combine(_baseStagingPath, Path.GetFileNameWithoutExtension(lockFile));
+            if (!Directory.Exists(stagingDirectory))
+                StagingSessionLock.TryAcquire(stagingDirectory)?.Dispose();
+        }
+    }
 }
 
 /// <summary>
@@ -33,8 +104,10 @@ public class StagingManager
 /// </summary>
 public class StagingSession : IDisposable
 {
+    private readonly IStagingFileSystem _fileSystem;
     private readonly ILogger? _logger;
     private bool _committed;
+    private bool _recoveryPending;
     private bool _disposed;
 
     /// <summary>
@@ -52,10 +125,11 @@ public class StagingSession : IDisposable
     /// </summary>
     public Dictionary<string, string> StagedFiles { get; } = new();
 
-    internal StagingSession(string changesetId, string stagingDirectory, ILogger? logger)
+    internal StagingSession(string changesetId, string stagingDirectory, IStagingFileSystem fileSystem, ILogger? logger)
     {
         ChangesetId = changesetId;
         StagingDirectory = stagingDirectory;
+        _fileSystem = fileSystem;
         _logger = logger;
     }
 
@@ -82,66 +156,200 @@ public class StagingSession : IDisposable
     }
 
     /// <summary>
-    /// Commits all staged files to the target directory by moving them.
-    /// Creates backups of existing files.
+    /// Commits all staged files to the target directory. Creates backups of
+    /// existing files.
     /// </summary>
+    /// <remarks>
+    /// Crash-consistent: each file is first moved next to its target (copied
+    /// only when staging is on another filesystem) and flushed, then a
+    /// manifest is flushed marking the commit prepared, and only then are the
+    /// files renamed over the targets and the target directories flushed. After a crash, <see cref="StagingManager.RecoverInterruptedCommits"/>
+    /// rolls the commit back if it never got prepared and forward otherwise,
+    /// so every target holds either its old or its new content in full.
+    /// </remarks>
     /// <param name="targetDirectory">The final installation target directory.</param>
     /// <param name="createBackups">Whether to back up existing files before overwriting.</param>
+    /// <param name="ct">Stops waiting for a recovery of this session running elsewhere.</param>
     /// <returns>Commit result with lists of installed and backed-up files.</returns>
-    public StagingCommitResult Commit(string targetDirectory, bool createBackups = true)
+    public StagingCommitResult Commit(string targetDirectory, bool createBackups = true, CancellationToken ct = default)
     {
         var result = new StagingCommitResult();
 
+        using var commitLock = StagingSessionLock.Acquire(StagingDirectory, ct);
+        if (!Directory.Exists(StagingDirectory))
+        {
+            result.Error = "Staging session was already committed or recovered elsewhere";
+            return result;
+        }
+
+        StagingCommitManifest? manifest = null;
         try
         {
-            foreach (var (relativePath, stagedPath) in StagedFiles)
-            {
-                var destPath = PathSanitizer.SanitizeEntryPath(relativePath, targetDirectory);
-                var destDir = Path.GetDirectoryName(destPath);
-                if (!string.IsNullOrEmpty(destDir) && !Directory.Exists(destDir))
-                    Directory.CreateDirectory(destDir);
-
-                // Backup existing file
-                if (File.Exists(destPath) && createBackups)
-                {
-                    var backupPath = destPath + ".backup";
-                    File.Copy(destPath, backupPath, true);
-                    result.BackedUpFiles.Add(backupPath);
-                }
-
-                // Move staged file to target
-                File.Move(stagedPath, destPath, overwrite: true);
-                result.InstalledFiles.Add(destPath);
-            }
+            manifest = CreateManifest(targetDirectory, createBackups);
+            StagingCommitJournal.Write(_fileSystem, StagingDirectory, manifest);
 
+            Prepare(manifest);
+            manifest.State = StagingCommitState.Prepared;
+            StagingCommitJournal.Write(_fileSystem, StagingDirectory, manifest);
+
+            StagingCommitJournal.RollForward(_fileSystem, StagingDirectory, manifest);
             _committed = true;
-            result.Success = true;
-            _logger?.LogInformation(
-                "Committed staging session {ChangesetId}: {Count} files",
-                ChangesetId, result.InstalledFiles.Count);
+            Complete(result, manifest);
         }
         catch (Exception ex)
         {
             result.Success = false;
             result.Error = ex.Message;
             _logger?.LogError(ex, "Failed to commit staging session {ChangesetId}", ChangesetId);
+
+            if (manifest != null)
+                ResolveFailedCommit(result, manifest);
         }
 
+        if (_committed)
+            CleanUp();
+
         return result;
     }
 
+    private StagingCommitManifest CreateManifest(string targetDirectory, bool createBackups)
+    {
+        var manifest = new StagingCommitManifest { ChangesetId = ChangesetId, State = StagingCommitState.Preparing };
+        var suffix = $".modular-{FileUtils.SanitizeFilename(ChangesetId)}.tmp";
+
+        // Nothing is written yet, so entries are mapped onto each other in a layer
+        // the shared index only learns about by re-reading the directories after the commit
+        var paths = CaseFoldingPathIndex.For(targetDirectory).CreateLayer();
+
+        foreach (var (relativePath, stagedPath) in StagedFiles)
+        {
+            var destPath = paths.SanitizeEntryPath(relativePath);
+            paths.AddFile(destPath);
+            var backup = createBackups && File.Exists(destPath);
+
+            manifest.Entries.Add(new StagingCommitEntry
+            {
+                StagedPath = stagedPath,
+                TargetPath = destPath,
+                TempPath = destPath + suffix,
+                BackupPath = backup ? destPath + ".backup" : null,
+                BackupTempPath = backup ? destPath + ".backup" + suffix : null
+            });
+        }
+
+        return manifest;
+    }
+
+    /// <summary>
+    /// Moves every staged file next to its target and copies every backup,
+    /// flushes them, and flushes the directories they (and any newly created
+    /// directories) live in.
+    /// </summary>
+    private void Prepare(StagingCommitManifest manifest)
+    {
+        var dirtyDirectories = new HashSet<string>(StringComparer.Ordinal);
+
+        foreach (var entry in manifest.Entries)
+        {
+            var destDir = Path.GetDirectoryName(entry.TargetPath)!;
+            CreateDirectoryDurably(destDir, dirtyDirectories);
+
+            _fileSystem.Relocate(entry.StagedPath, entry.TempPath);
+            _fileSystem.FlushFile(entry.TempPath);
+
+            if (entry.BackupTempPath != null)
+            {
+                _fileSystem.Copy(entry.TargetPath, entry.BackupTempPath);
+                _fileSystem.FlushFile(entry.BackupTempPath);
+            }
+
+            dirtyDirectories.Add(destDir);
+        }
+
+        foreach (var directory in dirtyDirectories)
+            _fileSystem.FlushDirectory(directory);
+    }
+
+    private void CreateDirectoryDurably(string directory, HashSet<string> dirtyDirectories)
+    {
+        if (Directory.Exists(directory))
+            return;
+
+        // Each new directory's entry lives in its parent
+        for (var current = directory; !Directory.Exists(current);)
+        {
+            var parent = Path.GetDirectoryName(current);
+            if (string.IsNullOrEmpty(parent))
+                break;
+            dirtyDirectories.Add(parent);
+            current = parent;
+        }
+
+        _fileSystem.CreateDirectory(directory);
+    }
+
+    private void ResolveFailedCommit(StagingCommitResult result, StagingCommitManifest manifest)
+    {
+        try
+        {
+            // Same decision recovery would make after a crash at this point
+            var outcome = StagingCommitJournal.Resolve(_fileSystem, StagingDirectory);
+            if (outcome is StagingRecoveryOutcome.RolledForward or StagingRecoveryOutcome.Completed)
+            {
+                _committed = true;
+                result.Error = null;
+                Complete(result, manifest);
+            }
+        }
+        catch (Exception ex)
+        {
+            // Leave the manifest for RecoverInterruptedCommits
+            _recoveryPending = true;
+            _logger?.LogWarning(ex, "Staging session {ChangesetId} left for recovery", ChangesetId);
+        }
+    }
+
+    private void CleanUp()
+    {
+        try
+        {
+            _fileSystem.DeleteDirectory(StagingDirectory);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // The committed manifest makes recovery remove it later
+            _logger?.LogWarning(ex, "Failed to remove staging directory of {ChangesetId}", ChangesetId);
+        }
+    }
+
+    private void Complete(StagingCommitResult result, StagingCommitManifest manifest)
+    {
+        result.Success = true;
+        result.InstalledFiles.AddRange(manifest.Entries.Select(e => e.TargetPath));
+        result.BackedUpFiles.AddRange(manifest.Entries.Where(e => e.BackupPath != null).Select(e => e.BackupPath!));
+        _logger?.LogInformation(
+            "Committed staging session {ChangesetId}: {Count} files",
+            ChangesetId, result.InstalledFiles.Count);
+    }
+
     /// <summary>
     /// Rolls back the staging session by deleting the staging directory.
     /// </summary>
     public void Rollback()
     {
-        if (_committed)
+        // A commit interrupted past its commit point must be finished by recovery, not discarded
+        if (_committed || _recoveryPending)
             return;
 
         try
         {
             if (Directory.Exists(StagingDirectory))
             {
+                // Taken so a failed commit's lock file goes with the directory
+                using var sessionLock = StagingSessionLock.TryAcquire(StagingDirectory);
+                if (sessionLock == null)
+                    return;
+
                 Directory.Delete(StagingDirectory, recursive: true);
                 _logger?.LogInformation("Rolled back staging session {ChangesetId}", ChangesetId);
             }
@@ -162,6 +370,88 @@ public class StagingSession : IDisposable
     }
 }
 
+/// <summary>
+/// The lock that keeps a commit of a staging session and its recovery apart.
+/// Each session has its own lock file under the staging root, which stays
+/// while the staging directory exists and is deleted by the holder once the
+/// directory is gone. A process that opened the file just before that
+/// deletion gets the lock on an unlinked file, but by then there is no
+/// session left for it to act on.
+/// </summary>
+internal sealed class StagingSessionLock : IDisposable
+{
+    /// <summary>
+    /// Directory under the staging root holding the lock files.
+    /// </summary>
+    public const string DirectoryName = ".locks";
+
+    public const string Extension = ".lock";
+
+    private readonly FileStream _stream;
+    private readonly string _stagingDirectory;
+
+    private StagingSessionLock(FileStream stream, string stagingDirectory)
+    {
+        _stream = stream;
+        _stagingDirectory = stagingDirectory;
+    }
+
+    /// <summary>
+    /// Takes the lock, or returns null if another process holds it.
+    /// </summary>
+    public static StagingSessionLock? TryAcquire(string stagingDirectory)
+    {
+        var lockDirectory = Path.Combine(Path.GetDirectoryName(stagingDirectory)!, DirectoryName);
+        Directory.CreateDirectory(lockDirectory);
+        var path = Path.Combine(lockDirectory, Path.GetFileName(stagingDirectory) + Extension);
+
+        try
+        {
+            // Windows needs FileShare.Delete for the holder to remove the file it has open;
+            // elsewhere any sharing flag turns the exclusive lock into a shared one
+            var share = OperatingSystem.IsWindows() ? FileShare.Delete : FileShare.None;
+            var stream = new FileStream(path, FileMode.OpenOrCreate, FileAccess.ReadWrite, share, bufferSize: 1);
+            return new StagingSessionLock(stream, stagingDirectory);
+        }
+        catch (IOException)
+        {
+            return null;
+        }
+    }
+
+    /// <summary>
+    /// Takes the lock, waiting for as long as another process holds it.
+    /// </summary>
+    public static StagingSessionLock Acquire(string stagingDirectory, CancellationToken ct = default)
+    {
+        while (true)
+        {
+            ct.ThrowIfCancellationRequested();
+            if (TryAcquire(stagingDirectory) is { } sessionLock)
+                return sessionLock;
+
+            Thread.Sleep(5);
+        }
+    }
+
+    public void Dispose()
+    {
+        try
+        {
+            if (!Directory.Exists(_stagingDirectory))
+                File.Delete(_stream.Name);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // Removed by the next recovery
+        }
+        finally
+        {
+            _stream.Dispose();
+        }
+    }
+}
+
 /// <summary>
 /// Result of committing a staging session.
 /// </summary>
@@ -322,6 +322,7 @@ public class SteamModInstaller : IModInstaller
 
             var installedFiles = new List<string>();
             var backedUpFiles = new List<string>();
+            var paths = CaseFoldingPathIndex.For(gameDirectory);
 
             foreach (var mod in resolution.InstallOrder)
             {
@@ -334,7 +335,7 @@ public class SteamModInstaller : IModInstaller
                 foreach (var stagedFile in stagedFiles)
                 {
                     var relativePath = Path.GetRelativePath(modStagingDir, stagedFile);
-                    var destPath = PathSanitizer.SanitizeEntryPath(relativePath, gameDirectory);
+                    var destPath = paths.SanitizeEntryPath(relativePath);
                     var destDir = Path.GetDirectoryName(destPath);
 
                     if (!string.IsNullOrEmpty(destDir) && !Directory.Exists(destDir))
@@ -356,6 +357,7 @@ public class SteamModInstaller : IModInstaller
 
                     // Copy from staging to game directory
                     File.Copy(stagedFile, destPath, overwrite: true);
+                    paths.AddFile(destPath);
                     installedFiles.Add(destPath);
                     modInstalled++;
                 }
@@ -428,18 +430,20 @@ public class SteamModInstaller : IModInstaller
         if (Directory.Exists(backupDirectory))
         {
             var backupFiles = Directory.GetFiles(backupDirectory, "*", SearchOption.AllDirectories);
+            var paths = CaseFoldingPathIndex.For(gameDirectory);
             foreach (var backupFile in backupFiles)
             {
                 try
                 {
                     var relativePath = Path.GetRelativePath(backupDirectory, backupFile);
-                    var destPath = PathSanitizer.SanitizeEntryPath(relativePath, gameDirectory);
+                    var destPath = paths.SanitizeEntryPath(relativePath);
                     var destDir = Path.GetDirectoryName(destPath);
 
                     if (!string.IsNullOrEmpty(destDir) && !Directory.Exists(destDir))
                         Directory.CreateDirectory(destDir);
 
                     File.Copy(backupFile, destPath, overwrite: true);
+                    paths.AddFile(destPath);
                     _logger?.LogDebug("Restored {Path} from backup", destPath);
                 }
                 catch (Exception ex)
@@ -521,11 +525,12 @@ public class SteamModInstaller : IModInstaller
         {
             var stagedFiles = Directory.GetFiles(stagingDir, "*", SearchOption.AllDirectories);
             int processed = 0;
+            var paths = CaseFoldingPathIndex.For(targetDir);
 
             foreach (var stagedFile in stagedFiles)
             {
                 var relativePath = Path.GetRelativePath(stagingDir, stagedFile);
-                var destPath = PathSanitizer.SanitizeEntryPath(relativePath, targetDir);
+                var destPath = paths.SanitizeEntryPath(relativePath);
                 var destDir = Path.GetDirectoryName(destPath);
 
                 if (!string.IsNullOrEmpty(destDir) && !Directory.Exists(destDir))
@@ -540,6 +545,7 @@ public class SteamModInstaller : IModInstaller
                 }
 
                 File.Copy(stagedFile, destPath, overwrite: true);
+                paths.AddFile(destPath);
                 installedFiles.Add(destPath);
                 processed++;
 
@@ -254,6 +254,7 @@ public class UnrealPakInstaller : IModInstaller
 
             int filesProcessed = 0;
             long bytesProcessed = 0;
+            var paths = CaseFoldingPathIndex.For(targetDir);
 
             foreach (var operation in extractOps)
             {
@@ -263,7 +264,7 @@ public class UnrealPakInstaller : IModInstaller
                 if (entry == null)
                     continue;
 
-                var destPath = PathSanitizer.SanitizeEntryPath(operation.DestinationPath, targetDir);
+                var destPath = paths.SanitizeEntryPath(operation.DestinationPath);
 
                 // Create subdirectories as needed
                 var destDir = Path.GetDirectoryName(destPath);
@@ -283,6 +284,7 @@ public class UnrealPakInstaller : IModInstaller
 
                 // Extract file
                 await reader.ExtractEntryAsync(entry, destPath, overwrite: true, ct);
+                paths.AddFile(destPath);
                 installedFiles.Add(destPath);
 
                 filesProcessed++;
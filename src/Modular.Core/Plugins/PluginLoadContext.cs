@@ -19,8 +19,9 @@ public class PluginLoadContext : AssemblyLoadContext
     /// <param name="isCollectible">
     /// Whether this context can be unloaded (true for hot reload support).
     /// </param>
-    public PluginLoadContext(string pluginPath, bool isCollectible = true)
-        : base(name: Path.GetFileName(pluginPath), isCollectible: isCollectible)
+    /// <param name="name">Context name; defaults to the directory name.</param>
+    public PluginLoadContext(string pluginPath, bool isCollectible = true, string? name = null)
+        : base(name: name ?? Path.GetFileName(pluginPath), isCollectible: isCollectible)
     {
         _pluginPath = pluginPath;
         
@@ -1,4 +1,5 @@
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Text.Json;
 using Microsoft.Extensions.Logging;
 using Modular.Core.ErrorHandling;
@@ -11,13 +12,29 @@ namespace Modular.Core.Plugins;
 
 /// <summary>
 /// Service for discovering and loading plugins from the plugin directory.
+/// Each loaded plugin holds a lease on its version in the <see cref="PluginStore"/>,
+/// so installing an update never removes files a running process has mapped;
+/// <see cref="HotSwapUpdatedPlugins"/> moves loaded plugins to the newly
+/// activated version.
 /// </summary>
-public class PluginLoader
+public class PluginLoader : IDisposable
 {
+    // Collections needed before an unloaded context is actually gone
+    private const int UnloadCollectAttempts = 10;
+
     private readonly string _pluginDirectory;
+    private readonly PluginStore _store;
     private readonly ILogger<PluginLoader>? _logger;
     private readonly Dictionary<string, LoadedPlugin> _loadedPlugins = new();
+    private readonly List<PendingUnload> _pendingUnloads = new();
+    private readonly object _sync = new();
     private readonly ErrorBoundary _errorBoundary;
+    private FileSystemWatcher? _watcher;
+
+    /// <summary>
+    /// Raised after a loaded plugin was replaced by its newly activated version.
+    /// </summary>
+    public event EventHandler<LoadedPlugin>? PluginReloaded;
 
     /// <summary>
     /// Default plugin directory: ~/.config/Modular/plugins
@@ -41,8 +58,15 @@ public class PluginLoader
             Directory.CreateDirectory(_pluginDirectory);
             _logger?.LogInformation("Created plugin directory: {PluginDirectory}", _pluginDirectory);
         }
+
+        _store = new PluginStore(_pluginDirectory);
     }
 
+    /// <summary>
+    /// The versioned store plugins are loaded from.
+    /// </summary>
+    public PluginStore Store => _store;
+
     /// <summary>
     /// Discovers all plugins in the plugin directory.
     /// </summary>
@@ -57,63 +81,101 @@ public class PluginLoader
             return manifests;
         }
 
-        // Each plugin is in its own subdirectory with a plugin.json manifest
-        foreach (var pluginDir in Directory.GetDirectories(_pluginDirectory))
+        // Each plugin is in its own subdirectory; plugin.json is in the active version's directory
+        foreach (var pluginId in _store.GetPluginIds())
         {
-            var manifestPath = Path.Combine(pluginDir, "plugin.json");
-            if (!File.Exists(manifestPath))
+            var activeDir = _store.GetActiveDirectory(pluginId);
+            if (activeDir == null)
             {
-                _logger?.LogWarning("No manifest found in plugin directory: {PluginDir}", pluginDir);
+                _logger?.LogWarning("No active version found for plugin: {PluginId}", pluginId);
                 continue;
             }
 
-            try
+            var manifest = ReadManifest(Path.Combine(activeDir, "plugin.json"));
+            if (manifest != null)
             {
-                var json = File.ReadAllText(manifestPath);
-                var manifest = JsonSerializer.Deserialize<PluginManifest>(json,
-                    new JsonSerializerOptions { PropertyNameCaseInsensitive = true });
+                manifests.Add(manifest);
+                _logger?.LogDebug("Discovered plugin: {PluginId} v{Version}", manifest.Id, manifest.Version);
+            }
+        }
 
-                if (manifest == null)
-                {
-                    _logger?.LogError("Failed to parse manifest: {ManifestPath}", manifestPath);
-                    continue;
-                }
+        return manifests;
+    }
 
-                // Validate manifest
-                if (string.IsNullOrEmpty(manifest.Id) ||
-                    string.IsNullOrEmpty(manifest.Version) ||
-                    string.IsNullOrEmpty(manifest.EntryAssembly))
-                {
-                    _logger?.LogError("Invalid manifest (missing required fields): {ManifestPath}", manifestPath);
-                    continue;
-                }
+    private PluginManifest? ReadManifest(string manifestPath)
+    {
+        if (!File.Exists(manifestPath))
+        {
+            _logger?.LogWarning("No manifest found: {ManifestPath}", manifestPath);
+            return null;
+        }
 
-                manifests.Add(manifest);
-                _logger?.LogDebug("Discovered plugin: {PluginId} v{Version}", manifest.Id, manifest.Version);
+        try
+        {
+            var json = File.ReadAllText(manifestPath);
+            var manifest = JsonSerializer.Deserialize<PluginManifest>(json,
+                new JsonSerializerOptions { PropertyNameCaseInsensitive = true });
+
+            if (manifest == null)
+            {
+                _logger?.LogError("Failed to parse manifest: {ManifestPath}", manifestPath);
+                return null;
             }
-            catch (Exception ex)
+
+            // Validate manifest
+            if (string.IsNullOrEmpty(manifest.Id) ||
+                string.IsNullOrEmpty(manifest.Version) ||
+                string.IsNullOrEmpty(manifest.EntryAssembly))
             {
-                _logger?.LogError(ex, "Error reading plugin manifest: {ManifestPath}", manifestPath);
+                _logger?.LogError("Invalid manifest (missing required fields): {ManifestPath}", manifestPath);
+                return null;
             }
-        }
 
-        return manifests;
+            return manifest;
+        }
+        catch (Exception ex)
+        {
+            _logger?.LogError(ex, "Error reading plugin manifest: {ManifestPath}", manifestPath);
+            return null;
+        }
     }
 
     /// <summary>
-    /// Loads a plugin from its manifest.
+    /// Loads the active version of a plugin.
     /// </summary>
     /// <param name="manifest">Plugin manifest.</param>
     /// <returns>Loaded plugin information.</returns>
     public LoadedPlugin LoadPlugin(PluginManifest manifest)
     {
-        if (_loadedPlugins.ContainsKey(manifest.Id))
+        lock (_sync)
         {
-            _logger?.LogWarning("Plugin already loaded: {PluginId}", manifest.Id);
-            return _loadedPlugins[manifest.Id];
+            if (_loadedPlugins.TryGetValue(manifest.Id, out var existing))
+            {
+                _logger?.LogWarning("Plugin already loaded: {PluginId}", manifest.Id);
+                return existing;
+            }
+
+            var lease = _store.AcquireLease(manifest.Id)
+                ?? throw new DirectoryNotFoundException($"Plugin not installed: {manifest.Id}");
+            try
+            {
+                var loadedPlugin = Load(lease, manifest);
+                _loadedPlugins[manifest.Id] = loadedPlugin;
+                return loadedPlugin;
+            }
+            catch
+            {
+                lease.Dispose();
+                throw;
+            }
         }
+    }
 
-        var pluginDir = Path.Combine(_pluginDirectory, manifest.Id);
+    private LoadedPlugin Load(PluginLease lease, PluginManifest requested)
+    {
+        // The active version may have changed since the caller discovered the plugin
+        var pluginDir = lease.Directory;
+        var manifest = ReadManifest(Path.Combine(pluginDir, "plugin.json")) ?? requested;
         var assemblyPath = Path.Combine(pluginDir, manifest.EntryAssembly);
 
         if (!File.Exists(assemblyPath))
@@ -124,7 +186,7 @@ public class PluginLoader
         _logger?.LogInformation("Loading plugin: {PluginId} from {AssemblyPath}", manifest.Id, assemblyPath);
 
         // Create isolated load context
-        var loadContext = new PluginLoadContext(pluginDir, isCollectible: true);
+        var loadContext = new PluginLoadContext(pluginDir, isCollectible: true, name: $"{manifest.Id}@{manifest.Version}");
 
         // Load the entry assembly
         var assembly = loadContext.LoadFromAssemblyPath(assemblyPath);
@@ -136,6 +198,7 @@ public class PluginLoader
 
         if (metadataTypes.Count == 0)
         {
+            loadContext.Unload();
             throw new InvalidOperationException(
                 $"Plugin {manifest.Id} does not contain any types implementing IPluginMetadata");
         }
@@ -144,6 +207,7 @@ public class PluginLoader
         var metadataInstance = Activator.CreateInstance(metadataTypes[0]) as IPluginMetadata;
         if (metadataInstance == null)
         {
+            loadContext.Unload();
             throw new InvalidOperationException(
                 $"Failed to create instance of IPluginMetadata for plugin {manifest.Id}");
         }
@@ -154,12 +218,13 @@ public class PluginLoader
             LoadContext = loadContext,
             Assembly = assembly,
             Metadata = metadataInstance,
+            Directory = pluginDir,
+            Lease = lease,
             Installers = DiscoverInstallers(assembly),
             Enrichers = DiscoverEnrichers(assembly),
             UiExtensions = DiscoverUiExtensions(assembly)
         };
 
-        _loadedPlugins[manifest.Id] = loadedPlugin;
         _logger?.LogInformation(
             "Successfully loaded plugin: {PluginId} v{Version} (Installers: {InstallerCount}, Enrichers: {EnricherCount}, UI: {UiCount})",
             manifest.Id, manifest.Version,
@@ -174,30 +239,155 @@ public class PluginLoader
     /// <param name="pluginId">Plugin ID to unload.</param>
     public void UnloadPlugin(string pluginId)
     {
-        if (!_loadedPlugins.TryGetValue(pluginId, out var plugin))
+        lock (_sync)
         {
-            _logger?.LogWarning("Plugin not loaded: {PluginId}", pluginId);
+            if (!Detach(pluginId))
+            {
+                _logger?.LogWarning("Plugin not loaded: {PluginId}", pluginId);
+                return;
+            }
+
+            ReleaseUnloadedVersions();
+        }
+    }
+
+    /// <summary>
+    /// Replaces every loaded plugin whose active version in the store has
+    /// changed: the old load context is unloaded and the new version loaded.
+    /// Returns the plugins that were swapped.
+    /// </summary>
+    public IReadOnlyList<LoadedPlugin> HotSwapUpdatedPlugins()
+    {
+        var swapped = new List<LoadedPlugin>();
+
+        lock (_sync)
+        {
+            var stale = _loadedPlugins.Values
+                .Where(p => p.Lease?.Version != null && _store.GetActiveVersion(p.Manifest.Id) is { } active && active != p.Lease.Version)
+                .Select(p => p.Manifest)
+                .ToList();
+
+            foreach (var manifest in stale)
+            {
+                _logger?.LogInformation("Hot-swapping plugin {PluginId}", manifest.Id);
+                Detach(manifest.Id);
+
+                try
+                {
+                    swapped.Add(LoadPlugin(manifest));
+                }
+                catch (Exception ex)
+                {
+                    _logger?.LogError(ex, "Failed to load updated plugin {PluginId}", manifest.Id);
+                }
+            }
+
+            if (stale.Count > 0)
+                ReleaseUnloadedVersions();
+        }
+
+        foreach (var plugin in swapped)
+            PluginReloaded?.Invoke(this, plugin);
+
+        return swapped;
+    }
+
+    /// <summary>
+    /// Watches the store for activated versions (from this or another
+    /// process) and hot-swaps loaded plugins when one changes.
+    /// </summary>
+    public void WatchForUpdates()
+    {
+        if (_watcher != null)
             return;
+
+        _watcher = new FileSystemWatcher(_pluginDirectory, PluginStore.CurrentPointerName)
+        {
+            IncludeSubdirectories = true,
+            NotifyFilter = NotifyFilters.FileName | NotifyFilters.LastWrite
+        };
+        _watcher.Created += OnPointerChanged;
+        _watcher.Changed += OnPointerChanged;
+        _watcher.Renamed += OnPointerChanged;
+        _watcher.EnableRaisingEvents = true;
+    }
+
+    private void OnPointerChanged(object sender, FileSystemEventArgs e)
+    {
+        try
+        {
+            HotSwapUpdatedPlugins();
         }
+        catch (Exception ex)
+        {
+            _logger?.LogError(ex, "Plugin hot swap failed");
+        }
+    }
 
-        _logger?.LogInformation("Unloading plugin: {PluginId}", pluginId);
+    /// <summary>
+    /// Removes a plugin and starts unloading its context. Kept out of line so
+    /// no reference to the plugin survives in the caller's frame.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private bool Detach(string pluginId)
+    {
+        if (!_loadedPlugins.Remove(pluginId, out var plugin))
+            return false;
 
-        // Unload the assembly load context
+        _logger?.LogInformation("Unloading plugin: {PluginId}", pluginId);
         plugin.LoadContext.Unload();
+        _pendingUnloads.Add(new PendingUnload(new WeakReference(plugin.LoadContext), plugin.Lease));
+        return true;
+    }
+
+    /// <summary>
+    /// Releases the leases of unloaded versions whose load context has been
+    /// collected, so the store can delete their files.
+    /// </summary>
+    private void ReleaseUnloadedVersions()
+    {
+        for (var i = 0; i < UnloadCollectAttempts && _pendingUnloads.Any(p => p.Context.IsAlive); i++)
+        {
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+        }
+
+        foreach (var pending in _pendingUnloads.Where(p => !p.Context.IsAlive).ToList())
+        {
+            _pendingUnloads.Remove(pending);
+            pending.Lease?.Dispose();
 
-        _loadedPlugins.Remove(pluginId);
+            if (pending.Lease != null)
+                _errorBoundary.Execute($"Collect old versions of {pending.Lease.PluginId}",
+                    () => _store.CollectGarbage(pending.Lease.PluginId), 0);
+        }
     }
 
+    public void Dispose()
+    {
+        _watcher?.Dispose();
+        _watcher = null;
+    }
+
+    private sealed record PendingUnload(WeakReference Context, PluginLease? Lease);
+
     /// <summary>
     /// Gets all loaded plugins.
     /// </summary>
-    public IReadOnlyList<LoadedPlugin> GetLoadedPlugins() => _loadedPlugins.Values.ToList();
+    public IReadOnlyList<LoadedPlugin> GetLoadedPlugins()
+    {
+        lock (_sync)
+            return _loadedPlugins.Values.ToList();
+    }
 
     /// <summary>
     /// Gets a loaded plugin by ID.
     /// </summary>
-    public LoadedPlugin? GetPlugin(string pluginId) =>
-        _loadedPlugins.TryGetValue(pluginId, out var plugin) ? plugin : null;
+    public LoadedPlugin? GetPlugin(string pluginId)
+    {
+        lock (_sync)
+            return _loadedPlugins.TryGetValue(pluginId, out var plugin) ? plugin : null;
+    }
 
     /// <summary>
     /// Discovers installer implementations in an assembly.
@@ -309,10 +499,13 @@ public class PluginLoader
     /// </summary>
     public List<IModInstaller> GetAllInstallers()
     {
-        return _loadedPlugins.Values
-            .SelectMany(p => p.Installers)
-            .OrderByDescending(i => i.Priority)
-            .ToList();
+        lock (_sync)
+        {
+            return _loadedPlugins.Values
+                .SelectMany(p => p.Installers)
+                .OrderByDescending(i => i.Priority)
+                .ToList();
+        }
     }
 
     /// <summary>
@@ -320,9 +513,12 @@ public class PluginLoader
     /// </summary>
     public Dictionary<string, IMetadataEnricher> GetAllEnrichers()
     {
-        return _loadedPlugins.Values
-            .SelectMany(p => p.Enrichers)
-            .ToDictionary(e => e.BackendId, e => e);
+        lock (_sync)
+        {
+            return _loadedPlugins.Values
+                .SelectMany(p => p.Enrichers)
+                .ToDictionary(e => e.BackendId, e => e);
+        }
     }
 
     /// <summary>
@@ -330,10 +526,13 @@ public class PluginLoader
     /// </summary>
     public Dictionary<UiExtensionLocation, List<IUiExtension>> GetAllUiExtensions()
     {
-        return _loadedPlugins.Values
-            .SelectMany(p => p.UiExtensions)
-            .GroupBy(e => e.Location)
-            .ToDictionary(g => g.Key, g => g.OrderByDescending(e => e.Priority).ToList());
+        lock (_sync)
+        {
+            return _loadedPlugins.Values
+                .SelectMany(p => p.UiExtensions)
+                .GroupBy(e => e.Location)
+                .ToDictionary(g => g.Key, g => g.OrderByDescending(e => e.Priority).ToList());
+        }
     }
 }
 
@@ -362,6 +561,16 @@ public class LoadedPlugin
     /// </summary>
     public required IPluginMetadata Metadata { get; init; }
 
+    /// <summary>
+    /// Directory the plugin was loaded from (its version directory).
+    /// </summary>
+    public string Directory { get; init; } = string.Empty;
+
+    /// <summary>
+    /// Keeps this version's files on disk while it is loaded.
+    /// </summary>
+    internal PluginLease? Lease { get; init; }
+
     /// <summary>
     /// Mod installers provided by this plugin.
     /// </summary>
@@ -2,6 +2,7 @@ using System.Security.Cryptography;
 using System.Text.Json;
 using System.Text.Json.Serialization;
 using Microsoft.Extensions.Logging;
+using Modular.Core.Utilities;
 
 namespace Modular.Core.Plugins;
 
@@ -10,8 +11,10 @@ namespace Modular.Core.Plugins;
 /// </summary>
 public class PluginMarketplace
 {
+    private const string DownloadDirectoryName = ".downloads";
+
     private readonly HttpClient _httpClient;
-    private readonly string _pluginsDirectory;
+    private readonly PluginStore _store;
     private readonly ILogger<PluginMarketplace>? _logger;
 
     public PluginMarketplace(
@@ -20,10 +23,15 @@ public class PluginMarketplace
         ILogger<PluginMarketplace>? logger = null)
     {
         _httpClient = httpClient;
-        _pluginsDirectory = pluginsDirectory;
+        _store = new PluginStore(pluginsDirectory);
         _logger = logger;
     }
 
+    /// <summary>
+    /// The versioned store plugins are installed into.
+    /// </summary>
+    public PluginStore Store => _store;
+
     /// <summary>
     /// Fetches the plugin index from a remote URL.
     /// </summary>
@@ -42,7 +50,9 @@ public class PluginMarketplace
     }
 
     /// <summary>
-    /// Downloads and installs a plugin.
+    /// Downloads and installs a plugin into its own version directory, then
+    /// activates it. The previously active version stays untouched (and
+    /// usable by running processes) until the new one is complete.
     /// </summary>
     public async Task<PluginInstallResult> InstallPluginAsync(
         PluginIndexEntry plugin,
@@ -51,41 +61,27 @@ public class PluginMarketplace
     {
         var result = new PluginInstallResult { PluginId = plugin.Id };
 
+        // Unique per install, so concurrent installs of the same plugin don't share a file
+        var downloadDir = Path.Combine(_store.PluginDirectory, DownloadDirectoryName);
+        Directory.CreateDirectory(downloadDir);
+        var tempPath = Path.Combine(downloadDir, $"{FileUtils.SanitizeFilename(plugin.Id)}-{Guid.NewGuid():N}.zip");
+
         try
         {
-            // Download plugin archive
             _logger?.LogInformation("Downloading plugin {Name} from {Url}", plugin.Name, plugin.DownloadUrl);
-            
-            var tempPath = Path.Combine(Path.GetTempPath(), $"{plugin.Id}.zip");
-            await DownloadFileAsync(plugin.DownloadUrl, tempPath, progress, ct);
+            var actualHash = await DownloadFileAsync(plugin.DownloadUrl, tempPath, progress, ct);
 
-            // Verify hash
-            if (!string.IsNullOrEmpty(plugin.Sha256))
+            if (!string.IsNullOrEmpty(plugin.Sha256) &&
+                !actualHash.Equals(plugin.Sha256, StringComparison.OrdinalIgnoreCase))
             {
-                var actualHash = await ComputeSha256Async(tempPath, ct);
-                if (!actualHash.Equals(plugin.Sha256, StringComparison.OrdinalIgnoreCase))
-                {
-                    result.Success = false;
-                    result.Error = $"Hash mismatch: expected {plugin.Sha256}, got {actualHash}";
-                    File.Delete(tempPath);
-                    return result;
-                }
+                result.Success = false;
+                result.Error = $"Hash mismatch: expected {plugin.Sha256}, got {actualHash}";
+                return result;
             }
 
-            // Extract to plugins directory
-            var targetDir = Path.Combine(_pluginsDirectory, plugin.Id);
-            if (Directory.Exists(targetDir))
-                Directory.Delete(targetDir, true);
-
-            Directory.CreateDirectory(targetDir);
-            System.IO.Compression.ZipFile.ExtractToDirectory(tempPath, targetDir);
-
-            // Cleanup
-            File.Delete(tempPath);
-
+            result.InstalledPath = await _store.InstallAsync(plugin.Id, plugin.Version, tempPath, ct);
             result.Success = true;
-            result.InstalledPath = targetDir;
-            _logger?.LogInformation("Successfully installed plugin {Name}", plugin.Name);
+            _logger?.LogInformation("Successfully installed plugin {Name} v{Version}", plugin.Name, plugin.Version);
         }
         catch (Exception ex)
         {
@@ -93,10 +89,33 @@ public class PluginMarketplace
             result.Error = ex.Message;
             _logger?.LogError(ex, "Failed to install plugin {Name}", plugin.Name);
         }
+        finally
+        {
+            File.Delete(tempPath);
+        }
 
         return result;
     }
 
+    /// <summary>
+    /// Installs or updates several plugins concurrently. Results are in the
+    /// order of <paramref name="plugins"/>.
+    /// </summary>
+    public async Task<List<PluginInstallResult>> InstallPluginsAsync(
+        IReadOnlyList<PluginIndexEntry> plugins,
+        int maxConcurrency = 4,
+        CancellationToken ct = default)
+    {
+        var results = new PluginInstallResult[plugins.Count];
+
+        await Parallel.ForEachAsync(
+            Enumerable.Range(0, plugins.Count),
+            new ParallelOptions { MaxDegreeOfParallelism = maxConcurrency, CancellationToken = ct },
+            async (i, token) => results[i] = await InstallPluginAsync(plugins[i], ct: token));
+
+        return results.ToList();
+    }
+
     /// <summary>
     /// Checks for plugin updates.
     /// </summary>
@@ -134,20 +153,14 @@ public class PluginMarketplace
     }
 
     /// <summary>
-    /// Uninstalls a plugin.
+    /// Uninstalls a plugin. Versions still loaded by a running process are
+    /// removed once that process releases them.
     /// </summary>
     public Task<bool> UninstallPluginAsync(string pluginId)
     {
         try
         {
-            var pluginDir = Path.Combine(_pluginsDirectory, pluginId);
-            if (Directory.Exists(pluginDir))
-            {
-                Directory.Delete(pluginDir, true);
-                _logger?.LogInformation("Uninstalled plugin {PluginId}", pluginId);
-                return Task.FromResult(true);
-            }
-            return Task.FromResult(false);
+            return Task.FromResult(_store.Uninstall(pluginId));
         }
         catch (Exception ex)
         {
@@ -156,7 +169,11 @@ public class PluginMarketplace
         }
     }
 
-    private async Task DownloadFileAsync(
+    /// <summary>
+    /// Downloads to <paramref name="outputPath"/>, hashing as the bytes
+    /// arrive. Returns the lowercase hex SHA-256.
+    /// </summary>
+    private async Task<string> DownloadFileAsync(
         string url,
         string outputPath,
         IProgress<double>? progress,
@@ -167,28 +184,24 @@ public class PluginMarketplace
 
         var totalBytes = response.Content.Headers.ContentLength ?? 0;
         await using var contentStream = await response.Content.ReadAsStreamAsync(ct);
-        await using var fileStream = File.Create(outputPath);
+        await using var fileStream = new FileStream(outputPath, FileMode.CreateNew, FileAccess.Write, FileShare.None, bufferSize: 1);
+        using var sha256 = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
 
-        var buffer = new byte[8192];
+        var buffer = new byte[81920];
         long totalRead = 0;
         int bytesRead;
 
-        while ((bytesRead = await contentStream.ReadAsync(buffer, 0, buffer.Length, ct)) > 0)
+        while ((bytesRead = await contentStream.ReadAsync(buffer, ct)) > 0)
         {
-            await fileStream.WriteAsync(buffer, 0, bytesRead, ct);
+            sha256.AppendData(buffer, 0, bytesRead);
+            await fileStream.WriteAsync(buffer.AsMemory(0, bytesRead), ct);
             totalRead += bytesRead;
 
             if (totalBytes > 0)
                 progress?.Report((double)totalRead / totalBytes * 100);
         }
-    }
 
-    private async Task<string> ComputeSha256Async(string filePath, CancellationToken ct)
-    {
-        using var sha256 = SHA256.Create();
-        await using var stream = File.OpenRead(filePath);
-        var hashBytes = await sha256.ComputeHashAsync(stream, ct);
-        return BitConverter.ToString(hashBytes).Replace("-", "").ToLowerInvariant();
+        return Convert.ToHexString(sha256.GetHashAndReset()).ToLowerInvariant();
     }
 }
 
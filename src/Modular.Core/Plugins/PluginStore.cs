@@ -0,0 +1,474 @@
+using System.IO.Compression;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Utilities;
+
+namespace Modular.Core.Plugins;
+
+/// <summary>
+/// Versioned, side-by-side plugin storage. Each plugin lives in
+/// <c>&lt;id&gt;/</c> with one directory per installed version and a
+/// <c>current</c> file naming the active one:
+/// <code>
+/// plugins/curseforge-backend/
+///   current            "1.3.0", replaced atomically on activation
+///   1.2.0/             still used by a running process
+///   1.3.0/
+///   .leases/           one locked file per process that loaded a version
+/// </code>
+/// Installing never touches the active version's files; a new version is
+/// extracted beside it and the pointer is swapped. Versions that are
+/// neither current nor leased are removed by <see cref="CollectGarbage"/>.
+/// Plugins installed before this layout (files directly in <c>&lt;id&gt;/</c>)
+/// are still found and are cleaned up once a versioned install replaces them.
+/// </summary>
+public class PluginStore
+{
+    /// <summary>
+    /// Name of the file holding the active version.
+    /// </summary>
+    public const string CurrentPointerName = "current";
+
+    private const string ManifestFileName = "plugin.json";
+    private const string LeaseDirectoryName = ".leases";
+    private const string LockFileName = ".lock";
+    private const string StagingPrefix = ".staging-";
+    private const string TrashPrefix = ".trash-";
+
+    // Lease name for plugins still in the flat pre-versioning layout
+    private const string LegacyLeaseVersion = "_root";
+
+    private static readonly TimeSpan LockTimeout = TimeSpan.FromSeconds(30);
+    private static readonly TimeSpan AbandonedStagingAge = TimeSpan.FromHours(1);
+
+    private readonly ILogger<PluginStore>? _logger;
+
+    public PluginStore(string pluginDirectory, ILogger<PluginStore>? logger = null)
+    {
+        PluginDirectory = pluginDirectory;
+        _logger = logger;
+        Directory.CreateDirectory(pluginDirectory);
+    }
+
+    /// <summary>
+    /// Root directory holding all plugins.
+    /// </summary>
+    public string PluginDirectory { get; }
+
+    /// <summary>
+    /// IDs of all plugins that have a directory in the store.
+    /// </summary>
+    public IEnumerable<string> GetPluginIds() =>
+        Directory.EnumerateDirectories(PluginDirectory)
+            .Select(Path.GetFileName)
+            .OfType<string>()
+            .Where(name => !name.StartsWith('.'));
+
+    /// <summary>
+    /// Active version of a plugin, or null if none is activated (or the
+    /// plugin uses the flat layout).
+    /// </summary>
+    public string? GetActiveVersion(string pluginId)
+    {
+        var pointer = Path.Combine(PluginRoot(pluginId), CurrentPointerName);
+        if (!File.Exists(pointer))
+            return null;
+
+        var version = File.ReadAllText(pointer).Trim();
+        return version.Length > 0 && Directory.Exists(Path.Combine(PluginRoot(pluginId), version)) ? version : null;
+    }
+
+    /// <summary>
+    /// Directory of the active version, falling back to a flat-layout
+    /// install. Null if the plugin has neither.
+    /// </summary>
+    public string? GetActiveDirectory(string pluginId)
+    {
+        var root = PluginRoot(pluginId);
+        var version = GetActiveVersion(pluginId);
+        if (version != null)
+            return Path.Combine(root, version);
+
+        return File.Exists(Path.Combine(root, ManifestFileName)) ? root : null;
+    }
+
+    /// <summary>
+    /// Versions present on disk, active or not.
+    /// </summary>
+    public IReadOnlyList<string> GetInstalledVersions(string pluginId)
+    {
+        var root = PluginRoot(pluginId);
+        if (!Directory.Exists(root))
+            return [];
+
+        return Directory.EnumerateDirectories(root)
+            .Where(IsVersionDirectory)
+            .Select(d => Path.GetFileName(d))
+            .ToList();
+    }
+
+    /// <summary>
+    /// Extracts a plugin archive into its version directory and activates
+    /// it. The archive is extracted to a private staging directory first, so
+    /// a failed or concurrent install never leaves a partial version behind
+    /// and never disturbs the active one.
+    /// </summary>
+    /// <returns>The directory of the installed version.</returns>
+    public Task<string> InstallAsync(string pluginId, string version, string archivePath, CancellationToken ct = default)
+    {
+        ValidateName(pluginId, nameof(pluginId));
+        ValidateName(version, nameof(version));
+
+        return Task.Run(() =>
+        {
+            var root = PluginRoot(pluginId);
+            var versionDir = Path.Combine(root, version);
+            Directory.CreateDirectory(root);
+
+            if (!IsVersionDirectory(versionDir))
+                ExtractVersion(pluginId, version, archivePath, root, versionDir, ct);
+
+            Activate(pluginId, version);
+            CollectGarbage(pluginId);
+            return versionDir;
+        }, ct);
+    }
+
+    /// <summary>
+    /// Makes an installed version the active one by atomically replacing the
+    /// pointer file.
+    /// </summary>
+    public void Activate(string pluginId, string version)
+    {
+        ValidateName(version, nameof(version));
+        var root = PluginRoot(pluginId);
+        if (!IsVersionDirectory(Path.Combine(root, version)))
+            throw new DirectoryNotFoundException($"Plugin {pluginId} version {version} is not installed");
+
+        using var _ = Lock(root);
+        var pointer = Path.Combine(root, CurrentPointerName);
+        var tempPointer = $"{pointer}.{Guid.NewGuid():N}.tmp";
+
+        File.WriteAllText(tempPointer, version);
+        DurableFile.FlushFile(tempPointer);
+        File.Move(tempPointer, pointer, overwrite: true);
+        DurableFile.FlushDirectory(root);
+
+        _logger?.LogInformation("Activated plugin {PluginId} v{Version}", pluginId, version);
+    }
+
+    /// <summary>
+    /// Records that this process is using the active version of a plugin,
+    /// so it is kept on disk after being replaced. Returns null if the
+    /// plugin is not installed.
+    /// </summary>
+    public PluginLease? AcquireLease(string pluginId)
+    {
+        var root = PluginRoot(pluginId);
+        if (!Directory.Exists(root))
+            return null;
+
+        // Under the lock, so garbage collection can't remove the version between reading and leasing it
+        using var _ = Lock(root);
+        var version = GetActiveVersion(pluginId);
+        var directory = GetActiveDirectory(pluginId);
+        if (directory == null)
+            return null;
+
+        var leaseDir = Path.Combine(root, LeaseDirectoryName);
+        Directory.CreateDirectory(leaseDir);
+        var leasePath = Path.Combine(leaseDir, $"{version ?? LegacyLeaseVersion}.{Guid.NewGuid():N}");
+        var handle = new FileStream(leasePath, FileMode.CreateNew, FileAccess.ReadWrite, FileShare.None, bufferSize: 1);
+
+        return new PluginLease(pluginId, version, directory, root, leasePath, handle);
+    }
+
+    /// <summary>
+    /// Removes versions of a plugin that are neither active nor leased by a
+    /// running process, and flat-layout files superseded by a versioned
+    /// install. Returns the number of versions removed.
+    /// </summary>
+    public int CollectGarbage(string pluginId)
+    {
+        var root = PluginRoot(pluginId);
+        if (!Directory.Exists(root))
+            return 0;
+
+        var trash = new List<string>();
+        var removed = 0;
+        using (Lock(root))
+        {
+            var active = GetActiveVersion(pluginId);
+            var leased = LiveLeaseVersions(root);
+
+            foreach (var versionDir in Directory.EnumerateDirectories(root).Where(IsVersionDirectory))
+            {
+                var version = Path.GetFileName(versionDir);
+                if (version == active || leased.Contains(version))
+                    continue;
+
+                // Renamed under the lock; the slow delete happens after it is released
+                var trashDir = Path.Combine(root, $"{TrashPrefix}{Guid.NewGuid():N}");
+                Directory.Move(versionDir, trashDir);
+                trash.Add(trashDir);
+                removed++;
+                _logger?.LogInformation("Removing unused plugin {PluginId} v{Version}", pluginId, version);
+            }
+
+            if (!leased.Contains(LegacyLeaseVersion) && (active != null || !File.Exists(Path.Combine(root, ManifestFileName))))
+                RemoveLegacyFiles(root);
+        }
+
+        foreach (var entry in Directory.EnumerateDirectories(root))
+        {
+            var name = Path.GetFileName(entry);
+            if (name.StartsWith(TrashPrefix, StringComparison.Ordinal) ||
+                (name.StartsWith(StagingPrefix, StringComparison.Ordinal) &&
+                 DateTime.UtcNow - Directory.GetLastWriteTimeUtc(entry) > AbandonedStagingAge))
+            {
+                if (!trash.Contains(entry))
+                    trash.Add(entry);
+            }
+        }
+
+        foreach (var dir in trash)
+            TryDeleteDirectory(dir);
+
+        return removed;
+    }
+
+    /// <summary>
+    /// Deactivates a plugin and removes every version no process is using.
+    /// The plugin directory itself goes once nothing in it is leased.
+    /// </summary>
+    /// <returns>False if the plugin was not installed.</returns>
+    public bool Uninstall(string pluginId)
+    {
+        var root = PluginRoot(pluginId);
+        if (!Directory.Exists(root))
+            return false;
+
+        using (Lock(root))
+        {
+            File.Delete(Path.Combine(root, CurrentPointerName));
+            if (LiveLeaseVersions(root).Count == 0)
+                RemoveLegacyFiles(root);
+        }
+
+        CollectGarbage(pluginId);
+
+        if (!Directory.EnumerateDirectories(root).Any(IsVersionDirectory) &&
+            !File.Exists(Path.Combine(root, ManifestFileName)))
+        {
+            TryDeleteDirectory(root);
+        }
+
+        _logger?.LogInformation("Uninstalled plugin {PluginId}", pluginId);
+        return true;
+    }
+
+    private void ExtractVersion(string pluginId, string version, string archivePath, string root, string versionDir, CancellationToken ct)
+    {
+        var staging = Path.Combine(root, $"{StagingPrefix}{Guid.NewGuid():N}");
+        try
+        {
+            // ExtractToDirectory rejects entries that would escape the staging directory
+            ZipFile.ExtractToDirectory(archivePath, staging);
+            ct.ThrowIfCancellationRequested();
+
+            if (!File.Exists(Path.Combine(staging, ManifestFileName)))
+                throw new InvalidDataException($"Plugin archive for {pluginId} has no {ManifestFileName}");
+
+            try
+            {
+                Directory.Move(staging, versionDir);
+            }
+            catch (IOException) when (IsVersionDirectory(versionDir))
+            {
+                // Another install of the same version finished first
+                _logger?.LogDebug("Plugin {PluginId} v{Version} was installed concurrently", pluginId, version);
+            }
+        }
+        finally
+        {
+            TryDeleteDirectory(staging);
+        }
+    }
+
+    /// <summary>
+    /// Versions with a lease file that some process still holds locked.
+    /// Leases of processes that have exited are deleted. Call under
+    /// <see cref="Lock"/>.
+    /// </summary>
+    /// <remarks>
+    /// Lease files are only ever deleted under the plugin lock, by their
+    /// holder on release or here once nobody holds them, so a file found
+    /// here can't be unlinked and replaced while it is being probed.
+    /// </remarks>
+    private static HashSet<string> LiveLeaseVersions(string root)
+    {
+        var live = new HashSet<string>(StringComparer.Ordinal);
+        var leaseDir = Path.Combine(root, LeaseDirectoryName);
+        if (!Directory.Exists(leaseDir))
+            return live;
+
+        foreach (var leasePath in Directory.EnumerateFiles(leaseDir))
+        {
+            var name = Path.GetFileName(leasePath);
+            var version = name[..Math.Max(0, name.LastIndexOf('.'))];
+            try
+            {
+                // Opening exclusively only succeeds once the holder is gone
+                new FileStream(leasePath, FileMode.Open, FileAccess.ReadWrite, FileShare.None, bufferSize: 1).Dispose();
+            }
+            catch (FileNotFoundException)
+            {
+                continue;
+            }
+            catch (IOException)
+            {
+                live.Add(version);
+                continue;
+            }
+
+            File.Delete(leasePath);
+        }
+
+        return live;
+    }
+
+    private void RemoveLegacyFiles(string root)
+    {
+        foreach (var file in Directory.EnumerateFiles(root))
+        {
+            var name = Path.GetFileName(file);
+            if (name == CurrentPointerName || name.StartsWith('.') || name.StartsWith(CurrentPointerName + ".", StringComparison.Ordinal))
+                continue;
+
+            try
+            {
+                File.Delete(file);
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                _logger?.LogDebug(ex, "Could not remove superseded plugin file {File}", file);
+            }
+        }
+
+        foreach (var dir in Directory.EnumerateDirectories(root))
+        {
+            if (!Path.GetFileName(dir).StartsWith('.') && !IsVersionDirectory(dir))
+                TryDeleteDirectory(dir);
+        }
+    }
+
+    private void TryDeleteDirectory(string path)
+    {
+        try
+        {
+            if (Directory.Exists(path))
+                Directory.Delete(path, recursive: true);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // Files still mapped on Windows; the next collection retries
+            _logger?.LogDebug(ex, "Could not remove {Path}", path);
+        }
+    }
+
+    /// <summary>
+    /// Takes the per-plugin lock that orders pointer swaps, leasing and
+    /// garbage collection. Held only for short metadata operations.
+    /// </summary>
+    internal static FileStream Lock(string root)
+    {
+        var path = Path.Combine(root, LockFileName);
+        var deadline = DateTime.UtcNow + LockTimeout;
+
+        while (true)
+        {
+            try
+            {
+                return new FileStream(path, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.None, bufferSize: 1);
+            }
+            catch (IOException) when (DateTime.UtcNow < deadline)
+            {
+                Thread.Sleep(5);
+            }
+        }
+    }
+
+    private static bool IsVersionDirectory(string path) =>
+        !Path.GetFileName(path).StartsWith('.') && File.Exists(Path.Combine(path, ManifestFileName));
+
+    private string PluginRoot(string pluginId)
+    {
+        ValidateName(pluginId, nameof(pluginId));
+        return Path.Combine(PluginDirectory, pluginId);
+    }
+
+    private static void ValidateName(string name, string parameter)
+    {
+        if (string.IsNullOrWhiteSpace(name) || name.StartsWith('.') || name == CurrentPointerName ||
+            name != FileUtils.SanitizeFilename(name) || name.Contains('/') || name.Contains('\\'))
+        {
+            throw new ArgumentException($"Invalid plugin {parameter}: '{name}'", parameter);
+        }
+    }
+}
+
+/// <summary>
+/// A process's claim on one installed plugin version. Dispose once the
+/// plugin's load context has been unloaded and collected.
+/// </summary>
+public sealed class PluginLease : IDisposable
+{
+    private readonly string _root;
+    private readonly string _path;
+    private readonly FileStream _handle;
+    private bool _disposed;
+
+    internal PluginLease(string pluginId, string? version, string directory, string root, string path, FileStream handle)
+    {
+        PluginId = pluginId;
+        Version = version;
+        Directory = directory;
+        _root = root;
+        _path = path;
+        _handle = handle;
+    }
+
+    public string PluginId { get; }
+
+    /// <summary>
+    /// Leased version, or null for a flat-layout install.
+    /// </summary>
+    public string? Version { get; }
+
+    /// <summary>
+    /// Directory holding the leased version's files.
+    /// </summary>
+    public string Directory { get; }
+
+    /// <summary>
+    /// Releases the lease and removes its file under the plugin lock. If the
+    /// lock can't be had, the file is left for garbage collection, which
+    /// treats an unlocked lease as released.
+    /// </summary>
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+        _disposed = true;
+
+        try
+        {
+            using var _ = PluginStore.Lock(_root);
+            _handle.Dispose();
+            File.Delete(_path);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            _handle.Dispose();
+        }
+    }
+}
@@ -0,0 +1,621 @@
+using System.Buffers.Binary;
+using System.Text;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Configuration;
+
+namespace Modular.Core.RateLimiting;
+
+/// <summary>
+/// Which share of the bandwidth a transfer draws from.
+/// </summary>
+public enum BandwidthClass
+{
+    /// <summary>A download the user started and is waiting for.</summary>
+    Interactive = 0,
+
+    /// <summary>Sync and other unattended transfers.</summary>
+    Background = 1
+}
+
+/// <summary>
+/// Token-bucket bandwidth limit shared by every Modular process on the machine.
+/// </summary>
+/// <remarks>
+/// <para>
+/// The buckets live in a small coordination file (<see cref="DefaultPath"/>)
+/// that each reservation locks exclusively, reads and rewrites. A
+/// reservation is charged up front and the caller sleeps off any debt, so
+/// concurrent transfers queue behind each other and the total rate holds at
+/// the limit with almost no burst.
+/// </para>
+/// <para>
+/// Each governor registers its running transfers per class in a slot of the
+/// file. The limit is split between the classes that have transfers by their
+/// weights (interactive 3 : background 1 by default), and whatever an idle
+/// class doesn't use goes to the other one. Slots of processes that stop
+/// reserving for <see cref="SlotTimeout"/> are ignored, so a crash doesn't
+/// hold a share.
+/// </para>
+/// <para>
+/// The policy (limit, schedule and weights) comes from <see cref="AppSettings"/>.
+/// When a process sees its settings change it publishes them to the file, and
+/// every other process applies them on its next reservation. Changes made in
+/// the GUI reach a running CLI sync without a restart.
+/// </para>
+/// </remarks>
+public sealed class BandwidthGovernor
+{
+    private const int FileLength = 4096;
+    private const int HeaderLength = 40;
+    private const int SlotLength = 24;
+    private const int SlotCount = 32;
+    private const int PolicyOffset = 1024;
+    private const int ClassCount = 2;
+    private const double BurstSeconds = 0.05;
+    private const int DefaultChunkSize = 81920;
+    private static readonly uint Magic = BinaryPrimitives.ReadUInt32LittleEndian("MBW1"u8);
+    private static readonly TimeSpan SlotTimeout = TimeSpan.FromSeconds(10);
+    private static readonly TimeSpan UnlimitedRecheckInterval = TimeSpan.FromMilliseconds(250);
+    private static int _nextInstance;
+
+    private readonly AppSettings _settings;
+    private readonly string _path;
+    private readonly ILogger? _logger;
+    private readonly int _processId = Environment.ProcessId;
+    private readonly int _instanceId = Interlocked.Increment(ref _nextInstance);
+    private readonly int[] _active = new int[ClassCount];
+    private readonly long[] _credit = new long[ClassCount];
+    private readonly object _lock = new();
+
+    private int? _localFingerprint;
+    private long _policyStamp;
+    private BandwidthPolicy _policy = new();
+    private BandwidthSchedule _schedule = BandwidthSchedule.Empty;
+    private long _limitBytesPerSecond;
+    private DateTime _nextUnlimitedCheck;
+
+    /// <summary>
+    /// Creates a governor coordinating through <paramref name="coordinationPath"/>
+    /// (default <see cref="DefaultPath"/>) and following the bandwidth
+    /// settings in <paramref name="settings"/>, including later changes to it.
+    /// </summary>
+    public BandwidthGovernor(AppSettings settings, string? coordinationPath = null, ILogger? logger = null)
+    {
+        _settings = settings;
+        _path = coordinationPath ?? DefaultPath;
+        _logger = logger;
+    }
+
+    /// <summary>
+    /// Default location of the coordination file.
+    /// </summary>
+    public static string DefaultPath =>
+        Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+            ".config", "Modular", "bandwidth.bin");
+
+    /// <summary>
+    /// Limit in force as of the last reservation, in bytes per second (0 = unlimited).
+    /// </summary>
+    public long CurrentLimitBytesPerSecond
+    {
+        get
+        {
+            lock (_lock)
+                return _limitBytesPerSecond;
+        }
+    }
+
+    /// <summary>
+    /// Largest read worth reserving at once: about 1/20 s at the current limit.
+    /// </summary>
+    public int ChunkSize
+    {
+        get
+        {
+            var limit = CurrentLimitBytesPerSecond;
+            return limit == 0 ? DefaultChunkSize : (int)Math.Clamp(limit / 20, 4096, 1024 * 1024);
+        }
+    }
+
+    /// <summary>
+    /// Publishes the current settings to the other processes now, instead of
+    /// on the next reservation. Call after the settings changed.
+    /// </summary>
+    public void ApplySettings()
+    {
+        lock (_lock)
+            WithFile(_ => { });
+    }
+
+    /// <summary>
+    /// Registers a running transfer of <paramref name="transferClass"/> until
+    /// the returned handle is disposed, so the class gets its share.
+    /// </summary>
+    public IDisposable BeginTransfer(BandwidthClass transferClass)
+    {
+        lock (_lock)
+        {
+            _active[(int)transferClass]++;
+            WithFile(_ => { });
+        }
+
+        return new TransferRegistration(this, transferClass);
+    }
+
+    /// <summary>
+    /// Waits until <paramref name="bytes"/> may be transferred in
+    /// <paramref name="transferClass"/>.
+    /// </summary>
+    public Task AcquireAsync(int bytes, BandwidthClass transferClass, CancellationToken ct = default)
+    {
+        var wait = Reserve(bytes, transferClass);
+        return wait > TimeSpan.Zero ? Task.Delay(wait, ct) : Task.CompletedTask;
+    }
+
+    /// <summary>
+    /// Wraps <paramref name="source"/> so that reads from it are held to the
+    /// limit. The transfer is registered until the wrapper is disposed.
+    /// </summary>
+    public Stream Throttle(Stream source, BandwidthClass transferClass) =>
+        new ThrottledStream(this, source, transferClass);
+
+    /// <summary>
+    /// Returns bytes reserved but not transferred; the next reservation of the
+    /// class uses them first.
+    /// </summary>
+    public void Refund(int bytes, BandwidthClass transferClass)
+    {
+        lock (_lock)
+            _credit[(int)transferClass] += bytes;
+    }
+
+    private TimeSpan Reserve(int bytes, BandwidthClass transferClass)
+    {
+        lock (_lock)
+        {
+            var index = (int)transferClass;
+            if (_credit[index] >= bytes)
+            {
+                _credit[index] -= bytes;
+                return TimeSpan.Zero;
+            }
+
+            bytes -= (int)_credit[index];
+            _credit[index] = 0;
+
+            // While unlimited, look at the file only every so often for a new policy
+            var now = DateTime.UtcNow;
+            if (_limitBytesPerSecond == 0 && now < _nextUnlimitedCheck && ComputeFingerprint() == _localFingerprint)
+                return TimeSpan.Zero;
+
+            var wait = TimeSpan.Zero;
+            WithFile(state =>
+            {
+                if (_limitBytesPerSecond == 0)
+                {
+                    _nextUnlimitedCheck = now + UnlimitedRecheckInterval;
+                    return;
+                }
+
+                state.Tokens[index] -= bytes;
+                if (state.Tokens[index] < 0)
+                    wait = TimeSpan.FromSeconds(-state.Tokens[index] / state.Rates[index]);
+            });
+
+            return wait;
+        }
+    }
+
+    private void EndTransfer(BandwidthClass transferClass)
+    {
+        lock (_lock)
+        {
+            _active[(int)transferClass]--;
+            _credit[(int)transferClass] = 0;
+            WithFile(_ => { });
+        }
+    }
+
+    /// <summary>
+    /// Locks the coordination file, brings policy, slot and buckets up to date,
+    /// runs <paramref name="update"/> on the state and writes it back.
+    /// Callers hold <see cref="_lock"/>.
+    /// </summary>
+    private void WithFile(Action<SharedState> update)
+    {
+        try
+        {
+            using var file = OpenLocked();
+            var header = new byte[PolicyOffset];
+            var read = file.Length >= FileLength ? file.Read(header) : 0;
+            var fresh = read < PolicyOffset || BinaryPrimitives.ReadUInt32LittleEndian(header) != Magic;
+            if (fresh)
+            {
+                Array.Clear(header);
+                BinaryPrimitives.WriteUInt32LittleEndian(header, Magic);
+                file.SetLength(FileLength);
+            }
+
+            var now = DateTime.UtcNow;
+            var state = SharedState.Read(header);
+            SyncPolicy(file, state, fresh);
+            _limitBytesPerSecond = _schedule.LimitAt(now.ToLocalTime(), _policy.LimitKbps) * 1024L;
+
+            var demand = UpdateSlots(state, now);
+            Refill(state, demand, now);
+            update(state);
+
+            state.Write(header);
+            file.Position = 0;
+            file.Write(header);
+        }
+        catch (IOException ex)
+        {
+            // Never fail a download over coordination; the limit is lifted until the file works again
+            _logger?.LogWarning(ex, "Bandwidth coordination file {Path} is unusable", _path);
+            _limitBytesPerSecond = 0;
+        }
+    }
+
+    /// <summary>
+    /// Publishes the local settings if they changed since last published, or
+    /// loads settings another process published since.
+    /// </summary>
+    private void SyncPolicy(FileStream file, SharedState state, bool fresh)
+    {
+        var fingerprint = ComputeFingerprint();
+        if (fresh || fingerprint != _localFingerprint)
+        {
+            _localFingerprint = fingerprint;
+            var policy = new BandwidthPolicy
+            {
+                LimitKbps = _settings.BandwidthLimitKbps,
+                Schedule = [.. _settings.BandwidthSchedule],
+                InteractiveWeight = _settings.BandwidthInteractiveWeight,
+                BackgroundWeight = _settings.BandwidthBackgroundWeight
+            };
+            var json = JsonSerializer.SerializeToUtf8Bytes(policy);
+            if (json.Length > FileLength - PolicyOffset - 4)
+            {
+                _logger?.LogWarning("Bandwidth schedule is too long to share with other processes; using it locally only");
+            }
+            else
+            {
+                var block = new byte[4 + json.Length];
+                BinaryPrimitives.WriteInt32LittleEndian(block, json.Length);
+                json.CopyTo(block, 4);
+                file.Position = PolicyOffset;
+                file.Write(block);
+                state.PolicyStamp = Math.Max(DateTime.UtcNow.Ticks, state.PolicyStamp + 1);
+            }
+
+            _policyStamp = state.PolicyStamp;
+            Use(policy);
+            return;
+        }
+
+        if (state.PolicyStamp == _policyStamp)
+            return;
+
+        _policyStamp = state.PolicyStamp;
+        try
+        {
+            var lengthBytes = new byte[4];
+            file.Position = PolicyOffset;
+            file.ReadExactly(lengthBytes);
+            var length = BinaryPrimitives.ReadInt32LittleEndian(lengthBytes);
+            var json = new byte[Math.Clamp(length, 0, FileLength - PolicyOffset - 4)];
+            file.ReadExactly(json);
+            Use(JsonSerializer.Deserialize<BandwidthPolicy>(json) ?? new BandwidthPolicy());
+            _logger?.LogDebug("Applied bandwidth policy published by another process: {Policy}", Encoding.UTF8.GetString(json));
+        }
+        catch (Exception ex) when (ex is JsonException or EndOfStreamException)
+        {
+            _logger?.LogWarning(ex, "Ignoring unreadable bandwidth policy in {Path}", _path);
+        }
+    }
+
+    private void Use(BandwidthPolicy policy)
+    {
+        _policy = policy;
+        try
+        {
+            _schedule = BandwidthSchedule.Parse(policy.Schedule);
+        }
+        catch (FormatException ex)
+        {
+            _logger?.LogWarning(ex, "Ignoring invalid bandwidth schedule");
+            _schedule = BandwidthSchedule.Empty;
+        }
+    }
+
+    /// <summary>
+    /// Writes this governor's transfer counts to its slot and sums the live
+    /// slots into the number of running transfers per class.
+    /// </summary>
+    private int[] UpdateSlots(SharedState state, DateTime now)
+    {
+        var own = -1;
+        var free = -1;
+        for (var i = 0; i < SlotCount; i++)
+        {
+            var slot = state.Slots[i];
+            if (slot.ProcessId == _processId && slot.InstanceId == _instanceId)
+                own = i;
+            else if (free < 0 && (slot.ProcessId == 0 || now.Ticks - slot.Heartbeat > SlotTimeout.Ticks))
+                free = i;
+        }
+
+        var busy = _active[0] > 0 || _active[1] > 0;
+        if (own < 0 && busy)
+        {
+            own = free;
+            if (own < 0)
+                _logger?.LogDebug("All bandwidth slots are taken; this process's transfers don't claim a share");
+        }
+
+        if (own >= 0)
+        {
+            state.Slots[own] = busy
+                ? new Slot(_processId, _instanceId, now.Ticks, _active[0], _active[1])
+                : default;
+        }
+
+        var demand = new int[ClassCount];
+        foreach (var slot in state.Slots)
+        {
+            if (slot.ProcessId == 0 || now.Ticks - slot.Heartbeat > SlotTimeout.Ticks)
+                continue;
+            demand[0] += slot.Interactive;
+            demand[1] += slot.Background;
+        }
+
+        return demand;
+    }
+
+    /// <summary>
+    /// Splits the limit between the classes with transfers by weight, adds
+    /// the tokens earned since the last refill and hands what a class can't
+    /// hold to the others.
+    /// </summary>
+    private void Refill(SharedState state, int[] demand, DateTime now)
+    {
+        var elapsed = Math.Clamp((now.Ticks - state.LastRefill) / (double)TimeSpan.TicksPerSecond, 0, 1);
+        state.LastRefill = now.Ticks;
+
+        // A reservation counts its own class as busy even without BeginTransfer
+        var weights = new[] { Math.Max(1, _policy.InteractiveWeight), Math.Max(1, _policy.BackgroundWeight) };
+        var active = new bool[ClassCount];
+        var totalWeight = 0;
+        for (var c = 0; c < ClassCount; c++)
+        {
+            active[c] = demand[c] > 0 || _active[c] > 0;
+            if (active[c])
+                totalWeight += weights[c];
+        }
+
+        double spill = 0;
+        for (var c = 0; c < ClassCount; c++)
+        {
+            state.Rates[c] = totalWeight > 0 && active[c] ? (double)_limitBytesPerSecond * weights[c] / totalWeight : 0;
+            if (!active[c] || _limitBytesPerSecond == 0)
+            {
+                state.Tokens[c] = 0;
+                continue;
+            }
+
+            state.Tokens[c] += state.Rates[c] * elapsed;
+            var capacity = state.Rates[c] * BurstSeconds;
+            if (state.Tokens[c] > capacity)
+            {
+                spill += state.Tokens[c] - capacity;
+                state.Tokens[c] = capacity;
+            }
+        }
+
+        for (var c = 0; c < ClassCount && spill > 0; c++)
+        {
+            if (!active[c])
+                continue;
+            var room = state.Rates[c] * BurstSeconds - state.Tokens[c];
+            var share = Math.Min(room, spill);
+            state.Tokens[c] += share;
+            spill -= share;
+        }
+
+        // Keeps the wait computation finite for a class that just became busy
+        for (var c = 0; c < ClassCount; c++)
+            state.Rates[c] = Math.Max(state.Rates[c], 1);
+    }
+
+    private FileStream OpenLocked()
+    {
+        Directory.CreateDirectory(Path.GetDirectoryName(Path.GetFullPath(_path))!);
+        var spin = new SpinWait();
+        var deadline = DateTime.UtcNow.AddSeconds(2);
+        while (true)
+        {
+            try
+            {
+                // FileShare.None is an exclusive lock on the open file, which also excludes other governors in this process
+                return new FileStream(_path, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.None, 1, FileOptions.None);
+            }
+            catch (IOException) when (DateTime.UtcNow < deadline && File.Exists(_path))
+            {
+                spin.SpinOnce(sleep1Threshold: 10);
+            }
+        }
+    }
+
+    private int ComputeFingerprint()
+    {
+        var hash = new HashCode();
+        hash.Add(_settings.BandwidthLimitKbps);
+        hash.Add(_settings.BandwidthInteractiveWeight);
+        hash.Add(_settings.BandwidthBackgroundWeight);
+        foreach (var rule in _settings.BandwidthSchedule)
+            hash.Add(rule);
+        return hash.ToHashCode();
+    }
+
+    private sealed class BandwidthPolicy
+    {
+        [JsonPropertyName("limit_kbps")]
+        public int LimitKbps { get; set; }
+
+        [JsonPropertyName("schedule")]
+        public List<string> Schedule { get; set; } = [];
+
+        [JsonPropertyName("interactive_weight")]
+        public int InteractiveWeight { get; set; } = 3;
+
+        [JsonPropertyName("background_weight")]
+        public int BackgroundWeight { get; set; } = 1;
+    }
+
+    private readonly record struct Slot(int ProcessId, int InstanceId, long Heartbeat, int Interactive, int Background);
+
+    /// <summary>
+    /// Header of the coordination file: magic, policy stamp, last refill,
+    /// the two buckets, then the process slots.
+    /// </summary>
+    private sealed class SharedState
+    {
+        public long PolicyStamp;
+        public long LastRefill;
+        public readonly double[] Tokens = new double[ClassCount];
+        public readonly double[] Rates = new double[ClassCount];
+        public readonly Slot[] Slots = new Slot[SlotCount];
+
+        public static SharedState Read(ReadOnlySpan<byte> header)
+        {
+            var state = new SharedState
+            {
+                PolicyStamp = BinaryPrimitives.ReadInt64LittleEndian(header[8..]),
+                LastRefill = BinaryPrimitives.ReadInt64LittleEndian(header[16..])
+            };
+            state.Tokens[0] = BinaryPrimitives.ReadDoubleLittleEndian(header[24..]);
+            state.Tokens[1] = BinaryPrimitives.ReadDoubleLittleEndian(header[32..]);
+            for (var i = 0; i < SlotCount; i++)
+            {
+                var slot = header[(HeaderLength + i * SlotLength)..];
+                state.Slots[i] = new Slot(
+                    BinaryPrimitives.ReadInt32LittleEndian(slot),
+                    BinaryPrimitives.ReadInt32LittleEndian(slot[4..]),
+                    BinaryPrimitives.ReadInt64LittleEndian(slot[8..]),
+                    BinaryPrimitives.ReadInt32LittleEndian(slot[16..]),
+                    BinaryPrimitives.ReadInt32LittleEndian(slot[20..]));
+            }
+
+            return state;
+        }
+
+        public void Write(Span<byte> header)
+        {
+            BinaryPrimitives.WriteInt64LittleEndian(header[8..], PolicyStamp);
+            BinaryPrimitives.WriteInt64LittleEndian(header[16..], LastRefill);
+            BinaryPrimitives.WriteDoubleLittleEndian(header[24..], Tokens[0]);
+            BinaryPrimitives.WriteDoubleLittleEndian(header[32..], Tokens[1]);
+            for (var i = 0; i < SlotCount; i++)
+            {
+                var slot = header[(HeaderLength + i * SlotLength)..];
+                BinaryPrimitives.WriteInt32LittleEndian(slot, Slots[i].ProcessId);
+                BinaryPrimitives.WriteInt32LittleEndian(slot[4..], Slots[i].InstanceId);
+                BinaryPrimitives.WriteInt64LittleEndian(slot[8..], Slots[i].Heartbeat);
+                BinaryPrimitives.WriteInt32LittleEndian(slot[16..], Slots[i].Interactive);
+                BinaryPrimitives.WriteInt32LittleEndian(slot[20..], Slots[i].Background);
+            }
+        }
+    }
+
+    private sealed class TransferRegistration(BandwidthGovernor governor, BandwidthClass transferClass) : IDisposable
+    {
+        private int _disposed;
+
+        public void Dispose()
+        {
+            if (Interlocked.Exchange(ref _disposed, 1) == 0)
+                governor.EndTransfer(transferClass);
+        }
+    }
+
+    /// <summary>
+    /// Read-only wrapper that reserves bandwidth before every read.
+    /// </summary>
+    private sealed class ThrottledStream : Stream
+    {
+        private readonly BandwidthGovernor _governor;
+        private readonly Stream _inner;
+        private readonly BandwidthClass _class;
+        private readonly IDisposable _registration;
+
+        public ThrottledStream(BandwidthGovernor governor, Stream inner, BandwidthClass transferClass)
+        {
+            _governor = governor;
+            _inner = inner;
+            _class = transferClass;
+            _registration = governor.BeginTransfer(transferClass);
+        }
+
+        public override bool CanRead => true;
+        public override bool CanSeek => false;
+        public override bool CanWrite => false;
+        public override long Length => _inner.Length;
+
+        public override long Position
+        {
+            get => _inner.Position;
+            set => throw new NotSupportedException();
+        }
+
+        public override int Read(byte[] buffer, int offset, int count) =>
+            ReadAsync(buffer.AsMemory(offset, count)).AsTask().GetAwaiter().GetResult();
+
+        public override async ValueTask<int> ReadAsync(Memory<byte> buffer, CancellationToken cancellationToken = default)
+        {
+            var count = Math.Min(buffer.Length, _governor.ChunkSize);
+            if (count == 0)
+                return 0;
+
+            await _governor.AcquireAsync(count, _class, cancellationToken);
+            var read = await _inner.ReadAsync(buffer[..count], cancellationToken);
+            if (read < count)
+                _governor.Refund(count - read, _class);
+            return read;
+        }
+
+        public override Task<int> ReadAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken) =>
+            ReadAsync(buffer.AsMemory(offset, count), cancellationToken).AsTask();
+
+        public override void Flush()
+        {
+        }
+
+        public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+
+        public override void SetLength(long value) => throw new NotSupportedException();
+
+        public override void Write(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+
+        protected override void Dispose(bool disposing)
+        {
+            if (disposing)
+            {
+                _registration.Dispose();
+                _inner.Dispose();
+            }
+
+            base.Dispose(disposing);
+        }
+
+        public override async ValueTask DisposeAsync()
+        {
+            _registration.Dispose();
+            await _inner.DisposeAsync();
+            GC.SuppressFinalize(this);
+        }
+    }
+}
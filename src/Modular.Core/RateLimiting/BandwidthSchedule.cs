@@ -0,0 +1,121 @@
+using System.Globalization;
+
+namespace Modular.Core.RateLimiting;
+
+/// <summary>
+/// Time-of-day bandwidth limits, parsed from rules of the form
+/// <c>&lt;days&gt; &lt;HH:mm&gt;-&lt;HH:mm&gt; &lt;KB/s&gt;</c>, for example
+/// <c>mon-fri 09:00-18:00 512</c> or <c>* 23:00-07:00 0</c>. Days are
+/// <c>*</c>, a day name, a range (<c>mon-fri</c>) or a comma list of those.
+/// A window whose end is before its start runs past midnight and belongs to
+/// the day it starts on. A limit of 0 means unlimited. The first matching
+/// rule wins; outside every window the default limit applies.
+/// </summary>
+public sealed class BandwidthSchedule
+{
+    private static readonly string[] DayNames = ["sun", "mon", "tue", "wed", "thu", "fri", "sat"];
+
+    private readonly List<Rule> _rules;
+
+    private BandwidthSchedule(List<Rule> rules) => _rules = rules;
+
+    /// <summary>
+    /// A schedule without rules.
+    /// </summary>
+    public static BandwidthSchedule Empty { get; } = new([]);
+
+    /// <summary>
+    /// Number of rules.
+    /// </summary>
+    public int Count => _rules.Count;
+
+    /// <summary>
+    /// Parses <paramref name="rules"/>.
+    /// </summary>
+    /// <exception cref="FormatException">A rule is malformed; the message names it.</exception>
+    public static BandwidthSchedule Parse(IEnumerable<string> rules) =>
+        new(rules.Where(r => !string.IsNullOrWhiteSpace(r)).Select(ParseRule).ToList());
+
+    /// <summary>
+    /// Limit in KB/s at <paramref name="localTime"/>, or
+    /// <paramref name="defaultKbps"/> when no rule covers it.
+    /// </summary>
+    public int LimitAt(DateTime localTime, int defaultKbps)
+    {
+        var time = localTime.TimeOfDay;
+        var day = localTime.DayOfWeek;
+        var previousDay = (DayOfWeek)(((int)day + 6) % 7);
+
+        foreach (var rule in _rules)
+        {
+            var matches = rule.Start < rule.End
+                ? rule.Days[(int)day] && time >= rule.Start && time < rule.End
+                : (rule.Days[(int)day] && time >= rule.Start) || (rule.Days[(int)previousDay] && time < rule.End);
+            if (matches)
+                return rule.Kbps;
+        }
+
+        return defaultKbps;
+    }
+
+    private static Rule ParseRule(string text)
+    {
+        var parts = text.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+        if (parts.Length != 3)
+            throw new FormatException($"Bandwidth rule '{text}' must be '<days> <HH:mm>-<HH:mm> <KB/s>'");
+
+        var window = parts[1].Split('-');
+        if (window.Length != 2
+            || !TryParseTime(window[0], out var start)
+            || !TryParseTime(window[1], out var end)
+            || start == end)
+            throw new FormatException($"Bandwidth rule '{text}' has an invalid time window '{parts[1]}'");
+
+        if (!int.TryParse(parts[2], NumberStyles.None, CultureInfo.InvariantCulture, out var kbps))
+            throw new FormatException($"Bandwidth rule '{text}' has an invalid limit '{parts[2]}'");
+
+        return new Rule(ParseDays(parts[0], text), start, end, kbps);
+    }
+
+    private static bool[] ParseDays(string text, string rule)
+    {
+        var days = new bool[7];
+        if (text == "*")
+        {
+            Array.Fill(days, true);
+            return days;
+        }
+
+        foreach (var item in text.ToLowerInvariant().Split(','))
+        {
+            var range = item.Split('-');
+            var first = Array.IndexOf(DayNames, range[0]);
+            var last = range.Length == 2 ? Array.IndexOf(DayNames, range[1]) : first;
+            if (range.Length > 2 || first < 0 || last < 0)
+                throw new FormatException($"Bandwidth rule '{rule}' has an invalid day '{item}'");
+
+            // Ranges may wrap the week (fri-mon)
+            for (var d = first; ; d = (d + 1) % 7)
+            {
+                days[d] = true;
+                if (d == last)
+                    break;
+            }
+        }
+
+        return days;
+    }
+
+    private static bool TryParseTime(string text, out TimeSpan time)
+    {
+        if (text == "24:00")
+        {
+            time = TimeSpan.FromDays(1);
+            return true;
+        }
+
+        return TimeSpan.TryParseExact(text, @"hh\:mm", CultureInfo.InvariantCulture, out time);
+    }
+
+    private sealed record Rule(bool[] Days, TimeSpan Start, TimeSpan End, int Kbps);
+}
@@ -29,6 +29,12 @@ public interface IRateLimiter
     /// </summary>
     void ReserveRequest();
 
+    /// <summary>
+    /// Forgets the tracked limits and starts again from the defaults. Limits
+    /// belong to an account, so call this when the API key changes.
+    /// </summary>
+    void Reset();
+
     /// <summary>
     /// Save rate limit state to file.
     /// </summary>
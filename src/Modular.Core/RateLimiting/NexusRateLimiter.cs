@@ -23,8 +23,8 @@ public class NexusRateLimiter : IRateLimiter
     private int _dailyRemaining = 20000;
     private int _hourlyLimit = 500;
     private int _hourlyRemaining = 500;
-    private DateTimeOffset _dailyReset = DateTimeOffset.UtcNow.Date.AddDays(1);
-    private DateTimeOffset _hourlyReset = new DateTimeOffset(DateTimeOffset.UtcNow.Year, DateTimeOffset.UtcNow.Month, DateTimeOffset.UtcNow.Day, DateTimeOffset.UtcNow.Hour, 0, 0, TimeSpan.Zero).AddHours(1);
+    private DateTimeOffset _dailyReset = NextDailyReset();
+    private DateTimeOffset _hourlyReset = NextHourlyReset();
 
     public NexusRateLimiter(ILogger<NexusRateLimiter>? logger = null)
     {
@@ -61,6 +61,30 @@ public class NexusRateLimiter : IRateLimiter
         get { lock (_lock) return _hourlyReset; }
     }
 
+    /// <inheritdoc />
+    public void Reset()
+    {
+        lock (_lock)
+        {
+            _dailyLimit = 20000;
+            _dailyRemaining = 20000;
+            _hourlyLimit = 500;
+            _hourlyRemaining = 500;
+            _dailyReset = NextDailyReset();
+            _hourlyReset = NextHourlyReset();
+        }
+
+        _logger?.LogDebug("Rate limit state reset");
+    }
+
+    private static DateTimeOffset NextDailyReset() => DateTimeOffset.UtcNow.Date.AddDays(1);
+
+    private static DateTimeOffset NextHourlyReset()
+    {
+        var now = DateTimeOffset.UtcNow;
+        return new DateTimeOffset(now.Year, now.Month, now.Day, now.Hour, 0, 0, TimeSpan.Zero).AddHours(1);
+    }
+
     /// <inheritdoc />
     public void UpdateFromHeaders(IEnumerable<KeyValuePair<string, IEnumerable<string>>> headers)
     {
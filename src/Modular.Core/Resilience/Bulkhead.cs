@@ -0,0 +1,78 @@
+using Modular.Core.Exceptions;
+
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Caps how many calls to one key run at once, with a bounded wait queue.
+/// A slow host or a hung plugin can then only hold its own slots instead of
+/// every thread and connection the process has.
+/// </summary>
+public sealed class Bulkhead
+{
+    private readonly SemaphoreSlim _slots;
+    private readonly int _maxQueue;
+    private int _queued;
+
+    public Bulkhead(string key, int maxConcurrency, int maxQueue)
+    {
+        Key = key;
+        MaxConcurrency = Math.Max(1, maxConcurrency);
+        _maxQueue = Math.Max(0, maxQueue);
+        _slots = new SemaphoreSlim(MaxConcurrency, MaxConcurrency);
+    }
+
+    public string Key { get; }
+    public int MaxConcurrency { get; }
+    public int Running => MaxConcurrency - _slots.CurrentCount;
+    public int Queued => Volatile.Read(ref _queued);
+
+    /// <summary>
+    /// Waits for a slot; dispose the result to free it.
+    /// </summary>
+    /// <exception cref="BulkheadRejectedException">The wait queue is full.</exception>
+    public async Task<IDisposable> EnterAsync(CancellationToken ct = default)
+    {
+        if (_slots.Wait(0, CancellationToken.None))
+            return new Lease(_slots);
+
+        if (Interlocked.Increment(ref _queued) > _maxQueue)
+        {
+            Interlocked.Decrement(ref _queued);
+            throw new BulkheadRejectedException(Key, MaxConcurrency, _maxQueue);
+        }
+
+        try
+        {
+            await _slots.WaitAsync(ct);
+        }
+        finally
+        {
+            Interlocked.Decrement(ref _queued);
+        }
+
+        return new Lease(_slots);
+    }
+
+    private sealed class Lease : IDisposable
+    {
+        private SemaphoreSlim? _slots;
+
+        public Lease(SemaphoreSlim slots) => _slots = slots;
+
+        public void Dispose() => Interlocked.Exchange(ref _slots, null)?.Release();
+    }
+}
+
+/// <summary>
+/// Thrown when a bulkhead's slots and wait queue are all taken.
+/// </summary>
+public class BulkheadRejectedException : ModularException
+{
+    public BulkheadRejectedException(string key, int maxConcurrency, int maxQueue)
+        : base($"Too many concurrent calls to '{key}' ({maxConcurrency} running, {maxQueue} queued)")
+    {
+        Key = key;
+    }
+
+    public string Key { get; }
+}
@@ -0,0 +1,153 @@
+using Modular.Core.Exceptions;
+
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// State of a circuit breaker.
+/// </summary>
+public enum CircuitState
+{
+    /// <summary>Calls flow normally.</summary>
+    Closed,
+
+    /// <summary>Calls are rejected without being attempted.</summary>
+    Open,
+
+    /// <summary>The break has elapsed; one probe call decides whether to close again.</summary>
+    HalfOpen
+}
+
+/// <summary>
+/// Consecutive-failure circuit breaker for one key (a host, a mount, a plugin).
+/// After <c>threshold</c> transient failures in a row the circuit opens and
+/// calls fail fast for the break duration; then a single probe is let through
+/// and its outcome closes or re-opens the circuit.
+/// </summary>
+public sealed class CircuitBreaker
+{
+    private readonly object _lock = new();
+    private readonly int _threshold;
+    private readonly TimeSpan _breakDuration;
+    private readonly TimeProvider _time;
+    private CircuitState _state = CircuitState.Closed;
+    private int _failures;
+    private DateTimeOffset _openedAt;
+    private bool _probeInFlight;
+
+    public CircuitBreaker(string key, int threshold, TimeSpan breakDuration, TimeProvider? time = null)
+    {
+        Key = key;
+        _threshold = Math.Max(1, threshold);
+        _breakDuration = breakDuration;
+        _time = time ?? TimeProvider.System;
+    }
+
+    public string Key { get; }
+
+    public CircuitState State
+    {
+        get
+        {
+            lock (_lock)
+            {
+                return _state == CircuitState.Open && _time.GetUtcNow() >= _openedAt + _breakDuration
+                    ? CircuitState.HalfOpen
+                    : _state;
+            }
+        }
+    }
+
+    /// <summary>
+    /// When an open circuit lets its next probe through.
+    /// </summary>
+    public DateTimeOffset RetryAt
+    {
+        get { lock (_lock) return _openedAt + _breakDuration; }
+    }
+
+    /// <summary>
+    /// Asks to make a call. False while the circuit is open, or while a
+    /// half-open circuit's probe is still running.
+    /// </summary>
+    public bool TryAcquire()
+    {
+        lock (_lock)
+        {
+            if (_state == CircuitState.Open)
+            {
+                if (_time.GetUtcNow() < _openedAt + _breakDuration)
+                    return false;
+                _state = CircuitState.HalfOpen;
+            }
+
+            if (_state == CircuitState.HalfOpen)
+            {
+                if (_probeInFlight)
+                    return false;
+                _probeInFlight = true;
+            }
+
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// The call worked, or failed in a way that says nothing about the key's health.
+    /// </summary>
+    public void RecordSuccess()
+    {
+        lock (_lock)
+        {
+            _state = CircuitState.Closed;
+            _failures = 0;
+            _probeInFlight = false;
+        }
+    }
+
+    /// <summary>
+    /// The call failed transiently. Returns true if this opened the circuit.
+    /// </summary>
+    public bool RecordFailure()
+    {
+        lock (_lock)
+        {
+            _probeInFlight = false;
+            if (_state == CircuitState.HalfOpen || ++_failures >= _threshold)
+            {
+                var opened = _state != CircuitState.Open;
+                _state = CircuitState.Open;
+                _openedAt = _time.GetUtcNow();
+                _failures = 0;
+                return opened;
+            }
+
+            return false;
+        }
+    }
+
+    /// <summary>
+    /// The call was cancelled before it said anything about the key's health.
+    /// </summary>
+    public void RecordAbandoned()
+    {
+        lock (_lock) _probeInFlight = false;
+    }
+}
+
+/// <summary>
+/// Thrown instead of attempting a call whose circuit is open.
+/// </summary>
+public class CircuitOpenException : ModularException
+{
+    public CircuitOpenException(ResilienceCategory category, string key, DateTimeOffset retryAt)
+        : base($"Circuit for {category} '{key}' is open until {retryAt:HH:mm:ss}")
+    {
+        Category = category;
+        Key = key;
+        RetryAt = retryAt;
+    }
+
+    public ResilienceCategory Category { get; }
+    public string Key { get; }
+    public DateTimeOffset RetryAt { get; }
+}
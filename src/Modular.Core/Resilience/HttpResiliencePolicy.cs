@@ -0,0 +1,39 @@
+using Modular.FluentHttp.Interfaces;
+
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Runs FluentHttp requests through a <see cref="ResilienceEngine"/>: circuits
+/// and bulkheads per host, retries limited by the request's own retry
+/// configuration, and hedging for GET and HEAD requests.
+/// </summary>
+public sealed class HttpResiliencePolicy : IRequestPolicy
+{
+    private readonly ResilienceEngine _engine;
+
+    public HttpResiliencePolicy(ResilienceEngine? engine = null)
+    {
+        _engine = engine ?? ResilienceEngine.Shared;
+    }
+
+    public Task<IResponse> ExecuteAsync(
+        RequestPolicyContext context,
+        Func<CancellationToken, Task<IResponse>> attempt,
+        CancellationToken ct)
+    {
+        return _engine.ExecuteAsync(
+            ResilienceCategory.Http,
+            HostKey(context.Url),
+            attempt,
+            idempotent: context.Hedgeable,
+            maxRetries: context.MaxRetries,
+            isTransientResult: r => !r.IsSuccessStatusCode && context.RetryConfig.ShouldRetry(r.StatusCode, false),
+            ct: ct);
+    }
+
+    /// <summary>
+    /// Circuit key for a request URL: host and port.
+    /// </summary>
+    public static string HostKey(string url) =>
+        Uri.TryCreate(url, UriKind.Absolute, out var uri) ? uri.Authority.ToLowerInvariant() : "relative";
+}
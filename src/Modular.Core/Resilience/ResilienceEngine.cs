@@ -0,0 +1,354 @@
+using System.Collections.Concurrent;
+using System.Runtime.ExceptionServices;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Telemetry;
+using Modular.Core.Utilities;
+
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Runs operations under the resilience policy of their category: bulkhead
+/// admission, circuit breaking, retries with jittered exponential backoff
+/// drawn from a retry budget, and hedging for idempotent calls. Circuits and
+/// bulkheads are per key (host, mount, plugin), so one bad dependency is
+/// isolated from the rest of its category.
+/// </summary>
+public sealed class ResilienceEngine
+{
+    private readonly Dictionary<ResilienceCategory, ResiliencePolicy> _policies = new();
+    private readonly Dictionary<ResilienceCategory, RetryBudget> _budgets = new();
+    private readonly Dictionary<ResilienceCategory, ResilienceMetrics> _metrics = new();
+    private readonly ConcurrentDictionary<(ResilienceCategory, string), CircuitBreaker> _breakers = new();
+    private readonly ConcurrentDictionary<(ResilienceCategory, string), Bulkhead> _bulkheads = new();
+    private readonly ILogger<ResilienceEngine>? _logger;
+    private readonly TelemetryService? _telemetry;
+    private readonly TimeProvider _time;
+
+    /// <summary>
+    /// Creates an engine.
+    /// </summary>
+    /// <param name="policies">Policies to replace the defaults of <see cref="ResiliencePolicy.For"/>, by category.</param>
+    /// <param name="logger">Optional logger.</param>
+    /// <param name="telemetry">Receives an event whenever a circuit opens.</param>
+    /// <param name="time">Clock for circuit breaks and backoff.</param>
+    public ResilienceEngine(
+        IReadOnlyDictionary<ResilienceCategory, ResiliencePolicy>? policies = null,
+        ILogger<ResilienceEngine>? logger = null,
+        TelemetryService? telemetry = null,
+        TimeProvider? time = null)
+    {
+        _logger = logger;
+        _telemetry = telemetry;
+        _time = time ?? TimeProvider.System;
+
+        foreach (var category in Enum.GetValues<ResilienceCategory>())
+        {
+            var policy = policies?.GetValueOrDefault(category) ?? ResiliencePolicy.For(category);
+            _policies[category] = policy;
+            _budgets[category] = new RetryBudget(policy.RetryBudgetRatio, policy.RetryBudgetReserve);
+            _metrics[category] = new ResilienceMetrics();
+        }
+    }
+
+    /// <summary>
+    /// Process-wide engine with default policies. Circuits only help if
+    /// everything talking to a host or mount shares them, so code that isn't
+    /// handed an engine uses this one.
+    /// </summary>
+    public static ResilienceEngine Shared { get; } = new();
+
+    public ResiliencePolicy GetPolicy(ResilienceCategory category) => _policies[category];
+
+    /// <summary>
+    /// Runs <paramref name="action"/> under the policy of <paramref name="category"/>.
+    /// </summary>
+    /// <param name="category">Operation category, selecting the policy.</param>
+    /// <param name="key">Host, mount or plugin the operation depends on.</param>
+    /// <param name="action">One attempt. Called again on retry, and concurrently when hedging.</param>
+    /// <param name="idempotent">Whether a slow attempt may be hedged.</param>
+    /// <param name="maxRetries">Lowers the policy's retry limit for this call.</param>
+    /// <param name="isTransientResult">Marks results that should be retried like a transient failure.
+    /// If retries run out, the last such result is returned rather than thrown.</param>
+    /// <param name="ct">Cancellation token.</param>
+    /// <exception cref="CircuitOpenException">The key's circuit is open.</exception>
+    /// <exception cref="BulkheadRejectedException">Too many calls to the key are already waiting.</exception>
+    public async Task<T> ExecuteAsync<T>(
+        ResilienceCategory category,
+        string key,
+        Func<CancellationToken, Task<T>> action,
+        bool idempotent = false,
+        int? maxRetries = null,
+        Func<T, bool>? isTransientResult = null,
+        CancellationToken ct = default)
+    {
+        var policy = _policies[category];
+        var metrics = _metrics[category];
+        var budget = _budgets[category];
+        var retries = Math.Min(policy.MaxRetries, maxRetries ?? policy.MaxRetries);
+        var hedgeDelay = idempotent ? policy.HedgeDelay : null;
+
+        var breaker = policy.FailureThreshold > 0
+            ? _breakers.GetOrAdd((category, key), _ => new CircuitBreaker(key, policy.FailureThreshold, policy.BreakDuration, _time))
+            : null;
+        var bulkhead = policy.MaxConcurrency > 0
+            ? _bulkheads.GetOrAdd((category, key), _ => new Bulkhead(key, policy.MaxConcurrency, policy.MaxQueue))
+            : null;
+
+        metrics.RecordCall();
+        var started = _time.GetTimestamp();
+        try
+        {
+            IDisposable? lease = null;
+            if (bulkhead != null)
+            {
+                try
+                {
+                    lease = await bulkhead.EnterAsync(ct);
+                }
+                catch (BulkheadRejectedException)
+                {
+                    metrics.RecordBulkheadRejection();
+                    throw;
+                }
+            }
+
+            using (lease)
+            {
+                budget.Deposit();
+
+                for (var attempt = 0; ; attempt++)
+                {
+                    if (breaker != null && !breaker.TryAcquire())
+                    {
+                        metrics.RecordCircuitRejection();
+                        throw new CircuitOpenException(category, key, breaker.RetryAt);
+                    }
+
+                    var result = default(T)!;
+                    Exception? error = null;
+                    try
+                    {
+                        result = hedgeDelay != null
+                            ? await HedgedAsync(action, hedgeDelay.Value, isTransientResult, metrics, ct)
+                            : await action(ct);
+                    }
+                    catch (Exception ex) when (!ct.IsCancellationRequested)
+                    {
+                        error = ex;
+                    }
+                    catch
+                    {
+                        breaker?.RecordAbandoned();
+                        throw;
+                    }
+
+                    var transient = error != null
+                        ? (policy.IsTransient ?? (e => TransientErrors.IsTransient(category, e)))(error)
+                        : isTransientResult?.Invoke(result) == true;
+
+                    if (!transient)
+                    {
+                        // A permanent error still proves the dependency answered
+                        breaker?.RecordSuccess();
+                        if (error == null)
+                        {
+                            metrics.RecordSuccess();
+                            return result;
+                        }
+
+                        metrics.RecordFailure();
+                        ExceptionDispatchInfo.Throw(error);
+                    }
+
+                    var opened = breaker?.RecordFailure() == true;
+                    if (opened)
+                        OnCircuitOpened(category, key, error);
+
+                    if (opened || attempt >= retries || !CanRetry(budget, metrics, category, key))
+                    {
+                        metrics.RecordFailure();
+                        if (error != null)
+                            ExceptionDispatchInfo.Throw(error);
+                        return result;
+                    }
+
+                    (result as IDisposable)?.Dispose();
+                    metrics.RecordRetry();
+
+                    var delay = policy.GetDelay(attempt, Random.Shared);
+                    _logger?.LogWarning("{Category} call to {Key} failed ({Reason}), retry {Retry}/{MaxRetries} in {Delay}ms",
+                        category, key, error?.Message ?? "transient result", attempt + 1, retries, (int)delay.TotalMilliseconds);
+                    await Task.Delay(delay, _time, ct);
+                }
+            }
+        }
+        finally
+        {
+            metrics.RecordLatency(_time.GetElapsedTime(started));
+        }
+    }
+
+    /// <summary>
+    /// Runs <paramref name="action"/> under the policy of <paramref name="category"/>.
+    /// </summary>
+    public Task ExecuteAsync(
+        ResilienceCategory category,
+        string key,
+        Func<CancellationToken, Task> action,
+        bool idempotent = false,
+        CancellationToken ct = default) =>
+        ExecuteAsync(category, key, async token =>
+        {
+            await action(token);
+            return true;
+        }, idempotent, ct: ct);
+
+    /// <summary>
+    /// Runs a filesystem operation on <paramref name="path"/>, keyed by the mount it lives on.
+    /// </summary>
+    public Task ExecuteFileAsync(string path, Action action, CancellationToken ct = default) =>
+        ExecuteAsync(ResilienceCategory.FileSystem, MountKey(path), _ =>
+        {
+            action();
+            return Task.CompletedTask;
+        }, ct: ct);
+
+    /// <summary>
+    /// Runs a filesystem operation on <paramref name="path"/>, keyed by the mount it lives on.
+    /// </summary>
+    public Task<T> ExecuteFileAsync<T>(string path, Func<CancellationToken, Task<T>> action, CancellationToken ct = default) =>
+        ExecuteAsync(ResilienceCategory.FileSystem, MountKey(path), action, ct: ct);
+
+    /// <summary>
+    /// Current state of the circuit for a key; closed if it has never been used.
+    /// </summary>
+    public CircuitState GetCircuitState(ResilienceCategory category, string key) =>
+        _breakers.TryGetValue((category, key), out var breaker) ? breaker.State : CircuitState.Closed;
+
+    /// <summary>
+    /// Counters for one category.
+    /// </summary>
+    public ResilienceMetricsSnapshot GetMetrics(ResilienceCategory category)
+    {
+        var open = _breakers
+            .Where(kv => kv.Key.Item1 == category && kv.Value.State != CircuitState.Closed)
+            .Select(kv => kv.Key.Item2)
+            .Order(StringComparer.Ordinal)
+            .ToList();
+        return _metrics[category].Snapshot(category, open);
+    }
+
+    /// <summary>
+    /// Counters for every category.
+    /// </summary>
+    public IReadOnlyList<ResilienceMetricsSnapshot> GetMetrics() =>
+        Enum.GetValues<ResilienceCategory>().Select(GetMetrics).ToList();
+
+    /// <summary>
+    /// Key for the filesystem <paramref name="path"/> is on: the device of its
+    /// nearest existing ancestor, in the same form as the install scheduler's lanes.
+    /// </summary>
+    public static string MountKey(string path)
+    {
+        for (var dir = Path.GetFullPath(path); !string.IsNullOrEmpty(dir); dir = Path.GetDirectoryName(dir))
+        {
+            if (Directory.Exists(dir) && FileStat.TryGetDevice(dir, out var device))
+                return $"dev:{device}";
+        }
+
+        return $"root:{Path.GetPathRoot(path)}";
+    }
+
+    private bool CanRetry(RetryBudget budget, ResilienceMetrics metrics, ResilienceCategory category, string key)
+    {
+        if (budget.TryWithdraw())
+            return true;
+
+        metrics.RecordRetryDenied();
+        _logger?.LogDebug("{Category} retry budget spent, not retrying call to {Key}", category, key);
+        return false;
+    }
+
+    /// <summary>
+    /// Starts a second attempt if the first hasn't finished after <paramref name="delay"/>
+    /// and returns whichever usable result comes first. The loser is cancelled.
+    /// </summary>
+    private async Task<T> HedgedAsync<T>(
+        Func<CancellationToken, Task<T>> action,
+        TimeSpan delay,
+        Func<T, bool>? isTransientResult,
+        ResilienceMetrics metrics,
+        CancellationToken ct)
+    {
+        using var cts = CancellationTokenSource.CreateLinkedTokenSource(ct);
+        try
+        {
+            var primary = action(cts.Token);
+            if (await Task.WhenAny(primary, Task.Delay(delay, _time, cts.Token)) == primary)
+                return await primary;
+
+            ct.ThrowIfCancellationRequested();
+            metrics.RecordHedge();
+            var hedge = action(cts.Token);
+
+            var first = await Task.WhenAny(primary, hedge);
+            var second = first == primary ? hedge : primary;
+            if (first.IsCompletedSuccessfully && isTransientResult?.Invoke(first.Result) != true)
+            {
+                Discard(second);
+                if (first == hedge)
+                    metrics.RecordHedgeWin();
+                return first.Result;
+            }
+
+            // The first to finish failed; the other may still come through
+            try
+            {
+                var result = await second;
+                Discard(first);
+                if (second == hedge)
+                    metrics.RecordHedgeWin();
+                return result;
+            }
+            catch (Exception) when (!ct.IsCancellationRequested)
+            {
+                return await first;
+            }
+        }
+        finally
+        {
+            cts.Cancel();
+        }
+    }
+
+    /// <summary>
+    /// Lets an attempt nobody is waiting for finish in the background, disposing its result.
+    /// </summary>
+    private static void Discard<T>(Task<T> task) =>
+        _ = task.ContinueWith(t =>
+        {
+            if (t.IsCompletedSuccessfully)
+                (t.Result as IDisposable)?.Dispose();
+            else
+                _ = t.Exception;
+        }, CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+
+    private void OnCircuitOpened(ResilienceCategory category, string key, Exception? error)
+    {
+        _metrics[category].RecordCircuitOpened();
+        _logger?.LogWarning(error, "Circuit for {Category} {Key} opened for {Duration}s after repeated failures",
+            category, key, _policies[category].BreakDuration.TotalSeconds);
+
+        _telemetry?.RecordEvent(new TelemetryEvent
+        {
+            EventType = "circuit_opened",
+            Category = "reliability",
+            Data = new Dictionary<string, object>
+            {
+                ["category"] = category.ToString(),
+                ["key"] = key,
+                ["exception_type"] = error?.GetType().Name ?? "transient_result"
+            }
+        });
+    }
+}
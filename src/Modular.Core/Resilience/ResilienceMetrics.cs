@@ -0,0 +1,120 @@
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Running counters for one category. Updated lock-free from any thread.
+/// </summary>
+internal sealed class ResilienceMetrics
+{
+    private long _calls;
+    private long _succeeded;
+    private long _failed;
+    private long _retries;
+    private long _retriesDenied;
+    private long _circuitRejections;
+    private long _bulkheadRejections;
+    private long _circuitsOpened;
+    private long _hedges;
+    private long _hedgeWins;
+    private long _totalLatencyTicks;
+    private long _maxLatencyTicks;
+
+    public void RecordCall() => Interlocked.Increment(ref _calls);
+    public void RecordSuccess() => Interlocked.Increment(ref _succeeded);
+    public void RecordFailure() => Interlocked.Increment(ref _failed);
+    public void RecordRetry() => Interlocked.Increment(ref _retries);
+    public void RecordRetryDenied() => Interlocked.Increment(ref _retriesDenied);
+    public void RecordCircuitRejection() => Interlocked.Increment(ref _circuitRejections);
+    public void RecordBulkheadRejection() => Interlocked.Increment(ref _bulkheadRejections);
+    public void RecordCircuitOpened() => Interlocked.Increment(ref _circuitsOpened);
+    public void RecordHedge() => Interlocked.Increment(ref _hedges);
+    public void RecordHedgeWin() => Interlocked.Increment(ref _hedgeWins);
+
+    public void RecordLatency(TimeSpan latency)
+    {
+        Interlocked.Add(ref _totalLatencyTicks, latency.Ticks);
+
+        var max = Interlocked.Read(ref _maxLatencyTicks);
+        while (latency.Ticks > max)
+        {
+            var seen = Interlocked.CompareExchange(ref _maxLatencyTicks, latency.Ticks, max);
+            if (seen == max)
+                break;
+            max = seen;
+        }
+    }
+
+    public ResilienceMetricsSnapshot Snapshot(ResilienceCategory category, IReadOnlyList<string> openCircuits)
+    {
+        var calls = Interlocked.Read(ref _calls);
+        return new ResilienceMetricsSnapshot
+        {
+            Category = category,
+            Calls = calls,
+            Succeeded = Interlocked.Read(ref _succeeded),
+            Failed = Interlocked.Read(ref _failed),
+            Retries = Interlocked.Read(ref _retries),
+            RetriesDenied = Interlocked.Read(ref _retriesDenied),
+            CircuitRejections = Interlocked.Read(ref _circuitRejections),
+            BulkheadRejections = Interlocked.Read(ref _bulkheadRejections),
+            CircuitsOpened = Interlocked.Read(ref _circuitsOpened),
+            Hedges = Interlocked.Read(ref _hedges),
+            HedgeWins = Interlocked.Read(ref _hedgeWins),
+            AverageLatency = calls == 0 ? TimeSpan.Zero : TimeSpan.FromTicks(Interlocked.Read(ref _totalLatencyTicks) / calls),
+            MaxLatency = TimeSpan.FromTicks(Interlocked.Read(ref _maxLatencyTicks)),
+            OpenCircuits = openCircuits
+        };
+    }
+}
+
+/// <summary>
+/// Point-in-time view of how the resilience engine has handled one category.
+/// </summary>
+public sealed class ResilienceMetricsSnapshot
+{
+    public ResilienceCategory Category { get; init; }
+
+    /// <summary>
+    /// Calls made, including rejected ones.
+    /// </summary>
+    public long Calls { get; init; }
+
+    public long Succeeded { get; init; }
+
+    /// <summary>
+    /// Calls that failed after their last attempt. Rejections are counted separately.
+    /// </summary>
+    public long Failed { get; init; }
+
+    public long Retries { get; init; }
+
+    /// <summary>
+    /// Retries skipped because the retry budget was spent.
+    /// </summary>
+    public long RetriesDenied { get; init; }
+
+    public long CircuitRejections { get; init; }
+    public long BulkheadRejections { get; init; }
+    public long CircuitsOpened { get; init; }
+
+    /// <summary>
+    /// Duplicate attempts raced against slow ones.
+    /// </summary>
+    public long Hedges { get; init; }
+
+    /// <summary>
+    /// Hedges that finished first with a usable result.
+    /// </summary>
+    public long HedgeWins { get; init; }
+
+    /// <summary>
+    /// Mean end-to-end call time, including queueing and backoff.
+    /// </summary>
+    public TimeSpan AverageLatency { get; init; }
+
+    public TimeSpan MaxLatency { get; init; }
+
+    /// <summary>
+    /// Keys whose circuit is currently open or half-open.
+    /// </summary>
+    public IReadOnlyList<string> OpenCircuits { get; init; } = [];
+}
@@ -0,0 +1,148 @@
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Kind of operation a resilience policy applies to. Each category has its
+/// own policy, retry budget and metrics; circuit breakers and bulkheads are
+/// further split by key (host, mount or plugin).
+/// </summary>
+public enum ResilienceCategory
+{
+    /// <summary>HTTP requests, keyed by host.</summary>
+    Http,
+
+    /// <summary>Filesystem operations, keyed by mount.</summary>
+    FileSystem,
+
+    /// <summary>Calls into plugin code, keyed by plugin or installer ID.</summary>
+    Plugin
+}
+
+/// <summary>
+/// How operations of one category are retried, broken and isolated.
+/// </summary>
+public class ResiliencePolicy
+{
+    /// <summary>
+    /// Retries after the first attempt. Calls may lower this but not raise it.
+    /// </summary>
+    public int MaxRetries { get; set; } = 3;
+
+    /// <summary>
+    /// Backoff before the first retry; doubles for each retry after that.
+    /// </summary>
+    public TimeSpan BaseDelay { get; set; } = TimeSpan.FromSeconds(1);
+
+    /// <summary>
+    /// Upper bound on a single backoff.
+    /// </summary>
+    public TimeSpan MaxDelay { get; set; } = TimeSpan.FromSeconds(16);
+
+    /// <summary>
+    /// Randomizes each backoff between half and all of its value.
+    /// </summary>
+    public bool Jitter { get; set; } = true;
+
+    /// <summary>
+    /// Retries earned per call. Over time retries can't exceed this fraction
+    /// of calls, so a failing dependency sees at most (1 + ratio) times its
+    /// normal load instead of (1 + MaxRetries) times.
+    /// </summary>
+    public double RetryBudgetRatio { get; set; } = 0.2;
+
+    /// <summary>
+    /// Retries available in reserve, so quiet periods still allow some.
+    /// Also the most the budget can save up.
+    /// </summary>
+    public int RetryBudgetReserve { get; set; } = 10;
+
+    /// <summary>
+    /// Consecutive transient failures on one key that open its circuit. 0 disables circuit breaking.
+    /// </summary>
+    public int FailureThreshold { get; set; } = 5;
+
+    /// <summary>
+    /// How long an open circuit rejects calls before letting a probe through.
+    /// </summary>
+    public TimeSpan BreakDuration { get; set; } = TimeSpan.FromSeconds(30);
+
+    /// <summary>
+    /// Calls allowed to run at once per key. 0 disables the bulkhead.
+    /// </summary>
+    public int MaxConcurrency { get; set; }
+
+    /// <summary>
+    /// Calls allowed to wait for a bulkhead slot per key before new ones are rejected.
+    /// </summary>
+    public int MaxQueue { get; set; } = 256;
+
+    /// <summary>
+    /// How long an idempotent attempt may run before a duplicate is raced
+    /// against it. Null disables hedging.
+    /// </summary>
+    public TimeSpan? HedgeDelay { get; set; }
+
+    /// <summary>
+    /// Overrides which exceptions count as transient. Defaults to <see cref="TransientErrors.IsTransient"/>.
+    /// </summary>
+    public Func<Exception, bool>? IsTransient { get; set; }
+
+    /// <summary>
+    /// Backoff before retry number <paramref name="attempt"/> + 1.
+    /// </summary>
+    public TimeSpan GetDelay(int attempt, Random random)
+    {
+        var delay = Math.Min(BaseDelay.TotalMilliseconds * Math.Pow(2, attempt), MaxDelay.TotalMilliseconds);
+        if (Jitter)
+            delay = delay / 2 + random.NextDouble() * delay / 2;
+        return TimeSpan.FromMilliseconds(delay);
+    }
+
+    /// <summary>
+    /// API requests: a few retries with long backoff, per-host circuits and
+    /// bulkheads, and a hedge for GETs that stall.
+    /// </summary>
+    public static ResiliencePolicy Http => new()
+    {
+        MaxRetries = 3,
+        BaseDelay = TimeSpan.FromSeconds(1),
+        MaxDelay = TimeSpan.FromSeconds(16),
+        FailureThreshold = 5,
+        BreakDuration = TimeSpan.FromSeconds(30),
+        MaxConcurrency = 8,
+        HedgeDelay = TimeSpan.FromSeconds(3)
+    };
+
+    /// <summary>
+    /// Filesystem operations: locks and busy files clear quickly, so retry
+    /// often with short backoff; a mount that keeps failing is broken.
+    /// </summary>
+    public static ResiliencePolicy FileSystem => new()
+    {
+        MaxRetries = 5,
+        BaseDelay = TimeSpan.FromMilliseconds(50),
+        MaxDelay = TimeSpan.FromSeconds(2),
+        RetryBudgetReserve = 50,
+        FailureThreshold = 10,
+        BreakDuration = TimeSpan.FromSeconds(15)
+    };
+
+    /// <summary>
+    /// Plugin calls: no retries, since plugin failures are rarely transient,
+    /// but a plugin that keeps throwing is switched off for a while and can't
+    /// tie up more than a few callers.
+    /// </summary>
+    public static ResiliencePolicy Plugin => new()
+    {
+        MaxRetries = 0,
+        FailureThreshold = 5,
+        BreakDuration = TimeSpan.FromMinutes(1),
+        MaxConcurrency = 4
+    };
+
+    public static ResiliencePolicy For(ResilienceCategory category) => category switch
+    {
+        ResilienceCategory.Http => Http,
+        ResilienceCategory.FileSystem => FileSystem,
+        _ => Plugin
+    };
+}
@@ -0,0 +1,55 @@
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Token bucket that caps retries at a fraction of calls. Every call deposits
+/// <c>ratio</c> tokens, every retry withdraws one. Per-call retry limits stop
+/// a single call from looping; the budget stops thousands of calls that fail
+/// together from multiplying the load on whatever is already failing.
+/// </summary>
+public sealed class RetryBudget
+{
+    private readonly object _lock = new();
+    private readonly double _ratio;
+    private readonly double _capacity;
+    private double _tokens;
+
+    /// <param name="ratio">Retries earned per call.</param>
+    /// <param name="reserve">Tokens to start with, and the most that can be saved up.</param>
+    public RetryBudget(double ratio, int reserve)
+    {
+        _ratio = Math.Max(0, ratio);
+        _capacity = Math.Max(1, reserve);
+        _tokens = _capacity;
+    }
+
+    /// <summary>
+    /// Tokens currently available.
+    /// </summary>
+    public double Available
+    {
+        get { lock (_lock) return _tokens; }
+    }
+
+    /// <summary>
+    /// Records a call, earning its share of a retry.
+    /// </summary>
+    public void Deposit()
+    {
+        lock (_lock)
+            _tokens = Math.Min(_capacity, _tokens + _ratio);
+    }
+
+    /// <summary>
+    /// Takes a token for one retry. False if the budget is spent.
+    /// </summary>
+    public bool TryWithdraw()
+    {
+        lock (_lock)
+        {
+            if (_tokens < 1)
+                return false;
+            _tokens--;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+namespace Modular.Core.Resilience;
+
+/// <summary>
+/// Decides which failures are worth retrying and count against a circuit.
+/// </summary>
+public static class TransientErrors
+{
+    // errno values for conditions that clear up by themselves
+    private const int EINTR = 4;
+    private const int EIO = 5;
+    private const int EAGAIN = 11;
+    private const int EBUSY = 16;
+    private const int ETXTBSY = 26;
+    private const int EDEADLK = 35;
+    private const int ENOLCK = 37;
+    private const int ETIMEDOUT = 110;
+    private const int ESTALE = 116;
+
+    // Win32 error codes
+    private const int ERROR_SHARING_VIOLATION = 32;
+    private const int ERROR_LOCK_VIOLATION = 33;
+    private const int ERROR_NETNAME_DELETED = 64;
+
+    /// <summary>
+    /// Whether <paramref name="exception"/> is transient for operations of <paramref name="category"/>.
+    /// Cancellation the caller didn't ask for means a timeout for HTTP. For
+    /// plugins "transient" means "counts against the plugin": anything but
+    /// errors caused by the input it was given.
+    /// </summary>
+    public static bool IsTransient(ResilienceCategory category, Exception exception) => category switch
+    {
+        ResilienceCategory.Http => exception is HttpRequestException or TimeoutException or OperationCanceledException
+            || IsTransientIo(exception),
+        ResilienceCategory.FileSystem => IsTransientIo(exception),
+        _ => exception is not (OperationCanceledException or IOException or InvalidDataException
+            or UnauthorizedAccessException or FormatException)
+    };
+
+    /// <summary>
+    /// Locked or busy files, interrupted calls and stale or timed-out network mounts.
+    /// Missing files, permissions and full disks are not transient.
+    /// </summary>
+    public static bool IsTransientIo(Exception exception)
+    {
+        if (exception is not IOException io ||
+            io is FileNotFoundException or DirectoryNotFoundException or PathTooLongException or EndOfStreamException)
+            return false;
+
+        // On Unix the runtime puts the raw errno in HResult; on Windows it's an HRESULT wrapping the Win32 code
+        if (OperatingSystem.IsWindows())
+        {
+            return (io.HResult & 0xFFFF) is ERROR_SHARING_VIOLATION or ERROR_LOCK_VIOLATION or ERROR_NETNAME_DELETED;
+        }
+
+        return io.HResult is EINTR or EIO or EAGAIN or EBUSY or ETXTBSY or EDEADLK or ENOLCK or ETIMEDOUT or ESTALE;
+    }
+}
@@ -4,6 +4,7 @@ using Modular.Core.Configuration;
 using Modular.Core.Database;
 using Modular.Core.Models;
 using Modular.Core.RateLimiting;
+using Modular.Core.Resilience;
 using Modular.Core.Utilities;
 using Modular.FluentHttp.Implementation;
 using Modular.FluentHttp.Interfaces;
@@ -33,8 +34,9 @@ public class RenameService : IRenameService
         _logger = logger;
         var adapter = new RateLimiterAdapter(rateLimiter);
         _client = FluentClientFactory.Create(BaseUrl, adapter, logger);
+        _client.SetRequestPolicy(new HttpResiliencePolicy());
         _client.SetUserAgent("Modular/1.0");
-        _graphQlClient = new NexusModsGraphQlClient(settings.NexusApiKey, adapter, logger);
+        _graphQlClient = new NexusModsGraphQlClient(() => settings.NexusApiKey, adapter, logger);
     }
 
     /// <summary>
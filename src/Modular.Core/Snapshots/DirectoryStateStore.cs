@@ -0,0 +1,526 @@
+using System.Security.Cryptography;
+using System.Text;
+using Microsoft.Extensions.Logging;
+
+namespace Modular.Core.Snapshots;
+
+/// <summary>
+/// Directory state as Merkle trees. Each directory is a node listing its
+/// entries (name, size, mtime, content hash, or node hash for directories),
+/// stored once by the SHA-256 of its encoding, so trees captured at
+/// different times share every unchanged subtree:
+/// <code>
+/// state/
+///   objects/3f/3fa2...e1   directory node
+///   live/&lt;root&gt;.bin        last capture of a live directory, by directory mtime
+/// </code>
+/// Diffs skip subtrees whose hashes match, so they cost as much as what
+/// changed. Capturing a live directory reuses the last capture of every
+/// directory whose mtime is unchanged and only hashes files whose size or
+/// mtime changed.
+/// </summary>
+public sealed class DirectoryStateStore
+{
+    private const string ObjectsDirectoryName = "objects";
+    private const string LiveDirectoryName = "live";
+
+    // "MDS1"
+    private const int LiveCacheMagic = 0x3153444D;
+
+    private readonly bool _hashContents;
+    private readonly ILogger<DirectoryStateStore>? _logger;
+    private readonly Dictionary<string, LiveTree> _liveTrees = new(StringComparer.Ordinal);
+
+    // Captures write nodes before any root references them, so garbage
+    // collection must not run in between
+    private readonly object _lock = new();
+
+    /// <param name="storeDirectory">Where nodes and live caches are kept.</param>
+    /// <param name="hashContents">
+    /// Hash file contents. Without it files are compared by size and mtime,
+    /// which makes the first capture of a large game much cheaper.
+    /// </param>
+    public DirectoryStateStore(string storeDirectory, bool hashContents = true, ILogger<DirectoryStateStore>? logger = null)
+    {
+        StoreDirectory = storeDirectory;
+        _hashContents = hashContents;
+        _logger = logger;
+        Directory.CreateDirectory(ObjectsDirectory);
+        Directory.CreateDirectory(LiveDirectory);
+    }
+
+    /// <summary>
+    /// Root directory of the store.
+    /// </summary>
+    public string StoreDirectory { get; }
+
+    /// <summary>
+    /// Default location of the store.
+    /// </summary>
+    public static string DefaultPath =>
+        Path.Combine(
+            Environment.GetFolderPath(Environment.SpecialFolder.UserProfile),
+            ".config", "Modular", "state");
+
+    private string ObjectsDirectory => Path.Combine(StoreDirectory, ObjectsDirectoryName);
+
+    private string LiveDirectory => Path.Combine(StoreDirectory, LiveDirectoryName);
+
+    /// <summary>
+    /// Records the current state of <paramref name="rootPath"/> and returns
+    /// its root hash.
+    /// </summary>
+    /// <param name="trustDirectoryMtime">
+    /// Reuse the last listing of directories whose mtime is unchanged, which
+    /// only stats directories. Adding, removing or renaming an entry changes
+    /// its directory's mtime, but rewriting a file in place doesn't; pass
+    /// false to stat every file and catch those too.
+    /// </param>
+    public DirectoryStateCapture Capture(string rootPath, bool trustDirectoryMtime = true, CancellationToken ct = default)
+    {
+        var root = new DirectoryInfo(Path.GetFullPath(rootPath));
+        if (!root.Exists)
+            throw new DirectoryNotFoundException($"Directory not found: {root.FullName}");
+
+        lock (_lock)
+        {
+            var tree = GetLiveTree(root.FullName);
+            var capture = new DirectoryStateCapture();
+            var visited = new Dictionary<string, CachedDirectory>(tree.Directories.Count, StringComparer.Ordinal);
+
+            capture.RootHash = HashDirectory(tree, visited, root, string.Empty, trustDirectoryMtime, capture, ct);
+
+            var changed = capture.DirectoriesListed > 0 || visited.Count != tree.Directories.Count;
+            tree.Directories = visited;
+            if (changed)
+                SaveLiveTree(tree);
+
+            _logger?.LogDebug("Captured {Root}: {Listed} directories listed, {Hashed} files hashed",
+                root.FullName, capture.DirectoriesListed, capture.FilesHashed);
+
+            return capture;
+        }
+    }
+
+    /// <summary>
+    /// What changed from the tree <paramref name="oldRoot"/> to <paramref name="newRoot"/>.
+    /// A directory added or removed as a whole is one change.
+    /// </summary>
+    public DirectoryStateDiff Diff(string oldRoot, string newRoot)
+    {
+        var diff = new DirectoryStateDiff { OldRoot = oldRoot, NewRoot = newRoot };
+        DiffNodes(oldRoot, newRoot, string.Empty, diff);
+        return diff;
+    }
+
+    /// <summary>
+    /// What changed in <paramref name="rootPath"/> since the tree
+    /// <paramref name="storedRoot"/> was captured.
+    /// </summary>
+    public DirectoryStateDiff DiffLive(string storedRoot, string rootPath, bool trustDirectoryMtime = true, CancellationToken ct = default)
+    {
+        lock (_lock)
+        {
+            var capture = Capture(rootPath, trustDirectoryMtime, ct);
+            return Diff(storedRoot, capture.RootHash);
+        }
+    }
+
+    /// <summary>
+    /// Whether the tree <paramref name="rootHash"/> is stored.
+    /// </summary>
+    public bool Contains(string rootHash) => File.Exists(NodePath(rootHash));
+
+    /// <summary>
+    /// Deletes nodes not reachable from <paramref name="keepRoots"/> or from
+    /// the last capture of a live directory. Returns how many were deleted.
+    /// </summary>
+    public int CollectGarbage(IEnumerable<string> keepRoots)
+    {
+        lock (_lock)
+        {
+            var reachable = new HashSet<string>(StringComparer.Ordinal);
+            var pending = new Stack<string>(keepRoots);
+
+            foreach (var file in Directory.EnumerateFiles(LiveDirectory, "*.bin"))
+            {
+                var tree = LoadLiveTree(file);
+                if (tree?.Directories.GetValueOrDefault(string.Empty) is { } root)
+                    pending.Push(root.Hash);
+            }
+
+            while (pending.Count > 0)
+            {
+                var hash = pending.Pop();
+                if (!reachable.Add(hash) || !Contains(hash))
+                    continue;
+
+                foreach (var entry in ReadNode(hash).Where(e => e.IsDirectory))
+                    pending.Push(entry.Hash);
+            }
+
+            var deleted = 0;
+            foreach (var file in Directory.EnumerateFiles(ObjectsDirectory, "*", SearchOption.AllDirectories))
+            {
+                if (reachable.Contains(Path.GetFileName(file)))
+                    continue;
+
+                File.Delete(file);
+                deleted++;
+            }
+
+            if (deleted > 0)
+                _logger?.LogInformation("Removed {Count} unreferenced directory state nodes", deleted);
+
+            return deleted;
+        }
+    }
+
+    private string HashDirectory(
+        LiveTree tree,
+        Dictionary<string, CachedDirectory> visited,
+        DirectoryInfo directory,
+        string relativePath,
+        bool trustDirectoryMtime,
+        DirectoryStateCapture capture,
+        CancellationToken ct)
+    {
+        ct.ThrowIfCancellationRequested();
+
+        var mtime = directory.LastWriteTimeUtc.Ticks;
+        tree.Directories.TryGetValue(relativePath, out var cached);
+        var entries = new List<Entry>(cached?.Entries.Count ?? 0);
+
+        if (trustDirectoryMtime && cached != null && cached.MtimeTicks == mtime)
+        {
+            // Same names as last time; only subdirectories can have changed
+            foreach (var entry in cached.Entries)
+            {
+                entries.Add(entry.IsDirectory
+                    ? entry with { Hash = HashDirectory(tree, visited, new DirectoryInfo(Path.Combine(directory.FullName, entry.Name)), Child(relativePath, entry.Name), trustDirectoryMtime, capture, ct) }
+                    : entry);
+            }
+        }
+        else
+        {
+            capture.DirectoriesListed++;
+            var previous = cached?.Entries.ToDictionary(e => e.Name, StringComparer.Ordinal);
+
+            try
+            {
+                foreach (var info in directory.EnumerateFileSystemInfos())
+                {
+                    if (info is DirectoryInfo subdirectory && info.LinkTarget == null)
+                    {
+                        var hash = HashDirectory(tree, visited, subdirectory, Child(relativePath, info.Name), trustDirectoryMtime, capture, ct);
+                        entries.Add(new Entry(info.Name, true, 0, 0, hash));
+                    }
+                    else
+                    {
+                        entries.Add(FileEntry(info, previous?.GetValueOrDefault(info.Name), capture));
+                    }
+                }
+            }
+            catch (Exception ex) when (ex is UnauthorizedAccessException or DirectoryNotFoundException)
+            {
+                _logger?.LogWarning(ex, "Could not list {Path}", directory.FullName);
+            }
+
+            entries.Sort((a, b) => string.CompareOrdinal(a.Name, b.Name));
+        }
+
+        var nodeHash = cached != null && cached.Entries.SequenceEqual(entries) ? cached.Hash : WriteNode(entries);
+        visited[relativePath] = new CachedDirectory(mtime, nodeHash, entries);
+        return nodeHash;
+    }
+
+    /// <summary>
+    /// A file's entry; its content hash is reused while size and mtime match
+    /// the last capture. Links are recorded by their target, not followed.
+    /// </summary>
+    private Entry FileEntry(FileSystemInfo info, Entry? previous, DirectoryStateCapture capture)
+    {
+        var mtime = info.LastWriteTimeUtc.Ticks;
+        if (info.LinkTarget is { } target)
+            return new Entry(info.Name, false, 0, mtime, Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(target))).ToLowerInvariant());
+
+        var size = ((FileInfo)info).Length;
+        if (previous is { IsDirectory: false } old && old.Size == size && old.MtimeTicks == mtime)
+            return old;
+
+        var hash = string.Empty;
+        if (_hashContents)
+        {
+            try
+            {
+                using var stream = new FileStream(info.FullName, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete, 1 << 16);
+                hash = Convert.ToHexString(SHA256.HashData(stream)).ToLowerInvariant();
+                capture.FilesHashed++;
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                // Compared by size and mtime only until it can be read
+                _logger?.LogDebug(ex, "Could not hash {Path}", info.FullName);
+            }
+        }
+
+        return new Entry(info.Name, false, size, mtime, hash);
+    }
+
+    private void DiffNodes(string oldHash, string newHash, string path, DirectoryStateDiff diff)
+    {
+        if (oldHash == newHash)
+            return;
+
+        diff.NodesCompared++;
+        var oldEntries = ReadNode(oldHash);
+        var newEntries = ReadNode(newHash);
+        int i = 0, j = 0;
+
+        while (i < oldEntries.Count || j < newEntries.Count)
+        {
+            var order = i == oldEntries.Count ? 1
+                : j == newEntries.Count ? -1
+                : string.CompareOrdinal(oldEntries[i].Name, newEntries[j].Name);
+
+            if (order < 0)
+            {
+                var removed = oldEntries[i++];
+                diff.Changes.Add(new DirectoryStateChange(Child(path, removed.Name), DirectoryStateChangeKind.Removed, removed.IsDirectory));
+                continue;
+            }
+
+            if (order > 0)
+            {
+                var added = newEntries[j++];
+                diff.Changes.Add(new DirectoryStateChange(Child(path, added.Name), DirectoryStateChangeKind.Added, added.IsDirectory));
+                continue;
+            }
+
+            var before = oldEntries[i++];
+            var after = newEntries[j++];
+            var childPath = Child(path, after.Name);
+
+            if (before.IsDirectory && after.IsDirectory)
+            {
+                DiffNodes(before.Hash, after.Hash, childPath, diff);
+            }
+            else if (before.IsDirectory != after.IsDirectory)
+            {
+                diff.Changes.Add(new DirectoryStateChange(childPath, DirectoryStateChangeKind.Removed, before.IsDirectory));
+                diff.Changes.Add(new DirectoryStateChange(childPath, DirectoryStateChangeKind.Added, after.IsDirectory));
+            }
+            else if (IsModified(before, after))
+            {
+                diff.Changes.Add(new DirectoryStateChange(childPath, DirectoryStateChangeKind.Modified, false));
+            }
+        }
+    }
+
+    /// <summary>
+    /// With content hashes on both sides a touched but identical file isn't
+    /// a change; without them mtime is all there is to go on.
+    /// </summary>
+    private static bool IsModified(Entry before, Entry after)
+    {
+        if (before.Size != after.Size)
+            return true;
+
+        return before.Hash.Length > 0 && after.Hash.Length > 0
+            ? before.Hash != after.Hash
+            : before.MtimeTicks != after.MtimeTicks;
+    }
+
+    private string WriteNode(List<Entry> entries)
+    {
+        using var buffer = new MemoryStream();
+        using (var writer = new BinaryWriter(buffer, Encoding.UTF8, leaveOpen: true))
+        {
+            writer.Write7BitEncodedInt(entries.Count);
+            foreach (var entry in entries)
+                WriteEntry(writer, entry);
+        }
+
+        var hash = Convert.ToHexString(SHA256.HashData(buffer.GetBuffer().AsSpan(0, (int)buffer.Length))).ToLowerInvariant();
+        var path = NodePath(hash);
+        if (!File.Exists(path))
+        {
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            var temp = $"{path}.{Guid.NewGuid():N}.tmp";
+            File.WriteAllBytes(temp, buffer.ToArray());
+            File.Move(temp, path, overwrite: true);
+        }
+
+        return hash;
+    }
+
+    private List<Entry> ReadNode(string hash)
+    {
+        var path = NodePath(hash);
+        if (!File.Exists(path))
+            throw new InvalidDataException($"Directory state node {hash} is missing");
+
+        using var reader = new BinaryReader(File.OpenRead(path));
+        var count = reader.Read7BitEncodedInt();
+        var entries = new List<Entry>(count);
+        for (var i = 0; i < count; i++)
+            entries.Add(ReadEntry(reader));
+
+        return entries;
+    }
+
+    private LiveTree GetLiveTree(string rootPath)
+    {
+        if (_liveTrees.TryGetValue(rootPath, out var tree))
+            return tree;
+
+        tree = LoadLiveTree(LiveTreePath(rootPath));
+        if (tree == null || tree.RootPath != rootPath)
+            tree = new LiveTree(rootPath);
+
+        _liveTrees[rootPath] = tree;
+        return tree;
+    }
+
+    private LiveTree? LoadLiveTree(string path)
+    {
+        if (!File.Exists(path))
+            return null;
+
+        try
+        {
+            using var reader = new BinaryReader(new BufferedStream(File.OpenRead(path), 1 << 16));
+            if (reader.ReadInt32() != LiveCacheMagic)
+                return null;
+
+            var tree = new LiveTree(reader.ReadString());
+            var count = reader.Read7BitEncodedInt();
+            tree.Directories = new Dictionary<string, CachedDirectory>(count, StringComparer.Ordinal);
+            for (var i = 0; i < count; i++)
+            {
+                var relativePath = reader.ReadString();
+                var mtime = reader.ReadInt64();
+                var hash = ReadHash(reader);
+                var entryCount = reader.Read7BitEncodedInt();
+                var entries = new List<Entry>(entryCount);
+                for (var e = 0; e < entryCount; e++)
+                    entries.Add(ReadEntry(reader));
+
+                tree.Directories[relativePath] = new CachedDirectory(mtime, hash, entries);
+            }
+
+            return tree;
+        }
+        catch (Exception ex) when (ex is EndOfStreamException or IOException or FormatException)
+        {
+            _logger?.LogWarning(ex, "Ignoring unreadable directory state cache {Path}", path);
+            return null;
+        }
+    }
+
+    private void SaveLiveTree(LiveTree tree)
+    {
+        var path = LiveTreePath(tree.RootPath);
+        var temp = $"{path}.{Guid.NewGuid():N}.tmp";
+        using (var writer = new BinaryWriter(new BufferedStream(File.Create(temp), 1 << 16)))
+        {
+            writer.Write(LiveCacheMagic);
+            writer.Write(tree.RootPath);
+            writer.Write7BitEncodedInt(tree.Directories.Count);
+            foreach (var (relativePath, directory) in tree.Directories)
+            {
+                writer.Write(relativePath);
+                writer.Write(directory.MtimeTicks);
+                WriteHash(writer, directory.Hash);
+                writer.Write7BitEncodedInt(directory.Entries.Count);
+                foreach (var entry in directory.Entries)
+                    WriteEntry(writer, entry);
+            }
+        }
+
+        File.Move(temp, path, overwrite: true);
+    }
+
+    private static void WriteEntry(BinaryWriter writer, Entry entry)
+    {
+        writer.Write(entry.Name);
+        writer.Write(entry.IsDirectory);
+        writer.Write7BitEncodedInt64(entry.Size);
+        writer.Write(entry.MtimeTicks);
+        WriteHash(writer, entry.Hash);
+    }
+
+    private static Entry ReadEntry(BinaryReader reader) =>
+        new(reader.ReadString(), reader.ReadBoolean(), reader.Read7BitEncodedInt64(), reader.ReadInt64(), ReadHash(reader));
+
+    private static void WriteHash(BinaryWriter writer, string hash)
+    {
+        var bytes = Convert.FromHexString(hash);
+        writer.Write((byte)bytes.Length);
+        writer.Write(bytes);
+    }
+
+    private static string ReadHash(BinaryReader reader) =>
+        Convert.ToHexString(reader.ReadBytes(reader.ReadByte())).ToLowerInvariant();
+
+    private string NodePath(string hash) => Path.Combine(ObjectsDirectory, hash[..2], hash);
+
+    private string LiveTreePath(string rootPath)
+    {
+        var key = Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(rootPath)))[..16].ToLowerInvariant();
+        return Path.Combine(LiveDirectory, key + ".bin");
+    }
+
+    private static string Child(string path, string name) => path.Length == 0 ? name : $"{path}/{name}";
+
+    private sealed record Entry(string Name, bool IsDirectory, long Size, long MtimeTicks, string Hash);
+
+    private sealed record CachedDirectory(long MtimeTicks, string Hash, List<Entry> Entries);
+
+    private sealed class LiveTree(string rootPath)
+    {
+        public string RootPath { get; } = rootPath;
+        public Dictionary<string, CachedDirectory> Directories { get; set; } = new(StringComparer.Ordinal);
+    }
+}
+
+/// <summary>
+/// Outcome of <see cref="DirectoryStateStore.Capture"/>.
+/// </summary>
+public sealed class DirectoryStateCapture
+{
+    public string RootHash { get; set; } = string.Empty;
+
+    /// <summary>Directories whose entries had to be listed again.</summary>
+    public int DirectoriesListed { get; set; }
+
+    /// <summary>Files whose contents had to be hashed.</summary>
+    public int FilesHashed { get; set; }
+}
+
+public enum DirectoryStateChangeKind
+{
+    Added,
+    Removed,
+    Modified
+}
+
+/// <summary>
+/// One changed path, relative to the captured root and '/'-separated.
+/// </summary>
+public sealed record DirectoryStateChange(string Path, DirectoryStateChangeKind Kind, bool IsDirectory);
+
+/// <summary>
+/// Differences between two directory state trees.
+/// </summary>
+public sealed class DirectoryStateDiff
+{
+    public string OldRoot { get; init; } = string.Empty;
+    public string NewRoot { get; init; } = string.Empty;
+    public List<DirectoryStateChange> Changes { get; } = [];
+
+    /// <summary>Directory nodes read; identical subtrees are never read.</summary>
+    public int NodesCompared { get; set; }
+
+    public bool HasChanges => Changes.Count > 0;
+}
@@ -30,6 +30,12 @@ public class SnapshotRecord
     public SnapshotTrigger Trigger { get; set; }
     public string CreatedAtUtc { get; set; } = string.Empty;
     public int ModCount { get; set; }
+
+    /// <summary>
+    /// Root hash of the game directory's state in the <see cref="DirectoryStateStore"/>,
+    /// or null when none was captured.
+    /// </summary>
+    public string? StateRoot { get; set; }
 }
 
 /// <summary>
@@ -66,20 +72,35 @@ public class SnapshotManager
 {
     private readonly ModularDatabase _database;
     private readonly ChangesetManager _changesetManager;
+    private readonly DirectoryStateStore? _stateStore;
     private readonly ILogger<SnapshotManager>? _logger;
 
+    /// <param name="stateStore">
+    /// When given, manual snapshots also record the game directory's state so
+    /// they can be diffed against the live directory or another snapshot.
+    /// </param>
     public SnapshotManager(
         ModularDatabase database,
         ChangesetManager changesetManager,
-        ILogger<SnapshotManager>? logger = null)
+        ILogger<SnapshotManager>? logger = null,
+        DirectoryStateStore? stateStore = null)
     {
         _database = database;
         _changesetManager = changesetManager;
         _logger = logger;
+        _stateStore = stateStore;
     }
 
+    /// <summary>
+    /// Store of directory state, if snapshots record it.
+    /// </summary>
+    public DirectoryStateStore? StateStore => _stateStore;
+
     /// <summary>
     /// Creates a snapshot of all committed changesets for a game's install path.
+    /// Only manual snapshots capture directory state: automatic ones are taken
+    /// on every install and uninstall, which must not wait for the game
+    /// directory to be walked and hashed.
     /// </summary>
     public async Task<SnapshotRecord> CreateSnapshotAsync(
         int gameAppId,
@@ -108,6 +129,20 @@ public class SnapshotManager
             Path.GetFullPath(c.TargetDirectory).Equals(normalizedPath, StringComparison.OrdinalIgnoreCase))
             .ToList();
 
+        string? stateRoot = null;
+        if (_stateStore != null && trigger == SnapshotTrigger.Manual && Directory.Exists(gameInstallPath))
+        {
+            try
+            {
+                var store = _stateStore;
+                stateRoot = (await Task.Run(() => store.Capture(gameInstallPath, ct: ct), ct)).RootHash;
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                _logger?.LogWarning(ex, "Could not capture directory state of {Path}", gameInstallPath);
+            }
+        }
+
         await using var transaction = await connection.BeginTransactionAsync(ct);
 
         try
@@ -117,8 +152,8 @@ public class SnapshotManager
             {
                 cmd.Transaction = (SqliteTransaction)transaction;
                 cmd.CommandText = """
-                    INSERT INTO snapshot (snapshot_id, game_appid, game_name, game_install_path, name, description, trigger, created_at_utc, mod_count)
-                    VALUES (@id, @appid, @game_name, @path, @name, @desc, @trigger, @created, @count)
+                    INSERT INTO snapshot (snapshot_id, game_appid, game_name, game_install_path, name, description, trigger, created_at_utc, mod_count, state_root)
+                    VALUES (@id, @appid, @game_name, @path, @name, @desc, @trigger, @created, @count, @state_root)
                     """;
                 cmd.Parameters.AddWithValue("@id", snapshotId);
                 cmd.Parameters.AddWithValue("@appid", gameAppId);
@@ -129,6 +164,7 @@ public class SnapshotManager
                 cmd.Parameters.AddWithValue("@trigger", triggerStr);
                 cmd.Parameters.AddWithValue("@created", createdAt);
                 cmd.Parameters.AddWithValue("@count", gameChangesets.Count);
+                cmd.Parameters.AddWithValue("@state_root", (object?)stateRoot ?? DBNull.Value);
                 await cmd.ExecuteNonQueryAsync(ct);
             }
 
@@ -166,7 +202,8 @@ public class SnapshotManager
                 Description = description,
                 Trigger = trigger,
                 CreatedAtUtc = createdAt,
-                ModCount = gameChangesets.Count
+                ModCount = gameChangesets.Count,
+                StateRoot = stateRoot
             };
         }
         catch
@@ -184,7 +221,7 @@ public class SnapshotManager
         var connection = await _database.GetConnectionAsync();
         await using var cmd = connection.CreateCommand();
         cmd.CommandText = """
-            SELECT snapshot_id, game_appid, game_name, game_install_path, name, description, trigger, created_at_utc, mod_count
+            SELECT snapshot_id, game_appid, game_name, game_install_path, name, description, trigger, created_at_utc, mod_count, state_root
             FROM snapshot WHERE snapshot_id = @id
             """;
         cmd.Parameters.AddWithValue("@id", snapshotId);
@@ -238,7 +275,7 @@ public class SnapshotManager
         var connection = await _database.GetConnectionAsync();
         await using var cmd = connection.CreateCommand();
         cmd.CommandText = """
-            SELECT snapshot_id, game_appid, game_name, game_install_path, name, description, trigger, created_at_utc, mod_count
+            SELECT snapshot_id, game_appid, game_name, game_install_path, name, description, trigger, created_at_utc, mod_count, state_root
             FROM snapshot
             WHERE game_appid = @appid AND created_at_utc >= @start AND created_at_utc < @end
             ORDER BY created_at_utc DESC
@@ -307,10 +344,69 @@ public class SnapshotManager
             cmd.CommandText = "DELETE FROM snapshot WHERE snapshot_id = @id";
             cmd.Parameters.AddWithValue("@id", snapshotId);
             var rows = await cmd.ExecuteNonQueryAsync(ct);
+            if (rows > 0 && _stateStore is { } store)
+            {
+                var roots = await ListStateRootsAsync(ct);
+                await Task.Run(() => store.CollectGarbage(roots), ct);
+            }
+
             return rows > 0;
         }
     }
 
+    /// <summary>
+    /// What changed in the game directory since a snapshot was taken. Only
+    /// directories whose state differs are visited.
+    /// </summary>
+    /// <param name="trustDirectoryMtime">See <see cref="DirectoryStateStore.Capture"/>.</param>
+    public async Task<DirectoryStateDiff> DiffAgainstLiveAsync(
+        string snapshotId, bool trustDirectoryMtime = true, CancellationToken ct = default)
+    {
+        var (store, snapshot) = await GetStateAsync(snapshotId, ct);
+        return await Task.Run(() => store.DiffLive(snapshot.StateRoot!, snapshot.GameInstallPath, trustDirectoryMtime, ct), ct);
+    }
+
+    /// <summary>
+    /// What changed in the game directory from one snapshot to another.
+    /// </summary>
+    public async Task<DirectoryStateDiff> DiffSnapshotsAsync(
+        string fromSnapshotId, string toSnapshotId, CancellationToken ct = default)
+    {
+        var (store, from) = await GetStateAsync(fromSnapshotId, ct);
+        var (_, to) = await GetStateAsync(toSnapshotId, ct);
+        return await Task.Run(() => store.Diff(from.StateRoot!, to.StateRoot!), ct);
+    }
+
+    private async Task<(DirectoryStateStore Store, SnapshotRecord Snapshot)> GetStateAsync(string snapshotId, CancellationToken ct)
+    {
+        if (_stateStore == null)
+            throw new InvalidOperationException("Snapshots are not recording directory state");
+
+        var snapshot = await GetSnapshotAsync(snapshotId, ct)
+            ?? throw new InvalidOperationException($"Snapshot '{snapshotId}' not found");
+
+        if (snapshot.StateRoot == null || !_stateStore.Contains(snapshot.StateRoot))
+            throw new InvalidOperationException($"Snapshot '{snapshotId}' has no recorded directory state");
+
+        return (_stateStore, snapshot);
+    }
+
+    private async Task<List<string>> ListStateRootsAsync(CancellationToken ct)
+    {
+        var connection = await _database.GetConnectionAsync();
+        await using var cmd = connection.CreateCommand();
+        cmd.CommandText = "SELECT DISTINCT state_root FROM snapshot WHERE state_root IS NOT NULL";
+        await using var reader = await cmd.ExecuteReaderAsync(ct);
+
+        var roots = new List<string>();
+        while (await reader.ReadAsync(ct))
+        {
+            roots.Add(reader.GetString(0));
+        }
+
+        return roots;
+    }
+
     /// <summary>
     /// Restores a snapshot by diffing desired state against current state,
     /// removing extra mods and reinstalling missing ones.
@@ -447,7 +543,8 @@ public class SnapshotManager
             Description = reader.IsDBNull(5) ? null : reader.GetString(5),
             Trigger = trigger,
             CreatedAtUtc = reader.GetString(7),
-            ModCount = reader.GetInt32(8)
+            ModCount = reader.GetInt32(8),
+            StateRoot = reader.IsDBNull(9) ? null : reader.GetString(9)
         };
     }
 }
@@ -0,0 +1,190 @@
+namespace Modular.Core.Telemetry;
+
+/// <summary>
+/// Merging t-digest (Dunning): a sketch of a distribution as weighted
+/// centroids, small ones near the tails and large ones in the middle, so
+/// extreme percentiles stay accurate in a few hundred bytes. Digests of
+/// disjoint data merge into a digest of their union, which is what lets
+/// hourly rollups answer percentiles over any range of hours.
+/// </summary>
+public sealed class TDigest
+{
+    private const int BufferSize = 256;
+
+    private readonly List<(double Mean, double Weight)> _centroids = [];
+    private readonly List<(double Mean, double Weight)> _buffer = [];
+
+    public TDigest(double compression = 100)
+    {
+        if (compression < 10)
+            throw new ArgumentOutOfRangeException(nameof(compression), compression, "Compression must be at least 10");
+
+        Compression = compression;
+    }
+
+    /// <summary>
+    /// Higher keeps more centroids and gives more accurate percentiles.
+    /// </summary>
+    public double Compression { get; }
+
+    public double Count { get; private set; }
+    public double Min { get; private set; } = double.NaN;
+    public double Max { get; private set; } = double.NaN;
+
+    public int CentroidCount
+    {
+        get
+        {
+            Compress();
+            return _centroids.Count;
+        }
+    }
+
+    public void Add(double value, double weight = 1)
+    {
+        if (double.IsNaN(value) || weight <= 0)
+            return;
+
+        Min = Count == 0 ? value : Math.Min(Min, value);
+        Max = Count == 0 ? value : Math.Max(Max, value);
+        Count += weight;
+
+        _buffer.Add((value, weight));
+        if (_buffer.Count >= BufferSize)
+            Compress();
+    }
+
+    /// <summary>
+    /// Folds another digest into this one.
+    /// </summary>
+    public void Merge(TDigest other)
+    {
+        if (other.Count == 0)
+            return;
+
+        other.Compress();
+        Min = Count == 0 ? other.Min : Math.Min(Min, other.Min);
+        Max = Count == 0 ? other.Max : Math.Max(Max, other.Max);
+        Count += other.Count;
+
+        _buffer.AddRange(other._centroids);
+        if (_buffer.Count >= BufferSize)
+            Compress();
+    }
+
+    /// <summary>
+    /// Estimated value at quantile <paramref name="q"/> (0-1); NaN when
+    /// empty.
+    /// </summary>
+    public double Quantile(double q)
+    {
+        if (q is < 0 or > 1)
+            throw new ArgumentOutOfRangeException(nameof(q), q, "Quantile must be between 0 and 1");
+
+        Compress();
+        if (_centroids.Count == 0)
+            return double.NaN;
+        if (_centroids.Count == 1)
+            return _centroids[0].Mean;
+
+        var index = q * Count;
+        var first = _centroids[0];
+        var last = _centroids[^1];
+
+        // Tails interpolate towards the exact min and max
+        if (index < first.Weight / 2)
+            return Min + (first.Mean - Min) * index / (first.Weight / 2);
+        if (index > Count - last.Weight / 2)
+            return Max - (Max - last.Mean) * (Count - index) / (last.Weight / 2);
+
+        var cumulative = first.Weight / 2;
+        for (var i = 0; i < _centroids.Count - 1; i++)
+        {
+            var (mean, weight) = _centroids[i];
+            var next = _centroids[i + 1];
+            var gap = (weight + next.Weight) / 2;
+            if (cumulative + gap >= index)
+                return mean + (next.Mean - mean) * (index - cumulative) / gap;
+
+            cumulative += gap;
+        }
+
+        return last.Mean;
+    }
+
+    public void Write(BinaryWriter writer)
+    {
+        Compress();
+        writer.Write(Compression);
+        writer.Write(Min);
+        writer.Write(Max);
+        writer.Write7BitEncodedInt(_centroids.Count);
+        foreach (var (mean, weight) in _centroids)
+        {
+            writer.Write(mean);
+            writer.Write(weight);
+        }
+    }
+
+    public static TDigest Read(BinaryReader reader)
+    {
+        var digest = new TDigest(reader.ReadDouble());
+        var min = reader.ReadDouble();
+        var max = reader.ReadDouble();
+        var count = reader.Read7BitEncodedInt();
+        for (var i = 0; i < count; i++)
+        {
+            var mean = reader.ReadDouble();
+            var weight = reader.ReadDouble();
+            digest._centroids.Add((mean, weight));
+            digest.Count += weight;
+        }
+
+        digest.Min = count == 0 ? double.NaN : min;
+        digest.Max = count == 0 ? double.NaN : max;
+        return digest;
+    }
+
+    /// <summary>
+    /// Sorts buffered points into the centroids and merges neighbours while
+    /// a centroid stays under its size bound, 4·n·q(1−q)/compression, which
+    /// keeps centroids at the tails small. Reads do this first; a compressed
+    /// digest can be read from several threads.
+    /// </summary>
+    public void Compress()
+    {
+        if (_buffer.Count == 0)
+            return;
+
+        _buffer.AddRange(_centroids);
+        _buffer.Sort((a, b) => a.Mean.CompareTo(b.Mean));
+        _centroids.Clear();
+
+        var total = Count;
+        var (mean, weight) = _buffer[0];
+        var before = 0.0;
+
+        for (var i = 1; i < _buffer.Count; i++)
+        {
+            var next = _buffer[i];
+            var q0 = before / total;
+            var q2 = (before + weight + next.Weight) / total;
+            var limit = 4 * total * Math.Min(q0 * (1 - q0), q2 * (1 - q2)) / Compression;
+
+            if (weight + next.Weight <= limit)
+            {
+                weight += next.Weight;
+                mean += (next.Mean - mean) * next.Weight / weight;
+            }
+            else
+            {
+                _centroids.Add((mean, weight));
+                before += weight;
+                (mean, weight) = next;
+            }
+        }
+
+        _centroids.Add((mean, weight));
+        _buffer.Clear();
+    }
+}
@@ -5,24 +5,25 @@ namespace Modular.Core.Telemetry;
 
 /// <summary>
 /// Privacy-respecting telemetry service with local-first storage and opt-in collection.
+/// Events are kept in a <see cref="TelemetryStore"/>.
 /// </summary>
 public class TelemetryService
 {
-    private readonly string _telemetryPath;
     private readonly ILogger<TelemetryService>? _logger;
     private readonly TelemetryConfig _config;
-    private readonly object _lock = new();
+    private readonly TelemetryStore _store;
 
     public TelemetryService(
         string telemetryPath,
         TelemetryConfig? config = null,
         ILogger<TelemetryService>? logger = null)
     {
-        _telemetryPath = telemetryPath;
         _config = config ?? new TelemetryConfig();
         _logger = logger;
+        _store = new TelemetryStore(telemetryPath, _config, logger);
 
-        Directory.CreateDirectory(_telemetryPath);
+        // Compaction, retention and import of the old JSON day files
+        _store.ScheduleMaintenance();
     }
 
     /// <summary>
@@ -35,28 +36,21 @@ public class TelemetryService
 
         try
         {
-            lock (_lock)
-            {
-                evt.Timestamp = DateTime.UtcNow;
-                evt.SessionId = _config.SessionId;
-
-                // Anonymize if configured
-                if (_config.AnonymizeData)
-                {
-                    evt = AnonymizeEvent(evt);
-                }
+            evt.Timestamp = DateTime.UtcNow;
+            evt.SessionId = _config.SessionId;
 
-                // Store locally
-                var eventPath = GetEventPath(evt.Timestamp);
-                var events = LoadEventsFromFile(eventPath);
-                events.Add(evt);
+            // Anonymize if configured
+            if (_config.AnonymizeData)
+            {
+                evt = AnonymizeEvent(evt);
+            }
 
-                SaveEventsToFile(eventPath, events);
+            // Store locally
+            _store.Append(evt);
 
-                _logger?.LogDebug(
-                    "Recorded telemetry event: {Type} ({Category})",
-                    evt.EventType, evt.Category);
-            }
+            _logger?.LogDebug(
+                "Recorded telemetry event: {Type} ({Category})",
+                evt.EventType, evt.Category);
         }
         catch (Exception ex)
         {
@@ -136,43 +130,37 @@ public class TelemetryService
 
         try
         {
-            lock (_lock)
-            {
-                var allEvents = LoadEventsInRange(startDate.Value, endDate.Value);
-
-                summary.TotalEvents = allEvents.Count;
-                summary.EventsByType = allEvents
-                    .GroupBy(e => e.EventType)
-                    .ToDictionary(g => g.Key, g => g.Count());
-
-                summary.EventsByCategory = allEvents
-                    .GroupBy(e => e.Category)
-                    .ToDictionary(g => g.Key, g => g.Count());
-
-                // Plugin crashes
-                summary.PluginCrashes = allEvents
-                    .Where(e => e.EventType == "plugin_crash")
-                    .Count();
-
-                // Installer stats
-                var installerEvents = allEvents
-                    .Where(e => e.EventType == "installer_execution")
-                    .ToList();
-
-                summary.InstallerSuccesses = installerEvents
-                    .Count(e => e.Data.ContainsKey("success") && (bool)e.Data["success"]);
-                summary.InstallerFailures = installerEvents.Count - summary.InstallerSuccesses;
-
-                // Download stats
-                var downloadEvents = allEvents
-                    .Where(e => e.EventType == "download_completed")
-                    .ToList();
-
-                summary.TotalDownloads = downloadEvents.Count;
-                summary.TotalBytesDownloaded = downloadEvents
-                    .Where(e => e.Data.ContainsKey("size_bytes"))
-                    .Sum(e => Convert.ToInt64(e.Data["size_bytes"]));
-            }
+            var stats = _store.Query(startDate.Value, endDate.Value);
+
+            summary.TotalEvents = (int)stats.Sum(s => s.Count);
+            summary.EventsByType = stats
+                .GroupBy(s => s.EventType)
+                .ToDictionary(g => g.Key, g => (int)g.Sum(s => s.Count));
+
+            summary.EventsByCategory = stats
+                .GroupBy(s => s.Category)
+                .ToDictionary(g => g.Key, g => (int)g.Sum(s => s.Count));
+
+            // Plugin crashes
+            summary.PluginCrashes = (int)stats
+                .Where(s => s.EventType == "plugin_crash")
+                .Sum(s => s.Count);
+
+            // Installer stats
+            var installerStats = stats
+                .Where(s => s.EventType == "installer_execution")
+                .ToList();
+
+            summary.InstallerSuccesses = (int)installerStats.Sum(s => s.Successes);
+            summary.InstallerFailures = (int)installerStats.Sum(s => s.Count) - summary.InstallerSuccesses;
+
+            // Download stats
+            var downloadStats = stats
+                .Where(s => s.EventType == "download_completed")
+                .ToList();
+
+            summary.TotalDownloads = (int)downloadStats.Sum(s => s.Count);
+            summary.TotalBytesDownloaded = downloadStats.Sum(s => s.TotalBytes);
         }
         catch (Exception ex)
         {
@@ -182,6 +170,26 @@ public class TelemetryService
         return summary;
     }
 
+    /// <summary>
+    /// Per-operation counts and duration percentiles of one event type, e.g.
+    /// p95 install time per installer for "installer_execution". Answered
+    /// from hourly rollups, so long ranges stay fast. With
+    /// <see cref="TelemetryConfig.AnonymizeData"/> on, installer and plugin
+    /// keys are hashes of their ids.
+    /// </summary>
+    public List<TelemetryOperationStats> GetOperationStats(string eventType, DateTime? startDate = null, DateTime? endDate = null)
+    {
+        try
+        {
+            return _store.Query(startDate ?? DateTime.UtcNow.AddDays(-30), endDate ?? DateTime.UtcNow, eventType);
+        }
+        catch (Exception ex)
+        {
+            _logger?.LogError(ex, "Failed to query telemetry for {Type}", eventType);
+            return [];
+        }
+    }
+
     /// <summary>
     /// Clears all telemetry data.
     /// </summary>
@@ -189,16 +197,9 @@ public class TelemetryService
     {
         try
         {
-            lock (_lock)
-            {
-                if (Directory.Exists(_telemetryPath))
-                {
-                    Directory.Delete(_telemetryPath, true);
-                    Directory.CreateDirectory(_telemetryPath);
-                }
+            _store.Clear();
 
-                _logger?.LogInformation("Cleared all telemetry data");
-            }
+            _logger?.LogInformation("Cleared all telemetry data");
         }
         catch (Exception ex)
         {
@@ -207,7 +208,8 @@ public class TelemetryService
     }
 
     /// <summary>
-    /// Exports telemetry data for a date range.
+    /// Exports telemetry data for a date range. Raw events are kept for
+    /// <see cref="TelemetryConfig.RawRetentionDays"/>; older days only have rollups.
     /// </summary>
     public async Task<bool> ExportDataAsync(string outputPath, DateTime? startDate = null, DateTime? endDate = null)
     {
@@ -216,19 +218,13 @@ public class TelemetryService
             startDate ??= DateTime.UtcNow.AddDays(-30);
             endDate ??= DateTime.UtcNow;
 
-            TelemetryExport export;
-            lock (_lock)
+            var export = new TelemetryExport
             {
-                var events = LoadEventsInRange(startDate.Value, endDate.Value);
-
-                export = new TelemetryExport
-                {
-                    ExportedAt = DateTime.UtcNow,
-                    StartDate = startDate.Value,
-                    EndDate = endDate.Value,
-                    Events = events
-                };
-            }
+                ExportedAt = DateTime.UtcNow,
+                StartDate = startDate.Value,
+                EndDate = endDate.Value,
+                Events = _store.ReadEvents(startDate.Value, endDate.Value)
+            };
 
             var json = JsonSerializer.Serialize(export, new JsonSerializerOptions
             {
@@ -267,6 +263,10 @@ public class TelemetryService
                 key.Contains("path", StringComparison.OrdinalIgnoreCase) ||
                 key.Contains("user", StringComparison.OrdinalIgnoreCase))
             {
+                // Rollups group by operation keys, so they can group by the hash instead
+                if (TelemetryStore.OperationKeyFields.Contains(key) && value is string id)
+                    anonymized.Data[key] = HashString(id);
+
                 continue; // Skip potentially identifying fields
             }
 
@@ -283,48 +283,6 @@ public class TelemetryService
         var hash = sha256.ComputeHash(bytes);
         return Convert.ToBase64String(hash).Substring(0, 16);
     }
-
-    private string GetEventPath(DateTime date)
-    {
-        return Path.Combine(_telemetryPath, $"telemetry-{date:yyyy-MM-dd}.json");
-    }
-
-    private List<TelemetryEvent> LoadEventsFromFile(string path)
-    {
-        if (!File.Exists(path))
-            return new List<TelemetryEvent>();
-
-        try
-        {
-            var json = File.ReadAllText(path);
-            return JsonSerializer.Deserialize<List<TelemetryEvent>>(json) ?? new List<TelemetryEvent>();
-        }
-        catch
-        {
-            return new List<TelemetryEvent>();
-        }
-    }
-
-    private void SaveEventsToFile(string path, List<TelemetryEvent> events)
-    {
-        var json = JsonSerializer.Serialize(events);
-        File.WriteAllText(path, json);
-    }
-
-    private List<TelemetryEvent> LoadEventsInRange(DateTime startDate, DateTime endDate)
-    {
-        var events = new List<TelemetryEvent>();
-        var currentDate = startDate.Date;
-
-        while (currentDate <= endDate.Date)
-        {
-            var path = GetEventPath(currentDate);
-            events.AddRange(LoadEventsFromFile(path));
-            currentDate = currentDate.AddDays(1);
-        }
-
-        return events.Where(e => e.Timestamp >= startDate && e.Timestamp <= endDate).ToList();
-    }
 }
 
 /// <summary>
@@ -346,6 +304,21 @@ public class TelemetryConfig
     /// Session identifier.
     /// </summary>
     public string SessionId { get; set; } = Guid.NewGuid().ToString();
+
+    /// <summary>
+    /// Days raw events are kept, for export.
+    /// </summary>
+    public int RawRetentionDays { get; set; } = 30;
+
+    /// <summary>
+    /// Days hourly rollups are kept, for summaries and percentiles.
+    /// </summary>
+    public int RollupRetentionDays { get; set; } = 365;
+
+    /// <summary>
+    /// Bytes a background maintenance pass may read before yielding.
+    /// </summary>
+    public long MaintenanceBytesPerPass { get; set; } = 16 * 1024 * 1024;
 }
 
 /// <summary>
@@ -0,0 +1,704 @@
+using System.Collections.Concurrent;
+using System.Globalization;
+using System.Text.Json;
+using Microsoft.Extensions.Logging;
+
+namespace Modular.Core.Telemetry;
+
+/// <summary>
+/// Local telemetry storage. Events are appended to a compact binary log,
+/// one segment per UTC day. Finished days are compacted into columnar
+/// rollups with one row per hour, event type and operation: a count,
+/// successes, failures, bytes and a t-digest of durations. Queries read
+/// rollups, plus the raw log of days that aren't compacted yet, so a
+/// summary over months reads a few kilobytes per day instead of every event.
+/// </summary>
+public sealed class TelemetryStore
+{
+    /// <summary>
+    /// Data fields naming the operation an event is about, e.g. which
+    /// installer ran. Rollups keep a row per value of the first one present.
+    /// </summary>
+    public static readonly string[] OperationKeyFields = ["installer_id", "backend", "plugin_id"];
+
+    private const string SegmentPrefix = "events-";
+    private const string SegmentExtension = ".log";
+    private const string RollupPrefix = "rollup-";
+    private const string RollupExtension = ".bin";
+    private const string LegacyPrefix = "telemetry-";
+    private const string DateFormat = "yyyy-MM-dd";
+
+    // "TLR1"
+    private const int RollupMagic = 0x31524C54;
+    private const int MaxRecordSize = 1 << 20;
+
+    private readonly string _path;
+    private readonly TelemetryConfig _config;
+    private readonly ILogger? _logger;
+    private readonly object _writeLock = new();
+    private readonly object _maintenanceLock = new();
+    private readonly ConcurrentDictionary<DateOnly, DayRollup> _days = new();
+    private Task _maintenance = Task.CompletedTask;
+    private int _maintenanceRunning;
+    private DateOnly _maintenanceDay;
+
+    public TelemetryStore(string path, TelemetryConfig? config = null, ILogger? logger = null)
+    {
+        _path = path;
+        _config = config ?? new TelemetryConfig();
+        _logger = logger;
+        _maintenanceDay = DateOnly.FromDateTime(DateTime.UtcNow);
+
+        Directory.CreateDirectory(_path);
+    }
+
+    /// <summary>
+    /// Pause between maintenance passes while work remains, which bounds
+    /// background I/O to <see cref="TelemetryConfig.MaintenanceBytesPerPass"/>
+    /// per pause.
+    /// </summary>
+    public TimeSpan MaintenancePause { get; set; } = TimeSpan.FromSeconds(1);
+
+    public void Append(TelemetryEvent evt) => Append([evt]);
+
+    /// <summary>
+    /// Appends events to the log segment of their day. The first append of a
+    /// new day starts background maintenance.
+    /// </summary>
+    public void Append(IEnumerable<TelemetryEvent> events)
+    {
+        var today = DateOnly.FromDateTime(DateTime.UtcNow);
+
+        lock (_writeLock)
+        {
+            foreach (var day in events.GroupBy(e => DateOnly.FromDateTime(AsUtc(e.Timestamp))))
+            {
+                using var buffer = new MemoryStream();
+                using (var writer = new BinaryWriter(buffer, System.Text.Encoding.UTF8, leaveOpen: true))
+                {
+                    foreach (var evt in day)
+                        WriteRecord(writer, evt);
+                }
+
+                using var stream = new FileStream(SegmentPath(day.Key), FileMode.Append, FileAccess.Write, FileShare.ReadWrite | FileShare.Delete);
+                buffer.Position = 0;
+                buffer.CopyTo(stream);
+            }
+
+            if (today <= _maintenanceDay)
+                return;
+
+            _maintenanceDay = today;
+        }
+
+        ScheduleMaintenance();
+    }
+
+    /// <summary>
+    /// Per-operation statistics for hours overlapping [start, end], optionally
+    /// only for one event type. Ranges are widened to whole hours.
+    /// </summary>
+    public List<TelemetryOperationStats> Query(DateTime start, DateTime end, string? eventType = null)
+    {
+        start = AsUtc(start);
+        end = AsUtc(end);
+        var firstHour = start.Ticks / TimeSpan.TicksPerHour;
+        var lastHour = end.Ticks / TimeSpan.TicksPerHour;
+        var stats = new Dictionary<(string, string, string), TelemetryOperationStats>();
+
+        for (var day = DateOnly.FromDateTime(start); day <= DateOnly.FromDateTime(end); day = day.AddDays(1))
+        {
+            var dayHour = day.ToDateTime(TimeOnly.MinValue).Ticks / TimeSpan.TicksPerHour;
+            foreach (var row in LoadDay(day).Rows)
+            {
+                if (dayHour + row.Hour < firstHour || dayHour + row.Hour > lastHour)
+                    continue;
+                if (eventType != null && row.EventType != eventType)
+                    continue;
+
+                var key = (row.EventType, row.Category, row.Key);
+                if (!stats.TryGetValue(key, out var stat))
+                {
+                    stats[key] = stat = new TelemetryOperationStats
+                    {
+                        EventType = row.EventType,
+                        Category = row.Category,
+                        Key = row.Key
+                    };
+                }
+
+                stat.Count += row.Count;
+                stat.Successes += row.Successes;
+                stat.Failures += row.Failures;
+                stat.TotalBytes += row.Bytes;
+                stat.TotalDurationMs += row.DurationSum;
+                stat.Durations.Merge(row.Durations);
+            }
+        }
+
+        return stats.Values.ToList();
+    }
+
+    /// <summary>
+    /// Raw events in [start, end]. Only days still within
+    /// <see cref="TelemetryConfig.RawRetentionDays"/> have them.
+    /// </summary>
+    public List<TelemetryEvent> ReadEvents(DateTime start, DateTime end)
+    {
+        start = AsUtc(start);
+        end = AsUtc(end);
+        var events = new List<TelemetryEvent>();
+
+        for (var day = DateOnly.FromDateTime(start); day <= DateOnly.FromDateTime(end); day = day.AddDays(1))
+            ReadSegment(SegmentPath(day), evt =>
+            {
+                if (evt.Timestamp >= start && evt.Timestamp <= end)
+                    events.Add(evt);
+            });
+
+        return events;
+    }
+
+    /// <summary>
+    /// Deletes every event and rollup.
+    /// </summary>
+    public void Clear()
+    {
+        lock (_maintenanceLock)
+        lock (_writeLock)
+        {
+            if (Directory.Exists(_path))
+                Directory.Delete(_path, true);
+            Directory.CreateDirectory(_path);
+            _days.Clear();
+        }
+    }
+
+    /// <summary>
+    /// Runs maintenance passes on a background thread until none is left,
+    /// pausing between passes. Returns the running task when one is already
+    /// in progress.
+    /// </summary>
+    public Task ScheduleMaintenance()
+    {
+        if (Interlocked.CompareExchange(ref _maintenanceRunning, 1, 0) != 0)
+            return _maintenance;
+
+        return _maintenance = Task.Run(async () =>
+        {
+            try
+            {
+                while (RunMaintenance().HasMoreWork)
+                    await Task.Delay(MaintenancePause);
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogWarning(ex, "Telemetry maintenance failed");
+            }
+            finally
+            {
+                Volatile.Write(ref _maintenanceRunning, 0);
+            }
+        });
+    }
+
+    /// <summary>
+    /// One maintenance pass: imports legacy JSON day files into the log,
+    /// compacts finished days into rollups (newest first) and applies
+    /// retention. Reads at most <see cref="TelemetryConfig.MaintenanceBytesPerPass"/>
+    /// (but always makes progress); the rest is left for the next pass.
+    /// </summary>
+    public TelemetryMaintenanceResult RunMaintenance()
+    {
+        lock (_maintenanceLock)
+        {
+            var result = new TelemetryMaintenanceResult();
+            var today = DateOnly.FromDateTime(DateTime.UtcNow);
+            var rawCutoff = today.AddDays(-_config.RawRetentionDays);
+            var rollupCutoff = today.AddDays(-_config.RollupRetentionDays);
+            var budget = _config.MaintenanceBytesPerPass;
+
+            bool Spend(long bytes)
+            {
+                if (result.BytesRead > 0 && result.BytesRead + bytes > budget)
+                {
+                    result.HasMoreWork = true;
+                    return false;
+                }
+
+                result.BytesRead += bytes;
+                return true;
+            }
+
+            foreach (var (day, file) in ListFiles(LegacyPrefix, ".json").OrderByDescending(f => f.Day))
+            {
+                if (!Spend(file.Length))
+                    break;
+
+                ImportLegacy(file);
+                result.LegacyFilesImported++;
+            }
+
+            var segments = ListFiles(SegmentPrefix, SegmentExtension).ToDictionary(f => f.Day, f => f.File);
+            var rollups = ListFiles(RollupPrefix, RollupExtension).ToDictionary(f => f.Day, f => f.File);
+
+            foreach (var (day, segment) in segments.OrderByDescending(s => s.Key))
+            {
+                if (day >= today || day < rollupCutoff)
+                    continue;
+                if (rollups.TryGetValue(day, out var existing) && ReadCoveredLength(existing.FullName) >= segment.Length)
+                    continue;
+                if (!Spend(segment.Length))
+                    break;
+
+                var rollup = Aggregate(segment.FullName);
+                WriteRollup(day, rollup);
+                _days[day] = rollup;
+                rollups[day] = new FileInfo(RollupPath(day));
+                result.DaysCompacted++;
+            }
+
+            foreach (var (day, segment) in segments)
+            {
+                // Raw events past retention go once their rollup has them
+                var expired = day < rollupCutoff
+                    || (day < rawCutoff && rollups.TryGetValue(day, out var rollup) && ReadCoveredLength(rollup.FullName) >= segment.Length);
+                if (!expired)
+                    continue;
+
+                _days.TryRemove(day, out _);
+                if (TryDelete(segment))
+                    result.FilesDeleted++;
+            }
+
+            foreach (var (day, rollup) in rollups.Where(r => r.Key < rollupCutoff))
+            {
+                _days.TryRemove(day, out _);
+                if (TryDelete(rollup))
+                    result.FilesDeleted++;
+            }
+
+            if (result.DaysCompacted + result.FilesDeleted + result.LegacyFilesImported > 0)
+            {
+                _logger?.LogDebug(
+                    "Telemetry maintenance: {Compacted} days compacted, {Deleted} files deleted, {Imported} legacy files imported",
+                    result.DaysCompacted, result.FilesDeleted, result.LegacyFilesImported);
+            }
+
+            return result;
+        }
+    }
+
+    /// <summary>
+    /// A day's rows: its rollup when that covers the whole segment,
+    /// otherwise aggregated from the raw log. Cached until the segment grows.
+    /// </summary>
+    private DayRollup LoadDay(DateOnly day)
+    {
+        var segment = new FileInfo(SegmentPath(day));
+        var segmentLength = segment.Exists ? segment.Length : 0;
+
+        if (_days.TryGetValue(day, out var cached) && cached.CoveredLength >= segmentLength)
+            return cached;
+
+        var rollup = ReadRollup(RollupPath(day));
+        if (rollup == null || rollup.CoveredLength < segmentLength)
+            rollup = segmentLength > 0 ? Aggregate(segment.FullName) : DayRollup.Empty;
+
+        _days[day] = rollup;
+        return rollup;
+    }
+
+    private static DayRollup Aggregate(string segmentPath)
+    {
+        var rows = new Dictionary<(int, string, string, string), RollupRow>();
+        var covered = ReadSegment(segmentPath, evt =>
+        {
+            var key = OperationKeyFields.Select(f => evt.Data.GetValueOrDefault(f) as string).FirstOrDefault(k => k != null) ?? string.Empty;
+            var rowKey = (evt.Timestamp.Hour, evt.EventType, evt.Category, key);
+            if (!rows.TryGetValue(rowKey, out var row))
+            {
+                rows[rowKey] = row = new RollupRow
+                {
+                    Hour = evt.Timestamp.Hour,
+                    EventType = evt.EventType,
+                    Category = evt.Category,
+                    Key = key
+                };
+            }
+
+            row.Count++;
+            if (evt.Data.GetValueOrDefault("success") is bool success)
+            {
+                if (success)
+                    row.Successes++;
+                else
+                    row.Failures++;
+            }
+
+            if (ToDouble(evt.Data.GetValueOrDefault("size_bytes")) is { } bytes)
+                row.Bytes += (long)bytes;
+
+            if (ToDouble(evt.Data.GetValueOrDefault("duration_ms")) is { } duration)
+            {
+                row.DurationSum += duration;
+                row.Durations.Add(duration);
+            }
+        });
+
+        // Cached rows are shared by concurrent queries, which only read them
+        foreach (var row in rows.Values)
+            row.Durations.Compress();
+
+        return new DayRollup(covered, rows.Values.ToList());
+    }
+
+    private void ImportLegacy(FileInfo file)
+    {
+        List<TelemetryEvent> events;
+        try
+        {
+            events = JsonSerializer.Deserialize<List<TelemetryEvent>>(File.ReadAllText(file.FullName)) ?? [];
+        }
+        catch (JsonException ex)
+        {
+            _logger?.LogWarning(ex, "Skipping unreadable telemetry file {Path}", file.FullName);
+            events = [];
+        }
+
+        Append(events);
+        TryDelete(file);
+    }
+
+    /// <summary>
+    /// Reads the records of a segment, stopping at a torn or corrupt tail.
+    /// Returns the segment length read, which later tells whether the
+    /// segment grew since.
+    /// </summary>
+    private static long ReadSegment(string path, Action<TelemetryEvent> onEvent)
+    {
+        if (!File.Exists(path))
+            return 0;
+
+        using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete, 64 * 1024);
+        var length = stream.Length;
+        using var reader = new BinaryReader(stream);
+
+        try
+        {
+            while (stream.Position + sizeof(int) <= length)
+            {
+                var size = reader.ReadInt32();
+                if (size <= 0 || size > MaxRecordSize || stream.Position + size > length)
+                    break;
+
+                var end = stream.Position + size;
+                onEvent(ReadRecord(reader));
+                stream.Position = end;
+            }
+        }
+        catch (Exception ex) when (ex is EndOfStreamException or IOException or FormatException)
+        {
+            // Keep what was read before the damage
+        }
+
+        return length;
+    }
+
+    private static void WriteRecord(BinaryWriter writer, TelemetryEvent evt)
+    {
+        var start = writer.BaseStream.Position;
+        writer.Write(0);
+
+        writer.Write(AsUtc(evt.Timestamp).Ticks);
+        writer.Write(evt.EventType);
+        writer.Write(evt.Category);
+        writer.Write(evt.SessionId);
+        writer.Write7BitEncodedInt(evt.Data.Count);
+        foreach (var (key, value) in evt.Data)
+        {
+            writer.Write(key);
+            switch (ToLogValue(value))
+            {
+                case bool b:
+                    writer.Write((byte)ValueTag.Bool);
+                    writer.Write(b);
+                    break;
+                case long l:
+                    writer.Write((byte)ValueTag.Long);
+                    writer.Write(l);
+                    break;
+                case double d:
+                    writer.Write((byte)ValueTag.Double);
+                    writer.Write(d);
+                    break;
+                case var s:
+                    writer.Write((byte)ValueTag.String);
+                    writer.Write((string)s);
+                    break;
+            }
+        }
+
+        var end = writer.BaseStream.Position;
+        writer.BaseStream.Position = start;
+        writer.Write((int)(end - start - sizeof(int)));
+        writer.BaseStream.Position = end;
+    }
+
+    private static TelemetryEvent ReadRecord(BinaryReader reader)
+    {
+        var evt = new TelemetryEvent
+        {
+            Timestamp = new DateTime(reader.ReadInt64(), DateTimeKind.Utc),
+            EventType = reader.ReadString(),
+            Category = reader.ReadString(),
+            SessionId = reader.ReadString()
+        };
+
+        var count = reader.Read7BitEncodedInt();
+        for (var i = 0; i < count; i++)
+        {
+            var key = reader.ReadString();
+            evt.Data[key] = (ValueTag)reader.ReadByte() switch
+            {
+                ValueTag.Bool => reader.ReadBoolean(),
+                ValueTag.Long => reader.ReadInt64(),
+                ValueTag.Double => reader.ReadDouble(),
+                ValueTag.String => reader.ReadString(),
+                var tag => throw new FormatException($"Unknown telemetry value tag {tag}")
+            };
+        }
+
+        return evt;
+    }
+
+    /// <summary>
+    /// Narrows a data value to what the log stores: bool, long, double or
+    /// string. Values of events loaded from JSON arrive as JsonElements.
+    /// </summary>
+    private static object ToLogValue(object? value) => value switch
+    {
+        bool or long or double or string => value,
+        int or short or byte or uint => Convert.ToInt64(value, CultureInfo.InvariantCulture),
+        float or decimal => Convert.ToDouble(value, CultureInfo.InvariantCulture),
+        TimeSpan span => span.TotalMilliseconds,
+        JsonElement { ValueKind: JsonValueKind.True } => true,
+        JsonElement { ValueKind: JsonValueKind.False } => false,
+        JsonElement { ValueKind: JsonValueKind.Number } e => e.TryGetInt64(out var l) ? l : e.GetDouble(),
+        JsonElement { ValueKind: JsonValueKind.String } e => e.GetString() ?? string.Empty,
+        JsonElement e => e.GetRawText(),
+        _ => Convert.ToString(value, CultureInfo.InvariantCulture) ?? string.Empty
+    };
+
+    private static double? ToDouble(object? value) => value switch
+    {
+        long l => l,
+        double d => d,
+        _ => null
+    };
+
+    /// <summary>
+    /// Rollup layout: magic, covered segment length, a string table, then
+    /// one column per field (hour, type, category and key as string indices,
+    /// count, successes, failures, bytes, duration sum) and the digests.
+    /// </summary>
+    private void WriteRollup(DateOnly day, DayRollup rollup)
+    {
+        var strings = new Dictionary<string, int>(StringComparer.Ordinal);
+        int Index(string s)
+        {
+            if (!strings.TryGetValue(s, out var index))
+                strings[s] = index = strings.Count;
+            return index;
+        }
+
+        var rows = rollup.Rows;
+        var types = rows.Select(r => Index(r.EventType)).ToArray();
+        var categories = rows.Select(r => Index(r.Category)).ToArray();
+        var keys = rows.Select(r => Index(r.Key)).ToArray();
+
+        var path = RollupPath(day);
+        var temp = $"{path}.{Guid.NewGuid():N}.tmp";
+        using (var writer = new BinaryWriter(File.Create(temp)))
+        {
+            writer.Write(RollupMagic);
+            writer.Write(rollup.CoveredLength);
+            writer.Write7BitEncodedInt(strings.Count);
+            foreach (var s in strings.OrderBy(s => s.Value))
+                writer.Write(s.Key);
+
+            writer.Write7BitEncodedInt(rows.Count);
+            foreach (var row in rows) writer.Write((byte)row.Hour);
+            foreach (var index in types) writer.Write7BitEncodedInt(index);
+            foreach (var index in categories) writer.Write7BitEncodedInt(index);
+            foreach (var index in keys) writer.Write7BitEncodedInt(index);
+            foreach (var row in rows) writer.Write7BitEncodedInt64(row.Count);
+            foreach (var row in rows) writer.Write7BitEncodedInt64(row.Successes);
+            foreach (var row in rows) writer.Write7BitEncodedInt64(row.Failures);
+            foreach (var row in rows) writer.Write7BitEncodedInt64(row.Bytes);
+            foreach (var row in rows) writer.Write(row.DurationSum);
+            foreach (var row in rows) row.Durations.Write(writer);
+        }
+
+        File.Move(temp, path, overwrite: true);
+    }
+
+    private DayRollup? ReadRollup(string path)
+    {
+        if (!File.Exists(path))
+            return null;
+
+        try
+        {
+            using var reader = new BinaryReader(File.OpenRead(path));
+            if (reader.ReadInt32() != RollupMagic)
+                return null;
+
+            var covered = reader.ReadInt64();
+            var strings = new string[reader.Read7BitEncodedInt()];
+            for (var i = 0; i < strings.Length; i++)
+                strings[i] = reader.ReadString();
+
+            var rows = new RollupRow[reader.Read7BitEncodedInt()];
+            for (var i = 0; i < rows.Length; i++) rows[i] = new RollupRow { Hour = reader.ReadByte() };
+            foreach (var row in rows) row.EventType = strings[reader.Read7BitEncodedInt()];
+            foreach (var row in rows) row.Category = strings[reader.Read7BitEncodedInt()];
+            foreach (var row in rows) row.Key = strings[reader.Read7BitEncodedInt()];
+            foreach (var row in rows) row.Count = reader.Read7BitEncodedInt64();
+            foreach (var row in rows) row.Successes = reader.Read7BitEncodedInt64();
+            foreach (var row in rows) row.Failures = reader.Read7BitEncodedInt64();
+            foreach (var row in rows) row.Bytes = reader.Read7BitEncodedInt64();
+            foreach (var row in rows) row.DurationSum = reader.ReadDouble();
+            foreach (var row in rows) row.Durations = TDigest.Read(reader);
+
+            return new DayRollup(covered, rows.ToList());
+        }
+        catch (Exception ex) when (ex is EndOfStreamException or IOException or FormatException or IndexOutOfRangeException)
+        {
+            _logger?.LogWarning(ex, "Ignoring unreadable telemetry rollup {Path}", path);
+            return null;
+        }
+    }
+
+    private static long ReadCoveredLength(string rollupPath)
+    {
+        try
+        {
+            using var reader = new BinaryReader(File.OpenRead(rollupPath));
+            return reader.ReadInt32() == RollupMagic ? reader.ReadInt64() : -1;
+        }
+        catch (Exception ex) when (ex is EndOfStreamException or IOException)
+        {
+            return -1;
+        }
+    }
+
+    private IEnumerable<(DateOnly Day, FileInfo File)> ListFiles(string prefix, string extension)
+    {
+        foreach (var file in new DirectoryInfo(_path).EnumerateFiles($"{prefix}*{extension}"))
+        {
+            var stamp = file.Name.Substring(prefix.Length, file.Name.Length - prefix.Length - extension.Length);
+            if (DateOnly.TryParseExact(stamp, DateFormat, CultureInfo.InvariantCulture, DateTimeStyles.None, out var day))
+                yield return (day, file);
+        }
+    }
+
+    private bool TryDelete(FileInfo file)
+    {
+        try
+        {
+            file.Delete();
+            return true;
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            _logger?.LogDebug(ex, "Could not delete {Path}", file.FullName);
+            return false;
+        }
+    }
+
+    private string SegmentPath(DateOnly day) =>
+        Path.Combine(_path, $"{SegmentPrefix}{day.ToString(DateFormat, CultureInfo.InvariantCulture)}{SegmentExtension}");
+
+    private string RollupPath(DateOnly day) =>
+        Path.Combine(_path, $"{RollupPrefix}{day.ToString(DateFormat, CultureInfo.InvariantCulture)}{RollupExtension}");
+
+    private static DateTime AsUtc(DateTime time) => time.Kind switch
+    {
+        DateTimeKind.Local => time.ToUniversalTime(),
+        DateTimeKind.Unspecified => DateTime.SpecifyKind(time, DateTimeKind.Utc),
+        _ => time
+    };
+
+    private enum ValueTag : byte
+    {
+        String,
+        Bool,
+        Long,
+        Double
+    }
+
+    private sealed record DayRollup(long CoveredLength, List<RollupRow> Rows)
+    {
+        public static readonly DayRollup Empty = new(0, []);
+    }
+
+    private sealed class RollupRow
+    {
+        public int Hour { get; init; }
+        public string EventType { get; set; } = string.Empty;
+        public string Category { get; set; } = string.Empty;
+        public string Key { get; set; } = string.Empty;
+        public long Count { get; set; }
+        public long Successes { get; set; }
+        public long Failures { get; set; }
+        public long Bytes { get; set; }
+        public double DurationSum { get; set; }
+        public TDigest Durations { get; set; } = new();
+    }
+}
+
+/// <summary>
+/// Aggregated events of one type and operation over a query range.
+/// </summary>
+public sealed class TelemetryOperationStats
+{
+    public string EventType { get; init; } = string.Empty;
+    public string Category { get; init; } = string.Empty;
+
+    /// <summary>
+    /// Value of the event's operation key field; empty when it has none.
+    /// </summary>
+    public string Key { get; init; } = string.Empty;
+
+    public long Count { get; set; }
+    public long Successes { get; set; }
+    public long Failures { get; set; }
+    public long TotalBytes { get; set; }
+    public double TotalDurationMs { get; set; }
+    public TDigest Durations { get; } = new();
+
+    public double MeanDurationMs => Durations.Count == 0 ? double.NaN : TotalDurationMs / Durations.Count;
+
+    /// <summary>
+    /// Estimated duration at <paramref name="percentile"/> (0-100), e.g. 95
+    /// for p95; NaN when no event had a duration.
+    /// </summary>
+    public double DurationPercentile(double percentile) => Durations.Quantile(percentile / 100);
+}
+
+/// <summary>
+/// Outcome of <see cref="TelemetryStore.RunMaintenance"/>.
+/// </summary>
+public sealed class TelemetryMaintenanceResult
+{
+    public int DaysCompacted { get; set; }
+    public int FilesDeleted { get; set; }
+    public int LegacyFilesImported { get; set; }
+    public long BytesRead { get; set; }
+
+    /// <summary>
+    /// The pass stopped at its byte budget; another pass has work to do.
+    /// </summary>
+    public bool HasMoreWork { get; set; }
+}
@@ -0,0 +1,37 @@
+namespace Modular.Core.Updates;
+
+/// <summary>
+/// A backend's cheap source of mod updates: a feed listing every mod of a
+/// game that changed in a time window, instead of one request per mod.
+/// </summary>
+public interface IUpdateFeed
+{
+    /// <summary>
+    /// Backend ID, e.g. "nexusmods".
+    /// </summary>
+    string BackendId { get; }
+
+    /// <summary>
+    /// False while the backend lacks the credentials the feed needs. Such a
+    /// feed is skipped and its watch list left as it was.
+    /// </summary>
+    bool IsAvailable { get; }
+
+    /// <summary>
+    /// Mods of this backend that the user has downloaded or tracks. Throws if
+    /// the list can't be fetched completely, so mods aren't dropped from the
+    /// index because of a failed request.
+    /// </summary>
+    Task<IReadOnlyList<WatchedMod>> GetWatchedModsAsync(CancellationToken ct = default);
+
+    /// <summary>
+    /// Mods of <paramref name="gameDomain"/> updated after <paramref name="since"/>
+    /// (Unix time), or in the longest window the feed offers when null. May
+    /// return older entries and mods that aren't watched; the caller filters.
+    /// </summary>
+    Task<IReadOnlyList<RemoteModUpdate>> GetUpdatesAsync(
+        string gameDomain,
+        long? since,
+        long now,
+        CancellationToken ct = default);
+}
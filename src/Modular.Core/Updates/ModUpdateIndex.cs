@@ -0,0 +1,260 @@
+using Microsoft.Data.Sqlite;
+using Modular.Core.Database;
+
+namespace Modular.Core.Updates;
+
+/// <summary>
+/// SQLite tables behind update checking: the mods we have or track, the latest
+/// update seen for each in a change feed, and per-feed watermarks. Whether a
+/// mod is outdated is answered by a join of the first two, with no network.
+/// </summary>
+/// <remarks>
+/// A SQLite connection holds one transaction at a time and isn't thread-safe,
+/// so an index polled in the background needs a <see cref="ModularDatabase"/>
+/// of its own rather than one shared with other code.
+/// </remarks>
+public sealed class ModUpdateIndex
+{
+    private readonly ModularDatabase _database;
+
+    // Serializes this index's own calls on its connection
+    private readonly SemaphoreSlim _lock = new(1, 1);
+
+    public ModUpdateIndex(ModularDatabase database)
+    {
+        _database = database;
+    }
+
+    /// <summary>
+    /// Replaces the watch list of <paramref name="backend"/>. Baselines only move
+    /// forward; a mod without one keeps the time it was first seen.
+    /// </summary>
+    public async Task SyncWatchedAsync(string backend, IReadOnlyList<WatchedMod> mods, long now, CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var transaction = (SqliteTransaction)await connection.BeginTransactionAsync(ct);
+
+            await using (var cmd = connection.CreateCommand())
+            {
+                cmd.Transaction = transaction;
+                cmd.CommandText = """
+                    INSERT INTO watched_mod (backend, game_domain, mod_id, name, sources, baseline_at, seen_at)
+                    VALUES (@backend, @domain, @mod, @name, @sources, COALESCE(@baseline, @now), @now)
+                    ON CONFLICT (backend, game_domain, mod_id) DO UPDATE SET
+                        name = CASE WHEN excluded.name <> '' THEN excluded.name ELSE name END,
+                        sources = excluded.sources,
+                        baseline_at = MAX(baseline_at, COALESCE(@baseline, baseline_at)),
+                        seen_at = excluded.seen_at
+                    """;
+
+                foreach (var mod in mods)
+                {
+                    cmd.Parameters.Clear();
+                    cmd.Parameters.AddWithValue("@backend", backend);
+                    cmd.Parameters.AddWithValue("@domain", mod.GameDomain);
+                    cmd.Parameters.AddWithValue("@mod", mod.ModId);
+                    cmd.Parameters.AddWithValue("@name", mod.Name);
+                    cmd.Parameters.AddWithValue("@sources", (int)mod.Source);
+                    cmd.Parameters.AddWithValue("@baseline", (object?)mod.BaselineAt ?? DBNull.Value);
+                    cmd.Parameters.AddWithValue("@now", now);
+                    await cmd.ExecuteNonQueryAsync(ct);
+                }
+            }
+
+            // Mods no longer downloaded or tracked, with the updates seen for them
+            await using (var cmd = connection.CreateCommand())
+            {
+                cmd.Transaction = transaction;
+                cmd.CommandText = """
+                    DELETE FROM mod_update WHERE backend = @backend AND NOT EXISTS (
+                        SELECT 1 FROM watched_mod w
+                        WHERE w.backend = mod_update.backend AND w.game_domain = mod_update.game_domain
+                          AND w.mod_id = mod_update.mod_id AND w.seen_at = @now);
+                    DELETE FROM watched_mod WHERE backend = @backend AND seen_at <> @now;
+                    """;
+                cmd.Parameters.AddWithValue("@backend", backend);
+                cmd.Parameters.AddWithValue("@now", now);
+                await cmd.ExecuteNonQueryAsync(ct);
+            }
+
+            await transaction.CommitAsync(ct);
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Unix time up to which the feed of <paramref name="gameDomain"/> has been
+    /// polled, or null if it never has.
+    /// </summary>
+    public async Task<long?> GetWatermarkAsync(string backend, string gameDomain, CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var cmd = connection.CreateCommand();
+            cmd.CommandText = "SELECT polled_at FROM update_watermark WHERE backend = @backend AND game_domain = @domain";
+            cmd.Parameters.AddWithValue("@backend", backend);
+            cmd.Parameters.AddWithValue("@domain", gameDomain);
+            var result = await cmd.ExecuteScalarAsync(ct);
+            return result is long polledAt ? polledAt : null;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Stores the feed entries that match watched mods and moves the watermark
+    /// to <paramref name="polledAt"/>, atomically.
+    /// </summary>
+    /// <returns>Number of entries that matched a watched mod.</returns>
+    public async Task<int> RecordUpdatesAsync(
+        string backend,
+        string gameDomain,
+        IReadOnlyList<RemoteModUpdate> updates,
+        long polledAt,
+        CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var transaction = (SqliteTransaction)await connection.BeginTransactionAsync(ct);
+            var matched = 0;
+
+            await using (var cmd = connection.CreateCommand())
+            {
+                cmd.Transaction = transaction;
+                cmd.CommandText = """
+                    INSERT INTO mod_update (backend, game_domain, mod_id, updated_at)
+                    SELECT @backend, @domain, @mod, @updated
+                    WHERE EXISTS (SELECT 1 FROM watched_mod
+                                  WHERE backend = @backend AND game_domain = @domain AND mod_id = @mod)
+                    ON CONFLICT (backend, game_domain, mod_id) DO UPDATE SET
+                        updated_at = MAX(updated_at, excluded.updated_at)
+                    """;
+
+                foreach (var update in updates)
+                {
+                    cmd.Parameters.Clear();
+                    cmd.Parameters.AddWithValue("@backend", backend);
+                    cmd.Parameters.AddWithValue("@domain", gameDomain);
+                    cmd.Parameters.AddWithValue("@mod", update.ModId);
+                    cmd.Parameters.AddWithValue("@updated", update.UpdatedAt);
+                    matched += await cmd.ExecuteNonQueryAsync(ct);
+                }
+            }
+
+            await using (var cmd = connection.CreateCommand())
+            {
+                cmd.Transaction = transaction;
+                cmd.CommandText = """
+                    INSERT INTO update_watermark (backend, game_domain, polled_at)
+                    VALUES (@backend, @domain, @polled)
+                    ON CONFLICT (backend, game_domain) DO UPDATE SET polled_at = MAX(polled_at, excluded.polled_at)
+                    """;
+                cmd.Parameters.AddWithValue("@backend", backend);
+                cmd.Parameters.AddWithValue("@domain", gameDomain);
+                cmd.Parameters.AddWithValue("@polled", polledAt);
+                await cmd.ExecuteNonQueryAsync(ct);
+            }
+
+            await transaction.CommitAsync(ct);
+            return matched;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Watched mods updated after their baseline, newest update first.
+    /// </summary>
+    public async Task<IReadOnlyList<OutdatedMod>> GetOutdatedAsync(
+        string? backend = null,
+        string? gameDomain = null,
+        CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var cmd = connection.CreateCommand();
+            cmd.CommandText = """
+                SELECT w.backend, w.game_domain, w.mod_id, w.name, w.sources, w.baseline_at, u.updated_at
+                FROM watched_mod w
+                JOIN mod_update u
+                  ON u.backend = w.backend AND u.game_domain = w.game_domain AND u.mod_id = w.mod_id
+                WHERE u.updated_at > w.baseline_at
+                  AND (@backend IS NULL OR w.backend = @backend)
+                  AND (@domain IS NULL OR w.game_domain = @domain)
+                ORDER BY u.updated_at DESC
+                """;
+            cmd.Parameters.AddWithValue("@backend", (object?)backend ?? DBNull.Value);
+            cmd.Parameters.AddWithValue("@domain", (object?)gameDomain ?? DBNull.Value);
+
+            var result = new List<OutdatedMod>();
+            await using var reader = await cmd.ExecuteReaderAsync(ct);
+            while (await reader.ReadAsync(ct))
+            {
+                result.Add(new OutdatedMod
+                {
+                    Backend = reader.GetString(0),
+                    GameDomain = reader.GetString(1),
+                    ModId = reader.GetString(2),
+                    Name = reader.GetString(3),
+                    Source = (WatchSource)reader.GetInt32(4),
+                    BaselineAt = DateTimeOffset.FromUnixTimeSeconds(reader.GetInt64(5)),
+                    UpdatedAt = DateTimeOffset.FromUnixTimeSeconds(reader.GetInt64(6))
+                });
+            }
+
+            return result;
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Marks a mod as up to date with its latest seen update, e.g. when the
+    /// user dismisses the notification.
+    /// </summary>
+    public async Task AcknowledgeAsync(string backend, string gameDomain, string modId, CancellationToken ct = default)
+    {
+        await _lock.WaitAsync(ct);
+        try
+        {
+            var connection = await _database.GetConnectionAsync();
+            await using var cmd = connection.CreateCommand();
+            cmd.CommandText = """
+                UPDATE watched_mod SET baseline_at = MAX(baseline_at, (
+                    SELECT updated_at FROM mod_update u
+                    WHERE u.backend = watched_mod.backend AND u.game_domain = watched_mod.game_domain
+                      AND u.mod_id = watched_mod.mod_id))
+                WHERE backend = @backend AND game_domain = @domain AND mod_id = @mod
+                  AND EXISTS (SELECT 1 FROM mod_update u
+                              WHERE u.backend = watched_mod.backend AND u.game_domain = watched_mod.game_domain
+                                AND u.mod_id = watched_mod.mod_id)
+                """;
+            cmd.Parameters.AddWithValue("@backend", backend);
+            cmd.Parameters.AddWithValue("@domain", gameDomain);
+            cmd.Parameters.AddWithValue("@mod", modId);
+            await cmd.ExecuteNonQueryAsync(ct);
+        }
+        finally
+        {
+            _lock.Release();
+        }
+    }
+}
@@ -0,0 +1,184 @@
+using Microsoft.Extensions.Logging;
+
+namespace Modular.Core.Updates;
+
+/// <summary>
+/// Finds updates for downloaded and tracked mods by polling each backend's
+/// change feed, one request per game rather than one per mod. Each poll only
+/// asks for the window since the previous one, and results are matched
+/// against the watch list in <see cref="ModUpdateIndex"/>, so listing
+/// outdated mods is a local query.
+/// </summary>
+public sealed class UpdateCheckService : IDisposable
+{
+    /// <summary>
+    /// Default time between background polls.
+    /// </summary>
+    public static readonly TimeSpan DefaultInterval = TimeSpan.FromHours(1);
+
+    private readonly ModUpdateIndex _index;
+    private readonly IReadOnlyList<IUpdateFeed> _feeds;
+    private readonly ILogger<UpdateCheckService>? _logger;
+    private readonly TimeProvider _time;
+    private readonly SemaphoreSlim _pollLock = new(1, 1);
+    private CancellationTokenSource? _backgroundCts;
+    private Task? _backgroundTask;
+
+    public UpdateCheckService(
+        ModUpdateIndex index,
+        IEnumerable<IUpdateFeed> feeds,
+        ILogger<UpdateCheckService>? logger = null,
+        TimeProvider? timeProvider = null)
+    {
+        _index = index;
+        _feeds = feeds.ToList();
+        _logger = logger;
+        _time = timeProvider ?? TimeProvider.System;
+    }
+
+    /// <summary>
+    /// The index polls are recorded in.
+    /// </summary>
+    public ModUpdateIndex Index => _index;
+
+    /// <summary>
+    /// Raised after a poll that found mods which were not outdated before it.
+    /// Raised on a background thread.
+    /// </summary>
+    public event EventHandler<IReadOnlyList<OutdatedMod>>? UpdatesFound;
+
+    /// <summary>
+    /// Refreshes the watch lists and polls every feed for the window since its
+    /// watermark. A backend that fails is skipped and retried on the next poll
+    /// from the same watermark, so no window is lost.
+    /// </summary>
+    public async Task<UpdatePollResult> PollAsync(CancellationToken ct = default)
+    {
+        await _pollLock.WaitAsync(ct);
+        try
+        {
+            var before = (await _index.GetOutdatedAsync(ct: ct)).Select(Key).ToHashSet();
+            var feedsPolled = 0;
+            var matched = 0;
+            var failed = new List<string>();
+
+            foreach (var feed in _feeds)
+            {
+                ct.ThrowIfCancellationRequested();
+                if (!feed.IsAvailable)
+                    continue;
+
+                try
+                {
+                    var now = _time.GetUtcNow().ToUnixTimeSeconds();
+                    var watched = await feed.GetWatchedModsAsync(ct);
+                    await _index.SyncWatchedAsync(feed.BackendId, watched, now, ct);
+
+                    foreach (var domain in watched.Select(m => m.GameDomain).Distinct(StringComparer.Ordinal))
+                    {
+                        var since = await _index.GetWatermarkAsync(feed.BackendId, domain, ct);
+                        var updates = await feed.GetUpdatesAsync(domain, since, now, ct);
+                        matched += await _index.RecordUpdatesAsync(feed.BackendId, domain, updates, now, ct);
+                        feedsPolled++;
+                    }
+                }
+                catch (Exception ex) when (ex is not OperationCanceledException)
+                {
+                    _logger?.LogWarning(ex, "Update check failed for {Backend}", feed.BackendId);
+                    failed.Add(feed.BackendId);
+                }
+            }
+
+            var outdated = await _index.GetOutdatedAsync(ct: ct);
+            var newlyOutdated = outdated.Where(m => !before.Contains(Key(m))).ToList();
+
+            _logger?.LogInformation(
+                "Update check: {Feeds} feed(s) polled, {Matched} update(s) matched, {Outdated} mod(s) outdated",
+                feedsPolled, matched, outdated.Count);
+
+            if (newlyOutdated.Count > 0)
+                UpdatesFound?.Invoke(this, newlyOutdated);
+
+            return new UpdatePollResult
+            {
+                FeedsPolled = feedsPolled,
+                UpdatesMatched = matched,
+                FailedBackends = failed,
+                NewlyOutdated = newlyOutdated,
+                Outdated = outdated
+            };
+        }
+        finally
+        {
+            _pollLock.Release();
+        }
+    }
+
+    /// <summary>
+    /// Outdated mods as of the last poll. Local only.
+    /// </summary>
+    public Task<IReadOnlyList<OutdatedMod>> GetOutdatedAsync(
+        string? backend = null,
+        string? gameDomain = null,
+        CancellationToken ct = default) =>
+        _index.GetOutdatedAsync(backend, gameDomain, ct);
+
+    /// <summary>
+    /// Polls now and then every <paramref name="interval"/> until stopped.
+    /// </summary>
+    public void Start(TimeSpan? interval = null)
+    {
+        if (_backgroundTask != null)
+            return;
+
+        _backgroundCts = new CancellationTokenSource();
+        _backgroundTask = RunAsync(interval ?? DefaultInterval, _backgroundCts.Token);
+    }
+
+    /// <summary>
+    /// Stops background polling and waits for a running poll to finish.
+    /// </summary>
+    public async Task StopAsync()
+    {
+        if (_backgroundTask == null)
+            return;
+
+        _backgroundCts!.Cancel();
+        try
+        {
+            await _backgroundTask;
+        }
+        catch (OperationCanceledException)
+        {
+            // Expected
+        }
+
+        _backgroundTask = null;
+        _backgroundCts.Dispose();
+        _backgroundCts = null;
+    }
+
+    public void Dispose()
+    {
+        _backgroundCts?.Cancel();
+    }
+
+    private async Task RunAsync(TimeSpan interval, CancellationToken ct)
+    {
+        using var timer = new PeriodicTimer(interval, _time);
+        do
+        {
+            try
+            {
+                await PollAsync(ct);
+            }
+            catch (Exception ex) when (ex is not OperationCanceledException)
+            {
+                _logger?.LogError(ex, "Background update check failed");
+            }
+        }
+        while (await timer.WaitForNextTickAsync(ct));
+    }
+
+    private static (string, string, string) Key(OutdatedMod mod) => (mod.Backend, mod.GameDomain, mod.ModId);
+}
@@ -0,0 +1,88 @@
+namespace Modular.Core.Updates;
+
+/// <summary>
+/// Why a mod is checked for updates.
+/// </summary>
+[Flags]
+public enum WatchSource
+{
+    None = 0,
+
+    /// <summary>
+    /// Files of the mod have been downloaded.
+    /// </summary>
+    Downloaded = 1,
+
+    /// <summary>
+    /// The user tracks or subscribes to the mod on the backend.
+    /// </summary>
+    Tracked = 2
+}
+
+/// <summary>
+/// A mod to check for updates.
+/// </summary>
+public sealed record WatchedMod
+{
+    public required string GameDomain { get; init; }
+    public required string ModId { get; init; }
+    public string Name { get; init; } = string.Empty;
+    public WatchSource Source { get; init; }
+
+    /// <summary>
+    /// Unix time of the version we have, e.g. the last download. Updates after
+    /// it make the mod outdated. Null when unknown: the mod is then compared
+    /// against the time it was first seen.
+    /// </summary>
+    public long? BaselineAt { get; init; }
+}
+
+/// <summary>
+/// A change-feed entry: the mod got new files at <see cref="UpdatedAt"/>.
+/// </summary>
+public readonly record struct RemoteModUpdate(string ModId, long UpdatedAt);
+
+/// <summary>
+/// A watched mod with an update newer than the version we have.
+/// </summary>
+public sealed record OutdatedMod
+{
+    public required string Backend { get; init; }
+    public required string GameDomain { get; init; }
+    public required string ModId { get; init; }
+    public string Name { get; init; } = string.Empty;
+    public WatchSource Source { get; init; }
+    public DateTimeOffset BaselineAt { get; init; }
+    public DateTimeOffset UpdatedAt { get; init; }
+}
+
+/// <summary>
+/// Outcome of one <see cref="UpdateCheckService.PollAsync"/>.
+/// </summary>
+public sealed class UpdatePollResult
+{
+    /// <summary>
+    /// Feed requests made, one per backend and game domain.
+    /// </summary>
+    public int FeedsPolled { get; init; }
+
+    /// <summary>
+    /// Feed entries that matched a watched mod.
+    /// </summary>
+    public int UpdatesMatched { get; init; }
+
+    /// <summary>
+    /// Backends whose watch list or feed could not be fetched.
+    /// </summary>
+    public IReadOnlyList<string> FailedBackends { get; init; } = [];
+
+    /// <summary>
+    /// Mods that became outdated during this poll.
+    /// </summary>
+    public IReadOnlyList<OutdatedMod> NewlyOutdated { get; init; } = [];
+
+    /// <summary>
+    /// Every outdated mod after this poll.
+    /// </summary>
+    public IReadOnlyList<OutdatedMod> Outdated { get; init; } = [];
+}
@@ -0,0 +1,328 @@
+using System.Collections.Concurrent;
+
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// Maps mod archive paths onto the casing a game directory already uses.
+/// Windows games (and Proton) treat <c>Data/Textures</c> and
+/// <c>data/textures</c> as one directory, but on a case-sensitive
+/// filesystem writing both creates duplicate siblings the game never reads.
+/// The index is a trie keyed by case-folded path segment that stores each
+/// segment's real name. It is built with one directory read per directory,
+/// told about files as installers write them, and re-reads a directory only
+/// when its modification time shows something else added, removed or
+/// renamed an entry in it. Mapping an entry costs a lookup per path segment
+/// and never touches the disk.
+/// </summary>
+public sealed class CaseFoldingPathIndex
+{
+    private static readonly ConcurrentDictionary<string, CaseFoldingPathIndex> Shared = new(StringComparer.Ordinal);
+
+    private readonly Node? _root;
+    private readonly CaseFoldingPathIndex? _base;
+    private readonly List<CaseCollision> _collisions = new();
+    private readonly object _lock = new();
+
+    private CaseFoldingPathIndex(string rootDirectory, bool isCaseSensitive)
+    {
+        RootDirectory = rootDirectory;
+        IsCaseSensitive = isCaseSensitive;
+        if (isCaseSensitive)
+        {
+            _root = new Node(string.Empty) { IsDirectory = true };
+            Refresh();
+        }
+    }
+
+    private CaseFoldingPathIndex(CaseFoldingPathIndex baseIndex)
+    {
+        RootDirectory = baseIndex.RootDirectory;
+        IsCaseSensitive = baseIndex.IsCaseSensitive;
+        _base = baseIndex;
+        if (IsCaseSensitive)
+            _root = new Node(string.Empty) { IsDirectory = true };
+    }
+
+    /// <summary>
+    /// The indexed directory.
+    /// </summary>
+    public string RootDirectory { get; }
+
+    /// <summary>
+    /// False when the filesystem folds case itself; paths are then passed
+    /// through unchanged and nothing is indexed.
+    /// </summary>
+    public bool IsCaseSensitive { get; }
+
+    /// <summary>
+    /// Directories read from disk while building or refreshing the index.
+    /// </summary>
+    public int DirectoriesScanned { get; private set; }
+
+    /// <summary>
+    /// Names that exist in more than one casing, as of the last read of their
+    /// directory. Entries are mapped to the first of them in ordinal order.
+    /// </summary>
+    public IReadOnlyList<CaseCollision> Collisions
+    {
+        get
+        {
+            lock (_lock)
+            {
+                return _collisions.ToList();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Index for a game directory, shared by every install into it. The first
+    /// call builds it; later ones re-read the directories changed on disk
+    /// since, which costs a stat per directory, so take the index once per
+    /// install rather than once per file.
+    /// </summary>
+    public static CaseFoldingPathIndex For(string rootDirectory)
+    {
+        var fullPath = Path.GetFullPath(rootDirectory);
+        if (!Shared.TryGetValue(fullPath, out var index))
+            return Shared.GetOrAdd(fullPath, Build);
+
+        index.Refresh();
+        return index;
+    }
+
+    /// <summary>
+    /// Builds a fresh, unshared index.
+    /// </summary>
+    public static CaseFoldingPathIndex Build(string rootDirectory)
+    {
+        var fullPath = Path.GetFullPath(rootDirectory);
+        return new CaseFoldingPathIndex(fullPath, IsCaseSensitiveDirectory(fullPath));
+    }
+
+    /// <summary>
+    /// An unshared layer over this index for paths that are planned but not
+    /// written yet. It maps through this index first, then through the files
+    /// added to the layer; nothing added to it reaches this index.
+    /// </summary>
+    public CaseFoldingPathIndex CreateLayer() => new(this);
+
+    /// <summary>
+    /// Rewrites a relative path so every segment that already exists (in any
+    /// casing) uses its on-disk name. Segments below the first new one are
+    /// kept as given. Separators are normalized to the platform's.
+    /// </summary>
+    public string Resolve(string relativePath)
+    {
+        if (_base != null)
+            relativePath = _base.Resolve(relativePath);
+
+        var segments = PathSanitizer.NormalizeSeparators(relativePath).Split(Path.DirectorySeparatorChar);
+        if (_root == null)
+            return string.Join(Path.DirectorySeparatorChar, segments);
+
+        lock (_lock)
+        {
+            var node = _root;
+            for (var i = 0; i < segments.Length && node?.Children != null; i++)
+            {
+                if (!node.Children.TryGetValue(segments[i], out var child))
+                    break;
+
+                segments[i] = child.Name;
+                node = child;
+            }
+        }
+
+        return string.Join(Path.DirectorySeparatorChar, segments);
+    }
+
+    /// <summary>
+    /// Validates an archive entry path like
+    /// <see cref="PathSanitizer.SanitizeEntryPath"/> and maps it onto existing
+    /// casing. Returns the full destination path; call <see cref="AddFile"/>
+    /// once the file is written there.
+    /// </summary>
+    public string SanitizeEntryPath(string entryPath) =>
+        PathSanitizer.SanitizeEntryPath(Resolve(entryPath), RootDirectory);
+
+    /// <summary>
+    /// Records a file (and its parent directories) written into the
+    /// directory, so later entries that differ only in case land beside it.
+    /// Takes a path relative to <see cref="RootDirectory"/> or a full path
+    /// inside it, and keeps the names already indexed.
+    /// </summary>
+    public void AddFile(string path)
+    {
+        if (_root == null)
+            return;
+
+        var segments = PathSanitizer.NormalizeSeparators(Path.GetRelativePath(RootDirectory, Path.Combine(RootDirectory, path)))
+            .Split(Path.DirectorySeparatorChar, StringSplitOptions.RemoveEmptyEntries);
+
+        lock (_lock)
+        {
+            var node = _root;
+            foreach (var segment in segments)
+            {
+                node.IsDirectory = true;
+                node.Children ??= NewChildren();
+                if (!node.Children.TryGetValue(segment, out var child))
+                {
+                    child = new Node(segment);
+                    node.Children.Add(segment, child);
+                }
+
+                node = child;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Reads every directory that was never read or whose modification time
+    /// changed since it was, and walks into the ones that didn't.
+    /// </summary>
+    private void Refresh()
+    {
+        lock (_lock)
+        {
+            var pending = new Stack<(Node Node, string Path)>();
+            pending.Push((_root!, RootDirectory));
+
+            while (pending.Count > 0)
+            {
+                var (node, path) = pending.Pop();
+                if (node.ReadAt == null || Directory.GetLastWriteTimeUtc(path) != node.ReadAt)
+                    Read(node, path);
+
+                if (node.Children == null)
+                    continue;
+
+                foreach (var child in node.Children.Values)
+                {
+                    if (child.IsDirectory)
+                        pending.Push((child, Path.Combine(path, child.Name)));
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Replaces a directory's entries with what is on disk, keeping the
+    /// nodes of subdirectories that are still there.
+    /// </summary>
+    private void Read(Node node, string path)
+    {
+        DateTime readAt;
+        List<FileSystemInfo> entries;
+        try
+        {
+            // Taken before listing, so a change made during the read shows up next time
+            readAt = Directory.GetLastWriteTimeUtc(path);
+            entries = new DirectoryInfo(path).EnumerateFileSystemInfos().OrderBy(e => e.Name, StringComparer.Ordinal).ToList();
+        }
+        catch (Exception ex) when (ex is UnauthorizedAccessException or IOException)
+        {
+            node.Children = null;
+            return;
+        }
+
+        DirectoriesScanned++;
+        node.ReadAt = readAt;
+        var relative = RelativeDirectory(path);
+        _collisions.RemoveAll(c => (Path.GetDirectoryName(c.Path) ?? string.Empty) == relative);
+
+        var previous = node.Children;
+        node.Children = null;
+        foreach (var entry in entries)
+        {
+            node.Children ??= NewChildren();
+            if (node.Children.TryGetValue(entry.Name, out var existing))
+            {
+                RecordCollision(relative, existing.Name, entry.Name);
+                continue;
+            }
+
+            // Don't follow links, they can loop or leave the game directory
+            var isDirectory = entry is DirectoryInfo && entry.LinkTarget == null;
+            var child = isDirectory && previous != null && previous.TryGetValue(entry.Name, out var known) && known.Name == entry.Name
+                ? known
+                : new Node(entry.Name);
+            child.IsDirectory = isDirectory;
+            node.Children.Add(entry.Name, child);
+        }
+    }
+
+    private string RelativeDirectory(string path)
+    {
+        var relative = Path.GetRelativePath(RootDirectory, path);
+        return relative == "." ? string.Empty : relative;
+    }
+
+    private void RecordCollision(string directory, string kept, string name)
+    {
+        var path = Path.Combine(directory, kept);
+        var collision = _collisions.FirstOrDefault(c => c.Path == path);
+        if (collision == null)
+            _collisions.Add(new CaseCollision(path, [kept, name]));
+        else
+            ((List<string>)collision.Names).Add(name);
+    }
+
+    /// <summary>
+    /// Tells whether a directory tells names apart by case by looking up one
+    /// of its entries in another casing, so nothing is written to the game
+    /// directory. Falls back to the platform default when the directory has
+    /// no entry with letters in it or can't be read.
+    /// </summary>
+    private static bool IsCaseSensitiveDirectory(string directory)
+    {
+        if (OperatingSystem.IsWindows())
+            return false;
+
+        try
+        {
+            var names = new DirectoryInfo(directory).EnumerateFileSystemInfos().Select(e => e.Name).ToHashSet(StringComparer.Ordinal);
+            foreach (var name in names)
+            {
+                var other = name.ToUpperInvariant();
+                if (other == name)
+                    other = name.ToLowerInvariant();
+                if (other == name)
+                    continue;
+
+                return names.Contains(other) || !Path.Exists(Path.Combine(directory, other));
+            }
+        }
+        catch (Exception ex) when (ex is UnauthorizedAccessException or IOException)
+        {
+        }
+
+        return !OperatingSystem.IsMacOS();
+    }
+
+    private static Dictionary<string, Node> NewChildren() => new(StringComparer.OrdinalIgnoreCase);
+
+    private sealed class Node(string name)
+    {
+        public string Name { get; } = name;
+        public Dictionary<string, Node>? Children { get; set; }
+
+        /// <summary>
+        /// Set for directories that are walked on refresh.
+        /// </summary>
+        public bool IsDirectory { get; set; }
+
+        /// <summary>
+        /// Modification time of the directory when its entries were last
+        /// read; null if they never were.
+        /// </summary>
+        public DateTime? ReadAt { get; set; }
+    }
+}
+
+/// <summary>
+/// A name that exists in several casings in one directory.
+/// </summary>
+/// <param name="Path">Relative path, in the casing entries are mapped to.</param>
+/// <param name="Names">Every casing found, the mapped one first.</param>
+public sealed record CaseCollision(string Path, IReadOnlyList<string> Names);
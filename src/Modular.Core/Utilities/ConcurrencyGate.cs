@@ -0,0 +1,130 @@
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// Limits how many operations run at once, like a <see cref="SemaphoreSlim"/>
+/// whose count can change while it is in use. Raising the limit starts queued
+/// waiters immediately; lowering it lets running operations finish and holds
+/// new ones back until the count drops below the new limit.
+/// </summary>
+public sealed class ConcurrencyGate
+{
+    private readonly object _lock = new();
+    private readonly LinkedList<TaskCompletionSource<IDisposable>> _waiters = new();
+    private int _limit;
+    private int _running;
+
+    public ConcurrencyGate(int limit)
+    {
+        _limit = Math.Max(1, limit);
+    }
+
+    public int Limit
+    {
+        get { lock (_lock) return _limit; }
+    }
+
+    public int Running
+    {
+        get { lock (_lock) return _running; }
+    }
+
+    public int Waiting
+    {
+        get { lock (_lock) return _waiters.Count; }
+    }
+
+    /// <summary>
+    /// Changes the limit. Values below 1 are treated as 1.
+    /// </summary>
+    public void SetLimit(int limit)
+    {
+        List<TaskCompletionSource<IDisposable>> released;
+        lock (_lock)
+        {
+            _limit = Math.Max(1, limit);
+            released = TakeReleasable();
+        }
+
+        Complete(released);
+    }
+
+    /// <summary>
+    /// Waits for a slot; dispose the result to free it.
+    /// </summary>
+    public Task<IDisposable> EnterAsync(CancellationToken ct = default)
+    {
+        ct.ThrowIfCancellationRequested();
+
+        LinkedListNode<TaskCompletionSource<IDisposable>> node;
+        lock (_lock)
+        {
+            if (_running < _limit && _waiters.Count == 0)
+            {
+                _running++;
+                return Task.FromResult<IDisposable>(new Lease(this));
+            }
+
+            node = _waiters.AddLast(new TaskCompletionSource<IDisposable>(TaskCreationOptions.RunContinuationsAsynchronously));
+        }
+
+        if (ct.CanBeCanceled)
+        {
+            var registration = ct.Register(() =>
+            {
+                lock (_lock)
+                {
+                    // Already granted a slot; the caller gets it and must dispose it
+                    if (node.List == null)
+                        return;
+                    _waiters.Remove(node);
+                }
+
+                node.Value.TrySetCanceled(ct);
+            });
+            node.Value.Task.ContinueWith(_ => registration.Dispose(), TaskScheduler.Default);
+        }
+
+        return node.Value.Task;
+    }
+
+    private void Release()
+    {
+        List<TaskCompletionSource<IDisposable>> released;
+        lock (_lock)
+        {
+            _running--;
+            released = TakeReleasable();
+        }
+
+        Complete(released);
+    }
+
+    // Called under _lock: claims slots for as many waiters as the limit allows
+    private List<TaskCompletionSource<IDisposable>> TakeReleasable()
+    {
+        var released = new List<TaskCompletionSource<IDisposable>>();
+        while (_running < _limit && _waiters.First is { } first)
+        {
+            _waiters.RemoveFirst();
+            _running++;
+            released.Add(first.Value);
+        }
+
+        return released;
+    }
+
+    private void Complete(List<TaskCompletionSource<IDisposable>> released)
+    {
+        foreach (var waiter in released)
+            waiter.SetResult(new Lease(this));
+    }
+
+    private sealed class Lease : IDisposable
+    {
+        private ConcurrencyGate? _gate;
+
+        public Lease(ConcurrencyGate gate) => _gate = gate;
+
+        public void Dispose() => Interlocked.Exchange(ref _gate, null)?.Release();
+    }
+}
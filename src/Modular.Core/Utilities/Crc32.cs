@@ -0,0 +1,68 @@
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// CRC-32 (IEEE 802.3, as used by ZIP, 7z and RAR) with slicing-by-8 tables.
+/// </summary>
+public static class Crc32
+{
+    private const uint Polynomial = 0xEDB88320;
+
+    private static readonly uint[] Table = BuildTable();
+
+    /// <summary>
+    /// Computes the CRC-32 of <paramref name="data"/>.
+    /// </summary>
+    public static uint Compute(ReadOnlySpan<byte> data) => Append(0, data);
+
+    /// <summary>
+    /// Continues a running CRC-32 (start with 0) over more data.
+    /// </summary>
+    public static uint Append(uint crc, ReadOnlySpan<byte> data)
+    {
+        var table = Table;
+        crc = ~crc;
+
+        while (data.Length >= 8)
+        {
+            var one = crc ^ (uint)(data[0] | data[1] << 8 | data[2] << 16 | data[3] << 24);
+            var two = (uint)(data[4] | data[5] << 8 | data[6] << 16 | data[7] << 24);
+            crc = table[7 * 256 + (one & 0xff)] ^
+                  table[6 * 256 + ((one >> 8) & 0xff)] ^
+                  table[5 * 256 + ((one >> 16) & 0xff)] ^
+                  table[4 * 256 + (one >> 24)] ^
+                  table[3 * 256 + (two & 0xff)] ^
+                  table[2 * 256 + ((two >> 8) & 0xff)] ^
+                  table[1 * 256 + ((two >> 16) & 0xff)] ^
+                  table[two >> 24];
+            data = data[8..];
+        }
+
+        foreach (var b in data)
+            crc = table[(crc ^ b) & 0xff] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    private static uint[] BuildTable()
+    {
+        var table = new uint[8 * 256];
+        for (uint i = 0; i < 256; i++)
+        {
+            var crc = i;
+            for (var bit = 0; bit < 8; bit++)
+                crc = (crc & 1) != 0 ? (crc >> 1) ^ Polynomial : crc >> 1;
+            table[i] = crc;
+        }
+
+        for (var i = 0; i < 256; i++)
+        {
+            for (var slice = 1; slice < 8; slice++)
+            {
+                var previous = table[(slice - 1) * 256 + i];
+                table[slice * 256 + i] = (previous >> 8) ^ table[previous & 0xff];
+            }
+        }
+
+        return table;
+    }
+}
@@ -0,0 +1,71 @@
+using System.Runtime.InteropServices;
+
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// fsync for files and directories. Flushing a file only makes its data
+/// durable; a newly created, renamed or deleted name is only durable once
+/// the directory holding it has been flushed too.
+/// </summary>
+public static class DurableFile
+{
+    // O_RDONLY opens directories too; O_DIRECTORY's value differs between architectures
+    private const int ORdOnly = 0;
+
+    [DllImport("libc", EntryPoint = "open", SetLastError = true)]
+    private static extern int Open([MarshalAs(UnmanagedType.LPUTF8Str)] string path, int flags);
+
+    [DllImport("libc", EntryPoint = "fsync", SetLastError = true)]
+    private static extern int Fsync(int fd);
+
+    [DllImport("libc", EntryPoint = "close")]
+    private static extern int Close(int fd);
+
+    private static bool _unavailable;
+
+    /// <summary>
+    /// Flushes a file's data and metadata to disk.
+    /// </summary>
+    public static void FlushFile(string path)
+    {
+        // Windows needs write access for FlushFileBuffers; fsync does not care
+        var access = OperatingSystem.IsWindows() ? FileAccess.ReadWrite : FileAccess.Read;
+        using var stream = new FileStream(path, FileMode.Open, access, FileShare.ReadWrite | FileShare.Delete);
+        stream.Flush(flushToDisk: true);
+    }
+
+    /// <summary>
+    /// Flushes a directory so entries created, renamed or removed in it
+    /// survive a crash. Does nothing on Windows, where NTFS journals
+    /// directory changes itself and directories cannot be opened for flushing.
+    /// </summary>
+    public static void FlushDirectory(string path)
+    {
+        if (OperatingSystem.IsWindows() || _unavailable)
+            return;
+
+        int fd;
+        try
+        {
+            fd = Open(path, ORdOnly);
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException)
+        {
+            _unavailable = true;
+            return;
+        }
+
+        if (fd < 0)
+            throw new IOException($"Cannot open directory for flushing: {path} (errno {Marshal.GetLastWin32Error()})");
+
+        try
+        {
+            if (Fsync(fd) != 0)
+                throw new IOException($"Failed to flush directory: {path} (errno {Marshal.GetLastWin32Error()})");
+        }
+        finally
+        {
+            Close(fd);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+using System.Runtime.InteropServices;
+using Microsoft.Win32.SafeHandles;
+
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// Copy-on-write file cloning. On btrfs, XFS (reflink=1), bcachefs and other
+/// filesystems supporting FICLONE the clone shares all data extents with the
+/// source, so it is near-instant and uses no extra space until either side is
+/// modified.
+/// </summary>
+public static class FileClone
+{
+    // _IOW(0x94, 9, int)
+    private const ulong Ficlone = 0x40049409;
+
+    [DllImport("libc", EntryPoint = "ioctl", SetLastError = true)]
+    private static extern int Ioctl(int fd, ulong request, int sourceFd);
+
+    private static bool _unavailable;
+
+    /// <summary>
+    /// Clones the whole of <paramref name="source"/> into the empty file
+    /// <paramref name="destination"/>. Returns false when the platform or
+    /// filesystem does not support reflinks (or the files are on different
+    /// filesystems); the destination is then left untouched and empty.
+    /// </summary>
+    public static bool TryReflink(SafeFileHandle source, SafeFileHandle destination)
+    {
+        if (!OperatingSystem.IsLinux() || _unavailable)
+            return false;
+
+        try
+        {
+            var sourceFd = (int)source.DangerousGetHandle();
+            var destinationFd = (int)destination.DangerousGetHandle();
+            return Ioctl(destinationFd, Ficlone, sourceFd) == 0;
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException)
+        {
+            _unavailable = true;
+            return false;
+        }
+    }
+}
@@ -0,0 +1,154 @@
+using System.Buffers.Binary;
+using System.Runtime.InteropServices;
+
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// Identity and change stamp of a file: the device and inode it lives on plus
+/// its size and modification time. Two stats that compare equal mean the file
+/// has (in practice) not been replaced or rewritten.
+/// </summary>
+public readonly record struct FileStat(ulong Device, ulong Inode, long Size, long MtimeNs)
+{
+    private const int AtFdCwd = -100;
+    private const uint StatxBasicStats = 0x7ff;
+    private const int StatxBufferSize = 256;
+
+    [DllImport("libc", EntryPoint = "statx", SetLastError = true)]
+    private static extern int Statx(
+        int dirfd,
+        [MarshalAs(UnmanagedType.LPUTF8Str)] string pathname,
+        int flags,
+        uint mask,
+        [Out] byte[] buffer);
+
+    private static bool _statxUnavailable;
+
+    /// <summary>
+    /// Device id in Linux dev_t encoding (major/minor), or 0 when unknown.
+    /// </summary>
+    public uint DeviceMajor => (uint)(((Device >> 32) & 0xfffff000) | ((Device >> 8) & 0xfff));
+
+    /// <summary>
+    /// Minor number of <see cref="Device"/>.
+    /// </summary>
+    public uint DeviceMinor => (uint)(((Device >> 12) & 0xffffff00) | (Device & 0xff));
+
+    /// <summary>
+    /// Stats a file. Uses statx(2) on Linux for device and inode numbers;
+    /// elsewhere only size and mtime are populated.
+    /// </summary>
+    public static bool TryGet(string path, out FileStat stat)
+    {
+        if (OperatingSystem.IsLinux() && !_statxUnavailable && TryStatx(path, regularFileOnly: true, out stat))
+            return true;
+
+        var info = new FileInfo(path);
+        if (!info.Exists)
+        {
+            stat = default;
+            return false;
+        }
+
+        stat = new FileStat(0, 0, info.Length, (info.LastWriteTimeUtc.Ticks - DateTime.UnixEpoch.Ticks) * 100);
+        return true;
+    }
+
+    /// <summary>
+    /// Gets the device id of any path (file or directory). Returns false when
+    /// unknown, e.g. on non-Linux platforms.
+    /// </summary>
+    public static bool TryGetDevice(string path, out ulong device)
+    {
+        device = 0;
+        if (!OperatingSystem.IsLinux() || _statxUnavailable || !TryStatx(path, regularFileOnly: false, out var stat))
+            return false;
+
+        device = stat.Device;
+        return true;
+    }
+
+    private static bool TryStatx(string path, bool regularFileOnly, out FileStat stat)
+    {
+        stat = default;
+        var buffer = new byte[StatxBufferSize];
+
+        try
+        {
+            if (Statx(AtFdCwd, path, 0, StatxBasicStats, buffer) != 0)
+                return false;
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException)
+        {
+            // Old libc without statx, fall back to FileInfo from now on
+            _statxUnavailable = true;
+            return false;
+        }
+
+        // struct statx layout is identical on every Linux architecture
+        var span = buffer.AsSpan();
+        var mode = BinaryPrimitives.ReadUInt16LittleEndian(span[28..]);
+        if (regularFileOnly && (mode & 0xF000) != 0x8000)
+            return false;
+
+        var inode = BinaryPrimitives.ReadUInt64LittleEndian(span[32..]);
+        var size = BinaryPrimitives.ReadInt64LittleEndian(span[40..]);
+        var mtimeSec = BinaryPrimitives.ReadInt64LittleEndian(span[112..]);
+        var mtimeNsec = BinaryPrimitives.ReadUInt32LittleEndian(span[120..]);
+        var major = BinaryPrimitives.ReadUInt32LittleEndian(span[136..]);
+        var minor = BinaryPrimitives.ReadUInt32LittleEndian(span[140..]);
+
+        stat = new FileStat(MakeDevice(major, minor), inode, size, mtimeSec * 1_000_000_000 + mtimeNsec);
+        return true;
+    }
+
+    private static ulong MakeDevice(uint major, uint minor) =>
+        ((ulong)(major & 0xfffff000) << 32) | ((ulong)(major & 0xfff) << 8) |
+        ((ulong)(minor & 0xffffff00) << 12) | (minor & 0xff);
+}
+
+/// <summary>
+/// Block device characteristics used to pick I/O parallelism.
+/// </summary>
+public static class StorageDevices
+{
+    /// <summary>
+    /// Returns true if the device is a spinning disk, false if it is solid state,
+    /// or null if it cannot be determined (non-Linux, network or virtual filesystems).
+    /// </summary>
+    public static bool? IsRotational(FileStat stat)
+    {
+        if (!OperatingSystem.IsLinux() || stat.Device == 0)
+            return null;
+
+        var deviceDir = $"/sys/dev/block/{stat.DeviceMajor}:{stat.DeviceMinor}";
+
+        // Partitions have no queue/ of their own; use the parent disk's
+        foreach (var candidate in new[] { Path.Combine(deviceDir, "queue", "rotational"), Path.Combine(deviceDir, "..", "queue", "rotational") })
+        {
+            try
+            {
+                if (File.Exists(candidate))
+                    return File.ReadAllText(candidate).Trim() == "1";
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+            {
+                return null;
+            }
+        }
+
+        return null;
+    }
+
+    /// <summary>
+    /// Recommended number of concurrent readers for the device holding a file:
+    /// one for spinning disks (seeks dominate), several for SSDs, and a
+    /// conservative middle ground when unknown.
+    /// </summary>
+    public static int RecommendedParallelism(FileStat stat) => IsRotational(stat) switch
+    {
+        true => 1,
+        false => Math.Clamp(Environment.ProcessorCount, 2, 8),
+        null => 2
+    };
+}
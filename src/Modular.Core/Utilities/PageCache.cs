@@ -0,0 +1,72 @@
+using System.Runtime.InteropServices;
+using Microsoft.Win32.SafeHandles;
+
+namespace Modular.Core.Utilities;
+
+/// <summary>
+/// Keeps large sequential writes from filling the page cache. On Linux a
+/// written range is pushed to disk with sync_file_range(2) and then dropped
+/// with posix_fadvise(POSIX_FADV_DONTNEED), so writing a multi-GB file does
+/// not evict the cached data of running programs. Elsewhere these calls do
+/// nothing; callers use <see cref="FileOptions.WriteThrough"/> instead.
+/// </summary>
+public static class PageCache
+{
+    private const uint SyncFileRangeWaitBefore = 1;
+    private const uint SyncFileRangeWrite = 2;
+    private const uint SyncFileRangeWaitAfter = 4;
+    private const int PosixFadvDontNeed = 4;
+
+    [DllImport("libc", EntryPoint = "sync_file_range", SetLastError = true)]
+    private static extern int SyncFileRange(int fd, long offset, long nbytes, uint flags);
+
+    [DllImport("libc", EntryPoint = "posix_fadvise")]
+    private static extern int PosixFadvise(int fd, long offset, long len, int advice);
+
+    private static bool _unavailable;
+
+    /// <summary>
+    /// True where <see cref="StartWriteback"/> and <see cref="Release"/> have
+    /// an effect.
+    /// </summary>
+    public static bool IsSupported => OperatingSystem.IsLinux() && !_unavailable;
+
+    /// <summary>
+    /// Starts writing back a dirty range without waiting for it.
+    /// </summary>
+    public static void StartWriteback(SafeFileHandle handle, long offset, long length)
+    {
+        if (!IsSupported || length <= 0)
+            return;
+
+        Invoke(() => SyncFileRange((int)handle.DangerousGetHandle(), offset, length, SyncFileRangeWrite));
+    }
+
+    /// <summary>
+    /// Waits until a range is on disk and drops it from the page cache.
+    /// </summary>
+    public static void Release(SafeFileHandle handle, long offset, long length)
+    {
+        if (!IsSupported || length <= 0)
+            return;
+
+        var fd = (int)handle.DangerousGetHandle();
+        Invoke(() => SyncFileRange(fd, offset, length, SyncFileRangeWaitBefore | SyncFileRangeWrite | SyncFileRangeWaitAfter));
+
+        // Only clean pages can be dropped, hence the sync first
+        Invoke(() => PosixFadvise(fd, offset, length, PosixFadvDontNeed));
+    }
+
+    private static void Invoke(Func<int> call)
+    {
+        try
+        {
+            // Failures only mean the hint was not taken; the data is written either way
+            call();
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException)
+        {
+            _unavailable = true;
+        }
+    }
+}
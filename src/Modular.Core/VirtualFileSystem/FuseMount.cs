@@ -0,0 +1,350 @@
+using System.Runtime.InteropServices;
+using Microsoft.Extensions.Logging;
+using Modular.Core.Utilities;
+using static Modular.Core.VirtualFileSystem.FuseNative;
+
+namespace Modular.Core.VirtualFileSystem;
+
+/// <summary>
+/// Exposes a <see cref="LayeredVfsResolver"/> as a FUSE filesystem, so a
+/// game directory can show a mod set without copying any mod files into it.
+/// Reads go straight to the winning layer's file; writes go through a
+/// <see cref="VfsOverlay"/>. Linux only, and needs libfuse 3 and
+/// <c>/dev/fuse</c> (see <see cref="IsSupported"/>).
+/// </summary>
+public sealed class FuseMount : IDisposable
+{
+    private readonly VfsOverlay _overlay;
+    private readonly ILogger<FuseMount>? _logger;
+    private readonly NativeStat _stat;
+    private readonly uint _uid = GetUid();
+    private readonly uint _gid = GetGid();
+
+    // Kept in fields so the GC can't collect them while libfuse holds the pointers
+    private readonly List<Delegate> _callbacks = new();
+    private IntPtr _fuse;
+    private Thread? _loop;
+    private bool _disposed;
+
+    private FuseMount(VfsOverlay overlay, string mountPoint, ILogger<FuseMount>? logger)
+    {
+        _overlay = overlay;
+        _logger = logger;
+        _stat = new NativeStat(StatLayout.Current!);
+        MountPoint = mountPoint;
+    }
+
+    /// <summary>
+    /// Whether FUSE mounts can be made on this machine.
+    /// </summary>
+    public static bool IsSupported => IsAvailable();
+
+    /// <summary>
+    /// Directory the merged view is mounted on.
+    /// </summary>
+    public string MountPoint { get; }
+
+    /// <summary>
+    /// Mounts the merged view of <paramref name="overlay"/>'s resolver on
+    /// <paramref name="mountPoint"/> and serves it on a background thread
+    /// until disposed.
+    /// </summary>
+    public static FuseMount Mount(VfsOverlay overlay, string mountPoint, ILogger<FuseMount>? logger = null)
+    {
+        if (!IsSupported)
+            throw new PlatformNotSupportedException("FUSE mounts need Linux, libfuse 3 and /dev/fuse");
+
+        Directory.CreateDirectory(mountPoint);
+        var mount = new FuseMount(overlay, Path.GetFullPath(mountPoint), logger);
+        try
+        {
+            mount.Start();
+        }
+        catch
+        {
+            mount.Dispose();
+            throw;
+        }
+
+        return mount;
+    }
+
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+        _disposed = true;
+
+        if (_fuse == IntPtr.Zero)
+            return;
+
+        Exit(_fuse);
+        if (_loop != null)
+        {
+            // Unmounting ends the session, which wakes the loop
+            Unmount(_fuse);
+            _loop.Join();
+        }
+
+        Destroy(_fuse);
+        _fuse = IntPtr.Zero;
+        _logger?.LogInformation("Unmounted merged view from {MountPoint}", MountPoint);
+    }
+
+    private void Start()
+    {
+        var operations = new FuseOperations
+        {
+            GetAttr = Register<GetAttrCallback>(OnGetAttr),
+            MkDir = Register<PathModeCallback>(OnMkDir),
+            Unlink = Register<PathCallback>(OnUnlink),
+            RmDir = Register<PathCallback>(OnRmDir),
+            Rename = Register<RenameCallback>(OnRename),
+            Chmod = Register<ChmodCallback>((_, _, _) => 0),
+            Chown = Register<ChownCallback>((_, _, _, _) => 0),
+            Truncate = Register<TruncateCallback>(OnTruncate),
+            Open = Register<FileInfoCallback>(OnOpen),
+            Read = Register<ReadWriteCallback>(OnRead),
+            Write = Register<ReadWriteCallback>(OnWrite),
+            Flush = Register<FileInfoCallback>((_, _) => 0),
+            Release = Register<FileInfoCallback>((_, _) => 0),
+            Fsync = Register<FsyncCallback>((_, _, _) => 0),
+            ReadDir = Register<ReadDirCallback>(OnReadDir),
+            Access = Register<AccessCallback>(OnAccess),
+            Create = Register<CreateCallback>(OnCreate),
+            Utimens = Register<UtimensCallback>((_, _, _) => 0)
+        };
+
+        // fuse_new and fuse_loop rather than fuse_main, which would take over the process's signal handlers
+        var argv = new[] { "modular-vfs", "-o", "fsname=modular" }.Select(Marshal.StringToCoTaskMemUTF8).ToArray();
+        var argvBlock = Marshal.AllocHGlobal(IntPtr.Size * argv.Length);
+        try
+        {
+            Marshal.Copy(argv, 0, argvBlock, argv.Length);
+            var args = new FuseArgs { Argc = argv.Length, Argv = argvBlock };
+            _fuse = New(ref args, ref operations, (nuint)Marshal.SizeOf<FuseOperations>(), IntPtr.Zero);
+        }
+        finally
+        {
+            Marshal.FreeHGlobal(argvBlock);
+            foreach (var arg in argv)
+                Marshal.FreeCoTaskMem(arg);
+        }
+
+        if (_fuse == IntPtr.Zero)
+            throw new IOException("fuse_new failed");
+        if (FuseNative.Mount(_fuse, MountPoint) != 0)
+            throw new IOException($"Could not mount merged view on {MountPoint}");
+
+        _loop = new Thread(() =>
+        {
+            var status = Loop(_fuse);
+            if (status != 0 && !_disposed)
+                _logger?.LogWarning("FUSE loop for {MountPoint} ended with status {Status}", MountPoint, status);
+        })
+        {
+            IsBackground = true,
+            Name = "FUSE " + MountPoint
+        };
+        _loop.Start();
+
+        _logger?.LogInformation("Mounted merged view of {Count} layers on {MountPoint}",
+            _overlay.Resolver.Layers.Count, MountPoint);
+    }
+
+    private IntPtr Register<T>(T callback) where T : Delegate
+    {
+        _callbacks.Add(callback);
+        return Marshal.GetFunctionPointerForDelegate(callback);
+    }
+
+    private int OnGetAttr(IntPtr path, IntPtr stat, IntPtr fileInfo) => Guard(() =>
+    {
+        var entry = _overlay.Resolver.Resolve(PathOf(path));
+        if (entry == null)
+            return -ENOENT;
+
+        if (entry.IsDirectory)
+        {
+            _stat.Write(stat, S_IFDIR | 0x1ED, nlink: 2, _uid, _gid, size: 0, mtimeNs: 0);
+            return 0;
+        }
+
+        if (!FileStat.TryGet(entry.PhysicalPath!, out var fileStat))
+            return -ENOENT;
+
+        _stat.Write(stat, S_IFREG | 0x1A4, nlink: 1, _uid, _gid, fileStat.Size, fileStat.MtimeNs);
+        return 0;
+    });
+
+    private int OnReadDir(IntPtr path, IntPtr buffer, IntPtr filler, long offset, IntPtr fileInfo, int flags) => Guard(() =>
+    {
+        var entries = _overlay.Resolver.ListDirectory(PathOf(path));
+        if (entries == null)
+            return -ENOTDIR;
+
+        var fill = Marshal.GetDelegateForFunctionPointer<FillDir>(filler);
+        fill(buffer, ".", IntPtr.Zero, 0, 0);
+        fill(buffer, "..", IntPtr.Zero, 0, 0);
+        foreach (var entry in entries)
+        {
+            if (fill(buffer, entry.Name, IntPtr.Zero, 0, 0) != 0)
+                break;
+        }
+
+        return 0;
+    });
+
+    private int OnAccess(IntPtr path, int mask) => Guard(() =>
+        _overlay.Resolver.Resolve(PathOf(path)) == null ? -ENOENT : 0);
+
+    private int OnOpen(IntPtr path, IntPtr fileInfo) => Guard(() =>
+    {
+        var name = PathOf(path);
+        var entry = _overlay.Resolver.Resolve(name);
+        if (entry == null)
+            return -ENOENT;
+
+        // struct fuse_file_info starts with the open flags
+        var flags = Marshal.ReadInt32(fileInfo);
+        if ((flags & O_ACCMODE) != 0)
+            _overlay.PrepareWrite(name);
+        return 0;
+    });
+
+    private int OnCreate(IntPtr path, uint mode, IntPtr fileInfo) => Guard(() =>
+    {
+        _overlay.CreateFile(PathOf(path));
+        return 0;
+    });
+
+    private int OnRead(IntPtr path, IntPtr buffer, nuint size, long offset, IntPtr fileInfo) => Guard(() =>
+    {
+        var entry = _overlay.Resolver.Resolve(PathOf(path));
+        if (entry == null || entry.IsDirectory)
+            return entry == null ? -ENOENT : -EISDIR;
+
+        var data = new byte[(int)size];
+        using var handle = File.OpenHandle(entry.PhysicalPath!, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete);
+
+        var total = 0;
+        while (total < data.Length)
+        {
+            var read = RandomAccess.Read(handle, data.AsSpan(total), offset + total);
+            if (read == 0)
+                break;
+            total += read;
+        }
+
+        Marshal.Copy(data, 0, buffer, total);
+        return total;
+    });
+
+    private int OnWrite(IntPtr path, IntPtr buffer, nuint size, long offset, IntPtr fileInfo) => Guard(() =>
+    {
+        var target = _overlay.PrepareWrite(PathOf(path));
+        var data = new byte[(int)size];
+        Marshal.Copy(buffer, data, 0, data.Length);
+
+        using var handle = File.OpenHandle(target, FileMode.Open, FileAccess.Write, FileShare.ReadWrite | FileShare.Delete);
+        RandomAccess.Write(handle, data, offset);
+        return data.Length;
+    });
+
+    private int OnTruncate(IntPtr path, long size, IntPtr fileInfo) => Guard(() =>
+    {
+        _overlay.Truncate(PathOf(path), size);
+        return 0;
+    });
+
+    private int OnUnlink(IntPtr path) => Guard(() =>
+    {
+        _overlay.DeleteFile(PathOf(path));
+        return 0;
+    });
+
+    private int OnMkDir(IntPtr path, uint mode) => Guard(() =>
+    {
+        _overlay.CreateDirectory(PathOf(path));
+        return 0;
+    });
+
+    private int OnRmDir(IntPtr path) => Guard(() =>
+    {
+        _overlay.DeleteDirectory(PathOf(path));
+        return 0;
+    });
+
+    private int OnRename(IntPtr from, IntPtr to, uint flags) => Guard(() =>
+    {
+        _overlay.RenameFile(PathOf(from), PathOf(to));
+        return 0;
+    });
+
+    /// <summary>
+    /// Runs a callback, turning exceptions into negative errno values; an
+    /// exception must never unwind into libfuse.
+    /// </summary>
+    private int Guard(Func<int> callback)
+    {
+        try
+        {
+            return callback();
+        }
+        catch (VfsOverlayException ex)
+        {
+            return -(ex.Error switch
+            {
+                VfsOverlayError.NotFound => ENOENT,
+                VfsOverlayError.Exists => EEXIST,
+                VfsOverlayError.NotEmpty => ENOTEMPTY,
+                VfsOverlayError.IsDirectory => EISDIR,
+                VfsOverlayError.NotDirectory => ENOTDIR,
+                _ => EACCES
+            });
+        }
+        catch (Exception ex) when (ex is FileNotFoundException or DirectoryNotFoundException)
+        {
+            return -ENOENT;
+        }
+        catch (UnauthorizedAccessException)
+        {
+            return -EACCES;
+        }
+        catch (Exception ex)
+        {
+            _logger?.LogWarning(ex, "FUSE operation failed on {MountPoint}", MountPoint);
+            return -EIO;
+        }
+    }
+
+    private static string PathOf(IntPtr path) => Marshal.PtrToStringUTF8(path) ?? string.Empty;
+
+    /// <summary>
+    /// Fills a struct stat in place for the running architecture.
+    /// </summary>
+    private sealed class NativeStat(StatLayout layout)
+    {
+        private readonly byte[] _zero = new byte[layout.Size];
+
+        public void Write(IntPtr stat, uint mode, int nlink, uint uid, uint gid, long size, long mtimeNs)
+        {
+            Marshal.Copy(_zero, 0, stat, _zero.Length);
+            Marshal.WriteInt32(stat, layout.Mode, (int)mode);
+            if (layout.WideNLink)
+                Marshal.WriteInt64(stat, layout.NLink, nlink);
+            else
+                Marshal.WriteInt32(stat, layout.NLink, nlink);
+            Marshal.WriteInt32(stat, layout.Uid, (int)uid);
+            Marshal.WriteInt32(stat, layout.Gid, (int)gid);
+            Marshal.WriteInt64(stat, layout.FileSize, size);
+
+            // atime, mtime and ctime are consecutive timespecs
+            for (var i = -1; i <= 1; i++)
+            {
+                Marshal.WriteInt64(stat, layout.MTime + 16 * i, mtimeNs / 1_000_000_000);
+                Marshal.WriteInt64(stat, layout.MTime + 16 * i + 8, mtimeNs % 1_000_000_000);
+            }
+        }
+    }
+}
@@ -0,0 +1,170 @@
+using System.Runtime.InteropServices;
+
+namespace Modular.Core.VirtualFileSystem;
+
+/// <summary>
+/// libfuse 3 entry points and the parts of its ABI the mount uses.
+/// </summary>
+internal static class FuseNative
+{
+    private const string Library = "libfuse3.so.3";
+
+    public const int ENOENT = 2;
+    public const int EIO = 5;
+    public const int EACCES = 13;
+    public const int EEXIST = 17;
+    public const int ENOTDIR = 20;
+    public const int EISDIR = 21;
+    public const int ENOTEMPTY = 39;
+
+    public const uint S_IFDIR = 0x4000;
+    public const uint S_IFREG = 0x8000;
+    public const int O_ACCMODE = 3;
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FuseArgs
+    {
+        public int Argc;
+        public IntPtr Argv;
+        public int Allocated;
+    }
+
+    /// <summary>
+    /// struct fuse_operations up to utimens; libfuse is told the size, so
+    /// the callbacks after it are treated as unset.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FuseOperations
+    {
+        public IntPtr GetAttr;
+        public IntPtr ReadLink;
+        public IntPtr MkNod;
+        public IntPtr MkDir;
+        public IntPtr Unlink;
+        public IntPtr RmDir;
+        public IntPtr Symlink;
+        public IntPtr Rename;
+        public IntPtr Link;
+        public IntPtr Chmod;
+        public IntPtr Chown;
+        public IntPtr Truncate;
+        public IntPtr Open;
+        public IntPtr Read;
+        public IntPtr Write;
+        public IntPtr StatFs;
+        public IntPtr Flush;
+        public IntPtr Release;
+        public IntPtr Fsync;
+        public IntPtr SetXAttr;
+        public IntPtr GetXAttr;
+        public IntPtr ListXAttr;
+        public IntPtr RemoveXAttr;
+        public IntPtr OpenDir;
+        public IntPtr ReadDir;
+        public IntPtr ReleaseDir;
+        public IntPtr FsyncDir;
+        public IntPtr Init;
+        public IntPtr Destroy;
+        public IntPtr Access;
+        public IntPtr Create;
+        public IntPtr Lock;
+        public IntPtr Utimens;
+    }
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int GetAttrCallback(IntPtr path, IntPtr stat, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int PathCallback(IntPtr path);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int PathModeCallback(IntPtr path, uint mode);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int RenameCallback(IntPtr from, IntPtr to, uint flags);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int ChmodCallback(IntPtr path, uint mode, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int ChownCallback(IntPtr path, uint uid, uint gid, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int TruncateCallback(IntPtr path, long size, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int FileInfoCallback(IntPtr path, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int ReadWriteCallback(IntPtr path, IntPtr buffer, nuint size, long offset, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int FsyncCallback(IntPtr path, int dataSync, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int ReadDirCallback(IntPtr path, IntPtr buffer, IntPtr filler, long offset, IntPtr fileInfo, int flags);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int FillDir(IntPtr buffer, [MarshalAs(UnmanagedType.LPUTF8Str)] string name, IntPtr stat, long offset, int flags);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int AccessCallback(IntPtr path, int mask);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int CreateCallback(IntPtr path, uint mode, IntPtr fileInfo);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    public delegate int UtimensCallback(IntPtr path, IntPtr times, IntPtr fileInfo);
+
+    [DllImport(Library, EntryPoint = "fuse_new")]
+    public static extern IntPtr New(ref FuseArgs args, ref FuseOperations operations, nuint operationsSize, IntPtr userData);
+
+    [DllImport(Library, EntryPoint = "fuse_mount")]
+    public static extern int Mount(IntPtr fuse, [MarshalAs(UnmanagedType.LPUTF8Str)] string mountPoint);
+
+    [DllImport(Library, EntryPoint = "fuse_loop")]
+    public static extern int Loop(IntPtr fuse);
+
+    [DllImport(Library, EntryPoint = "fuse_exit")]
+    public static extern void Exit(IntPtr fuse);
+
+    [DllImport(Library, EntryPoint = "fuse_unmount")]
+    public static extern void Unmount(IntPtr fuse);
+
+    [DllImport(Library, EntryPoint = "fuse_destroy")]
+    public static extern void Destroy(IntPtr fuse);
+
+    [DllImport("libc", EntryPoint = "getuid")]
+    public static extern uint GetUid();
+
+    [DllImport("libc", EntryPoint = "getgid")]
+    public static extern uint GetGid();
+
+    /// <summary>
+    /// Whether libfuse 3 can be loaded and the kernel offers /dev/fuse.
+    /// </summary>
+    public static bool IsAvailable()
+    {
+        if (!OperatingSystem.IsLinux() || !File.Exists("/dev/fuse") || StatLayout.Current == null)
+            return false;
+
+        if (!NativeLibrary.TryLoad(Library, out var handle))
+            return false;
+
+        NativeLibrary.Free(handle);
+        return true;
+    }
+
+    /// <summary>
+    /// Field offsets of struct stat, which differs between architectures.
+    /// </summary>
+    public sealed record StatLayout(int Size, int Mode, int NLink, bool WideNLink, int Uid, int Gid, int FileSize, int MTime)
+    {
+        public static readonly StatLayout? Current = RuntimeInformation.ProcessArchitecture switch
+        {
+            Architecture.X64 => new StatLayout(144, Mode: 24, NLink: 16, WideNLink: true, Uid: 28, Gid: 32, FileSize: 48, MTime: 88),
+            Architecture.Arm64 => new StatLayout(128, Mode: 16, NLink: 20, WideNLink: false, Uid: 24, Gid: 28, FileSize: 48, MTime: 88),
+            _ => null
+        };
+    }
+}
@@ -0,0 +1,317 @@
+namespace Modular.Core.VirtualFileSystem;
+
+/// <summary>
+/// Computes the merged view of a game directory from stacked layers without
+/// touching the disk. Every path any layer provides is kept in a trie of
+/// path segments (case-insensitive, as Windows games expect), and each file
+/// node lists its providing layers winner first, so resolving a path costs
+/// one dictionary lookup per segment however many layers there are.
+/// Adding or removing a layer only touches the paths that layer provides.
+/// </summary>
+public class LayeredVfsResolver
+{
+    private readonly Node _root = new(string.Empty, null);
+    private readonly Dictionary<string, LayerState> _layers = new(StringComparer.Ordinal);
+    private readonly object _lock = new();
+    private long _sequence;
+
+    /// <summary>
+    /// IDs of all layers, highest priority first.
+    /// </summary>
+    public IReadOnlyList<string> Layers
+    {
+        get
+        {
+            lock (_lock)
+            {
+                return _layers.Values
+                    .OrderByDescending(l => l.Layer.Priority)
+                    .ThenByDescending(l => l.Sequence)
+                    .Select(l => l.Layer.Id)
+                    .ToList();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Stacks a layer onto the view.
+    /// </summary>
+    public void AddLayer(VfsLayer layer)
+    {
+        lock (_lock)
+        {
+            if (_layers.ContainsKey(layer.Id))
+                throw new InvalidOperationException($"Layer '{layer.Id}' is already added");
+
+            var state = new LayerState(layer, ++_sequence);
+            _layers.Add(layer.Id, state);
+            foreach (var file in layer.Files)
+                AddFile(state, file);
+        }
+    }
+
+    /// <summary>
+    /// Removes a layer from the view. Returns false if it was not added.
+    /// </summary>
+    public bool RemoveLayer(string layerId)
+    {
+        lock (_lock)
+        {
+            if (!_layers.Remove(layerId, out var state))
+                return false;
+
+            foreach (var file in state.Files)
+                RemoveEntry(state, file, isDirectory: false);
+            foreach (var directory in state.Directories)
+                RemoveEntry(state, directory, isDirectory: true);
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Records a file created in a layer after it was added, e.g. a write
+    /// into the overlay.
+    /// </summary>
+    public void AddFile(string layerId, string path)
+    {
+        lock (_lock)
+        {
+            AddFile(GetLayer(layerId), NormalizePath(path));
+        }
+    }
+
+    /// <summary>
+    /// Records a file removed from a layer. Returns false if the layer did
+    /// not provide it.
+    /// </summary>
+    public bool RemoveFile(string layerId, string path)
+    {
+        lock (_lock)
+        {
+            var state = GetLayer(layerId);
+            var normalized = NormalizePath(path);
+            if (!state.Files.TryGetValue(normalized, out var existing))
+                return false;
+
+            state.Files.Remove(existing);
+            RemoveEntry(state, existing, isDirectory: false);
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Records a directory a layer has even when it holds no files, e.g. one
+    /// created in the overlay.
+    /// </summary>
+    public void AddDirectory(string layerId, string path)
+    {
+        lock (_lock)
+        {
+            var state = GetLayer(layerId);
+            var normalized = NormalizePath(path);
+            if (normalized.Length > 0 && state.Directories.Add(normalized))
+                AddEntry(state, normalized, isDirectory: true);
+        }
+    }
+
+    /// <summary>
+    /// Removes a directory recorded with <see cref="AddDirectory"/>.
+    /// </summary>
+    public bool RemoveDirectory(string layerId, string path)
+    {
+        lock (_lock)
+        {
+            var state = GetLayer(layerId);
+            var normalized = NormalizePath(path);
+            if (!state.Directories.TryGetValue(normalized, out var existing))
+                return false;
+
+            state.Directories.Remove(existing);
+            RemoveEntry(state, existing, isDirectory: true);
+            return true;
+        }
+    }
+
+    /// <summary>
+    /// Resolves a game-relative path to the winning file or to a merged
+    /// directory. Returns null if no layer provides it. A path that is a
+    /// file in one layer and a directory in another resolves to the file.
+    /// </summary>
+    public VfsEntry? Resolve(string path)
+    {
+        lock (_lock)
+        {
+            var node = Find(path);
+            if (node == null)
+                return null;
+
+            if (node.Providers is { Count: > 0 } providers)
+            {
+                var winner = providers[0];
+                return new VfsEntry(MergedPath(node), false, winner.Layer.Layer.Id, PhysicalPath(winner));
+            }
+
+            return new VfsEntry(MergedPath(node), true, null, null);
+        }
+    }
+
+    /// <summary>
+    /// Lists a merged directory. Returns null if the path is not a directory.
+    /// </summary>
+    public IReadOnlyList<VfsDirectoryEntry>? ListDirectory(string path)
+    {
+        lock (_lock)
+        {
+            var node = Find(path);
+            if (node == null || node.Providers is { Count: > 0 })
+                return null;
+
+            if (node.Children == null)
+                return [];
+
+            return node.Children.Values
+                .Select(c => new VfsDirectoryEntry(c.Name, c.Providers is not { Count: > 0 }))
+                .ToList();
+        }
+    }
+
+    /// <summary>
+    /// IDs of every layer providing a file, winner first.
+    /// </summary>
+    public IReadOnlyList<string> GetProviders(string path)
+    {
+        lock (_lock)
+        {
+            var providers = Find(path)?.Providers;
+            return providers == null ? [] : providers.Select(p => p.Layer.Layer.Id).ToList();
+        }
+    }
+
+    /// <summary>
+    /// Converts a path to the '/'-separated form used for lookups, dropping
+    /// empty and "." segments.
+    /// </summary>
+    public static string NormalizePath(string path)
+    {
+        var segments = path.Split('/', '\\');
+        if (segments.Any(s => s == ".."))
+            throw new ArgumentException($"Path must not leave its root: '{path}'", nameof(path));
+
+        return string.Join('/', segments.Where(s => s.Length > 0 && s != "."));
+    }
+
+    private LayerState GetLayer(string layerId) =>
+        _layers.TryGetValue(layerId, out var state)
+            ? state
+            : throw new KeyNotFoundException($"Layer '{layerId}' is not added");
+
+    private void AddFile(LayerState state, string path)
+    {
+        // A layer can't provide two files that differ only in case
+        if (state.Files.Add(path))
+            AddEntry(state, path, isDirectory: false);
+    }
+
+    private void AddEntry(LayerState state, string path, bool isDirectory)
+    {
+        var node = _root;
+        node.Entries++;
+        foreach (var segment in path.Split('/'))
+        {
+            node.Children ??= new Dictionary<string, Node>(StringComparer.OrdinalIgnoreCase);
+            if (!node.Children.TryGetValue(segment, out var child))
+            {
+                child = new Node(segment, node);
+                node.Children.Add(segment, child);
+            }
+
+            node = child;
+            node.Entries++;
+        }
+
+        if (isDirectory)
+            return;
+
+        var provider = new Provider(state, path);
+        node.Providers ??= new List<Provider>(1);
+        var index = node.Providers.FindIndex(p => Outranks(state, p.Layer));
+        node.Providers.Insert(index < 0 ? node.Providers.Count : index, provider);
+    }
+
+    private void RemoveEntry(LayerState state, string path, bool isDirectory)
+    {
+        var node = Find(path);
+        if (node == null)
+            return;
+
+        if (!isDirectory)
+            node.Providers?.RemoveAll(p => ReferenceEquals(p.Layer, state));
+
+        // Walk back up, dropping nodes nothing provides any more
+        for (var current = node; current != null; current = current.Parent)
+        {
+            current.Entries--;
+            if (current.Entries == 0 && current.Parent != null)
+                current.Parent.Children!.Remove(current.Name);
+        }
+    }
+
+    private Node? Find(string path)
+    {
+        var node = _root;
+        foreach (var segment in path.Split('/', '\\'))
+        {
+            if (segment.Length == 0 || segment == ".")
+                continue;
+
+            if (node.Children == null || !node.Children.TryGetValue(segment, out var child))
+                return null;
+            node = child;
+        }
+
+        return node;
+    }
+
+    private static string MergedPath(Node node)
+    {
+        var segments = new Stack<string>();
+        for (var current = node; current.Parent != null; current = current.Parent)
+            segments.Push(current.Name);
+
+        return string.Join('/', segments);
+    }
+
+    private static string PhysicalPath(Provider provider) =>
+        Path.Combine(provider.Layer.Layer.RootDirectory, provider.RelativePath.Replace('/', Path.DirectorySeparatorChar));
+
+    private static bool Outranks(LayerState layer, LayerState other) =>
+        layer.Layer.Priority > other.Layer.Priority ||
+        (layer.Layer.Priority == other.Layer.Priority && layer.Sequence > other.Sequence);
+
+    private sealed class LayerState(VfsLayer layer, long sequence)
+    {
+        public VfsLayer Layer { get; } = layer;
+        public long Sequence { get; } = sequence;
+        public HashSet<string> Files { get; } = new(StringComparer.OrdinalIgnoreCase);
+        public HashSet<string> Directories { get; } = new(StringComparer.OrdinalIgnoreCase);
+    }
+
+    private readonly record struct Provider(LayerState Layer, string RelativePath);
+
+    private sealed class Node(string name, Node? parent)
+    {
+        public string Name { get; } = name;
+        public Node? Parent { get; } = parent;
+        public Dictionary<string, Node>? Children { get; set; }
+
+        /// <summary>
+        /// Layers providing a file at this path, winner first.
+        /// </summary>
+        public List<Provider>? Providers { get; set; }
+
+        /// <summary>
+        /// Files and explicit directories at or below this node.
+        /// </summary>
+        public int Entries { get; set; }
+    }
+}
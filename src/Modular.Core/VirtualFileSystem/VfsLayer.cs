@@ -0,0 +1,67 @@
+namespace Modular.Core.VirtualFileSystem;
+
+/// <summary>
+/// One layer of a merged game directory: the base game or a mod, with the
+/// directory its files live in and the game-relative paths it provides.
+/// </summary>
+public sealed class VfsLayer
+{
+    public VfsLayer(string id, string rootDirectory, int priority, IEnumerable<string> files)
+    {
+        if (string.IsNullOrWhiteSpace(id))
+            throw new ArgumentException("Layer ID is required", nameof(id));
+
+        Id = id;
+        RootDirectory = rootDirectory;
+        Priority = priority;
+        Files = files.Select(LayeredVfsResolver.NormalizePath).Where(p => p.Length > 0).ToList();
+    }
+
+    /// <summary>
+    /// Unique layer ID, e.g. "base" or a mod ID.
+    /// </summary>
+    public string Id { get; }
+
+    /// <summary>
+    /// Directory holding the layer's files.
+    /// </summary>
+    public string RootDirectory { get; }
+
+    /// <summary>
+    /// Higher priority wins. The base game should have the lowest; among
+    /// equal priorities the layer added last wins.
+    /// </summary>
+    public int Priority { get; }
+
+    /// <summary>
+    /// Game-relative file paths, '/'-separated, in the layer's own casing.
+    /// </summary>
+    public IReadOnlyList<string> Files { get; }
+
+    /// <summary>
+    /// Indexes a directory once and makes it a layer.
+    /// </summary>
+    public static VfsLayer FromDirectory(string id, string rootDirectory, int priority)
+    {
+        var files = Directory.Exists(rootDirectory)
+            ? Directory.EnumerateFiles(rootDirectory, "*", SearchOption.AllDirectories)
+                .Select(f => Path.GetRelativePath(rootDirectory, f))
+            : [];
+
+        return new VfsLayer(id, rootDirectory, priority, files);
+    }
+}
+
+/// <summary>
+/// What a game-relative path resolves to in the merged view.
+/// </summary>
+/// <param name="Path">The path in merged casing.</param>
+/// <param name="IsDirectory">Whether the path is a directory.</param>
+/// <param name="LayerId">Winning layer of a file; null for directories.</param>
+/// <param name="PhysicalPath">Where the winning file is on disk; null for directories.</param>
+public sealed record VfsEntry(string Path, bool IsDirectory, string? LayerId, string? PhysicalPath);
+
+/// <summary>
+/// A child of a merged directory.
+/// </summary>
+public sealed record VfsDirectoryEntry(string Name, bool IsDirectory);
@@ -0,0 +1,229 @@
+namespace Modular.Core.VirtualFileSystem;
+
+/// <summary>
+/// Writable top layer of a merged view. Lower layers (the game and mods) are
+/// never modified: a file opened for writing is first copied up into the
+/// overlay directory, and new files and directories are created there.
+/// Only overlay entries can be deleted or renamed; with no whiteouts, a
+/// lower-layer file shows through again once its overlay copy is deleted.
+/// </summary>
+public class VfsOverlay
+{
+    /// <summary>
+    /// Layer ID of the overlay in the resolver.
+    /// </summary>
+    public const string LayerId = "overlay";
+
+    private readonly LayeredVfsResolver _resolver;
+    private readonly object _lock = new();
+
+    /// <summary>
+    /// Adds <paramref name="overlayDirectory"/> to the resolver as the top
+    /// layer, including files left there by earlier sessions.
+    /// </summary>
+    public VfsOverlay(LayeredVfsResolver resolver, string overlayDirectory)
+    {
+        _resolver = resolver;
+        OverlayDirectory = overlayDirectory;
+        Directory.CreateDirectory(overlayDirectory);
+
+        resolver.AddLayer(VfsLayer.FromDirectory(LayerId, overlayDirectory, int.MaxValue));
+        foreach (var directory in Directory.EnumerateDirectories(overlayDirectory, "*", SearchOption.AllDirectories))
+            resolver.AddDirectory(LayerId, Path.GetRelativePath(overlayDirectory, directory));
+    }
+
+    /// <summary>
+    /// Directory holding the overlay's files.
+    /// </summary>
+    public string OverlayDirectory { get; }
+
+    public LayeredVfsResolver Resolver => _resolver;
+
+    /// <summary>
+    /// Makes a file writable, copying it up from its layer if needed.
+    /// Returns its path in the overlay.
+    /// </summary>
+    public string PrepareWrite(string path)
+    {
+        lock (_lock)
+        {
+            var entry = _resolver.Resolve(path) ?? throw NotFound(path);
+            if (entry.IsDirectory)
+                throw new VfsOverlayException(VfsOverlayError.IsDirectory, $"Is a directory: {path}");
+            if (entry.LayerId == LayerId)
+                return entry.PhysicalPath!;
+
+            var target = OverlayPath(entry.Path);
+            Directory.CreateDirectory(Path.GetDirectoryName(target)!);
+            File.Copy(entry.PhysicalPath!, target, overwrite: true);
+            _resolver.AddFile(LayerId, entry.Path);
+            return target;
+        }
+    }
+
+    /// <summary>
+    /// Creates (or truncates) a file in the overlay. Returns its path.
+    /// </summary>
+    public string CreateFile(string path)
+    {
+        lock (_lock)
+        {
+            var merged = MergedPathForNew(path);
+            var existing = _resolver.Resolve(merged);
+            if (existing is { IsDirectory: true })
+                throw new VfsOverlayException(VfsOverlayError.IsDirectory, $"Is a directory: {path}");
+
+            var target = OverlayPath(merged);
+            Directory.CreateDirectory(Path.GetDirectoryName(target)!);
+            File.Create(target).Dispose();
+            _resolver.AddFile(LayerId, merged);
+            return target;
+        }
+    }
+
+    /// <summary>
+    /// Sets the length of a file, copying it up first.
+    /// </summary>
+    public void Truncate(string path, long length)
+    {
+        lock (_lock)
+        {
+            using var stream = new FileStream(PrepareWrite(path), FileMode.Open, FileAccess.Write, FileShare.ReadWrite);
+            stream.SetLength(length);
+        }
+    }
+
+    /// <summary>
+    /// Deletes a file the overlay provides.
+    /// </summary>
+    public void DeleteFile(string path)
+    {
+        lock (_lock)
+        {
+            var entry = _resolver.Resolve(path) ?? throw NotFound(path);
+            if (entry.IsDirectory)
+                throw new VfsOverlayException(VfsOverlayError.IsDirectory, $"Is a directory: {path}");
+            if (entry.LayerId != LayerId)
+                throw ReadOnly(path);
+
+            File.Delete(entry.PhysicalPath!);
+            _resolver.RemoveFile(LayerId, entry.Path);
+        }
+    }
+
+    /// <summary>
+    /// Renames a file the overlay provides, replacing any file at the target.
+    /// </summary>
+    public void RenameFile(string from, string to)
+    {
+        lock (_lock)
+        {
+            var entry = _resolver.Resolve(from) ?? throw NotFound(from);
+            if (entry.IsDirectory || entry.LayerId != LayerId)
+                throw ReadOnly(from);
+
+            var merged = MergedPathForNew(to);
+            if (_resolver.Resolve(merged) is { IsDirectory: true })
+                throw new VfsOverlayException(VfsOverlayError.IsDirectory, $"Is a directory: {to}");
+
+            var target = OverlayPath(merged);
+            Directory.CreateDirectory(Path.GetDirectoryName(target)!);
+            File.Move(entry.PhysicalPath!, target, overwrite: true);
+            _resolver.RemoveFile(LayerId, entry.Path);
+            _resolver.AddFile(LayerId, merged);
+        }
+    }
+
+    /// <summary>
+    /// Creates a directory in the overlay.
+    /// </summary>
+    public void CreateDirectory(string path)
+    {
+        lock (_lock)
+        {
+            var merged = MergedPathForNew(path);
+            if (_resolver.Resolve(merged) != null)
+                throw new VfsOverlayException(VfsOverlayError.Exists, $"Already exists: {path}");
+
+            Directory.CreateDirectory(OverlayPath(merged));
+            _resolver.AddDirectory(LayerId, merged);
+        }
+    }
+
+    /// <summary>
+    /// Deletes an empty directory that only the overlay provides.
+    /// </summary>
+    public void DeleteDirectory(string path)
+    {
+        lock (_lock)
+        {
+            var entry = _resolver.Resolve(path) ?? throw NotFound(path);
+            if (!entry.IsDirectory)
+                throw new VfsOverlayException(VfsOverlayError.NotDirectory, $"Not a directory: {path}");
+            if (_resolver.ListDirectory(entry.Path) is { Count: > 0 })
+                throw new VfsOverlayException(VfsOverlayError.NotEmpty, $"Directory not empty: {path}");
+            if (!_resolver.RemoveDirectory(LayerId, entry.Path))
+                throw ReadOnly(path);
+
+            var physical = OverlayPath(entry.Path);
+            if (Directory.Exists(physical))
+                Directory.Delete(physical);
+        }
+    }
+
+    /// <summary>
+    /// Path for a new entry: the parent's merged casing plus the new name,
+    /// so new files land beside their siblings whatever case was asked for.
+    /// </summary>
+    private string MergedPathForNew(string path)
+    {
+        var normalized = LayeredVfsResolver.NormalizePath(path);
+        if (normalized.Length == 0)
+            throw ReadOnly(path);
+
+        var slash = normalized.LastIndexOf('/');
+        if (slash < 0)
+            return normalized;
+
+        var parent = _resolver.Resolve(normalized[..slash]) ?? throw NotFound(normalized[..slash]);
+        if (!parent.IsDirectory)
+            throw new VfsOverlayException(VfsOverlayError.NotDirectory, $"Not a directory: {normalized[..slash]}");
+
+        return parent.Path + normalized[slash..];
+    }
+
+    private string OverlayPath(string mergedPath) =>
+        Path.Combine(OverlayDirectory, mergedPath.Replace('/', Path.DirectorySeparatorChar));
+
+    private static VfsOverlayException NotFound(string path) =>
+        new(VfsOverlayError.NotFound, $"No such file or directory: {path}");
+
+    private static VfsOverlayException ReadOnly(string path) =>
+        new(VfsOverlayError.ReadOnly, $"Provided by a read-only layer: {path}");
+}
+
+/// <summary>
+/// Why an overlay operation was refused.
+/// </summary>
+public enum VfsOverlayError
+{
+    NotFound,
+    ReadOnly,
+    Exists,
+    NotEmpty,
+    IsDirectory,
+    NotDirectory
+}
+
+/// <summary>
+/// An overlay operation the merged view does not allow.
+/// </summary>
+public class VfsOverlayException : IOException
+{
+    public VfsOverlayException(VfsOverlayError error, string message) : base(message)
+    {
+        Error = error;
+    }
+
+    public VfsOverlayError Error { get; }
+}
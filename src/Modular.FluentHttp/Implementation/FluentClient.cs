@@ -33,6 +33,7 @@ public class FluentClient : IFluentClient
     public RequestOptions Options { get; private set; } = new();
     public FilterCollection Filters { get; } = new();
     public IRateLimiter? RateLimiter { get; private set; }
+    public IRequestPolicy? RequestPolicy { get; private set; }
 
     public IRequest GetAsync(string resource) => new FluentRequest(this, HttpMethod.Get, resource);
     public IRequest PostAsync(string resource) => new FluentRequest(this, HttpMethod.Post, resource);
@@ -79,6 +80,7 @@ public class FluentClient : IFluentClient
         return this;
     }
     public IFluentClient DisableRetries() { _retryConfig = new DefaultRetryConfig { MaxRetries = 0 }; return this; }
+    public IFluentClient SetRequestPolicy(IRequestPolicy? policy) { RequestPolicy = policy; return this; }
 
     public IFluentClient SetRateLimiter(IRateLimiter? rateLimiter) { RateLimiter = rateLimiter; return this; }
     /// <summary>
@@ -94,64 +96,37 @@ public class FluentClient : IFluentClient
     {
         var config = retryConfig ?? _retryConfig;
         var maxRetries = options.NoRetry ? 0 : config.MaxRetries;
+
+        Task<IResponse> Attempt(CancellationToken token) =>
+            SendOnceAsync(request, url, method, headers, body, options, authScheme, authParameter, requestFilters, token);
+
+        if (RequestPolicy != null)
+        {
+            // Every attempt reserves rate-limit quota, so a hedge would spend two units on one slow request
+            var hedgeable = !options.NoHedge && RateLimiter == null && (method == HttpMethod.Get || method == HttpMethod.Head);
+            var context = new RequestPolicyContext(method, url, maxRetries, hedgeable, config);
+            return await RequestPolicy.ExecuteAsync(context, Attempt, ct);
+        }
+
         Exception? lastException = null;
 
         for (var attempt = 0; attempt <= maxRetries; attempt++)
         {
             try
             {
-                // Wait for rate limiter and reserve a slot
-                if (RateLimiter != null)
-                {
-                    await RateLimiter.WaitIfNeededAsync(ct);
-                    RateLimiter.ReserveRequest();
-                }
-
-                using var httpRequest = new HttpRequestMessage(method, url);
-
-                // Apply body
-                if (body?.Content != null)
-                    httpRequest.Content = body.Content;
-
-                // Apply headers
-                foreach (var (key, value) in headers)
-                    httpRequest.Headers.TryAddWithoutValidation(key, value);
-
-                // Apply authentication
-                var scheme = authScheme ?? _authScheme;
-                var param = authParameter ?? _authParameter;
-                if (!string.IsNullOrEmpty(scheme) && !string.IsNullOrEmpty(param))
-                    httpRequest.Headers.Authorization = new System.Net.Http.Headers.AuthenticationHeaderValue(scheme, param);
-
-                // Apply filters
-                var allFilters = Filters.GetOrdered().Concat(requestFilters).ToList();
-                foreach (var filter in allFilters)
-                    filter.OnRequest(request);
-
-                var stopwatch = Stopwatch.StartNew();
-                var response = await _httpClient.SendAsync(httpRequest, ct);
-                stopwatch.Stop();
-
-                // Update rate limiter
-                RateLimiter?.UpdateFromHeaders(response.Headers);
-
-                var fluentResponse = new FluentResponse(response, url, stopwatch.Elapsed);
-
-                // Apply response filters
-                foreach (var filter in allFilters)
-                    filter.OnResponse(fluentResponse, !options.IgnoreHttpErrors);
+                var response = await Attempt(ct);
 
                 // Check for retry
-                if (!response.IsSuccessStatusCode && config.ShouldRetry((int)response.StatusCode, false) && attempt < maxRetries)
+                if (!response.IsSuccessStatusCode && config.ShouldRetry(response.StatusCode, false) && attempt < maxRetries)
                 {
                     var delay = config.GetDelay(attempt);
                     _logger?.LogWarning("Request to {Url} failed with {StatusCode}, retrying in {Delay}ms",
-                        url, (int)response.StatusCode, delay.TotalMilliseconds);
+                        url, response.StatusCode, delay.TotalMilliseconds);
                     await Task.Delay(delay, ct);
                     continue;
                 }
 
-                return fluentResponse;
+                return response;
             }
             catch (HttpRequestException ex)
             {
@@ -178,6 +153,57 @@ public class FluentClient : IFluentClient
         throw new HttpRequestException($"Request to {url} failed after {maxRetries} retries", lastException);
     }
 
+    /// <summary>
+    /// Sends the request once: rate limiting, headers, auth and filters included.
+    /// </summary>
+    private async Task<IResponse> SendOnceAsync(FluentRequest request, string url, HttpMethod method,
+        Dictionary<string, string> headers, RequestBody? body, RequestOptions options,
+        string? authScheme, string? authParameter, List<IHttpFilter> requestFilters, CancellationToken ct)
+    {
+        // Wait for rate limiter and reserve a slot
+        if (RateLimiter != null)
+        {
+            await RateLimiter.WaitIfNeededAsync(ct);
+            RateLimiter.ReserveRequest();
+        }
+
+        using var httpRequest = new HttpRequestMessage(method, url);
+
+        // Apply body
+        if (body?.Content != null)
+            httpRequest.Content = body.Content;
+
+        // Apply headers
+        foreach (var (key, value) in headers)
+            httpRequest.Headers.TryAddWithoutValidation(key, value);
+
+        // Apply authentication
+        var scheme = authScheme ?? _authScheme;
+        var param = authParameter ?? _authParameter;
+        if (!string.IsNullOrEmpty(scheme) && !string.IsNullOrEmpty(param))
+            httpRequest.Headers.Authorization = new System.Net.Http.Headers.AuthenticationHeaderValue(scheme, param);
+
+        // Apply filters
+        var allFilters = Filters.GetOrdered().Concat(requestFilters).ToList();
+        foreach (var filter in allFilters)
+            filter.OnRequest(request);
+
+        var stopwatch = Stopwatch.StartNew();
+        var response = await _httpClient.SendAsync(httpRequest, ct);
+        stopwatch.Stop();
+
+        // Update rate limiter
+        RateLimiter?.UpdateFromHeaders(response.Headers);
+
+        var fluentResponse = new FluentResponse(response, url, stopwatch.Elapsed);
+
+        // Apply response filters
+        foreach (var filter in allFilters)
+            filter.OnResponse(fluentResponse, !options.IgnoreHttpErrors);
+
+        return fluentResponse;
+    }
+
     public void Dispose()
     {
         if (!_disposed)
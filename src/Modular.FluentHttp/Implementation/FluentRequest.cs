@@ -102,6 +102,8 @@ public class FluentRequest : IRequest
 
     public async Task DownloadToAsync(string path, IProgress<(long downloaded, long total)>? progress = null, CancellationToken ct = default)
     {
+        // The body is buffered before the policy sees the response, so a hedge would download it twice
+        _options.NoHedge = true;
         var response = await AsResponseAsync();
         if (!response.IsSuccessStatusCode)
         {
@@ -20,6 +20,11 @@ public class RequestOptions
     /// </summary>
     public bool NoRetry { get; set; }
 
+    /// <summary>
+    /// Whether a request policy may race a duplicate of this request against a slow attempt.
+    /// </summary>
+    public bool NoHedge { get; set; }
+
     /// <summary>
     /// Creates a copy of these options.
     /// </summary>
@@ -27,7 +32,8 @@ public class RequestOptions
     {
         IgnoreHttpErrors = IgnoreHttpErrors,
         Timeout = Timeout,
-        NoRetry = NoRetry
+        NoRetry = NoRetry,
+        NoHedge = NoHedge
     };
 }
 
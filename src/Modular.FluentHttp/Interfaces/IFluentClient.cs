@@ -38,6 +38,13 @@ public interface IFluentClient : IDisposable
     IFluentClient SetRetryPolicy(int maxRetries, int initialDelayMs = 1000, int maxDelayMs = 16000, bool exponentialBackoff = true);
     IFluentClient DisableRetries();
 
+    /// <summary>
+    /// Hands the attempt loop of every request to <paramref name="policy"/>, or
+    /// back to the built-in retry loop when null.
+    /// </summary>
+    IFluentClient SetRequestPolicy(IRequestPolicy? policy);
+    IRequestPolicy? RequestPolicy { get; }
+
     // Rate limiting
     IFluentClient SetRateLimiter(IRateLimiter? rateLimiter);
     IRateLimiter? RateLimiter { get; }
@@ -0,0 +1,55 @@
+namespace Modular.FluentHttp.Interfaces;
+
+/// <summary>
+/// Takes over the attempt loop of a request. When a client has a request
+/// policy, the policy decides whether and when to retry, hedge or reject an
+/// attempt instead of the client's built-in <see cref="IRetryConfig"/> loop.
+/// </summary>
+public interface IRequestPolicy
+{
+    /// <summary>
+    /// Executes a request.
+    /// </summary>
+    /// <param name="context">What is being requested and how much retrying it allows.</param>
+    /// <param name="attempt">Sends the request once. May be called several times, also concurrently when hedging.</param>
+    /// <param name="ct">Cancellation token.</param>
+    Task<IResponse> ExecuteAsync(
+        RequestPolicyContext context,
+        Func<CancellationToken, Task<IResponse>> attempt,
+        CancellationToken ct);
+}
+
+/// <summary>
+/// Describes a request handed to an <see cref="IRequestPolicy"/>.
+/// </summary>
+public sealed class RequestPolicyContext
+{
+    public RequestPolicyContext(HttpMethod method, string url, int maxRetries, bool hedgeable, IRetryConfig retryConfig)
+    {
+        Method = method;
+        Url = url;
+        MaxRetries = maxRetries;
+        Hedgeable = hedgeable;
+        RetryConfig = retryConfig;
+    }
+
+    public HttpMethod Method { get; }
+    public string Url { get; }
+
+    /// <summary>
+    /// Retries the request allows; 0 when retries are disabled for it.
+    /// </summary>
+    public int MaxRetries { get; }
+
+    /// <summary>
+    /// Whether a duplicate attempt may be raced against a slow one.
+    /// Only true for idempotent requests that did not opt out, sent by a
+    /// client without a rate limiter.
+    /// </summary>
+    public bool Hedgeable { get; }
+
+    /// <summary>
+    /// The retry configuration in effect, for its status-code classification.
+    /// </summary>
+    public IRetryConfig RetryConfig { get; }
+}
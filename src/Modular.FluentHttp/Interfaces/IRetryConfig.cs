@@ -31,6 +31,12 @@ public class DefaultRetryConfig : IRetryConfig
     public int MaxDelayMs { get; set; } = 16000;
     public bool ExponentialBackoff { get; set; } = true;
 
+    /// <summary>
+    /// Randomizes each delay between half and all of its backoff value, so
+    /// clients that failed together don't retry in lockstep.
+    /// </summary>
+    public bool Jitter { get; set; } = true;
+
     public bool ShouldRetry(int statusCode, bool isTimeout)
     {
         return isTimeout || statusCode >= 500 || statusCode == 429;
@@ -38,10 +44,13 @@ public class DefaultRetryConfig : IRetryConfig
 
     public TimeSpan GetDelay(int attempt)
     {
-        if (!ExponentialBackoff)
-            return TimeSpan.FromMilliseconds(InitialDelayMs);
+        double delay = InitialDelayMs;
+        if (ExponentialBackoff)
+            delay = Math.Min(InitialDelayMs * Math.Pow(2, attempt), MaxDelayMs);
+
+        if (Jitter)
+            delay = delay / 2 + Random.Shared.NextDouble() * delay / 2;
 
-        var delay = InitialDelayMs * (int)Math.Pow(2, attempt);
-        return TimeSpan.FromMilliseconds(Math.Min(delay, MaxDelayMs));
+        return TimeSpan.FromMilliseconds(delay);
     }
 }
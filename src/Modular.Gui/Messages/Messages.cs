@@ -1,4 +1,5 @@
 using CommunityToolkit.Mvvm.Messaging.Messages;
+using Modular.Core.Updates;
 
 namespace Modular.Gui.Messages;
 
@@ -26,3 +27,12 @@ public class SettingsChangedInfo
 public class DownloadBatchCompletedMessage
 {
 }
+
+/// <summary>
+/// Message sent when a background update check finds mods with newer files
+/// upstream. Carries only the mods that were not already known to be outdated.
+/// </summary>
+public class ModUpdatesAvailableMessage : ValueChangedMessage<IReadOnlyList<OutdatedMod>>
+{
+    public ModUpdatesAvailableMessage(IReadOnlyList<OutdatedMod> value) : base(value) { }
+}
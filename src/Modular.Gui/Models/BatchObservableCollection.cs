@@ -0,0 +1,59 @@
+using System.Collections.ObjectModel;
+using System.Collections.Specialized;
+using System.ComponentModel;
+
+namespace Modular.Gui.Models;
+
+/// <summary>
+/// An <see cref="ObservableCollection{T}"/> that can apply many changes with a
+/// single Reset notification, so a bound list lays out once per batch instead
+/// of once per item.
+/// </summary>
+public class BatchObservableCollection<T> : ObservableCollection<T>
+{
+    public BatchObservableCollection()
+    {
+    }
+
+    public BatchObservableCollection(IEnumerable<T> items) : base(items)
+    {
+    }
+
+    /// <summary>
+    /// Replaces the contents with <paramref name="items"/>.
+    /// </summary>
+    public void ReplaceAll(IEnumerable<T> items)
+    {
+        CheckReentrancy();
+        Items.Clear();
+        foreach (var item in items)
+            Items.Add(item);
+        RaiseReset();
+    }
+
+    /// <summary>
+    /// Removes every item matching <paramref name="predicate"/>.
+    /// </summary>
+    /// <returns>Number of items removed.</returns>
+    public int RemoveAll(Func<T, bool> predicate)
+    {
+        CheckReentrancy();
+        var kept = Items.Where(item => !predicate(item)).ToList();
+        var removed = Items.Count - kept.Count;
+        if (removed == 0)
+            return 0;
+
+        Items.Clear();
+        foreach (var item in kept)
+            Items.Add(item);
+        RaiseReset();
+        return removed;
+    }
+
+    private void RaiseReset()
+    {
+        OnPropertyChanged(new PropertyChangedEventArgs(nameof(Count)));
+        OnPropertyChanged(new PropertyChangedEventArgs("Item[]"));
+        OnCollectionChanged(new NotifyCollectionChangedEventArgs(NotifyCollectionChangedAction.Reset));
+    }
+}
@@ -1,13 +1,16 @@
 using Avalonia;
 using Avalonia.Dialogs;
+using CommunityToolkit.Mvvm.Messaging;
 using Microsoft.Extensions.DependencyInjection;
 using Microsoft.Extensions.Logging;
+using Modular.Core.Archives;
 using Modular.Core.Backends;
 using Modular.Core.Backends.GameBanana;
 using Modular.Core.Backends.NexusMods;
 using Modular.Core.Collections;
 using Modular.Core.Configuration;
 using Modular.Core.Database;
+using Modular.Core.Downloads;
 using Modular.Core.Authentication;
 using Modular.Core.Diagnostics;
 using Modular.Core.GameDetection;
@@ -18,6 +21,8 @@ using Modular.Core.RateLimiting;
 using Modular.Core.Snapshots;
 using Modular.Core.Services;
 using Modular.Core.Telemetry;
+using Modular.Core.Updates;
+using Modular.Gui.Messages;
 using Modular.Gui.Services;
 using Modular.Gui.ViewModels;
 using Modular.Switch.Installer;
@@ -31,6 +36,8 @@ sealed class Program
 
     // Cached instances loaded during async initialization
     private static AppSettings? _settings;
+    private static ConfigurationStore? _configStore;
+    private static CredentialService? _credentials;
     private static DownloadDatabase? _database;
     private static ModMetadataCache? _metadataCache;
     private static DownloadHistoryService? _downloadHistory;
@@ -56,6 +63,9 @@ sealed class Program
 
             // Build DI container with pre-loaded instances
             Services = ConfigureServices();
+            ModInstallationService.RecoverInterruptedCommits(Services.GetService<ILogger<StagingManager>>());
+            WatchConfiguration(Services);
+            StartUpdateChecks(Services);
 
             BuildAvaloniaApp().StartWithClassicDesktopLifetime(args);
         }
@@ -77,8 +87,10 @@ sealed class Program
     private static async Task InitializeServicesAsync()
     {
         // Load configuration
-        var configService = new ConfigurationService();
-        _settings = await configService.LoadAsync();
+        _credentials = CredentialService.CreateDefault();
+        var configService = new ConfigurationService(_credentials);
+        _configStore = new ConfigurationStore(configService);
+        _settings = await _configStore.LoadAsync();
 
         // Load database
         _database = new DownloadDatabase(_settings.DatabasePath);
@@ -99,6 +111,44 @@ sealed class Program
         await _downloadHistory.LoadAsync();
     }
 
+    /// <summary>
+    /// Applies config changes, whether saved from the settings view or made to
+    /// config.json directly, to the running services.
+    /// </summary>
+    private static void WatchConfiguration(IServiceProvider services)
+    {
+        var store = services.GetRequiredService<ConfigurationStore>();
+        var rateLimiter = services.GetRequiredService<IRateLimiter>();
+        var bandwidth = services.GetRequiredService<BandwidthGovernor>();
+
+        store.Changed += (_, e) =>
+        {
+            // Rate limits are per account; the old key's counters don't apply to a new one
+            if (e.HasChanged("nexus_api_key"))
+                rateLimiter.Reset();
+
+            // Running transfers here and in other Modular processes pick up the new limit
+            if (e.ChangedKeys.Any(k => k.StartsWith("bandwidth_", StringComparison.Ordinal)))
+                bandwidth.ApplySettings();
+
+            WeakReferenceMessenger.Default.Send(new SettingsChangedMessage(
+                new SettingsChangedInfo { SettingName = string.Join(",", e.ChangedKeys) }));
+        };
+        store.StartWatching();
+    }
+
+    /// <summary>
+    /// Polls the backends' change feeds in the background and notifies the UI
+    /// about newly outdated mods.
+    /// </summary>
+    private static void StartUpdateChecks(IServiceProvider services)
+    {
+        var checker = services.GetRequiredService<UpdateCheckService>();
+        checker.UpdatesFound += (_, mods) =>
+            WeakReferenceMessenger.Default.Send(new ModUpdatesAvailableMessage(mods));
+        checker.Start();
+    }
+
     public static AppBuilder BuildAvaloniaApp()
     {
         var builder = AppBuilder.Configure<App>()
@@ -134,11 +184,16 @@ sealed class Program
         });
 
         // Core services - use pre-loaded instances to avoid async-over-sync
+        services.AddSingleton(_credentials!);
         services.AddSingleton<ConfigurationService>();
+        services.AddSingleton(_configStore!);
         services.AddSingleton(_settings!);
         services.AddSingleton(_database!);
         services.AddSingleton(_metadataCache!);
         services.AddSingleton<IRateLimiter, NexusRateLimiter>();
+        services.AddSingleton(sp => new BandwidthGovernor(
+            sp.GetRequiredService<AppSettings>(),
+            logger: sp.GetService<ILogger<BandwidthGovernor>>()));
 
         // Backend services
         services.AddSingleton(sp =>
@@ -148,7 +203,11 @@ sealed class Program
             var database = sp.GetRequiredService<DownloadDatabase>();
             var metadataCache = sp.GetRequiredService<ModMetadataCache>();
             var logger = sp.GetService<ILogger<NexusModsBackend>>();
-            return new NexusModsBackend(settings, rateLimiter, database, metadataCache, logger);
+            var mirrors = new MirrorSelector(
+                new MirrorModel(MirrorModel.DefaultPath, logger: logger),
+                logger: logger,
+                governor: sp.GetRequiredService<BandwidthGovernor>());
+            return new NexusModsBackend(settings, rateLimiter, database, metadataCache, logger, mirrors);
         });
         services.AddSingleton(sp =>
         {
@@ -179,7 +238,9 @@ sealed class Program
         services.AddSingleton(sp =>
         {
             var logger = sp.GetService<ILogger<PluginLoader>>();
-            return new PluginLoader(logger: logger);
+            var loader = new PluginLoader(logger: logger);
+            loader.WatchForUpdates();
+            return loader;
         });
         services.AddSingleton(sp =>
         {
@@ -210,12 +271,32 @@ sealed class Program
             db.InitializeAsync().GetAwaiter().GetResult();
             return db;
         });
+        // Update checks. The poll runs on a timer thread, so the index gets a
+        // connection of its own instead of sharing the UI's.
+        services.AddSingleton(sp =>
+            new ModUpdateIndex(new ModularDatabase(sp.GetRequiredService<ModularDatabase>().DatabasePath)));
+        services.AddSingleton(sp =>
+        {
+            var feeds = new List<IUpdateFeed>
+            {
+                new NexusUpdateFeed(
+                    sp.GetRequiredService<NexusModsBackend>(),
+                    sp.GetRequiredService<DownloadDatabase>(),
+                    sp.GetRequiredService<ModMetadataCache>()),
+                new GameBananaUpdateFeed(sp.GetRequiredService<GameBananaBackend>())
+            };
+            var logger = sp.GetService<ILogger<UpdateCheckService>>();
+            return new UpdateCheckService(sp.GetRequiredService<ModUpdateIndex>(), feeds, logger);
+        });
         services.AddSingleton(sp =>
         {
             var db = sp.GetRequiredService<ModularDatabase>();
             var changesetManager = new ChangesetManager(db);
             var logger = sp.GetService<ILogger<SnapshotManager>>();
-            return new SnapshotManager(db, changesetManager, logger);
+            var stateStore = new DirectoryStateStore(
+                DirectoryStateStore.DefaultPath,
+                logger: sp.GetService<ILogger<DirectoryStateStore>>());
+            return new SnapshotManager(db, changesetManager, logger, stateStore);
         });
         services.AddSingleton(sp =>
         {
@@ -225,6 +306,21 @@ sealed class Program
             var logger = sp.GetService<ILogger<ModInstallationService>>();
             return new ModInstallationService(db, telemetry, snapshotManager, logger);
         });
+        services.AddSingleton(sp =>
+        {
+            var logger = sp.GetService<ILogger<InstallScheduler>>();
+            return new InstallScheduler(logger: logger);
+        });
+        services.AddSingleton(sp =>
+        {
+            var installers = new InstallerManager(
+                logger: sp.GetService<ILogger<InstallerManager>>(),
+                telemetry: sp.GetService<TelemetryService>());
+            var logger = sp.GetService<ILogger<DownloadLibraryIndex>>();
+            // Scans run on the thread pool, so the index gets its own connection
+            var db = new ModularDatabase(sp.GetRequiredService<ModularDatabase>().DatabasePath);
+            return new DownloadLibraryIndex(db, installers, logger: logger);
+        });
 
         // Profiles
         services.AddSingleton(sp =>
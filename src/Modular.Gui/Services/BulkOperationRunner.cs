@@ -0,0 +1,180 @@
+using System.Collections.Concurrent;
+using Avalonia.Threading;
+using Modular.Core.Installers;
+using Modular.Gui.ViewModels;
+
+namespace Modular.Gui.Services;
+
+/// <summary>
+/// Runs an operation over many items from the GUI. Items are submitted to the
+/// <see cref="InstallScheduler"/> together, which runs them in parallel across
+/// devices and one after another within a target directory. Results are
+/// collected off the UI thread and applied once per frame: one progress update
+/// and one batch of collection changes, however many items finished.
+/// </summary>
+public sealed class BulkOperationRunner
+{
+    /// <summary>
+    /// How often finished items are applied to the UI; about one frame.
+    /// </summary>
+    public static readonly TimeSpan DefaultFlushInterval = TimeSpan.FromMilliseconds(16);
+
+    private readonly InstallScheduler _scheduler;
+    private readonly TimeSpan _flushInterval;
+
+    public BulkOperationRunner(InstallScheduler scheduler, TimeSpan? flushInterval = null)
+    {
+        _scheduler = scheduler;
+        _flushInterval = flushInterval ?? DefaultFlushInterval;
+    }
+
+    /// <summary>
+    /// Runs <paramref name="work"/> for every item. Must be called on the UI thread.
+    /// </summary>
+    /// <param name="progress">Progress model to drive; its cancel command stops the remaining items.</param>
+    /// <param name="title">Operation name, e.g. "Uninstalling".</param>
+    /// <param name="items">Items to process.</param>
+    /// <param name="name">Display name of an item, used in the summary.</param>
+    /// <param name="targetDirectory">Directory an item writes to; items without one fail without running.</param>
+    /// <param name="work">Processes one item. Returns null on success or an error message.</param>
+    /// <param name="applySucceeded">Applies a batch of succeeded items to the UI, on the UI thread.</param>
+    public async Task<BulkOperationSummary> RunAsync<TItem>(
+        BulkOperationProgress progress,
+        string title,
+        IReadOnlyList<TItem> items,
+        Func<TItem, string> name,
+        Func<TItem, string?> targetDirectory,
+        Func<TItem, CancellationToken, Task<string?>> work,
+        Action<IReadOnlyList<TItem>> applySucceeded)
+    {
+        var ct = progress.Begin(title, items.Count);
+        var finished = new ConcurrentQueue<(TItem Item, string Name, BulkItemOutcome Outcome, string? Error)>();
+        var summary = new BulkOperationSummary(title, items.Count);
+        var pending = new List<Task>(items.Count);
+
+        foreach (var item in items)
+        {
+            var itemName = name(item);
+            var target = targetDirectory(item);
+            if (string.IsNullOrEmpty(target))
+            {
+                finished.Enqueue((item, itemName, BulkItemOutcome.Failed, "No target directory recorded"));
+                continue;
+            }
+
+            var operation = _scheduler.Schedule(itemName, target, (_, token) => work(item, token), ct: ct);
+            pending.Add(operation.Result.ContinueWith(t =>
+            {
+                if (t.IsCanceled)
+                    finished.Enqueue((item, itemName, BulkItemOutcome.Cancelled, null));
+                else if (t.IsFaulted)
+                    finished.Enqueue((item, itemName, BulkItemOutcome.Failed, t.Exception!.GetBaseException().Message));
+                else if (t.Result != null)
+                    finished.Enqueue((item, itemName, BulkItemOutcome.Failed, t.Result));
+                else
+                    finished.Enqueue((item, itemName, BulkItemOutcome.Succeeded, null));
+            }, TaskScheduler.Default));
+        }
+
+        void Flush()
+        {
+            if (finished.IsEmpty)
+                return;
+
+            var succeeded = new List<TItem>();
+            while (finished.TryDequeue(out var result))
+            {
+                switch (result.Outcome)
+                {
+                    case BulkItemOutcome.Succeeded:
+                        succeeded.Add(result.Item);
+                        summary.Succeeded++;
+                        break;
+                    case BulkItemOutcome.Cancelled:
+                        summary.Cancelled++;
+                        break;
+                    default:
+                        summary.Failures.Add(new BulkItemFailure(result.Name, result.Error ?? "Unknown error"));
+                        break;
+                }
+            }
+
+            if (succeeded.Count > 0)
+                applySucceeded(succeeded);
+            progress.Report(summary.Completed, summary.Failures.Count);
+        }
+
+        var timer = new DispatcherTimer(_flushInterval, DispatcherPriority.Background, (_, _) => Flush());
+        timer.Start();
+        try
+        {
+            await Task.WhenAll(pending);
+        }
+        finally
+        {
+            timer.Stop();
+            Flush();
+            progress.End();
+        }
+
+        return summary;
+    }
+
+    private enum BulkItemOutcome
+    {
+        Succeeded,
+        Failed,
+        Cancelled
+    }
+}
+
+/// <summary>
+/// Outcome of a bulk operation, reported to the user once.
+/// </summary>
+public sealed class BulkOperationSummary
+{
+    private const int MaxListedFailures = 10;
+
+    public BulkOperationSummary(string title, int total)
+    {
+        Title = title;
+        Total = total;
+    }
+
+    public string Title { get; }
+    public int Total { get; }
+    public int Succeeded { get; internal set; }
+    public int Cancelled { get; internal set; }
+    public List<BulkItemFailure> Failures { get; } = [];
+
+    public int Completed => Succeeded + Cancelled + Failures.Count;
+
+    /// <summary>
+    /// One line for the status bar, e.g. "Removed 180 of 200 mod(s), 20 failed".
+    /// </summary>
+    public string Describe(string verb, string noun)
+    {
+        var text = $"{verb} {Succeeded} of {Total} {noun}";
+        if (Failures.Count > 0)
+            text += $", {Failures.Count} failed";
+        if (Cancelled > 0)
+            text += $", {Cancelled} cancelled";
+        return text;
+    }
+
+    /// <summary>
+    /// The failures as one dialog message, listing the first few.
+    /// </summary>
+    public string DescribeFailures()
+    {
+        var lines = Failures.Take(MaxListedFailures).Select(f => $"• {f.Name}: {f.Error}").ToList();
+        if (Failures.Count > MaxListedFailures)
+            lines.Add($"...and {Failures.Count - MaxListedFailures} more");
+        return string.Join("\n", lines);
+    }
+}
+
+/// <summary>
+/// An item that failed in a bulk operation.
+/// </summary>
+public sealed record BulkItemFailure(string Name, string Error);
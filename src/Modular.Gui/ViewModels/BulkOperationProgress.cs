@@ -0,0 +1,78 @@
+using CommunityToolkit.Mvvm.ComponentModel;
+using CommunityToolkit.Mvvm.Input;
+
+namespace Modular.Gui.ViewModels;
+
+/// <summary>
+/// Progress of a bulk operation as one bindable model. Updated by
+/// <see cref="Services.BulkOperationRunner"/> at most once per frame, however
+/// many items finish in between.
+/// </summary>
+public partial class BulkOperationProgress : ViewModelBase
+{
+    private CancellationTokenSource? _cts;
+
+    [ObservableProperty]
+    private string _title = string.Empty;
+
+    [ObservableProperty]
+    private bool _isRunning;
+
+    [ObservableProperty]
+    private int _total;
+
+    [ObservableProperty]
+    private int _completed;
+
+    [ObservableProperty]
+    private int _failed;
+
+    [ObservableProperty]
+    private double _percentage;
+
+    [ObservableProperty]
+    private string _statusText = string.Empty;
+
+    /// <summary>
+    /// Starts tracking a new operation.
+    /// </summary>
+    /// <returns>Token cancelled by <see cref="CancelCommand"/>.</returns>
+    internal CancellationToken Begin(string title, int total)
+    {
+        _cts?.Dispose();
+        _cts = new CancellationTokenSource();
+
+        Title = title;
+        Total = total;
+        Completed = 0;
+        Failed = 0;
+        Percentage = 0;
+        StatusText = $"{title} (0/{total})...";
+        IsRunning = true;
+        return _cts.Token;
+    }
+
+    internal void Report(int completed, int failed)
+    {
+        Completed = completed;
+        Failed = failed;
+        Percentage = Total == 0 ? 100 : completed * 100.0 / Total;
+        StatusText = failed == 0
+            ? $"{Title} ({completed}/{Total})..."
+            : $"{Title} ({completed}/{Total}, {failed} failed)...";
+    }
+
+    internal void End()
+    {
+        IsRunning = false;
+        _cts?.Dispose();
+        _cts = null;
+    }
+
+    [RelayCommand]
+    private void Cancel()
+    {
+        _cts?.Cancel();
+        StatusText = $"{Title}: cancelling...";
+    }
+}
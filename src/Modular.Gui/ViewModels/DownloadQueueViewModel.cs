@@ -10,6 +10,7 @@ using Modular.Sdk.Backends.Common;
 using Modular.Core.Backends.NexusMods;
 using Modular.Core.Backends.GameBanana;
 using Modular.Core.Configuration;
+using Modular.Core.RateLimiting;
 using Modular.Core.Services;
 using Modular.Core.Utilities;
 using Modular.Gui.Messages;
@@ -29,9 +30,10 @@ public partial class DownloadQueueViewModel : ViewModelBase
     private readonly AppSettings? _settings;
     private readonly DownloadHistoryService? _historyService;
     private readonly DownloadDatabase? _downloadDatabase;
+    private readonly BandwidthGovernor? _bandwidth;
     private readonly HttpClient _httpClient;
     private readonly ConcurrentQueue<DownloadItemModel> _pendingQueue = new();
-    private readonly SemaphoreSlim _downloadSemaphore = new(1, 1); // Single concurrent download
+    private readonly ConcurrencyGate _downloadGate = new(1);
     private CancellationTokenSource? _downloadCts;
     
     // Track domains that need reorganization after download batch completes
@@ -95,7 +97,8 @@ public partial class DownloadQueueViewModel : ViewModelBase
         IRenameService renameService,
         AppSettings settings,
         DownloadHistoryService historyService,
-        DownloadDatabase downloadDatabase)
+        DownloadDatabase downloadDatabase,
+        BandwidthGovernor bandwidth)
     {
         _nexusBackend = nexusBackend;
         _gameBananaBackend = gameBananaBackend;
@@ -103,9 +106,17 @@ public partial class DownloadQueueViewModel : ViewModelBase
         _settings = settings;
         _historyService = historyService;
         _downloadDatabase = downloadDatabase;
+        _bandwidth = bandwidth;
         _httpClient = new HttpClient();
         _httpClient.DefaultRequestHeaders.Add("User-Agent", "Modular/1.0");
+        _downloadGate.SetLimit(settings.MaxConcurrentDownloads);
         UpdateHistoryStats();
+
+        // Resize the running queue when max_concurrent_downloads changes
+        WeakReferenceMessenger.Default.Register<SettingsChangedMessage>(this, (r, m) =>
+        {
+            _downloadGate.SetLimit(settings.MaxConcurrentDownloads);
+        });
     }
 
     private void UpdateHistoryStats()
@@ -175,22 +186,32 @@ public partial class DownloadQueueViewModel : ViewModelBase
         _downloadCts = new CancellationTokenSource();
         IsDownloading = true;
 
+        var token = _downloadCts.Token;
+        var running = new List<Task>();
+
         try
         {
-            while (_pendingQueue.TryDequeue(out var item))
+            // Start queued items as slots free up; keep going while downloads are
+            // running, since they may finish after more items have been queued
+            while (true)
             {
-                _downloadCts.Token.ThrowIfCancellationRequested();
-
-                await _downloadSemaphore.WaitAsync(_downloadCts.Token);
-                try
-                {
-                    await DownloadItemAsync(item, _downloadCts.Token);
-                }
-                finally
+                if (_pendingQueue.TryDequeue(out var item))
                 {
-                    _downloadSemaphore.Release();
+                    token.ThrowIfCancellationRequested();
+
+                    var slot = await _downloadGate.EnterAsync(token);
+                    running.Add(RunDownloadAsync(item, slot, token));
+                    continue;
                 }
+
+                running.RemoveAll(t => t.IsCompleted);
+                if (running.Count == 0)
+                    break;
+
+                await Task.WhenAny(running);
             }
+
+            token.ThrowIfCancellationRequested();
         }
         catch (OperationCanceledException)
         {
@@ -198,6 +219,9 @@ public partial class DownloadQueueViewModel : ViewModelBase
         }
         finally
         {
+            // Let downloads already started observe the cancellation and finish
+            await Task.WhenAll(running);
+
             IsDownloading = false;
             _downloadCts = null;
             
@@ -209,6 +233,21 @@ public partial class DownloadQueueViewModel : ViewModelBase
         }
     }
     
+    private async Task RunDownloadAsync(DownloadItemModel item, IDisposable slot, CancellationToken ct)
+    {
+        using (slot)
+        {
+            try
+            {
+                await DownloadItemAsync(item, ct);
+            }
+            catch (OperationCanceledException)
+            {
+                // Reported once by ProcessQueueAsync
+            }
+        }
+    }
+
     /// <summary>
     /// Reorganizes downloaded mods into proper folder structure with human-readable names.
     /// </summary>
@@ -319,7 +358,10 @@ public partial class DownloadQueueViewModel : ViewModelBase
                 await Dispatcher.UIThread.InvokeAsync(() => item.TotalBytes = totalBytes);
             }
 
-            await using var contentStream = await response.Content.ReadAsStreamAsync(ct);
+            // Downloads started here get the interactive share of the bandwidth limit
+            await using var contentStream = _bandwidth != null
+                ? _bandwidth.Throttle(await response.Content.ReadAsStreamAsync(ct), BandwidthClass.Interactive)
+                : await response.Content.ReadAsStreamAsync(ct);
             await using var fileStream = new FileStream(outputPath, FileMode.Create, FileAccess.Write, FileShare.None, 81920, true);
 
             var buffer = new byte[81920];
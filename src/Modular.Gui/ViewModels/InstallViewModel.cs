@@ -16,10 +16,12 @@ namespace Modular.Gui.ViewModels;
 public partial class InstallViewModel : ViewModelBase
 {
     private readonly ModInstallationService? _installService;
+    private readonly InstallScheduler? _scheduler;
     private readonly SteamGameScanner? _scanner;
     private readonly IDialogService? _dialogService;
     private readonly AppSettings? _settings;
     private readonly ModMetadataCache? _metadataCache;
+    private CancellationTokenSource? _installCts;
 
     [ObservableProperty]
     private ObservableCollection<string> _archivePaths = new();
@@ -77,12 +79,14 @@ public partial class InstallViewModel : ViewModelBase
     // DI constructor
     public InstallViewModel(
         ModInstallationService installService,
+        InstallScheduler scheduler,
         SteamGameScanner scanner,
         IDialogService dialogService,
         AppSettings settings,
         ModMetadataCache metadataCache)
     {
         _installService = installService;
+        _scheduler = scheduler;
         _scanner = scanner;
         _dialogService = dialogService;
         _settings = settings;
@@ -422,25 +426,37 @@ public partial class InstallViewModel : ViewModelBase
         var succeeded = 0;
         var failed = 0;
 
+        // Installs run on the shared scheduler so they can overlap with work on
+        // other disks; they get their own connection since they leave this thread.
+        // Archives for the same target still run one at a time, in order.
+        _installCts = new CancellationTokenSource();
+        await using var db = new ModularDatabase(_installService.Database.DatabasePath);
+        var worker = _installService.WithDatabase(db);
+        var scheduler = _scheduler ?? new InstallScheduler();
+        var targetDirectory = TargetDirectory;
+        var operations = new List<(string FileName, ScheduledInstall<ModInstallationResult>? Operation)>();
+
+        void OnSchedulerProgress(object? sender, InstallSchedulerProgress _) =>
+            Avalonia.Threading.Dispatcher.UIThread.Post(() =>
+            {
+                var scheduled = operations.Where(o => o.Operation != null).Select(o => o.Operation!).ToList();
+                if (scheduled.Count > 0)
+                    InstallProgress = scheduled.Average(o => o.Completion.IsCompleted ? 100 : o.Percentage);
+            });
+
+        scheduler.ProgressChanged += OnSchedulerProgress;
+
         try
         {
-            for (var i = 0; i < pathsToInstall.Count; i++)
+            foreach (var archivePath in pathsToInstall)
             {
-                var archivePath = pathsToInstall[i];
                 var fileName = Path.GetFileName(archivePath);
-                CurrentArchiveIndex = i + 1;
-
                 if (!File.Exists(archivePath))
                 {
-                    InstallResults.Add($"Skipped (not found): {fileName}");
-                    failed++;
+                    operations.Add((fileName, null));
                     continue;
                 }
 
-                StatusMessage = DryRun
-                    ? $"Dry-run {CurrentArchiveIndex}/{TotalArchives}: {fileName}"
-                    : $"Installing {CurrentArchiveIndex}/{TotalArchives}: {fileName}";
-
                 var options = new ModInstallationOptions
                 {
                     ModId = Path.GetFileNameWithoutExtension(archivePath),
@@ -449,16 +465,41 @@ public partial class InstallViewModel : ViewModelBase
                     DryRun = DryRun
                 };
 
-                var progress = new Progress<InstallProgress>(p =>
+                var operation = scheduler.Schedule(
+                    fileName,
+                    targetDirectory,
+                    (progress, ct) => worker.InstallAsync(archivePath, targetDirectory, options, progress, ct),
+                    ct: _installCts.Token);
+                operations.Add((fileName, operation));
+            }
+
+            for (var i = 0; i < operations.Count; i++)
+            {
+                var (fileName, operation) = operations[i];
+                CurrentArchiveIndex = i + 1;
+
+                if (operation == null)
                 {
-                    // Scale progress across all archives
-                    var archiveBase = (double)(i) / TotalArchives * 100;
-                    var archiveSlice = p.Percentage / TotalArchives;
-                    InstallProgress = archiveBase + archiveSlice;
-                });
+                    InstallResults.Add($"Skipped (not found): {fileName}");
+                    failed++;
+                    continue;
+                }
 
-                var result = await _installService.InstallAsync(
-                    archivePath, TargetDirectory, options, progress);
+                StatusMessage = DryRun
+                    ? $"Dry-run {CurrentArchiveIndex}/{TotalArchives}: {fileName}"
+                    : $"Installing {CurrentArchiveIndex}/{TotalArchives}: {fileName}";
+
+                ModInstallationResult result;
+                try
+                {
+                    result = await operation.Result;
+                }
+                catch (OperationCanceledException)
+                {
+                    InstallResults.Add($"Cancelled: {fileName}");
+                    failed++;
+                    continue;
+                }
 
                 if (result.Success)
                 {
@@ -493,11 +534,24 @@ public partial class InstallViewModel : ViewModelBase
         }
         finally
         {
+            _installCts.Cancel();
+            await Task.WhenAll(operations.Where(o => o.Operation != null)
+                .Select(o => o.Operation!.Completion.ContinueWith(_ => { }, TaskScheduler.Default)));
+            scheduler.ProgressChanged -= OnSchedulerProgress;
+            _installCts.Dispose();
+            _installCts = null;
             IsInstalling = false;
             InstallProgress = 100;
         }
     }
 
+    [RelayCommand]
+    private void CancelInstall()
+    {
+        _installCts?.Cancel();
+        StatusMessage = "Cancelling...";
+    }
+
     private static string FormatFileSize(long bytes)
     {
         string[] suffixes = { "B", "KB", "MB", "GB" };
@@ -1,28 +1,48 @@
-using System.Collections.ObjectModel;
+using System.ComponentModel;
 using CommunityToolkit.Mvvm.ComponentModel;
 using CommunityToolkit.Mvvm.Input;
+using Modular.Core.Database;
 using Modular.Core.Installers;
+using Modular.Gui.Models;
 using Modular.Gui.Services;
 
 namespace Modular.Gui.ViewModels;
 
 public partial class InstalledModsViewModel : ViewModelBase
 {
+    // Shown for changesets recorded without a target directory
+    private const string UnknownTarget = "Unknown";
+
     private readonly ModInstallationService? _installService;
+    private readonly BulkOperationRunner? _bulkRunner;
     private readonly IDialogService? _dialogService;
 
     [ObservableProperty]
-    private ObservableCollection<ChangesetDisplayModel> _changesets = new();
+    private BatchObservableCollection<ChangesetDisplayModel> _changesets = new();
 
     [ObservableProperty]
+    [NotifyPropertyChangedFor(nameof(IsBusy))]
     private bool _isLoading;
 
+    [ObservableProperty]
+    private int _selectedCount;
+
     [ObservableProperty]
     private string _statusMessage = "Ready";
 
     [ObservableProperty]
     private int _totalInstalled;
 
+    /// <summary>
+    /// Progress of the running bulk uninstall, if any.
+    /// </summary>
+    public BulkOperationProgress Bulk { get; } = new();
+
+    /// <summary>
+    /// True while loading or uninstalling; disables the list actions.
+    /// </summary>
+    public bool IsBusy => IsLoading || Bulk.IsRunning;
+
     // Designer constructor
     public InstalledModsViewModel()
     {
@@ -40,11 +60,19 @@ public partial class InstalledModsViewModel : ViewModelBase
     // DI constructor
     public InstalledModsViewModel(
         ModInstallationService installService,
+        InstallScheduler scheduler,
         IDialogService dialogService)
     {
         _installService = installService;
+        _bulkRunner = new BulkOperationRunner(scheduler);
         _dialogService = dialogService;
 
+        Bulk.PropertyChanged += (_, e) =>
+        {
+            if (e.PropertyName == nameof(BulkOperationProgress.IsRunning))
+                OnPropertyChanged(nameof(IsBusy));
+        };
+
         _ = RefreshInstalledAsync();
     }
 
@@ -63,20 +91,21 @@ public partial class InstalledModsViewModel : ViewModelBase
         try
         {
             var installed = await _installService.ListInstalledAsync();
-            Changesets.Clear();
 
-            foreach (var record in installed)
+            var models = installed.Select(record => new ChangesetDisplayModel
             {
-                Changesets.Add(new ChangesetDisplayModel
-                {
-                    ChangesetId = record.ChangesetId,
-                    ModId = record.ModId ?? "Unknown",
-                    TargetDirectory = record.TargetDirectory ?? "Unknown",
-                    ArchivePath = record.ArchivePath ?? "",
-                    CreatedAt = record.CreatedAtUtc,
-                    State = record.State.ToString()
-                });
-            }
+                ChangesetId = record.ChangesetId,
+                ModId = record.ModId ?? "Unknown",
+                TargetDirectory = record.TargetDirectory ?? UnknownTarget,
+                ArchivePath = record.ArchivePath ?? "",
+                CreatedAt = record.CreatedAtUtc,
+                State = record.State.ToString()
+            }).ToList();
+            foreach (var model in models)
+                model.PropertyChanged += OnChangesetPropertyChanged;
+
+            Changesets.ReplaceAll(models);
+            UpdateSelectedCount();
 
             TotalInstalled = Changesets.Count;
             StatusMessage = $"{TotalInstalled} installed mod(s)";
@@ -91,56 +120,111 @@ public partial class InstalledModsViewModel : ViewModelBase
         }
     }
 
+    [RelayCommand]
+    private void SelectAll()
+    {
+        foreach (var changeset in Changesets)
+            changeset.IsSelected = true;
+    }
+
+    [RelayCommand]
+    private void SelectNone()
+    {
+        foreach (var changeset in Changesets)
+            changeset.IsSelected = false;
+    }
+
+    [RelayCommand]
+    private async Task RemoveSelectedAsync()
+    {
+        var selected = Changesets.Where(c => c.IsSelected).ToList();
+        if (_dialogService == null || selected.Count == 0)
+            return;
+
+        var confirmed = await _dialogService.ShowConfirmationAsync(
+            "Remove Selected Mods",
+            $"Are you sure you want to uninstall {selected.Count} selected mod(s)?\n\nThis action cannot be undone.");
+
+        if (confirmed)
+            await UninstallManyAsync(selected);
+    }
+
     [RelayCommand]
     private async Task RemoveAllAsync()
     {
-        if (_installService == null || _dialogService == null || Changesets.Count == 0)
+        if (_dialogService == null || Changesets.Count == 0)
             return;
 
         var confirmed = await _dialogService.ShowConfirmationAsync(
             "Remove All Mods",
             $"Are you sure you want to uninstall all {Changesets.Count} installed mod(s)?\n\nThis action cannot be undone.");
 
-        if (!confirmed) return;
+        if (confirmed)
+            await UninstallManyAsync(Changesets.ToList());
+    }
 
-        IsLoading = true;
-        var total = Changesets.Count;
-        var removed = 0;
-        var failed = 0;
+    private async Task UninstallManyAsync(IReadOnlyList<ChangesetDisplayModel> changesets)
+    {
+        if (_installService == null || _bulkRunner == null || _dialogService == null)
+            return;
 
-        var snapshot = Changesets.ToList();
-        foreach (var changeset in snapshot)
+        // One connection and service per target directory, set up front. Targets
+        // may be processed side by side, but the scheduler runs the items of one
+        // target one after another, so each service serves one item at a time.
+        var dbPath = _installService.Database.DatabasePath;
+        var services = new Dictionary<string, (ModularDatabase Database, ModInstallationService Service)>(StringComparer.Ordinal);
+        foreach (var target in changesets.Select(c => c.TargetDirectory)
+                     .Where(t => !string.IsNullOrEmpty(t) && t != UnknownTarget).Select(TargetKey))
         {
-            StatusMessage = $"Uninstalling {changeset.ModId} ({removed + failed + 1}/{total})...";
+            if (services.ContainsKey(target))
+                continue;
+            var db = new ModularDatabase(dbPath);
+            services[target] = (db, _installService.WithDatabase(db));
+        }
 
-            try
-            {
-                var result = await _installService.UninstallAsync(changeset.ChangesetId);
-                if (result.Success)
+        BulkOperationSummary summary;
+        try
+        {
+            summary = await _bulkRunner.RunAsync(
+                Bulk,
+                "Uninstalling",
+                changesets,
+                c => c.ModId,
+                c => c.TargetDirectory == UnknownTarget ? null : c.TargetDirectory,
+                async (changeset, ct) =>
                 {
-                    Changesets.Remove(changeset);
-                    removed++;
-                }
-                else
+                    var service = services[TargetKey(changeset.TargetDirectory)].Service;
+                    var result = await service.UninstallAsync(changeset.ChangesetId, ct);
+                    return result.Success ? null : result.Error ?? "Uninstall failed";
+                },
+                removed =>
                 {
-                    failed++;
-                }
-            }
-            catch
-            {
-                failed++;
-            }
+                    var set = removed.ToHashSet();
+                    Changesets.RemoveAll(set.Contains);
+                    TotalInstalled = Changesets.Count;
+                    UpdateSelectedCount();
+                });
+        }
+        finally
+        {
+            foreach (var (db, _) in services.Values)
+                await db.DisposeAsync();
         }
 
-        TotalInstalled = Changesets.Count;
-        IsLoading = false;
+        StatusMessage = summary.Describe("Removed", "mod(s)");
 
-        if (failed == 0)
-            StatusMessage = $"Successfully removed all {removed} mod(s)";
-        else
-            StatusMessage = $"Removed {removed} mod(s), {failed} failed";
+        if (summary.Failures.Count > 0)
+        {
+            await _dialogService.ShowErrorAsync(
+                $"{summary.Failures.Count} of {summary.Total} mod(s) could not be removed",
+                summary.DescribeFailures());
+        }
     }
 
+    // Same normalization the install scheduler groups targets by
+    private static string TargetKey(string targetDirectory) =>
+        Path.TrimEndingDirectorySeparator(Path.GetFullPath(targetDirectory));
+
     [RelayCommand]
     private async Task UninstallModAsync(ChangesetDisplayModel? changeset)
     {
@@ -166,6 +250,7 @@ public partial class InstalledModsViewModel : ViewModelBase
             {
                 Changesets.Remove(changeset);
                 TotalInstalled = Changesets.Count;
+                UpdateSelectedCount();
                 StatusMessage = $"Successfully uninstalled {changeset.ModId}";
             }
             else
@@ -184,10 +269,24 @@ public partial class InstalledModsViewModel : ViewModelBase
             IsLoading = false;
         }
     }
+
+    private void OnChangesetPropertyChanged(object? sender, PropertyChangedEventArgs e)
+    {
+        if (e.PropertyName == nameof(ChangesetDisplayModel.IsSelected))
+            UpdateSelectedCount();
+    }
+
+    private void UpdateSelectedCount()
+    {
+        SelectedCount = Changesets.Count(c => c.IsSelected);
+    }
 }
 
 public partial class ChangesetDisplayModel : ObservableObject
 {
+    [ObservableProperty]
+    private bool _isSelected;
+
     [ObservableProperty]
     private string _changesetId = string.Empty;
 
@@ -6,6 +6,7 @@ using CommunityToolkit.Mvvm.Messaging;
 using Modular.Core.Backends;
 using Modular.Core.Configuration;
 using Modular.Core.RateLimiting;
+using Modular.Core.Updates;
 using Modular.Gui.Messages;
 using Modular.Gui.Services;
 
@@ -43,6 +44,12 @@ public partial class MainWindowViewModel : ViewModelBase
     [ObservableProperty]
     private ViewModelBase? _currentViewModel;
 
+    [ObservableProperty]
+    private string _updateNotification = string.Empty;
+
+    [ObservableProperty]
+    private bool _showUpdateNotification;
+
     // Child ViewModels
     public NexusModsViewModel? NexusModsViewModel { get; }
     public GameBananaPanelViewModel? GameBananaPanelViewModel { get; }
@@ -125,6 +132,12 @@ public partial class MainWindowViewModel : ViewModelBase
             });
         });
 
+        // Surface mods found outdated by the background update check
+        WeakReferenceMessenger.Default.Register<ModUpdatesAvailableMessage>(this, (r, m) =>
+        {
+            Dispatcher.UIThread.Post(() => ShowUpdates(m.Value));
+        });
+
         // Set up timer to update rate limit info periodically
         _rateLimitTimer = new System.Timers.Timer(5000); // Update every 5 seconds
         _rateLimitTimer.Elapsed += OnRateLimitTimerElapsed;
@@ -177,6 +190,25 @@ public partial class MainWindowViewModel : ViewModelBase
         }
     }
 
+    private void ShowUpdates(IReadOnlyList<OutdatedMod> mods)
+    {
+        if (mods.Count == 0)
+            return;
+
+        var names = mods.Take(3).Select(m => string.IsNullOrEmpty(m.Name) ? $"{m.GameDomain}/{m.ModId}" : m.Name);
+        var more = mods.Count > 3 ? $" and {mods.Count - 3} more" : string.Empty;
+        UpdateNotification = mods.Count == 1
+            ? $"Update available: {names.First()}"
+            : $"{mods.Count} mod updates available: {string.Join(", ", names)}{more}";
+        ShowUpdateNotification = true;
+    }
+
+    [RelayCommand]
+    private void DismissUpdateNotification()
+    {
+        ShowUpdateNotification = false;
+    }
+
     private void UpdateRateLimitInfo()
     {
         if (_rateLimiter is NexusRateLimiter nexusLimiter)
@@ -245,7 +277,7 @@ public partial class MainWindowViewModel : ViewModelBase
             }
             else if (CurrentViewModel is ModManagerViewModel modManager)
             {
-                modManager.ScanForArchivesCommand.Execute(null);
+                await modManager.ScanForArchivesCommand.ExecuteAsync(null);
                 if (modManager.InstalledModsViewModel != null)
                     await modManager.InstalledModsViewModel.RefreshInstalledCommand.ExecuteAsync(null);
             }
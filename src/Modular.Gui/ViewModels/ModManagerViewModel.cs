@@ -1,27 +1,49 @@
 using System.Collections.ObjectModel;
 using CommunityToolkit.Mvvm.ComponentModel;
 using CommunityToolkit.Mvvm.Input;
+using Modular.Core.Archives;
 using Modular.Core.Configuration;
+using Modular.Gui.Models;
 
 namespace Modular.Gui.ViewModels;
 
 /// <summary>
 /// Combined ViewModel wrapping Install and Installed Mods as sub-tabs.
-/// Also scans the mods directory for installable archives.
+/// Also shows the download library from the mods directory, kept current by
+/// <see cref="DownloadLibraryIndex"/>.
 /// </summary>
 public partial class ModManagerViewModel : ViewModelBase
 {
+    private const string AllGames = "All games";
+    private const int InstallTabIndex = 0;
+
     public InstallViewModel? InstallViewModel { get; }
     public InstalledModsViewModel? InstalledModsViewModel { get; }
     public SwitchInstallViewModel? SwitchInstallViewModel { get; }
 
     private readonly AppSettings? _settings;
+    private readonly DownloadLibraryIndex? _library;
+    private List<LibraryArchiveDisplayModel> _allArchives = [];
 
     [ObservableProperty]
     private int _selectedTabIndex;
 
+    /// <summary>
+    /// Library archives matching the current filter.
+    /// </summary>
+    public BatchObservableCollection<LibraryArchiveDisplayModel> Archives { get; } = new();
+
     [ObservableProperty]
-    private ObservableCollection<string> _detectedArchives = new();
+    private ObservableCollection<string> _games = new() { AllGames };
+
+    [ObservableProperty]
+    private string _selectedGame = AllGames;
+
+    [ObservableProperty]
+    private string _filterText = string.Empty;
+
+    [ObservableProperty]
+    private bool _isScanning;
 
     [ObservableProperty]
     private string _statusMessage = string.Empty;
@@ -32,7 +54,17 @@ public partial class ModManagerViewModel : ViewModelBase
         InstallViewModel = new InstallViewModel();
         InstalledModsViewModel = new InstalledModsViewModel();
         SwitchInstallViewModel = new SwitchInstallViewModel();
-        DetectedArchives.Add("/home/user/Mods/skyrim/sample-mod.zip");
+        SetArchives(
+        [
+            new LibraryArchive
+            {
+                Path = "/home/user/Mods/skyrim/sample-mod.zip",
+                SizeBytes = 12_345_678,
+                MtimeTicks = DateTime.UtcNow.Ticks,
+                GameDomain = "skyrim",
+                InstallerId = "fomod"
+            }
+        ]);
     }
 
     // DI constructor
@@ -40,53 +72,189 @@ public partial class ModManagerViewModel : ViewModelBase
         InstallViewModel installViewModel,
         InstalledModsViewModel installedModsViewModel,
         SwitchInstallViewModel switchInstallViewModel,
-        AppSettings settings)
+        AppSettings settings,
+        DownloadLibraryIndex library)
     {
         InstallViewModel = installViewModel;
         InstalledModsViewModel = installedModsViewModel;
         SwitchInstallViewModel = switchInstallViewModel;
         _settings = settings;
-        ScanForArchives();
+        _library = library;
+        _ = ScanForArchivesAsync();
     }
 
+    partial void OnFilterTextChanged(string value) => ApplyFilter();
+
+    partial void OnSelectedGameChanged(string value) => ApplyFilter();
+
+    /// <summary>
+    /// Shows the indexed library straight away, then rescans the mods
+    /// directory; only new or changed archives are opened.
+    /// </summary>
     [RelayCommand]
-    private void ScanForArchives()
+    private async Task ScanForArchivesAsync()
     {
-        DetectedArchives.Clear();
         var modsDir = _settings?.ModsDirectory;
+        if (_library == null || IsScanning)
+            return;
+
         if (string.IsNullOrEmpty(modsDir) || !Directory.Exists(modsDir))
         {
             StatusMessage = "Mods directory not configured or doesn't exist";
             return;
         }
 
-        var archiveExtensions = new HashSet<string>(StringComparer.OrdinalIgnoreCase)
-            { ".zip", ".7z", ".rar", ".tar.gz", ".tar" };
-
+        IsScanning = true;
         try
         {
-            var files = Directory.GetFiles(modsDir, "*", SearchOption.AllDirectories)
-                .Where(f => archiveExtensions.Contains(Path.GetExtension(f)))
-                .OrderBy(f => f)
-                .ToList();
-
-            foreach (var file in files)
-                DetectedArchives.Add(file);
-
-            StatusMessage = files.Count > 0
-                ? $"Found {files.Count} archive(s) in {modsDir}"
-                : "No archives found in mods directory";
-
-            // Auto-populate the Install VM's archive list if empty
-            if (InstallViewModel != null && InstallViewModel.ArchivePaths.Count == 0)
+            if (_allArchives.Count == 0)
             {
-                foreach (var archive in files.Take(50)) // Limit to avoid overwhelming
-                    InstallViewModel.ArchivePaths.Add(archive);
+                var indexed = await Task.Run(() => _library.GetIndexedAsync(modsDir));
+                if (indexed.Count > 0)
+                {
+                    SetArchives(indexed);
+                    StatusMessage = $"{indexed.Count} archive(s) indexed, checking for changes...";
+                }
+                else
+                {
+                    StatusMessage = $"Indexing archives in {modsDir}...";
+                }
             }
+
+            var report = await Task.Run(() => _library.ScanAsync(modsDir));
+            SetArchives(report.Archives);
+
+            StatusMessage = report.Archives.Count == 0
+                ? "No archives found in mods directory"
+                : $"{report.Archives.Count} archive(s) in {modsDir}: {report.InspectedCount} inspected, " +
+                  $"{report.RemovedCount} removed ({report.Duration.TotalMilliseconds:F0} ms)";
         }
         catch (Exception ex)
         {
             StatusMessage = $"Error scanning: {ex.Message}";
         }
+        finally
+        {
+            IsScanning = false;
+        }
+    }
+
+    /// <summary>
+    /// Queues the selected library archives on the Install tab.
+    /// </summary>
+    [RelayCommand]
+    private void AddSelectedToInstall()
+    {
+        if (InstallViewModel == null)
+            return;
+
+        var selected = _allArchives.Where(a => a.IsSelected).ToList();
+        if (selected.Count == 0)
+        {
+            StatusMessage = "No archives selected";
+            return;
+        }
+
+        var added = 0;
+        foreach (var archive in selected)
+        {
+            archive.IsSelected = false;
+            if (InstallViewModel.ArchivePaths.Contains(archive.Path))
+                continue;
+            InstallViewModel.ArchivePaths.Add(archive.Path);
+            added++;
+        }
+
+        StatusMessage = $"Queued {added} archive(s) for installation";
+        SelectedTabIndex = InstallTabIndex;
+    }
+
+    [RelayCommand]
+    private void SelectAllArchives()
+    {
+        foreach (var archive in Archives)
+            archive.IsSelected = true;
+    }
+
+    [RelayCommand]
+    private void SelectNoArchives()
+    {
+        foreach (var archive in _allArchives)
+            archive.IsSelected = false;
+    }
+
+    private void SetArchives(IReadOnlyList<LibraryArchive> archives)
+    {
+        // Keep selections across rescans
+        var selected = _allArchives.Where(a => a.IsSelected).Select(a => a.Path).ToHashSet(StringComparer.Ordinal);
+
+        _allArchives = archives
+            .OrderBy(a => a.GameDomain, StringComparer.OrdinalIgnoreCase)
+            .ThenBy(a => a.FileName, StringComparer.OrdinalIgnoreCase)
+            .Select(a => new LibraryArchiveDisplayModel(a) { IsSelected = selected.Contains(a.Path) })
+            .ToList();
+
+        var games = _allArchives
+            .Select(a => a.Game)
+            .Distinct(StringComparer.OrdinalIgnoreCase)
+            .OrderBy(g => g, StringComparer.OrdinalIgnoreCase)
+            .Prepend(AllGames)
+            .ToList();
+        if (!games.SequenceEqual(Games))
+        {
+            var current = SelectedGame;
+            Games = new ObservableCollection<string>(games);
+            SelectedGame = games.Contains(current) ? current : AllGames;
+        }
+
+        ApplyFilter();
+    }
+
+    private void ApplyFilter()
+    {
+        var text = FilterText.Trim();
+        var game = SelectedGame;
+
+        Archives.ReplaceAll(_allArchives.Where(a =>
+            (game == AllGames || string.Equals(a.Game, game, StringComparison.OrdinalIgnoreCase)) &&
+            (text.Length == 0 ||
+             a.Name.Contains(text, StringComparison.OrdinalIgnoreCase) ||
+             a.Installer.Contains(text, StringComparison.OrdinalIgnoreCase))));
+    }
+}
+
+/// <summary>
+/// Display model for an archive in the download library.
+/// </summary>
+public partial class LibraryArchiveDisplayModel : ObservableObject
+{
+    public LibraryArchiveDisplayModel(LibraryArchive archive)
+    {
+        Path = archive.Path;
+        Name = archive.FileName;
+        Game = archive.GameDomain ?? "-";
+        Installer = archive.InstallerId ?? "-";
+        SizeBytes = archive.SizeBytes;
+        Modified = archive.LastWriteUtc.ToLocalTime();
+    }
+
+    [ObservableProperty]
+    private bool _isSelected;
+
+    public string Path { get; }
+    public string Name { get; }
+    public string Game { get; }
+    public string Installer { get; }
+    public long SizeBytes { get; }
+    public DateTime Modified { get; }
+
+    public string SizeText => FormatBytes(SizeBytes);
+
+    private static string FormatBytes(long bytes)
+    {
+        if (bytes < 1024) return $"{bytes} B";
+        if (bytes < 1024 * 1024) return $"{bytes / 1024.0:F1} KB";
+        if (bytes < 1024 * 1024 * 1024) return $"{bytes / (1024.0 * 1024):F1} MB";
+        return $"{bytes / (1024.0 * 1024 * 1024):F1} GB";
     }
 }
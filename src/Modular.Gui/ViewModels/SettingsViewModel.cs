@@ -1,6 +1,7 @@
 using System.Text.Json;
 using Avalonia;
 using Avalonia.Styling;
+using Avalonia.Threading;
 using CommunityToolkit.Mvvm.ComponentModel;
 using CommunityToolkit.Mvvm.Input;
 using CommunityToolkit.Mvvm.Messaging;
@@ -19,7 +20,7 @@ namespace Modular.Gui.ViewModels;
 /// </summary>
 public partial class SettingsViewModel : ViewModelBase
 {
-    private readonly ConfigurationService? _configService;
+    private readonly ConfigurationStore? _configStore;
     private readonly AppSettings? _settings;
     private readonly IDialogService? _dialogService;
     private readonly NexusSsoClient? _ssoClient;
@@ -78,6 +79,9 @@ public partial class SettingsViewModel : ViewModelBase
     [ObservableProperty]
     private int _maxConcurrentDownloads = 1;
 
+    [ObservableProperty]
+    private int _bandwidthLimitKbps;
+
     // Advanced settings
     [ObservableProperty]
     private bool _verbose;
@@ -163,7 +167,7 @@ public partial class SettingsViewModel : ViewModelBase
 
     // DI constructor
     public SettingsViewModel(
-        ConfigurationService configService,
+        ConfigurationStore configStore,
         AppSettings settings,
         IDialogService dialogService,
         NexusSsoClient ssoClient,
@@ -172,7 +176,7 @@ public partial class SettingsViewModel : ViewModelBase
         ProfilesViewModel profilesViewModel,
         PluginsViewModel pluginsViewModel)
     {
-        _configService = configService;
+        _configStore = configStore;
         _settings = settings;
         _dialogService = dialogService;
         _ssoClient = ssoClient;
@@ -182,6 +186,17 @@ public partial class SettingsViewModel : ViewModelBase
         PluginsViewModel = pluginsViewModel;
 
         LoadSettings();
+
+        // Show changes made outside this view, e.g. config.json edited by hand,
+        // unless they would overwrite edits the user hasn't saved yet
+        WeakReferenceMessenger.Default.Register<SettingsChangedMessage>(this, (r, m) =>
+        {
+            Dispatcher.UIThread.Post(() =>
+            {
+                if (!HasUnsavedChanges)
+                    LoadSettings();
+            });
+        });
     }
 
     private void LoadSettings()
@@ -214,6 +229,7 @@ public partial class SettingsViewModel : ViewModelBase
         VerifyDownloads = _settings.VerifyDownloads;
         ValidateTracking = _settings.ValidateTracking;
         MaxConcurrentDownloads = _settings.MaxConcurrentDownloads;
+        BandwidthLimitKbps = _settings.BandwidthLimitKbps;
 
         // Advanced
         Verbose = _settings.Verbose;
@@ -242,6 +258,7 @@ public partial class SettingsViewModel : ViewModelBase
     partial void OnVerifyDownloadsChanged(bool value) => HasUnsavedChanges = true;
     partial void OnValidateTrackingChanged(bool value) => HasUnsavedChanges = true;
     partial void OnMaxConcurrentDownloadsChanged(int value) => HasUnsavedChanges = true;
+    partial void OnBandwidthLimitKbpsChanged(int value) => HasUnsavedChanges = true;
     partial void OnVerboseChanged(bool value) => HasUnsavedChanges = true;
     partial void OnCookieFileChanged(string value) => HasUnsavedChanges = true;
     partial void OnDatabasePathChanged(string value) => HasUnsavedChanges = true;
@@ -308,7 +325,7 @@ public partial class SettingsViewModel : ViewModelBase
     [RelayCommand]
     private async Task SaveSettingsAsync()
     {
-        if (_configService == null || _settings == null)
+        if (_configStore == null || _settings == null)
         {
             StatusMessage = "Configuration service not available";
             return;
@@ -316,45 +333,49 @@ public partial class SettingsViewModel : ViewModelBase
 
         try
         {
+            var updated = _settings.Clone();
+
             // NexusMods
-            _settings.NexusApiKey = NexusApiKey;
-            _settings.NexusApplicationSlug = NexusApplicationSlug;
-            _settings.NexusSsoEnabled = NexusSsoEnabled;
+            updated.NexusApiKey = NexusApiKey;
+            updated.NexusApplicationSlug = NexusApplicationSlug;
+            updated.NexusSsoEnabled = NexusSsoEnabled;
 
             // GameBanana
-            _settings.GameBananaUserId = GameBananaUserId;
-            _settings.GameBananaGameIds = ParseIntList(GameBananaGameIds);
-            _settings.GameBananaDownloadDir = GameBananaDownloadDir;
+            updated.GameBananaUserId = GameBananaUserId;
+            updated.GameBananaGameIds = ParseIntList(GameBananaGameIds);
+            updated.GameBananaDownloadDir = GameBananaDownloadDir;
 
             // Backends
-            _settings.EnabledBackends = BuildEnabledBackends();
+            updated.EnabledBackends = BuildEnabledBackends();
 
             // Downloads
-            _settings.ModsDirectory = ModsDirectory;
-            _settings.DefaultCategories = ParseStringList(DefaultCategories);
-            _settings.AutoRename = AutoRename;
-            _settings.OrganizeByCategory = OrganizeByCategory;
-            _settings.VerifyDownloads = VerifyDownloads;
-            _settings.ValidateTracking = ValidateTracking;
-            _settings.MaxConcurrentDownloads = MaxConcurrentDownloads;
+            updated.ModsDirectory = ModsDirectory;
+            updated.DefaultCategories = ParseStringList(DefaultCategories);
+            updated.AutoRename = AutoRename;
+            updated.OrganizeByCategory = OrganizeByCategory;
+            updated.VerifyDownloads = VerifyDownloads;
+            updated.ValidateTracking = ValidateTracking;
+            updated.MaxConcurrentDownloads = MaxConcurrentDownloads;
+            updated.BandwidthLimitKbps = BandwidthLimitKbps;
 
             // Advanced
-            _settings.Verbose = Verbose;
-            _settings.CookieFile = CookieFile;
-            _settings.DatabasePath = DatabasePath;
-            _settings.RateLimitStatePath = RateLimitStatePath;
-            _settings.MetadataCachePath = MetadataCachePath;
-
-            await _configService.SaveAsync(_settings);
-
+            updated.Verbose = Verbose;
+            updated.CookieFile = CookieFile;
+            updated.DatabasePath = DatabasePath;
+            updated.RateLimitStatePath = RateLimitStatePath;
+            updated.MetadataCachePath = MetadataCachePath;
+
+            // Validates and writes the file, then updates the shared settings and
+            // notifies listeners through SettingsChangedMessage. Cleared first so
+            // that message refreshes this view with the saved values.
             HasUnsavedChanges = false;
-            StatusMessage = "Settings saved successfully";
+            await _configStore.SaveAsync(updated);
 
-            WeakReferenceMessenger.Default.Send(new SettingsChangedMessage(
-                new SettingsChangedInfo { SettingName = "all" }));
+            StatusMessage = "Settings saved successfully";
         }
         catch (Exception ex)
         {
+            HasUnsavedChanges = true;
             StatusMessage = $"Error saving settings: {ex.Message}";
             if (_dialogService != null)
             {
@@ -1,5 +1,6 @@
 using Modular.Switch.Installer;
 using Modular.Switch.Models;
+using Modular.Switch.Patches;
 using SharpCompress.Archives;
 
 namespace Modular.Switch.DependencyResolver;
@@ -8,6 +9,8 @@ namespace Modular.Switch.DependencyResolver;
 /// Detects file-level overlaps between Switch mods before installation.
 /// Scans each mod's archive entries or extracted folder contents and reports
 /// which normalized file paths are provided by more than one mod.
+/// Exefs patches (IPS, IPS32, pchtxt) are all applied by the emulator, so
+/// for those only byte ranges that two mods patch differently count.
 /// </summary>
 public static class SwitchFileOverlapDetector
 {
@@ -20,17 +23,24 @@ public static class SwitchFileOverlapDetector
     {
         // Map normalized path (lowercased) -> list of ModKeys that provide it
         var fileProviders = new Dictionary<string, List<string>>(StringComparer.OrdinalIgnoreCase);
+        var patches = new List<(string Path, ExeFsPatch Patch)>();
 
         foreach (var mod in mods)
         {
             ct.ThrowIfCancellationRequested();
 
-            var paths = mod.IsExtracted
-                ? GetFolderPaths(mod)
-                : GetArchivePaths(mod);
+            var files = mod.IsExtracted
+                ? GetFolderFiles(mod)
+                : GetArchiveFiles(mod);
 
-            foreach (var path in paths)
+            foreach (var (path, patchContent) in files)
             {
+                if (patchContent != null && TryParsePatch(path, patchContent, mod.ModKey) is { } patch)
+                {
+                    patches.Add((path, patch));
+                    continue;
+                }
+
                 if (!fileProviders.TryGetValue(path, out var providers))
                 {
                     providers = [];
@@ -49,13 +59,49 @@ public static class SwitchFileOverlapDetector
                 NormalizedPath = kv.Key,
                 ModKeys = kv.Value
             })
+            .Concat(GetPatchOverlaps(patches))
             .OrderBy(o => o.NormalizedPath, StringComparer.OrdinalIgnoreCase)
             .ToList();
 
         return await Task.FromResult(new SwitchOverlapReport { Overlaps = overlaps });
     }
 
-    private static IEnumerable<string> GetArchivePaths(SwitchMod mod)
+    /// <summary>
+    /// One overlap entry per patched NSO, listing the byte ranges that mods
+    /// patch differently.
+    /// </summary>
+    private static IEnumerable<SwitchFileOverlap> GetPatchOverlaps(List<(string Path, ExeFsPatch Patch)> patches)
+    {
+        var paths = patches
+            .GroupBy(p => p.Patch.BuildId)
+            .ToDictionary(g => g.Key, g => g.First().Path);
+
+        return ExeFsPatchMerger.FindOverlaps(patches.Select(p => p.Patch))
+            .GroupBy(o => o.BuildId)
+            .Select(g => new SwitchFileOverlap
+            {
+                NormalizedPath = paths[g.Key],
+                ModKeys = g.SelectMany(o => new[] { o.FirstSource, o.SecondSource })
+                    .Distinct(StringComparer.OrdinalIgnoreCase)
+                    .ToList(),
+                PatchRanges = g.ToList()
+            });
+    }
+
+    private static ExeFsPatch? TryParsePatch(string path, byte[] content, string modKey)
+    {
+        // Unreadable patches fall back to path-level overlap detection
+        try
+        {
+            return ExeFsPatchParser.Parse(path, content, modKey);
+        }
+        catch (InvalidDataException)
+        {
+            return null;
+        }
+    }
+
+    private static IEnumerable<(string Path, byte[]? PatchContent)> GetArchiveFiles(SwitchMod mod)
     {
         if (!File.Exists(mod.SourcePath))
             yield break;
@@ -69,12 +115,23 @@ public static class SwitchFileOverlapDetector
                 continue;
 
             var normalized = SwitchModInstaller.NormaliseArchivePath(raw, mod.Category);
-            if (normalized != null)
-                yield return normalized.ToLowerInvariant();
+            if (normalized == null)
+                continue;
+
+            byte[]? patchContent = null;
+            if (ExeFsPatchParser.IsPatchFile(normalized))
+            {
+                using var stream = entry.OpenEntryStream();
+                using var buffer = new MemoryStream();
+                stream.CopyTo(buffer);
+                patchContent = buffer.ToArray();
+            }
+
+            yield return (normalized.ToLowerInvariant(), patchContent);
         }
     }
 
-    private static IEnumerable<string> GetFolderPaths(SwitchMod mod)
+    private static IEnumerable<(string Path, byte[]? PatchContent)> GetFolderFiles(SwitchMod mod)
     {
         if (!Directory.Exists(mod.SourcePath))
             yield break;
@@ -88,7 +145,10 @@ public static class SwitchFileOverlapDetector
 
             var normalized = SwitchModInstaller.NormaliseArchivePath(relPath, mod.Category);
             if (normalized != null)
-                yield return normalized.ToLowerInvariant();
+            {
+                var patchContent = ExeFsPatchParser.IsPatchFile(normalized) ? File.ReadAllBytes(file) : null;
+                yield return (normalized.ToLowerInvariant(), patchContent);
+            }
         }
     }
 }
@@ -103,6 +163,18 @@ public sealed class SwitchFileOverlap
 
     /// <summary>ModKeys that provide this file, in install-order sequence.</summary>
     public List<string> ModKeys { get; init; } = [];
+
+    /// <summary>
+    /// For exefs patches, the byte ranges the mods patch differently; empty
+    /// for ordinary files, which overlap as a whole.
+    /// </summary>
+    public List<ExeFsPatchOverlap> PatchRanges { get; init; } = [];
+
+    /// <summary>Path for display, with the first conflicting patch ranges appended.</summary>
+    public string DisplayPath => PatchRanges.Count == 0
+        ? NormalizedPath
+        : $"{NormalizedPath} @ {string.Join(", ", PatchRanges.Take(3).Select(r => $"0x{r.Start:X}-0x{r.End:X}"))}"
+          + (PatchRanges.Count > 3 ? ", ..." : "");
 }
 
 /// <summary>
@@ -0,0 +1,72 @@
+namespace Modular.Switch.Patches;
+
+/// <summary>
+/// File formats an exefs patch can come in.
+/// </summary>
+public enum ExeFsPatchFormat
+{
+    /// <summary>Classic IPS: 24-bit offsets, "PATCH" … "EOF".</summary>
+    Ips,
+
+    /// <summary>IPS32: 32-bit offsets, "IPS32" … "EEOF".</summary>
+    Ips32,
+
+    /// <summary>IPSwitch text patch (<c>.pchtxt</c>).</summary>
+    PchTxt
+}
+
+/// <summary>
+/// Bytes written at one offset of an NSO. Offsets are IPS offsets, i.e.
+/// relative to the start of the NSO including its 0x100-byte header.
+/// </summary>
+public readonly record struct ExeFsPatchRecord(long Offset, byte[] Data)
+{
+    /// <summary>First offset after the written bytes.</summary>
+    public long End => Offset + Data.Length;
+}
+
+/// <summary>
+/// A parsed exefs patch: the records it writes into the executable with
+/// build ID <see cref="BuildId"/>.
+/// </summary>
+public sealed class ExeFsPatch
+{
+    public ExeFsPatch(string buildId, ExeFsPatchFormat format, IReadOnlyList<ExeFsPatchRecord> records, string source)
+    {
+        BuildId = NormalizeBuildId(buildId);
+        Format = format;
+        Records = records;
+        Source = source;
+    }
+
+    /// <summary>
+    /// Upper-case hex build ID, zero-padded to the full 32 bytes so that
+    /// truncated and full-length file names of one NSO compare equal.
+    /// </summary>
+    public string BuildId { get; }
+
+    public ExeFsPatchFormat Format { get; }
+
+    public IReadOnlyList<ExeFsPatchRecord> Records { get; }
+
+    /// <summary>
+    /// Who provides the patch (a mod key or file path); overlaps are only
+    /// reported between different sources.
+    /// </summary>
+    public string Source { get; }
+
+    /// <summary>
+    /// Canonical form of a build ID, or null when it isn't hex.
+    /// </summary>
+    public static string? TryNormalizeBuildId(string buildId)
+    {
+        var trimmed = buildId.Trim();
+        if (trimmed.Length == 0 || trimmed.Length > 64 || !trimmed.All(Uri.IsHexDigit))
+            return null;
+
+        return trimmed.ToUpperInvariant().PadRight(64, '0');
+    }
+
+    private static string NormalizeBuildId(string buildId) =>
+        TryNormalizeBuildId(buildId) ?? throw new ArgumentException($"Not a hex build ID: {buildId}", nameof(buildId));
+}
@@ -0,0 +1,205 @@
+using System.Buffers.Binary;
+
+namespace Modular.Switch.Patches;
+
+/// <summary>
+/// Finds byte-level overlaps between exefs patches and merges compatible
+/// ones into a single IPS per build ID. Two patches only conflict where
+/// they write different bytes to the same offsets; writing the same bytes
+/// twice, or patching disjoint ranges of one NSO, is fine.
+/// </summary>
+public static class ExeFsPatchMerger
+{
+    private const int MaxIpsRecordSize = 0xFFFF;
+    private const long MaxIpsOffset = 0xFFFFFF;
+
+    // A classic IPS record at this offset would read as the "EOF" footer
+    private const long IpsFooterOffset = 0x454F46;
+
+    /// <summary>
+    /// Ranges where patches from different sources write different bytes,
+    /// coalesced per build ID and pair of sources.
+    /// </summary>
+    public static List<ExeFsPatchOverlap> FindOverlaps(IEnumerable<ExeFsPatch> patches)
+    {
+        var overlaps = new List<ExeFsPatchOverlap>();
+
+        foreach (var group in patches.GroupBy(p => p.BuildId))
+        {
+            var tree = new PatchIntervalTree<(ExeFsPatch Patch, ExeFsPatchRecord Record)>(
+                group.SelectMany(p => p.Records.Select(r => (r.Offset, r.End, (p, r)))));
+
+            foreach (var patch in group)
+            {
+                foreach (var record in patch.Records)
+                {
+                    foreach (var (_, _, hit) in tree.Query(record.Offset, record.End))
+                    {
+                        // Each pair is seen from both sides; report it from the lower source
+                        if (string.CompareOrdinal(patch.Source, hit.Patch.Source) >= 0)
+                            continue;
+
+                        var start = Math.Max(record.Offset, hit.Record.Offset);
+                        var end = Math.Min(record.End, hit.Record.End);
+                        var ours = record.Data.AsSpan((int)(start - record.Offset), (int)(end - start));
+                        var theirs = hit.Record.Data.AsSpan((int)(start - hit.Record.Offset), (int)(end - start));
+                        if (!ours.SequenceEqual(theirs))
+                            overlaps.Add(new ExeFsPatchOverlap(group.Key, start, end, patch.Source, hit.Patch.Source));
+                    }
+                }
+            }
+        }
+
+        return Coalesce(overlaps);
+    }
+
+    /// <summary>
+    /// Merges the patches of every build ID that has no overlaps into one
+    /// patch; build IDs with overlaps are left out and reported.
+    /// </summary>
+    public static ExeFsPatchMergeResult Merge(IEnumerable<ExeFsPatch> patches, string source = "merged")
+    {
+        var all = patches.ToList();
+        var overlaps = FindOverlaps(all);
+        var conflicted = overlaps.Select(o => o.BuildId).ToHashSet();
+
+        var merged = all
+            .Where(p => !conflicted.Contains(p.BuildId))
+            .GroupBy(p => p.BuildId)
+            .Select(g =>
+            {
+                var records = CoalesceRecords(g.SelectMany(p => p.Records));
+                var format = records.Count > 0 && records[^1].End - 1 > MaxIpsOffset ? ExeFsPatchFormat.Ips32 : ExeFsPatchFormat.Ips;
+                return new ExeFsPatch(g.Key, format, records, source);
+            })
+            .ToList();
+
+        return new ExeFsPatchMergeResult { Patches = merged, Overlaps = overlaps };
+    }
+
+    /// <summary>
+    /// Serializes a patch as IPS, or as IPS32 when its offsets don't fit in
+    /// 24 bits. Records longer than an IPS record allows are split.
+    /// </summary>
+    public static byte[] ToIps(ExeFsPatch patch)
+    {
+        var chunks = new List<(long Offset, ReadOnlyMemory<byte> Data)>();
+        foreach (var record in patch.Records)
+        {
+            for (var i = 0; i < record.Data.Length; i += MaxIpsRecordSize)
+                chunks.Add((record.Offset + i, record.Data.AsMemory(i, Math.Min(MaxIpsRecordSize, record.Data.Length - i))));
+        }
+
+        var wide = patch.Format == ExeFsPatchFormat.Ips32
+            || chunks.Any(c => c.Offset > MaxIpsOffset || c.Offset == IpsFooterOffset);
+
+        using var output = new MemoryStream();
+        output.Write(wide ? "IPS32"u8 : "PATCH"u8);
+
+        Span<byte> header = stackalloc byte[6];
+        foreach (var (offset, data) in chunks)
+        {
+            var offsetSize = wide ? 4 : 3;
+            if (wide)
+                BinaryPrimitives.WriteUInt32BigEndian(header, (uint)offset);
+            else
+            {
+                header[0] = (byte)(offset >> 16);
+                header[1] = (byte)(offset >> 8);
+                header[2] = (byte)offset;
+            }
+
+            BinaryPrimitives.WriteUInt16BigEndian(header[offsetSize..], (ushort)data.Length);
+            output.Write(header[..(offsetSize + 2)]);
+            output.Write(data.Span);
+        }
+
+        output.Write(wide ? "EEOF"u8 : "EOF"u8);
+        return output.ToArray();
+    }
+
+    /// <summary>
+    /// Sorted, non-overlapping records; touching or overlapping records are
+    /// joined, later ones writing over earlier ones.
+    /// </summary>
+    private static List<ExeFsPatchRecord> CoalesceRecords(IEnumerable<ExeFsPatchRecord> records)
+    {
+        var result = new List<ExeFsPatchRecord>();
+        var run = new List<byte>();
+        long runStart = 0;
+
+        foreach (var record in records.OrderBy(r => r.Offset))
+        {
+            if (run.Count > 0 && record.Offset <= runStart + run.Count)
+            {
+                var at = (int)(record.Offset - runStart);
+                for (var i = 0; i < record.Data.Length; i++)
+                {
+                    if (at + i < run.Count)
+                        run[at + i] = record.Data[i];
+                    else
+                        run.Add(record.Data[i]);
+                }
+
+                continue;
+            }
+
+            if (run.Count > 0)
+                result.Add(new ExeFsPatchRecord(runStart, run.ToArray()));
+
+            runStart = record.Offset;
+            run = new List<byte>(record.Data);
+        }
+
+        if (run.Count > 0)
+            result.Add(new ExeFsPatchRecord(runStart, run.ToArray()));
+
+        return result;
+    }
+
+    private static List<ExeFsPatchOverlap> Coalesce(List<ExeFsPatchOverlap> overlaps)
+    {
+        var result = new List<ExeFsPatchOverlap>();
+        foreach (var overlap in overlaps
+                     .OrderBy(o => o.BuildId, StringComparer.Ordinal)
+                     .ThenBy(o => o.FirstSource, StringComparer.Ordinal)
+                     .ThenBy(o => o.SecondSource, StringComparer.Ordinal)
+                     .ThenBy(o => o.Start))
+        {
+            if (result.Count > 0
+                && result[^1] is var last
+                && last.BuildId == overlap.BuildId
+                && last.FirstSource == overlap.FirstSource
+                && last.SecondSource == overlap.SecondSource
+                && overlap.Start <= last.End)
+            {
+                result[^1] = last with { End = Math.Max(last.End, overlap.End) };
+                continue;
+            }
+
+            result.Add(overlap);
+        }
+
+        return result;
+    }
+}
+
+/// <summary>
+/// Bytes [<see cref="Start"/>, <see cref="End"/>) of one NSO that two
+/// patch sources set to different values.
+/// </summary>
+public sealed record ExeFsPatchOverlap(string BuildId, long Start, long End, string FirstSource, string SecondSource);
+
+/// <summary>
+/// Outcome of <see cref="ExeFsPatchMerger.Merge"/>.
+/// </summary>
+public sealed class ExeFsPatchMergeResult
+{
+    /// <summary>One merged patch per build ID without overlaps.</summary>
+    public List<ExeFsPatch> Patches { get; init; } = [];
+
+    /// <summary>Overlaps that kept their build ID from being merged.</summary>
+    public List<ExeFsPatchOverlap> Overlaps { get; init; } = [];
+
+    public bool HasOverlaps => Overlaps.Count > 0;
+}
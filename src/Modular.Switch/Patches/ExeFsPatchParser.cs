@@ -0,0 +1,203 @@
+using System.Buffers.Binary;
+using System.Globalization;
+using System.Text;
+using System.Text.RegularExpressions;
+
+namespace Modular.Switch.Patches;
+
+/// <summary>
+/// Parses exefs patches in IPS, IPS32 and IPSwitch <c>.pchtxt</c> form.
+/// IPS files are named after the build ID they patch; <c>.pchtxt</c> files
+/// name it in an <c>@nsobid-</c> line. Malformed input throws
+/// <see cref="InvalidDataException"/>.
+/// </summary>
+public static class ExeFsPatchParser
+{
+    private static readonly byte[] IpsHeader = "PATCH"u8.ToArray();
+    private static readonly byte[] Ips32Header = "IPS32"u8.ToArray();
+    private static readonly byte[] IpsFooter = "EOF"u8.ToArray();
+    private static readonly byte[] Ips32Footer = "EEOF"u8.ToArray();
+
+    /// <summary>
+    /// Whether a path names a patch file this parser reads.
+    /// </summary>
+    public static bool IsPatchFile(string path) =>
+        path.EndsWith(".ips", StringComparison.OrdinalIgnoreCase)
+        || path.EndsWith(".pchtxt", StringComparison.OrdinalIgnoreCase);
+
+    /// <summary>
+    /// Parses a patch file's contents; <paramref name="fileName"/> decides
+    /// the format and, for IPS, the build ID.
+    /// </summary>
+    public static ExeFsPatch Parse(string fileName, ReadOnlySpan<byte> content, string source)
+    {
+        if (fileName.EndsWith(".pchtxt", StringComparison.OrdinalIgnoreCase))
+            return ParsePchTxt(Encoding.UTF8.GetString(content), source);
+
+        var stem = Path.GetFileNameWithoutExtension(fileName);
+        if (ExeFsPatch.TryNormalizeBuildId(stem) == null)
+            throw new InvalidDataException($"IPS patch is not named after a build ID: {fileName}");
+
+        return ParseIps(stem, content, source);
+    }
+
+    /// <summary>
+    /// Parses an IPS or IPS32 patch, told apart by its header.
+    /// </summary>
+    public static ExeFsPatch ParseIps(string buildId, ReadOnlySpan<byte> content, string source)
+    {
+        bool wide;
+        if (content.StartsWith(Ips32Header))
+            wide = true;
+        else if (content.StartsWith(IpsHeader))
+            wide = false;
+        else
+            throw new InvalidDataException("Not an IPS or IPS32 patch");
+
+        var footer = wide ? Ips32Footer : IpsFooter;
+        var offsetSize = wide ? 4 : 3;
+        var records = new List<ExeFsPatchRecord>();
+        var position = 5;
+
+        while (true)
+        {
+            var rest = content[position..];
+            if (rest.StartsWith(footer) && (rest.Length == footer.Length || rest.Length == footer.Length + 3))
+                break;
+            if (rest.Length < offsetSize + 2)
+                throw new InvalidDataException($"IPS patch truncated at byte {position}");
+
+            long offset = wide
+                ? BinaryPrimitives.ReadUInt32BigEndian(rest)
+                : (rest[0] << 16) | (rest[1] << 8) | rest[2];
+            var size = BinaryPrimitives.ReadUInt16BigEndian(rest[offsetSize..]);
+            position += offsetSize + 2;
+            rest = content[position..];
+
+            if (size > 0)
+            {
+                if (rest.Length < size)
+                    throw new InvalidDataException($"IPS record at 0x{offset:X} runs past the end of the patch");
+
+                records.Add(new ExeFsPatchRecord(offset, rest[..size].ToArray()));
+                position += size;
+            }
+            else
+            {
+                // Run-length record: 16-bit count, then the byte to repeat
+                if (rest.Length < 3)
+                    throw new InvalidDataException($"IPS record at 0x{offset:X} runs past the end of the patch");
+
+                var count = BinaryPrimitives.ReadUInt16BigEndian(rest);
+                var data = new byte[count];
+                Array.Fill(data, rest[2]);
+                records.Add(new ExeFsPatchRecord(offset, data));
+                position += 3;
+            }
+        }
+
+        return new ExeFsPatch(buildId, wide ? ExeFsPatchFormat.Ips32 : ExeFsPatchFormat.Ips, records, source);
+    }
+
+    /// <summary>
+    /// Parses an IPSwitch text patch. Only lines in <c>@enabled</c>
+    /// sections are applied, <c>@flag offset_shift</c> is added to every
+    /// offset, <c>@little-endian</c> reverses hex values and <c>@stop</c>
+    /// ends the patch.
+    /// </summary>
+    public static ExeFsPatch ParsePchTxt(string text, string source)
+    {
+        string? buildId = null;
+        var records = new List<ExeFsPatchRecord>();
+        var enabled = false;
+        var littleEndian = false;
+        long offsetShift = 0;
+        var lineNumber = 0;
+
+        foreach (var rawLine in text.Split('\n'))
+        {
+            lineNumber++;
+            var line = StripComment(rawLine).Trim();
+            if (line.Length == 0 || line.StartsWith('['))
+                continue;
+
+            if (line.StartsWith('@'))
+            {
+                if (line.StartsWith("@nsobid-", StringComparison.OrdinalIgnoreCase))
+                    buildId = line["@nsobid-".Length..].Trim();
+                else if (line.Equals("@enabled", StringComparison.OrdinalIgnoreCase))
+                    enabled = true;
+                else if (line.Equals("@disabled", StringComparison.OrdinalIgnoreCase))
+                    enabled = false;
+                else if (line.Equals("@little-endian", StringComparison.OrdinalIgnoreCase))
+                    littleEndian = true;
+                else if (line.Equals("@big-endian", StringComparison.OrdinalIgnoreCase))
+                    littleEndian = false;
+                else if (line.Equals("@stop", StringComparison.OrdinalIgnoreCase))
+                    break;
+                else if (line.StartsWith("@flag", StringComparison.OrdinalIgnoreCase))
+                    offsetShift = ParseFlag(line, offsetShift, lineNumber);
+                continue;
+            }
+
+            if (!enabled)
+                continue;
+
+            var split = line.IndexOfAny([' ', '\t']);
+            if (split < 0 || !long.TryParse(line[..split], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out var offset))
+                throw new InvalidDataException($"pchtxt line {lineNumber}: expected '<hex offset> <value>'");
+
+            var data = ParseValue(line[split..].Trim(), littleEndian, lineNumber);
+            if (data.Length > 0)
+                records.Add(new ExeFsPatchRecord(offset + offsetShift, data));
+        }
+
+        if (buildId == null || ExeFsPatch.TryNormalizeBuildId(buildId) == null)
+            throw new InvalidDataException("pchtxt patch has no valid @nsobid line");
+
+        return new ExeFsPatch(buildId, ExeFsPatchFormat.PchTxt, records, source);
+    }
+
+    private static long ParseFlag(string line, long offsetShift, int lineNumber)
+    {
+        var parts = line.Split([' ', '\t'], StringSplitOptions.RemoveEmptyEntries);
+        if (parts.Length < 3 || !parts[1].Equals("offset_shift", StringComparison.OrdinalIgnoreCase))
+            return offsetShift;
+
+        var value = parts[2];
+        var parsed = value.StartsWith("0x", StringComparison.OrdinalIgnoreCase)
+            ? long.TryParse(value[2..], NumberStyles.HexNumber, CultureInfo.InvariantCulture, out var shift)
+            : long.TryParse(value, NumberStyles.Integer, CultureInfo.InvariantCulture, out shift);
+
+        return parsed ? shift : throw new InvalidDataException($"pchtxt line {lineNumber}: bad offset_shift '{value}'");
+    }
+
+    private static byte[] ParseValue(string value, bool littleEndian, int lineNumber)
+    {
+        if (value.StartsWith('"'))
+        {
+            var end = value.LastIndexOf('"');
+            if (end <= 0)
+                throw new InvalidDataException($"pchtxt line {lineNumber}: unterminated string");
+
+            return Encoding.UTF8.GetBytes(Regex.Unescape(value[1..end]));
+        }
+
+        var hex = value.Split([' ', '\t'], 2)[0];
+        if (hex.Length % 2 != 0 || !hex.All(Uri.IsHexDigit))
+            throw new InvalidDataException($"pchtxt line {lineNumber}: bad hex value '{hex}'");
+
+        var data = Convert.FromHexString(hex);
+        if (littleEndian)
+            Array.Reverse(data);
+        return data;
+    }
+
+    private static string StripComment(string line)
+    {
+        // Comments can't start inside a quoted string value
+        var quote = line.IndexOf('"');
+        var comment = line.IndexOf("//", StringComparison.Ordinal);
+        return comment >= 0 && (quote < 0 || comment < quote) ? line[..comment] : line;
+    }
+}
@@ -0,0 +1,66 @@
+namespace Modular.Switch.Patches;
+
+/// <summary>
+/// Static interval tree over half-open byte ranges. Intervals are sorted by
+/// start and the sorted array is read as a balanced binary search tree,
+/// each node storing the largest end in its subtree, so a query costs
+/// O(log n + k) for k results.
+/// </summary>
+public sealed class PatchIntervalTree<T>
+{
+    private readonly (long Start, long End, T Value)[] _intervals;
+    private readonly long[] _maxEnd;
+
+    public PatchIntervalTree(IEnumerable<(long Start, long End, T Value)> intervals)
+    {
+        _intervals = intervals.Where(i => i.End > i.Start).OrderBy(i => i.Start).ToArray();
+        _maxEnd = new long[_intervals.Length];
+        Build(0, _intervals.Length);
+    }
+
+    public int Count => _intervals.Length;
+
+    /// <summary>
+    /// Intervals that share at least one byte with [start, end).
+    /// </summary>
+    public List<(long Start, long End, T Value)> Query(long start, long end)
+    {
+        var results = new List<(long Start, long End, T Value)>();
+        if (end > start)
+            Query(0, _intervals.Length, start, end, results);
+        return results;
+    }
+
+    private long Build(int low, int high)
+    {
+        if (low >= high)
+            return long.MinValue;
+
+        var mid = low + (high - low) / 2;
+        var maxEnd = Math.Max(_intervals[mid].End, Math.Max(Build(low, mid), Build(mid + 1, high)));
+        _maxEnd[mid] = maxEnd;
+        return maxEnd;
+    }
+
+    private void Query(int low, int high, long start, long end, List<(long Start, long End, T Value)> results)
+    {
+        if (low >= high)
+            return;
+
+        var mid = low + (high - low) / 2;
+        if (_maxEnd[mid] <= start)
+            return;
+
+        Query(low, mid, start, end, results);
+
+        // Everything to the right starts at or after this node
+        var interval = _intervals[mid];
+        if (interval.Start >= end)
+            return;
+
+        if (interval.End > start)
+            results.Add(interval);
+
+        Query(mid + 1, high, start, end, results);
+    }
+}
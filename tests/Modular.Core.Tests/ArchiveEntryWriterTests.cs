@@ -0,0 +1,121 @@
+using System.IO.Compression;
+using System.Security.Cryptography;
+using Modular.Core.Archives;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class ArchiveEntryWriterTests : IDisposable
+{
+    private readonly string _testDir;
+
+    public ArchiveEntryWriterTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_writer_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Theory]
+    [InlineData(0)]
+    [InlineData(1000)]
+    [InlineData(ArchiveEntryWriter.SmallFileThreshold)]
+    [InlineData(3 * 1024 * 1024 + 17)]
+    public async Task Write_ProducesExactContent(int size)
+    {
+        var data = RandomBytes(size);
+        var path = Path.Combine(_testDir, "out.bin");
+
+        await ArchiveEntryWriter.WriteAsync(new MemoryStream(data), path, size, overwrite: false);
+
+        Assert.Equal(data, await File.ReadAllBytesAsync(path));
+    }
+
+    [Fact]
+    public async Task Write_LargeEntryWithZeroRuns_ReadsBackIdentical()
+    {
+        // Zero runs at the start, in the middle (unaligned) and at the end
+        var size = (int)ArchiveEntryWriter.LargeFileThreshold + 5 * 1024 * 1024 + 123;
+        var data = RandomBytes(size);
+        Array.Clear(data, 0, 3 * 1024 * 1024);
+        Array.Clear(data, 20 * 1024 * 1024 + 999, 10 * 1024 * 1024);
+        Array.Clear(data, size - 2 * 1024 * 1024, 2 * 1024 * 1024);
+        var path = Path.Combine(_testDir, "large.bin");
+
+        await ArchiveEntryWriter.WriteAsync(new MemoryStream(data), path, size, overwrite: false);
+
+        Assert.Equal(size, new FileInfo(path).Length);
+        Assert.Equal(SHA256.HashData(data), SHA256.HashData(await File.ReadAllBytesAsync(path)));
+    }
+
+    [Fact]
+    public async Task Write_WrongOrUnknownLength_WritesWhatTheStreamYields()
+    {
+        var data = RandomBytes(300 * 1024);
+        var understated = Path.Combine(_testDir, "understated.bin");
+        var unknown = Path.Combine(_testDir, "unknown.bin");
+
+        await ArchiveEntryWriter.WriteAsync(new MemoryStream(data), understated, 10, overwrite: false);
+        await ArchiveEntryWriter.WriteAsync(new MemoryStream(data), unknown, -1, overwrite: false);
+
+        Assert.Equal(data, await File.ReadAllBytesAsync(understated));
+        Assert.Equal(data, await File.ReadAllBytesAsync(unknown));
+    }
+
+    [Fact]
+    public async Task Write_ExistingFileWithoutOverwrite_Throws()
+    {
+        var path = Path.Combine(_testDir, "exists.bin");
+        await File.WriteAllTextAsync(path, "keep");
+
+        await Assert.ThrowsAsync<IOException>(() =>
+            ArchiveEntryWriter.WriteAsync(new MemoryStream(RandomBytes(10)), path, 10, overwrite: false));
+        Assert.Equal("keep", await File.ReadAllTextAsync(path));
+    }
+
+    [Fact]
+    public async Task ExtractAll_BatchesSmallFilesAndKeepsTimestamps()
+    {
+        var archivePath = Path.Combine(_testDir, "mod.zip");
+        var contents = new Dictionary<string, byte[]>();
+        var stamp = new DateTimeOffset(2020, 5, 17, 12, 30, 0, TimeSpan.Zero);
+
+        using (var zip = ZipFile.Open(archivePath, ZipArchiveMode.Create))
+        {
+            for (var i = 0; i < 300; i++)
+                contents[$"Data/small/{i}.txt"] = RandomBytes(i * 7);
+            contents["Data/medium.pak"] = RandomBytes(2 * 1024 * 1024);
+
+            foreach (var (name, bytes) in contents)
+            {
+                var entry = zip.CreateEntry(name, CompressionLevel.Fastest);
+                entry.LastWriteTime = stamp;
+                await using var stream = entry.Open();
+                await stream.WriteAsync(bytes);
+            }
+        }
+
+        var destination = Path.Combine(_testDir, "out");
+        using var reader = new ZipArchiveReader(archivePath);
+        await reader.ExtractAllAsync(destination);
+
+        foreach (var entry in reader.Entries)
+        {
+            var path = Path.Combine(destination, entry.FullName);
+            Assert.Equal(contents[entry.FullName], await File.ReadAllBytesAsync(path));
+            Assert.Equal(entry.LastWriteTime!.Value.UtcDateTime, File.GetLastWriteTimeUtc(path));
+        }
+    }
+
+    private static byte[] RandomBytes(int size)
+    {
+        var data = new byte[size];
+        new Random(size).NextBytes(data);
+        return data;
+    }
+}
@@ -0,0 +1,113 @@
+using System.IO.Compression;
+using System.Security.Cryptography;
+using FluentAssertions;
+using Microsoft.Data.Sqlite;
+using Modular.Core.Archives;
+using Modular.Core.Database;
+using Modular.Core.Exceptions;
+using Modular.Core.Utilities;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class ArchiveIngestionServiceTests : IDisposable
+{
+    private readonly string _root;
+    private readonly string _library;
+
+    public ArchiveIngestionServiceTests()
+    {
+        _root = Path.Combine(Path.GetTempPath(), $"modular_ingest_{Guid.NewGuid():N}");
+        _library = Path.Combine(_root, "library");
+        Directory.CreateDirectory(_root);
+    }
+
+    public void Dispose()
+    {
+        SqliteConnection.ClearAllPools();
+        if (Directory.Exists(_root))
+            Directory.Delete(_root, true);
+    }
+
+    [Fact]
+    public async Task IngestAsync_MoveWithinFilesystem_RenamesWithoutCopying()
+    {
+        var source = CreateZip("download.zip");
+        FileStat.TryGet(source, out var before);
+        var destination = Path.Combine(_library, "skyrim", "mod.zip");
+
+        var result = await new ArchiveIngestionService().IngestAsync(source, destination, new IngestOptions { Move = true });
+
+        File.Exists(source).Should().BeFalse();
+        FileStat.TryGet(destination, out var after).Should().BeTrue();
+        if (OperatingSystem.IsLinux())
+        {
+            result.Method.Should().Be(IngestMethod.Rename);
+            after.Inode.Should().Be(before.Inode);
+        }
+    }
+
+    [Fact]
+    public async Task IngestAsync_Copy_KeepsSourceAndHashesStreamedData()
+    {
+        var source = CreateZip("dropped.zip");
+        var destination = Path.Combine(_library, "dropped.zip");
+
+        var result = await new ArchiveIngestionService().IngestAsync(source, destination);
+
+        File.Exists(source).Should().BeTrue();
+        File.ReadAllBytes(destination).Should().Equal(File.ReadAllBytes(source));
+        File.GetLastWriteTimeUtc(destination).Should().Be(File.GetLastWriteTimeUtc(source));
+        Directory.GetFiles(_library).Should().ContainSingle("no temp file may be left behind");
+
+        // Reflinks never read the data, so only a streamed copy carries a hash
+        result.Method.Should().BeOneOf(IngestMethod.Reflink, IngestMethod.Copy);
+        if (result.Method == IngestMethod.Copy)
+            result.Sha256.Should().Be(Convert.ToHexString(SHA256.HashData(File.ReadAllBytes(source))).ToLowerInvariant());
+        else
+            result.Sha256.Should().BeNull();
+    }
+
+    [Fact]
+    public async Task IngestAsync_ExistingDestination_Throws()
+    {
+        var source = CreateZip("a.zip");
+        var destination = Path.Combine(_library, "a.zip");
+        Directory.CreateDirectory(_library);
+        File.WriteAllText(destination, "existing");
+
+        var act = () => new ArchiveIngestionService().IngestAsync(source, destination);
+
+        await act.Should().ThrowAsync<FileSystemException>();
+        File.ReadAllText(destination).Should().Be("existing");
+    }
+
+    [Fact]
+    public async Task IngestAsync_RegistersInventoryInSamePass()
+    {
+        var db = new ModularDatabase(Path.Combine(_root, "modular.db"));
+        await db.InitializeAsync();
+        var inventory = new ArchiveInventoryService(db);
+        var source = CreateZip("inventoried.zip");
+        var destination = Path.Combine(_library, "inventoried.zip");
+
+        var result = await new ArchiveIngestionService(inventory).IngestAsync(source, destination, new IngestOptions { Move = true });
+
+        result.Entries.Should().HaveCount(2);
+        (await inventory.GetInventoryAsync(destination)).Should().HaveCount(2);
+        await db.DisposeAsync();
+    }
+
+    private string CreateZip(string name)
+    {
+        var path = Path.Combine(_root, name);
+        using var archive = ZipFile.Open(path, ZipArchiveMode.Create);
+        foreach (var entry in new[] { "data/a.txt", "data/b.txt" })
+        {
+            using var writer = new StreamWriter(archive.CreateEntry(entry).Open());
+            writer.Write(string.Concat(Enumerable.Repeat(entry, 1000)));
+        }
+
+        return path;
+    }
+}
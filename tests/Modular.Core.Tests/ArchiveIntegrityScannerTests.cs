@@ -0,0 +1,191 @@
+using System.IO.Compression;
+using System.Security.Cryptography;
+using System.Text;
+using FluentAssertions;
+using Microsoft.Data.Sqlite;
+using Modular.Core.Archives;
+using Modular.Core.Database;
+using Modular.Core.Utilities;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class ArchiveIntegrityScannerTests : IDisposable
+{
+    private readonly string _root;
+    private readonly string _library;
+
+    public ArchiveIntegrityScannerTests()
+    {
+        _root = Path.Combine(Path.GetTempPath(), $"modular_integrity_{Guid.NewGuid():N}");
+        _library = Path.Combine(_root, "downloads");
+        Directory.CreateDirectory(_library);
+    }
+
+    public void Dispose()
+    {
+        SqliteConnection.ClearAllPools();
+        if (Directory.Exists(_root))
+            Directory.Delete(_root, true);
+    }
+
+    [Fact]
+    public void Check_ValidZip_IsOk()
+    {
+        var path = CreateZip("good.zip", CompressionLevel.Optimal);
+
+        var check = ArchiveIntegrityChecker.Check(path);
+
+        check.Status.Should().Be(ArchiveIntegrityStatus.Ok);
+        check.Format.Should().Be("zip");
+        check.EntryCount.Should().Be(2);
+    }
+
+    [Fact]
+    public void Check_TruncatedZip_IsTruncated()
+    {
+        var path = CreateZip("partial.zip", CompressionLevel.Optimal);
+        var bytes = File.ReadAllBytes(path);
+        File.WriteAllBytes(path, bytes[..(bytes.Length / 2)]);
+
+        ArchiveIntegrityChecker.Check(path).Status.Should().Be(ArchiveIntegrityStatus.Truncated);
+    }
+
+    [Fact]
+    public void Check_FlippedByteInStoredEntry_FailsCrc()
+    {
+        var path = CreateZip("rot.zip", CompressionLevel.NoCompression);
+        var bytes = File.ReadAllBytes(path);
+        var marker = Encoding.ASCII.GetBytes("MARKER");
+        var index = bytes.AsSpan().IndexOf(marker);
+        bytes[index] ^= 0x20;
+        File.WriteAllBytes(path, bytes);
+
+        var deep = ArchiveIntegrityChecker.Check(path, deep: true);
+        deep.Status.Should().Be(ArchiveIntegrityStatus.Corrupt);
+        deep.Detail.Should().Contain("CRC mismatch");
+
+        // Headers are intact, so a quick check can't see bit-rot inside entry data
+        ArchiveIntegrityChecker.Check(path, deep: false).Status.Should().Be(ArchiveIntegrityStatus.Ok);
+    }
+
+    [Fact]
+    public void Check_SevenZipWithMissingHeader_IsTruncated()
+    {
+        // Valid signature header pointing past the end of the file
+        var header = new byte[32];
+        new byte[] { 0x37, 0x7A, 0xBC, 0xAF, 0x27, 0x1C, 0x00, 0x04 }.CopyTo(header, 0);
+        BitConverter.GetBytes(1000UL).CopyTo(header, 12);
+        BitConverter.GetBytes(64UL).CopyTo(header, 20);
+        BitConverter.GetBytes(Crc32.Compute(header.AsSpan(12, 20))).CopyTo(header, 8);
+
+        var path = Path.Combine(_library, "cut.7z");
+        File.WriteAllBytes(path, header);
+
+        ArchiveIntegrityChecker.Check(path, deep: false).Status.Should().Be(ArchiveIntegrityStatus.Truncated);
+    }
+
+    [Fact]
+    public void Check_RarWithoutEndBlock_IsTruncated()
+    {
+        var path = Path.Combine(_library, "cut.rar");
+        File.WriteAllBytes(path, [0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x01, 0x00, 1, 2, 3, 4, 5, 6, 7, 8]);
+
+        ArchiveIntegrityChecker.Check(path, deep: false).Status.Should().Be(ArchiveIntegrityStatus.Truncated);
+    }
+
+    [Fact]
+    public async Task ScanAsync_RecordsResultsAndSkipsUnchangedFiles()
+    {
+        await using var db = await OpenDatabaseAsync();
+        var good = CreateZip(Path.Combine("skyrim", "100", "good.zip"), CompressionLevel.Optimal);
+        var bad = CreateZip(Path.Combine("skyrim", "200", "bad.zip"), CompressionLevel.Optimal);
+        File.WriteAllBytes(bad, File.ReadAllBytes(bad)[..40]);
+        var scanner = new ArchiveIntegrityScanner(db);
+
+        var first = await scanner.ScanAsync(_library);
+
+        first.CheckedCount.Should().Be(2);
+        first.Problems.Should().ContainSingle().Which.Path.Should().Be(bad);
+
+        var second = await scanner.ScanAsync(_library);
+
+        second.CheckedCount.Should().Be(0);
+        second.CachedCount.Should().Be(2);
+        second.Results.Should().OnlyContain(r => r.FromCache);
+
+        // Rewriting a file changes its stamp and triggers a re-check of that file only
+        CreateZip(Path.Combine("skyrim", "200", "bad.zip"), CompressionLevel.Optimal);
+        File.SetLastWriteTimeUtc(bad, DateTime.UtcNow.AddMinutes(1));
+
+        var third = await scanner.ScanAsync(_library);
+
+        third.CheckedCount.Should().Be(1);
+        third.Problems.Should().BeEmpty();
+        (await scanner.GetResultsAsync(_library)).Select(r => r.Path).Should().BeEquivalentTo(new[] { good, bad });
+    }
+
+    [Fact]
+    public async Task ScanAsync_KnownChecksum_DetectsMismatch()
+    {
+        await using var db = await OpenDatabaseAsync();
+        var path = CreateZip("mod.zip", CompressionLevel.Optimal);
+        var scanner = new ArchiveIntegrityScanner(db);
+
+        var matching = new ArchiveChecksumIndex();
+        matching.Add(path, Convert.ToHexString(MD5.HashData(File.ReadAllBytes(path))));
+        var report = await scanner.ScanAsync(_library, new ArchiveScanOptions { Checksums = matching });
+        report.Results.Single().ChecksumVerified.Should().BeTrue();
+
+        // A different expected checksum invalidates the cached result
+        var wrong = new ArchiveChecksumIndex();
+        wrong.Add(path, new string('0', 32));
+        report = await scanner.ScanAsync(_library, new ArchiveScanOptions { Checksums = wrong });
+
+        report.CheckedCount.Should().Be(1);
+        report.Results.Single().Status.Should().Be(ArchiveIntegrityStatus.ChecksumMismatch);
+    }
+
+    [Fact]
+    public async Task ScanAsync_DeletedFile_IsDroppedFromResults()
+    {
+        await using var db = await OpenDatabaseAsync();
+        var path = CreateZip("gone.zip", CompressionLevel.Optimal);
+        var scanner = new ArchiveIntegrityScanner(db);
+        await scanner.ScanAsync(_library);
+
+        File.Delete(path);
+        await scanner.ScanAsync(_library);
+
+        (await scanner.GetResultsAsync(_library)).Should().BeEmpty();
+    }
+
+    private async Task<ModularDatabase> OpenDatabaseAsync()
+    {
+        var db = new ModularDatabase(Path.Combine(_root, "modular.db"));
+        await db.InitializeAsync();
+        return db;
+    }
+
+    private string CreateZip(string relativePath, CompressionLevel level)
+    {
+        var path = Path.Combine(_library, relativePath);
+        Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+        if (File.Exists(path))
+            File.Delete(path);
+
+        using (var archive = ZipFile.Open(path, ZipArchiveMode.Create))
+        {
+            WriteEntry(archive, "data/readme.txt", "MARKER " + string.Concat(Enumerable.Repeat("mod content ", 500)), level);
+            WriteEntry(archive, "data/plugin.esp", "plugin", level);
+        }
+
+        return path;
+    }
+
+    private static void WriteEntry(ZipArchive archive, string name, string content, CompressionLevel level)
+    {
+        using var writer = new StreamWriter(archive.CreateEntry(name, level).Open());
+        writer.Write(content);
+    }
+}
@@ -0,0 +1,340 @@
+using System.Collections.Concurrent;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Text.Json;
+using System.Text.RegularExpressions;
+using Modular.Core.Backends.NexusMods;
+using Modular.Core.Configuration;
+using Modular.Core.Database;
+using Modular.Core.Dependencies;
+using Modular.Core.RateLimiting;
+using Modular.Core.Versioning;
+using Xunit;
+
+namespace Modular.Core.Tests.Backends;
+
+/// <summary>
+/// Runs metadata reads against a local fake of the Nexus GraphQL endpoint and
+/// checks how they are coalesced into requests.
+/// </summary>
+public class NexusGraphQlBatchingTests : IDisposable
+{
+    private const string Domain = "skyrim";
+
+    private readonly string _root;
+    private readonly FakeGraphQlServer _server = new();
+    private readonly DownloadDatabase _database;
+    private readonly ModMetadataCache _metadataCache;
+
+    public NexusGraphQlBatchingTests()
+    {
+        _root = Path.Combine(Path.GetTempPath(), $"modular_graphql_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_root);
+        _database = new DownloadDatabase(Path.Combine(_root, "downloads.json"));
+        _metadataCache = new ModMetadataCache(Path.Combine(_root, "metadata.json"));
+    }
+
+    public void Dispose()
+    {
+        _server.Dispose();
+        if (Directory.Exists(_root))
+            Directory.Delete(_root, true);
+    }
+
+    [Fact]
+    public async Task ConcurrentModInfo_IsOneRequest()
+    {
+        var backend = CreateBackend();
+
+        var mods = await Task.WhenAll(Enumerable.Range(1, 50).Select(id => backend.GetModInfoAsync(id.ToString(), Domain)));
+
+        Assert.Equal(1, _server.GraphQlRequests);
+        Assert.Equal(Enumerable.Range(1, 50).Select(id => $"Mod {id}"), mods.Select(m => m!.Name));
+
+        // 50 mods in pages of 20, each page an aliased selection
+        var query = Assert.Single(_server.Queries);
+        Assert.Equal(3, query.Aliases.Count);
+        Assert.Contains("s0: mods(filter: $s0, count: 20)", query.Text);
+        Assert.DoesNotContain("modRequirements", query.Text);
+    }
+
+    [Fact]
+    public async Task DuplicateLoads_AreFetchedOnce()
+    {
+        var backend = CreateBackend();
+
+        var mods = await Task.WhenAll(Enumerable.Range(0, 10).Select(_ => backend.GetModInfoAsync("7", Domain)));
+
+        Assert.All(mods, m => Assert.Equal("Mod 7", m!.Name));
+        var query = Assert.Single(_server.Queries);
+        Assert.Equal(new[] { 7 }, query.ModIds);
+    }
+
+    [Fact]
+    public async Task MissingMod_IsNullWithoutFailingOthers()
+    {
+        _server.Missing.Add(3);
+        var backend = CreateBackend();
+
+        var infos = await Task.WhenAll(backend.GetModInfoAsync("2", Domain), backend.GetModInfoAsync("3", Domain));
+        var files = await Task.WhenAll(
+            backend.GetModFilesBatchedAsync("2", Domain),
+            backend.GetModFilesBatchedAsync("3", Domain));
+
+        Assert.Equal("Mod 2", infos[0]!.Name);
+        Assert.Null(infos[1]);
+        Assert.Equal("1.2.0", Assert.Single(files[0]).Version);
+        Assert.Empty(files[1]);
+        Assert.Equal(2, _server.GraphQlRequests);
+    }
+
+    [Fact]
+    public async Task DuplicateNodesInResponse_DoNotFailTheBatch()
+    {
+        _server.Duplicated.Add(4);
+        var backend = CreateBackend();
+
+        var infos = await Task.WhenAll(backend.GetModInfoAsync("4", Domain), backend.GetModInfoAsync("5", Domain));
+
+        Assert.Equal("Mod 4", infos[0]!.Name);
+        Assert.Equal("Mod 5", infos[1]!.Name);
+        Assert.Equal(1, _server.GraphQlRequests);
+    }
+
+    [Fact]
+    public async Task RecentlyUpdated_FetchesDetailsInOneRequest()
+    {
+        _server.Updated.AddRange(Enumerable.Range(1, 60));
+        var backend = CreateBackend();
+
+        var mods = await backend.GetRecentlyUpdatedModsAsync(Domain);
+
+        Assert.Equal(60, mods.Count);
+        Assert.Equal(1, _server.Count("updated.json"));
+        Assert.Equal(1, _server.GraphQlRequests);
+    }
+
+    [Fact]
+    public async Task Requirements_AreReturnedAsDependencies()
+    {
+        _server.Requirements[5] = [9, 10];
+        var provider = new NexusModsVersionProvider(CreateBackend(), Domain);
+
+        var deps = await provider.GetDependenciesAsync("nexusmods:5", new SemanticVersion(1, 2, 0));
+
+        Assert.Equal(new[] { "skyrim:9", "skyrim:10" }, deps.Select(d => d.Target.ProjectId));
+        Assert.All(deps, d => Assert.Equal("nexusmods", d.Target.BackendId));
+        Assert.Contains("modRequirements", Assert.Single(_server.Queries).Text);
+    }
+
+    [Fact]
+    public async Task DataVersions_FollowUpdatedAtInOneRequest()
+    {
+        _server.Missing.Add(7);
+        _server.UpdatedAt[6] = "2026-03-01T12:00:00Z";
+        var ids = new[] { "nexusmods:5", $"nexusmods:{Domain}:6", "nexusmods:7" };
+
+        var before = await new NexusModsVersionProvider(CreateBackend(), Domain).GetDataVersionsAsync(ids);
+        _server.UpdatedAt[6] = "2026-03-02T08:30:00Z";
+        var after = await new NexusModsVersionProvider(CreateBackend(), Domain).GetDataVersionsAsync(ids);
+
+        Assert.Equal(["nexusmods:5", $"nexusmods:{Domain}:6"], before.Keys.Order());
+        Assert.Equal(before["nexusmods:5"], after["nexusmods:5"]);
+        Assert.NotEqual(before[$"nexusmods:{Domain}:6"], after[$"nexusmods:{Domain}:6"]);
+        Assert.Equal(2, _server.GraphQlRequests);
+        Assert.All(_server.Queries, q => Assert.DoesNotContain("modFiles", q.Text));
+    }
+
+    [Fact]
+    public async Task DependencyResolution_Over400Mods_TakesAHandfulOfRequests()
+    {
+        // 400 mods, each requiring one of 10 shared libraries
+        for (var id = 1; id <= 400; id++)
+            _server.Requirements[id] = [1000 + id % 10];
+
+        var provider = new NexusModsVersionProvider(CreateBackend(), Domain);
+        var resolver = new GreedyDependencyResolver(provider);
+        var roots = Enumerable.Range(1, 400).Select(id => ($"nexusmods:{Domain}:{id}", (VersionRange?)null)).ToList();
+
+        var result = await resolver.ResolveAsync(roots);
+
+        Assert.True(result.Success, result.FailureReason);
+        Assert.Equal(410, result.ResolvedVersions.Count);
+
+        // One level of roots, one of libraries: 820 lookups
+        Assert.InRange(_server.GraphQlRequests, 2, 6);
+        Assert.Equal(1, _server.Count($"/v1/games/{Domain}.json"));
+    }
+
+    private NexusModsBackend CreateBackend() =>
+        new(new AppSettings { NexusApiKey = "test-key" }, new NexusRateLimiter(), _database, _metadataCache, _server.BaseUrl);
+
+    /// <summary>
+    /// Answers the batched queries the backend sends: aliased <c>mods</c>
+    /// pages and <c>modFiles</c> lists, plus the v1 game and updated-mods
+    /// endpoints. Records every query for assertions about its shape.
+    /// </summary>
+    private sealed class FakeGraphQlServer : IDisposable
+    {
+        private static readonly Regex AliasPattern = new(@"(s\d+): (mods|modFiles)\(", RegexOptions.Compiled);
+
+        private readonly HttpListener _listener = new();
+        private readonly ConcurrentQueue<string> _log = new();
+        private readonly ConcurrentQueue<RecordedQuery> _queries = new();
+
+        public FakeGraphQlServer()
+        {
+            var port = FreePort();
+            BaseUrl = $"http://127.0.0.1:{port}";
+            _listener.Prefixes.Add(BaseUrl + "/");
+            _listener.Start();
+            _ = Task.Run(ServeAsync);
+        }
+
+        public string BaseUrl { get; }
+
+        public HashSet<int> Missing { get; } = [];
+        public HashSet<int> Duplicated { get; } = [];
+        public Dictionary<int, int[]> Requirements { get; } = [];
+        public Dictionary<int, string> UpdatedAt { get; } = [];
+        public List<int> Updated { get; } = [];
+
+        public IReadOnlyList<RecordedQuery> Queries => _queries.ToList();
+
+        public int GraphQlRequests => _queries.Count;
+
+        public int Count(string fragment) => _log.Count(p => p.Contains(fragment));
+
+        private async Task ServeAsync()
+        {
+            while (_listener.IsListening)
+            {
+                HttpListenerContext context;
+                try
+                {
+                    context = await _listener.GetContextAsync();
+                }
+                catch (Exception ex) when (ex is HttpListenerException or ObjectDisposedException)
+                {
+                    return;
+                }
+
+                var path = context.Request.Url!.AbsolutePath;
+                _log.Enqueue(path);
+
+                string body;
+                using (var reader = new StreamReader(context.Request.InputStream))
+                    body = await reader.ReadToEndAsync();
+
+                var (status, response) = path switch
+                {
+                    "/v2/graphql" => (200, Answer(body)),
+                    $"/v1/games/{Domain}.json" => (200, Json(new { id = 110, domain_name = Domain })),
+                    $"/v1/games/{Domain}/mods/updated.json" => (200, Json(Updated.Select(id => new
+                    {
+                        mod_id = id,
+                        latest_file_update = 1_700_000_000,
+                        latest_mod_activity = 1_700_000_000
+                    }))),
+                    _ => (404, "{}")
+                };
+
+                var bytes = Encoding.UTF8.GetBytes(response);
+                context.Response.StatusCode = status;
+                context.Response.ContentType = "application/json";
+                await context.Response.OutputStream.WriteAsync(bytes);
+                context.Response.Close();
+            }
+        }
+
+        private string Answer(string body)
+        {
+            using var request = JsonDocument.Parse(body);
+            var text = request.RootElement.GetProperty("query").GetString()!;
+            var variables = request.RootElement.GetProperty("variables");
+
+            var data = new Dictionary<string, object?>();
+            var errors = new List<object>();
+            var aliases = new List<string>();
+            var modIds = new List<int>();
+
+            foreach (Match match in AliasPattern.Matches(text))
+            {
+                var alias = match.Groups[1].Value;
+                aliases.Add(alias);
+
+                if (match.Groups[2].Value == "modFiles")
+                {
+                    var modId = int.Parse(variables.GetProperty(alias + "m").GetString()!);
+                    modIds.Add(modId);
+                    if (Missing.Contains(modId))
+                    {
+                        data[alias] = null;
+                        errors.Add(new { message = $"Mod {modId} not found", path = new[] { alias } });
+                        continue;
+                    }
+
+                    data[alias] = new[]
+                    {
+                        new { fileId = modId * 10, name = "Main", uri = $"mod-{modId}.zip", version = "1.2.0", category = "MAIN", date = 1_700_000_000, sizeInBytes = "1024" },
+                        new { fileId = modId * 10 + 1, name = "Old", uri = $"mod-{modId}-old.zip", version = "1.0.0", category = "OLD_VERSION", date = 1_600_000_000, sizeInBytes = "1024" }
+                    };
+                    continue;
+                }
+
+                var ids = variables.GetProperty(alias).GetProperty("modId").EnumerateArray()
+                    .Select(v => v.GetProperty("value").GetInt32()).ToList();
+                modIds.AddRange(ids);
+                var withRequirements = text.Contains("modRequirements");
+
+                data[alias] = new
+                {
+                    nodes = ids.Where(id => !Missing.Contains(id)).SelectMany(Repeat).Select(id => new
+                    {
+                        modId = id,
+                        name = $"Mod {id}",
+                        version = "1.2.0",
+                        updatedAt = UpdatedAt.GetValueOrDefault(id, "2026-01-01T00:00:00Z"),
+                        game = new { domainName = Domain },
+                        modRequirements = withRequirements
+                            ? new
+                            {
+                                nexusRequirements = new
+                                {
+                                    nodes = Requirements.GetValueOrDefault(id, []).Select(r => new
+                                    {
+                                        modId = r.ToString(),
+                                        modName = $"Mod {r}",
+                                        url = $"https://www.nexusmods.com/{Domain}/mods/{r}",
+                                        externalRequirement = false
+                                    })
+                                }
+                            }
+                            : null
+                    })
+                };
+            }
+
+            _queries.Enqueue(new RecordedQuery(text, aliases, modIds));
+            return errors.Count > 0 ? Json(new { data, errors }) : Json(new { data });
+        }
+
+        private int[] Repeat(int id) => Duplicated.Contains(id) ? [id, id] : [id];
+
+        private static string Json(object value) => JsonSerializer.Serialize(value);
+
+        private static int FreePort()
+        {
+            var socket = new TcpListener(IPAddress.Loopback, 0);
+            socket.Start();
+            var port = ((IPEndPoint)socket.LocalEndpoint).Port;
+            socket.Stop();
+            return port;
+        }
+
+        public void Dispose() => _listener.Close();
+    }
+
+    private sealed record RecordedQuery(string Text, List<string> Aliases, List<int> ModIds);
+}
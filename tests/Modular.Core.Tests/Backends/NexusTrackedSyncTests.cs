@@ -0,0 +1,263 @@
+using System.Collections.Concurrent;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Text.Json;
+using Modular.Core.Backends.NexusMods;
+using Modular.Core.Configuration;
+using Modular.Core.Database;
+using Modular.Core.RateLimiting;
+using Modular.Sdk.Backends;
+using Xunit;
+
+namespace Modular.Core.Tests.Backends;
+
+/// <summary>
+/// Runs tracked-mod syncs against a local fake of the Nexus v1 API and counts
+/// the API requests each one makes.
+/// </summary>
+public class NexusTrackedSyncTests : IDisposable
+{
+    private const string Domain = "skyrim";
+
+    private readonly string _root;
+    private readonly FakeNexusServer _server;
+    private readonly DownloadDatabase _database;
+    private readonly ModMetadataCache _metadataCache;
+
+    public NexusTrackedSyncTests()
+    {
+        _root = Path.Combine(Path.GetTempPath(), $"modular_sync_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_root);
+        _server = new FakeNexusServer();
+        _database = new DownloadDatabase(Path.Combine(_root, "downloads.json"));
+        _metadataCache = new ModMetadataCache(Path.Combine(_root, "metadata.json"));
+
+        var lastWeek = DateTimeOffset.UtcNow.AddDays(-7).ToUnixTimeSeconds();
+        for (var modId = 1; modId <= 20; modId++)
+            _server.AddFile(modId, modId * 100, lastWeek);
+    }
+
+    public void Dispose()
+    {
+        _server.Dispose();
+        if (Directory.Exists(_root))
+            Directory.Delete(_root, true);
+    }
+
+    [Fact]
+    public async Task Resync_WithNoChanges_CostsTwoApiCalls()
+    {
+        var backend = CreateBackend();
+        await backend.DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+
+        Assert.Equal(20, _server.Count("download_link.json"));
+        Assert.Equal(20, Directory.GetFiles(Path.Combine(_root, "out"), "*.zip", SearchOption.AllDirectories).Length);
+
+        _server.ResetCounts();
+        await CreateBackend().DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+
+        Assert.Equal(2, _server.ApiRequests);
+        Assert.Equal(1, _server.Count("tracked_mods.json"));
+        Assert.Equal(1, _server.Count("updated.json"));
+    }
+
+    [Fact]
+    public async Task Resync_AfterUpload_ListsOnlyChangedMod()
+    {
+        await CreateBackend().DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+        _server.AddFile(7, 9999, DateTimeOffset.UtcNow.ToUnixTimeSeconds());
+
+        _server.ResetCounts();
+        await CreateBackend().DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+
+        Assert.Equal(1, _server.Count("/mods/7/files.json"));
+        Assert.Equal(1, _server.Count("/files.json"));
+        Assert.Equal(1, _server.Count("/download_link.json"));
+        Assert.Equal(1, _server.Downloads);
+        Assert.True(_database.IsDownloaded(Domain, 7, 9999));
+    }
+
+    [Fact]
+    public async Task FailedDownload_IsRetriedOnNextSync()
+    {
+        _server.FailDownloadsOf(300);
+        await CreateBackend().DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+        Assert.False(_database.IsDownloaded(Domain, 3, 300));
+
+        _server.FailDownloadsOf(null);
+        _server.ResetCounts();
+        await CreateBackend().DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+
+        Assert.Equal(1, _server.Count("/files.json"));
+        Assert.True(_database.IsDownloaded(Domain, 3, 300));
+    }
+
+    [Fact]
+    public async Task DownloadLinks_AreResolvedJustBeforeEachTransfer()
+    {
+        await CreateBackend().DownloadModsAsync(Path.Combine(_root, "out"), Domain);
+
+        // Every link request is immediately followed by the download it was for
+        var log = _server.Log.Where(p => p.Contains("download_link.json") || p.StartsWith("/dl/")).ToList();
+        for (var i = 0; i < log.Count; i += 2)
+        {
+            Assert.Contains("download_link.json", log[i]);
+            Assert.StartsWith("/dl/", log[i + 1]);
+        }
+    }
+
+    [Fact]
+    public void Plan_ChangedFilter_ListsEverything()
+    {
+        var now = DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+        var state = new TrackedModSyncState { FilterKey = "main", SyncedAt = { [1] = now - 60, [2] = now - 60 } };
+
+        Assert.Null(NexusSyncPlanner.ChooseUpdatedPeriod(state, [1, 2], "optional", now));
+        var plan = NexusSyncPlanner.Plan([1, 2], state, [], "1d", "optional", now, force: false);
+
+        Assert.Equal(new[] { 1, 2 }, plan.ModsToList);
+    }
+
+    [Fact]
+    public void Plan_SyncOlderThanWindow_IsListedAgain()
+    {
+        var now = DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+        var state = new TrackedModSyncState { SyncedAt = { [1] = now - 3_600 * 2, [2] = now - 86_400 * 60 } };
+
+        Assert.Equal("1m", NexusSyncPlanner.ChooseUpdatedPeriod(state, [1, 2], string.Empty, now));
+        var plan = NexusSyncPlanner.Plan([1, 2, 3], state, [], "1m", string.Empty, now, force: false);
+
+        Assert.Equal(new[] { 2, 3 }, plan.ModsToList);
+        Assert.Equal(new[] { 1 }, plan.Unchanged);
+    }
+
+    private NexusModsBackend CreateBackend() =>
+        new(new AppSettings { NexusApiKey = "test-key" }, new NexusRateLimiter(), _database, _metadataCache, _server.BaseUrl);
+
+    /// <summary>
+    /// Minimal Nexus v1 API: tracked mods, mod info, updated feed, file lists,
+    /// download links and the downloads themselves.
+    /// </summary>
+    private sealed class FakeNexusServer : IDisposable
+    {
+        private readonly HttpListener _listener = new();
+        private readonly ConcurrentDictionary<int, List<(int FileId, long Uploaded)>> _files = new();
+        private readonly ConcurrentQueue<string> _log = new();
+        private int? _failingFileId;
+
+        public FakeNexusServer()
+        {
+            var port = FreePort();
+            BaseUrl = $"http://127.0.0.1:{port}";
+            _listener.Prefixes.Add(BaseUrl + "/");
+            _listener.Start();
+            _ = Task.Run(ServeAsync);
+        }
+
+        public string BaseUrl { get; }
+
+        public IReadOnlyList<string> Log => _log.ToList();
+
+        public int ApiRequests => _log.Count(p => p.StartsWith("/v1/", StringComparison.Ordinal));
+
+        public int Downloads => _log.Count(p => p.StartsWith("/dl/", StringComparison.Ordinal));
+
+        public int Count(string fragment) => _log.Count(p => p.Contains(fragment));
+
+        public void ResetCounts() => _log.Clear();
+
+        public void AddFile(int modId, int fileId, long uploaded) =>
+            _files.GetOrAdd(modId, _ => []).Add((fileId, uploaded));
+
+        public void FailDownloadsOf(int? fileId) => _failingFileId = fileId;
+
+        private async Task ServeAsync()
+        {
+            while (_listener.IsListening)
+            {
+                HttpListenerContext context;
+                try
+                {
+                    context = await _listener.GetContextAsync();
+                }
+                catch (Exception ex) when (ex is HttpListenerException or ObjectDisposedException)
+                {
+                    return;
+                }
+
+                var path = context.Request.Url!.AbsolutePath;
+                _log.Enqueue(path);
+                var (status, body) = Route(path);
+                var bytes = Encoding.UTF8.GetBytes(body);
+                context.Response.StatusCode = status;
+                context.Response.ContentType = "application/json";
+                await context.Response.OutputStream.WriteAsync(bytes);
+                context.Response.Close();
+            }
+        }
+
+        private (int Status, string Body) Route(string path)
+        {
+            var parts = path.Trim('/').Split('/');
+
+            if (path == "/v1/user/tracked_mods.json")
+                return (200, Json(_files.Keys.Order().Select(id => new { mod_id = id, domain_name = Domain, name = $"Mod {id}" })));
+
+            if (path == $"/v1/games/{Domain}/mods/updated.json")
+            {
+                return (200, Json(_files.Select(kv => new
+                {
+                    mod_id = kv.Key,
+                    latest_file_update = kv.Value.Max(f => f.Uploaded),
+                    latest_mod_activity = kv.Value.Max(f => f.Uploaded)
+                })));
+            }
+
+            // v1/games/{domain}/mods/{id}.json
+            if (parts.Length == 5 && parts[4].EndsWith(".json"))
+                return (200, Json(new { name = $"Mod {parts[4][..^5]}", category_id = 1 }));
+
+            // v1/games/{domain}/mods/{id}/files.json
+            if (parts.Length == 6 && parts[5] == "files.json")
+            {
+                var modId = int.Parse(parts[4]);
+                return (200, Json(new
+                {
+                    files = _files[modId].Select(f => new
+                    {
+                        file_id = f.FileId,
+                        name = $"File {f.FileId}",
+                        file_name = $"file-{f.FileId}.zip",
+                        size_kb = 1,
+                        category_id = 1,
+                        version = "1.0",
+                        uploaded_timestamp = f.Uploaded
+                    })
+                }));
+            }
+
+            // v1/games/{domain}/mods/{id}/files/{fileId}/download_link.json
+            if (parts.Length == 8 && parts[7] == "download_link.json")
+                return (200, Json(new[] { new { URI = $"{BaseUrl}/dl/{parts[6]}", name = "fake", short_name = "fake" } }));
+
+            if (parts[0] == "dl")
+                return parts[1] == _failingFileId?.ToString() ? (500, "broken") : (200, $"archive {parts[1]}");
+
+            return (404, "{}");
+        }
+
+        private static string Json(object value) => JsonSerializer.Serialize(value);
+
+        private static int FreePort()
+        {
+            var socket = new TcpListener(IPAddress.Loopback, 0);
+            socket.Start();
+            var port = ((IPEndPoint)socket.LocalEndpoint).Port;
+            socket.Stop();
+            return port;
+        }
+
+        public void Dispose() => _listener.Close();
+    }
+}
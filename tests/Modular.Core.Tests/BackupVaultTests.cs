@@ -0,0 +1,175 @@
+using System.Text;
+using Modular.Core.Installers;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class BackupVaultTests : IDisposable
+{
+    private static readonly string[] Textures =
+    [
+        "Data/Textures/Armor/iron.dds",
+        "Data/Textures/Armor/steel.dds",
+        "Data/Textures/Weapons/sword.dds"
+    ];
+
+    private readonly string _testDir;
+    private readonly string _gameDir;
+    private readonly BackupVault _vault;
+
+    public BackupVaultTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_vault_test_{Guid.NewGuid():N}");
+        _gameDir = Path.Combine(_testDir, "game");
+        _vault = new BackupVault(Path.Combine(_testDir, "vault"));
+
+        foreach (var texture in Textures)
+        {
+            var path = Path.Combine(_gameDir, texture);
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            File.WriteAllText(path, Original(texture));
+        }
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task InstallAndUninstallSamePack10Times_KeepsOneCompressedCopyPerOriginal()
+    {
+        var originalBytes = Textures.Sum(t => (long)Encoding.UTF8.GetByteCount(Original(t)));
+
+        for (var i = 1; i <= 10; i++)
+        {
+            var changesetId = $"cs-{i}";
+            var vaulted = await _vault.AdoptBackupsAsync(changesetId, InstallPack());
+
+            Assert.Equal(Textures.Length, vaulted.Count);
+            Assert.Empty(Directory.EnumerateFiles(_gameDir, "*.backup", SearchOption.AllDirectories));
+            var stats = _vault.GetStats();
+            Assert.Equal(Textures.Length, stats.ObjectCount);
+            Assert.Equal(Textures.Length, stats.CompressedObjectCount);
+            Assert.True(stats.StoredBytes < originalBytes / 4, $"{stats.StoredBytes} of {originalBytes} bytes");
+
+            foreach (var texture in Textures)
+                File.Delete(Path.Combine(_gameDir, texture));
+            Assert.Equal(Textures.Length, await _vault.RestoreChangesetAsync(changesetId));
+            _vault.Release(changesetId);
+
+            AssertOriginals();
+        }
+
+        Assert.Equal(0, _vault.GetStats().ObjectCount);
+    }
+
+    [Fact]
+    public async Task StackedInstalls_ShareOriginalsUntilEveryChangesetIsReleased()
+    {
+        var first = await _vault.AdoptBackupsAsync("cs-1", InstallPack());
+        RestoreOriginalsInGame();
+        await _vault.AdoptBackupsAsync("cs-2", InstallPack());
+
+        Assert.Equal(Textures.Length, _vault.GetStats().ObjectCount);
+        Assert.All(first, f => Assert.Equal(2, _vault.GetReferenceCount(f.Hash)));
+
+        Assert.Equal(0, _vault.Release("cs-1"));
+        Assert.Equal(Textures.Length, _vault.GetStats().ObjectCount);
+        Assert.Equal(Textures.Length, _vault.Release("cs-2"));
+        Assert.Equal(0, _vault.GetStats().ObjectCount);
+    }
+
+    [Fact]
+    public async Task CollectGarbage_RemovesStaleUnreferencedObjectsAndTempFiles()
+    {
+        await _vault.AdoptBackupsAsync("cs-1", InstallPack());
+        var objects = Path.Combine(_testDir, "vault", "objects", "ab");
+        Directory.CreateDirectory(objects);
+
+        var stale = DateTime.UtcNow - TimeSpan.FromDays(1);
+        var orphan = Path.Combine(objects, new string('a', 64) + ".zst");
+        var temp = Path.Combine(objects, new string('b', 64) + $".{Guid.NewGuid():N}.tmp");
+        var recent = Path.Combine(objects, new string('c', 64) + ".raw");
+        foreach (var path in new[] { orphan, temp, recent })
+            File.WriteAllText(path, "left behind by a crashed store");
+        File.SetLastWriteTimeUtc(orphan, stale);
+        File.SetLastWriteTimeUtc(temp, stale);
+
+        Assert.Equal(2, _vault.CollectGarbage());
+
+        Assert.False(File.Exists(orphan));
+        Assert.False(File.Exists(temp));
+        Assert.True(File.Exists(recent));
+        Assert.Equal(Textures.Length + 1, _vault.GetStats().ObjectCount);
+        foreach (var texture in Textures)
+            File.Delete(Path.Combine(_gameDir, texture));
+        Assert.Equal(Textures.Length, await _vault.RestoreChangesetAsync("cs-1"));
+        AssertOriginals();
+    }
+
+    [Fact]
+    public async Task IncompressibleOriginal_IsStoredRawAndRestoredExactly()
+    {
+        var path = Path.Combine(_gameDir, "Data/Meshes.bsa");
+        var content = new byte[256 * 1024];
+        new Random(42).NextBytes(content);
+        await File.WriteAllBytesAsync(path + ".backup", content);
+
+        var vaulted = Assert.Single(await _vault.AdoptBackupsAsync("cs-1", [path + ".backup"]));
+        var stats = _vault.GetStats();
+
+        Assert.Equal(path, vaulted.TargetPath);
+        Assert.Equal(content.Length, vaulted.Length);
+        Assert.Equal(1, stats.ObjectCount);
+        Assert.Equal(0, stats.CompressedObjectCount);
+
+        await _vault.RestoreAsync(vaulted);
+        Assert.Equal(content, await File.ReadAllBytesAsync(path));
+    }
+
+    [Fact]
+    public async Task AdoptBackups_SkipsPathsWithoutBackupSuffix()
+    {
+        var other = Path.Combine(_gameDir, "notes.txt");
+        await File.WriteAllTextAsync(other, "keep me");
+
+        Assert.Empty(await _vault.AdoptBackupsAsync("cs-1", [other]));
+        Assert.True(File.Exists(other));
+        Assert.Empty(_vault.GetFiles("cs-1"));
+    }
+
+    /// <summary>
+    /// Does what an installer does: backs up each original beside it and
+    /// overwrites it with the pack's file. Returns the backup paths.
+    /// </summary>
+    private List<string> InstallPack()
+    {
+        var backups = new List<string>();
+        foreach (var texture in Textures)
+        {
+            var path = Path.Combine(_gameDir, texture);
+            File.Copy(path, path + ".backup", overwrite: true);
+            File.WriteAllText(path, $"retextured {texture}");
+            backups.Add(path + ".backup");
+        }
+
+        return backups;
+    }
+
+    private void RestoreOriginalsInGame()
+    {
+        foreach (var texture in Textures)
+            File.WriteAllText(Path.Combine(_gameDir, texture), Original(texture));
+    }
+
+    private void AssertOriginals()
+    {
+        foreach (var texture in Textures)
+            Assert.Equal(Original(texture), File.ReadAllText(Path.Combine(_gameDir, texture)));
+    }
+
+    private static string Original(string texture) =>
+        string.Concat(Enumerable.Repeat($"DDS original pixels of {texture};", 2000));
+}
@@ -0,0 +1,224 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using Modular.Core.Configuration;
+using Modular.Core.RateLimiting;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class BandwidthGovernorTests : IDisposable
+{
+    private const int MB = 1024 * 1024;
+
+    private readonly string _testDir;
+    private readonly string _coordinationPath;
+    private readonly HttpListener _listener = new();
+    private readonly HttpClient _httpClient = new();
+    private readonly string _baseUrl;
+
+    public BandwidthGovernorTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_bandwidth_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+        _coordinationPath = Path.Combine(_testDir, "bandwidth.bin");
+
+        var socket = new TcpListener(IPAddress.Loopback, 0);
+        socket.Start();
+        _baseUrl = $"http://127.0.0.1:{((IPEndPoint)socket.LocalEndpoint).Port}";
+        socket.Stop();
+        _listener.Prefixes.Add(_baseUrl + "/");
+        _listener.Start();
+        _ = Task.Run(ServeAsync);
+    }
+
+    public void Dispose()
+    {
+        _listener.Close();
+        _httpClient.Dispose();
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void Schedule_FirstMatchingWindowWinsAndWrapsMidnight()
+    {
+        var schedule = BandwidthSchedule.Parse(["mon-fri 09:00-18:00 512", "* 23:00-07:00 0", "sat,sun 10:00-12:00 2048"]);
+        var monday = new DateTime(2026, 10, 19);
+
+        Assert.Equal(512, schedule.LimitAt(monday.AddHours(9), 100));
+        Assert.Equal(100, schedule.LimitAt(monday.AddHours(18), 100));
+        Assert.Equal(0, schedule.LimitAt(monday.AddHours(23.5), 100));
+        Assert.Equal(0, schedule.LimitAt(monday.AddHours(6), 100));
+        Assert.Equal(2048, schedule.LimitAt(monday.AddDays(-1).AddHours(11), 100));
+        Assert.Equal(100, schedule.LimitAt(monday.AddDays(-2).AddHours(9.5), 100));
+
+        // fri-mon wraps the week; a window running past midnight belongs to the day it starts
+        var weekend = BandwidthSchedule.Parse(["fri-mon 22:00-02:00 64"]);
+        Assert.Equal(64, weekend.LimitAt(monday.AddDays(1).AddHours(1), 0));
+        Assert.Equal(0, weekend.LimitAt(monday.AddDays(1).AddHours(22), 0));
+
+        Assert.Throws<FormatException>(() => BandwidthSchedule.Parse(["weekdays 09:00-18:00 512"]));
+        Assert.Throws<FormatException>(() => BandwidthSchedule.Parse(["* 9-18 512"]));
+        var errors = ConfigurationService.GetSchemaErrors(new AppSettings { BandwidthSchedule = ["* 09:00-18:00 fast"] });
+        Assert.Equal("bandwidth_schedule:", Assert.Single(errors)[..19]);
+    }
+
+    [Fact]
+    public async Task Throttle_HoldsTheCapWithinFivePercent()
+    {
+        var settings = new AppSettings { BandwidthLimitKbps = 2048 };
+        var governor = new BandwidthGovernor(settings, _coordinationPath);
+
+        // Keep first-request costs (connection, JIT) out of the measurement
+        await DownloadAsync(new BandwidthGovernor(settings, _coordinationPath + ".warmup"), BandwidthClass.Interactive, 64 * 1024);
+
+        var stopwatch = Stopwatch.StartNew();
+        var bytes = await DownloadAsync(governor, BandwidthClass.Interactive, 4 * MB);
+        stopwatch.Stop();
+
+        Assert.Equal(4 * MB, bytes);
+        AssertRate(2 * MB, bytes, stopwatch.Elapsed);
+    }
+
+    [Fact]
+    public async Task Governors_SharingACoordinationFile_HoldTheCapTogether()
+    {
+        // Separate governors with their own settings stand in for the CLI and GUI processes
+        var cli = new BandwidthGovernor(new AppSettings { BandwidthLimitKbps = 2048 }, _coordinationPath);
+        var gui = new BandwidthGovernor(new AppSettings { BandwidthLimitKbps = 2048 }, _coordinationPath);
+
+        var stopwatch = Stopwatch.StartNew();
+        var results = await Task.WhenAll(
+            DownloadAsync(cli, BandwidthClass.Background, 3 * MB),
+            DownloadAsync(gui, BandwidthClass.Background, 3 * MB));
+        stopwatch.Stop();
+
+        AssertRate(2 * MB, results.Sum(), stopwatch.Elapsed);
+    }
+
+    [Fact]
+    public async Task Classes_SplitTheCapByWeight()
+    {
+        var settings = new AppSettings { BandwidthLimitKbps = 2048, BandwidthInteractiveWeight = 3, BandwidthBackgroundWeight = 1 };
+        var sync = new BandwidthGovernor(settings, _coordinationPath);
+        var user = new BandwidthGovernor(settings, _coordinationPath);
+        var background = new Counter();
+        var interactive = new Counter();
+        using var cts = new CancellationTokenSource();
+
+        var transfers = Task.WhenAll(
+            DownloadAsync(sync, BandwidthClass.Background, 64 * MB, background, cts.Token),
+            DownloadAsync(user, BandwidthClass.Interactive, 64 * MB, interactive, cts.Token));
+        await Task.Delay(500);
+        var (background0, interactive0) = (background.Bytes, interactive.Bytes);
+        var stopwatch = Stopwatch.StartNew();
+        await Task.Delay(2000);
+        var backgroundBytes = background.Bytes - background0;
+        var interactiveBytes = interactive.Bytes - interactive0;
+        var elapsed = stopwatch.Elapsed;
+        cts.Cancel();
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => transfers);
+
+        var share = (double)interactiveBytes / (interactiveBytes + backgroundBytes);
+        Assert.InRange(share, 0.70, 0.80);
+        AssertRate(2 * MB, interactiveBytes + backgroundBytes, elapsed, tolerance: 0.1);
+    }
+
+    [Fact]
+    public async Task RateChanges_InAnotherProcess_ApplyToRunningTransfers()
+    {
+        var gui = new AppSettings { BandwidthLimitKbps = 4096 };
+        var guiGovernor = new BandwidthGovernor(gui, _coordinationPath);
+        var cliGovernor = new BandwidthGovernor(new AppSettings { BandwidthLimitKbps = 4096 }, _coordinationPath);
+        var counter = new Counter();
+        using var cts = new CancellationTokenSource();
+
+        var transfer = DownloadAsync(cliGovernor, BandwidthClass.Background, 64 * MB, counter, cts.Token);
+        await Task.Delay(1000);
+        Assert.InRange(counter.Bytes, 3.4 * MB, 4.6 * MB);
+
+        gui.BandwidthLimitKbps = 1024;
+        guiGovernor.ApplySettings();
+        await Task.Delay(250);
+        var before = counter.Bytes;
+        var stopwatch = Stopwatch.StartNew();
+        await Task.Delay(1500);
+        var bytes = counter.Bytes - before;
+        var elapsed = stopwatch.Elapsed;
+        cts.Cancel();
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => transfer);
+
+        Assert.Equal(1024 * 1024, cliGovernor.CurrentLimitBytesPerSecond);
+        AssertRate(MB, bytes, elapsed, tolerance: 0.1);
+    }
+
+    private static void AssertRate(double expectedBytesPerSecond, long bytes, TimeSpan elapsed, double tolerance = 0.05)
+    {
+        var rate = bytes / elapsed.TotalSeconds;
+        Assert.True(
+            Math.Abs(rate - expectedBytesPerSecond) <= expectedBytesPerSecond * tolerance,
+            $"{rate / 1024:N0} KB/s, expected {expectedBytesPerSecond / 1024:N0} KB/s ±{tolerance:P0}");
+    }
+
+    private async Task<long> DownloadAsync(
+        BandwidthGovernor governor,
+        BandwidthClass transferClass,
+        long size,
+        Counter? counter = null,
+        CancellationToken ct = default)
+    {
+        using var response = await _httpClient.GetAsync($"{_baseUrl}/{size}", HttpCompletionOption.ResponseHeadersRead, ct);
+        response.EnsureSuccessStatusCode();
+        await using var body = governor.Throttle(await response.Content.ReadAsStreamAsync(ct), transferClass);
+        var buffer = new byte[81920];
+        long total = 0;
+        int read;
+        while ((read = await body.ReadAsync(buffer, ct)) > 0)
+        {
+            total += read;
+            if (counter != null)
+                Interlocked.Add(ref counter.Bytes, read);
+        }
+
+        return total;
+    }
+
+    private async Task ServeAsync()
+    {
+        var chunk = new byte[64 * 1024];
+        while (_listener.IsListening)
+        {
+            HttpListenerContext context;
+            try
+            {
+                context = await _listener.GetContextAsync();
+            }
+            catch (Exception ex) when (ex is HttpListenerException or ObjectDisposedException)
+            {
+                return;
+            }
+
+            _ = Task.Run(async () =>
+            {
+                try
+                {
+                    var size = long.Parse(context.Request.Url!.AbsolutePath.Trim('/'));
+                    context.Response.ContentLength64 = size;
+                    for (long sent = 0; sent < size; sent += chunk.Length)
+                        await context.Response.OutputStream.WriteAsync(chunk.AsMemory(0, (int)Math.Min(chunk.Length, size - sent)));
+                    context.Response.Close();
+                }
+                catch (Exception ex) when (ex is HttpListenerException or IOException or ObjectDisposedException)
+                {
+                    context.Response.Abort();
+                }
+            });
+        }
+    }
+
+    private sealed class Counter
+    {
+        public long Bytes;
+    }
+}
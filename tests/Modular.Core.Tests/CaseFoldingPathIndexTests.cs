@@ -0,0 +1,171 @@
+using Modular.Core.Installers;
+using Modular.Core.Utilities;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class CaseFoldingPathIndexTests : IDisposable
+{
+    private readonly string _testDir;
+
+    public CaseFoldingPathIndexTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_casefold_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void Resolve_UsesExistingCasingAndKeepsNewSegments()
+    {
+        var game = CreateGame("data/textures/sky.dds", "Data.ini");
+        var index = CaseFoldingPathIndex.Build(game);
+        if (!index.IsCaseSensitive)
+            return;
+
+        Assert.Equal(Path.Combine("data", "textures", "Armor", "Iron.dds"), index.Resolve("Data/Textures/Armor/Iron.dds"));
+        Assert.Equal(Path.Combine("data", "textures", "sky.dds"), index.Resolve(@"DATA\TEXTURES\SKY.DDS"));
+        Assert.Equal("Data.ini", index.Resolve("data.INI"));
+        Assert.Empty(index.Collisions);
+    }
+
+    [Fact]
+    public void AddFile_MapsLaterEntriesOntoDeployedOnes()
+    {
+        var game = CreateGame("game.exe");
+        var index = CaseFoldingPathIndex.Build(game);
+        if (!index.IsCaseSensitive)
+            return;
+
+        var first = index.SanitizeEntryPath("Data/Meshes/a.nif");
+        Assert.Equal(Path.Combine(game, "data", "meshes", "b.nif"), index.SanitizeEntryPath("data/meshes/b.nif"));
+
+        // Only a written file is recorded
+        index.AddFile(first);
+        var second = index.SanitizeEntryPath("data/meshes/b.nif");
+
+        Assert.Equal(Path.Combine(game, "Data", "Meshes", "a.nif"), first);
+        Assert.Equal(Path.Combine(game, "Data", "Meshes", "b.nif"), second);
+        Assert.Throws<InvalidOperationException>(() => index.SanitizeEntryPath("../outside.txt"));
+    }
+
+    [Fact]
+    public void For_RereadsDirectoriesChangedOnDisk()
+    {
+        var game = CreateGame("Data/Textures/sky.dds", "Data/Meshes/a.nif");
+        var index = CaseFoldingPathIndex.For(game);
+        if (!index.IsCaseSensitive)
+            return;
+
+        Assert.Equal(4, index.DirectoriesScanned);
+        Assert.Same(index, CaseFoldingPathIndex.For(game));
+        Assert.Equal(4, index.DirectoriesScanned);
+
+        // Removed and renamed outside any installer
+        Directory.Delete(Path.Combine(game, "Data", "Meshes"), recursive: true);
+        Directory.Move(Path.Combine(game, "Data", "Textures"), Path.Combine(game, "Data", "textures"));
+        CaseFoldingPathIndex.For(game);
+
+        Assert.Equal(Path.Combine("Data", "textures", "sky.dds"), index.Resolve("DATA/TEXTURES/SKY.DDS"));
+        Assert.Equal(Path.Combine("Data", "meshes", "a.nif"), index.Resolve("DATA/meshes/a.nif"));
+        // Data and the renamed directory; the root didn't change
+        Assert.Equal(6, index.DirectoriesScanned);
+    }
+
+    [Fact]
+    public void Build_WritesNothingIntoTheGameDirectory()
+    {
+        var game = CreateGame("Game.exe");
+        var missing = Path.Combine(_testDir, "not-installed");
+
+        CaseFoldingPathIndex.Build(game);
+        CaseFoldingPathIndex.Build(missing);
+
+        Assert.Equal(["Game.exe"], Directory.GetFileSystemEntries(game).Select(Path.GetFileName));
+        Assert.False(Directory.Exists(missing));
+    }
+
+    [Fact]
+    public void Build_ReportsPreExistingCaseCollisions()
+    {
+        var game = CreateGame("Data/a.esp", "data/b.esp", "Data/Textures/x.dds", "Data/textures/y.dds", "README.txt");
+        var index = CaseFoldingPathIndex.Build(game);
+        if (!index.IsCaseSensitive)
+            return;
+
+        var collisions = index.Collisions.OrderBy(c => c.Path, StringComparer.Ordinal).ToList();
+
+        Assert.Equal(2, collisions.Count);
+        Assert.Equal("Data", collisions[0].Path);
+        Assert.Equal(["Data", "data"], collisions[0].Names);
+        Assert.Equal(Path.Combine("Data", "Textures"), collisions[1].Path);
+        Assert.Equal(Path.Combine("Data", "Textures", "z.dds"), index.Resolve("DATA/TEXTURES/z.dds"));
+    }
+
+    [Fact]
+    public void LargeInstall_ReadsEachDirectoryOnlyOnce()
+    {
+        var game = CreateGame(Enumerable.Range(0, 20).Select(i => $"Data/Textures/Set{i}/base.dds").ToArray());
+        var index = CaseFoldingPathIndex.Build(game);
+        if (!index.IsCaseSensitive)
+            return;
+
+        // Root, Data, Textures and the 20 sets
+        Assert.Equal(23, index.DirectoriesScanned);
+
+        for (var i = 0; i < 100_000; i++)
+        {
+            var mapped = index.SanitizeEntryPath($"data/TEXTURES/set{i % 20}/File{i}.dds");
+            index.AddFile(mapped);
+            Assert.StartsWith(Path.Combine(game, "Data", "Textures", $"Set{i % 20}") + Path.DirectorySeparatorChar, mapped);
+        }
+
+        Assert.Equal(23, index.DirectoriesScanned);
+        Assert.Equal(Path.Combine("Data", "Textures", "Set3", "File3.dds"), index.Resolve("DATA/textures/SET3/file3.DDS"));
+    }
+
+    [Fact]
+    public void StagingCommit_DeploysIntoExistingDirectoryCasing()
+    {
+        var game = CreateGame("Data/Textures/sky.dds");
+        if (!CaseFoldingPathIndex.Build(game).IsCaseSensitive)
+            return;
+
+        using (var session = new StagingManager(Path.Combine(_testDir, "staging")).CreateSession("cs-1"))
+        {
+            foreach (var relativePath in new[] { "data/textures/ground.dds", "DATA/Textures/Armor/iron.dds", "data/TEXTURES/armor/steel.dds" })
+            {
+                var stagedPath = session.GetStagedPath(relativePath);
+                File.WriteAllText(stagedPath, relativePath);
+                session.RecordStagedFile(relativePath, stagedPath);
+            }
+
+            Assert.True(session.Commit(game).Success);
+        }
+
+        Assert.Equal(["Data"], Directory.GetDirectories(game).Select(Path.GetFileName));
+        Assert.Equal(["Textures"], Directory.GetDirectories(Path.Combine(game, "Data")).Select(Path.GetFileName));
+        Assert.True(File.Exists(Path.Combine(game, "Data", "Textures", "ground.dds")));
+        Assert.True(File.Exists(Path.Combine(game, "Data", "Textures", "Armor", "iron.dds")));
+        Assert.True(File.Exists(Path.Combine(game, "Data", "Textures", "Armor", "steel.dds")));
+    }
+
+    private string CreateGame(params string[] files)
+    {
+        var game = Path.Combine(_testDir, "game");
+        Directory.CreateDirectory(game);
+        foreach (var file in files)
+        {
+            var path = Path.Combine(game, file);
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            File.WriteAllText(path, file);
+        }
+
+        return game;
+    }
+}
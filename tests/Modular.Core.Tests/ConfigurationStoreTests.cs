@@ -0,0 +1,237 @@
+using Modular.Core.Configuration;
+using Modular.Core.Exceptions;
+using Modular.Core.Utilities;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class ConfigurationStoreTests : IDisposable
+{
+    private static readonly TimeSpan EventTimeout = TimeSpan.FromSeconds(10);
+
+    private readonly string _testDir;
+    private readonly string _configPath;
+
+    public ConfigurationStoreTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_config_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+        _configPath = Path.Combine(_testDir, "config.json");
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task ConcurrentWritesAndReloads_NeverExposeTornSettings()
+    {
+        var service = new ConfigurationService();
+        await service.SaveAsync(Generation(0), _configPath);
+        using var store = new ConfigurationStore(service, _configPath, debounce: TimeSpan.FromMilliseconds(5));
+        await store.LoadAsync();
+        store.StartWatching();
+
+        var torn = 0;
+        var unreadable = 0;
+        using var cts = new CancellationTokenSource(TimeSpan.FromSeconds(2));
+
+        // Saves through the store, plus another process rewriting the file behind its back
+        var writers = Enumerable.Range(0, 3).Select(w => Task.Run(async () =>
+        {
+            for (var n = w * 100_000; !cts.IsCancellationRequested; n++)
+                await store.SaveAsync(Generation(n));
+        })).Append(Task.Run(async () =>
+        {
+            var external = new ConfigurationService();
+            for (var n = 900_000; !cts.IsCancellationRequested; n++)
+                await external.SaveAsync(Generation(n), _configPath);
+        })).ToList();
+
+        var readers = Enumerable.Range(0, 2).Select(_ => Task.Run(async () =>
+        {
+            while (!cts.IsCancellationRequested)
+            {
+                for (var i = 0; i < 1000; i++)
+                {
+                    if (!IsConsistent(store.Current))
+                        Interlocked.Increment(ref torn);
+                }
+
+                // Leave threads for the writers on small machines
+                await Task.Yield();
+            }
+        })).Append(Task.Run(async () =>
+        {
+            var reader = new ConfigurationService();
+            while (!cts.IsCancellationRequested)
+            {
+                try
+                {
+                    if (!IsConsistent(await reader.LoadAsync(_configPath)))
+                        Interlocked.Increment(ref torn);
+                }
+                catch (ConfigException)
+                {
+                    Interlocked.Increment(ref unreadable);
+                }
+            }
+        })).ToList();
+
+        await Task.WhenAll(writers.Concat(readers));
+
+        Assert.Equal(0, torn);
+        Assert.Equal(0, unreadable);
+        Assert.True(store.Version > 1);
+        Assert.Empty(Directory.GetFiles(_testDir, "*.tmp"));
+    }
+
+    [Fact]
+    public async Task MalformedEdit_KeepsLastGoodConfig()
+    {
+        var service = new ConfigurationService();
+        await service.SaveAsync(Generation(1), _configPath);
+        using var store = new ConfigurationStore(service, _configPath, debounce: TimeSpan.FromMilliseconds(20));
+        await store.LoadAsync();
+        var version = store.Version;
+
+        var failed = new TaskCompletionSource<Exception>(TaskCreationOptions.RunContinuationsAsynchronously);
+        store.ReloadFailed += (_, e) => failed.TrySetResult(e.Error);
+        store.StartWatching();
+
+        await File.WriteAllTextAsync(_configPath, "{ \"max_concurrent_downloads\": 3, ");
+
+        Assert.IsType<ConfigException>(await failed.Task.WaitAsync(EventTimeout));
+        Assert.Equal(version, store.Version);
+        Assert.Equal("1", store.Current.GameBananaUserId);
+        Assert.Equal(2, store.Settings.MaxConcurrentDownloads);
+    }
+
+    [Fact]
+    public async Task SchemaViolation_IsRejectedOnReloadAndSave()
+    {
+        var service = new ConfigurationService();
+        await service.SaveAsync(Generation(1), _configPath);
+        using var store = new ConfigurationStore(service, _configPath);
+        await store.LoadAsync();
+
+        await File.WriteAllTextAsync(_configPath, "{ \"max_concurrent_downloads\": 0 }");
+        Assert.False(await store.ReloadAsync());
+        Assert.Equal(2, store.Current.MaxConcurrentDownloads);
+
+        var invalid = store.Current.Clone();
+        invalid.PluginMarketplaceUrl = "ftp://example.com";
+        var ex = await Assert.ThrowsAsync<ConfigException>(() => store.SaveAsync(invalid));
+        Assert.Equal("plugin_marketplace_url", ex.ConfigKey);
+        Assert.Contains("\"max_concurrent_downloads\": 0", await File.ReadAllTextAsync(_configPath));
+    }
+
+    [Fact]
+    public async Task ExternalEdit_RaisesChangedWithChangedKeys()
+    {
+        var service = new ConfigurationService();
+        await service.SaveAsync(Generation(1), _configPath);
+        using var store = new ConfigurationStore(service, _configPath, debounce: TimeSpan.FromMilliseconds(20));
+        var live = await store.LoadAsync();
+
+        var changed = new TaskCompletionSource<ConfigurationChangedEventArgs>(TaskCreationOptions.RunContinuationsAsynchronously);
+        store.Changed += (_, e) => changed.TrySetResult(e);
+        store.StartWatching();
+
+        var edited = store.Current.Clone();
+        edited.MaxConcurrentDownloads = 7;
+        edited.NexusApiKey = "new-key";
+        await new ConfigurationService().SaveAsync(edited, _configPath);
+
+        var e = await changed.Task.WaitAsync(EventTimeout);
+        Assert.Equal<string>(new[] { "nexus_api_key", "max_concurrent_downloads" }, e.ChangedKeys);
+        Assert.Equal(2, e.Previous.MaxConcurrentDownloads);
+        Assert.Equal(7, e.Current.MaxConcurrentDownloads);
+        Assert.Same(live, store.Settings);
+        Assert.Equal(7, live.MaxConcurrentDownloads);
+        Assert.Equal("new-key", live.NexusApiKey);
+    }
+
+    [Fact]
+    public async Task Subscribe_FiresOnlyWhenSelectedValueChanges()
+    {
+        var service = new ConfigurationService();
+        await service.SaveAsync(Generation(1), _configPath);
+        using var store = new ConfigurationStore(service, _configPath);
+        await store.LoadAsync();
+
+        var limits = new List<int>();
+        var subscription = store.Subscribe(s => s.MaxConcurrentDownloads, limits.Add);
+
+        var update = store.Current.Clone();
+        update.Verbose = true;
+        await store.SaveAsync(update);
+        update.MaxConcurrentDownloads = 5;
+        await store.SaveAsync(update);
+        await store.SaveAsync(update);
+
+        subscription.Dispose();
+        update.MaxConcurrentDownloads = 6;
+        await store.SaveAsync(update);
+
+        Assert.Equal(new[] { 5 }, limits);
+    }
+
+    [Fact]
+    public async Task ConcurrencyGate_ResizesWhileInUse()
+    {
+        var gate = new ConcurrencyGate(1);
+
+        var first = await gate.EnterAsync();
+        var second = gate.EnterAsync();
+        var third = gate.EnterAsync();
+        Assert.False(second.IsCompleted);
+        Assert.Equal(2, gate.Waiting);
+
+        // Raising the limit starts queued waiters straight away
+        gate.SetLimit(3);
+        var secondLease = await second.WaitAsync(EventTimeout);
+        var thirdLease = await third.WaitAsync(EventTimeout);
+        Assert.Equal(3, gate.Running);
+
+        // Lowering it holds new entries until running work drops below the limit
+        gate.SetLimit(1);
+        var fourth = gate.EnterAsync();
+        first.Dispose();
+        secondLease.Dispose();
+        Assert.False(fourth.IsCompleted);
+        thirdLease.Dispose();
+        (await fourth.WaitAsync(EventTimeout)).Dispose();
+        Assert.Equal(0, gate.Running);
+
+        // Cancelled waiters give up their place in the queue
+        var held = await gate.EnterAsync();
+        using var cts = new CancellationTokenSource();
+        var cancelled = gate.EnterAsync(cts.Token);
+        cts.Cancel();
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => cancelled);
+        Assert.Equal(0, gate.Waiting);
+        held.Dispose();
+    }
+
+    // Every value derives from n, so a mix of two generations is detectable
+    private static AppSettings Generation(int n) => new()
+    {
+        GameBananaUserId = n.ToString(),
+        ModsDirectory = $"/mods/{n}",
+        GameBananaGameIds = [n + 1],
+        MaxConcurrentDownloads = n % 16 + 1
+    };
+
+    private static bool IsConsistent(AppSettings settings)
+    {
+        if (!int.TryParse(settings.GameBananaUserId, out var n))
+            return false;
+
+        return settings.ModsDirectory == $"/mods/{n}" &&
+               settings.GameBananaGameIds.SequenceEqual([n + 1]) &&
+               settings.MaxConcurrentDownloads == n % 16 + 1;
+    }
+}
@@ -0,0 +1,210 @@
+using FluentAssertions;
+using Modular.Core.Authentication;
+using Modular.Core.Configuration;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class CredentialServiceTests : IDisposable
+{
+    private readonly string _stateDir;
+    private readonly FakeSecretStore _store = new();
+    private readonly CountingValidator _validator = new();
+
+    public CredentialServiceTests()
+    {
+        _stateDir = Path.Combine(Path.GetTempPath(), $"modular_creds_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_stateDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_stateDir))
+            Directory.Delete(_stateDir, true);
+    }
+
+    [Fact]
+    public async Task ValidateAsync_SecondCall_IsServedFromCache()
+    {
+        var service = new CredentialService(_store, _stateDir);
+
+        var first = await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator);
+        var second = await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator);
+
+        first!.IsValid.Should().BeTrue();
+        first.FromCache.Should().BeFalse();
+        second!.FromCache.Should().BeTrue();
+        second.UserName.Should().Be("tester");
+        _validator.Calls.Should().Be(1);
+    }
+
+    [Fact]
+    public async Task ValidateAsync_ConcurrentProcesses_ShareOneValidation()
+    {
+        // Separate service instances stand in for separate processes sharing the state directory
+        var tasks = Enumerable.Range(0, 20)
+            .Select(_ => new CredentialService(_store, _stateDir)
+                .ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator))
+            .ToList();
+
+        var results = await Task.WhenAll(tasks);
+
+        results.Should().OnlyContain(r => r != null && r.IsValid);
+        _validator.Calls.Should().Be(1);
+
+        // A later burst makes no validation calls at all
+        _validator.Calls = 0;
+        await Task.WhenAll(Enumerable.Range(0, 20)
+            .Select(_ => new CredentialService(_store, _stateDir)
+                .ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator)));
+        _validator.Calls.Should().Be(0);
+    }
+
+    [Fact]
+    public async Task ValidateAsync_DifferentSecret_Revalidates()
+    {
+        var service = new CredentialService(_store, _stateDir);
+
+        await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator);
+        await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-2", _validator);
+
+        _validator.Calls.Should().Be(2);
+    }
+
+    [Fact]
+    public async Task ValidateAsync_ExpiredEntry_Revalidates()
+    {
+        var service = new CredentialService(_store, _stateDir) { ValidLifetime = TimeSpan.Zero };
+
+        await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator);
+        await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator);
+
+        _validator.Calls.Should().Be(2);
+    }
+
+    [Fact]
+    public async Task ValidateAsync_ValidatorUnreachable_ReturnsNullAndDoesNotCache()
+    {
+        var service = new CredentialService(_store, _stateDir);
+        _validator.Throw = true;
+
+        var result = await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator);
+
+        result.Should().BeNull();
+        _validator.Throw = false;
+        (await service.ValidateAsync(CredentialService.NexusApiKeyName, "key-1", _validator))!.FromCache.Should().BeFalse();
+    }
+
+    [Fact]
+    public async Task RefreshAsync_RunsReauthenticationOnceAcrossCallers()
+    {
+        await _store.SetAsync(CredentialService.NexusApiKeyName, "revoked");
+        var reauthCalls = 0;
+
+        async Task<string> Reauthenticate(CancellationToken ct)
+        {
+            Interlocked.Increment(ref reauthCalls);
+            await Task.Delay(20, ct);
+            return "fresh";
+        }
+
+        var results = await Task.WhenAll(Enumerable.Range(0, 5)
+            .Select(_ => new CredentialService(_store, _stateDir)
+                .RefreshAsync(CredentialService.NexusApiKeyName, "revoked", Reauthenticate)));
+
+        results.Should().OnlyContain(r => r == "fresh");
+        reauthCalls.Should().Be(1);
+        (await _store.GetAsync(CredentialService.NexusApiKeyName)).Should().Be("fresh");
+    }
+
+    [Fact]
+    public async Task ConfigurationService_WithCredentials_KeepsKeyOutOfConfigFile()
+    {
+        var configPath = Path.Combine(_stateDir, "config.json");
+        var credentials = new CredentialService(_store, _stateDir);
+        var configService = new ConfigurationService(credentials);
+
+        await configService.SaveAsync(new AppSettings { NexusApiKey = "secret-key" }, configPath);
+
+        (await File.ReadAllTextAsync(configPath)).Should().NotContain("secret-key");
+        (await _store.GetAsync(CredentialService.NexusApiKeyName)).Should().Be("secret-key");
+
+        var loaded = await configService.LoadAsync(configPath);
+        if (string.IsNullOrEmpty(Environment.GetEnvironmentVariable("NEXUS_API_KEY")) &&
+            string.IsNullOrEmpty(Environment.GetEnvironmentVariable("API_KEY")))
+        {
+            loaded.NexusApiKey.Should().Be("secret-key");
+        }
+    }
+
+    [Fact]
+    public async Task KeyFileSecretStore_RoundTripsEncryptedWithPrivatePermissions()
+    {
+        var store = new KeyFileSecretStore(_stateDir);
+
+        await store.SetAsync("nexusmods.api_key", "plain-text-secret");
+        var roundTrip = await new KeyFileSecretStore(_stateDir).GetAsync("nexusmods.api_key");
+
+        roundTrip.Should().Be("plain-text-secret");
+        (await File.ReadAllTextAsync(Path.Combine(_stateDir, "credentials.bin"))).Should().NotContain("plain-text-secret");
+
+        if (!OperatingSystem.IsWindows())
+        {
+            var mode = File.GetUnixFileMode(Path.Combine(_stateDir, "credentials.key"));
+            mode.Should().Be(UnixFileMode.UserRead | UnixFileMode.UserWrite);
+        }
+
+        (await store.DeleteAsync("nexusmods.api_key")).Should().BeTrue();
+        (await store.GetAsync("nexusmods.api_key")).Should().BeNull();
+    }
+
+    private sealed class FakeSecretStore : ISecretStore
+    {
+        private readonly Dictionary<string, string> _secrets = new();
+
+        public string Name => "fake";
+
+        public Task<string?> GetAsync(string key, CancellationToken ct = default)
+        {
+            lock (_secrets)
+                return Task.FromResult(_secrets.GetValueOrDefault(key));
+        }
+
+        public Task SetAsync(string key, string secret, CancellationToken ct = default)
+        {
+            lock (_secrets)
+                _secrets[key] = secret;
+            return Task.CompletedTask;
+        }
+
+        public Task<bool> DeleteAsync(string key, CancellationToken ct = default)
+        {
+            lock (_secrets)
+                return Task.FromResult(_secrets.Remove(key));
+        }
+    }
+
+    private sealed class CountingValidator : ICredentialValidator
+    {
+        private int _calls;
+
+        public int Calls
+        {
+            get => Volatile.Read(ref _calls);
+            set => Volatile.Write(ref _calls, value);
+        }
+
+        public bool Throw { get; set; }
+
+        public async Task<CredentialValidation> ValidateAsync(string secret, CancellationToken ct = default)
+        {
+            Interlocked.Increment(ref _calls);
+            await Task.Delay(10, ct);
+
+            if (Throw)
+                throw new HttpRequestException("offline");
+
+            return new CredentialValidation { IsValid = true, UserName = "tester" };
+        }
+    }
+}
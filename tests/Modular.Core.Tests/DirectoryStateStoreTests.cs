@@ -0,0 +1,145 @@
+using System.Diagnostics;
+using Modular.Core.Snapshots;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class DirectoryStateStoreTests : IDisposable
+{
+    private readonly string _testDir;
+    private readonly string _gameDir;
+    private readonly string _storeDir;
+
+    public DirectoryStateStoreTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_state_test_{Guid.NewGuid():N}");
+        _gameDir = Path.Combine(_testDir, "game");
+        _storeDir = Path.Combine(_testDir, "state");
+        Directory.CreateDirectory(_gameDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void Diff_ReportsAddedRemovedAndModifiedPaths()
+    {
+        Write("Data/textures/a.dds", "a");
+        Write("Data/textures/b.dds", "b");
+        Write("Data/meshes/m.nif", "m");
+        Write("game.exe", "exe");
+        var store = new DirectoryStateStore(_storeDir);
+        var before = store.Capture(_gameDir).RootHash;
+
+        Write("Data/textures/a.dds", "changed");
+        Directory.Delete(Path.Combine(_gameDir, "Data", "meshes"), recursive: true);
+        Write("Data/scripts/new.pex", "new");
+        var after = store.Capture(_gameDir, trustDirectoryMtime: false).RootHash;
+        var diff = store.Diff(before, after);
+
+        Assert.Equal(
+            [
+                new DirectoryStateChange("Data/meshes", DirectoryStateChangeKind.Removed, true),
+                new DirectoryStateChange("Data/scripts", DirectoryStateChangeKind.Added, true),
+                new DirectoryStateChange("Data/textures/a.dds", DirectoryStateChangeKind.Modified, false)
+            ],
+            diff.Changes);
+        Assert.False(store.Diff(after, after).HasChanges);
+    }
+
+    [Fact]
+    public void Capture_OnlyRelistsDirectoriesWhoseMtimeChanged()
+    {
+        for (var d = 0; d < 20; d++)
+            for (var f = 0; f < 5; f++)
+                Write($"dir{d}/sub/file{f}.txt", $"{d}-{f}");
+
+        var store = new DirectoryStateStore(_storeDir);
+        var first = store.Capture(_gameDir);
+        Assert.Equal(100, first.FilesHashed);
+
+        var unchanged = store.Capture(_gameDir);
+        Assert.Equal(first.RootHash, unchanged.RootHash);
+        Assert.Equal(0, unchanged.DirectoriesListed);
+
+        Write("dir7/sub/extra.txt", "extra");
+        var edited = store.Capture(_gameDir);
+        Assert.Equal(1, edited.DirectoriesListed);
+        Assert.Equal(1, edited.FilesHashed);
+    }
+
+    [Fact]
+    public void Capture_FullStatCatchesInPlaceRewritesButIgnoresTouches()
+    {
+        Write("a/config.ini", "one");
+        Write("a/other.ini", "same");
+        var store = new DirectoryStateStore(_storeDir);
+        var before = store.Capture(_gameDir).RootHash;
+
+        using (var stream = new FileStream(Path.Combine(_gameDir, "a", "config.ini"), FileMode.Open, FileAccess.Write))
+            stream.Write("two"u8);
+        File.SetLastWriteTimeUtc(Path.Combine(_gameDir, "a", "other.ini"), DateTime.UtcNow.AddMinutes(5));
+        var diff = store.DiffLive(before, _gameDir, trustDirectoryMtime: false);
+
+        Assert.Equal([new DirectoryStateChange("a/config.ini", DirectoryStateChangeKind.Modified, false)], diff.Changes);
+    }
+
+    [Fact]
+    public void DiffLive_OnLargeTreeFromNewProcessIsProportionalToChanges()
+    {
+        // 20,000 files in 2,000 directories
+        for (var top = 0; top < 40; top++)
+            for (var mid = 0; mid < 50; mid++)
+                for (var f = 0; f < 10; f++)
+                    Write($"t{top}/m{mid}/f{f}.bin", $"{top}/{mid}/{f}");
+
+        var snapshot = new DirectoryStateStore(_storeDir).Capture(_gameDir).RootHash;
+
+        Write("t3/m7/new.bin", "new");
+        File.Delete(Path.Combine(_gameDir, "t30", "m1", "f4.bin"));
+
+        var store = new DirectoryStateStore(_storeDir);
+        var stopwatch = Stopwatch.StartNew();
+        var diff = store.DiffLive(snapshot, _gameDir);
+        stopwatch.Stop();
+
+        Assert.Equal(
+            [
+                new DirectoryStateChange("t3/m7/new.bin", DirectoryStateChangeKind.Added, false),
+                new DirectoryStateChange("t30/m1/f4.bin", DirectoryStateChangeKind.Removed, false)
+            ],
+            diff.Changes.OrderBy(c => c.Path, StringComparer.Ordinal));
+        Assert.Equal(5, diff.NodesCompared);
+        Assert.True(stopwatch.ElapsedMilliseconds < 1000, $"took {stopwatch.ElapsedMilliseconds} ms");
+    }
+
+    [Fact]
+    public void CollectGarbage_KeepsOnlyReachableNodes()
+    {
+        Write("a/one.txt", "1");
+        Write("b/two.txt", "2");
+        var store = new DirectoryStateStore(_storeDir);
+        var kept = store.Capture(_gameDir).RootHash;
+
+        Write("b/three.txt", "3");
+        var dropped = store.Capture(_gameDir).RootHash;
+        Write("b/four.txt", "4");
+        var live = store.Capture(_gameDir).RootHash;
+
+        Assert.Equal(2, store.CollectGarbage([kept]));
+        Assert.True(store.Contains(kept));
+        Assert.True(store.Contains(live));
+        Assert.False(store.Contains(dropped));
+        Assert.Equal(2, store.Diff(kept, live).Changes.Count);
+    }
+
+    private void Write(string relativePath, string content)
+    {
+        var path = Path.Combine(_gameDir, relativePath);
+        Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+        File.WriteAllText(path, content);
+    }
+}
@@ -0,0 +1,192 @@
+using System.IO.Compression;
+using FluentAssertions;
+using Modular.Core.Archives;
+using Modular.Core.Database;
+using Modular.Core.Installers;
+using Modular.Sdk.Installers;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class DownloadLibraryIndexTests : IAsyncLifetime
+{
+    private readonly string _testDir;
+    private readonly string _library;
+    private readonly ModularDatabase _database;
+    private readonly CountingInstaller _installer = new();
+    private readonly InstallerManager _installers = new();
+
+    public DownloadLibraryIndexTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_library_test_{Guid.NewGuid():N}");
+        _library = Path.Combine(_testDir, "downloads");
+        Directory.CreateDirectory(_library);
+        _database = new ModularDatabase(Path.Combine(_testDir, "modular.db"));
+        _installers.RegisterInstaller(_installer);
+    }
+
+    public Task InitializeAsync() => _database.InitializeAsync();
+
+    public async Task DisposeAsync()
+    {
+        await _database.DisposeAsync();
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task Scan_IndexesArchivesWithGameAndInstaller()
+    {
+        CreateZip("skyrim", "a.zip");
+        CreateZip("fallout4", "b.zip");
+        CreateZip(null, "loose.zip");
+        File.WriteAllText(Path.Combine(_library, "skyrim", "readme.txt"), "not an archive");
+        var index = new DownloadLibraryIndex(_database, _installers);
+
+        var report = await index.ScanAsync(_library);
+
+        report.Archives.Should().HaveCount(3);
+        report.InspectedCount.Should().Be(3);
+        report.Archives.Should().OnlyContain(a => a.InstallerId == CountingInstaller.Id);
+        report.Archives.Single(a => a.FileName == "a.zip").GameDomain.Should().Be("skyrim");
+        report.Archives.Single(a => a.FileName == "b.zip").GameDomain.Should().Be("fallout4");
+        report.Archives.Single(a => a.FileName == "loose.zip").GameDomain.Should().BeNull();
+    }
+
+    [Fact]
+    public async Task Rescan_UnchangedLibraryInspectsNothing()
+    {
+        CreateZip("skyrim", "a.zip");
+        CreateZip("skyrim", "b.zip");
+        var index = new DownloadLibraryIndex(_database, _installers);
+        await index.ScanAsync(_library);
+        var detections = _installer.Detections;
+
+        var report = await index.ScanAsync(_library);
+
+        report.InspectedCount.Should().Be(0);
+        report.UnchangedCount.Should().Be(2);
+        _installer.Detections.Should().Be(detections);
+    }
+
+    [Fact]
+    public async Task Rescan_InspectsOnlyNewAndChangedArchives()
+    {
+        var changed = CreateZip("skyrim", "a.zip");
+        CreateZip("skyrim", "b.zip");
+        var index = new DownloadLibraryIndex(_database, _installers);
+        await index.ScanAsync(_library);
+
+        CreateZip("skyrim", "a.zip", entries: 3);
+        File.SetLastWriteTimeUtc(changed, DateTime.UtcNow.AddMinutes(1));
+        CreateZip("skyrim", "c.zip");
+        var report = await index.ScanAsync(_library);
+
+        report.Archives.Should().HaveCount(3);
+        report.InspectedCount.Should().Be(2);
+        report.UnchangedCount.Should().Be(1);
+    }
+
+    [Fact]
+    public async Task Rescan_DropsDeletedArchives()
+    {
+        var deleted = CreateZip("skyrim", "a.zip");
+        CreateZip("skyrim", "b.zip");
+        var index = new DownloadLibraryIndex(_database, _installers);
+        await index.ScanAsync(_library);
+
+        File.Delete(deleted);
+        var report = await index.ScanAsync(_library);
+
+        report.RemovedCount.Should().Be(1);
+        report.Archives.Should().ContainSingle().Which.FileName.Should().Be("b.zip");
+        (await index.GetIndexedAsync(_library)).Should().ContainSingle();
+    }
+
+    [Fact]
+    public async Task Index_IsPersistedAcrossInstances()
+    {
+        CreateZip("skyrim", "a.zip");
+        await new DownloadLibraryIndex(_database, _installers).ScanAsync(_library);
+        var detections = _installer.Detections;
+
+        var restarted = new DownloadLibraryIndex(_database, _installers);
+        (await restarted.GetIndexedAsync(_library)).Should().ContainSingle()
+            .Which.InstallerId.Should().Be(CountingInstaller.Id);
+
+        var report = await restarted.ScanAsync(_library);
+        report.InspectedCount.Should().Be(0);
+        _installer.Detections.Should().Be(detections);
+    }
+
+    [Fact]
+    public async Task Index_IsScopedToLibraryRoot()
+    {
+        CreateZip("skyrim", "a.zip");
+        var index = new DownloadLibraryIndex(_database, _installers);
+        await index.ScanAsync(_library);
+
+        // A sibling whose name shares the root as a prefix is a different library
+        var sibling = _library + "-old";
+        Directory.CreateDirectory(sibling);
+        (await index.GetIndexedAsync(sibling)).Should().BeEmpty();
+
+        var report = await index.ScanAsync(sibling);
+        report.RemovedCount.Should().Be(0);
+        (await index.GetIndexedAsync(_library)).Should().ContainSingle();
+    }
+
+    [Fact]
+    public async Task Force_ReinspectsEverything()
+    {
+        CreateZip("skyrim", "a.zip");
+        var index = new DownloadLibraryIndex(_database, _installers);
+        await index.ScanAsync(_library);
+
+        var report = await index.ScanAsync(_library, new LibraryScanOptions { Force = true });
+
+        report.InspectedCount.Should().Be(1);
+    }
+
+    private string CreateZip(string? game, string name, int entries = 1)
+    {
+        var directory = game == null ? _library : Path.Combine(_library, game);
+        Directory.CreateDirectory(directory);
+        var path = Path.Combine(directory, name);
+        File.Delete(path);
+
+        using var zip = ZipFile.Open(path, ZipArchiveMode.Create);
+        for (var i = 0; i < entries; i++)
+        {
+            using var writer = new StreamWriter(zip.CreateEntry($"Data/file{i}.esp").Open());
+            writer.Write($"content {i}");
+        }
+
+        return path;
+    }
+
+    private sealed class CountingInstaller : IModInstaller
+    {
+        public const string Id = "counting";
+
+        private int _detections;
+
+        public int Detections => _detections;
+
+        public string InstallerId => Id;
+        public string DisplayName => "Counting";
+        public int Priority => 1000;
+
+        public Task<InstallDetectionResult> DetectAsync(string archivePath, CancellationToken ct = default)
+        {
+            Interlocked.Increment(ref _detections);
+            return Task.FromResult(new InstallDetectionResult { CanHandle = true, Confidence = 1.0 });
+        }
+
+        public Task<InstallPlan> AnalyzeAsync(string archivePath, InstallContext context, CancellationToken ct = default) =>
+            throw new NotSupportedException();
+
+        public Task<InstallResult> InstallAsync(InstallPlan plan, IProgress<InstallProgress>? progress = null, CancellationToken ct = default) =>
+            throw new NotSupportedException();
+    }
+}
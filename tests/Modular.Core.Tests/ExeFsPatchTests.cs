@@ -0,0 +1,222 @@
+using System.Diagnostics;
+using Modular.Switch.DependencyResolver;
+using Modular.Switch.Models;
+using Modular.Switch.Patches;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class ExeFsPatchTests : IDisposable
+{
+    private const string BuildId = "0123456789ABCDEF0123456789ABCDEF01234567";
+
+    private readonly string _testDir;
+
+    public ExeFsPatchTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_exefs_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void ParseIps_ReadsPlainAndRunLengthRecords()
+    {
+        var content = Concat(
+            "PATCH"u8.ToArray(),
+            [0x00, 0x01, 0x00, 0x00, 0x02, 0xAA, 0xBB],
+            [0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x04, 0xCC],
+            "EOF"u8.ToArray());
+
+        var patch = ExeFsPatchParser.Parse($"{BuildId.ToLowerInvariant()}.ips", content, "mod");
+
+        Assert.Equal(ExeFsPatchFormat.Ips, patch.Format);
+        Assert.Equal(BuildId.PadRight(64, '0'), patch.BuildId);
+        Assert.Equal(2, patch.Records.Count);
+        Assert.Equal(0x100, patch.Records[0].Offset);
+        Assert.Equal([0xAA, 0xBB], patch.Records[0].Data);
+        Assert.Equal([0xCC, 0xCC, 0xCC, 0xCC], patch.Records[1].Data);
+    }
+
+    [Fact]
+    public void ParseIps32_ReadsWideOffsets()
+    {
+        var content = Concat("IPS32"u8.ToArray(), [0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x1F], "EEOF"u8.ToArray());
+
+        var patch = ExeFsPatchParser.Parse($"{BuildId}.ips", content, "mod");
+
+        Assert.Equal(ExeFsPatchFormat.Ips32, patch.Format);
+        Assert.Equal(0x1000000, Assert.Single(patch.Records).Offset);
+    }
+
+    [Fact]
+    public void Parse_RejectsMalformedPatches()
+    {
+        Assert.Throws<InvalidDataException>(() => ExeFsPatchParser.Parse($"{BuildId}.ips", "PATCH\0\0"u8, "mod"));
+        Assert.Throws<InvalidDataException>(() => ExeFsPatchParser.Parse($"{BuildId}.ips", "NOTIPS"u8, "mod"));
+        Assert.Throws<InvalidDataException>(() => ExeFsPatchParser.Parse("main.ips", "PATCHEOF"u8, "mod"));
+        Assert.Throws<InvalidDataException>(() => ExeFsPatchParser.ParsePchTxt("@enabled\n0100 AABB\n", "mod"));
+    }
+
+    [Fact]
+    public void ParsePchTxt_AppliesEnabledLinesWithOffsetShift()
+    {
+        var text = $"""
+            @nsobid-{BuildId}
+            [60 FPS]
+            @flag offset_shift 0x100
+            // comment
+            @enabled
+            00001000 1F2003D5 // nop
+            00002000 "hi"
+            @disabled
+            00003000 DEADBEEF
+            @little-endian
+            @enabled
+            00004000 11223344
+            @stop
+            00005000 FFFF
+            """;
+
+        var patch = ExeFsPatchParser.Parse("60fps.pchtxt", System.Text.Encoding.UTF8.GetBytes(text), "mod");
+
+        Assert.Equal(ExeFsPatchFormat.PchTxt, patch.Format);
+        Assert.Equal([0x1100L, 0x2100L, 0x4100L], patch.Records.Select(r => r.Offset));
+        Assert.Equal([0x1F, 0x20, 0x03, 0xD5], patch.Records[0].Data);
+        Assert.Equal("hi"u8.ToArray(), patch.Records[1].Data);
+        Assert.Equal([0x44, 0x33, 0x22, 0x11], patch.Records[2].Data);
+    }
+
+    [Fact]
+    public void IntervalTree_FindsAllOverlappingRanges()
+    {
+        var random = new Random(42);
+        var intervals = Enumerable.Range(0, 2000)
+            .Select(i =>
+            {
+                long start = random.Next(0, 100_000);
+                return (start, start + random.Next(1, 64), i);
+            })
+            .ToList();
+        var tree = new PatchIntervalTree<int>(intervals);
+
+        for (var q = 0; q < 200; q++)
+        {
+            long start = random.Next(0, 100_000);
+            var end = start + random.Next(1, 500);
+            var expected = intervals.Where(i => i.Item1 < end && i.Item2 > start).Select(i => i.Item3).Order();
+
+            Assert.Equal(expected, tree.Query(start, end).Select(r => r.Value).Order());
+        }
+    }
+
+    [Fact]
+    public void FindOverlaps_IgnoresDisjointAndIdenticalWrites()
+    {
+        var a = Patch("mod-a", (0x100, [1, 2, 3, 4]), (0x200, [9]));
+        var b = Patch("mod-b", (0x104, [5, 6]), (0x200, [9]));
+        var c = Patch("mod-c", (0x102, [7, 7, 7, 7]));
+
+        var overlaps = ExeFsPatchMerger.FindOverlaps([a, b, c]);
+
+        Assert.Equal(
+            [
+                new ExeFsPatchOverlap(a.BuildId, 0x102, 0x104, "mod-a", "mod-c"),
+                new ExeFsPatchOverlap(a.BuildId, 0x104, 0x106, "mod-b", "mod-c")
+            ],
+            overlaps);
+        Assert.Empty(ExeFsPatchMerger.FindOverlaps([a, b]));
+    }
+
+    [Fact]
+    public void Merge_CombinesCompatiblePatchesIntoOneIps()
+    {
+        var a = Patch("mod-a", (0x100, [1, 2]), (0x300, [3]));
+        var b = Patch("mod-b", (0x102, [4, 5]), (0x300, [3]));
+        var other = Patch("mod-c", (0x100, [6]));
+        var conflicting = new ExeFsPatch("FEDCBA98", ExeFsPatchFormat.Ips, [new ExeFsPatchRecord(0x100, [1])], "mod-a");
+        var conflicting2 = new ExeFsPatch("FEDCBA98", ExeFsPatchFormat.Ips, [new ExeFsPatchRecord(0x100, [2])], "mod-b");
+
+        var result = ExeFsPatchMerger.Merge([a, b, conflicting, conflicting2]);
+        var merged = Assert.Single(result.Patches);
+        var reparsed = ExeFsPatchParser.Parse($"{merged.BuildId}.ips", ExeFsPatchMerger.ToIps(merged), "merged");
+
+        Assert.Equal([0x100L, 0x300L], reparsed.Records.Select(r => r.Offset));
+        Assert.Equal([1, 2, 4, 5], reparsed.Records[0].Data);
+        Assert.Equal(conflicting.BuildId, Assert.Single(result.Overlaps).BuildId);
+        Assert.True(ExeFsPatchMerger.Merge([a, other]).HasOverlaps);
+    }
+
+    [Fact]
+    public void ToIps_SwitchesToIps32AndSplitsLongRecords()
+    {
+        var data = Enumerable.Range(0, 0x10010).Select(i => (byte)i).ToArray();
+        var patch = new ExeFsPatch(BuildId, ExeFsPatchFormat.Ips, [new ExeFsPatchRecord(0xFFFF00, data)], "mod");
+
+        var ips = ExeFsPatchMerger.ToIps(patch);
+        var reparsed = ExeFsPatchParser.Parse($"{BuildId}.ips", ips, "mod");
+
+        Assert.Equal(ExeFsPatchFormat.Ips32, reparsed.Format);
+        Assert.Equal(2, reparsed.Records.Count);
+        Assert.Equal(data, reparsed.Records.SelectMany(r => r.Data));
+    }
+
+    [Fact]
+    public void ParseAndMerge_HundredsOfPatchesIsFast()
+    {
+        var files = Enumerable.Range(0, 300)
+            .Select(mod => ExeFsPatchMerger.ToIps(Patch($"mod-{mod}",
+                Enumerable.Range(0, 200).Select(r => ((long)(mod * 0x10000 + r * 0x40 + 0x100), new byte[] { (byte)mod, (byte)r })).ToArray())))
+            .ToList();
+
+        var stopwatch = Stopwatch.StartNew();
+        var patches = files.Select((content, mod) => ExeFsPatchParser.Parse($"{BuildId}.ips", content, $"mod-{mod}")).ToList();
+        var result = ExeFsPatchMerger.Merge(patches);
+        stopwatch.Stop();
+
+        Assert.False(result.HasOverlaps);
+        Assert.Equal(60_000, Assert.Single(result.Patches).Records.Count);
+        Assert.True(stopwatch.Elapsed < TimeSpan.FromSeconds(2), $"took {stopwatch.Elapsed}");
+    }
+
+    [Fact]
+    public async Task Detector_ReportsOnlyByteLevelPatchOverlaps()
+    {
+        var disjointA = WriteExeFsMod("disjoint-a", Patch("x", (0x100, [1])));
+        var disjointB = WriteExeFsMod("disjoint-b", Patch("x", (0x200, [2])));
+        var clashing = WriteExeFsMod("clashing", Patch("x", (0x100, [3, 3])));
+
+        var compatible = await SwitchFileOverlapDetector.DetectAsync([disjointA, disjointB]);
+        var report = await SwitchFileOverlapDetector.DetectAsync([disjointA, disjointB, clashing]);
+
+        Assert.False(compatible.HasOverlaps);
+        var overlap = Assert.Single(report.Overlaps);
+        Assert.Equal(["clashing", "disjoint-a"], overlap.ModKeys.Order());
+        Assert.Equal((0x100L, 0x101L), (overlap.PatchRanges[0].Start, overlap.PatchRanges[0].End));
+    }
+
+    private SwitchMod WriteExeFsMod(string name, ExeFsPatch patch)
+    {
+        var dir = Path.Combine(_testDir, name, "exefs");
+        Directory.CreateDirectory(dir);
+        File.WriteAllBytes(Path.Combine(dir, $"{BuildId}.ips"), ExeFsPatchMerger.ToIps(patch));
+        return new SwitchMod
+        {
+            ModKey = name,
+            Name = name,
+            Category = SwitchModCategory.ExeFs,
+            SourcePath = Path.Combine(_testDir, name),
+            IsExtracted = true
+        };
+    }
+
+    private static ExeFsPatch Patch(string source, params (long Offset, byte[] Data)[] records) =>
+        new(BuildId, ExeFsPatchFormat.Ips, records.Select(r => new ExeFsPatchRecord(r.Offset, r.Data)).ToList(), source);
+
+    private static byte[] Concat(params byte[][] parts) => parts.SelectMany(p => p).ToArray();
+}
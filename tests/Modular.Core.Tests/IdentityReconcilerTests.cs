@@ -0,0 +1,234 @@
+using System.Diagnostics;
+using Modular.Core.Identity;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class IdentityReconcilerTests
+{
+    private static readonly IdentityReconcileOptions Options = new();
+
+    [Fact]
+    public void SameHash_LinksAcrossSources()
+    {
+        var plan = Plan(
+            Download("skyrim", 1, 10, path: "/mods/a.zip", md5: "aa"),
+            Upstream("nexusmods", "skyrim", "1", "10", md5: "AA"),
+            Install("c1", path: "/mods/a.zip"));
+
+        Assert.Equal(1, plan.IdentityCount);
+        Assert.Single(plan.Upserts.Select(u => u.Identity).Distinct());
+    }
+
+    [Fact]
+    public void SameBackendMod_Links()
+    {
+        var plan = Plan(
+            Download("skyrim", 1, 10, path: "/mods/a.zip"),
+            Download("skyrim", 1, 11, path: "/mods/b.zip"),
+            Metadata("skyrim", 1, "SkyUI"),
+            Download("skyrim", 2, 20, path: "/mods/c.zip"));
+
+        Assert.Equal(2, plan.IdentityCount);
+    }
+
+    [Fact]
+    public void SimilarNameAndAuthor_LinksAcrossBackends()
+    {
+        var plan = Plan(
+            Canonical("nexusmods", "skyrim", "12604", "SkyUI", "schlangster"),
+            Canonical("gamebanana", "skyrim", "500", "SkyUI SE", "Schlangster"));
+
+        Assert.Equal(1, plan.IdentityCount);
+    }
+
+    [Fact]
+    public void SimilarName_DoesNotJoinTwoModsOfOneBackend()
+    {
+        var plan = Plan(
+            Canonical("nexusmods", "skyrim", "1", "Immersive Armors", "hothtrooper"),
+            Canonical("nexusmods", "skyrim", "2", "Immersive Armours", "hothtrooper"));
+
+        Assert.Equal(2, plan.IdentityCount);
+    }
+
+    [Fact]
+    public void SimilarName_WithoutAuthor_NeedsStricterMatch()
+    {
+        var plan = Plan(
+            Canonical("nexusmods", "skyrim", "1", "Unofficial Skyrim Patch", "usep team"),
+            Library("/lib/Unofficial Skyrim Patch-1-4-2.7z", "skyrim"),
+            Library("/lib/Unofficial Skyrim Patch Extras-3-1.7z", "skyrim"));
+
+        Assert.Equal(2, plan.IdentityCount);
+        Assert.Equal(
+            plan.Upserts.Single(u => u.Record.Key == "canonical:nexusmods:skyrim:1").Identity,
+            plan.Upserts.Single(u => u.Record.Key == "library:/lib/Unofficial Skyrim Patch-1-4-2.7z").Identity);
+    }
+
+    [Fact]
+    public void UnchangedRecords_PlanNothing()
+    {
+        var records = new[] { Download("skyrim", 1, 10, path: "/mods/a.zip"), Install("c1", path: "/mods/a.zip") };
+        var stored = Store(IdentityReconciler.Plan(Stored(), records, Options));
+
+        var plan = IdentityReconciler.Plan(stored, records, Options);
+
+        Assert.True(plan.IsEmpty);
+        Assert.Equal(1, plan.IdentityCount);
+    }
+
+    [Fact]
+    public void NewRecord_BridgingTwoIdentities_MergesTheSmallerOne()
+    {
+        var records = new List<IdentityRecord>
+        {
+            Download("skyrim", 1, 10, path: "/mods/a.zip"),
+            Download("skyrim", 1, 11, path: "/mods/b.zip"),
+            Library("/mods/c.zip", "skyrim")
+        };
+        var stored = Store(IdentityReconciler.Plan(Stored(), records, Options));
+        var big = stored["download:skyrim:1:10"].Identity;
+
+        records.Add(Upstream("nexusmods", "skyrim", "1", "12", path: "/mods/c.zip"));
+        var plan = IdentityReconciler.Plan(stored, records, Options);
+
+        Assert.Equal(1, plan.IdentityCount);
+        var upsert = Assert.Single(plan.Upserts);
+        Assert.Equal(big, upsert.Identity);
+        Assert.Equal(big, Assert.Single(plan.Merges).Value);
+    }
+
+    [Fact]
+    public void RemovedBridge_SplitsTheIdentity()
+    {
+        var records = new List<IdentityRecord>
+        {
+            Download("skyrim", 1, 10, path: "/mods/a.zip"),
+            Library("/mods/a.zip", "skyrim"),
+            Install("c1", path: "/mods/b.zip"),
+            Library("/mods/b.zip", "skyrim"),
+            Upstream("nexusmods", "skyrim", "1", "11", path: "/mods/b.zip")
+        };
+        var stored = Store(IdentityReconciler.Plan(Stored(), records, Options));
+        Assert.Single(stored.Values.Select(s => s.Identity).Distinct());
+
+        records.RemoveAt(4);
+        var plan = IdentityReconciler.Plan(stored, records, Options);
+
+        Assert.Equal(2, plan.IdentityCount);
+        Assert.Equal("upstream:nexusmods:skyrim:1:11", Assert.Single(plan.Deletes));
+        Assert.Empty(plan.Upserts);
+        Assert.NotEmpty(plan.Relabels);
+    }
+
+    [Fact]
+    public void LargeLibrary_ReconcilesIncrementally()
+    {
+        // 50k records: per mod a download, a library archive, metadata and an upstream file
+        var records = new List<IdentityRecord>();
+        for (var mod = 1; mod <= 12_500; mod++)
+        {
+            var path = $"/mods/skyrim/mod-{mod}.zip";
+            records.Add(Download("skyrim", mod, mod * 10, path: path, md5: $"{mod:x8}"));
+            records.Add(Library(path, "skyrim"));
+            records.Add(Metadata("skyrim", mod, $"Mod {mod} {(char)('a' + mod % 26)}{(char)('a' + mod / 26 % 26)}"));
+            records.Add(Upstream("nexusmods", "skyrim", mod.ToString(), (mod * 10).ToString(), md5: $"{mod:x8}"));
+        }
+
+        var stopwatch = Stopwatch.StartNew();
+        var first = IdentityReconciler.Plan(Stored(), records, Options);
+        var full = stopwatch.Elapsed;
+        Assert.Equal(12_500, first.IdentityCount);
+        Assert.Equal(50_000, first.AddedCount);
+
+        var stored = Store(first);
+        records.Add(Download("skyrim", 7, 71, path: "/mods/skyrim/mod-7-update.zip"));
+        stopwatch.Restart();
+        var second = IdentityReconciler.Plan(stored, records, Options);
+
+        Assert.Equal(1, second.AddedCount);
+        Assert.Empty(second.Relabels);
+        Assert.Empty(second.Merges);
+        Assert.Equal(12_500, second.IdentityCount);
+        Assert.True(full < TimeSpan.FromSeconds(5), $"full reconcile took {full}");
+        Assert.True(stopwatch.Elapsed < TimeSpan.FromSeconds(2), $"incremental reconcile took {stopwatch.Elapsed}");
+    }
+
+    [Fact]
+    public void NormalizeName_DropsVersionsAndIds()
+    {
+        Assert.Equal("skyui se", IdentityReconciler.NormalizeName("SkyUI_5_2_SE-12604-5-2SE-1573"));
+        Assert.Equal("better dialogue controls", IdentityReconciler.NormalizeName("Better Dialogue Controls v1.2"));
+    }
+
+    private static IdentityPlan Plan(params IdentityRecord[] records) =>
+        IdentityReconciler.Plan(Stored(), records, Options);
+
+    private static Dictionary<string, StoredIdentity> Stored() => new(StringComparer.Ordinal);
+
+    private static Dictionary<string, StoredIdentity> Store(IdentityPlan plan) =>
+        plan.Upserts.ToDictionary(u => u.Record.Key, u => new StoredIdentity(u.Record, u.Identity), StringComparer.Ordinal);
+
+    private static IdentityRecord Download(string domain, int modId, int fileId, string? path = null, string? md5 = null) => new()
+    {
+        Key = $"download:{domain}:{modId}:{fileId}",
+        Source = IdentitySources.Download,
+        Backend = "nexusmods",
+        GameDomain = domain,
+        ModId = modId.ToString(),
+        FileId = fileId.ToString(),
+        ArchivePath = path,
+        ArchiveHash = md5 == null ? null : "md5:" + md5
+    };
+
+    private static IdentityRecord Upstream(string backend, string domain, string modId, string fileId, string? md5 = null, string? path = null) => new()
+    {
+        Key = $"upstream:{backend}:{domain}:{modId}:{fileId}",
+        Source = IdentitySources.Upstream,
+        Backend = backend,
+        GameDomain = domain,
+        ModId = modId,
+        FileId = fileId,
+        ArchivePath = path,
+        ArchiveHash = md5 == null ? null : "md5:" + md5,
+        UploadedAt = 1_700_000_000
+    };
+
+    private static IdentityRecord Install(string changesetId, string? path = null) => new()
+    {
+        Key = $"install:{changesetId}",
+        Source = IdentitySources.Install,
+        ArchivePath = path
+    };
+
+    private static IdentityRecord Library(string path, string? domain) => new()
+    {
+        Key = $"library:{path}",
+        Source = IdentitySources.Library,
+        GameDomain = domain,
+        Name = Path.GetFileNameWithoutExtension(path),
+        ArchivePath = path
+    };
+
+    private static IdentityRecord Metadata(string domain, int modId, string name) => new()
+    {
+        Key = $"metadata:{domain}:{modId}",
+        Source = IdentitySources.Metadata,
+        Backend = "nexusmods",
+        GameDomain = domain,
+        ModId = modId.ToString(),
+        Name = name
+    };
+
+    private static IdentityRecord Canonical(string backend, string domain, string modId, string name, string author) => new()
+    {
+        Key = $"canonical:{backend}:{domain}:{modId}",
+        Source = IdentitySources.Canonical,
+        Backend = backend,
+        GameDomain = domain,
+        ModId = modId,
+        Name = name,
+        Author = author
+    };
+}
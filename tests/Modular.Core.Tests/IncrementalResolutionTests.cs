@@ -0,0 +1,244 @@
+using System.Diagnostics;
+using Modular.Core.Dependencies;
+using Modular.Core.Metadata;
+using Modular.Core.Versioning;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class IncrementalResolutionTests : IDisposable
+{
+    private static readonly string[] Constraints = ["", ">=1.0.0", "^1.0.0", "<2.0.0", ">=1.1.0", "~1.0.0"];
+
+    private readonly string _testDir;
+
+    public IncrementalResolutionTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_resolution_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task RandomEdits_MatchFullSolve()
+    {
+        for (var seed = 0; seed < 40; seed++)
+        {
+            var random = new Random(seed);
+            var provider = FakeProvider.Random(random, modCount: 60);
+            var roots = Enumerable.Range(0, 15).Select(_ => RandomRoot(random, 60)).DistinctBy(r => r.canonicalId).ToList();
+            var incremental = new GreedyDependencyResolver(provider, cache: new ResolutionCache());
+
+            await AssertSameAsFullSolve(incremental, provider, roots, $"seed {seed} initial");
+
+            for (var edit = 0; edit < 15; edit++)
+            {
+                switch (random.Next(4))
+                {
+                    case 0:
+                        var index = random.Next(roots.Count);
+                        roots[index] = (roots[index].canonicalId, RandomConstraint(random));
+                        break;
+                    case 1 when roots.Count > 1:
+                        roots.RemoveAt(random.Next(roots.Count));
+                        break;
+                    case 1:
+                    case 2:
+                        var root = RandomRoot(random, 60);
+                        if (roots.All(r => r.canonicalId != root.canonicalId))
+                            roots.Add(root);
+                        break;
+                    default:
+                        provider.PublishRandomVersion(random, $"m{random.Next(60)}");
+                        break;
+                }
+
+                await AssertSameAsFullSolve(incremental, provider, roots, $"seed {seed} edit {edit}");
+            }
+        }
+    }
+
+    [Fact]
+    public async Task SingleModEdit_OnLargeProfileOnlyTouchesItsSubgraph()
+    {
+        // 1,000 mods over 50 shared libraries
+        var provider = new FakeProvider();
+        for (var lib = 0; lib < 50; lib++)
+            provider.Add($"lib{lib}", ["1.0.0", "1.1.0", "2.0.0"]);
+        for (var mod = 0; mod < 1000; mod++)
+            provider.Add($"mod{mod}", ["1.0.0", "1.2.0"], ($"lib{mod % 50}", "<2.0.0"), ($"lib{(mod * 7) % 50}", ">=1.0.0"));
+
+        var roots = Enumerable.Range(0, 1000).Select(i => ($"mod{i}", (VersionRange?)null)).ToList();
+        var resolver = new GreedyDependencyResolver(provider, cache: new ResolutionCache());
+        var first = await resolver.ResolveAsync(roots);
+        Assert.True(first.Success, first.FailureReason);
+        Assert.Equal(1050, first.ResolvedVersions.Count);
+
+        roots[500] = ("mod500", VersionRange.Parse("<1.2.0"));
+        provider.Calls = 0;
+        var stopwatch = Stopwatch.StartNew();
+        var edited = await resolver.ResolveAsync(roots);
+        stopwatch.Stop();
+
+        Assert.True(edited.Success, edited.FailureReason);
+        Assert.Equal(SemanticVersion.Parse("1.0.0"), edited.ResolvedVersions["mod500"]);
+        Assert.Equal(["mod500"], edited.ReResolvedMods);
+        Assert.Equal(1, provider.Calls);
+        Assert.NotEqual(first.Fingerprint, edited.Fingerprint);
+        Assert.True(stopwatch.ElapsedMilliseconds < 500, $"took {stopwatch.ElapsedMilliseconds} ms");
+
+        var full = await new GreedyDependencyResolver(provider).ResolveAsync(roots);
+        Assert.Equal(Describe(full), Describe(edited));
+    }
+
+    [Fact]
+    public async Task PersistedCache_IsReusedByTheNextProcess()
+    {
+        var path = Path.Combine(_testDir, "profile.json");
+        var provider = FakeProvider.Random(new Random(7), modCount: 30);
+        var roots = Enumerable.Range(0, 10).Select(i => ($"m{i}", (VersionRange?)null)).ToList();
+
+        var first = await new GreedyDependencyResolver(provider, cache: new ResolutionCache(path)).ResolveAsync(roots);
+        provider.Calls = 0;
+        var second = await new GreedyDependencyResolver(provider, cache: new ResolutionCache(path)).ResolveAsync(roots);
+
+        Assert.Equal(0, provider.Calls);
+        Assert.Empty(second.ReResolvedMods);
+        Assert.Equal(first.Fingerprint, second.Fingerprint);
+        Assert.Equal(Describe(first), Describe(second));
+
+        provider.PublishRandomVersion(new Random(1), "m3");
+        var third = await new GreedyDependencyResolver(provider, cache: new ResolutionCache(path)).ResolveAsync(roots);
+        Assert.Contains("m3", third.ReResolvedMods);
+        Assert.NotEqual(first.Fingerprint, third.Fingerprint);
+    }
+
+    [Fact]
+    public async Task UnversionedProviderData_ExpiresAfterMaxAge()
+    {
+        var provider = FakeProvider.Random(new Random(3), modCount: 20);
+        provider.ReportsDataVersions = false;
+        var roots = Enumerable.Range(0, 5).Select(i => ($"m{i}", (VersionRange?)null)).ToList();
+
+        var trusting = new GreedyDependencyResolver(provider, cache: new ResolutionCache());
+        await trusting.ResolveAsync(roots);
+        provider.Calls = 0;
+        await trusting.ResolveAsync(roots);
+        Assert.Equal(0, provider.Calls);
+
+        var expiring = new GreedyDependencyResolver(provider, cache: new ResolutionCache(maxUnversionedAge: TimeSpan.Zero));
+        var first = await expiring.ResolveAsync(roots);
+        provider.Calls = 0;
+        var second = await expiring.ResolveAsync(roots);
+        Assert.True(provider.Calls > 0);
+        Assert.Equal(first.ReResolvedMods, second.ReResolvedMods);
+    }
+
+    private static async Task AssertSameAsFullSolve(
+        GreedyDependencyResolver incremental,
+        FakeProvider provider,
+        List<(string canonicalId, VersionRange? constraint)> roots,
+        string step)
+    {
+        var expected = await new GreedyDependencyResolver(provider).ResolveAsync(roots.ToList());
+        var actual = await incremental.ResolveAsync(roots.ToList());
+
+        Assert.True(Describe(expected) == Describe(actual), $"{step}:\n{Describe(expected)}\n!=\n{Describe(actual)}");
+    }
+
+    private static string Describe(ResolutionResult result) =>
+        $"{result.Success} {result.FailureReason}\n"
+        + string.Join(",", result.ResolvedVersions.OrderBy(kv => kv.Key, StringComparer.Ordinal).Select(kv => $"{kv.Key}@{kv.Value}")) + "\n"
+        + string.Join(",", result.InstallOrder.Select(n => n.CanonicalId)) + "\n"
+        + string.Join(",", result.Conflicts.Select(c => $"{c.Type}:{c.CanonicalId}"));
+
+    private static (string canonicalId, VersionRange? constraint) RandomRoot(Random random, int modCount) =>
+        ($"m{random.Next(modCount)}", RandomConstraint(random));
+
+    private static VersionRange? RandomConstraint(Random random)
+    {
+        var constraint = Constraints[random.Next(Constraints.Length)];
+        return constraint.Length == 0 ? null : VersionRange.Parse(constraint);
+    }
+
+    private sealed class FakeProvider : IModVersionProvider
+    {
+        private readonly Dictionary<string, Dictionary<SemanticVersion, List<ModDependency>>> _mods = new();
+        private readonly Dictionary<string, int> _dataVersions = new();
+
+        public int Calls { get; set; }
+        public bool ReportsDataVersions { get; set; } = true;
+
+        public static FakeProvider Random(Random random, int modCount)
+        {
+            var provider = new FakeProvider();
+            for (var mod = 0; mod < modCount; mod++)
+            {
+                var versionCount = random.Next(1, 4);
+                for (var v = 0; v < versionCount; v++)
+                    provider.PublishRandomVersion(random, $"m{mod}", $"{random.Next(1, 3)}.{random.Next(0, 3)}.0");
+            }
+
+            return provider;
+        }
+
+        public void Add(string id, string[] versions, params (string Target, string Constraint)[] dependencies)
+        {
+            foreach (var version in versions)
+                Publish(id, version, dependencies.Select(d => Dependency(d.Target, d.Constraint, DependencyType.Required)).ToList());
+        }
+
+        public void PublishRandomVersion(Random random, string id, string? version = null)
+        {
+            var index = int.Parse(id[1..]);
+            var dependencies = new List<ModDependency>();
+            for (var d = random.Next(0, 3); d > 0; d--)
+            {
+                // Mostly forward edges, so cycles stay rare
+                var target = random.Next(10) == 0 ? random.Next(index + 1) : index + 1 + random.Next(20);
+                var type = random.Next(12) == 0 ? DependencyType.Incompatible : DependencyType.Required;
+                dependencies.Add(Dependency($"m{target}", Constraints[random.Next(Constraints.Length)], type));
+            }
+
+            Publish(id, version ?? $"{random.Next(1, 3)}.{random.Next(0, 5)}.{random.Next(0, 3)}", dependencies);
+        }
+
+        private void Publish(string id, string version, List<ModDependency> dependencies)
+        {
+            if (!_mods.TryGetValue(id, out var versions))
+                _mods[id] = versions = new();
+
+            versions[SemanticVersion.Parse(version)] = dependencies;
+            _dataVersions[id] = _dataVersions.GetValueOrDefault(id) + 1;
+        }
+
+        public Task<List<SemanticVersion>> GetAvailableVersionsAsync(string canonicalId, CancellationToken ct = default)
+        {
+            Calls++;
+            return Task.FromResult(_mods.TryGetValue(canonicalId, out var versions) ? versions.Keys.ToList() : []);
+        }
+
+        public Task<List<ModDependency>> GetDependenciesAsync(string canonicalId, SemanticVersion version, CancellationToken ct = default)
+        {
+            Calls++;
+            return Task.FromResult(_mods[canonicalId][version].ToList());
+        }
+
+        public Task<Dictionary<string, string>> GetDataVersionsAsync(IReadOnlyCollection<string> canonicalIds, CancellationToken ct = default) =>
+            Task.FromResult(ReportsDataVersions
+                ? canonicalIds.ToDictionary(id => id, id => _dataVersions.GetValueOrDefault(id).ToString())
+                : new Dictionary<string, string>());
+
+        private static ModDependency Dependency(string target, string constraint, DependencyType type) => new()
+        {
+            Type = type,
+            Target = new DependencyTarget { ProjectId = target },
+            Constraint = constraint.Length == 0 ? null : constraint
+        };
+    }
+}
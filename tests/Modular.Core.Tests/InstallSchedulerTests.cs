@@ -0,0 +1,171 @@
+using FluentAssertions;
+using Modular.Core.Installers;
+using Modular.Sdk.Installers;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class InstallSchedulerTests
+{
+    // /hdd/* is one spinning disk, /ssd/* one solid-state disk
+    private static readonly InstallSchedulerOptions FakeDevices = new()
+    {
+        RotationalConcurrency = 1,
+        SolidStateConcurrency = 2,
+        DeviceResolver = path => path.StartsWith("/hdd", StringComparison.Ordinal)
+            ? new InstallDevice("hdd", true)
+            : new InstallDevice("ssd", false)
+    };
+
+    [Fact]
+    public async Task Schedule_RunsDevicesInParallelAndRespectsBudgets()
+    {
+        using var scheduler = new InstallScheduler(FakeDevices);
+        var tracker = new ConcurrencyTracker();
+
+        var operations = new List<ScheduledInstall<int>>();
+        for (var i = 0; i < 4; i++)
+        {
+            operations.Add(scheduler.Schedule($"hdd{i}", $"/hdd/game{i}", (_, ct) => tracker.RunAsync("hdd", ct)));
+            operations.Add(scheduler.Schedule($"ssd{i}", $"/ssd/game{i}", (_, ct) => tracker.RunAsync("ssd", ct)));
+        }
+
+        await Task.WhenAll(operations.Select(o => o.Result));
+
+        tracker.MaxConcurrent("hdd").Should().Be(1);
+        tracker.MaxConcurrent("ssd").Should().Be(2);
+        tracker.MaxConcurrentOverall.Should().BeGreaterThan(1, "separate devices must not wait on each other");
+    }
+
+    [Fact]
+    public async Task Schedule_SameTarget_RunsSeriallyInPriorityOrder()
+    {
+        using var scheduler = new InstallScheduler(FakeDevices);
+        var gate = new TaskCompletionSource();
+        var order = new List<string>();
+
+        Func<IProgress<InstallProgress>, CancellationToken, Task<bool>> Record(string name, Task? wait = null) =>
+            async (_, _) =>
+            {
+                lock (order) order.Add(name);
+                if (wait != null) await wait;
+                return true;
+            };
+
+        // The first blocks the target while the rest queue up behind it
+        var first = scheduler.Schedule("first", "/ssd/game", Record("first", gate.Task));
+        var low = scheduler.Schedule("low", "/ssd/game", Record("low"));
+        var high = scheduler.Schedule("high", "/ssd/game", Record("high"), priority: 10);
+        var normal = scheduler.Schedule("normal", "/ssd/game", Record("normal"));
+
+        gate.SetResult();
+        await Task.WhenAll(first.Result, low.Result, high.Result, normal.Result);
+
+        order.Should().Equal("first", "high", "low", "normal");
+    }
+
+    [Fact]
+    public async Task Cancel_QueuedOperation_NeverRuns()
+    {
+        using var scheduler = new InstallScheduler(FakeDevices);
+        var gate = new TaskCompletionSource();
+        var ran = false;
+
+        var blocker = scheduler.Schedule("blocker", "/hdd/a", async (_, _) => { await gate.Task; return 0; });
+        var queued = scheduler.Schedule("queued", "/hdd/b", (_, _) => { ran = true; return Task.FromResult(0); });
+
+        queued.Cancel();
+        gate.SetResult();
+        await blocker.Result;
+
+        var act = () => queued.Result;
+        await act.Should().ThrowAsync<OperationCanceledException>();
+        queued.State.Should().Be(ScheduledInstallState.Cancelled);
+        ran.Should().BeFalse();
+    }
+
+    [Fact]
+    public async Task Cancel_RunningOperation_CancelsItsToken()
+    {
+        using var scheduler = new InstallScheduler(FakeDevices);
+        using var cts = new CancellationTokenSource();
+        var started = new TaskCompletionSource();
+
+        var operation = scheduler.Schedule("long", "/ssd/game", async (_, ct) =>
+        {
+            started.SetResult();
+            await Task.Delay(Timeout.Infinite, ct);
+            return 0;
+        }, ct: cts.Token);
+
+        await started.Task;
+        cts.Cancel();
+
+        var act = () => operation.Result;
+        await act.Should().ThrowAsync<OperationCanceledException>();
+        operation.State.Should().Be(ScheduledInstallState.Cancelled);
+    }
+
+    [Fact]
+    public async Task GetProgress_AggregatesAcrossOperations()
+    {
+        using var scheduler = new InstallScheduler(FakeDevices);
+        var halfway = new TaskCompletionSource();
+        var finish = new TaskCompletionSource();
+
+        scheduler.Schedule("done", "/ssd/a", (_, _) => Task.FromResult(0));
+        scheduler.Schedule("failing", "/ssd/b", (_, _) => Task.FromException<int>(new IOException("disk full")));
+        scheduler.Schedule("half", "/hdd/c", async (progress, _) =>
+        {
+            progress.Report(new InstallProgress { FilesProcessed = 1, TotalFiles = 2 });
+            halfway.SetResult();
+            await finish.Task;
+            return 0;
+        });
+
+        await halfway.Task;
+        var snapshot = scheduler.GetProgress();
+        snapshot.Total.Should().Be(3);
+        snapshot.Running.Should().BeGreaterThanOrEqualTo(1);
+
+        finish.SetResult();
+        await scheduler.WhenIdleAsync();
+
+        var final = scheduler.GetProgress();
+        final.Succeeded.Should().Be(2);
+        final.Failed.Should().Be(1);
+        final.IsIdle.Should().BeTrue();
+        final.Percentage.Should().Be(100);
+    }
+
+    private sealed class ConcurrencyTracker
+    {
+        private readonly Dictionary<string, (int Current, int Max)> _devices = new();
+        private int _overall;
+
+        public int MaxConcurrentOverall { get; private set; }
+
+        public int MaxConcurrent(string device) => _devices[device].Max;
+
+        public async Task<int> RunAsync(string device, CancellationToken ct)
+        {
+            lock (_devices)
+            {
+                var (current, max) = _devices.GetValueOrDefault(device);
+                _devices[device] = (current + 1, Math.Max(max, current + 1));
+                MaxConcurrentOverall = Math.Max(MaxConcurrentOverall, ++_overall);
+            }
+
+            await Task.Delay(50, ct);
+
+            lock (_devices)
+            {
+                var (current, max) = _devices[device];
+                _devices[device] = (current - 1, max);
+                _overall--;
+            }
+
+            return 0;
+        }
+    }
+}
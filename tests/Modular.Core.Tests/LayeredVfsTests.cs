@@ -0,0 +1,225 @@
+using Modular.Core.VirtualFileSystem;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class LayeredVfsTests : IDisposable
+{
+    private readonly string _testDir;
+
+    public LayeredVfsTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_vfs_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void Resolve_PicksHighestPriorityLayer()
+    {
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(new VfsLayer("base", "/game", 0, ["Data/Skyrim.esm", "Data/Textures/sky.dds"]));
+        resolver.AddLayer(new VfsLayer("hd-sky", "/mods/hd-sky", 20, ["Data/Textures/sky.dds"]));
+        resolver.AddLayer(new VfsLayer("sky-lite", "/mods/sky-lite", 10, ["Data/Textures/sky.dds"]));
+
+        var sky = resolver.Resolve("Data/Textures/sky.dds")!;
+        var esm = resolver.Resolve("Data/Skyrim.esm")!;
+
+        Assert.Equal("hd-sky", sky.LayerId);
+        Assert.Equal(Path.Combine("/mods/hd-sky", "Data", "Textures", "sky.dds"), sky.PhysicalPath);
+        Assert.Equal(["hd-sky", "sky-lite", "base"], resolver.GetProviders("Data/Textures/sky.dds"));
+        Assert.Equal("base", esm.LayerId);
+        Assert.True(resolver.Resolve("Data/Textures")!.IsDirectory);
+        Assert.Null(resolver.Resolve("Data/Meshes"));
+    }
+
+    [Fact]
+    public void Resolve_IgnoresCaseAndKeepsFirstSeenCasing()
+    {
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(new VfsLayer("base", "/game", 0, ["data/textures/sky.dds"]));
+        resolver.AddLayer(new VfsLayer("mod", "/mods/mod", 1, [@"Data\Textures\Sky.DDS"]));
+
+        var entry = resolver.Resolve("DATA/TEXTURES/SKY.dds")!;
+
+        Assert.Equal("mod", entry.LayerId);
+        Assert.Equal("data/textures/sky.dds", entry.Path);
+        Assert.Equal(Path.Combine("/mods/mod", "Data", "Textures", "Sky.DDS"), entry.PhysicalPath);
+    }
+
+    [Fact]
+    public void EqualPriority_LayerAddedLastWins()
+    {
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(new VfsLayer("first", "/a", 5, ["file.txt"]));
+        resolver.AddLayer(new VfsLayer("second", "/b", 5, ["file.txt"]));
+
+        Assert.Equal("second", resolver.Resolve("file.txt")!.LayerId);
+        Assert.Equal(["second", "first"], resolver.Layers);
+    }
+
+    [Fact]
+    public void RemoveLayer_RevealsNextLayerAndDropsEmptyDirectories()
+    {
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(new VfsLayer("base", "/game", 0, ["Data/Skyrim.esm"]));
+        resolver.AddLayer(new VfsLayer("mod", "/mods/mod", 1, ["Data/Skyrim.esm", "Data/Scripts/Extra/a.pex"]));
+
+        Assert.True(resolver.RemoveLayer("mod"));
+
+        Assert.Equal("base", resolver.Resolve("Data/Skyrim.esm")!.LayerId);
+        Assert.Null(resolver.Resolve("Data/Scripts"));
+        Assert.Equal([new VfsDirectoryEntry("Skyrim.esm", false)], resolver.ListDirectory("Data"));
+        Assert.False(resolver.RemoveLayer("mod"));
+    }
+
+    [Fact]
+    public void ListDirectory_MergesChildrenOfAllLayers()
+    {
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(new VfsLayer("base", "/game", 0, ["Data/Skyrim.esm", "Data/Textures/sky.dds", "game.exe"]));
+        resolver.AddLayer(new VfsLayer("mod", "/mods/mod", 1, ["Data/Mod.esp", "data/textures/ground.dds"]));
+
+        var data = resolver.ListDirectory("Data")!.OrderBy(e => e.Name, StringComparer.Ordinal).ToList();
+
+        Assert.Equal(
+            [new("Mod.esp", false), new("Skyrim.esm", false), new VfsDirectoryEntry("Textures", true)],
+            data);
+        Assert.Equal(2, resolver.ListDirectory("Data/Textures")!.Count);
+        Assert.Equal(2, resolver.ListDirectory("")!.Count);
+        Assert.Null(resolver.ListDirectory("game.exe"));
+    }
+
+    [Fact]
+    public void ManyLayers_AddAndRemoveOnlyTouchTheirOwnPaths()
+    {
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(new VfsLayer("base", "/game", 0,
+            Enumerable.Range(0, 5000).Select(i => $"Data/Textures/{i % 50}/{i}.dds")));
+        for (var mod = 1; mod <= 100; mod++)
+        {
+            var files = Enumerable.Range(0, 500).Select(i => $"Data/Textures/{i % 50}/{(i * mod) % 5000}.dds");
+            resolver.AddLayer(new VfsLayer($"mod-{mod}", $"/mods/{mod}", mod, files));
+        }
+
+        // 0.dds is in every mod, so the highest priority one wins until it's removed
+        Assert.Equal("mod-100", resolver.Resolve("Data/Textures/0/0.dds")!.LayerId);
+        resolver.RemoveLayer("mod-100");
+        Assert.Equal("mod-99", resolver.Resolve("Data/Textures/0/0.dds")!.LayerId);
+
+        for (var mod = 1; mod < 100; mod++)
+            resolver.RemoveLayer($"mod-{mod}");
+
+        Assert.Equal(["base"], resolver.GetProviders("Data/Textures/0/0.dds"));
+        Assert.Equal("base", resolver.Resolve("data/textures/7/4957.DDS")!.LayerId);
+        Assert.Equal(100, resolver.ListDirectory("Data/Textures/7")!.Count);
+    }
+
+    [Fact]
+    public void Overlay_WriteCopiesUpAndLeavesLowerLayerUntouched()
+    {
+        var (overlay, gameDir) = CreateOverlay();
+
+        var target = overlay.PrepareWrite("data/skyrim.ini");
+        File.AppendAllText(target, "[Display]\n");
+
+        Assert.Equal(VfsOverlay.LayerId, overlay.Resolver.Resolve("Data/Skyrim.ini")!.LayerId);
+        Assert.Equal(Path.Combine(overlay.OverlayDirectory, "Data", "Skyrim.ini"), target);
+        Assert.Equal("[General]\n[Display]\n", File.ReadAllText(target));
+        Assert.Equal("[General]\n", File.ReadAllText(Path.Combine(gameDir, "Data", "Skyrim.ini")));
+    }
+
+    [Fact]
+    public void Overlay_OnlyDeletesItsOwnFiles()
+    {
+        var (overlay, gameDir) = CreateOverlay();
+        overlay.PrepareWrite("Data/Skyrim.ini");
+
+        overlay.DeleteFile("Data/Skyrim.ini");
+
+        // The game's copy shows through again and can't itself be deleted
+        Assert.Equal("base", overlay.Resolver.Resolve("Data/Skyrim.ini")!.LayerId);
+        var refused = Assert.Throws<VfsOverlayException>(() => overlay.DeleteFile("Data/Skyrim.ini"));
+        Assert.Equal(VfsOverlayError.ReadOnly, refused.Error);
+        Assert.True(File.Exists(Path.Combine(gameDir, "Data", "Skyrim.ini")));
+    }
+
+    [Fact]
+    public void Overlay_CreatesDirectoriesAndRenamesFilesInMergedCasing()
+    {
+        var (overlay, _) = CreateOverlay();
+
+        overlay.CreateDirectory("DATA/Saves");
+        var save = overlay.CreateFile("data/saves/quick.tmp");
+        File.WriteAllText(save, "save");
+        overlay.RenameFile("Data/Saves/quick.tmp", "Data/Saves/quick.ess");
+
+        Assert.Null(overlay.Resolver.Resolve("Data/Saves/quick.tmp"));
+        Assert.Equal("Data/Saves/quick.ess", overlay.Resolver.Resolve("data/saves/QUICK.ESS")!.Path);
+        Assert.Equal("save", File.ReadAllText(Path.Combine(overlay.OverlayDirectory, "Data", "Saves", "quick.ess")));
+        Assert.Equal(VfsOverlayError.NotEmpty,
+            Assert.Throws<VfsOverlayException>(() => overlay.DeleteDirectory("Data/Saves")).Error);
+        Assert.Equal(VfsOverlayError.Exists,
+            Assert.Throws<VfsOverlayException>(() => overlay.CreateDirectory("Data/Saves")).Error);
+    }
+
+    [Fact]
+    public void Overlay_PicksUpFilesFromEarlierSessions()
+    {
+        var (overlay, gameDir) = CreateOverlay();
+        File.WriteAllText(overlay.PrepareWrite("Data/Skyrim.ini"), "[Changed]\n");
+        overlay.CreateDirectory("Logs");
+
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(VfsLayer.FromDirectory("base", gameDir, 0));
+        var reopened = new VfsOverlay(resolver, overlay.OverlayDirectory);
+
+        Assert.Equal(VfsOverlay.LayerId, reopened.Resolver.Resolve("Data/Skyrim.ini")!.LayerId);
+        Assert.True(reopened.Resolver.Resolve("Logs")!.IsDirectory);
+    }
+
+    [Fact]
+    public void FuseMount_ServesMergedViewWithOverlayWrites()
+    {
+        // Only where libfuse 3 and /dev/fuse are available
+        if (!FuseMount.IsSupported)
+            return;
+
+        var (overlay, gameDir) = CreateOverlay();
+        var modDir = Path.Combine(_testDir, "mod");
+        Directory.CreateDirectory(Path.Combine(modDir, "Data"));
+        File.WriteAllText(Path.Combine(modDir, "Data", "Mod.esp"), "mod plugin");
+        overlay.Resolver.AddLayer(VfsLayer.FromDirectory("mod", modDir, 1));
+        var mountPoint = Path.Combine(_testDir, "mnt");
+
+        using (FuseMount.Mount(overlay, mountPoint))
+        {
+            Assert.Equal("mod plugin", File.ReadAllText(Path.Combine(mountPoint, "Data", "Mod.esp")));
+            Assert.Equal(
+                ["Mod.esp", "Skyrim.ini"],
+                Directory.EnumerateFiles(Path.Combine(mountPoint, "Data")).Select(Path.GetFileName).Order().ToArray());
+
+            File.WriteAllText(Path.Combine(mountPoint, "Data", "Skyrim.ini"), "[Mounted]\n");
+            Assert.Equal("[Mounted]\n", File.ReadAllText(Path.Combine(mountPoint, "Data", "Skyrim.ini")));
+        }
+
+        Assert.Equal("[General]\n", File.ReadAllText(Path.Combine(gameDir, "Data", "Skyrim.ini")));
+        Assert.Equal("[Mounted]\n", File.ReadAllText(Path.Combine(overlay.OverlayDirectory, "Data", "Skyrim.ini")));
+    }
+
+    private (VfsOverlay Overlay, string GameDir) CreateOverlay()
+    {
+        var gameDir = Path.Combine(_testDir, "game");
+        Directory.CreateDirectory(Path.Combine(gameDir, "Data"));
+        File.WriteAllText(Path.Combine(gameDir, "Data", "Skyrim.ini"), "[General]\n");
+
+        var resolver = new LayeredVfsResolver();
+        resolver.AddLayer(VfsLayer.FromDirectory("base", gameDir, 0));
+        return (new VfsOverlay(resolver, Path.Combine(_testDir, "overlay")), gameDir);
+    }
+}
@@ -0,0 +1,310 @@
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using Modular.Core.Configuration;
+using Modular.Core.Downloads;
+using Modular.Core.Models;
+using Modular.Core.RateLimiting;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class MirrorSelectorTests : IDisposable
+{
+    private readonly string _testDir;
+    private readonly MirrorServer _server;
+    private readonly byte[] _payload;
+
+    public MirrorSelectorTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_mirror_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+        _payload = new byte[2 * 1024 * 1024];
+        new Random(3).NextBytes(_payload);
+        _server = new MirrorServer(_payload);
+    }
+
+    public void Dispose()
+    {
+        _server.Dispose();
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void Model_SmoothsSamplesAndRanksBySizeOfFile()
+    {
+        var model = new MirrorModel(alpha: 0.5);
+        model.RecordSuccess("near", TimeSpan.FromMilliseconds(10), 1_000_000, TimeSpan.FromSeconds(1));
+        model.RecordSuccess("far", TimeSpan.FromMilliseconds(400), 10_000_000, TimeSpan.FromSeconds(1));
+        model.RecordSuccess("far", TimeSpan.FromMilliseconds(200), 10_000_000, TimeSpan.FromSeconds(1));
+
+        var far = model.GetStats("far")!;
+        Assert.Equal(300, far.LatencyMs);
+        Assert.Equal(10_000_000, far.ThroughputBytesPerSecond);
+        Assert.Equal(2, far.Samples);
+
+        DownloadLink[] links = [Link("far"), Link("near"), Link("unknown")];
+        Assert.Equal(["near", "far", "unknown"], model.Rank(links, 10_000).Select(l => l.ShortName));
+        Assert.Equal(["far", "near", "unknown"], model.Rank(links, 100_000_000).Select(l => l.ShortName));
+
+        // Failures push a mirror down until it recovers
+        Assert.Equal("far", model.Rank(links, 1_000_000)[0].ShortName);
+        model.RecordFailure("far");
+        model.RecordFailure("far");
+        Assert.Equal(0.75, model.GetStats("far")!.FailureRate);
+        Assert.Equal("near", model.Rank(links, 1_000_000)[0].ShortName);
+    }
+
+    [Fact]
+    public async Task RankAsync_RacesProbesAndReusesFreshMeasurements()
+    {
+        _server.Add("slow").BytesPerSecond = 32 * 1024;
+        _server.Add("broken").Status = 500;
+        _server.Add("fast");
+        var selector = new MirrorSelector(options: new MirrorSelectorOptions { ProbeTimeout = TimeSpan.FromSeconds(1) });
+        DownloadLink[] links = [Link("slow"), Link("broken"), Link("fast")];
+
+        var stopwatch = Stopwatch.StartNew();
+        var ranked = await selector.RankAsync(links, _payload.Length);
+        stopwatch.Stop();
+
+        Assert.Equal(["fast", "slow", "broken"], ranked.Select(l => l.ShortName));
+        Assert.True(stopwatch.ElapsedMilliseconds < 2000, $"probes took {stopwatch.ElapsedMilliseconds} ms");
+        Assert.True(selector.Model.GetStats("slow")!.ThroughputBytesPerSecond < 100 * 1024);
+
+        // Measured mirrors aren't probed again; the broken one stays unmeasured and is retried
+        await selector.RankAsync(links, _payload.Length);
+        Assert.Equal(1, _server.Requests("fast"));
+        Assert.Equal(1, _server.Requests("slow"));
+        Assert.Equal(2, _server.Requests("broken"));
+    }
+
+    [Fact]
+    public async Task DownloadAsync_SwitchesMirrorWhenThroughputDropsAndResumesWithRange()
+    {
+        var degrading = _server.Add("degrading");
+        degrading.ThrottleAfter = 256 * 1024;
+        degrading.BytesPerSecond = 16 * 1024;
+        _server.Add("steady");
+
+        var model = new MirrorModel();
+        model.RecordSuccess("degrading", TimeSpan.FromMilliseconds(5), 50_000_000, TimeSpan.FromSeconds(1));
+        model.RecordSuccess("steady", TimeSpan.FromMilliseconds(5), 20_000_000, TimeSpan.FromSeconds(1));
+        var selector = new MirrorSelector(model, new MirrorSelectorOptions
+        {
+            MinThroughputBytesPerSecond = 200 * 1024,
+            ThroughputWindow = TimeSpan.FromMilliseconds(300)
+        });
+        var destination = Path.Combine(_testDir, "file.zip.part");
+
+        var stopwatch = Stopwatch.StartNew();
+        var result = await selector.DownloadAsync([Link("degrading"), Link("steady")], destination, _payload.Length);
+        stopwatch.Stop();
+
+        Assert.Equal(["degrading", "steady"], result.Mirrors);
+        Assert.Equal(_server.UrlOf("steady"), result.Url);
+        Assert.Equal(_payload, File.ReadAllBytes(destination));
+        var resumedAt = Assert.Single(_server.Mirror("steady").RangeStarts);
+        Assert.True(resumedAt >= 256 * 1024, $"resumed at {resumedAt}");
+        Assert.True(stopwatch.ElapsedMilliseconds < 5000, $"took {stopwatch.ElapsedMilliseconds} ms");
+        Assert.True(model.EstimateSeconds("steady", _payload.Length) < model.EstimateSeconds("degrading", _payload.Length));
+    }
+
+    [Fact]
+    public async Task DownloadAsync_UnderBandwidthCapDoesNotBlameTheMirror()
+    {
+        _server.Add("first");
+        _server.Add("second");
+        var governor = new BandwidthGovernor(
+            new AppSettings { BandwidthLimitKbps = 1024 }, Path.Combine(_testDir, "bandwidth.bin"));
+        var selector = new MirrorSelector(
+            options: new MirrorSelectorOptions
+            {
+                MinThroughputBytesPerSecond = 2 * 1024 * 1024,
+                ThroughputWindow = TimeSpan.FromMilliseconds(300)
+            },
+            governor: governor);
+        var destination = Path.Combine(_testDir, "file.zip.part");
+
+        var stopwatch = Stopwatch.StartNew();
+        var result = await selector.DownloadAsync([Link("first"), Link("second")], destination, _payload.Length);
+        stopwatch.Stop();
+
+        // Capped at 1 MB/s, below the 2 MB/s switch threshold, yet the mirror keeps the transfer
+        Assert.Single(result.Mirrors);
+        Assert.Equal(_payload, File.ReadAllBytes(destination));
+        Assert.InRange(stopwatch.Elapsed.TotalSeconds, 1.8, 3);
+        Assert.True(selector.Model.GetStats(result.Mirrors[0])!.ThroughputBytesPerSecond > 2 * 1024 * 1024);
+    }
+
+    [Fact]
+    public async Task DownloadAsync_FailsOverOnBrokenAndStalledMirrorsAndPersistsModel()
+    {
+        _server.Add("reset").AbortAfter = 512 * 1024;
+        _server.Add("hung").HangAfterHeaders = true;
+        _server.Add("no-ranges").IgnoreRange = true;
+
+        var statePath = Path.Combine(_testDir, "mirrors.json");
+        var model = new MirrorModel(statePath);
+        foreach (var (name, rate) in new[] { ("reset", 90_000_000), ("hung", 80_000_000), ("no-ranges", 70_000_000) })
+            model.RecordSuccess(name, TimeSpan.FromMilliseconds(5), rate, TimeSpan.FromSeconds(1));
+        var selector = new MirrorSelector(model, new MirrorSelectorOptions { StallTimeout = TimeSpan.FromMilliseconds(500) });
+        var destination = Path.Combine(_testDir, "file.zip.part");
+
+        var result = await selector.DownloadAsync([Link("reset"), Link("hung"), Link("no-ranges")], destination);
+
+        Assert.Equal(["reset", "hung", "no-ranges"], result.Mirrors);
+        Assert.Equal(_payload, File.ReadAllBytes(destination));
+        Assert.Equal(_payload.Length, result.Bytes);
+
+        var reloaded = new MirrorModel(statePath);
+        Assert.True(reloaded.GetStats("reset")!.FailureRate > 0);
+        Assert.True(reloaded.GetStats("hung")!.FailureRate > 0);
+        Assert.Equal(0, reloaded.GetStats("no-ranges")!.FailureRate);
+        Assert.Equal("no-ranges", reloaded.Rank([Link("reset"), Link("hung"), Link("no-ranges")], _payload.Length)[0].ShortName);
+
+        _server.Mirror("no-ranges").Status = 503;
+        await Assert.ThrowsAsync<HttpRequestException>(() =>
+            selector.DownloadAsync([Link("no-ranges")], destination));
+    }
+
+    private DownloadLink Link(string mirror) => new() { Uri = _server.UrlOf(mirror), Name = mirror, ShortName = mirror };
+
+    /// <summary>
+    /// Serves one payload from several named mirrors, each with its own
+    /// throttling and failure behaviour.
+    /// </summary>
+    private sealed class MirrorServer : IDisposable
+    {
+        private const int ChunkSize = 8 * 1024;
+
+        private readonly HttpListener _listener = new();
+        private readonly ConcurrentDictionary<string, MirrorBehavior> _mirrors = new();
+        private readonly ConcurrentQueue<string> _log = new();
+        private readonly CancellationTokenSource _shutdown = new();
+        private readonly byte[] _payload;
+
+        public MirrorServer(byte[] payload)
+        {
+            _payload = payload;
+            var socket = new TcpListener(IPAddress.Loopback, 0);
+            socket.Start();
+            BaseUrl = $"http://127.0.0.1:{((IPEndPoint)socket.LocalEndpoint).Port}";
+            socket.Stop();
+            _listener.Prefixes.Add(BaseUrl + "/");
+            _listener.Start();
+            _ = Task.Run(ServeAsync);
+        }
+
+        public string BaseUrl { get; }
+
+        public MirrorBehavior Add(string name) => _mirrors[name] = new MirrorBehavior();
+
+        public MirrorBehavior Mirror(string name) => _mirrors[name];
+
+        public string UrlOf(string name) => $"{BaseUrl}/{name}/file.zip";
+
+        public int Requests(string name) => _log.Count(n => n == name);
+
+        private async Task ServeAsync()
+        {
+            while (_listener.IsListening)
+            {
+                HttpListenerContext context;
+                try
+                {
+                    context = await _listener.GetContextAsync();
+                }
+                catch (Exception ex) when (ex is HttpListenerException or ObjectDisposedException)
+                {
+                    return;
+                }
+
+                _ = Task.Run(() => HandleAsync(context));
+            }
+        }
+
+        private async Task HandleAsync(HttpListenerContext context)
+        {
+            var name = context.Request.Url!.AbsolutePath.Trim('/').Split('/')[0];
+            _log.Enqueue(name);
+            var response = context.Response;
+            try
+            {
+                if (!_mirrors.TryGetValue(name, out var mirror) || mirror.Status != 200)
+                {
+                    response.StatusCode = mirror?.Status ?? 404;
+                    response.Close();
+                    return;
+                }
+
+                var (start, end) = (0L, _payload.LongLength - 1);
+                var range = context.Request.Headers["Range"];
+                if (range != null && !mirror.IgnoreRange)
+                {
+                    var bounds = range["bytes=".Length..].Split('-');
+                    start = long.Parse(bounds[0]);
+                    if (bounds[1].Length > 0)
+                        end = Math.Min(end, long.Parse(bounds[1]));
+                    mirror.RangeStarts.Enqueue(start);
+                    response.StatusCode = 206;
+                    response.AddHeader("Content-Range", $"bytes {start}-{end}/{_payload.Length}");
+                }
+
+                response.ContentLength64 = end - start + 1;
+                await response.OutputStream.FlushAsync();
+                if (mirror.HangAfterHeaders)
+                {
+                    await Task.Delay(Timeout.Infinite, _shutdown.Token);
+                    return;
+                }
+
+                for (var offset = start; offset <= end; offset += ChunkSize)
+                {
+                    if (mirror.AbortAfter >= 0 && offset >= mirror.AbortAfter)
+                    {
+                        response.Abort();
+                        return;
+                    }
+
+                    var count = (int)Math.Min(ChunkSize, end - offset + 1);
+                    await response.OutputStream.WriteAsync(_payload.AsMemory((int)offset, count), _shutdown.Token);
+                    if (mirror.BytesPerSecond > 0 && offset >= mirror.ThrottleAfter)
+                        await Task.Delay(TimeSpan.FromSeconds((double)count / mirror.BytesPerSecond), _shutdown.Token);
+                }
+
+                response.Close();
+            }
+            catch (Exception ex) when (ex is HttpListenerException or IOException or ObjectDisposedException or OperationCanceledException)
+            {
+                // The client hung up or moved to another mirror
+                response.Abort();
+            }
+        }
+
+        public void Dispose()
+        {
+            _shutdown.Cancel();
+            _listener.Close();
+        }
+    }
+
+    private sealed class MirrorBehavior
+    {
+        public int Status { get; set; } = 200;
+
+        public int BytesPerSecond { get; set; }
+
+        public long ThrottleAfter { get; set; }
+
+        public long AbortAfter { get; set; } = -1;
+
+        public bool HangAfterHeaders { get; set; }
+
+        public bool IgnoreRange { get; set; }
+
+        public ConcurrentQueue<long> RangeStarts { get; } = new();
+    }
+}
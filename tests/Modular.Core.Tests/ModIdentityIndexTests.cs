@@ -0,0 +1,158 @@
+using FluentAssertions;
+using Modular.Core.Database;
+using Modular.Core.Identity;
+using Modular.Core.Installers;
+using Modular.Core.Metadata;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class ModIdentityIndexTests : IAsyncLifetime
+{
+    private readonly string _testDir;
+    private readonly ModularDatabase _database;
+    private readonly DownloadDatabase _downloads;
+    private readonly ModMetadataCache _metadataCache;
+
+    public ModIdentityIndexTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_identity_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+        _database = new ModularDatabase(Path.Combine(_testDir, "modular.db"));
+        _downloads = new DownloadDatabase(Path.Combine(_testDir, "downloads.json"));
+        _metadataCache = new ModMetadataCache(Path.Combine(_testDir, "metadata.json"));
+    }
+
+    public Task InitializeAsync() => _database.InitializeAsync();
+
+    public async Task DisposeAsync()
+    {
+        await _database.DisposeAsync();
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task Reconcile_LinksEveryStoreIntoOneIdentity()
+    {
+        var archive = ArchivePath("SkyUI_5_2_SE-12604-5-2SE.7z");
+        AddDownload(12604, 35407, archive, md5: "AABB");
+        _metadataCache.SetModMetadata("skyrim", new ModMetadata { ModId = 12604, Name = "SkyUI" });
+        _metadataCache.SetCanonicalMod(Canonical(("35407", "aabb", 1_600_000_000)));
+        var changeset = await InstallAsync(archive, modId: null);
+
+        var index = new ModIdentityIndex(_database);
+        var report = await index.ReconcileAsync(await Collect());
+
+        report.IdentityCount.Should().Be(1);
+        var identity = await index.GetIdentityAsync($"install:{changeset}");
+        (await index.GetMembersAsync(identity!)).Select(r => r.Source).Should().BeEquivalentTo(
+        [
+            IdentitySources.Download, IdentitySources.Metadata, IdentitySources.Canonical,
+            IdentitySources.Upstream, IdentitySources.Install
+        ]);
+    }
+
+    [Fact]
+    public async Task Reconcile_UnchangedStores_WritesNothing()
+    {
+        AddDownload(1, 10, ArchivePath("a.zip"));
+        AddDownload(2, 20, ArchivePath("b.zip"));
+        var index = new ModIdentityIndex(_database);
+        await index.ReconcileAsync(await Collect());
+
+        var report = await index.ReconcileAsync(await Collect());
+
+        report.AddedCount.Should().Be(0);
+        report.ChangedCount.Should().Be(0);
+        report.RemovedCount.Should().Be(0);
+        report.RelinkedCount.Should().Be(0);
+        report.IdentityCount.Should().Be(2);
+    }
+
+    [Fact]
+    public async Task Reconcile_IsPersistedAcrossInstances()
+    {
+        AddDownload(1, 10, ArchivePath("a.zip"));
+        await new ModIdentityIndex(_database).ReconcileAsync(await Collect());
+
+        _metadataCache.SetModMetadata("skyrim", new ModMetadata { ModId = 1, Name = "Mod One" });
+        var restarted = new ModIdentityIndex(_database);
+        var report = await restarted.ReconcileAsync(await Collect());
+
+        report.AddedCount.Should().Be(1);
+        report.IdentityCount.Should().Be(1);
+        (await restarted.GetIdentityAsync("metadata:skyrim:1"))
+            .Should().Be(await restarted.GetIdentityAsync("download:skyrim:1:10"));
+    }
+
+    [Fact]
+    public async Task InstalledStatus_ComparesWithNewestUpstreamFile()
+    {
+        var current = ArchivePath("current.zip");
+        var outdated = ArchivePath("outdated.zip");
+        AddDownload(12604, 2, current, md5: "22");
+        AddDownload(12604, 1, outdated, md5: "11");
+        _metadataCache.SetCanonicalMod(Canonical(("1", "11", 1_600_000_000), ("2", "22", 1_700_000_000)));
+        var installedCurrent = await InstallAsync(current, "nexusmods:skyrim:12604");
+        var installedOutdated = await InstallAsync(outdated, "nexusmods:skyrim:12604");
+        var unknown = await InstallAsync(ArchivePath("manual.zip"), modId: null);
+
+        var index = new ModIdentityIndex(_database);
+        await index.ReconcileAsync(await Collect());
+        var statuses = (await index.GetInstalledStatusAsync()).ToDictionary(s => s.InstallKey);
+
+        statuses[$"install:{installedCurrent}"].IsLatest.Should().BeTrue();
+        statuses[$"install:{installedOutdated}"].IsLatest.Should().BeFalse();
+        statuses[$"install:{installedOutdated}"].LatestFileId.Should().Be("2");
+        statuses[$"install:{unknown}"].IsLatest.Should().BeNull();
+    }
+
+    private async Task<IReadOnlyList<IdentityRecord>> Collect() =>
+        await new IdentitySourceCollector(_database, _downloads, _metadataCache).CollectAsync();
+
+    private string ArchivePath(string name) => Path.Combine(_testDir, "downloads", name);
+
+    private void AddDownload(int modId, int fileId, string path, string md5 = "") =>
+        _downloads.AddRecord(new DownloadRecord
+        {
+            GameDomain = "skyrim",
+            ModId = modId,
+            FileId = fileId,
+            Filename = Path.GetFileName(path),
+            Filepath = path,
+            Md5Expected = md5,
+            Status = DownloadStatus.Success
+        });
+
+    private async Task<string> InstallAsync(string archivePath, string? modId)
+    {
+        var changesets = new ChangesetManager(_database);
+        var id = await changesets.CreateChangesetAsync(modId, archivePath, _testDir);
+        await changesets.UpdateStateAsync(id, ChangesetState.Committed);
+        return id;
+    }
+
+    private static CanonicalMod Canonical(params (string FileId, string Md5, long Uploaded)[] files) => new()
+    {
+        CanonicalId = "nexusmods:skyrim:12604",
+        Source = new ModSource { BackendId = "nexusmods", ProjectId = "12604" },
+        Game = new GameInfo { Domain = "skyrim" },
+        Name = "SkyUI",
+        Authors = [new ModAuthor { Name = "schlangster" }],
+        Versions =
+        [
+            new CanonicalVersion
+            {
+                VersionId = "5.2",
+                Files = files.Select(f => new CanonicalFile
+                {
+                    FileId = f.FileId,
+                    FileName = $"SkyUI-{f.FileId}.7z",
+                    Hashes = new FileHashes { Md5 = f.Md5 },
+                    UploadedAt = DateTimeOffset.FromUnixTimeSeconds(f.Uploaded).UtcDateTime
+                }).ToList()
+            }
+        ]
+    };
+}
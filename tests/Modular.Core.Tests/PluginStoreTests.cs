@@ -0,0 +1,227 @@
+using System.IO.Compression;
+using System.Net;
+using System.Security.Cryptography;
+using System.Text;
+using Modular.Core.Plugins;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class PluginStoreTests : IDisposable
+{
+    private readonly string _testDir;
+    private readonly string _pluginDir;
+
+    public PluginStoreTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_plugin_store_test_{Guid.NewGuid():N}");
+        _pluginDir = Path.Combine(_testDir, "plugins");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task Install_ExtractsIntoVersionDirectoryAndActivates()
+    {
+        var store = new PluginStore(_pluginDir);
+
+        var dir = await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+
+        Assert.Equal(Path.Combine(_pluginDir, "sample", "1.0.0"), dir);
+        Assert.Equal("1.0.0", store.GetActiveVersion("sample"));
+        Assert.Equal(dir, store.GetActiveDirectory("sample"));
+        Assert.Equal("1.0.0", File.ReadAllText(Path.Combine(dir, "Sample.dll")));
+    }
+
+    [Fact]
+    public async Task Update_RemovesOldVersionNobodyUses()
+    {
+        var store = new PluginStore(_pluginDir);
+        await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+
+        await store.InstallAsync("sample", "2.0.0", WritePackage("sample", "2.0.0"));
+
+        Assert.Equal("2.0.0", store.GetActiveVersion("sample"));
+        Assert.Equal("2.0.0", Assert.Single(store.GetInstalledVersions("sample")));
+    }
+
+    [Fact]
+    public async Task Update_KeepsLeasedVersionUntilReleased()
+    {
+        var store = new PluginStore(_pluginDir);
+        await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+        var lease = store.AcquireLease("sample")!;
+
+        await store.InstallAsync("sample", "2.0.0", WritePackage("sample", "2.0.0"));
+
+        Assert.Equal("2.0.0", store.GetActiveVersion("sample"));
+        Assert.Equal("1.0.0", lease.Version);
+        Assert.Equal("1.0.0", File.ReadAllText(Path.Combine(lease.Directory, "Sample.dll")));
+
+        lease.Dispose();
+        Assert.Equal(1, store.CollectGarbage("sample"));
+        Assert.Equal("2.0.0", Assert.Single(store.GetInstalledVersions("sample")));
+    }
+
+    [Fact]
+    public async Task LeaseFiles_AreRemovedOnReleaseAndWhenAbandoned()
+    {
+        var store = new PluginStore(_pluginDir);
+        await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+        var lease = store.AcquireLease("sample")!;
+        var leaseDir = Path.Combine(_pluginDir, "sample", ".leases");
+
+        // Left behind by a process that died holding 1.0.0
+        await File.WriteAllTextAsync(Path.Combine(leaseDir, "1.0.0.0123456789abcdef"), "");
+        await store.InstallAsync("sample", "2.0.0", WritePackage("sample", "2.0.0"));
+
+        Assert.Equal(0, store.CollectGarbage("sample"));
+        Assert.Single(Directory.EnumerateFiles(leaseDir));
+
+        lease.Dispose();
+        Assert.Empty(Directory.EnumerateFiles(leaseDir));
+        Assert.Equal(1, store.CollectGarbage("sample"));
+    }
+
+    [Fact]
+    public async Task FailedInstall_LeavesActiveVersionInPlace()
+    {
+        var store = new PluginStore(_pluginDir);
+        await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+        var corrupt = Path.Combine(_testDir, "corrupt.zip");
+        await File.WriteAllTextAsync(corrupt, "not a zip");
+
+        await Assert.ThrowsAnyAsync<Exception>(() => store.InstallAsync("sample", "2.0.0", corrupt));
+
+        Assert.Equal("1.0.0", store.GetActiveVersion("sample"));
+        Assert.Equal("1.0.0", Assert.Single(store.GetInstalledVersions("sample")));
+        Assert.Empty(Directory.EnumerateDirectories(Path.Combine(_pluginDir, "sample"), ".staging-*"));
+    }
+
+    [Fact]
+    public async Task FlatLayout_IsFoundAndReplacedByVersionedInstall()
+    {
+        var legacy = Path.Combine(_pluginDir, "sample");
+        Directory.CreateDirectory(legacy);
+        await File.WriteAllTextAsync(Path.Combine(legacy, "plugin.json"), Manifest("sample", "0.9.0"));
+        await File.WriteAllTextAsync(Path.Combine(legacy, "Sample.dll"), "0.9.0");
+        var store = new PluginStore(_pluginDir);
+        Assert.Equal(legacy, store.GetActiveDirectory("sample"));
+
+        await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+
+        Assert.Equal(Path.Combine(legacy, "1.0.0"), store.GetActiveDirectory("sample"));
+        Assert.False(File.Exists(Path.Combine(legacy, "Sample.dll")));
+        Assert.False(File.Exists(Path.Combine(legacy, "plugin.json")));
+    }
+
+    [Fact]
+    public async Task Uninstall_KeepsLeasedFilesUntilReleased()
+    {
+        var store = new PluginStore(_pluginDir);
+        await store.InstallAsync("sample", "1.0.0", WritePackage("sample", "1.0.0"));
+        var lease = store.AcquireLease("sample")!;
+
+        Assert.True(store.Uninstall("sample"));
+        Assert.Null(store.GetActiveDirectory("sample"));
+        Assert.True(File.Exists(Path.Combine(lease.Directory, "Sample.dll")));
+
+        lease.Dispose();
+        store.Uninstall("sample");
+        Assert.False(Directory.Exists(Path.Combine(_pluginDir, "sample")));
+    }
+
+    [Fact]
+    public async Task Marketplace_HashMismatch_KeepsPreviousVersion()
+    {
+        var packages = new Dictionary<string, byte[]>
+        {
+            ["/sample/1.0.0.zip"] = await File.ReadAllBytesAsync(WritePackage("sample", "1.0.0")),
+            ["/sample/2.0.0.zip"] = await File.ReadAllBytesAsync(WritePackage("sample", "2.0.0"))
+        };
+        using var http = new HttpClient(new PackageHandler(packages));
+        var marketplace = new PluginMarketplace(http, _pluginDir);
+
+        var installed = await marketplace.InstallPluginAsync(Entry("sample", "1.0.0", packages));
+        var tampered = Entry("sample", "2.0.0", packages);
+        tampered.Sha256 = new string('0', 64);
+        var rejected = await marketplace.InstallPluginAsync(tampered);
+
+        Assert.True(installed.Success, installed.Error);
+        Assert.False(rejected.Success);
+        Assert.Contains("Hash mismatch", rejected.Error);
+        Assert.Equal("1.0.0", marketplace.Store.GetActiveVersion("sample"));
+        Assert.Empty(Directory.EnumerateFiles(Path.Combine(_pluginDir, ".downloads")));
+    }
+
+    [Fact]
+    public async Task Marketplace_ParallelInstallsAndUpdatesOf30Plugins()
+    {
+        var packages = new Dictionary<string, byte[]>();
+        var ids = Enumerable.Range(1, 30).Select(i => $"plugin-{i:D2}").ToList();
+        foreach (var id in ids)
+        {
+            foreach (var version in new[] { "1.0.0", "2.0.0" })
+                packages[$"/{id}/{version}.zip"] = await File.ReadAllBytesAsync(WritePackage(id, version));
+        }
+
+        using var http = new HttpClient(new PackageHandler(packages));
+        var marketplace = new PluginMarketplace(http, _pluginDir);
+
+        var installs = await marketplace.InstallPluginsAsync(
+            ids.Select(id => Entry(id, "1.0.0", packages)).ToList(), maxConcurrency: 8);
+
+        // Every update requested twice at once, as two processes racing would
+        var updates = await marketplace.InstallPluginsAsync(
+            ids.Concat(ids).Select(id => Entry(id, "2.0.0", packages)).ToList(), maxConcurrency: 16);
+
+        Assert.All(installs.Concat(updates), r => Assert.True(r.Success, r.Error));
+        foreach (var id in ids)
+        {
+            Assert.Equal("2.0.0", marketplace.Store.GetActiveVersion(id));
+            Assert.Equal("2.0.0", Assert.Single(marketplace.Store.GetInstalledVersions(id)));
+            Assert.Equal("2.0.0", File.ReadAllText(Path.Combine(marketplace.Store.GetActiveDirectory(id)!, "Sample.dll")));
+        }
+
+        Assert.Empty(Directory.EnumerateFiles(Path.Combine(_pluginDir, ".downloads")));
+    }
+
+    private string WritePackage(string id, string version)
+    {
+        var path = Path.Combine(_testDir, $"{id}-{version}-{Guid.NewGuid():N}.zip");
+        using var zip = ZipFile.Open(path, ZipArchiveMode.Create);
+        using (var writer = new StreamWriter(zip.CreateEntry("plugin.json").Open()))
+            writer.Write(Manifest(id, version));
+        using (var writer = new StreamWriter(zip.CreateEntry("Sample.dll").Open()))
+            writer.Write(version);
+        return path;
+    }
+
+    private static string Manifest(string id, string version) =>
+        $$"""{ "id": "{{id}}", "version": "{{version}}", "entryAssembly": "Sample.dll" }""";
+
+    private static PluginIndexEntry Entry(string id, string version, Dictionary<string, byte[]> packages) => new()
+    {
+        Id = id,
+        Name = id,
+        Version = version,
+        DownloadUrl = $"http://plugins.test/{id}/{version}.zip",
+        Sha256 = Convert.ToHexString(SHA256.HashData(packages[$"/{id}/{version}.zip"]))
+    };
+
+    private sealed class PackageHandler(Dictionary<string, byte[]> packages) : HttpMessageHandler
+    {
+        protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request, CancellationToken ct)
+        {
+            await Task.Yield();
+            return packages.TryGetValue(request.RequestUri!.AbsolutePath, out var bytes)
+                ? new HttpResponseMessage(HttpStatusCode.OK) { Content = new ByteArrayContent(bytes) }
+                : new HttpResponseMessage(HttpStatusCode.NotFound) { Content = new StringContent("", Encoding.UTF8) };
+        }
+    }
+}
@@ -0,0 +1,431 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using Modular.Core.Resilience;
+using Modular.FluentHttp.Implementation;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+/// <summary>
+/// Chaos tests: faults are injected into a local HTTP server and a fake
+/// filesystem, and the engine has to keep throughput up and latency bounded.
+/// </summary>
+public class ResilienceEngineTests
+{
+    private const int EBUSY = 16;
+    private const int ESTALE = 116;
+
+    [Fact]
+    public async Task ChaosHttp_KeepsThroughputAndBoundsLatency()
+    {
+        // 15% 503s, 10% dropped connections, 10% stalls far longer than the hedge delay and the timeout
+        using var server = new ChaosHttpServer(seed: 42, n => n switch
+        {
+            < 15 => Fault.Unavailable,
+            < 25 => Fault.Drop,
+            < 35 => Fault.Stall,
+            _ => Fault.None
+        });
+        var engine = new ResilienceEngine(Policies(new ResiliencePolicy
+        {
+            MaxRetries = 6,
+            BaseDelay = TimeSpan.FromMilliseconds(10),
+            MaxDelay = TimeSpan.FromMilliseconds(100),
+            RetryBudgetRatio = 1,
+            RetryBudgetReserve = 50,
+            FailureThreshold = 50,
+            MaxConcurrency = 16,
+            HedgeDelay = TimeSpan.FromMilliseconds(200)
+        }));
+        // Attempts time out, so a stall that also catches the hedge is retried instead of waited out
+        using var client = FluentClientFactory.Create(server.BaseUrl)
+            .SetRequestPolicy(new HttpResiliencePolicy(engine))
+            .SetRetryPolicy(6)
+            .SetTimeout(TimeSpan.FromSeconds(1));
+
+        var latencies = new List<TimeSpan>();
+        var succeeded = 0;
+        var total = Stopwatch.StartNew();
+        await Parallel.ForEachAsync(Enumerable.Range(0, 100), new ParallelOptions { MaxDegreeOfParallelism = 10 }, async (i, _) =>
+        {
+            var watch = Stopwatch.StartNew();
+            try
+            {
+                var response = await client.GetAsync($"/item/{i}").WithIgnoreHttpErrors().AsResponseAsync();
+                if (response.IsSuccessStatusCode)
+                    Interlocked.Increment(ref succeeded);
+            }
+            catch (HttpRequestException)
+            {
+            }
+
+            lock (latencies) latencies.Add(watch.Elapsed);
+        });
+        total.Stop();
+
+        var metrics = engine.GetMetrics(ResilienceCategory.Http);
+        Assert.True(succeeded >= 98, $"only {succeeded}/100 requests succeeded");
+        Assert.True(latencies.Max() < TimeSpan.FromSeconds(3), $"slowest request took {latencies.Max()}");
+        Assert.True(total.Elapsed < TimeSpan.FromSeconds(15), $"100 requests took {total.Elapsed}");
+        Assert.True(metrics.Retries > 0);
+        Assert.True(metrics.HedgeWins > 0, "stalled GETs should be overtaken by their hedge");
+    }
+
+    [Fact]
+    public async Task RateLimitedClient_IsNotHedged()
+    {
+        using var server = new ChaosHttpServer(seed: 1, _ => Fault.Stall);
+        var engine = new ResilienceEngine(Policies(new ResiliencePolicy
+        {
+            MaxRetries = 0,
+            HedgeDelay = TimeSpan.FromMilliseconds(100)
+        }));
+        var limiter = new CountingRateLimiter();
+        using var client = FluentClientFactory.Create(server.BaseUrl)
+            .SetRequestPolicy(new HttpResiliencePolicy(engine))
+            .SetRateLimiter(limiter)
+            .SetRetryPolicy(0)
+            .SetTimeout(TimeSpan.FromSeconds(1));
+
+        await Assert.ThrowsAnyAsync<Exception>(() => client.GetAsync("/slow").AsResponseAsync());
+
+        // A hedge would have reserved a second unit of quota for the same logical request
+        Assert.Equal(1, limiter.Reserved);
+        Assert.Equal(1, server.Requests);
+        Assert.Equal(0L, engine.GetMetrics(ResilienceCategory.Http).Hedges);
+    }
+
+    [Fact]
+    public async Task CircuitBreaker_IsolatesFailingHost()
+    {
+        using var broken = new ChaosHttpServer(seed: 1, _ => Fault.Unavailable);
+        using var healthy = new ChaosHttpServer(seed: 1, _ => Fault.None);
+        var engine = new ResilienceEngine(Policies(new ResiliencePolicy
+        {
+            MaxRetries = 2,
+            BaseDelay = TimeSpan.FromMilliseconds(5),
+            FailureThreshold = 3,
+            BreakDuration = TimeSpan.FromMinutes(5)
+        }));
+        using var brokenClient = FluentClientFactory.Create(broken.BaseUrl).SetRequestPolicy(new HttpResiliencePolicy(engine));
+        using var healthyClient = FluentClientFactory.Create(healthy.BaseUrl).SetRequestPolicy(new HttpResiliencePolicy(engine));
+
+        var rejected = 0;
+        var watch = Stopwatch.StartNew();
+        for (var i = 0; i < 20; i++)
+        {
+            try
+            {
+                await brokenClient.GetAsync("/").WithIgnoreHttpErrors().AsResponseAsync();
+            }
+            catch (CircuitOpenException)
+            {
+                rejected++;
+            }
+
+            var ok = await healthyClient.GetAsync("/").AsResponseAsync();
+            Assert.True(ok.IsSuccessStatusCode);
+        }
+
+        Assert.Equal(3, broken.Requests);
+        Assert.Equal(19, rejected);
+        Assert.Equal(20, healthy.Requests);
+        Assert.Equal(CircuitState.Open, engine.GetCircuitState(ResilienceCategory.Http, HttpResiliencePolicy.HostKey(broken.BaseUrl)));
+        Assert.True(watch.Elapsed < TimeSpan.FromSeconds(5));
+    }
+
+    [Fact]
+    public async Task ChaosFileSystem_RetriesLocksAndBreaksDeadMount()
+    {
+        var fs = new FakeFileSystem(seed: 7);
+        fs.Mount("dev:1", lockRate: 0.2);
+        fs.Mount("dev:2", lockRate: 1.0, error: ESTALE);
+        var engine = new ResilienceEngine(Policies(new ResiliencePolicy
+        {
+            MaxRetries = 8,
+            BaseDelay = TimeSpan.FromMilliseconds(1),
+            MaxDelay = TimeSpan.FromMilliseconds(20),
+            RetryBudgetRatio = 1,
+            RetryBudgetReserve = 100,
+            FailureThreshold = 10,
+            BreakDuration = TimeSpan.FromMinutes(5)
+        }));
+
+        var watch = Stopwatch.StartNew();
+        var healthy = await Task.WhenAll(Enumerable.Range(0, 200).Select(i =>
+            engine.ExecuteAsync(ResilienceCategory.FileSystem, "dev:1", _ => fs.WriteAsync("dev:1", $"file{i}"))));
+        Assert.Equal(200, healthy.Length);
+        Assert.Equal(200, fs.Files("dev:1"));
+
+        var dead = 0;
+        for (var i = 0; i < 50; i++)
+        {
+            try
+            {
+                await engine.ExecuteAsync(ResilienceCategory.FileSystem, "dev:2", _ => fs.WriteAsync("dev:2", $"file{i}"));
+            }
+            catch (IOException)
+            {
+                dead++;
+            }
+            catch (CircuitOpenException)
+            {
+                dead++;
+            }
+        }
+
+        Assert.Equal(50, dead);
+        Assert.True(fs.Attempts("dev:2") <= 10, $"dead mount was hit {fs.Attempts("dev:2")} times");
+        Assert.True(watch.Elapsed < TimeSpan.FromSeconds(5), $"took {watch.Elapsed}");
+        Assert.Contains("dev:2", engine.GetMetrics(ResilienceCategory.FileSystem).OpenCircuits);
+    }
+
+    [Fact]
+    public async Task RetryBudget_CapsRetryAmplification()
+    {
+        var engine = new ResilienceEngine(Policies(new ResiliencePolicy
+        {
+            MaxRetries = 5,
+            BaseDelay = TimeSpan.FromMilliseconds(1),
+            RetryBudgetRatio = 0.1,
+            RetryBudgetReserve = 5,
+            FailureThreshold = 0
+        }));
+        var attempts = 0;
+
+        for (var i = 0; i < 50; i++)
+        {
+            var act = () => engine.ExecuteAsync(ResilienceCategory.FileSystem, "dev:1", _ =>
+            {
+                Interlocked.Increment(ref attempts);
+                throw new IOException("busy", EBUSY);
+            });
+            await Assert.ThrowsAsync<IOException>(act);
+        }
+
+        // Without a budget this would be 50 * 6 = 300 attempts
+        Assert.True(attempts <= 50 + 5 + 5, $"{attempts} attempts");
+        Assert.True(engine.GetMetrics(ResilienceCategory.FileSystem).RetriesDenied > 0);
+    }
+
+    [Fact]
+    public async Task PermanentError_IsNotRetried()
+    {
+        var engine = new ResilienceEngine();
+        var attempts = 0;
+
+        var act = () => engine.ExecuteAsync(ResilienceCategory.FileSystem, "dev:1", _ =>
+        {
+            attempts++;
+            throw new FileNotFoundException("gone");
+        });
+
+        await Assert.ThrowsAsync<FileNotFoundException>(act);
+        Assert.Equal(1, attempts);
+        Assert.Equal(CircuitState.Closed, engine.GetCircuitState(ResilienceCategory.FileSystem, "dev:1"));
+    }
+
+    [Fact]
+    public async Task Bulkhead_LimitsConcurrencyPerPlugin()
+    {
+        var engine = new ResilienceEngine(Policies(new ResiliencePolicy
+        {
+            MaxRetries = 0,
+            MaxConcurrency = 2,
+            MaxQueue = 1
+        }));
+        var gate = new TaskCompletionSource();
+        var running = 0;
+        var maxRunning = 0;
+
+        async Task<int> Work(CancellationToken _)
+        {
+            var now = Interlocked.Increment(ref running);
+            lock (gate) maxRunning = Math.Max(maxRunning, now);
+            await gate.Task;
+            Interlocked.Decrement(ref running);
+            return 0;
+        }
+
+        var calls = Enumerable.Range(0, 3).Select(_ => engine.ExecuteAsync(ResilienceCategory.Plugin, "slow-plugin", Work)).ToList();
+        var other = engine.ExecuteAsync(ResilienceCategory.Plugin, "other-plugin", _ => Task.FromResult(1));
+
+        await Assert.ThrowsAsync<BulkheadRejectedException>(() => engine.ExecuteAsync(ResilienceCategory.Plugin, "slow-plugin", Work));
+        Assert.Equal(1, await other);
+
+        gate.SetResult();
+        await Task.WhenAll(calls);
+        Assert.Equal(2, maxRunning);
+        Assert.Equal(1, engine.GetMetrics(ResilienceCategory.Plugin).BulkheadRejections);
+    }
+
+    [Fact]
+    public void Backoff_GrowsExponentiallyWithinJitterBounds()
+    {
+        var policy = new ResiliencePolicy { BaseDelay = TimeSpan.FromMilliseconds(100), MaxDelay = TimeSpan.FromSeconds(1) };
+        var random = new Random(3);
+
+        for (var attempt = 0; attempt < 8; attempt++)
+        {
+            var ceiling = Math.Min(100 * Math.Pow(2, attempt), 1000);
+            var delay = policy.GetDelay(attempt, random).TotalMilliseconds;
+            Assert.InRange(delay, ceiling / 2, ceiling);
+        }
+    }
+
+    private static Dictionary<ResilienceCategory, ResiliencePolicy> Policies(ResiliencePolicy policy) => new()
+    {
+        [ResilienceCategory.Http] = policy,
+        [ResilienceCategory.FileSystem] = policy,
+        [ResilienceCategory.Plugin] = policy
+    };
+
+    private enum Fault
+    {
+        None,
+        Unavailable,
+        Drop,
+        Stall
+    }
+
+    /// <summary>
+    /// HTTP server that answers each request with a fault drawn from a seeded
+    /// roll of 0-99, serving requests concurrently so stalls don't block others.
+    /// </summary>
+    private sealed class ChaosHttpServer : IDisposable
+    {
+        private readonly HttpListener _listener = new();
+        private readonly Random _random;
+        private readonly Func<int, Fault> _faults;
+        private int _requests;
+
+        public ChaosHttpServer(int seed, Func<int, Fault> faults)
+        {
+            _random = new Random(seed);
+            _faults = faults;
+            BaseUrl = $"http://127.0.0.1:{FreePort()}";
+            _listener.Prefixes.Add(BaseUrl + "/");
+            _listener.Start();
+            _ = Task.Run(ServeAsync);
+        }
+
+        public string BaseUrl { get; }
+
+        public int Requests => Volatile.Read(ref _requests);
+
+        private async Task ServeAsync()
+        {
+            while (_listener.IsListening)
+            {
+                HttpListenerContext context;
+                try
+                {
+                    context = await _listener.GetContextAsync();
+                }
+                catch (Exception ex) when (ex is HttpListenerException or ObjectDisposedException)
+                {
+                    return;
+                }
+
+                Interlocked.Increment(ref _requests);
+                int roll;
+                lock (_random) roll = _random.Next(100);
+                _ = Task.Run(() => HandleAsync(context, _faults(roll)));
+            }
+        }
+
+        private static async Task HandleAsync(HttpListenerContext context, Fault fault)
+        {
+            try
+            {
+                switch (fault)
+                {
+                    case Fault.Drop:
+                        context.Response.Abort();
+                        return;
+                    case Fault.Unavailable:
+                        context.Response.StatusCode = 503;
+                        break;
+                    case Fault.Stall:
+                        await Task.Delay(TimeSpan.FromSeconds(5));
+                        break;
+                }
+
+                var bytes = Encoding.UTF8.GetBytes("{}");
+                await context.Response.OutputStream.WriteAsync(bytes);
+                context.Response.Close();
+            }
+            catch (Exception ex) when (ex is HttpListenerException or ObjectDisposedException or IOException)
+            {
+                // The client gave up on this one, e.g. a hedged request that lost
+            }
+        }
+
+        private static int FreePort()
+        {
+            var socket = new TcpListener(IPAddress.Loopback, 0);
+            socket.Start();
+            var port = ((IPEndPoint)socket.LocalEndpoint).Port;
+            socket.Stop();
+            return port;
+        }
+
+        public void Dispose() => _listener.Close();
+    }
+
+    private sealed class CountingRateLimiter : Modular.FluentHttp.Interfaces.IRateLimiter
+    {
+        public int Reserved;
+
+        public void UpdateFromHeaders(IEnumerable<KeyValuePair<string, IEnumerable<string>>> headers) { }
+        public bool CanMakeRequest() => true;
+        public Task WaitIfNeededAsync(CancellationToken ct = default) => Task.CompletedTask;
+        public void ReserveRequest() => Interlocked.Increment(ref Reserved);
+    }
+
+    /// <summary>
+    /// In-memory mounts whose writes fail with an errno at a given rate.
+    /// </summary>
+    private sealed class FakeFileSystem
+    {
+        private readonly Random _random;
+        private readonly Dictionary<string, (double LockRate, int Error)> _mounts = new();
+        private readonly Dictionary<string, HashSet<string>> _files = new();
+        private readonly Dictionary<string, int> _attempts = new();
+
+        public FakeFileSystem(int seed) => _random = new Random(seed);
+
+        public void Mount(string key, double lockRate, int error = EBUSY)
+        {
+            _mounts[key] = (lockRate, error);
+            _files[key] = [];
+            _attempts[key] = 0;
+        }
+
+        public int Files(string mount)
+        {
+            lock (_random) return _files[mount].Count;
+        }
+
+        public int Attempts(string mount)
+        {
+            lock (_random) return _attempts[mount];
+        }
+
+        public async Task<bool> WriteAsync(string mount, string name)
+        {
+            await Task.Yield();
+            lock (_random)
+            {
+                _attempts[mount]++;
+                var (lockRate, error) = _mounts[mount];
+                if (_random.NextDouble() < lockRate)
+                    throw new IOException($"{name} is busy", error);
+                _files[mount].Add(name);
+                return true;
+            }
+        }
+    }
+}
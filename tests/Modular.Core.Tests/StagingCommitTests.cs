@@ -0,0 +1,387 @@
+using Modular.Core.Installers;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class StagingCommitTests : IDisposable
+{
+    private static readonly Dictionary<string, string> OldContent = new()
+    {
+        ["Data/existing.esp"] = "old esp",
+        ["readme.txt"] = "old readme"
+    };
+
+    private static readonly Dictionary<string, string> NewContent = new()
+    {
+        ["Data/existing.esp"] = "new esp",
+        ["Data/Textures/Armor/new.dds"] = "new dds",
+        ["readme.txt"] = "new readme"
+    };
+
+    private readonly string _testDir;
+
+    public StagingCommitTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_staging_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void Commit_InstallsFilesWithBackupsAndRemovesStaging()
+    {
+        var (stagingRoot, target) = CreateLayout("clean");
+        var fileSystem = new FaultyFileSystem();
+
+        using var session = Stage(new StagingManager(stagingRoot, fileSystem), "cs-1");
+        var result = session.Commit(target);
+
+        Assert.True(result.Success, result.Error);
+        Assert.Equal(3, result.InstalledFiles.Count);
+        Assert.Equal(2, result.BackedUpFiles.Count);
+        AssertCommitted(target);
+        Assert.False(Directory.Exists(session.StagingDirectory));
+        AssertStagingEmpty(stagingRoot);
+    }
+
+    [Fact]
+    public void CrashAtEveryStep_RecoversToOldOrNewState()
+    {
+        // Count the steps of an undisturbed commit
+        var (countRoot, countTarget) = CreateLayout("count");
+        var counter = new FaultyFileSystem();
+        using (var session = Stage(new StagingManager(countRoot, counter), "cs-1"))
+            Assert.True(session.Commit(countTarget).Success);
+        Assert.True(counter.Steps > 10);
+
+        var committedFrom = -1;
+        for (var step = 0; step < counter.Steps; step++)
+        {
+            var (stagingRoot, target) = CreateLayout($"crash-{step}");
+            var fileSystem = new FaultyFileSystem(failAt: step);
+
+            using (var session = Stage(new StagingManager(stagingRoot, fileSystem), "cs-1"))
+                session.Commit(target);
+
+            fileSystem.LoseUnflushedState();
+            new StagingManager(stagingRoot).RecoverInterruptedCommits();
+
+            var committed = File.ReadAllText(Path.Combine(target, "readme.txt")) == NewContent["readme.txt"];
+            if (committed)
+            {
+                AssertCommitted(target);
+                AssertStagingEmpty(stagingRoot);
+                if (committedFrom < 0)
+                    committedFrom = step;
+            }
+            else
+            {
+                // Once a crash leaves the commit durable, every later one must too
+                Assert.True(committedFrom < 0, $"step {step} rolled back after step {committedFrom} rolled forward");
+                AssertUntouched(target);
+            }
+
+            Assert.Empty(Directory.EnumerateFiles(target, "*.tmp", SearchOption.AllDirectories));
+        }
+
+        Assert.True(committedFrom > 0, "no crash point rolled forward");
+    }
+
+    [Fact]
+    public void TransientFailureAfterCommitPoint_IsFinishedInProcess()
+    {
+        var (countRoot, countTarget) = CreateLayout("count");
+        var counter = new FaultyFileSystem();
+        using (var session = Stage(new StagingManager(countRoot, counter), "cs-1"))
+            session.Commit(countTarget);
+
+        // Fail writing the committed mark (the last four steps and cleanup), after the renames
+        var (stagingRoot, target) = CreateLayout("transient");
+        var fileSystem = new FaultyFileSystem(failAt: counter.Steps - 5, permanent: false);
+        using var failing = Stage(new StagingManager(stagingRoot, fileSystem), "cs-1");
+
+        var result = failing.Commit(target);
+
+        Assert.True(result.Success, result.Error);
+        AssertCommitted(target);
+        AssertStagingEmpty(stagingRoot);
+    }
+
+    [Fact]
+    public void TransientFailureBeforeCommitPoint_LeavesTargetsUntouched()
+    {
+        var (stagingRoot, target) = CreateLayout("transient");
+        var fileSystem = new FaultyFileSystem(failAt: 6, permanent: false);
+        using var session = Stage(new StagingManager(stagingRoot, fileSystem), "cs-1");
+
+        var result = session.Commit(target);
+
+        Assert.False(result.Success);
+        Assert.NotNull(result.Error);
+        AssertUntouched(target);
+        Assert.Empty(Directory.EnumerateFiles(target, "*.tmp", SearchOption.AllDirectories));
+    }
+
+    [Fact]
+    public void Recovery_SkipsSessionBeingCommitted()
+    {
+        var (stagingRoot, target) = CreateLayout("locked");
+        var fileSystem = new FaultyFileSystem(failAt: 12);
+        using (var session = Stage(new StagingManager(stagingRoot, fileSystem), "cs-1"))
+            session.Commit(target);
+        var stagingDirectory = Path.Combine(stagingRoot, "cs-1");
+
+        using (StagingSessionLock.TryAcquire(stagingDirectory))
+        {
+            Assert.Null(StagingSessionLock.TryAcquire(stagingDirectory));
+            Assert.Empty(new StagingManager(stagingRoot).RecoverInterruptedCommits());
+            Assert.True(File.Exists(Path.Combine(stagingDirectory, StagingCommitJournal.ManifestFileName)));
+        }
+
+        var recovered = Assert.Single(new StagingManager(stagingRoot).RecoverInterruptedCommits());
+        Assert.Equal("cs-1", recovered.ChangesetId);
+    }
+
+    [Fact]
+    public void Commit_MovesStagedFilesInsteadOfCopying()
+    {
+        var (stagingRoot, target) = CreateLayout("move");
+        var fileSystem = new FaultyFileSystem();
+        using var session = Stage(new StagingManager(stagingRoot, fileSystem), "cs-1");
+
+        Assert.True(session.Commit(target).Success);
+
+        // Only the two backups of existing files are copies
+        Assert.Equal(2, fileSystem.Copies);
+        AssertCommitted(target);
+    }
+
+    [Fact]
+    public void Commit_WaitsForItsOwnSessionOnlyAndHonoursCancellation()
+    {
+        var (stagingRoot, target) = CreateLayout("wait");
+        var manager = new StagingManager(stagingRoot);
+        using var other = Stage(manager, "cs-2");
+        using var session = Stage(manager, "cs-1");
+
+        // Another session's commit doesn't hold this one up
+        using (StagingSessionLock.TryAcquire(other.StagingDirectory))
+            Assert.True(session.Commit(target).Success);
+
+        var held = StagingSessionLock.TryAcquire(other.StagingDirectory)!;
+        using var cts = new CancellationTokenSource(TimeSpan.FromMilliseconds(100));
+        Assert.Throws<OperationCanceledException>(() => other.Commit(target, ct: cts.Token));
+
+        held.Dispose();
+        Assert.True(other.Commit(target).Success);
+        AssertStagingEmpty(stagingRoot);
+    }
+
+    private (string StagingRoot, string Target) CreateLayout(string name)
+    {
+        var root = Path.Combine(_testDir, name);
+        var target = Path.Combine(root, "game");
+        foreach (var (relativePath, content) in OldContent)
+        {
+            var path = Path.Combine(target, relativePath);
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            File.WriteAllText(path, content);
+        }
+
+        return (Path.Combine(root, "staging"), target);
+    }
+
+    private static StagingSession Stage(StagingManager manager, string changesetId)
+    {
+        var session = manager.CreateSession(changesetId);
+        foreach (var (relativePath, content) in NewContent)
+        {
+            var stagedPath = session.GetStagedPath(relativePath);
+            File.WriteAllText(stagedPath, content);
+            session.RecordStagedFile(relativePath, stagedPath);
+        }
+
+        return session;
+    }
+
+    private static void AssertCommitted(string target)
+    {
+        foreach (var (relativePath, content) in NewContent)
+            Assert.Equal(content, File.ReadAllText(Path.Combine(target, relativePath)));
+        foreach (var (relativePath, content) in OldContent)
+            Assert.Equal(content, File.ReadAllText(Path.Combine(target, relativePath + ".backup")));
+    }
+
+    private static void AssertStagingEmpty(string stagingRoot)
+    {
+        // The lock file goes with its session; only the lock directory is left
+        var remaining = Assert.Single(Directory.EnumerateFileSystemEntries(stagingRoot));
+        Assert.Equal(StagingSessionLock.DirectoryName, Path.GetFileName(remaining));
+        Assert.Empty(Directory.EnumerateFileSystemEntries(remaining));
+    }
+
+    private static void AssertUntouched(string target)
+    {
+        foreach (var (relativePath, content) in OldContent)
+            Assert.Equal(content, File.ReadAllText(Path.Combine(target, relativePath)));
+        Assert.False(File.Exists(Path.Combine(target, "Data/Textures/Armor/new.dds")));
+        Assert.Empty(Directory.EnumerateFiles(target, "*.backup", SearchOption.AllDirectories));
+    }
+
+    /// <summary>
+    /// Filesystem that fails at a chosen step and, after a permanent failure
+    /// (a crash), can throw away what a power loss would: data of files that
+    /// were not flushed, and directory entries created, renamed or deleted
+    /// in directories that were not flushed afterwards. Removing a whole
+    /// directory is treated as durable.
+    /// </summary>
+    private sealed class FaultyFileSystem : IStagingFileSystem
+    {
+        private readonly int _failAt;
+        private readonly bool _permanent;
+        private readonly HashSet<string> _unflushedFiles = new(StringComparer.Ordinal);
+        private readonly List<(string Directory, Action Undo)> _unflushedEntries = new();
+        private bool _crashed;
+
+        public FaultyFileSystem(int failAt = -1, bool permanent = true)
+        {
+            _failAt = failAt;
+            _permanent = permanent;
+        }
+
+        public int Steps { get; private set; }
+
+        public int Copies { get; private set; }
+
+        public bool FileExists(string path)
+        {
+            ThrowIfCrashed();
+            return File.Exists(path);
+        }
+
+        public string ReadAllText(string path)
+        {
+            ThrowIfCrashed();
+            return File.ReadAllText(path);
+        }
+
+        public void WriteAllText(string path, string contents)
+        {
+            Step();
+            TrackCreate(path);
+            File.WriteAllText(path, contents);
+            _unflushedFiles.Add(path);
+        }
+
+        public void Copy(string source, string destination)
+        {
+            Step();
+            Copies++;
+            TrackCreate(destination);
+            File.Copy(source, destination, overwrite: true);
+            _unflushedFiles.Add(destination);
+        }
+
+        public void Relocate(string source, string destination)
+        {
+            // The staged file was never flushed
+            Move(source, destination);
+            _unflushedFiles.Add(destination);
+        }
+
+        public void Move(string source, string destination)
+        {
+            Step();
+            var replaced = File.Exists(destination) ? File.ReadAllBytes(destination) : null;
+            File.Move(source, destination, overwrite: true);
+            if (_unflushedFiles.Remove(source))
+                _unflushedFiles.Add(destination);
+
+            _unflushedEntries.Add((Path.GetDirectoryName(destination)!, () =>
+            {
+                File.Move(destination, source, overwrite: true);
+                if (replaced != null)
+                    File.WriteAllBytes(destination, replaced);
+            }));
+        }
+
+        public void Delete(string path)
+        {
+            Step();
+            var content = File.ReadAllBytes(path);
+            File.Delete(path);
+            _unflushedFiles.Remove(path);
+            _unflushedEntries.Add((Path.GetDirectoryName(path)!, () => File.WriteAllBytes(path, content)));
+        }
+
+        public void CreateDirectory(string path)
+        {
+            Step();
+            var topmost = path;
+            while (!Directory.Exists(Path.GetDirectoryName(topmost)))
+                topmost = Path.GetDirectoryName(topmost)!;
+            Directory.CreateDirectory(path);
+            _unflushedEntries.Add((Path.GetDirectoryName(topmost)!, () => Directory.Delete(topmost, recursive: true)));
+        }
+
+        public void DeleteDirectory(string path)
+        {
+            Step();
+            if (Directory.Exists(path))
+                Directory.Delete(path, recursive: true);
+        }
+
+        public void FlushFile(string path)
+        {
+            Step();
+            _unflushedFiles.Remove(path);
+        }
+
+        public void FlushDirectory(string path)
+        {
+            Step();
+            _unflushedEntries.RemoveAll(e => e.Directory == path);
+        }
+
+        /// <summary>
+        /// Applies the crash to the disk: unflushed files come back empty and
+        /// unflushed directory changes are undone, newest first.
+        /// </summary>
+        public void LoseUnflushedState()
+        {
+            foreach (var path in _unflushedFiles.Where(File.Exists))
+                File.WriteAllBytes(path, []);
+
+            for (var i = _unflushedEntries.Count - 1; i >= 0; i--)
+                _unflushedEntries[i].Undo();
+            _unflushedEntries.Clear();
+        }
+
+        private void TrackCreate(string path)
+        {
+            if (!File.Exists(path))
+                _unflushedEntries.Add((Path.GetDirectoryName(path)!, () => File.Delete(path)));
+        }
+
+        private void Step()
+        {
+            ThrowIfCrashed();
+            if (Steps++ != _failAt)
+                return;
+
+            _crashed = _permanent;
+            throw new IOException($"Injected failure at step {_failAt}");
+        }
+
+        private void ThrowIfCrashed()
+        {
+            if (_crashed)
+                throw new IOException("Filesystem unavailable after crash");
+        }
+    }
+}
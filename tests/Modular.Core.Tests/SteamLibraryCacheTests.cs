@@ -0,0 +1,142 @@
+using FluentAssertions;
+using Modular.Core.GameDetection;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class SteamLibraryCacheTests : IDisposable
+{
+    private readonly string _root;
+    private readonly string _steamRoot;
+    private readonly string _secondLibrary;
+    private readonly CountingLocator _locator;
+
+    public SteamLibraryCacheTests()
+    {
+        _root = Path.Combine(Path.GetTempPath(), $"modular_steamcache_{Guid.NewGuid():N}");
+        _steamRoot = Path.Combine(_root, "Steam");
+        _secondLibrary = Path.Combine(_root, "Library2");
+        Directory.CreateDirectory(Path.Combine(_steamRoot, "steamapps"));
+        Directory.CreateDirectory(Path.Combine(_secondLibrary, "steamapps"));
+
+        File.WriteAllText(Path.Combine(_steamRoot, "steamapps", "libraryfolders.vdf"), $$"""
+            "libraryfolders"
+            {
+                "0" { "path" "{{_steamRoot}}" }
+                "1" { "path" "{{_secondLibrary}}" }
+            }
+            """);
+
+        WriteManifest(_steamRoot, 100, "Alpha Game", "Alpha");
+        WriteManifest(_secondLibrary, 200, "Beta Game", "Beta");
+
+        _locator = new CountingLocator(_steamRoot);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_root))
+            Directory.Delete(_root, true);
+    }
+
+    [Fact]
+    public void FindByAppId_ResolvesGamesAcrossLibraries()
+    {
+        var cache = new SteamLibraryCache(_locator) { RevalidationInterval = TimeSpan.Zero };
+
+        cache.FindByAppId(100)!.InstallPath.Should().Be(Path.Combine(_steamRoot, "steamapps", "common", "Alpha"));
+        cache.FindByAppId(200)!.InstallPath.Should().Be(Path.Combine(_secondLibrary, "steamapps", "common", "Beta"));
+        cache.FindByName("beta").Should().NotBeNull();
+        cache.FindByName("Beta Game")!.AppId.Should().Be(200);
+    }
+
+    [Fact]
+    public void GetView_UnchangedLibraries_ReturnsSameViewAndLocatesRootOnce()
+    {
+        var cache = new SteamLibraryCache(_locator) { RevalidationInterval = TimeSpan.Zero };
+
+        var first = cache.GetView();
+        for (var i = 0; i < 100; i++)
+            cache.GetView().Should().BeSameAs(first);
+
+        _locator.Calls.Should().Be(1);
+    }
+
+    [Fact]
+    public void GetView_NewManifest_RescansOnlyChangedLibrary()
+    {
+        var cache = new SteamLibraryCache(_locator) { RevalidationInterval = TimeSpan.Zero };
+        var before = cache.GetView();
+
+        // Rewrite the main library's manifest in place without changing the directory mtime:
+        // an unchanged library must be reused rather than re-parsed.
+        var mainSteamApps = Path.Combine(_steamRoot, "steamapps");
+        var mainMtime = Directory.GetLastWriteTimeUtc(mainSteamApps);
+        WriteManifest(_steamRoot, 100, "Alpha Renamed", "Alpha");
+        Directory.SetLastWriteTimeUtc(mainSteamApps, mainMtime);
+
+        WriteManifest(_secondLibrary, 300, "Gamma Game", "Gamma");
+        Directory.SetLastWriteTimeUtc(Path.Combine(_secondLibrary, "steamapps"), DateTime.UtcNow.AddMinutes(1));
+
+        var after = cache.GetView();
+
+        after.Should().NotBeSameAs(before);
+        after.Libraries[0].Should().BeSameAs(before.Libraries[0]);
+        after.ByAppId[100].DisplayName.Should().Be("Alpha Game");
+        after.ByAppId.Should().ContainKey(300);
+    }
+
+    [Fact]
+    public void GetView_WithinRevalidationInterval_DoesNotTouchFilesystem()
+    {
+        var cache = new SteamLibraryCache(_locator) { RevalidationInterval = TimeSpan.FromHours(1) };
+        var first = cache.GetView();
+
+        WriteManifest(_secondLibrary, 300, "Gamma Game", "Gamma");
+        Directory.SetLastWriteTimeUtc(Path.Combine(_secondLibrary, "steamapps"), DateTime.UtcNow.AddMinutes(1));
+
+        cache.GetView().Should().BeSameAs(first);
+
+        cache.Invalidate();
+        cache.GetView().ByAppId.Should().ContainKey(300);
+    }
+
+    [Fact]
+    public void GetView_PersistedCache_IsReusedByNewInstance()
+    {
+        var cachePath = Path.Combine(_root, "steam_library_cache.json");
+        var warm = new SteamLibraryCache(_locator, cachePath) { RevalidationInterval = TimeSpan.Zero };
+        warm.GetView();
+        File.Exists(cachePath).Should().BeTrue();
+
+        var locator = new CountingLocator(_steamRoot);
+        var cold = new SteamLibraryCache(locator, cachePath) { RevalidationInterval = TimeSpan.Zero };
+
+        cold.FindByAppId(200).Should().NotBeNull();
+        locator.Calls.Should().Be(0);
+    }
+
+    private static void WriteManifest(string libraryRoot, int appId, string name, string installDir)
+    {
+        File.WriteAllText(Path.Combine(libraryRoot, "steamapps", $"appmanifest_{appId}.acf"), $$"""
+            "AppState"
+            {
+                "appid" "{{appId}}"
+                "name" "{{name}}"
+                "installdir" "{{installDir}}"
+                "StateFlags" "4"
+            }
+            """);
+    }
+
+    private sealed class CountingLocator(string root) : ISteamLocator
+    {
+        public int Calls { get; private set; }
+
+        public string? FindSteamRoot()
+        {
+            Calls++;
+            return root;
+        }
+    }
+}
@@ -0,0 +1,235 @@
+using System.Diagnostics;
+using System.Text.Json;
+using Modular.Core.Telemetry;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class TelemetryStoreTests : IDisposable
+{
+    private static readonly string[] Installers = ["fomod", "bepinex", "loose_file", "unreal_pak", "cyberpunk"];
+
+    private readonly string _testDir;
+
+    public TelemetryStoreTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_telemetry_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+    }
+
+    public void Dispose()
+    {
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public void TDigest_EstimatesPercentilesOfWholeAndMergedData()
+    {
+        var random = new Random(11);
+        var values = Enumerable.Range(0, 100_000).Select(_ => Math.Exp(random.NextDouble() * 3 + random.NextDouble() * 3)).ToArray();
+        var whole = new TDigest();
+        var merged = new TDigest();
+        foreach (var chunk in values.Chunk(100))
+        {
+            var part = new TDigest();
+            foreach (var value in chunk)
+            {
+                whole.Add(value);
+                part.Add(value);
+            }
+
+            merged.Merge(part);
+        }
+
+        var sorted = values.Order().ToArray();
+        foreach (var q in new[] { 0.5, 0.9, 0.95, 0.99 })
+        {
+            var exact = sorted[(int)(q * (sorted.Length - 1))];
+            Assert.InRange(whole.Quantile(q), exact * 0.98, exact * 1.02);
+            Assert.InRange(merged.Quantile(q), exact * 0.98, exact * 1.02);
+        }
+
+        Assert.Equal(sorted[0], merged.Quantile(0));
+        Assert.Equal(sorted[^1], merged.Quantile(1));
+        Assert.True(merged.CentroidCount < 1000, $"{merged.CentroidCount} centroids");
+
+        using var buffer = new MemoryStream();
+        merged.Write(new BinaryWriter(buffer));
+        buffer.Position = 0;
+        Assert.Equal(merged.Quantile(0.95), TDigest.Read(new BinaryReader(buffer)).Quantile(0.95));
+    }
+
+    [Fact]
+    public void Query_P95PerInstallerOverMonthsOfRollupsIsFast()
+    {
+        var random = new Random(5);
+        var now = DateTime.UtcNow;
+        var events = new List<TelemetryEvent>();
+        var exact = Installers.ToDictionary(i => i, _ => new List<double>());
+        for (var minute = 90 * 24 * 60; minute > 0; minute -= 3)
+        {
+            var installer = Installers[random.Next(Installers.Length)];
+            var duration = 50 + random.NextDouble() * 1000 * (Array.IndexOf(Installers, installer) + 1);
+            var timestamp = now.AddMinutes(-minute);
+            events.Add(InstallerEvent(timestamp, installer, duration, success: random.Next(10) > 0));
+            if (timestamp >= now.AddDays(-30))
+                exact[installer].Add(duration);
+        }
+
+        var config = new TelemetryConfig { RawRetentionDays = 120, RollupRetentionDays = 120 };
+        var store = new TelemetryStore(_testDir, config);
+        store.Append(events);
+        while (store.RunMaintenance().HasMoreWork)
+        {
+        }
+
+        // A fresh store reads the rollups from disk
+        var stopwatch = Stopwatch.StartNew();
+        var stats = new TelemetryStore(_testDir, config).Query(now.AddDays(-30), now, "installer_execution");
+        stopwatch.Stop();
+
+        Assert.Equal(Installers.Order(), stats.Select(s => s.Key).Order());
+        foreach (var stat in stats)
+        {
+            var sorted = exact[stat.Key].Order().ToArray();
+            var p95 = sorted[(int)(0.95 * (sorted.Length - 1))];
+
+            // Whole hours at the range edges may add a few events
+            Assert.InRange(stat.Count, sorted.Length, sorted.Length + 45);
+            Assert.InRange(stat.DurationPercentile(95), p95 * 0.97, p95 * 1.03);
+            Assert.Equal(stat.Count, stat.Successes + stat.Failures);
+        }
+
+        Assert.True(stopwatch.ElapsedMilliseconds < 250, $"took {stopwatch.ElapsedMilliseconds} ms");
+    }
+
+    [Fact]
+    public void Maintenance_DropsRawEventsAfterRetentionButKeepsRollups()
+    {
+        var now = DateTime.UtcNow;
+        var config = new TelemetryConfig { RawRetentionDays = 5, RollupRetentionDays = 60 };
+        var store = new TelemetryStore(_testDir, config);
+        store.Append(
+        [
+            InstallerEvent(now.AddDays(-100), "fomod", 10, true),
+            InstallerEvent(now.AddDays(-10), "fomod", 20, true),
+            InstallerEvent(now.AddDays(-1), "fomod", 30, false)
+        ]);
+
+        var result = store.RunMaintenance();
+
+        Assert.Equal(2, result.DaysCompacted);
+        Assert.Equal(2, result.FilesDeleted);
+        Assert.Empty(store.ReadEvents(now.AddDays(-11), now.AddDays(-9)));
+        Assert.Single(store.ReadEvents(now.AddDays(-2), now));
+
+        var stats = Assert.Single(store.Query(now.AddDays(-200), now));
+        Assert.Equal(2, stats.Count);
+        Assert.Equal(1, stats.Failures);
+        Assert.Equal(25, stats.MeanDurationMs);
+        Assert.Empty(new TelemetryStore(_testDir, config).Query(now.AddDays(-101), now.AddDays(-99)));
+    }
+
+    [Fact]
+    public void Maintenance_ReadsAtMostItsBudgetPerPass()
+    {
+        var now = DateTime.UtcNow;
+        var store = new TelemetryStore(_testDir, new TelemetryConfig { MaintenanceBytesPerPass = 1 });
+        store.Append(Enumerable.Range(1, 4).Select(d => InstallerEvent(now.AddDays(-d), "fomod", d, true)).ToList());
+
+        var passes = new List<TelemetryMaintenanceResult>();
+        do
+        {
+            passes.Add(store.RunMaintenance());
+        }
+        while (passes[^1].HasMoreWork);
+
+        Assert.Equal([1, 1, 1, 1], passes.Select(p => p.DaysCompacted));
+        Assert.Equal(0, store.RunMaintenance().DaysCompacted);
+        Assert.Equal(4, store.Query(now.AddDays(-5), now).Sum(s => s.Count));
+    }
+
+    [Fact]
+    public void Maintenance_ImportsLegacyJsonDays()
+    {
+        var day = DateTime.UtcNow.Date.AddDays(-3);
+        var legacy = new List<TelemetryEvent>
+        {
+            InstallerEvent(day.AddHours(2), "fomod", 100, true),
+            new() { EventType = "download_completed", Category = "usage", Timestamp = day.AddHours(3), Data = new() { ["backend"] = "nexus", ["size_bytes"] = 2048L, ["success"] = true } }
+        };
+        File.WriteAllText(Path.Combine(_testDir, $"telemetry-{day:yyyy-MM-dd}.json"), JsonSerializer.Serialize(legacy));
+
+        var store = new TelemetryStore(_testDir);
+        var result = store.RunMaintenance();
+
+        Assert.Equal(1, result.LegacyFilesImported);
+        Assert.Empty(Directory.GetFiles(_testDir, "telemetry-*.json"));
+        var stats = store.Query(day, day.AddDays(1)).ToDictionary(s => s.EventType);
+        Assert.Equal(100, stats["installer_execution"].DurationPercentile(50));
+        Assert.Equal("nexus", stats["download_completed"].Key);
+        Assert.Equal(2048, stats["download_completed"].TotalBytes);
+        Assert.Equal(2, store.ReadEvents(day, day.AddDays(1)).Count);
+    }
+
+    [Fact]
+    public void Service_SummarizesTodaysEventsAndKeepsInstallerIdsWhenNotAnonymizing()
+    {
+        var service = new TelemetryService(_testDir, new TelemetryConfig { Enabled = true, AnonymizeData = false });
+        service.RecordInstallerResult("fomod", true, TimeSpan.FromMilliseconds(120));
+        service.RecordInstallerResult("fomod", false, TimeSpan.FromMilliseconds(80));
+        service.RecordInstallerResult("bepinex", true, TimeSpan.FromMilliseconds(40));
+        service.RecordDownload("nexus", 4096, TimeSpan.FromSeconds(1), true);
+
+        var summary = service.GetSummary();
+        var installers = service.GetOperationStats("installer_execution").ToDictionary(s => s.Key);
+
+        Assert.Equal(4, summary.TotalEvents);
+        Assert.Equal(2, summary.InstallerSuccesses);
+        Assert.Equal(1, summary.InstallerFailures);
+        Assert.Equal(4096, summary.TotalBytesDownloaded);
+        Assert.Equal(2, installers["fomod"].Count);
+        Assert.Equal(100, installers["fomod"].MeanDurationMs);
+        Assert.Equal(1, installers["bepinex"].Count);
+
+        service.ClearData();
+        Assert.Equal(0, service.GetSummary().TotalEvents);
+    }
+
+    [Fact]
+    public void Service_AnonymizingGroupsByHashedInstallerAndPluginIds()
+    {
+        var service = new TelemetryService(_testDir, new TelemetryConfig { Enabled = true });
+        service.RecordInstallerResult("fomod", true, TimeSpan.FromMilliseconds(120));
+        service.RecordInstallerResult("fomod", false, TimeSpan.FromMilliseconds(80));
+        service.RecordInstallerResult("bepinex", true, TimeSpan.FromMilliseconds(40));
+        service.RecordPluginCrash("my-private-plugin", new InvalidOperationException("boom"));
+
+        var installers = service.GetOperationStats("installer_execution");
+        var crashes = service.GetOperationStats("plugin_crash");
+        var today = DateTime.UtcNow.Date;
+        var events = new TelemetryStore(_testDir).ReadEvents(today, today.AddDays(1));
+
+        Assert.Equal([1, 2], installers.Select(s => s.Count).Order().ToArray());
+        Assert.All(installers, s => Assert.DoesNotContain(s.Key, new[] { "fomod", "bepinex" }));
+        Assert.NotEqual("my-private-plugin", Assert.Single(crashes).Key);
+        Assert.NotEmpty(Assert.Single(crashes).Key);
+        Assert.Equal(4, events.Count);
+        var clearIds = new[] { "fomod", "bepinex", "my-private-plugin" };
+        Assert.All(events, e => Assert.Empty(e.Data.Values.OfType<string>().Intersect(clearIds)));
+    }
+
+    private static TelemetryEvent InstallerEvent(DateTime timestamp, string installer, double duration, bool success) => new()
+    {
+        EventType = "installer_execution",
+        Category = "performance",
+        Timestamp = timestamp,
+        Data = new Dictionary<string, object>
+        {
+            ["installer_id"] = installer,
+            ["success"] = success,
+            ["duration_ms"] = duration
+        }
+    };
+}
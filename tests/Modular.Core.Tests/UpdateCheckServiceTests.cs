@@ -0,0 +1,238 @@
+using Modular.Core.Backends.NexusMods;
+using Modular.Core.Database;
+using Modular.Core.Updates;
+using Xunit;
+
+namespace Modular.Core.Tests;
+
+public class UpdateCheckServiceTests : IAsyncLifetime
+{
+    private const long Start = 1_700_000_000;
+
+    private readonly string _testDir;
+    private readonly ModularDatabase _database;
+    private readonly ModUpdateIndex _index;
+    private readonly ManualTime _time = new(Start);
+
+    public UpdateCheckServiceTests()
+    {
+        _testDir = Path.Combine(Path.GetTempPath(), $"modular_updates_test_{Guid.NewGuid():N}");
+        Directory.CreateDirectory(_testDir);
+        _database = new ModularDatabase(Path.Combine(_testDir, "modular.db"));
+        _index = new ModUpdateIndex(_database);
+    }
+
+    public Task InitializeAsync() => _database.InitializeAsync();
+
+    public async Task DisposeAsync()
+    {
+        await _database.DisposeAsync();
+        if (Directory.Exists(_testDir))
+            Directory.Delete(_testDir, recursive: true);
+    }
+
+    [Fact]
+    public async Task Poll_MatchesFeedAgainstWatchedModsOnly()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        feed.Watch("skyrim", "2", baseline: Start - 1000);
+        feed.Updates["skyrim"] = [new("1", Start - 10), new("2", Start - 2000), new("99", Start - 10)];
+        using var checker = new UpdateCheckService(_index, [feed], timeProvider: _time);
+
+        var result = await checker.PollAsync();
+
+        Assert.Equal(2, result.UpdatesMatched);
+        var outdated = Assert.Single(result.Outdated);
+        Assert.Equal("1", outdated.ModId);
+        Assert.Equal(DateTimeOffset.FromUnixTimeSeconds(Start - 10), outdated.UpdatedAt);
+        Assert.Single(await _index.GetOutdatedAsync("nexusmods", "skyrim"));
+        Assert.Empty(await _index.GetOutdatedAsync(gameDomain: "fallout4"));
+    }
+
+    [Fact]
+    public async Task Poll_AsksOnlyForWindowSinceWatermark()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        using var checker = new UpdateCheckService(_index, [feed], timeProvider: _time);
+
+        await checker.PollAsync();
+        _time.Now = Start + 600;
+        await checker.PollAsync();
+
+        Assert.Equal(new long?[] { null, Start }, feed.Requests.Select(r => r.Since));
+        Assert.Equal(Start + 600, await _index.GetWatermarkAsync("nexusmods", "skyrim"));
+
+        // The watermark is persisted, so a new service picks up where the last left off
+        using var restarted = new UpdateCheckService(_index, [feed], timeProvider: _time);
+        _time.Now = Start + 1200;
+        await restarted.PollAsync();
+        Assert.Equal(Start + 600, feed.Requests[^1].Since);
+    }
+
+    [Fact]
+    public async Task Poll_FailedBackendKeepsWatermarkAndIndex()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        feed.Updates["skyrim"] = [new("1", Start - 10)];
+        var other = new FakeFeed("gamebanana");
+        other.Watch("unknown", "42", baseline: Start - 1000);
+        other.Updates["unknown"] = [new("42", Start - 5)];
+        using var checker = new UpdateCheckService(_index, [feed, other], timeProvider: _time);
+        await checker.PollAsync();
+
+        feed.Fail = true;
+        _time.Now = Start + 600;
+        var result = await checker.PollAsync();
+
+        Assert.Equal(new[] { "nexusmods" }, result.FailedBackends);
+        Assert.Equal(2, result.Outdated.Count);
+        Assert.Equal(Start, await _index.GetWatermarkAsync("nexusmods", "skyrim"));
+        Assert.Equal(Start + 600, await _index.GetWatermarkAsync("gamebanana", "unknown"));
+    }
+
+    [Fact]
+    public async Task Poll_SkipsUnavailableFeedWithoutDroppingWatchList()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        feed.Updates["skyrim"] = [new("1", Start - 10)];
+        using var checker = new UpdateCheckService(_index, [feed], timeProvider: _time);
+        await checker.PollAsync();
+
+        feed.Available = false;
+        feed.Watched.Clear();
+        var result = await checker.PollAsync();
+
+        Assert.Empty(result.FailedBackends);
+        Assert.Single(result.Outdated);
+    }
+
+    [Fact]
+    public async Task Baselines_OnlyMoveForwardAndUnwatchedModsAreDropped()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        feed.Watch("skyrim", "2", baseline: null);
+        feed.Updates["skyrim"] = [new("1", Start - 10), new("2", Start - 10)];
+        using var checker = new UpdateCheckService(_index, [feed], timeProvider: _time);
+
+        // Mod 2 has no baseline, so it counts as current when first seen
+        var first = await checker.PollAsync();
+        Assert.Equal("1", Assert.Single(first.Outdated).ModId);
+
+        // Downloading the update moves the baseline past it
+        feed.Watched.Clear();
+        feed.Watch("skyrim", "1", baseline: Start);
+        feed.Watch("skyrim", "2", baseline: Start - 5000);
+        feed.Updates["skyrim"] = [new("2", Start + 100)];
+        _time.Now = Start + 600;
+        var second = await checker.PollAsync();
+        Assert.Equal("2", Assert.Single(second.Outdated).ModId);
+
+        // Untracking removes the mod and its recorded update
+        feed.Watched.RemoveAll(m => m.ModId == "2");
+        _time.Now = Start + 1200;
+        var third = await checker.PollAsync();
+        Assert.Empty(third.Outdated);
+
+        feed.Watch("skyrim", "2", baseline: Start - 5000);
+        feed.Updates["skyrim"] = [];
+        _time.Now = Start + 1800;
+        Assert.Empty((await checker.PollAsync()).Outdated);
+    }
+
+    [Fact]
+    public async Task UpdatesFound_RaisedOnlyForNewlyOutdatedMods()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        feed.Watch("skyrim", "2", baseline: Start - 1000);
+        feed.Updates["skyrim"] = [new("1", Start - 10)];
+        using var checker = new UpdateCheckService(_index, [feed], timeProvider: _time);
+        var raised = new List<IReadOnlyList<OutdatedMod>>();
+        checker.UpdatesFound += (_, mods) => raised.Add(mods);
+
+        await checker.PollAsync();
+        feed.Updates["skyrim"] = [new("2", Start + 10)];
+        _time.Now = Start + 600;
+        await checker.PollAsync();
+        _time.Now = Start + 1200;
+        await checker.PollAsync();
+
+        Assert.Equal(2, raised.Count);
+        Assert.Equal("1", Assert.Single(raised[0]).ModId);
+        Assert.Equal("2", Assert.Single(raised[1]).ModId);
+    }
+
+    [Fact]
+    public async Task Acknowledge_ClearsOutdatedUntilNextUpdate()
+    {
+        var feed = new FakeFeed();
+        feed.Watch("skyrim", "1", baseline: Start - 1000);
+        feed.Updates["skyrim"] = [new("1", Start - 10)];
+        using var checker = new UpdateCheckService(_index, [feed], timeProvider: _time);
+        await checker.PollAsync();
+
+        await _index.AcknowledgeAsync("nexusmods", "skyrim", "1");
+        Assert.Empty(await checker.GetOutdatedAsync());
+
+        feed.Updates["skyrim"] = [new("1", Start + 50)];
+        _time.Now = Start + 600;
+        Assert.Single((await checker.PollAsync()).Outdated);
+    }
+
+    [Theory]
+    [InlineData(null, "1m")]
+    [InlineData(Start - 3600, "1d")]
+    [InlineData(Start - 82_800, "1d")]
+    [InlineData(Start - 82_801, "1w")]
+    [InlineData(Start - 601_200, "1w")]
+    [InlineData(Start - 601_201, "1m")]
+    [InlineData(Start - 10_000_000, "1m")]
+    public void PeriodCovering_PicksShortestWindowWithMargin(long? since, string expected)
+    {
+        Assert.Equal(expected, NexusSyncPlanner.PeriodCovering(since, Start));
+    }
+
+    private sealed class FakeFeed : IUpdateFeed
+    {
+        public FakeFeed(string backendId = "nexusmods") => BackendId = backendId;
+
+        public string BackendId { get; }
+        public bool Available { get; set; } = true;
+        public bool IsAvailable => Available;
+        public bool Fail { get; set; }
+        public List<WatchedMod> Watched { get; } = [];
+        public Dictionary<string, List<RemoteModUpdate>> Updates { get; } = [];
+        public List<(string Domain, long? Since)> Requests { get; } = [];
+
+        public void Watch(string domain, string modId, long? baseline) =>
+            Watched.Add(new WatchedMod { GameDomain = domain, ModId = modId, Source = WatchSource.Downloaded, BaselineAt = baseline });
+
+        public Task<IReadOnlyList<WatchedMod>> GetWatchedModsAsync(CancellationToken ct = default)
+        {
+            if (Fail)
+                throw new HttpRequestException("feed unavailable");
+            return Task.FromResult<IReadOnlyList<WatchedMod>>(Watched.ToList());
+        }
+
+        public Task<IReadOnlyList<RemoteModUpdate>> GetUpdatesAsync(string gameDomain, long? since, long now, CancellationToken ct = default)
+        {
+            Requests.Add((gameDomain, since));
+            return Task.FromResult<IReadOnlyList<RemoteModUpdate>>(
+                Updates.TryGetValue(gameDomain, out var updates) ? updates.ToList() : []);
+        }
+    }
+
+    private sealed class ManualTime : TimeProvider
+    {
+        public ManualTime(long now) => Now = now;
+
+        public long Now { get; set; }
+
+        public override DateTimeOffset GetUtcNow() => DateTimeOffset.FromUnixTimeSeconds(Now);
+    }
+}